@@ -0,0 +1,253 @@
+// Compares derivatives from automatic differentiation to hand-coded ones on
+// the Rosenbrock and simple constrained examples.  We time the gradient, the
+// Hessian-vector product, and the second derivative adjoint of the
+// constraints, and then we solve both problems with each set of derivatives
+// to make sure the iterates agree.
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/ad.h"
+
+// Create some type shortcuts
+typedef Optizelle::Rm <double> X;
+typedef X::Vector X_Vector;
+using Optizelle::Natural;
+using Optizelle::Rm;
+
+// f(x,y)=(1-x)^2+100(y-x^2)^2 with hand-coded derivatives
+struct Rosenbrock : public Optizelle::ScalarValuedFunction <double,Rm> {
+    double eval(X_Vector const & x) const {
+        return Optizelle::sq(1.-x[0])+100.*Optizelle::sq(x[1]-x[0]*x[0]);
+    }
+    void grad(X_Vector const & x,X_Vector & g) const {
+        g[0]=-400.*x[0]*(x[1]-x[0]*x[0])-2.*(1.-x[0]);
+        g[1]=200.*(x[1]-x[0]*x[0]);
+    }
+    void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+        const
+    {
+        H_dx[0]=(1200.*x[0]*x[0]-400.*x[1]+2)*dx[0]-400.*x[0]*dx[1];
+        H_dx[1]=-400.*x[0]*dx[0]+200.*dx[1];
+    }
+};
+
+// The same function written once for automatic differentiation
+struct RosenbrockAD {
+    template <typename T>
+    T operator () (std::vector <T> const & x) const {
+        return (1.-x[0])*(1.-x[0])+100.*(x[1]-x[0]*x[0])*(x[1]-x[0]*x[0]);
+    }
+};
+
+// f(x,y)=(x+1)^2+(y+1)^2 with hand-coded derivatives
+struct MyObj : public Optizelle::ScalarValuedFunction <double,Rm> {
+    double eval(X_Vector const & x) const {
+        return Optizelle::sq(x[0]+1.)+Optizelle::sq(x[1]+1.);
+    }
+    void grad(X_Vector const & x,X_Vector & g) const {
+        g[0]=2*x[0]+2;
+        g[1]=2*x[1]+2;
+    }
+    void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+        const
+    {
+        H_dx[0]=2.*dx[0];
+        H_dx[1]=2.*dx[1];
+    }
+};
+struct MyObjAD {
+    template <typename T>
+    T operator () (std::vector <T> const & x) const {
+        return (x[0]+1.)*(x[0]+1.)+(x[1]+1.)*(x[1]+1.);
+    }
+};
+
+// g(x,y)= [ x + 2y = 1 ] and h(x,y)= [ 2x + y >= 1 ] with hand-coded
+// derivatives
+template <Natural i>
+struct MyLinear : public Optizelle::VectorValuedFunction<double,Rm,Rm> {
+    static double a(Natural const & j) {
+        return (i==j) ? 2. : 1.;
+    }
+    void eval(X_Vector const & x,X_Vector & y) const {
+        y[0]=a(0)*x[0]+a(1)*x[1]-1.;
+    }
+    void p(X_Vector const & x,X_Vector const & dx,X_Vector & y) const {
+        y[0]=a(0)*dx[0]+a(1)*dx[1];
+    }
+    void ps(X_Vector const & x,X_Vector const & dy,X_Vector & z) const {
+        z[0]=a(0)*dy[0];
+        z[1]=a(1)*dy[0];
+    }
+    void pps(
+        X_Vector const & x,
+        X_Vector const & dx,
+        X_Vector const & dy,
+        X_Vector & z
+    ) const {
+        X::zero(z);
+    }
+};
+template <Natural i>
+struct MyLinearAD {
+    template <typename T>
+    void operator () (std::vector <T> const & x,std::vector <T> & y) const {
+        y[0]=MyLinear <i>::a(0)*x[0]+MyLinear <i>::a(1)*x[1]-1.;
+    }
+};
+typedef MyLinear <1> MyEq;
+typedef MyLinear <0> MyIneq;
+
+// Returns the average time in seconds over a number of repetitions
+template <typename F>
+double time_it(Natural const nreps,F const & f) {
+    auto start = std::chrono::steady_clock::now();
+    for(Natural i=0;i<nreps;i++)
+        f();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration <double> (stop-start).count()/double(nreps);
+}
+
+// Relative difference between two vectors
+double rel_err(X_Vector const & x,X_Vector const & y) {
+    X_Vector r(x);
+    X::axpy(-1.,y,r);
+    return std::sqrt(X::innr(r,r))/(1.+std::sqrt(X::innr(y,y)));
+}
+
+// Prints a row of the timing table
+void print_row(
+    std::string const & name,
+    double const & t_hand,
+    double const & t_ad
+) {
+    std::cout << std::setw(24) << name
+        << std::setw(16) << std::scientific << std::setprecision(3) << t_hand
+        << std::setw(16) << t_ad
+        << std::setw(10) << std::fixed << std::setprecision(2)
+        << t_ad/t_hand << std::endl;
+}
+
+int main(int argc,char* argv[]) {
+    // Grab the number of repetitions per measurement
+    Natural nreps = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+    std::cout << std::setw(24) << "operation"
+        << std::setw(16) << "hand (s)"
+        << std::setw(16) << "ad (s)"
+        << std::setw(10) << "ratio" << std::endl;
+
+    // Time the derivatives at a fixed point.  The tape is recorded on the
+    // first call and then reused by every call afterwards.
+    double err(0.);
+    X_Vector x = {-1.2,1.};
+    X_Vector dx = {0.3,-0.7};
+    X_Vector dy = {1.5};
+    X_Vector g(2), g_ad(2), H_dx(2), H_dx_ad(2), z(2), z_ad(2);
+    {
+        Rosenbrock f;
+        Optizelle::AD::ScalarValuedFunction <double,RosenbrockAD> f_ad(
+            (RosenbrockAD()));
+        print_row("rosenbrock grad",
+            time_it(nreps,[&]() { f.grad(x,g); }),
+            time_it(nreps,[&]() { f_ad.grad(x,g_ad); }));
+        print_row("rosenbrock hessvec",
+            time_it(nreps,[&]() { f.hessvec(x,dx,H_dx); }),
+            time_it(nreps,[&]() { f_ad.hessvec(x,dx,H_dx_ad); }));
+        err = std::max(err,std::max(rel_err(g_ad,g),rel_err(H_dx_ad,H_dx)));
+    }
+    {
+        MyObj f;
+        Optizelle::AD::ScalarValuedFunction <double,MyObjAD> f_ad(
+            (MyObjAD()));
+        MyEq g_eq;
+        Optizelle::AD::VectorValuedFunction <double,MyLinearAD <1> > g_eq_ad(
+            (MyLinearAD <1>()));
+        print_row("simple grad",
+            time_it(nreps,[&]() { f.grad(x,g); }),
+            time_it(nreps,[&]() { f_ad.grad(x,g_ad); }));
+        print_row("simple hessvec",
+            time_it(nreps,[&]() { f.hessvec(x,dx,H_dx); }),
+            time_it(nreps,[&]() { f_ad.hessvec(x,dx,H_dx_ad); }));
+        print_row("simple equality ps",
+            time_it(nreps,[&]() { g_eq.ps(x,dy,z); }),
+            time_it(nreps,[&]() { g_eq_ad.ps(x,dy,z_ad); }));
+        err = std::max(err,std::max(rel_err(g_ad,g),rel_err(H_dx_ad,H_dx)));
+        err = std::max(err,rel_err(z_ad,z));
+        print_row("simple equality pps",
+            time_it(nreps,[&]() { g_eq.pps(x,dx,dy,z); }),
+            time_it(nreps,[&]() { g_eq_ad.pps(x,dx,dy,z_ad); }));
+        err = std::max(err,rel_err(z_ad,z));
+    }
+
+    // Solve Rosenbrock with each set of derivatives using Newton-CG.  Since
+    // the adapter also provides a dense Hessian, we turn off the dense
+    // trust-region subproblem solver, so that both runs take the same steps.
+    std::vector <Natural> iters;
+    std::vector <X_Vector> sols;
+    std::vector <double> times;
+    for(bool ad : {false,true}) {
+        Optizelle::Unconstrained <double,Rm>::State::t state(X_Vector{-1.2,1.});
+        state.msg_level = 0;
+        state.H_type = Optizelle::Operators::UserDefined;
+        state.iter_max = 100;
+        state.dense_size_max = 0;
+        Optizelle::Unconstrained <double,Rm>::Functions::t fns;
+        if(ad)
+            fns.f.reset(new Optizelle::AD::ScalarValuedFunction
+                <double,RosenbrockAD> (RosenbrockAD()));
+        else
+            fns.f.reset(new Rosenbrock);
+        double t = time_it(1,[&]() {
+            Optizelle::Unconstrained <double,Rm>::Algorithms
+                ::getMin(Optizelle::Messaging(),fns,state);
+        });
+        times.push_back(t);
+        iters.push_back(state.iter);
+        sols.push_back(state.x);
+    }
+
+    // Solve the simple constrained problem with each set of derivatives
+    for(bool ad : {false,true}) {
+        Optizelle::Constrained <double,Rm,Rm,Rm>::State::t state(
+            X_Vector{2.1,1.1},X_Vector(1),X_Vector(1));
+        state.msg_level = 0;
+        state.H_type = Optizelle::Operators::UserDefined;
+        state.iter_max = 100;
+        Optizelle::Constrained <double,Rm,Rm,Rm>::Functions::t fns;
+        if(ad) {
+            fns.f.reset(new Optizelle::AD::ScalarValuedFunction
+                <double,MyObjAD> (MyObjAD()));
+            fns.g.reset(new Optizelle::AD::VectorValuedFunction
+                <double,MyLinearAD <1> > (MyLinearAD <1>()));
+            fns.h.reset(new Optizelle::AD::VectorValuedFunction
+                <double,MyLinearAD <0> > (MyLinearAD <0>()));
+        } else {
+            fns.f.reset(new MyObj);
+            fns.g.reset(new MyEq);
+            fns.h.reset(new MyIneq);
+        }
+        double t = time_it(1,[&]() {
+            Optizelle::Constrained <double,Rm,Rm,Rm>::Algorithms
+                ::getMin(Optizelle::Messaging(),fns,state);
+        });
+        times.push_back(t);
+        iters.push_back(state.iter);
+        sols.push_back(state.x);
+    }
+
+    print_row("rosenbrock getMin",times[0],times[1]);
+    print_row("simple getMin",times[2],times[3]);
+    std::cout << "Iterations (hand/ad): rosenbrock " << iters[0] << '/'
+        << iters[1] << ", simple " << iters[2] << '/' << iters[3] << std::endl;
+    err = std::max(err,std::max(rel_err(sols[1],sols[0]),
+        rel_err(sols[3],sols[2])));
+    std::cout << "Relative difference between the derivatives: "
+        << std::scientific << err << std::endl;
+
+    return err < 1e-10 && iters[0]==iters[1] && iters[2]==iters[3]
+        ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,143 @@
+// Reports how many augmented system iterations we save on each optimization
+// iteration by continuing the composite-step solves from where they left off
+// after getStep tightens the tolerances.  We run the simple
+// equality example and the version of the parameter estimation example in
+// parest.h.
+
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "parest.h"
+
+// Create some type shortcuts
+typedef Optizelle::Rm <double> X;
+typedef X::Vector X_Vector;
+using Optizelle::Natural;
+using Optizelle::Rm;
+typedef Optizelle::EqualityConstrained <double,Rm,Rm> Problem;
+
+// f(x,y)=x^2+y^2
+struct SimpleObj : public Optizelle::ScalarValuedFunction <double,Rm> {
+    double eval(X_Vector const & x) const {
+        return Optizelle::sq(x[0])+Optizelle::sq(x[1]);
+    }
+    void grad(X_Vector const & x,X_Vector & g) const {
+        g[0]=2.*x[0];
+        g[1]=2.*x[1];
+    }
+    void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+        const
+    {
+        H_dx[0]=2.*dx[0];
+        H_dx[1]=2.*dx[1];
+    }
+};
+
+// g(x,y)= [ (x-2)^2 + (y-2)^2 = 1 ]
+struct SimpleEq : public Optizelle::VectorValuedFunction <double,Rm,Rm> {
+    void eval(X_Vector const & x,X_Vector & y) const {
+        y[0]=Optizelle::sq(x[0]-2.)+Optizelle::sq(x[1]-2.)-1.;
+    }
+    void p(X_Vector const & x,X_Vector const & dx,X_Vector & y) const {
+        y[0]=2.*(x[0]-2.)*dx[0]+2.*(x[1]-2.)*dx[1];
+    }
+    void ps(X_Vector const & x,X_Vector const & dy,X_Vector & z) const {
+        z[0]=2.*(x[0]-2.)*dy[0];
+        z[1]=2.*(x[1]-2.)*dy[0];
+    }
+    void pps(
+        X_Vector const & x,
+        X_Vector const & dx,
+        X_Vector const & dy,
+        X_Vector & z
+    ) const {
+        z[0]=2.*dx[0]*dy[0];
+        z[1]=2.*dx[1]*dy[0];
+    }
+};
+
+// Prints the counters at the end of each optimization iteration
+struct PrintSaved : public Optizelle::StateManipulator <Problem> {
+    mutable Natural saved;
+    PrintSaved() : saved(0) {}
+    void eval(
+        Problem::Functions::t const & fns,
+        Problem::State::t & state,
+        Optizelle::OptimizationLocation::t const & loc
+    ) const {
+        if(loc!=Optizelle::OptimizationLocation::EndOfOptimizationIteration)
+            return;
+        std::cout << std::setw(8) << state.iter
+            << std::setw(10) << state.augsys_iter_saved-saved
+            << std::endl;
+        saved = state.augsys_iter_saved;
+    }
+};
+
+// Solves the problem and prints the counters for each iteration
+void solve(
+    std::string const & name,
+    Problem::Functions::t & fns,
+    Problem::State::t & state
+) {
+    std::cout << name << std::endl;
+    std::cout << std::setw(8) << "iter"
+        << std::setw(10) << "saved" << std::endl;
+    Problem::Algorithms::getMin(Optizelle::Messaging(),fns,state,PrintSaved());
+    std::cout << "Total saved: " << state.augsys_iter_saved
+        << ", stopping condition: "
+        << Optizelle::StoppingCondition::to_string(state.opt_stop)
+        << std::endl << std::endl;
+}
+
+int main(int argc,char* argv[]) {
+    // Grab the sizes of x1 and x2 in the parameter estimation problem as well
+    // as the inexactness tolerances.  Looser tolerances mean that getStep
+    // tightens them more often.
+    Natural m = argc > 1 ? std::atoi(argv[1]) : 5;
+    Natural n = argc > 2 ? std::atoi(argv[2]) : 20;
+    double xi = argc > 3 ? std::atof(argv[3]) : 3e-1;
+    double xi_4 = argc > 4 ? std::atof(argv[4]) : 1.1;
+
+    // Solve the simple equality example
+    {
+        Problem::State::t state(X_Vector{2.1,1.1},X_Vector(1));
+        state.msg_level = 0;
+        state.H_type = Optizelle::Operators::UserDefined;
+        state.iter_max = 50;
+        state.xi_all(xi);
+        state.xi_4 = xi_4;
+        state.delta = 100.;
+        state.eps_dx = 1e-16;
+        Problem::Functions::t fns;
+        fns.f.reset(new SimpleObj);
+        fns.g.reset(new SimpleEq);
+        solve("simple_equality",fns,state);
+    }
+
+    // Solve the parameter estimation problem
+    {
+        Parest p(m,n);
+        X_Vector x(m+n);
+        std::mt19937 gen(2);
+        std::normal_distribution <double> randn;
+        for(auto & x_i : x)
+            x_i = randn(gen);
+        Problem::State::t state(x,X_Vector(n));
+        state.msg_level = 0;
+        state.H_type = Optizelle::Operators::UserDefined;
+        state.iter_max = 50;
+        state.xi_all(xi);
+        state.xi_4 = xi_4;
+        state.eps_krylov = 1e-4;
+        Problem::Functions::t fns;
+        fns.f.reset(new ParestObj(p));
+        fns.g.reset(new ParestEq(p));
+        solve("parest (m=" + std::to_string(m) + ", n=" + std::to_string(n)
+            + ")",fns,state);
+    }
+
+    return EXIT_SUCCESS;
+}
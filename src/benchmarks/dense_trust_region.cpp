@@ -0,0 +1,206 @@
+// Compares the trust-region subproblem solvers on batches of small problems.
+// For each problem, we solve from a number of starting points once with
+// truncated CG and once with the dense Moré-Sorensen solver, which we use when
+// the objective provides its Hessian.  We report the average time per solve
+// along with the average number of iterations of each, and we check that
+// both find the minimizer.
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+
+// Create some type shortcuts
+typedef Optizelle::Rm <double> X;
+typedef X::Vector X_Vector;
+using Optizelle::Natural;
+using Optizelle::Rm;
+using Optizelle::ijtok;
+
+// f(x) = 1/2 <Ax,x> + <b,x> where A is a dense, positive definite matrix
+struct Quadratic : public Optizelle::ScalarValuedFunction <double,Rm> {
+    Natural m;
+    std::vector <double> A;
+    std::vector <double> b;
+    Quadratic(Natural const & m_) : m(m_), A(m_*m_), b(m_) {
+        for(Natural j=1;j<=m;j++) {
+            for(Natural i=1;i<=m;i++)
+                A[ijtok(i,j,m)]= i==j ? 1.+double(i) : 1./double(i+j);
+            b[j-1]=std::cos(double(j));
+        }
+    }
+    double eval(X_Vector const & x) const {
+        X_Vector Ax(m);
+        Optizelle::symv <double> ('U',m,1.,&(A[0]),m,&(x[0]),1,0.,&(Ax[0]),1);
+        return .5*X::innr(Ax,x)+X::innr(b,x);
+    }
+    void grad(X_Vector const & x,X_Vector & g) const {
+        X::copy(b,g);
+        Optizelle::symv <double> ('U',m,1.,&(A[0]),m,&(x[0]),1,1.,&(g[0]),1);
+    }
+    void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+        const
+    {
+        Optizelle::symv <double> ('U',m,1.,&(A[0]),m,&(dx[0]),1,0.,
+            &(H_dx[0]),1);
+    }
+    bool hessian(X_Vector const & x,std::vector <double> & H) const {
+        H = A;
+        return true;
+    }
+
+    // Minimizer, -inv(A) b
+    X_Vector minimizer() const {
+        std::vector <double> R(A);
+        X_Vector x(b);
+        X::scal(-1.,x);
+        Optizelle::Integer info(0);
+        Optizelle::potrf <double> ('U',m,&(R[0]),m,info);
+        Optizelle::trsv <double> ('U','T','N',m,&(R[0]),m,&(x[0]),1);
+        Optizelle::trsv <double> ('U','N','N',m,&(R[0]),m,&(x[0]),1);
+        return x;
+    }
+};
+
+// Extended Rosenbrock,
+//
+// f(x) = sum_i (1-x_{2i})^2 + 100 (x_{2i+1}-x_{2i}^2)^2
+struct Rosenbrock : public Optizelle::ScalarValuedFunction <double,Rm> {
+    double eval(X_Vector const & x) const {
+        double z(0.);
+        for(Natural i=0;i+1<x.size();i+=2)
+            z+=Optizelle::sq(1.-x[i])+100.*Optizelle::sq(x[i+1]-x[i]*x[i]);
+        return z;
+    }
+    void grad(X_Vector const & x,X_Vector & g) const {
+        for(Natural i=0;i+1<x.size();i+=2) {
+            g[i]=-400.*x[i]*(x[i+1]-x[i]*x[i])-2.*(1.-x[i]);
+            g[i+1]=200.*(x[i+1]-x[i]*x[i]);
+        }
+    }
+    void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+        const
+    {
+        for(Natural i=0;i+1<x.size();i+=2) {
+            H_dx[i]=(1200.*x[i]*x[i]-400.*x[i+1]+2.)*dx[i]-400.*x[i]*dx[i+1];
+            H_dx[i+1]=-400.*x[i]*dx[i]+200.*dx[i+1];
+        }
+    }
+    bool hessian(X_Vector const & x,std::vector <double> & H) const {
+        Natural const m=x.size();
+        std::fill(H.begin(),H.end(),0.);
+        for(Natural i=0;i+1<m;i+=2) {
+            H[i+i*m]=1200.*x[i]*x[i]-400.*x[i+1]+2.;
+            H[i+(i+1)*m]=H[i+1+i*m]=-400.*x[i];
+            H[i+1+(i+1)*m]=200.;
+        }
+        return true;
+    }
+};
+
+// Solves a batch of problems from the starting points x0 and returns the
+// average time per solve along with the total number of iterations
+template <typename F>
+double solve_batch(
+    Natural const & dense_size_max,
+    F const & f,
+    std::vector <X_Vector> const & x0,
+    std::vector <X_Vector> & sols,
+    Natural & iters
+) {
+    iters = 0;
+    sols.clear();
+    auto start = std::chrono::steady_clock::now();
+    for(auto const & x : x0) {
+        Optizelle::Unconstrained <double,Rm>::State::t state(x);
+        state.msg_level = 0;
+        state.H_type = Optizelle::Operators::UserDefined;
+        state.iter_max = 500;
+        state.eps_grad = 1e-10;
+        state.dense_size_max = dense_size_max;
+        Optizelle::Unconstrained <double,Rm>::Functions::t fns;
+        fns.f.reset(new F(f));
+        Optizelle::Unconstrained <double,Rm>::Algorithms
+            ::getMin(Optizelle::Messaging(),fns,state);
+        iters += state.iter;
+        sols.emplace_back(std::move(state.x));
+    }
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration <double> (stop-start).count()
+        / double(x0.size());
+}
+
+// Relative difference between two vectors
+double rel_err(X_Vector const & x,X_Vector const & y) {
+    X_Vector r(x);
+    X::axpy(-1.,y,r);
+    return std::sqrt(X::innr(r,r))/(1.+std::sqrt(X::innr(y,y)));
+}
+
+// Compares both solvers on a batch and prints a row of the table.  Returns
+// the largest relative error in the solutions.
+template <typename F>
+double compare(
+    std::string const & name,
+    Natural const & m,
+    F const & f,
+    X_Vector const & x_star,
+    std::vector <X_Vector> const & x0
+) {
+    std::vector <X_Vector> sols_krylov, sols_dense;
+    Natural iters_krylov(0), iters_dense(0);
+    double t_krylov = solve_batch(0,f,x0,sols_krylov,iters_krylov);
+    double t_dense = solve_batch(m,f,x0,sols_dense,iters_dense);
+    double err(0.);
+    for(Natural i=0;i<x0.size();i++)
+        err = std::max(err,std::max(rel_err(sols_krylov[i],x_star),
+            rel_err(sols_dense[i],x_star)));
+
+    std::cout << std::setw(12) << name
+        << std::setw(6) << m
+        << std::setw(16) << std::scientific << std::setprecision(3)
+        << t_krylov
+        << std::setw(16) << t_dense
+        << std::setw(10) << std::fixed << std::setprecision(2)
+        << t_krylov/t_dense
+        << std::setw(10) << std::setprecision(1)
+        << double(iters_krylov)/double(x0.size())
+        << std::setw(10) << double(iters_dense)/double(x0.size())
+        << std::endl;
+    return err;
+}
+
+int main(int argc,char* argv[]) {
+    // Grab the number of solves in each batch
+    Natural nsolves = argc > 1 ? std::atoi(argv[1]) : 1000;
+
+    std::cout << std::setw(12) << "problem"
+        << std::setw(6) << "m"
+        << std::setw(16) << "krylov (s)"
+        << std::setw(16) << "dense (s)"
+        << std::setw(10) << "speedup"
+        << std::setw(10) << "it kry"
+        << std::setw(10) << "it dense" << std::endl;
+
+    double err(0.);
+    for(Natural m : {2,10,50,200}) {
+        // Starting points around the usual one for Rosenbrock
+        std::vector <X_Vector> x0(nsolves,X_Vector(m));
+        for(Natural k=0;k<nsolves;k++)
+            for(Natural i=0;i<m;i++)
+                x0[k][i] = (i%2==0 ? -1.2 : 1.)
+                    + 0.5*std::sin(double(k*m+i+1));
+
+        Quadratic quadratic(m);
+        err = std::max(err,compare("quadratic",m,quadratic,
+            quadratic.minimizer(),x0));
+        err = std::max(err,compare("rosenbrock",m,Rosenbrock(),
+            X_Vector(m,1.),x0));
+    }
+
+    std::cout << "Largest relative error in the solutions: "
+        << std::scientific << err << std::endl;
+
+    return err < 1e-4 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,203 @@
+// Times the unconstrained and inequality constrained solvers on the
+// distributed version of R^m with 1, 2, 4, 8, and 16 ranks that run as
+// threads in one process.  The objective is the separable
+//
+// f(x) = sum_i d_i/2 (x_i-1)^2 + 1/4 x_i^4
+//
+// where d_i is spaced logarithmically in [1,1e4], so that the truncated CG
+// solves in the trust-region method take a fair number of iterations.  The
+// inequality constrained problem adds the bounds x_i >= 1.2 on the even
+// elements and x_i >= 0 on the odd ones.  Each rank runs its kernels on a
+// single thread, so the speedup comes only from the partitioning.  Every
+// inner product, barrier, and line search costs one reduction across the
+// ranks, so for small n the synchronization dominates.  We report the
+// number of optimization and Krylov iterations, which should not depend on
+// the number of ranks except through rounding, along with the time, the
+// speedup over one rank, and the parallel efficiency.
+//
+// The arguments are the size n and the largest number of ranks.
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/distributed.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Create some type shortcuts
+using Optizelle::Natural;
+using Optizelle::DistributedRm;
+typedef Optizelle::Communicator <double> Communicator;
+typedef Optizelle::DistributedRm <double> XD;
+typedef XD::Vector XD_Vector;
+
+// Data for the elements of this rank
+struct Piece {
+    // Global indices of the elements, [begin,end)
+    Natural begin;
+    Natural end;
+
+    // Weights on the quadratic terms
+    std::vector <double> d;
+
+    // Lower bounds
+    std::vector <double> l;
+
+    Piece(Natural const & n,Communicator const & comm) :
+        begin(XD::partition(n,comm).first),
+        end(XD::partition(n,comm).second),
+        d(end-begin),
+        l(end-begin)
+    {
+        for(Natural i=0;i<end-begin;i++) {
+            d[i] = std::pow(10.,4.*double(begin+i)/double(n));
+            l[i] = (begin+i)%2==0 ? 1.2 : 0.;
+        }
+    }
+};
+
+// f(x) = sum_i d_i/2 (x_i-1)^2 + 1/4 x_i^4
+struct MyObj : public Optizelle::ScalarValuedFunction <double,DistributedRm> {
+    Piece const piece;
+    explicit MyObj(Piece const & piece_) : piece(piece_) {}
+
+    double eval(XD_Vector const & x) const {
+        double z(0.);
+        for(Natural i=0;i<x.local.size();i++)
+            z+=0.5*piece.d[i]*Optizelle::sq(x.local[i]-1.)
+                +0.25*Optizelle::sq(Optizelle::sq(x.local[i]));
+        x.comm->allreduce_sum(&z,1);
+        return z;
+    }
+    void grad(XD_Vector const & x,XD_Vector & g) const {
+        for(Natural i=0;i<x.local.size();i++)
+            g.local[i]=piece.d[i]*(x.local[i]-1.)
+                +x.local[i]*x.local[i]*x.local[i];
+    }
+    void hessvec(XD_Vector const & x,XD_Vector const & dx,XD_Vector & H_dx)
+        const
+    {
+        for(Natural i=0;i<x.local.size();i++)
+            H_dx.local[i]=(piece.d[i]+3.*x.local[i]*x.local[i])*dx.local[i];
+    }
+};
+
+// h(x) = x - l >= 0
+struct MyIneq :
+    public Optizelle::VectorValuedFunction <double,DistributedRm,DistributedRm>
+{
+    Piece const piece;
+    explicit MyIneq(Piece const & piece_) : piece(piece_) {}
+
+    void eval(XD_Vector const & x,XD_Vector & y) const {
+        for(Natural i=0;i<x.local.size();i++)
+            y.local[i]=x.local[i]-piece.l[i];
+    }
+    void p(XD_Vector const & x,XD_Vector const & dx,XD_Vector & y) const {
+        XD::copy(dx,y);
+    }
+    void ps(XD_Vector const & x,XD_Vector const & dy,XD_Vector & z) const {
+        XD::copy(dy,z);
+    }
+    void pps(
+        XD_Vector const & x,
+        XD_Vector const & dx,
+        XD_Vector const & dy,
+        XD_Vector & z
+    ) const {
+        XD::zero(z);
+    }
+};
+
+// Results from rank 0
+struct Result {
+    Natural iter;
+    Natural krylov_iter;
+    double time;
+};
+
+// Sets up the state for either problem class
+template <typename State>
+void setup(State & state) {
+    state.msg_level = 0;
+    state.H_type = Optizelle::Operators::UserDefined;
+}
+
+// Solves the unconstrained or the inequality constrained problem on p ranks
+Result solve(Natural const & n,Natural const & p,bool const & constrained) {
+    Result result{0,0,0.};
+    Optizelle::runLocalRanks <double> (p,[&](Communicator const & comm) {
+        #ifdef _OPENMP
+        omp_set_num_threads(1);
+        #endif
+        Optizelle::Messaging msg;
+        Piece piece(n,comm);
+        XD_Vector x(comm,std::vector <double> (piece.end-piece.begin,2.));
+        Natural iter, krylov_iter;
+        auto start = std::chrono::steady_clock::now();
+        if(!constrained) {
+            typedef Optizelle::Unconstrained <double,DistributedRm> Problem;
+            Problem::State::t state(x);
+            setup(state);
+            Problem::Functions::t fns;
+            fns.f.reset(new MyObj(piece));
+            Problem::Algorithms::getMin(msg,fns,state);
+            iter = state.iter;
+            krylov_iter = state.krylov_iter_total;
+        } else {
+            typedef Optizelle::InequalityConstrained
+                <double,DistributedRm,DistributedRm> Problem;
+            Problem::State::t state(x,XD::init(x));
+            setup(state);
+            Problem::Functions::t fns;
+            fns.f.reset(new MyObj(piece));
+            fns.h.reset(new MyIneq(piece));
+            Problem::Algorithms::getMin(msg,fns,state);
+            iter = state.iter;
+            krylov_iter = state.krylov_iter_total;
+        }
+        double elapsed = std::chrono::duration <double> (
+            std::chrono::steady_clock::now()-start).count();
+        if(comm.rank()==0)
+            result = Result{iter,krylov_iter,elapsed};
+    });
+    return result;
+}
+
+int main(int argc,char* argv[]) {
+    // Grab the size and the largest number of ranks
+    Natural n = argc > 1 ? Natural(std::atof(argv[1])) : 1000000;
+    Natural p_max = argc > 2 ? std::atoi(argv[2]) : 16;
+
+    // Run the scaling study for each problem class
+    for(bool constrained : {false,true}) {
+        std::cout << (constrained ? "inequality" : "unconstrained")
+            << " (n=" << n << ")" << std::endl;
+        std::cout << std::setw(8) << "ranks"
+            << std::setw(8) << "iter"
+            << std::setw(10) << "krylov"
+            << std::setw(12) << "time"
+            << std::setw(10) << "speedup"
+            << std::setw(12) << "efficiency" << std::endl;
+        double time1(0.);
+        for(Natural p=1;p<=p_max;p*=2) {
+            Result r = solve(n,p,constrained);
+            time1 = p==1 ? r.time : time1;
+            std::cout << std::setw(8) << p
+                << std::setw(8) << r.iter
+                << std::setw(10) << r.krylov_iter
+                << std::setw(12) << std::scientific << std::setprecision(3)
+                << r.time
+                << std::setw(10) << std::fixed << std::setprecision(2)
+                << time1/r.time
+                << std::setw(12) << time1/r.time/double(p) << std::endl;
+        }
+        std::cout << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
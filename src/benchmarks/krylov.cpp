@@ -0,0 +1,381 @@
+// Times the Krylov solvers in linalg.h on synthetic operators.  For each
+// combination of solver, operator, size, orthogonalization count or restart
+// frequency, and preconditioner, we run a fixed number of iterations and
+// report the time per iteration, the number of vector operations and
+// operator applications per iteration, and the memory bandwidth that we
+// achieve.  The operator applications include the preconditioners and the
+// shape of the trust-region.  The operators are
+//
+// diag      : diagonal with eigenvalues spaced logarithmically in [1,cond]
+// laplace2d : 5-point stencil of the Laplacian on a k x k grid
+// laplace3d : 7-point stencil of the Laplacian on a k x k x k grid
+// saddle    : [I B'; B 0] where B is the forward difference operator, which
+//             is symmetric and indefinite
+//
+// Since truncated CD only works with positive definite operators, we don't
+// run it on the saddle point operator.  The preconditioners are the identity
+// and Jacobi, which is the inverse of the diagonal for the Laplacians and the
+// inverse of the diagonal of [I 0; 0 BB'] for the saddle point operator.
+// Since Jacobi is exact for the diagonal operator, we instead round each
+// eigenvalue down to a power of 10 before we invert it, which leaves a
+// spectrum in [1,10).
+//
+// We count the bytes that each vector operation and operator application
+// reads and writes, so the bandwidth ignores anything that stays in cache.
+// We count the workspace of the solvers, which includes the orthogonalized
+// vectors, but not the memory allocations.
+//
+// The arguments are the largest size n, which grows by factors of 10 from
+// 10^4, the minimum time in seconds that we spend on each benchmark, and a
+// filter.  We only run the benchmarks whose name contains the filter.  Names
+// have the form solver/operator/n:<n>/<orthog or rst>:<value>/prec:<prec>.
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/linalg.h"
+
+using Optizelle::Natural;
+
+// Counts the vector operations along with the bytes that they move and
+// otherwise defers to Rm
+template <typename Real>
+struct Counted {
+    // Disallow constructors
+    NO_CONSTRUCTORS(Counted)
+
+    // Create some type shortcuts
+    typedef Optizelle::Rm <Real> X;
+    typedef typename X::Vector Vector;
+
+    // Number of operations and bytes moved since the last reset
+    static Natural ops;
+    static double bytes;
+    static void reset() {
+        ops = 0;
+        bytes = 0.;
+    }
+
+    // Records an operation that touches the given number of vectors
+    static void count(Vector const & x,Natural const & vectors) {
+        ops++;
+        bytes += double(vectors*x.size()*sizeof(Real));
+    }
+
+    static Vector init(Vector const & x) {
+        return X::init(x);
+    }
+    static void copy(Vector const & x, Vector & y) {
+        count(x,2);
+        X::copy(x,y);
+    }
+    static void scal(Real const & alpha, Vector & x) {
+        count(x,2);
+        X::scal(alpha,x);
+    }
+    static void axpy(Real const & alpha, Vector const & x, Vector & y) {
+        count(x,3);
+        X::axpy(alpha,x,y);
+    }
+    static Real innr(Vector const & x,Vector const & y) {
+        count(x,2);
+        return X::innr(x,y);
+    }
+    static void zero(Vector & x) {
+        count(x,1);
+        X::zero(x);
+    }
+};
+template <typename Real>
+Natural Counted <Real>::ops = 0;
+template <typename Real>
+double Counted <Real>::bytes = 0.;
+
+// Create some type shortcuts
+typedef Counted <double> X;
+typedef X::Vector X_Vector;
+typedef Optizelle::Operator <double,Counted,Counted> Operator;
+
+// Operators count their applications along with the bytes that they move
+struct SyntheticOperator : public Operator {
+    static Natural applies;
+    static double bytes;
+
+    // Size of the vectors that the operator acts on
+    virtual Natural size() const = 0;
+
+    // Records an application that touches the given number of vectors
+    void count(Natural const & vectors) const {
+        applies++;
+        bytes += double(vectors*size()*sizeof(double));
+    }
+};
+Natural SyntheticOperator::applies = 0;
+double SyntheticOperator::bytes = 0.;
+
+// y <- d o x
+struct Diagonal : public SyntheticOperator {
+    std::vector <double> d;
+    explicit Diagonal(std::vector <double> const & d_) : d(d_) {}
+    Natural size() const {
+        return d.size();
+    }
+    void eval(X_Vector const & x,X_Vector & y) const {
+        count(3);
+        Natural const n = d.size();
+        #ifdef _OPENMP
+        #pragma omp parallel for schedule(static)
+        #endif
+        for(Natural i=0;i<n;i++)
+            y[i]=d[i]*x[i];
+    }
+};
+
+// The Laplacian with Dirichlet boundary conditions on a grid with k points
+// in each of dim dimensions.  We use the 2 dim + 1 point stencil, scaled so
+// that the diagonal is 2 dim.
+struct Laplacian : public SyntheticOperator {
+    Natural k;
+    Natural dim;
+    Laplacian(Natural const & k_,Natural const & dim_) : k(k_), dim(dim_) {}
+    Natural size() const {
+        return dim==2 ? k*k : k*k*k;
+    }
+    void eval(X_Vector const & x,X_Vector & y) const {
+        count(2);
+        Natural const n = size();
+        Natural const kk = k*k;
+        #ifdef _OPENMP
+        #pragma omp parallel for schedule(static)
+        #endif
+        for(Natural i=0;i<n;i++) {
+            Natural const ix = i % k;
+            Natural const iy = (i / k) % k;
+            double y_i = double(2*dim)*x[i];
+            if(ix>0) y_i-=x[i-1];
+            if(ix+1<k) y_i-=x[i+1];
+            if(iy>0) y_i-=x[i-k];
+            if(iy+1<k) y_i-=x[i+k];
+            if(dim==3) {
+                Natural const iz = i / kk;
+                if(iz>0) y_i-=x[i-kk];
+                if(iz+1<k) y_i-=x[i+kk];
+            }
+            y[i]=y_i;
+        }
+    }
+};
+
+// [y1;y2] <- [I B'; B 0] [x1;x2] where x1 and x2 each hold m elements and
+// (B x1)_i = x1_{i+1} - x1_i with x1_{m+1} = 0
+struct SaddlePoint : public SyntheticOperator {
+    Natural m;
+    explicit SaddlePoint(Natural const & m_) : m(m_) {}
+    Natural size() const {
+        return 2*m;
+    }
+    void eval(X_Vector const & x,X_Vector & y) const {
+        count(2);
+        double const * const x1 = x.data();
+        double const * const x2 = x.data()+m;
+        double * const y1 = y.data();
+        double * const y2 = y.data()+m;
+        #ifdef _OPENMP
+        #pragma omp parallel for schedule(static)
+        #endif
+        for(Natural i=0;i<m;i++) {
+            y1[i]=x1[i]-x2[i]+(i>0 ? x2[i-1] : 0.);
+            y2[i]=(i+1<m ? x1[i+1] : 0.)-x1[i];
+        }
+    }
+};
+
+// The identity operator
+struct Identity : public SyntheticOperator {
+    Natural n;
+    explicit Identity(Natural const & n_) : n(n_) {}
+    Natural size() const {
+        return n;
+    }
+    void eval(X_Vector const & x,X_Vector & y) const {
+        count(2);
+        X::X::copy(x,y);
+    }
+};
+
+// The synthetic problems along with their Jacobi preconditioners
+struct Problem {
+    std::string name;
+    std::unique_ptr <SyntheticOperator> A;
+    std::unique_ptr <SyntheticOperator> M_inv;
+    bool definite;
+};
+
+// Creates the operator with the given name and about n unknowns
+Problem make_problem(std::string const & name,Natural const & n) {
+    Problem p;
+    p.name = name;
+    p.definite = true;
+    if(name=="diag") {
+        double const cond = 1e4;
+        std::vector <double> d(n), d_inv(n);
+        for(Natural i=0;i<n;i++) {
+            d[i] = std::pow(cond,double(i)/double(n-1));
+            d_inv[i] = std::pow(10.,-std::floor(std::log10(d[i])));
+        }
+        p.A.reset(new Diagonal(d));
+        p.M_inv.reset(new Diagonal(d_inv));
+    } else if(name=="laplace2d" || name=="laplace3d") {
+        Natural const dim = name=="laplace2d" ? 2 : 3;
+        Natural const k = Natural(std::round(std::pow(double(n),1./dim)));
+        p.A.reset(new Laplacian(k,dim));
+        p.M_inv.reset(new Diagonal(std::vector <double> (p.A->size(),
+            1./double(2*dim))));
+    } else {
+        Natural const m = n/2;
+        p.A.reset(new SaddlePoint(m));
+        std::vector <double> d_inv(2*m,1.);
+        for(Natural i=0;i<m;i++)
+            d_inv[m+i] = i+1<m ? .5 : 1.;
+        p.M_inv.reset(new Diagonal(d_inv));
+        p.definite = false;
+    }
+    return p;
+}
+
+// Repeats f until we've spent at least min_time seconds and returns the
+// average time of a single call along with the number of calls
+template <typename F>
+std::pair <double,Natural> time_it(double const & min_time,F const & f) {
+    Natural reps = 1;
+    while(true) {
+        auto start = std::chrono::steady_clock::now();
+        for(Natural i=0;i<reps;i++)
+            f();
+        double elapsed = std::chrono::duration <double> (
+            std::chrono::steady_clock::now()-start).count();
+        if(elapsed >= min_time || reps >= (Natural(1) << 30))
+            return {elapsed/double(reps),reps};
+        reps = elapsed > 0.
+            ? std::max(reps+1,Natural(1.2*min_time/elapsed*reps))
+            : 10*reps;
+    }
+}
+
+// Runs a single benchmark.  The solve returns the number of iterations.  We
+// count the operations on a first, untimed, solve and then time the rest.
+template <typename Solve>
+void run(
+    std::string const & name,
+    double const & min_time,
+    Solve const & solve
+) {
+    X::reset();
+    SyntheticOperator::applies = 0;
+    SyntheticOperator::bytes = 0.;
+    Natural const iter = std::max(solve(),Natural(1));
+    double const ops = double(X::ops)/double(iter);
+    double const applies = double(SyntheticOperator::applies)/double(iter);
+    double const bytes = (X::bytes+SyntheticOperator::bytes)/double(iter);
+    auto t = time_it(min_time,[&]() { solve(); });
+    double const time = t.first/double(iter);
+    std::cout << std::left << std::setw(56) << name << std::right
+        << std::setw(8) << iter
+        << std::setw(12) << std::scientific << std::setprecision(3) << time
+        << std::setw(12) << std::fixed << std::setprecision(1) << ops
+        << std::setw(12) << applies
+        << std::setw(10) << std::setprecision(2) << bytes/time*1e-9
+        << std::setw(8) << t.second << std::endl;
+}
+
+int main(int argc,char* argv[]) {
+    // Grab the largest size, the minimum time per benchmark, and the filter
+    Natural max_n = argc > 1 ? std::atof(argv[1]) : 1e5;
+    double min_time = argc > 2 ? std::atof(argv[2]) : 0.1;
+    std::string filter = argc > 3 ? argv[3] : "";
+
+    // Run a fixed number of iterations unless we converge first
+    double const eps = 1e-12;
+    Natural const iter_max = 100;
+    double const delta = std::numeric_limits <double>::infinity();
+
+    std::cout << std::left << std::setw(56) << "benchmark" << std::right
+        << std::setw(8) << "iter"
+        << std::setw(12) << "time/iter"
+        << std::setw(12) << "ops/iter"
+        << std::setw(12) << "apply/iter"
+        << std::setw(10) << "GB/s"
+        << std::setw(8) << "reps" << std::endl;
+
+    for(Natural n=10000;n<=max_n;n*=10)
+        for(auto const & op : std::vector <std::string>
+            {"diag","laplace2d","laplace3d","saddle"})
+        {
+            Problem p(make_problem(op,n));
+            Natural const size = p.A->size();
+            Identity I(size);
+
+            // Create a right hand side and workspace
+            X_Vector b(size);
+            for(Natural i=0;i<size;i++)
+                b[i] = std::cos(double(i));
+            X_Vector x(size), x_cp(size), x_cntr(size,0.);
+            double norm_r0(0.), norm_r(0.);
+            Natural iter(0);
+            Optizelle::KrylovStop::t stop;
+            Optizelle::EmptyGMRESManipulator <double,Counted> gmanip;
+
+            for(auto const & prec : std::vector <std::string> {"none","jacobi"})
+            {
+                Operator const & M_inv = prec=="none"
+                    ? static_cast <Operator const &> (I) : *p.M_inv;
+                std::string const suffix = "/prec:" + prec;
+                auto prefix = [&](std::string const & solver) {
+                    std::stringstream ss;
+                    ss << solver << "/" << op << "/n:" << size;
+                    return ss.str();
+                };
+
+                for(Natural orthog_max : {1,10}) {
+                    std::string const orthog = "/orthog:"
+                        + std::to_string(orthog_max);
+                    std::string name = prefix("truncated_cd") + orthog
+                        + suffix;
+                    if(p.definite && name.find(filter)!=std::string::npos)
+                        run(name,min_time,[&]() {
+                            Optizelle::truncated_cd <double,Counted> (*p.A,b,
+                                M_inv,I,eps,iter_max,orthog_max,delta,x_cntr,
+                                false,x,x_cp,norm_r0,norm_r,iter,stop);
+                            return iter;
+                        });
+
+                    name = prefix("truncated_minres") + orthog + suffix;
+                    if(name.find(filter)!=std::string::npos)
+                        run(name,min_time,[&]() {
+                            Optizelle::truncated_minres <double,Counted> (
+                                *p.A,b,M_inv,I,eps,iter_max,orthog_max,delta,
+                                x_cntr,x,x_cp,norm_r0,norm_r,iter,stop);
+                            return iter;
+                        });
+                }
+
+                for(Natural rst_freq : {10,50}) {
+                    std::string const name = prefix("gmres") + "/rst:"
+                        + std::to_string(rst_freq) + suffix;
+                    if(name.find(filter)!=std::string::npos)
+                        run(name,min_time,[&]() {
+                            X::X::zero(x);
+                            return Optizelle::gmres <double,Counted> (*p.A,b,
+                                eps,iter_max,rst_freq,I,M_inv,gmanip,x).second;
+                        });
+                }
+            }
+        }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,157 @@
+// Measures the memory bandwidth of copy, axpy, and innr in R^m on 1, 2,
+// and 4 NUMA nodes.  We compare Rm, whose vectors are zeroed by the thread
+// that creates them and so live on a single node, against NumaRm, whose
+// vectors are first touched in parallel with the same static schedule as
+// its kernels, both with and without huge pages.  For each count of nodes,
+// we restrict the process to the CPUs of the first nodes, run one OpenMP
+// thread per CPU, and pin each thread to its own CPU, so that the threads
+// keep the pages that they touched first.  We skip the counts of nodes that
+// the machine doesn't have.  The bandwidth counts each element that we read
+// or write once, so copy and innr move 2n elements and axpy moves 3n.
+//
+// The arguments are the size n and the number of repetitions.
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sched.h>
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/numa.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Create some type shortcuts
+using Optizelle::Natural;
+typedef Optizelle::Rm <double> X;
+typedef Optizelle::NumaRm <double> XN;
+
+// Reads the CPUs of NUMA node i.  The list looks like 0-3,8-11.
+std::vector <int> cpus(Natural const & i) {
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(i)
+        + "/cpulist");
+    std::vector <int> result;
+    std::string range;
+    while(std::getline(file,range,',')) {
+        std::istringstream in(range);
+        int first, last;
+        char dash;
+        in >> first;
+        if(!(in >> dash >> last))
+            last = first;
+        for(int cpu=first;cpu<=last;cpu++)
+            result.push_back(cpu);
+    }
+    return result;
+}
+
+// Number of NUMA nodes.  Machines without NUMA look like a single node.
+Natural nodes() {
+    Natural n = 0;
+    while(!cpus(n).empty())
+        n++;
+    return n > 0 ? n : 1;
+}
+
+// Runs one OpenMP thread on each CPU in the list and pins each thread to
+// its CPU
+void pin(std::vector <int> const & list) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(auto const & cpu : list)
+        CPU_SET(cpu,&set);
+    sched_setaffinity(0,sizeof(set),&set);
+    #ifdef _OPENMP
+    omp_set_num_threads(int(list.size()));
+    #pragma omp parallel
+    {
+        cpu_set_t mine;
+        CPU_ZERO(&mine);
+        CPU_SET(list[omp_get_thread_num()],&mine);
+        sched_setaffinity(0,sizeof(mine),&mine);
+    }
+    #endif
+}
+
+// Bandwidth in GB/s of copy, axpy, and innr on vectors of the space XX
+// that we derive from x
+template <typename XX>
+std::vector <double> bandwidth(
+    typename XX::Vector const & x,
+    Natural const & reps
+) {
+    auto y = XX::init(x);
+    auto z = XX::init(x);
+    XX::id(y);
+    XX::id(z);
+
+    // Times f over the repetitions and converts it into GB/s when f moves
+    // the given number of elements
+    auto time = [&](Natural const & elements,auto const & f) {
+        f();
+        auto start = std::chrono::steady_clock::now();
+        for(Natural i=0;i<reps;i++)
+            f();
+        double elapsed = std::chrono::duration <double> (
+            std::chrono::steady_clock::now()-start).count();
+        return double(elements*x.size()*sizeof(double)*reps)/elapsed/1e9;
+    };
+
+    double sum(0.);
+    return {
+        time(2,[&]() { XX::copy(y,z); }),
+        time(3,[&]() { XX::axpy(1e-8,y,z); }),
+        time(2,[&]() { sum+=XX::innr(y,z); })};
+}
+
+int main(int argc,char* argv[]) {
+    // Grab the size and the number of repetitions
+    Natural n = argc > 1 ? Natural(std::atof(argv[1])) : 50000000;
+    Natural reps = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    // Run the study on each count of nodes
+    Natural const available = nodes();
+    std::cout << "n=" << n << ", NUMA nodes=" << available << std::endl;
+    std::cout << std::setw(8) << "nodes"
+        << std::setw(8) << "threads"
+        << std::setw(10) << "space"
+        << std::setw(10) << "copy"
+        << std::setw(10) << "axpy"
+        << std::setw(10) << "innr" << std::endl;
+    for(Natural k : {1,2,4}) {
+        if(k > available) {
+            std::cout << std::setw(8) << k << "  skipped" << std::endl;
+            continue;
+        }
+        std::vector <int> list;
+        for(Natural i=0;i<k;i++) {
+            auto node = cpus(i);
+            list.insert(list.end(),node.begin(),node.end());
+        }
+        if(list.empty())
+            list.push_back(sched_getcpu());
+        pin(list);
+
+        // Vectors from Rm are first touched by this thread
+        std::vector <std::pair <std::string,std::vector <double> > > results;
+        results.emplace_back("Rm",
+            bandwidth <X> (std::vector <double> (n),reps));
+        results.emplace_back("NumaRm",
+            bandwidth <XN> (XN::Vector(n,false),reps));
+        results.emplace_back("NumaRm+HP",
+            bandwidth <XN> (XN::Vector(n,true),reps));
+        for(auto const & r : results)
+            std::cout << std::setw(8) << k
+                << std::setw(8) << list.size()
+                << std::setw(10) << r.first
+                << std::fixed << std::setprecision(2)
+                << std::setw(10) << r.second[0]
+                << std::setw(10) << r.second[1]
+                << std::setw(10) << r.second[2] << std::endl;
+    }
+}
@@ -0,0 +1,144 @@
+// A version of the parameter estimation example that scales,
+//
+// min .5 || x2 - d ||^2 + .5 beta || x1 || ^2 s.t. (sum_i A_i x1_i) x2 = b,
+//
+// where A_i, d, and b come from a seeded random number generator.
+
+#ifndef PAREST_H
+#define PAREST_H
+
+#include <random>
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+
+// Create some type shortcuts
+typedef Optizelle::Rm <double> X;
+typedef X::Vector X_Vector;
+using Optizelle::Natural;
+using Optizelle::Rm;
+
+// Data for the parameter estimation problem.  The variable x holds x1 in its
+// first m elements and x2 in its last n elements.
+struct Parest {
+    Natural m;
+    Natural n;
+    double beta;
+    std::vector <std::vector <double>> A;
+    std::vector <double> b;
+    std::vector <double> d;
+    Parest(Natural const & m_,Natural const & n_) :
+        m(m_), n(n_), beta(1e-2), A(m,std::vector <double> (n*n)), b(n), d(n)
+    {
+        std::mt19937 gen(1);
+        std::normal_distribution <double> randn;
+        for(auto & A_i : A)
+            for(auto & a : A_i)
+                a = randn(gen);
+        for(auto & b_i : b)
+            b_i = randn(gen);
+        for(auto & d_i : d)
+            d_i = randn(gen);
+    }
+
+    // y <- (sum_i A_i u_i) v
+    void apply(
+        double const * u,
+        double const * v,
+        double * y
+    ) const {
+        for(Natural k=0;k<n;k++)
+            y[k]=0.;
+        for(Natural i=0;i<m;i++)
+            for(Natural j=0;j<n;j++)
+                for(Natural k=0;k<n;k++)
+                    y[k]+=u[i]*A[i][k+j*n]*v[j];
+    }
+
+    // z <- (sum_i A_i u_i)' w
+    void apply_t(
+        double const * u,
+        double const * w,
+        double * z
+    ) const {
+        for(Natural j=0;j<n;j++)
+            z[j]=0.;
+        for(Natural i=0;i<m;i++)
+            for(Natural j=0;j<n;j++)
+                for(Natural k=0;k<n;k++)
+                    z[j]+=u[i]*A[i][k+j*n]*w[k];
+    }
+
+    // z_i <- v' A_i' w
+    void adjoint_x1(
+        double const * v,
+        double const * w,
+        double * z
+    ) const {
+        for(Natural i=0;i<m;i++) {
+            z[i]=0.;
+            for(Natural j=0;j<n;j++)
+                for(Natural k=0;k<n;k++)
+                    z[i]+=v[j]*A[i][k+j*n]*w[k];
+        }
+    }
+};
+
+// f(x1,x2) = .5 || x2 - d ||^2 + .5 beta || x1 ||^2
+struct ParestObj : public Optizelle::ScalarValuedFunction <double,Rm> {
+    Parest const & data;
+    ParestObj(Parest const & data_) : data(data_) {}
+    double eval(X_Vector const & x) const {
+        double f(0.);
+        for(Natural i=0;i<data.m;i++)
+            f+=.5*data.beta*Optizelle::sq(x[i]);
+        for(Natural j=0;j<data.n;j++)
+            f+=.5*Optizelle::sq(x[data.m+j]-data.d[j]);
+        return f;
+    }
+    void grad(X_Vector const & x,X_Vector & g) const {
+        for(Natural i=0;i<data.m;i++)
+            g[i]=data.beta*x[i];
+        for(Natural j=0;j<data.n;j++)
+            g[data.m+j]=x[data.m+j]-data.d[j];
+    }
+    void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+        const
+    {
+        for(Natural i=0;i<data.m;i++)
+            H_dx[i]=data.beta*dx[i];
+        for(Natural j=0;j<data.n;j++)
+            H_dx[data.m+j]=dx[data.m+j];
+    }
+};
+
+// g(x1,x2) = (sum_i A_i x1_i) x2 - b
+struct ParestEq : public Optizelle::VectorValuedFunction <double,Rm,Rm> {
+    Parest const & data;
+    ParestEq(Parest const & data_) : data(data_) {}
+    void eval(X_Vector const & x,X_Vector & y) const {
+        data.apply(&x[0],&x[data.m],&y[0]);
+        for(Natural k=0;k<data.n;k++)
+            y[k]-=data.b[k];
+    }
+    void p(X_Vector const & x,X_Vector const & dx,X_Vector & y) const {
+        X_Vector y_tmp(data.n);
+        data.apply(&dx[0],&x[data.m],&y[0]);
+        data.apply(&x[0],&dx[data.m],&y_tmp[0]);
+        X::axpy(1.,y_tmp,y);
+    }
+    void ps(X_Vector const & x,X_Vector const & dy,X_Vector & z) const {
+        data.adjoint_x1(&x[data.m],&dy[0],&z[0]);
+        data.apply_t(&x[0],&dy[0],&z[data.m]);
+    }
+    void pps(
+        X_Vector const & x,
+        X_Vector const & dx,
+        X_Vector const & dy,
+        X_Vector & z
+    ) const {
+        data.adjoint_x1(&dx[data.m],&dy[0],&z[0]);
+        data.apply_t(&dx[0],&dy[0],&z[data.m]);
+    }
+};
+
+#endif
@@ -0,0 +1,167 @@
+// Times the Jordan product, its inverse, the barrier, and the line search on
+// a problem with a large number of small second-order cones.  We compare the
+// routines in SQL, which process all of the second-order cones together, to
+// a path that handles each block on its own with the BLAS wrappers.
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+
+// Create some type shortcuts
+typedef Optizelle::SQL <double> Z;
+typedef Z::Vector Z_Vector;
+using Optizelle::Natural;
+
+// Jordan product, computed one block at a time
+void prod_blockwise(Z_Vector const & x,Z_Vector const & y,Z_Vector & z) {
+    for(Natural blk=1;blk<=x.numBlocks();blk++) {
+        Natural mbar=x.blkSize(blk)-1;
+        z.naught(blk)=Optizelle::dot <double> (
+            mbar+1,&(x.front(blk)),1,&(y.front(blk)),1);
+        Optizelle::copy <double> (mbar,&(y.bar(blk)),1,&(z.bar(blk)),1);
+        Optizelle::scal <double> (mbar,x.naught(blk),&(z.bar(blk)),1);
+        Optizelle::axpy <double> (mbar,y.naught(blk),&(x.bar(blk)),1,
+            &(z.bar(blk)),1);
+    }
+}
+
+// Jordan product inverse, computed one block at a time with the Schur
+// complement of the arrow matrix
+void linv_blockwise(Z_Vector const & x,Z_Vector const & y,Z_Vector & z) {
+    for(Natural blk=1;blk<=x.numBlocks();blk++) {
+        Natural mbar=x.blkSize(blk)-1;
+        std::vector <double> invSchur_ybar(mbar);
+        Optizelle::copy <double> (mbar,&(y.bar(blk)),1,
+            &(invSchur_ybar.front()),1);
+        Z::invSchur(mbar,&(x.front(blk)),&(invSchur_ybar[0]));
+        double a = y.naught(blk) / (x.naught(blk) - (1./x.naught(blk)) *
+            Optizelle::dot <double> (mbar,&(x.bar(blk)),1,&(x.bar(blk)),1));
+        double b = -Optizelle::dot <double> (mbar,
+            &(x.bar(blk)),1,&(invSchur_ybar.front()),1) / x.naught(blk);
+        z.naught(blk) = a + b;
+        Optizelle::copy <double> (mbar,&(x.bar(blk)),1,&(z.bar(blk)),1);
+        Z::invSchur(mbar,&(x.front(blk)),&(z.bar(blk)));
+        Optizelle::scal <double> (mbar,-y.naught(blk)/x.naught(blk),
+            &(z.bar(blk)),1);
+        Optizelle::axpy <double> (mbar,1.,&(invSchur_ybar.front()),1,
+            &(z.bar(blk)),1);
+    }
+}
+
+// Barrier function, computed one block at a time
+double barr_blockwise(Z_Vector const & x) {
+    double z(0.);
+    for(Natural blk=1;blk<=x.numBlocks();blk++) {
+        Natural mbar=x.blkSize(blk)-1;
+        z+=0.5 * log(x.naught(blk)*x.naught(blk)
+            -Optizelle::dot <double> (mbar,&(x.bar(blk)),1,&(x.bar(blk)),1));
+    }
+    return z;
+}
+
+// Line search, computed one block at a time
+double srch_blockwise(Z_Vector const & x,Z_Vector const & y) {
+    double alpha=std::numeric_limits <double>::infinity();
+    for(Natural blk=1;blk<=x.numBlocks();blk++) {
+        Natural mbar=x.blkSize(blk)-1;
+        double alpha0 = -y.naught(blk)/x.naught(blk);
+        double a = x.naught(blk)*x.naught(blk)
+            - Optizelle::dot <double> (mbar,&(x.bar(blk)),1,&(x.bar(blk)),1);
+        double b = 2.*(x.naught(blk)*y.naught(blk)
+            - Optizelle::dot <double> (mbar,&(x.bar(blk)),1,&(y.bar(blk)),1));
+        double c = y.naught(blk)*y.naught(blk)
+            - Optizelle::dot <double> (mbar,&(y.bar(blk)),1,&(y.bar(blk)),1);
+        Natural nroots(0);
+        double alpha1(-1.);
+        double alpha2(-1.);
+        Optizelle::quad_equation(a,b,c,nroots,alpha1,alpha2);
+        alpha = x.naught(blk) < 0. && alpha0<alpha ? alpha0 : alpha;
+        if(nroots>=1)
+            alpha = alpha1>=0. && alpha1<alpha ? alpha1 : alpha;
+        if(nroots==2)
+            alpha = alpha2>=0. && alpha2<alpha ? alpha2 : alpha;
+    }
+    return alpha;
+}
+
+// Returns the average time in seconds over a number of repetitions
+template <typename F>
+double time_it(Natural const nreps,F const & f) {
+    auto start = std::chrono::steady_clock::now();
+    for(Natural i=0;i<nreps;i++)
+        f();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration <double> (stop-start).count()/double(nreps);
+}
+
+int main(int argc,char* argv[]) {
+    // Grab the number of cones and repetitions
+    Natural ncones = argc > 1 ? std::atoi(argv[1]) : 100000;
+    Natural nreps = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    // Create the cones, which are of size 3 to 10
+    std::vector <Optizelle::Cone::t> types(ncones,Optizelle::Cone::Quadratic);
+    std::vector <Natural> sizes(ncones);
+    for(Natural i=0;i<ncones;i++)
+        sizes[i]=3+(i*7)%8;
+    Z_Vector zz(types,sizes);
+
+    // Create two strictly feasible vectors and a direction
+    Z_Vector x(Z::init(zz));
+    Z_Vector y(Z::init(zz));
+    Z_Vector dy(Z::init(zz));
+    for(Natural blk=1;blk<=ncones;blk++)
+        for(Natural i=1;i<=sizes[blk-1];i++) {
+            x(blk,i)= i==1 ? double(sizes[blk-1])+1. : sin(double(blk+i));
+            y(blk,i)= i==1 ? double(sizes[blk-1])+2. : cos(double(blk*i));
+            dy(blk,i)= i==1 ? -1. : cos(double(blk+3*i));
+        }
+    Z_Vector z(Z::init(zz));
+
+    // Run the benchmarks and make sure the two paths agree
+    std::cout << "Second-order cones: " << ncones << std::endl
+        << std::setw(6) << "op"
+        << std::setw(16) << "blockwise (s)"
+        << std::setw(16) << "batched (s)"
+        << std::setw(10) << "speedup" << std::endl;
+    auto report = [](std::string const & name,double t_blk,double t_bat) {
+        std::cout << std::setw(6) << name
+            << std::setw(16) << std::scientific << std::setprecision(3) << t_blk
+            << std::setw(16) << t_bat
+            << std::setw(10) << std::fixed << std::setprecision(2)
+            << t_blk/t_bat << std::endl;
+    };
+
+    double t_blk = time_it(nreps,[&]() { prod_blockwise(x,y,z); });
+    double t_bat = time_it(nreps,[&]() { Z::prod(x,y,z); });
+    report("prod",t_blk,t_bat);
+
+    t_blk = time_it(nreps,[&]() { linv_blockwise(x,y,z); });
+    t_bat = time_it(nreps,[&]() { Z::linv(x,y,z); });
+    report("linv",t_blk,t_bat);
+
+    double barr_blk(0.), barr_bat(0.);
+    t_blk = time_it(nreps,[&]() { barr_blk=barr_blockwise(x); });
+    t_bat = time_it(nreps,[&]() { barr_bat=Z::barr(x); });
+    report("barr",t_blk,t_bat);
+
+    double srch_blk(0.), srch_bat(0.);
+    t_blk = time_it(nreps,[&]() { srch_blk=srch_blockwise(dy,y); });
+    t_bat = time_it(nreps,[&]() { srch_bat=Z::srch(dy,y); });
+    report("srch",t_blk,t_bat);
+
+    // Check that the results match
+    linv_blockwise(x,y,z);
+    Z_Vector z_bat(Z::init(zz));
+    Z::linv(x,y,z_bat);
+    Z::axpy(-1.,z_bat,z);
+    double err = std::sqrt(Z::innr(z,z))/(1.+std::sqrt(Z::innr(z_bat,z_bat)));
+    err = std::max(err,std::fabs(barr_blk-barr_bat)/(1.+std::fabs(barr_blk)));
+    err = std::max(err,std::fabs(srch_blk-srch_bat)/(1.+std::fabs(srch_blk)));
+    std::cout << "Relative difference between the paths: "
+        << std::scientific << err << std::endl;
+
+    return err < 1e-10 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
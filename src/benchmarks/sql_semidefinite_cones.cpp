@@ -0,0 +1,102 @@
+// Times the kernels behind a single semidefinite block as its size grows.  We
+// compare the Jordan product inverse on full storage, which multiplies by the
+// cached inverse, to the one on packed storage, which solves with the cached
+// Choleski factor in rectangular full packed format.  In addition, we time
+// the line search, which uses the restarted Lanczos eigenvalue solver.
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/linalg.h"
+
+// Create some type shortcuts
+typedef Optizelle::SQL <double> Z;
+typedef Z::Vector Z_Vector;
+using Optizelle::Natural;
+
+// Returns the average time in seconds over a number of repetitions
+template <typename F>
+double time_it(Natural const nreps,F const & f) {
+    auto start = std::chrono::steady_clock::now();
+    for(Natural i=0;i<nreps;i++)
+        f();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration <double> (stop-start).count()/double(nreps);
+}
+
+int main(int argc,char* argv[]) {
+    // Grab the largest block size and the amount of work per measurement
+    Natural m_max = argc > 1 ? std::atoi(argv[1]) : 2000;
+    double flops = argc > 2 ? std::atof(argv[2]) : 1e9;
+
+    std::cout << std::setw(6) << "m"
+        << std::setw(16) << "linv full (s)"
+        << std::setw(18) << "linv packed (s)"
+        << std::setw(16) << "srch (s)" << std::endl;
+
+    // Sweep over the block sizes
+    double err(0.);
+    for(Natural m : {10,20,50,100,200,500,1000,2000}) {
+        if(m > m_max) break;
+
+        // Run enough repetitions to do a roughly fixed amount of work
+        Natural nreps = std::max(Natural(1),
+            Natural(flops/(double(m)*double(m)*double(m))));
+
+        // Create a strictly feasible point, a direction, and a right hand
+        // side in a single semidefinite block
+        std::vector <Optizelle::Cone::t> types(1,Optizelle::Cone::Semidefinite);
+        std::vector <Natural> sizes(1,m);
+        Z_Vector x(types,sizes);
+        Z_Vector y(Z::init(x));
+        Z_Vector dy(Z::init(x));
+        for(Natural j=1;j<=m;j++)
+            for(Natural i=1;i<=m;i++) {
+                x(1,i,j)= i==j ? 2.+double(i)/double(m)
+                    : sin(double(i+j))/double(m);
+                y(1,i,j)= i==j ? 1. : 0.3*cos(double(i*j))/double(m);
+                dy(1,i,j)= i==j ? -1.+double(i)/double(m)
+                    : 0.1*cos(double(i+j))/double(m);
+            }
+        Z_Vector z(Z::init(x));
+
+        // Time the Jordan product inverse on full storage.  After the first
+        // call, the inverse is cached.
+        Z::linv(x,y,z);
+        double t_full = time_it(nreps,[&]() { Z::linv(x,y,z); });
+
+        // Time the Jordan product inverse on packed storage.  After the first
+        // call, the Choleski factor is cached.
+        Z_Vector xp(types,sizes,Optizelle::SDPStorage::Packed);
+        Z_Vector yp(Z::init(xp));
+        Z_Vector zp(Z::init(xp));
+        Z::convert(x,xp);
+        Z::convert(y,yp);
+        Z::linv(xp,yp,zp);
+        double t_packed = time_it(nreps,[&]() { Z::linv(xp,yp,zp); });
+
+        // Packed storage keeps the symmetric part of the result
+        Z::symm(z);
+        Z_Vector r(Z::init(x));
+        Z::convert(zp,r);
+        Z::axpy(-1.,z,r);
+        err = std::max(err,std::sqrt(Z::innr(r,r))
+            /(1.+std::sqrt(Z::innr(z,z))));
+
+        // Time the line search
+        double t_srch = time_it(nreps,[&]() { Z::srch(dy,y); });
+
+        std::cout << std::setw(6) << m
+            << std::setw(16) << std::scientific << std::setprecision(3)
+            << t_full
+            << std::setw(18) << t_packed
+            << std::setw(16) << t_srch << std::endl;
+    }
+
+    std::cout << "Relative difference between the full and packed inverses: "
+        << std::scientific << err << std::endl;
+
+    return err < 1e-10 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,600 @@
+// Times Optizelle on scalable problems from each of the problem classes and
+// writes the results as one JSON object per line, so that we can track them
+// across commits.  For each problem, we time getMin end to end and a single
+// Krylov solve.  Separately, we time the vector space kernels of Rm and SQL.
+// The problems are
+//
+// rosenbrock : the chained Rosenbrock function (Unconstrained)
+// quadratic  : .5 x'Ax - b'x where A is a shifted 1-D Laplacian
+//              (Unconstrained)
+// parest     : the parameter estimation problem in parest.h
+//              (EqualityConstrained)
+// sql        : min c'x st sum_i A_i x_i - A_0 >= 0 with random sparse A_i
+//              and a mix of linear, second-order, and semidefinite cones
+//              (InequalityConstrained)
+// maxcut     : the dual of the max-cut relaxation of a random graph,
+//              min sum_i y_i st diag(y) - L/4 >= 0, which is how the
+//              SDPLIB mcp instances are posed in SDPA format
+//              (InequalityConstrained)
+// constrained: quadratic with the constraints sum_i x_i = n/2 and x >= 0
+//              (Constrained)
+//
+// The arguments are the largest size n for the Rm problems, which grows by
+// factors of 10 from 10^3, the minimum time in seconds that we spend on each
+// kernel, and the file where we write the results, which defaults to the
+// standard output.
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/linalg.h"
+#include "parest.h"
+
+// Create some type shortcuts
+typedef Optizelle::SQL <double> Z;
+typedef Z::Vector Z_Vector;
+using Optizelle::SQL;
+
+// Writes each result as a line of JSON
+struct Results {
+    std::ostream & out;
+    explicit Results(std::ostream & out_) : out(out_) {}
+
+    // Writes a result.  The extra fields must already be formatted as
+    // JSON, starting with a comma.
+    void write(
+        std::string const & problem,
+        Natural const & n,
+        std::string const & measure,
+        double const & seconds,
+        Natural const & reps,
+        std::string const & extra = ""
+    ) {
+        std::stringstream line;
+        line.precision(6);
+        line << std::scientific
+            << "{\"problem\":\"" << problem << "\""
+            << ",\"n\":" << n
+            << ",\"measure\":\"" << measure << "\""
+            << ",\"seconds\":" << seconds
+            << ",\"reps\":" << reps
+            << extra << "}";
+        out << line.str() << std::endl;
+    }
+};
+
+// Repeats f until we've spent at least min_time seconds and returns the
+// average time of a single call along with the number of calls
+template <typename F>
+std::pair <double,Natural> time_it(double const & min_time,F const & f) {
+    Natural reps = 1;
+    while(true) {
+        auto start = std::chrono::steady_clock::now();
+        for(Natural i=0;i<reps;i++)
+            f();
+        double elapsed = std::chrono::duration <double> (
+            std::chrono::steady_clock::now()-start).count();
+        if(elapsed >= min_time || reps >= (Natural(1) << 30))
+            return {elapsed/double(reps),reps};
+        reps = elapsed > 0.
+            ? std::max(reps+1,Natural(1.2*min_time/elapsed*reps))
+            : 10*reps;
+    }
+}
+
+// Times a single call
+template <typename F>
+double time_once(F const & f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration <double> (
+        std::chrono::steady_clock::now()-start).count();
+}
+
+// Formats the counters of a finished solve
+template <typename State>
+std::string solve_fields(State const & state) {
+    std::stringstream fields;
+    fields << ",\"iterations\":" << state.iter
+        << ",\"krylov_iterations\":" << state.krylov_iter_total
+        << ",\"stop\":\""
+        << Optizelle::StoppingCondition::to_string(state.opt_stop) << "\"";
+    return fields.str();
+}
+
+// f(x) = sum_i 100 (x_{i+1}-x_i^2)^2 + (1-x_i)^2
+struct Rosenbrock : public Optizelle::ScalarValuedFunction <double,Rm> {
+    double eval(X_Vector const & x) const {
+        double f(0.);
+        for(Natural i=0;i+1<x.size();i++)
+            f+=100.*Optizelle::sq(x[i+1]-x[i]*x[i])+Optizelle::sq(1.-x[i]);
+        return f;
+    }
+    void grad(X_Vector const & x,X_Vector & g) const {
+        X::zero(g);
+        for(Natural i=0;i+1<x.size();i++) {
+            g[i]+=-400.*x[i]*(x[i+1]-x[i]*x[i])-2.*(1.-x[i]);
+            g[i+1]+=200.*(x[i+1]-x[i]*x[i]);
+        }
+    }
+    void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+        const
+    {
+        X::zero(H_dx);
+        for(Natural i=0;i+1<x.size();i++) {
+            H_dx[i]+=(1200.*x[i]*x[i]-400.*x[i+1]+2.)*dx[i]-400.*x[i]*dx[i+1];
+            H_dx[i+1]+=-400.*x[i]*dx[i]+200.*dx[i+1];
+        }
+    }
+};
+
+// f(x) = .5 x'Ax - b'x where A = tridiag(-1,2.01,-1) and b = 1
+struct Quadratic : public Optizelle::ScalarValuedFunction <double,Rm> {
+    static void apply(X_Vector const & x,X_Vector & y) {
+        Natural const n = x.size();
+        for(Natural i=0;i<n;i++)
+            y[i]=2.01*x[i]-(i>0 ? x[i-1] : 0.)-(i+1<n ? x[i+1] : 0.);
+    }
+    double eval(X_Vector const & x) const {
+        X_Vector Ax(X::init(x));
+        apply(x,Ax);
+        double f(0.);
+        for(Natural i=0;i<x.size();i++)
+            f+=.5*x[i]*Ax[i]-x[i];
+        return f;
+    }
+    void grad(X_Vector const & x,X_Vector & g) const {
+        apply(x,g);
+        for(auto & g_i : g)
+            g_i-=1.;
+    }
+    void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+        const
+    {
+        apply(dx,H_dx);
+    }
+};
+
+// f(x) = c'x
+struct Linear : public Optizelle::ScalarValuedFunction <double,Rm> {
+    X_Vector c;
+    explicit Linear(X_Vector const & c_) : c(c_) {}
+    double eval(X_Vector const & x) const {
+        return X::innr(c,x);
+    }
+    void grad(X_Vector const & x,X_Vector & g) const {
+        X::copy(c,g);
+    }
+    void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+        const
+    {
+        X::zero(H_dx);
+    }
+};
+
+// g(x) = sum_i x_i - n/2
+struct Sum : public Optizelle::VectorValuedFunction <double,Rm,Rm> {
+    void eval(X_Vector const & x,X_Vector & y) const {
+        y[0]=-.5*double(x.size());
+        for(auto const & x_i : x)
+            y[0]+=x_i;
+    }
+    void p(X_Vector const & x,X_Vector const & dx,X_Vector & y) const {
+        y[0]=0.;
+        for(auto const & dx_i : dx)
+            y[0]+=dx_i;
+    }
+    void ps(X_Vector const & x,X_Vector const & dy,X_Vector & z) const {
+        for(auto & z_i : z)
+            z_i=dy[0];
+    }
+    void pps(
+        X_Vector const & x,
+        X_Vector const & dx,
+        X_Vector const & dy,
+        X_Vector & z
+    ) const {
+        X::zero(z);
+    }
+};
+
+// h(x) = x
+struct Bounds : public Optizelle::VectorValuedFunction <double,Rm,Rm> {
+    void eval(X_Vector const & x,X_Vector & y) const {
+        X::copy(x,y);
+    }
+    void p(X_Vector const & x,X_Vector const & dx,X_Vector & y) const {
+        X::copy(dx,y);
+    }
+    void ps(X_Vector const & x,X_Vector const & dy,X_Vector & z) const {
+        X::copy(dy,z);
+    }
+    void pps(
+        X_Vector const & x,
+        X_Vector const & dx,
+        X_Vector const & dy,
+        X_Vector & z
+    ) const {
+        X::zero(z);
+    }
+};
+
+// The Hessian of a function at a fixed point
+struct Hessian : public Optizelle::Operator <double,Rm,Rm> {
+    Optizelle::ScalarValuedFunction <double,Rm> const & f;
+    X_Vector const & x;
+    Hessian(
+        Optizelle::ScalarValuedFunction <double,Rm> const & f_,
+        X_Vector const & x_
+    ) : f(f_), x(x_) {}
+    void eval(X_Vector const & dx,X_Vector & H_dx) const {
+        f.hessvec(x,dx,H_dx);
+    }
+};
+
+// The identity operator
+struct Identity : public Optizelle::Operator <double,Rm,Rm> {
+    void eval(X_Vector const & x,X_Vector & y) const {
+        X::copy(x,y);
+    }
+};
+
+// Times getMin and the Krylov solvers on a problem on Rm.  The Krylov
+// solvers use the Hessian at the initial guess.
+template <typename F>
+void unconstrained(
+    Results & results,
+    std::string const & name,
+    X_Vector const & x0,
+    double const & min_time
+) {
+    typedef Optizelle::Unconstrained <double,Rm> Problem;
+    Natural const n = x0.size();
+
+    // Solve the problem with a trust-region Newton method.  The chained
+    // Rosenbrock function needs on the order of n iterations, so we time a
+    // fixed budget of iterations rather than a full solve.
+    Problem::State::t state(x0);
+    state.msg_level = 0;
+    state.H_type = Optizelle::Operators::UserDefined;
+    state.iter_max = 100;
+    state.krylov_iter_max = 1000;
+    Problem::Functions::t fns;
+    fns.f.reset(new F);
+    double t = time_once([&]() {
+        Problem::Algorithms::getMin(Optizelle::Messaging(),fns,state);
+    });
+    results.write(name,n,"getMin",t,1,solve_fields(state));
+
+    // Solve the Newton system at the initial guess with each of the Krylov
+    // methods
+    F f;
+    Hessian H(f,x0);
+    Identity I;
+    X_Vector b(X::init(x0));
+    f.grad(x0,b);
+    X::scal(-1.,b);
+    X_Vector x(X::init(x0));
+    X_Vector x_cp(X::init(x0));
+    X_Vector x_cntr(X::init(x0));
+    X::zero(x_cntr);
+    double norm_r0(0.), norm_r(0.);
+    Natural iter(0);
+    Optizelle::KrylovStop::t stop;
+    double const eps = 1e-6;
+    Natural const iter_max = 1000;
+    double const delta = std::numeric_limits <double>::infinity();
+
+    auto cd = time_it(min_time,[&]() {
+        Optizelle::truncated_cd <double,Rm> (H,b,I,I,eps,iter_max,1,delta,
+            x_cntr,false,x,x_cp,norm_r0,norm_r,iter,stop);
+    });
+    std::stringstream fields;
+    fields << ",\"krylov_iterations\":" << iter;
+    results.write(name,n,"truncated_cd",cd.first,cd.second,fields.str());
+
+    auto minres = time_it(min_time,[&]() {
+        Optizelle::truncated_minres <double,Rm> (H,b,I,I,eps,iter_max,1,delta,
+            x_cntr,x,x_cp,norm_r0,norm_r,iter,stop);
+    });
+    fields.str("");
+    fields << ",\"krylov_iterations\":" << iter;
+    results.write(name,n,"truncated_minres",minres.first,minres.second,
+        fields.str());
+
+    Optizelle::EmptyGMRESManipulator <double,Rm> gmanip;
+    Natural gmres_iter(0);
+    auto gmres = time_it(min_time,[&]() {
+        X::zero(x);
+        gmres_iter = Optizelle::gmres <double,Rm> (
+            H,b,eps,iter_max,50,I,I,gmanip,x).second;
+    });
+    fields.str("");
+    fields << ",\"krylov_iterations\":" << gmres_iter;
+    results.write(name,n,"gmres",gmres.first,gmres.second,fields.str());
+}
+
+// Solves a parameter estimation problem
+void equality_constrained(
+    Results & results,
+    Natural const & m,
+    Natural const & n
+) {
+    typedef Optizelle::EqualityConstrained <double,Rm,Rm> Problem;
+    Parest p(m,n);
+    X_Vector x(m+n);
+    std::mt19937 gen(2);
+    std::normal_distribution <double> randn;
+    for(auto & x_i : x)
+        x_i = randn(gen);
+    Problem::State::t state(x,X_Vector(n));
+    state.msg_level = 0;
+    state.H_type = Optizelle::Operators::UserDefined;
+    state.iter_max = 100;
+    state.eps_krylov = 1e-4;
+    Problem::Functions::t fns;
+    fns.f.reset(new ParestObj(p));
+    fns.g.reset(new ParestEq(p));
+    double t = time_once([&]() {
+        Problem::Algorithms::getMin(Optizelle::Messaging(),fns,state);
+    });
+    results.write("parest",m+n,"getMin",t,1,solve_fields(state));
+}
+
+// Solves min c'x st sum_i A_i x_i - A_0 >= 0 from a strictly feasible x0
+// with the Schur complement as the preconditioner
+void sdpa(
+    Results & results,
+    std::string const & name,
+    std::vector <Optizelle::SparseSQL <double> > const & A,
+    X_Vector const & c,
+    X_Vector const & x0,
+    Z_Vector const & zz
+) {
+    typedef Optizelle::InequalityConstrained <double,Rm,SQL> Problem;
+    Z_Vector z(Z::init(zz));
+    Z::id(z);
+    Problem::State::t state(x0,z);
+    state.msg_level = 0;
+    state.H_type = Optizelle::Operators::UserDefined;
+    state.PH_type = Optizelle::Operators::UserDefined;
+    state.iter_max = 200;
+    state.krylov_iter_max = 200;
+    state.krylov_orthog_max = 200;
+    state.eps_krylov = 1e-8;
+    state.eps_dx = 1e-15;
+    state.eps_grad = 1e-8;
+    state.eps_mu = 1e-8;
+    state.sigma = 0.5;
+    state.gamma = 0.95;
+    state.delta = 1e50;
+    Problem::Functions::t fns;
+    fns.f.reset(new Linear(c));
+    Optizelle::LinearSQLFunction <double> * h
+        = new Optizelle::LinearSQLFunction <double> (A);
+    fns.h.reset(h);
+    fns.PH.reset(new Optizelle::SchurComplement <double> (*h,state.z,
+        state.h_x));
+    double t = time_once([&]() {
+        Problem::Algorithms::getMin(Optizelle::Messaging(),fns,state);
+    });
+    results.write(name,zz.data.size(),"getMin",t,1,solve_fields(state));
+}
+
+// Creates a random SQL problem whose cones grow with s along with a vector
+// from its codomain
+Z_Vector random_sql(
+    Natural const & s,
+    Natural const & m,
+    std::vector <Optizelle::SparseSQL <double> > & A
+) {
+    // One linear block, several second-order cones, and a pair of
+    // semidefinite blocks
+    std::vector <Optizelle::Cone::t> types{Optizelle::Cone::Linear};
+    std::vector <Natural> sizes{10*s};
+    for(Natural k=0;k<4;k++) {
+        types.emplace_back(Optizelle::Cone::Quadratic);
+        sizes.emplace_back(s+1);
+    }
+    for(Natural k=0;k<2;k++) {
+        types.emplace_back(Optizelle::Cone::Semidefinite);
+        sizes.emplace_back(s);
+    }
+    Z_Vector zz(types,sizes);
+
+    // Give each A_i a few random entries in every block
+    std::mt19937 gen(3);
+    std::normal_distribution <double> randn;
+    A.assign(m+1,Optizelle::SparseSQL <double> ());
+    for(Natural i=1;i<=m;i++)
+        for(Natural blk=1;blk<=zz.numBlocks();blk++)
+            for(Natural k=0;k<3;k++) {
+                Natural const size = zz.blkSize(blk);
+                Natural const r = 1 + gen() % size;
+                Natural const c = 1 + gen() % size;
+                A[i].blks.emplace_back(blk);
+                if(zz.blkType(blk)==Optizelle::Cone::Semidefinite) {
+                    A[i].is.emplace_back(std::min(r,c));
+                    A[i].js.emplace_back(std::max(r,c));
+                } else {
+                    A[i].is.emplace_back(r);
+                    A[i].js.emplace_back(0);
+                }
+                A[i].data.emplace_back(randn(gen));
+            }
+    return zz;
+}
+
+// Solves the random SQL problem.  We set A_0 = -e, so that x=0 is strictly
+// feasible.  We set c_i = 2 <A_i,e>, so that z=2e is strictly feasible for
+// the dual, which bounds the objective from below.  Using e instead would
+// make the gradient at the initial guess zero and leave us without a typical
+// gradient or step to measure convergence.
+void inequality_constrained(Results & results,Natural const & s) {
+    Natural const m = 2*s;
+    std::vector <Optizelle::SparseSQL <double> > A;
+    Z_Vector zz(random_sql(s,m,A));
+    Z_Vector e(Z::init(zz));
+    Z::id(e);
+    for(Natural blk=1;blk<=e.numBlocks();blk++)
+        for(Natural i=1;i<=e.blkSize(blk);i++) {
+            if(e.blkType(blk)==Optizelle::Cone::Quadratic && i>1)
+                continue;
+            bool const sdp = e.blkType(blk)==Optizelle::Cone::Semidefinite;
+            A[0].blks.emplace_back(blk);
+            A[0].is.emplace_back(i);
+            A[0].js.emplace_back(sdp ? i : 0);
+            A[0].data.emplace_back(sdp ? -e(blk,i,i) : -e(blk,i));
+        }
+    X_Vector c(m);
+    for(Natural i=1;i<=m;i++)
+        c[i-1] = 2.*Optizelle::SparseSQL <double>::innr(A[i],e);
+    sdpa(results,"sql",A,c,X_Vector(m,0.),zz);
+}
+
+// Solves the max-cut relaxation of a random graph with nodes vertices
+void maxcut(Results & results,Natural const & nodes) {
+    // Create a random graph and store A_0 = L/4, where L is its Laplacian
+    std::mt19937 gen(4);
+    std::uniform_real_distribution <double> unif;
+    std::vector <double> degree(nodes,0.);
+    std::vector <Optizelle::SparseSQL <double> > A(nodes+1);
+    for(Natural i=1;i<=nodes;i++)
+        for(Natural j=i+1;j<=nodes;j++)
+            if(unif(gen) < 0.5) {
+                A[0].blks.emplace_back(1);
+                A[0].is.emplace_back(i);
+                A[0].js.emplace_back(j);
+                A[0].data.emplace_back(-.25);
+                degree[i-1]+=1.;
+                degree[j-1]+=1.;
+            }
+    for(Natural i=1;i<=nodes;i++) {
+        A[0].blks.emplace_back(1);
+        A[0].is.emplace_back(i);
+        A[0].js.emplace_back(i);
+        A[0].data.emplace_back(.25*degree[i-1]);
+    }
+
+    // A_i = e_i e_i'
+    for(Natural i=1;i<=nodes;i++) {
+        A[i].blks.emplace_back(1);
+        A[i].is.emplace_back(i);
+        A[i].js.emplace_back(i);
+        A[i].data.emplace_back(1.);
+    }
+
+    // Start from y_i = n/2, which is larger than the eigenvalues of L/4
+    Z_Vector zz(std::vector <Optizelle::Cone::t> {
+        Optizelle::Cone::Semidefinite},std::vector <Natural> {nodes});
+    sdpa(results,"maxcut",A,X_Vector(nodes,1.),
+        X_Vector(nodes,double(nodes)/2.),zz);
+}
+
+// Solves the quadratic problem with a linear equality and bounds
+void constrained(Results & results,Natural const & n) {
+    typedef Optizelle::Constrained <double,Rm,Rm,Rm> Problem;
+
+    // Start from a strictly feasible point that isn't constant.  A constant
+    // starting point is already stationary in the span of the constraint.
+    X_Vector x0(n);
+    for(Natural i=0;i<n;i++)
+        x0[i] = (double(i)+.5)/double(n);
+    Problem::State::t state(x0,X_Vector(1),X_Vector(n));
+    state.msg_level = 0;
+    state.H_type = Optizelle::Operators::UserDefined;
+    state.iter_max = 100;
+    Problem::Functions::t fns;
+    fns.f.reset(new Quadratic);
+    fns.g.reset(new Sum);
+    fns.h.reset(new Bounds);
+    double t = time_once([&]() {
+        Problem::Algorithms::getMin(Optizelle::Messaging(),fns,state);
+    });
+    results.write("constrained",n,"getMin",t,1,solve_fields(state));
+}
+
+// Times the kernels of Rm
+void rm_kernels(Results & results,Natural const & n,double const & min_time) {
+    X_Vector x(n,1.), y(n,2.), z(n,0.);
+    double const bytes = double(sizeof(double)*n);
+    auto report = [&](std::string const & name,
+        std::pair <double,Natural> const & t,
+        double const & moved
+    ) {
+        std::stringstream fields;
+        fields << ",\"bytes\":" << moved;
+        results.write("rm",n,name,t.first,t.second,fields.str());
+    };
+    report("copy",time_it(min_time,[&]() { X::copy(x,z); }),2.*bytes);
+    report("scal",time_it(min_time,[&]() { X::scal(-1.,z); }),2.*bytes);
+    report("axpy",time_it(min_time,[&]() { X::axpy(1e-9,x,z); }),3.*bytes);
+    volatile double sink(0.);
+    report("innr",time_it(min_time,[&]() { sink=X::innr(x,y); }),2.*bytes);
+    report("zero",time_it(min_time,[&]() { X::zero(z); }),bytes);
+    report("prod",time_it(min_time,[&]() { X::prod(x,y,z); }),3.*bytes);
+    report("linv",time_it(min_time,[&]() { X::linv(x,y,z); }),3.*bytes);
+    report("barr",time_it(min_time,[&]() { sink=X::barr(x); }),bytes);
+    report("srch",time_it(min_time,[&]() { sink=X::srch(x,y); }),2.*bytes);
+    (void)sink;
+}
+
+// Times the kernels of SQL on the cones of the random SQL problem
+void sql_kernels(Results & results,Natural const & s,double const & min_time) {
+    std::vector <Optizelle::SparseSQL <double> > A;
+    Z_Vector zz(random_sql(s,1,A));
+    Z_Vector x(Z::init(zz)), y(Z::init(zz)), z(Z::init(zz));
+    Z::id(x);
+    Z::id(y);
+    Z::scal(2.,y);
+    Natural const n = zz.data.size();
+    volatile double sink(0.);
+    auto t = time_it(min_time,[&]() { Z::prod(x,y,z); });
+    results.write("sql",n,"prod",t.first,t.second);
+    t = time_it(min_time,[&]() { Z::linv(x,y,z); });
+    results.write("sql",n,"linv",t.first,t.second);
+    t = time_it(min_time,[&]() { sink=Z::innr(x,y); });
+    results.write("sql",n,"innr",t.first,t.second);
+    t = time_it(min_time,[&]() { sink=Z::barr(x); });
+    results.write("sql",n,"barr",t.first,t.second);
+    Z::scal(-1.,y);
+    t = time_it(min_time,[&]() { sink=Z::srch(y,x); });
+    results.write("sql",n,"srch",t.first,t.second);
+    (void)sink;
+}
+
+int main(int argc,char* argv[]) {
+    // Grab the largest size, the minimum time per kernel, and where we write
+    Natural max_n = argc > 1 ? std::atof(argv[1]) : 1e5;
+    double min_time = argc > 2 ? std::atof(argv[2]) : 0.05;
+    std::ofstream file;
+    if(argc > 3)
+        file.open(argv[3]);
+    Results results(argc > 3 ? file : std::cout);
+
+    // Problems and kernels on Rm
+    for(Natural n=1000;n<=max_n;n*=10) {
+        X_Vector x0(n);
+        for(Natural i=0;i<n;i++)
+            x0[i] = i%2 ? 1. : -1.2;
+        unconstrained <Rosenbrock> (results,"rosenbrock",x0,min_time);
+        unconstrained <Quadratic> (results,"quadratic",X_Vector(n,0.),
+            min_time);
+        constrained(results,n);
+        rm_kernels(results,n,min_time);
+    }
+
+    // Problems whose work grows faster than their size
+    for(Natural s=10;s*s*100<=max_n;s*=2) {
+        equality_constrained(results,s/2,2*s);
+        inequality_constrained(results,s);
+        maxcut(results,2*s);
+        sql_kernels(results,s,min_time);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,21 @@
+# Compiles an Optizelle C++ benchmark
+macro(add_optizelle_benchmark_cpp name)
+
+    # Make sure that benchmarks are enabled
+    if(ENABLE_CPP_BENCHMARKS)
+
+        # Set common includes
+        include_directories(${OPTIZELLE_INCLUDE_DIRS})
+        include_directories(${JSONCPP_INCLUDE_DIRS})
+
+        # Compile and link the benchmark.  We prefix the target since
+        # benchmarks often share a name with the unit test of the same code.
+        add_executable(benchmark_${name} "${name}.cpp")
+        target_link_libraries(benchmark_${name}
+            optizelle_static
+            ${JSONCPP_LIBRARIES}
+            ${LAPACK_LIBRARIES}
+            ${BLAS_LIBRARIES})
+    endif()
+
+endmacro()
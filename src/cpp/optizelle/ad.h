@@ -0,0 +1,671 @@
+/*
+Copyright 2013-2014 OptimoJoe.
+
+For the full copyright notice, see LICENSE.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Author: Joseph Young (joe@optimojoe.com)
+*/
+
+#ifndef AD_H
+#define AD_H
+
+#include <cmath>
+#include <vector>
+#include <limits>
+#include <type_traits>
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+
+//---Optizelle0---
+namespace Optizelle {
+//---Optizelle1---
+
+    // Automatic differentiation for functions on Rm.  Rather than coding the
+    // derivatives by hand, the user writes the function once as a template
+    // over the scalar type,
+    //
+    // struct MyObj {
+    //     template <typename T>
+    //     T operator () (std::vector <T> const & x) const { ... }
+    // };
+    //
+    // struct MyConstraint {
+    //     template <typename T>
+    //     void operator () (std::vector <T> const & x,std::vector <T> & y)
+    //         const { ... }
+    // };
+    //
+    // and then wraps it in AD::ScalarValuedFunction or AD::VectorValuedFunction.
+    // When we need a derivative at a new x, we evaluate the function once on
+    // AD::Variable, which records every elementary operation along with its
+    // first and second partial derivatives on a tape.  Then, the gradient and
+    // adjoint derivatives are a reverse sweep of the tape, the derivative is a
+    // forward sweep, and the Hessian-vector products are a forward sweep
+    // followed by a reverse sweep of the forward derivatives, which is
+    // forward-over-reverse differentiation.  Since the tape is kept until x
+    // changes, every Krylov iteration at the same x only replays the tape.
+    namespace AD {
+
+        // A tape of elementary operations.  Each operation has at most two
+        // arguments, a and b, and we store the partials of the operation with
+        // respect to these arguments.  The first n entries are the
+        // independent variables.
+        template <typename Real>
+        struct Tape {
+            // Disallow constructors
+            NO_COPY_ASSIGNMENT(Tape)
+
+            // Marks an argument that doesn't exist or a constant
+            static Natural const none = std::numeric_limits <Natural>::max();
+
+            // Arguments of each operation
+            std::vector <Natural> a;
+            std::vector <Natural> b;
+
+            // First partials of each operation
+            std::vector <Real> da;
+            std::vector <Real> db;
+
+            // Second partials of each operation
+            std::vector <Real> daa;
+            std::vector <Real> dab;
+            std::vector <Real> dbb;
+
+            // Create an empty tape
+            Tape() : a(), b(), da(), db(), daa(), dab(), dbb() {}
+
+            // Number of operations on the tape
+            Natural size() const {
+                return a.size();
+            }
+
+            // Erase the operations while keeping the memory
+            void clear() {
+                a.clear(); b.clear();
+                da.clear(); db.clear();
+                daa.clear(); dab.clear(); dbb.clear();
+            }
+
+            // Records an operation and returns its index
+            Natural push(
+                Natural const & a_,
+                Natural const & b_,
+                Real const & da_,
+                Real const & db_,
+                Real const & daa_,
+                Real const & dab_,
+                Real const & dbb_
+            ) {
+                a.push_back(a_); b.push_back(b_);
+                da.push_back(da_); db.push_back(db_);
+                daa.push_back(daa_); dab.push_back(dab_); dbb.push_back(dbb_);
+                return a.size()-1;
+            }
+
+            // Tape that operations are currently recorded on.  This is
+            // per thread, so that different threads may record different
+            // functions at the same time.
+            static Tape *& active() {
+                static thread_local Tape * tape = nullptr;
+                return tape;
+            }
+
+            // Forward sweep, dv <- derivative of every operation in the
+            // direction dx of the independent variables
+            void forward(std::vector <Real> const & dx,std::vector <Real> & dv)
+                const
+            {
+                dv.assign(size(),Real(0.));
+                for(Natural i=0;i<dx.size();i++)
+                    dv[i]=dx[i];
+                for(Natural k=dx.size();k<size();k++) {
+                    Real dv_k(0.);
+                    if(a[k]!=none) dv_k+=da[k]*dv[a[k]];
+                    if(b[k]!=none) dv_k+=db[k]*dv[b[k]];
+                    dv[k]=dv_k;
+                }
+            }
+
+            // Reverse sweep.  On input, v_bar contains the adjoint seeds of
+            // the outputs.  On output, it contains the adjoints of every
+            // operation.  If dv contains the forward derivatives, we also
+            // propagate the derivatives of the adjoints, dv_bar, which gives
+            // the second-order adjoints.
+            void reverse(
+                std::vector <Real> & v_bar,
+                std::vector <Real> const * const dv,
+                std::vector <Real> & dv_bar
+            ) const {
+                if(dv!=nullptr) dv_bar.assign(size(),Real(0.));
+                for(Natural k=size();k-- > 0;) {
+                    if(a[k]==none && b[k]==none) continue;
+                    Real const & v_bar_k=v_bar[k];
+                    if(dv==nullptr) {
+                        if(v_bar_k==Real(0.)) continue;
+                        if(a[k]!=none) v_bar[a[k]]+=da[k]*v_bar_k;
+                        if(b[k]!=none) v_bar[b[k]]+=db[k]*v_bar_k;
+                        continue;
+                    }
+                    Real const & dv_bar_k=dv_bar[k];
+                    if(v_bar_k==Real(0.) && dv_bar_k==Real(0.)) continue;
+                    Real const dv_a = a[k]!=none ? (*dv)[a[k]] : Real(0.);
+                    Real const dv_b = b[k]!=none ? (*dv)[b[k]] : Real(0.);
+                    if(a[k]!=none) {
+                        v_bar[a[k]]+=da[k]*v_bar_k;
+                        dv_bar[a[k]]+=da[k]*dv_bar_k
+                            +v_bar_k*(daa[k]*dv_a+dab[k]*dv_b);
+                    }
+                    if(b[k]!=none) {
+                        v_bar[b[k]]+=db[k]*v_bar_k;
+                        dv_bar[b[k]]+=db[k]*dv_bar_k
+                            +v_bar_k*(dab[k]*dv_a+dbb[k]*dv_b);
+                    }
+                }
+            }
+        };
+        template <typename Real>
+        Natural const Tape <Real>::none;
+
+        // Scalar that records its operations on the active tape.  Constants,
+        // including every value computed while no tape is active, are not
+        // recorded.
+        template <typename Real>
+        struct Variable {
+            // Type of the underlying value
+            typedef Real Scalar;
+
+            // Value of the variable
+            Real val;
+
+            // Index of the variable on the tape
+            Natural idx;
+
+            // Constants
+            Variable() : val(0.), idx(Tape <Real>::none) {}
+            Variable(Real const & val_) : val(val_), idx(Tape <Real>::none) {}
+
+            // Variables with a known place on the tape
+            Variable(Real const & val_,Natural const & idx_)
+                : val(val_), idx(idx_) {}
+
+            // Records the result of a unary operation f(x)
+            static Variable unary(
+                Variable const & x,
+                Real const & f,
+                Real const & df,
+                Real const & d2f
+            ) {
+                Tape <Real> * tape = Tape <Real>::active();
+                if(tape==nullptr || x.idx==Tape <Real>::none)
+                    return Variable(f);
+                return Variable(f,tape->push(x.idx,Tape <Real>::none,
+                    df,Real(0.),d2f,Real(0.),Real(0.)));
+            }
+
+            // Records the result of a binary operation f(x,y)
+            static Variable binary(
+                Variable const & x,
+                Variable const & y,
+                Real const & f,
+                Real const & dfx,
+                Real const & dfy,
+                Real const & d2fxx,
+                Real const & d2fxy,
+                Real const & d2fyy
+            ) {
+                if(y.idx==Tape <Real>::none) return unary(x,f,dfx,d2fxx);
+                if(x.idx==Tape <Real>::none) return unary(y,f,dfy,d2fyy);
+                Tape <Real> * tape = Tape <Real>::active();
+                if(tape==nullptr) return Variable(f);
+                return Variable(f,tape->push(x.idx,y.idx,
+                    dfx,dfy,d2fxx,d2fxy,d2fyy));
+            }
+
+            // Compound assignment
+            Variable & operator += (Variable const & y) {
+                return *this = *this + y;
+            }
+            Variable & operator -= (Variable const & y) {
+                return *this = *this - y;
+            }
+            Variable & operator *= (Variable const & y) {
+                return *this = *this * y;
+            }
+            Variable & operator /= (Variable const & y) {
+                return *this = *this / y;
+            }
+        };
+
+        // Arithmetic
+        template <typename Real>
+        Variable <Real> operator + (Variable <Real> const & x) {
+            return x;
+        }
+        template <typename Real>
+        Variable <Real> operator - (Variable <Real> const & x) {
+            return Variable <Real>::unary(x,-x.val,Real(-1.),Real(0.));
+        }
+        template <typename Real>
+        Variable <Real> operator + (
+            Variable <Real> const & x,
+            Variable <Real> const & y
+        ) {
+            return Variable <Real>::binary(x,y,x.val+y.val,
+                Real(1.),Real(1.),Real(0.),Real(0.),Real(0.));
+        }
+        template <typename Real>
+        Variable <Real> operator - (
+            Variable <Real> const & x,
+            Variable <Real> const & y
+        ) {
+            return Variable <Real>::binary(x,y,x.val-y.val,
+                Real(1.),Real(-1.),Real(0.),Real(0.),Real(0.));
+        }
+        template <typename Real>
+        Variable <Real> operator * (
+            Variable <Real> const & x,
+            Variable <Real> const & y
+        ) {
+            return Variable <Real>::binary(x,y,x.val*y.val,
+                y.val,x.val,Real(0.),Real(1.),Real(0.));
+        }
+        template <typename Real>
+        Variable <Real> operator / (
+            Variable <Real> const & x,
+            Variable <Real> const & y
+        ) {
+            Real const y_inv = Real(1.)/y.val;
+            Real const f = x.val*y_inv;
+            return Variable <Real>::binary(x,y,f,
+                y_inv,-f*y_inv,Real(0.),-y_inv*y_inv,Real(2.)*f*y_inv*y_inv);
+        }
+
+        // Arithmetic with constants of type Real.  Without these, template
+        // deduction fails on expressions such as 2.*x.
+        #define OPTIZELLE_AD_CONSTANT_OPERATOR(op) \
+            template <typename Real> \
+            Variable <Real> operator op ( \
+                Variable <Real> const & x, \
+                typename Variable <Real>::Scalar const & y \
+            ) { \
+                return x op Variable <Real> (y); \
+            } \
+            template <typename Real> \
+            Variable <Real> operator op ( \
+                typename Variable <Real>::Scalar const & x, \
+                Variable <Real> const & y \
+            ) { \
+                return Variable <Real> (x) op y; \
+            }
+        OPTIZELLE_AD_CONSTANT_OPERATOR(+)
+        OPTIZELLE_AD_CONSTANT_OPERATOR(-)
+        OPTIZELLE_AD_CONSTANT_OPERATOR(*)
+        OPTIZELLE_AD_CONSTANT_OPERATOR(/)
+        #undef OPTIZELLE_AD_CONSTANT_OPERATOR
+
+        // Comparisons look at the values, which lets branches in the
+        // user's function work on the tape
+        #define OPTIZELLE_AD_COMPARISON(op) \
+            template <typename Real> \
+            bool operator op ( \
+                Variable <Real> const & x, \
+                Variable <Real> const & y \
+            ) { \
+                return x.val op y.val; \
+            } \
+            template <typename Real> \
+            bool operator op ( \
+                Variable <Real> const & x, \
+                typename Variable <Real>::Scalar const & y \
+            ) { \
+                return x.val op y; \
+            } \
+            template <typename Real> \
+            bool operator op ( \
+                typename Variable <Real>::Scalar const & x, \
+                Variable <Real> const & y \
+            ) { \
+                return x op y.val; \
+            }
+        OPTIZELLE_AD_COMPARISON(<)
+        OPTIZELLE_AD_COMPARISON(<=)
+        OPTIZELLE_AD_COMPARISON(>)
+        OPTIZELLE_AD_COMPARISON(>=)
+        OPTIZELLE_AD_COMPARISON(==)
+        OPTIZELLE_AD_COMPARISON(!=)
+        #undef OPTIZELLE_AD_COMPARISON
+
+        // Elementary functions
+        template <typename Real>
+        Variable <Real> sin(Variable <Real> const & x) {
+            Real const s = std::sin(x.val);
+            return Variable <Real>::unary(x,s,std::cos(x.val),-s);
+        }
+        template <typename Real>
+        Variable <Real> cos(Variable <Real> const & x) {
+            Real const c = std::cos(x.val);
+            return Variable <Real>::unary(x,c,-std::sin(x.val),-c);
+        }
+        template <typename Real>
+        Variable <Real> tan(Variable <Real> const & x) {
+            Real const t = std::tan(x.val);
+            Real const dt = Real(1.)+t*t;
+            return Variable <Real>::unary(x,t,dt,Real(2.)*t*dt);
+        }
+        template <typename Real>
+        Variable <Real> atan(Variable <Real> const & x) {
+            Real const d = Real(1.)/(Real(1.)+x.val*x.val);
+            return Variable <Real>::unary(x,std::atan(x.val),d,
+                Real(-2.)*x.val*d*d);
+        }
+        template <typename Real>
+        Variable <Real> tanh(Variable <Real> const & x) {
+            Real const t = std::tanh(x.val);
+            Real const dt = Real(1.)-t*t;
+            return Variable <Real>::unary(x,t,dt,Real(-2.)*t*dt);
+        }
+        template <typename Real>
+        Variable <Real> exp(Variable <Real> const & x) {
+            Real const e = std::exp(x.val);
+            return Variable <Real>::unary(x,e,e,e);
+        }
+        template <typename Real>
+        Variable <Real> log(Variable <Real> const & x) {
+            Real const x_inv = Real(1.)/x.val;
+            return Variable <Real>::unary(x,std::log(x.val),x_inv,
+                -x_inv*x_inv);
+        }
+        template <typename Real>
+        Variable <Real> sqrt(Variable <Real> const & x) {
+            Real const s = std::sqrt(x.val);
+            Real const ds = Real(0.5)/s;
+            return Variable <Real>::unary(x,s,ds,-ds/(Real(2.)*x.val));
+        }
+        template <typename Real>
+        Variable <Real> pow(
+            Variable <Real> const & x,
+            typename Variable <Real>::Scalar const & p
+        ) {
+            Real const f = std::pow(x.val,p-Real(2.));
+            return Variable <Real>::unary(x,f*x.val*x.val,p*f*x.val,
+                p*(p-Real(1.))*f);
+        }
+        template <typename Real>
+        Variable <Real> fabs(Variable <Real> const & x) {
+            return Variable <Real>::unary(x,std::fabs(x.val),
+                x.val < Real(0.) ? Real(-1.) : Real(1.),Real(0.));
+        }
+        template <typename Real>
+        Variable <Real> abs(Variable <Real> const & x) {
+            return fabs(x);
+        }
+
+        // Records the function F at x and returns the indices of the outputs
+        // on the tape.  The functor either returns a scalar or fills an
+        // output vector of size m.
+        template <typename Real,typename F>
+        void record(
+            F const & f,
+            std::vector <Real> const & x,
+            Natural const & m,
+            Tape <Real> & tape,
+            std::vector <Natural> & outputs,
+            std::true_type const & scalar
+        ) {
+            std::vector <Variable <Real> > x_ad(x.size());
+            for(Natural i=0;i<x.size();i++)
+                x_ad[i]=Variable <Real> (x[i],tape.push(Tape <Real>::none,
+                    Tape <Real>::none,Real(0.),Real(0.),Real(0.),Real(0.),
+                    Real(0.)));
+            outputs.assign(1,f(x_ad).idx);
+        }
+        template <typename Real,typename F>
+        void record(
+            F const & f,
+            std::vector <Real> const & x,
+            Natural const & m,
+            Tape <Real> & tape,
+            std::vector <Natural> & outputs,
+            std::false_type const & scalar
+        ) {
+            std::vector <Variable <Real> > x_ad(x.size());
+            for(Natural i=0;i<x.size();i++)
+                x_ad[i]=Variable <Real> (x[i],tape.push(Tape <Real>::none,
+                    Tape <Real>::none,Real(0.),Real(0.),Real(0.),Real(0.),
+                    Real(0.)));
+            std::vector <Variable <Real> > y_ad(m);
+            f(x_ad,y_ad);
+            outputs.resize(m);
+            for(Natural i=0;i<m;i++)
+                outputs[i]=y_ad[i].idx;
+        }
+
+        // Holds the tape of a function along with the point where we recorded
+        // it.  Functors with the signature T f(std::vector <T> const &) are
+        // scalar valued and everything else is vector valued.
+        template <typename Real,typename F>
+        struct Recording {
+        private:
+            // Whether or not the function is scalar valued, which we detect
+            // by whether it can be called with a single argument
+            template <typename G>
+            static std::true_type is_scalar(decltype(std::declval <G const &>()(
+                std::declval <std::vector <Variable <Real> > const &> ()))*);
+            template <typename G>
+            static std::false_type is_scalar(...);
+            typedef decltype(is_scalar <F> (nullptr)) scalar;
+
+            // Point where we last recorded the tape
+            std::vector <Real> x_last;
+
+            // Whether we've recorded anything yet
+            bool recorded;
+
+        public:
+            // Disallow constructors
+            NO_COPY_ASSIGNMENT(Recording)
+
+            // The tape
+            Tape <Real> tape;
+
+            // Indices of the outputs on the tape
+            std::vector <Natural> outputs;
+
+            // Workspaces for the sweeps
+            std::vector <Real> v_bar;
+            std::vector <Real> dv;
+            std::vector <Real> dv_bar;
+
+            Recording() : x_last(), recorded(false), tape(), outputs(),
+                v_bar(), dv(), dv_bar() {}
+
+            // Makes sure that the tape corresponds to f at x
+            void update(F const & f,std::vector <Real> const & x,
+                Natural const & m)
+            {
+                if(recorded && x==x_last && outputs.size()==m)
+                    return;
+                tape.clear();
+                Tape <Real> * const active = Tape <Real>::active();
+                Tape <Real>::active() = &tape;
+                record(f,x,m,tape,outputs,scalar());
+                Tape <Real>::active() = active;
+                x_last=x;
+                recorded=true;
+            }
+
+            // Seeds the adjoints of the outputs with y_bar
+            void seed(Real const * const y_bar) {
+                v_bar.assign(tape.size(),Real(0.));
+                for(Natural i=0;i<outputs.size();i++)
+                    if(outputs[i]!=Tape <Real>::none)
+                        v_bar[outputs[i]]+=y_bar[i];
+            }
+        };
+
+        // Scalar valued function whose derivatives come from automatic
+        // differentiation.  The functor F must provide
+        //
+        // template <typename T> T operator () (std::vector <T> const & x)
+        template <typename Real,typename F>
+        struct ScalarValuedFunction
+            : public Optizelle::ScalarValuedFunction <Real,Rm>
+        {
+        private:
+            // Function
+            F const f;
+
+            // Tape of f at the last point where we took a derivative
+            mutable Recording <Real,F> rec;
+
+        public:
+            // Create some type shortcuts
+            typedef Rm <Real> X;
+            typedef typename X::Vector X_Vector;
+
+            // Prevent constructors
+            NO_DEFAULT_COPY_ASSIGNMENT(ScalarValuedFunction)
+
+            ScalarValuedFunction(F const & f_) : f(f_), rec() {}
+
+            // <- f(x).  This doesn't need a tape.
+            Real eval(X_Vector const & x) const {
+                return f(x);
+            }
+
+            // grad = grad f(x) by a reverse sweep
+            void grad(X_Vector const & x,X_Vector & g) const {
+                Real const one(1.);
+                rec.update(f,x,1);
+                rec.seed(&one);
+                rec.tape.reverse(rec.v_bar,nullptr,rec.dv_bar);
+                for(Natural i=0;i<x.size();i++)
+                    g[i]=rec.v_bar[i];
+            }
+
+            // H_dx = hess f(x) dx by forward-over-reverse
+            void hessvec(
+                X_Vector const & x,
+                X_Vector const & dx,
+                X_Vector & H_dx
+            ) const {
+                Real const one(1.);
+                rec.update(f,x,1);
+                rec.tape.forward(dx,rec.dv);
+                rec.seed(&one);
+                rec.tape.reverse(rec.v_bar,&rec.dv,rec.dv_bar);
+                for(Natural i=0;i<x.size();i++)
+                    H_dx[i]=rec.dv_bar[i];
+            }
+
+            // H = hess f(x) by one forward-over-reverse sweep per column
+            bool hessian(X_Vector const & x,std::vector <Real> & H) const {
+                Real const one(1.);
+                Natural const m=x.size();
+                X_Vector e(m,Real(0.));
+                rec.update(f,x,1);
+                for(Natural j=0;j<m;j++) {
+                    e[j]=Real(1.);
+                    rec.tape.forward(e,rec.dv);
+                    rec.seed(&one);
+                    rec.tape.reverse(rec.v_bar,&rec.dv,rec.dv_bar);
+                    for(Natural i=0;i<m;i++)
+                        H[i+j*m]=rec.dv_bar[i];
+                    e[j]=Real(0.);
+                }
+                return true;
+            }
+        };
+
+        // Vector valued function whose derivatives come from automatic
+        // differentiation.  The functor F must provide
+        //
+        // template <typename T>
+        // void operator () (std::vector <T> const & x,std::vector <T> & y)
+        template <typename Real,typename F>
+        struct VectorValuedFunction
+            : public Optizelle::VectorValuedFunction <Real,Rm,Rm>
+        {
+        private:
+            // Function
+            F const f;
+
+            // Tape of f at the last point where we took a derivative
+            mutable Recording <Real,F> rec;
+
+        public:
+            // Create some type shortcuts
+            typedef Rm <Real> X;
+            typedef typename X::Vector X_Vector;
+            typedef Rm <Real> Y;
+            typedef typename Y::Vector Y_Vector;
+
+            // Prevent constructors
+            NO_DEFAULT_COPY_ASSIGNMENT(VectorValuedFunction)
+
+            VectorValuedFunction(F const & f_) : f(f_), rec() {}
+
+            // y=f(x).  This doesn't need a tape.
+            void eval(X_Vector const & x,Y_Vector & y) const {
+                f(x,y);
+            }
+
+            // y=f'(x)dx by a forward sweep
+            void p(X_Vector const & x,X_Vector const & dx,Y_Vector & y) const {
+                rec.update(f,x,y.size());
+                rec.tape.forward(dx,rec.dv);
+                for(Natural i=0;i<y.size();i++)
+                    y[i] = rec.outputs[i]!=Tape <Real>::none
+                        ? rec.dv[rec.outputs[i]] : Real(0.);
+            }
+
+            // z=f'(x)*dy by a reverse sweep
+            void ps(X_Vector const & x,Y_Vector const & dy,X_Vector & z) const{
+                rec.update(f,x,dy.size());
+                rec.seed(&(dy[0]));
+                rec.tape.reverse(rec.v_bar,nullptr,rec.dv_bar);
+                for(Natural i=0;i<x.size();i++)
+                    z[i]=rec.v_bar[i];
+            }
+
+            // z=(f''(x)dx)*dy by forward-over-reverse
+            void pps(
+                X_Vector const & x,
+                X_Vector const & dx,
+                Y_Vector const & dy,
+                X_Vector & z
+            ) const {
+                rec.update(f,x,dy.size());
+                rec.tape.forward(dx,rec.dv);
+                rec.seed(&(dy[0]));
+                rec.tape.reverse(rec.v_bar,&rec.dv,rec.dv_bar);
+                for(Natural i=0;i<x.size();i++)
+                    z[i]=rec.dv_bar[i];
+            }
+        };
+    }
+}
+#endif
@@ -0,0 +1,405 @@
+/*
+Copyright 2013-2014 OptimoJoe.
+
+For the full copyright notice, see LICENSE.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Author: Joseph Young (joe@optimojoe.com)
+*/
+
+#ifndef DISTRIBUTED_H
+#define DISTRIBUTED_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "optizelle/optizelle.h"
+#include "optizelle/linalg.h"
+#include "optizelle/vspaces.h"
+
+//---Optizelle0---
+namespace Optizelle {
+//---Optizelle1---
+
+    // Collective operations among the ranks that together hold a distributed
+    // vector.  Every rank runs the same optimization on its own piece of each
+    // vector, so every rank must call the collectives in the same order and
+    // must receive exactly the same result from each of them.  Otherwise,
+    // the ranks make different decisions and deadlock.
+    template <typename Real>
+    struct Communicator {
+        // Disallow constructors
+        NO_COPY_ASSIGNMENT(Communicator)
+
+        // Give an empty default constructor
+        Communicator() {}
+
+        // Number of this rank, 0 <= rank < size
+        virtual Natural rank() const = 0;
+
+        // Number of ranks
+        virtual Natural size() const = 0;
+
+        // x <- the elementwise sum of x over all the ranks
+        virtual void allreduce_sum(Real * const x,Natural const & n) const = 0;
+
+        // x <- the elementwise minimum of x over all the ranks
+        virtual void allreduce_min(Real * const x,Natural const & n) const = 0;
+
+        // Allow a derived class to deallocate memory
+        virtual ~Communicator() {}
+    };
+
+    // State shared by a group of ranks that run as threads in a single
+    // process.  Each rank writes its contribution to a reduction into its
+    // own slot and, after everyone has written, combines the slots in rank
+    // order.  This gives every rank the same result bit for bit.
+    template <typename Real>
+    struct LocalGroup {
+        // Disallow constructors
+        NO_DEFAULT_COPY_ASSIGNMENT(LocalGroup)
+
+        // Number of ranks
+        Natural const size;
+
+        // Contribution of each rank to the current reduction
+        std::vector <std::vector <Real> > slots;
+
+        // Synchronization for the barrier
+        std::mutex mtx;
+        std::condition_variable cv;
+        Natural waiting;
+        Natural generation;
+
+        // Creates a group of size ranks
+        explicit LocalGroup(Natural const & size_) :
+            size(size_),
+            slots(size_),
+            mtx(),
+            cv(),
+            waiting(0),
+            generation(0)
+        {}
+
+        // Waits until every rank reaches the barrier
+        void barrier() {
+            std::unique_lock <std::mutex> lock(mtx);
+            Natural const gen = generation;
+            if(++waiting == size) {
+                waiting = 0;
+                generation++;
+                cv.notify_all();
+            } else
+                cv.wait(lock,[&]() { return gen != generation; });
+        }
+    };
+
+    // One rank in a group of ranks that run as threads in a single process.
+    // This lets us run and test distributed code on one machine.
+    template <typename Real>
+    struct LocalCommunicator : public Communicator <Real> {
+    private:
+        // Group that this rank belongs to
+        LocalGroup <Real> & group;
+
+        // Number of this rank
+        Natural const myrank;
+
+        // Combines the contributions from all of the ranks with op
+        template <typename Op>
+        void allreduce(Real * const x,Natural const & n,Op const & op) const {
+            group.slots[myrank].assign(x,x+n);
+            group.barrier();
+            std::copy(group.slots[0].begin(),group.slots[0].end(),x);
+            for(Natural r=1;r<group.size;r++)
+                for(Natural i=0;i<n;i++)
+                    x[i]=op(x[i],group.slots[r][i]);
+            group.barrier();
+        }
+
+    public:
+        // Disallow constructors
+        NO_DEFAULT_COPY_ASSIGNMENT(LocalCommunicator)
+
+        // Joins the group as rank myrank_
+        LocalCommunicator(LocalGroup <Real> & group_,Natural const & myrank_)
+            : group(group_), myrank(myrank_)
+        {}
+
+        // Number of this rank
+        Natural rank() const {
+            return myrank;
+        }
+
+        // Number of ranks
+        Natural size() const {
+            return group.size;
+        }
+
+        // x <- the elementwise sum of x over all the ranks
+        void allreduce_sum(Real * const x,Natural const & n) const {
+            allreduce(x,n,[](Real const & a,Real const & b) { return a+b; });
+        }
+
+        // x <- the elementwise minimum of x over all the ranks
+        void allreduce_min(Real * const x,Natural const & n) const {
+            allreduce(x,n,[](Real const & a,Real const & b) {
+                return b < a ? b : a;
+            });
+        }
+    };
+
+    // Runs f(comm) on p ranks, each in its own thread with its own
+    // communicator, and waits for all of them to finish
+    template <typename Real,typename F>
+    void runLocalRanks(Natural const & p,F const & f) {
+        LocalGroup <Real> group(p);
+        std::vector <std::thread> ranks;
+        for(Natural rank=0;rank<p;rank++)
+            ranks.emplace_back([&group,&f,rank]() {
+                LocalCommunicator <Real> comm(group,rank);
+                f(comm);
+            });
+        for(auto & rank : ranks)
+            rank.join();
+    }
+
+#ifdef MPI_VERSION
+    // MPI datatype that matches Real
+    template <typename Real>
+    struct MPIType {};
+    template <>
+    struct MPIType <double> {
+        static MPI_Datatype value() { return MPI_DOUBLE; }
+    };
+    template <>
+    struct MPIType <float> {
+        static MPI_Datatype value() { return MPI_FLOAT; }
+    };
+
+    // Ranks in an MPI communicator.  We only define this when the user
+    // includes mpi.h before this header.
+    template <typename Real>
+    struct MPICommunicator : public Communicator <Real> {
+    private:
+        // Underlying MPI communicator
+        MPI_Comm comm;
+
+    public:
+        // Disallow constructors
+        NO_DEFAULT_COPY_ASSIGNMENT(MPICommunicator)
+
+        // Uses the MPI communicator comm_, such as MPI_COMM_WORLD
+        explicit MPICommunicator(MPI_Comm const & comm_) : comm(comm_) {}
+
+        // Number of this rank
+        Natural rank() const {
+            int myrank;
+            MPI_Comm_rank(comm,&myrank);
+            return Natural(myrank);
+        }
+
+        // Number of ranks
+        Natural size() const {
+            int mysize;
+            MPI_Comm_size(comm,&mysize);
+            return Natural(mysize);
+        }
+
+        // x <- the elementwise sum of x over all the ranks
+        void allreduce_sum(Real * const x,Natural const & n) const {
+            MPI_Allreduce(MPI_IN_PLACE,x,int(n),MPIType <Real>::value(),
+                MPI_SUM,comm);
+        }
+
+        // x <- the elementwise minimum of x over all the ranks
+        void allreduce_min(Real * const x,Natural const & n) const {
+            MPI_Allreduce(MPI_IN_PLACE,x,int(n),MPIType <Real>::value(),
+                MPI_MIN,comm);
+        }
+    };
+#endif
+
+    // A vector whose pieces live on different ranks.  Each rank holds its
+    // piece as a vector in the space XX along with the communicator that
+    // connects it to the other pieces.  The communicator must outlive the
+    // vector.
+    template <typename Real,template <typename> class XX>
+    struct DistributedVector {
+        // Create some type shortcuts
+        typedef typename XX <Real>::Vector X_Vector;
+
+        // Communicator among the ranks that hold the pieces
+        Communicator <Real> const * comm;
+
+        // Piece of the vector on this rank
+        X_Vector local;
+
+        // Eliminate constructors
+        NO_DEFAULT_COPY_ASSIGNMENT(DistributedVector)
+
+        // Holds the piece local_ of a vector distributed over comm_
+        DistributedVector(
+            Communicator <Real> const & comm_,
+            X_Vector && local_
+        ) : comm(&comm_), local(std::move(local_)) {}
+
+        // Move constructor
+        DistributedVector(DistributedVector && x) :
+            comm(x.comm), local(std::move(x.local))
+        {}
+
+        // Move assignment
+        DistributedVector & operator = (DistributedVector && x) {
+            comm = x.comm;
+            local = std::move(x.local);
+            return *this;
+        }
+    };
+
+    // Vector space whose vectors are partitioned across ranks.  Each rank
+    // runs the same optimization and holds one piece of every vector, which
+    // is itself a vector in the space XX.  Everything except the reductions
+    // works on the local pieces alone.  The inner product, barrier, and line
+    // search combine the local results with a single collective each.  This
+    // works for any space where these three functions are a sum or a
+    // minimum over the pieces, such as Rm split by elements or SQL split by
+    // blocks.  The user functions receive the local pieces and need to
+    // reduce over the communicator themselves.  Typically, only one rank
+    // should print, so set msg_level to 0 on the others.
+    template <typename Real,template <typename> class XX>
+    struct Distributed {
+        // Disallow constructors
+        NO_CONSTRUCTORS(Distributed)
+
+        // Create some type shortcuts
+        typedef XX <Real> X;
+
+        // Store the local piece along with the communicator
+        typedef DistributedVector <Real,XX> Vector;
+
+        // Divides n elements as evenly as possible over the ranks and
+        // returns the range [begin,end) held by this rank
+        static std::pair <Natural,Natural> partition(
+            Natural const & n,
+            Communicator <Real> const & comm
+        ) {
+            Natural const p = comm.size();
+            Natural const r = comm.rank();
+            Natural const begin = r*(n/p) + std::min(r,n%p);
+            return std::pair <Natural,Natural> (
+                begin,begin + n/p + (r < n%p ? 1 : 0));
+        }
+
+        // Memory allocation and size setting
+        static Vector init(Vector const & x) {
+            return std::move(Vector(*x.comm,X::init(x.local)));
+        }
+
+        // y <- x (Shallow.  No memory allocation.)
+        static void copy(Vector const & x, Vector & y) {
+            X::copy(x.local,y.local);
+        }
+
+        // x <- alpha * x
+        static void scal(Real const & alpha, Vector & x) {
+            X::scal(alpha,x.local);
+        }
+
+        // y <- alpha * x + y
+        static void axpy(Real const & alpha, Vector const & x, Vector & y) {
+            X::axpy(alpha,x.local,y.local);
+        }
+
+        // innr <- <x,y>
+        static Real innr(Vector const & x,Vector const & y) {
+            Real z = X::innr(x.local,y.local);
+            x.comm->allreduce_sum(&z,1);
+            return z;
+        }
+
+        // x <- 0
+        static void zero(Vector & x) {
+            X::zero(x.local);
+        }
+
+        // x <- random
+        static void rand(Vector & x) {
+            X::rand(x.local);
+        }
+
+        // Jordan product, z <- x o y
+        static void prod(Vector const & x, Vector const & y, Vector & z) {
+            X::prod(x.local,y.local,z.local);
+        }
+
+        // Identity element, x <- e such that x o e = x
+        static void id(Vector & x) {
+            X::id(x.local);
+        }
+
+        // Jordan product inverse, z <- inv(L(x)) y where L(x) y = x o y
+        static void linv(Vector const & x,Vector const & y,Vector & z) {
+            X::linv(x.local,y.local,z.local);
+        }
+
+        // Barrier function, barr <- barr(x) where x o grad barr(x) = e
+        static Real barr(Vector const & x) {
+            Real z = X::barr(x.local);
+            x.comm->allreduce_sum(&z,1);
+            return z;
+        }
+
+        // Line search, srch <- argmax {alpha \in Real >= 0 : alpha x + y >= 0}
+        // where y > 0
+        static Real srch(Vector const & x,Vector const & y) {
+            Real alpha = X::srch(x.local,y.local);
+            x.comm->allreduce_min(&alpha,1);
+            return alpha;
+        }
+
+        // Symmetrization, x <- symm(x) such that L(symm(x)) is a symmetric
+        // operator
+        static void symm(Vector & x) {
+            X::symm(x.local);
+        }
+    };
+
+    // R^m with its elements partitioned across ranks
+    template <typename Real>
+    using DistributedRm = Distributed <Real,Rm>;
+
+    // SQL with its blocks partitioned across ranks
+    template <typename Real>
+    using DistributedSQL = Distributed <Real,SQL>;
+
+//---Optizelle2---
+}
+//---Optizelle3---
+#endif
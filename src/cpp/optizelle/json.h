@@ -286,7 +286,7 @@ namespace Optizelle {
                 Json::StyledWriter writer;
 
                 // Loop over all the names in the root
-                for(Json::ValueIterator itr=root[vs].begin();
+                for(Json::ValueConstIterator itr=root[vs].begin();
                     itr!=root[vs].end();
                     itr++
                 ){
@@ -307,7 +307,7 @@ namespace Optizelle {
                 typename RestartPackage <Real>::t & reals
             ) {
                 // Loop over all the names in the root
-                for(Json::ValueIterator itr=root[vs].begin();
+                for(Json::ValueConstIterator itr=root[vs].begin();
                     itr!=root[vs].end();
                     itr++
                 ){
@@ -380,6 +380,13 @@ namespace Optizelle {
                         "history_reset",
                         Json::Value::UInt64(state.history_reset)),
                     "history_reset");
+                state.history_precision=read::param <KrylovPrecision::t> (
+                    msg,
+                    root["Optizelle"].get("history_precision",
+                        KrylovPrecision::to_string(state.history_precision)),
+                    KrylovPrecision::is_valid,
+                    KrylovPrecision::from_string,
+                    "history_precision");
                 state.iter_max=read::natural(
                     msg,
                     root["Optizelle"].get(
@@ -398,6 +405,12 @@ namespace Optizelle {
                         "krylov_orthog_max",
                         Json::Value::UInt64(state.krylov_orthog_max)),
                     "krylov_orthog_max");
+                state.dense_size_max=read::natural(
+                    msg,
+                    root["Optizelle"].get(
+                        "dense_size_max",
+                        Json::Value::UInt64(state.dense_size_max)),
+                    "dense_size_max");
                 state.eps_krylov=read::real <Real> (
                     msg,
                     root["Optizelle"].get("eps_krylov",state.eps_krylov),
@@ -409,6 +422,13 @@ namespace Optizelle {
                     KrylovSolverTruncated::is_valid,
                     KrylovSolverTruncated::from_string,
                     "krylov_solver");
+                state.krylov_precision=read::param <KrylovPrecision::t> (
+                    msg,
+                    root["Optizelle"].get("krylov_precision",
+                        KrylovPrecision::to_string(state.krylov_precision)),
+                    KrylovPrecision::is_valid,
+                    KrylovPrecision::from_string,
+                    "krylov_precision");
                 state.algorithm_class=read::param <AlgorithmClass::t> (
                     msg,
                     root["Optizelle"].get("algorithm_class",
@@ -517,14 +537,20 @@ namespace Optizelle {
                     state.stored_history);
                 root["Optizelle"]["history_reset"]=write::natural(
                     state.history_reset);
+                root["Optizelle"]["history_precision"]=write_param(
+                    KrylovPrecision::to_string,state.history_precision);
                 root["Optizelle"]["iter_max"]=write::natural(state.iter_max);
                 root["Optizelle"]["krylov_iter_max"]=write::natural(
                     state.krylov_iter_max);
                 root["Optizelle"]["krylov_orthog_max"]=write::natural(
                     state.krylov_orthog_max);
+                root["Optizelle"]["dense_size_max"]=write::natural(
+                    state.dense_size_max);
                 root["Optizelle"]["eps_krylov"]=write::real(state.eps_krylov);
                 root["Optizelle"]["krylov_solver"]=write_param(
                     KrylovSolverTruncated::to_string,state.krylov_solver);
+                root["Optizelle"]["krylov_precision"]=write_param(
+                    KrylovPrecision::to_string,state.krylov_precision);
                 root["Optizelle"]["algorithm_class"]=write_param(
                     AlgorithmClass::to_string,state.algorithm_class);
                 root["Optizelle"]["PH_type"]=write_param(
@@ -228,6 +228,20 @@ void dpftrf_fortran(char* transr,char* uplo,Integer* n,double* Arf,
 void spftrf_fortran(char* transr,char* uplo,Integer* n,float* Arf,
     Integer* info);
 
+#define dpftri_fortran FortranCInterface_GLOBAL (dpftri,DPFTRI)
+void dpftri_fortran(char* transr,char* uplo,Integer* n,double* Arf,
+    Integer* info);
+#define spftri_fortran FortranCInterface_GLOBAL (spftri,SPFTRI)
+void spftri_fortran(char* transr,char* uplo,Integer* n,float* Arf,
+    Integer* info);
+
+#define dpftrs_fortran FortranCInterface_GLOBAL (dpftrs,DPFTRS)
+void dpftrs_fortran(char* transr,char* uplo,Integer* n,Integer* nrhs,
+    double* Arf,double* B,Integer* ldb,Integer* info);
+#define spftrs_fortran FortranCInterface_GLOBAL (spftrs,SPFTRS)
+void spftrs_fortran(char* transr,char* uplo,Integer* n,Integer* nrhs,
+    float* Arf,float* B,Integer* ldb,Integer* info);
+
 #define dtrtri_fortran FortranCInterface_GLOBAL (dtrtri,DTRTRI)
 void dtrtri_fortran(char* uplo,char* diag,Integer* n,double* A,Integer* lda,
     Integer* info);
@@ -688,6 +702,30 @@ namespace Optizelle {
         spftrf_fortran(&transr,&uplo,&n,Arf,&info);
     }
 
+    template <>
+    void pftri(char transr,char uplo,Integer n,double* Arf,Integer& info) {
+        dpftri_fortran(&transr,&uplo,&n,Arf,&info);
+    }
+    template <>
+    void pftri(char transr,char uplo,Integer n,float* Arf,Integer& info) {
+        spftri_fortran(&transr,&uplo,&n,Arf,&info);
+    }
+
+    template <>
+    void pftrs(char transr,char uplo,Integer n,Integer nrhs,
+        double const * const Arf,double* B,Integer ldb,Integer& info
+    ) {
+        dpftrs_fortran(&transr,&uplo,&n,&nrhs,const_cast <double*> (Arf),B,
+            &ldb,&info);
+    }
+    template <>
+    void pftrs(char transr,char uplo,Integer n,Integer nrhs,
+        float const * const Arf,float* B,Integer ldb,Integer& info
+    ) {
+        spftrs_fortran(&transr,&uplo,&n,&nrhs,const_cast <float*> (Arf),B,
+            &ldb,&info);
+    }
+
     template <>
     void trtri(
         char uplo,char diag,Integer n,double* A,Integer lda,Integer& info
@@ -825,8 +863,10 @@ namespace Optizelle {
         // Determine k where m = 2k when m is even or m = 2k+1 when m is odd
         const Natural k = m/2; 
 
-        // Return the index
-        return i<=k && j<=k ? j-1 + k+1 + (2*k+1)*(i-1) : i-1 + (j-1-k)*m;
+        // Return the index.  The leading dimension of the RFP matrix is
+        // 2k+1, which is m when m is odd and m+1 when m is even.
+        return i<=k && j<=k ? j-1 + k+1 + (2*k+1)*(i-1)
+                            : i-1 + (j-1-k)*(2*k+1);
     }
 
     // Indexing for vectors.  Assumes the first index is 1.
@@ -887,4 +927,43 @@ namespace Optizelle {
                 return false;
         }
     }
+
+    namespace KrylovPrecision{
+        // Converts the Krylov precision to a string
+        std::string to_string(t const & krylov_precision){
+            switch(krylov_precision){
+            case Full:
+                return "Full";
+            case Mixed:
+                return "Mixed";
+            case Compressed:
+                return "Compressed";
+            default:
+                throw;
+            }
+        }
+
+        // Converts a string to a Krylov precision
+        t from_string(std::string const & krylov_precision){
+            if(krylov_precision=="Full")
+                return Full;
+            else if(krylov_precision=="Mixed")
+                return Mixed;
+            else if(krylov_precision=="Compressed")
+                return Compressed;
+            else
+                throw;
+        }
+
+        // Checks whether or not a string is valid
+        bool is_valid(std::string const & name) {
+            if( name=="Full" ||
+                name=="Mixed" ||
+                name=="Compressed"
+            )
+                return true;
+            else
+                return false;
+        }
+    }
 }
@@ -34,6 +34,7 @@ Author: Joseph Young (joe@optimojoe.com)
 
 #include <vector>
 #include <list>
+#include <deque>
 #include <cmath>
 #include <limits>
 #include <utility>
@@ -42,6 +43,10 @@ Author: Joseph Young (joe@optimojoe.com)
 #include <iostream>
 #include <cstdlib>
 #include <random>
+#include <type_traits>
+#include <cassert>
+#include <memory>
+#include "optizelle/trace.h"
 
 // Putting this into a class prevents its construction.  Essentially, we use
 // this trick in order to create modules like in ML.  It also allows us to
@@ -507,6 +512,23 @@ namespace Optizelle {
     template <>
     void pftrf(char transr,char uplo,Integer n,float* Arf,Integer& info);
 
+    template <typename Real>
+    void pftri(char transr,char uplo,Integer n,Real* Arf,Integer& info);
+    template <>
+    void pftri(char transr,char uplo,Integer n,double* Arf,Integer& info);
+    template <>
+    void pftri(char transr,char uplo,Integer n,float* Arf,Integer& info);
+
+    template <typename Real>
+    void pftrs(char transr,char uplo,Integer n,Integer nrhs,
+        Real const * const Arf,Real* B,Integer ldb,Integer& info);
+    template <>
+    void pftrs(char transr,char uplo,Integer n,Integer nrhs,
+        double const * const Arf,double* B,Integer ldb,Integer& info);
+    template <>
+    void pftrs(char transr,char uplo,Integer n,Integer nrhs,
+        float const * const Arf,float* B,Integer ldb,Integer& info);
+
     template <typename Real>
     void trtri(char uplo,char diag,Integer n,Real* A,Integer lda,Integer& info);
     template <>
@@ -698,18 +720,23 @@ namespace Optizelle {
         beta.emplace_back(std::sqrt(dot <Real> (m,&(w[0]),1,&(w[0]),1)));
 
         // Allocate memory for solving an eigenvalue problem for the Ritz
-        // values and vectors later.
-        std::vector <Integer> isuppz;
-        std::vector <Real> work(1);
-        std::vector <Integer> iwork(1);
-        Integer lwork=-1;
-        Integer liwork=-1;
+        // values and vectors later.  We only ever need the leftmost Ritz pair,
+        // so we size everything once for the largest subproblem.
+        Natural const k_max = max_iter+1;
+        std::vector <Integer> isuppz(2*k_max);
+        Integer lwork=20*k_max;
+        std::vector <Real> work(lwork);
+        Integer liwork=10*k_max;
+        std::vector <Integer> iwork(liwork);
         Integer info;
         Integer nevals;
-        std::vector <Real> W;
-        std::vector <Real> Z;
-        std::vector <Real> D;
-        std::vector <Real> E;
+        std::vector <Real> W(k_max);
+        std::vector <Real> Z(k_max);
+        std::vector <Real> D(k_max);
+        std::vector <Real> E(k_max);
+        alpha.reserve(k_max);
+        beta.reserve(k_max);
+        W[0]=alpha[0];
 
         // Start Lanczos
         std::vector <Real> v_old(m);
@@ -743,28 +770,21 @@ namespace Optizelle {
             // of T.
             beta.emplace_back(std::sqrt(dot <Real> (m,&(w[0]),1,&(w[0]),1)));
    
-            // Figure out the workspaces for the eigenvalues and eigenvectors
+            // Find only the leftmost Ritz pair of the tridiagonal matrix.
+            // The workspace query is unnecessary since stevr needs at most
+            // 20k and 10k elements.
             Natural k=alpha.size();  // Size of the eigenvalue subproblem
-            D.resize(alpha.size());
             copy <Real> (k,&(alpha[0]),1,&(D[0]),1);
-            E.resize(beta.size());
             copy <Real> (k,&(beta[0]),1,&(E[0]),1);
-            isuppz.resize(2*k);
-            lwork=20*k;
-            work.resize(lwork);
-            liwork=10*k;
-            iwork.resize(liwork);
-            W.resize(k);
-            Z.resize(k*k);
-            Optizelle::stevr <Real> ('V','A',k,&(D[0]),&(E[0]),Real(0.),
-                Real(0.),0,0,Optizelle::lamch <Real> ('S'),
+            Optizelle::stevr <Real> ('V','I',k,&(D[0]),&(E[0]),Real(0.),
+                Real(0.),1,1,Optizelle::lamch <Real> ('S'),
                 nevals,&(W[0]),&(Z[0]),k,&(isuppz[0]),&(work[0]),
                 lwork,&(iwork[0]),liwork,info);
 
             // Find beta_i |s_{i1}| where s_{i1} is the last element
             // of the 1st Ritz vector, which corresponds to the smallest
             // Ritz value.
-            Real err_est = fabs(Z[ijtok(k,1,k)])*beta[i+1];
+            Real err_est = fabs(Z[k-1])*beta[i+1];
 
             // Stop of the error estimates are small
             if(err_est < tol)
@@ -857,6 +877,16 @@ namespace Optizelle {
         std::vector <Real> v1(m);
         std::vector <Real> v2(m);
 
+        // Allocate memory for tracking the leftmost Ritz pair of the
+        // tridiagonal part of H during the Arnoldi iteration
+        std::vector <Real> T_D(iter_innr_max);
+        std::vector <Real> T_E(iter_innr_max);
+        Real theta(0.);
+        std::vector <Real> s(iter_innr_max);
+        std::vector <Integer> isuppz(2*iter_innr_max);
+        std::vector <Real> work_ritz(20*iter_innr_max);
+        std::vector <Integer> iwork_ritz(10*iter_innr_max);
+
         // Continue to compute until we converge
         for(Natural iter_outr=1;iter_outr<=iter_outr_max;iter_outr++) {
             // If we restart, we already have a second Krylov vector.
@@ -880,6 +910,25 @@ namespace Optizelle {
                 norm_v=sqrt(
                     dot<Real>(m,&(V[ijtok(1,k+1,m)]),1,&(V[ijtok(1,k+1,m)]),1));
                 scal <Real> (m,Real(1.)/norm_v,&(V[ijtok(1,k+1,m)]),1);
+
+                // Check whether the leftmost Ritz pair has already converged.
+                // Since A is symmetric, H is tridiagonal, so we only need the
+                // smallest eigenvalue of a k x k tridiagonal matrix and the
+                // last element of its eigenvector.  Then, the residual of the
+                // Ritz pair is norm_v |s_k|.  This lets us stop in the middle
+                // of the Arnoldi iteration rather than waiting for the
+                // restart.
+                for(Natural i=1;i<=k;i++) {
+                    T_D[itok(i)]=Hp[ijtokp(i,i)];
+                    T_E[itok(i)]= i<k ? Hp[ijtokp(i,i+1)] : Real(0.);
+                }
+                stevr <Real> ('V','I',k,&(T_D[0]),&(T_E[0]),Real(0.),Real(0.),
+                    1,1,lamch <Real> ('S'),nevals,&theta,&(s[0]),k,
+                    &(isuppz[0]),&(work_ritz[0]),work_ritz.size(),
+                    &(iwork_ritz[0]),iwork_ritz.size(),info);
+                Real const err_est = norm_v*fabs(s[itok(k)]);
+                if(err_est < tol)
+                    return std::pair <Real,Real> (theta,err_est);
             }
 
             // Find the Ritz values of H 
@@ -1033,6 +1082,283 @@ namespace Optizelle {
         return syiram <Real> (m,&(Ap[0]),iter_innr_max,iter_outr_max,tol);
     }
 
+    // Solves the trust-region subproblem
+    //
+    // min <g,d> + 1/2 <H d,d> st || d || <= delta
+    //
+    // with a dense, symmetric H using the method of Moré and Sorensen.  The
+    // solution satisfies (H + lambda I) d = -g where H + lambda I is positive
+    // semidefinite, lambda >= 0, and lambda (delta - || d ||) = 0.  We find
+    // lambda with Newton's method on the secular equation
+    //
+    // 1/delta - 1/|| d(lambda) || = 0.
+    //
+    // When H is positive definite, its Cholesky factorization gives the
+    // Newton step and, if that lies outside the trust-region, each iteration
+    // factors H + lambda I.  Otherwise, we find the eigenvalue decomposition
+    // H = V D V' once, which makes each iteration, as well as each solve with
+    // a smaller radius after a rejected step, cost O(m).
+    template <typename Real>
+    struct MoreSorensen {
+    private:
+        // Size of the problem
+        Natural m;
+
+        // Hessian, gradient, and the norm of the gradient
+        std::vector <Real> H;
+        std::vector <Real> g;
+        Real norm_g;
+
+        // Cholesky factor of H, Newton step, and its norm when H is
+        // positive definite
+        bool newton;
+        std::vector <Real> U;
+        std::vector <Real> d_newton;
+        Real norm_newton;
+
+        // Eigenvectors and eigenvalues of H along with g in the eigenvector
+        // basis, V' g.  We only compute these when we need them.
+        std::vector <Real> V;
+        std::vector <Real> D;
+        std::vector <Real> g_eig;
+
+        // Finds the eigenvalue decomposition of H if we haven't already
+        void eig() {
+            if(D.size()==m) return;
+            D.resize(m);
+            V.resize(m*m);
+            g_eig.resize(m);
+            std::vector <Real> A(H);
+            Integer neig(0);
+            Integer info(0);
+            std::vector <Integer> isuppz(2*m);
+            Real work_size(0.);
+            Integer iwork_size(0);
+            syevr <Real> ('V','A','U',m,&(A[0]),m,Real(0.),Real(0.),0,0,
+                lamch <Real> ('S'),neig,&(D[0]),&(V[0]),m,&(isuppz[0]),
+                &work_size,-1,&iwork_size,-1,info);
+            std::vector <Real> work(static_cast <Natural> (work_size));
+            std::vector <Integer> iwork(iwork_size);
+            syevr <Real> ('V','A','U',m,&(A[0]),m,Real(0.),Real(0.),0,0,
+                lamch <Real> ('S'),neig,&(D[0]),&(V[0]),m,&(isuppz[0]),
+                &(work[0]),work.size(),&(iwork[0]),iwork.size(),info);
+            gemv <Real> ('T',m,m,Real(1.),&(V[0]),m,&(g[0]),1,Real(0.),
+                &(g_eig[0]),1);
+        }
+
+        // Factors H + lambda I = R' R and solves R' R d = -g.  Returns false
+        // if H + lambda I isn't positive definite.
+        bool factor(
+            Real const & lambda,
+            std::vector <Real> & R,
+            Real * d,
+            Real & norm_d
+        ) const {
+            R = H;
+            for(Natural i=1;i<=m;i++)
+                R[ijtok(i,i,m)]+=lambda;
+            Integer info(0);
+            potrf <Real> ('U',m,&(R[0]),m,info);
+            if(info!=0) return false;
+            copy <Real> (m,&(g[0]),1,d,1);
+            scal <Real> (m,Real(-1.),d,1);
+            trsv <Real> ('U','T','N',m,&(R[0]),m,d,1);
+            trsv <Real> ('U','N','N',m,&(R[0]),m,d,1);
+            norm_d = std::sqrt(dot <Real> (m,d,1,d,1));
+            return true;
+        }
+
+    public:
+        // Factor H.  Only the upper triangle of H is referenced.
+        MoreSorensen(
+            Natural const & m_,
+            Real const * const H_,
+            Real const * const g_
+        ) : m(m_), H(H_,H_+m_*m_), g(g_,g_+m_),
+            norm_g(std::sqrt(dot <Real> (m_,g_,1,g_,1))), newton(false),
+            U(), d_newton(m_), norm_newton(0.), V(), D(), g_eig()
+        {
+            // Try a Cholesky factorization, H = U' U, and, if it works, find
+            // the Newton step
+            newton = factor(Real(0.),U,&(d_newton[0]),norm_newton);
+        }
+
+        // Solves the subproblem with the trust-region radius delta.  We stop
+        // iterating on the secular equation once || d || is within a
+        // relative distance tol of delta or after iter_max iterations.
+        //
+        // (input) delta : Trust-region radius
+        // (input) tol : Relative tolerance on the norm of the step
+        // (input) iter_max : Maximum number of iterations on lambda
+        // (output) d : Solution
+        // (output) lambda : Multiplier on the trust-region constraint
+        // (output) boundary : Whether the solution lies on the boundary
+        // (return) Number of iterations, which counts the factorization
+        Natural solve(
+            Real const & delta,
+            Real const & tol,
+            Natural const & iter_max,
+            Real * d,
+            Real & lambda,
+            bool & boundary
+        ) {
+            // If the Newton step lies inside the trust-region, we're done
+            if(newton && norm_newton <= delta) {
+                copy <Real> (m,&(d_newton[0]),1,d,1);
+                lambda = Real(0.);
+                boundary = false;
+                return 1;
+            }
+
+            // When H is positive definite and we haven't already found its
+            // eigenvalue decomposition, we iterate from lambda=0, where
+            // || d || > delta.  Newton's method increases lambda
+            // monotonically toward the root from here, so H + lambda I
+            // remains positive definite.  Each iteration uses
+            //
+            // d || d ||^2 / d lambda = -2 || inv(U') d ||^2.
+            if(newton && D.size()==0) {
+                std::vector <Real> R(U);
+                std::vector <Real> q(m);
+                copy <Real> (m,&(d_newton[0]),1,d,1);
+                Real phi = norm_newton;
+                lambda = Real(0.);
+                Natural iter(1);
+                bool pd(true);
+                while(pd && iter<iter_max) {
+                    iter++;
+
+                    // q <- inv(R') d
+                    copy <Real> (m,d,1,&(q[0]),1);
+                    trsv <Real> ('U','T','N',m,&(R[0]),m,&(q[0]),1);
+                    Real const norm_q2 = dot <Real> (m,&(q[0]),1,&(q[0]),1);
+
+                    // Take the Newton step and refactor
+                    lambda += (phi*phi/norm_q2)*(phi-delta)/delta;
+                    pd = factor(lambda,R,d,phi);
+                    if(pd && std::fabs(phi-delta) <= tol*delta)
+                        break;
+                }
+
+                // Make sure that the step lies inside the trust-region.  If
+                // rounding error made H + lambda I indefinite, we fall back
+                // to the eigenvalue decomposition below.
+                if(pd) {
+                    if(phi > delta)
+                        scal <Real> (m,delta/phi,d,1);
+                    boundary = true;
+                    return iter;
+                }
+            }
+
+            // Otherwise, work in the eigenvector basis
+            eig();
+
+            // Eigenvalues within eps_D of the smallest one are considered
+            // equal to it.  This matters in the hard case, where g has no
+            // component in the corresponding eigenspace.
+            Real const eps = std::numeric_limits <Real>::epsilon();
+            Real const eps_D = Real(m)*eps*std::max(std::fabs(D[0]),
+                std::fabs(D[m-1]));
+            Real const lambda_L = std::max(Real(0.),-D[0]);
+
+            // Norm of the step at lambda_L restricted to the remaining
+            // eigenvectors and the size of g in the leftmost eigenspace
+            Real phi_L(0.);
+            Real g_L(0.);
+            Natural nleft(0);
+            for(Natural i=0;i<m;i++)
+                if(D[i]+lambda_L <= eps_D) {
+                    g_L += g_eig[i]*g_eig[i];
+                    nleft++;
+                } else
+                    phi_L += sq(g_eig[i]/(D[i]+lambda_L));
+            phi_L = std::sqrt(phi_L);
+            g_L = std::sqrt(g_L);
+
+            // Interior solution when H is positive semidefinite and the step
+            // with lambda=0 is small enough
+            Natural iter(1);
+            if(nleft==0 && phi_L <= delta) {
+                lambda = Real(0.);
+                boundary = false;
+
+            // The hard case.  The step at lambda_L lies inside the
+            // trust-region and g has no component in the leftmost eigenspace,
+            // so we move to the boundary along the leftmost eigenvector.
+            } else if(nleft > 0 && g_L <= std::sqrt(eps)*norm_g
+                && phi_L <= delta
+            ) {
+                lambda = lambda_L;
+                boundary = true;
+                std::vector <Real> d_eig(m,Real(0.));
+                for(Natural i=nleft;i<m;i++)
+                    d_eig[i] = -g_eig[i]/(D[i]+lambda);
+                d_eig[0] = std::sqrt(delta*delta-phi_L*phi_L);
+                gemv <Real> ('N',m,m,Real(1.),&(V[0]),m,&(d_eig[0]),1,
+                    Real(0.),d,1);
+                return iter;
+
+            // Otherwise, find lambda > lambda_L with || d(lambda) || = delta
+            // using Newton's method on the secular equation safeguarded by
+            // bisection.  Since || d(lambda) || <= || g || / (D[0]+lambda),
+            // the root lies below lambda_L + || g || / delta.
+            } else {
+                Real lo = lambda_L;
+                Real hi = lambda_L + norm_g/delta;
+                lambda = nleft==0 ? lambda_L : lo + std::sqrt(eps)*(hi-lo);
+                for(boundary=true;iter<=iter_max;iter++) {
+                    // phi <- || d(lambda) ||^2, q <- || L^{-1} d(lambda) ||^2
+                    // where H + lambda I = L L'
+                    Real phi(0.);
+                    Real q(0.);
+                    bool defined(true);
+                    for(Natural i=0;i<m;i++) {
+                        Real const D_lambda = D[i]+lambda;
+                        if(D_lambda <= Real(0.)) {
+                            defined = false;
+                            break;
+                        }
+                        Real const d_i = g_eig[i]/D_lambda;
+                        phi += d_i*d_i;
+                        q += d_i*d_i/D_lambda;
+                    }
+                    phi = std::sqrt(phi);
+
+                    // Check for convergence and update the bracket
+                    if(defined && std::fabs(phi-delta) <= tol*delta)
+                        break;
+                    if(!defined || phi > delta)
+                        lo = lambda;
+                    else
+                        hi = lambda;
+
+                    // Take a Newton step and bisect if it leaves the bracket
+                    Real lambda_new = defined ?
+                        lambda + (phi*phi/q)*(phi-delta)/delta :
+                        std::numeric_limits <Real>::quiet_NaN();
+                    lambda = lambda_new > lo && lambda_new < hi ?
+                        lambda_new : (lo+hi)/Real(2.);
+                    if(hi-lo <= eps*hi) break;
+                }
+                iter = std::min(iter,iter_max);
+            }
+
+            // Form the step, d = - V (D + lambda I)^{-1} V' g, and make sure
+            // that it doesn't leave the trust-region
+            std::vector <Real> d_eig(m,Real(0.));
+            for(Natural i=0;i<m;i++)
+                if(D[i]+lambda > Real(0.))
+                    d_eig[i] = -g_eig[i]/(D[i]+lambda);
+            gemv <Real> ('N',m,m,Real(1.),&(V[0]),m,&(d_eig[0]),1,Real(0.),
+                d,1);
+            Real const norm_d = std::sqrt(dot <Real> (m,d,1,d,1));
+            if(norm_d > delta)
+                scal <Real> (m,delta/norm_d,d,1);
+            return iter;
+        }
+    };
+
     // Solves a quadratic equation
     //
     // a x^2 + b x + c = 0
@@ -1113,6 +1439,168 @@ namespace Optizelle {
         bool is_valid(std::string const & name);
     }
 
+    // Precision used for the iterations inside of the Krylov methods
+    namespace KrylovPrecision{
+        enum t{
+            //---KrylovPrecision0---
+            Full,                     // Iterate in the working precision
+            Mixed,                    // Iterate in a lower precision and
+                                      // refine the solution in the working
+                                      // precision
+            Compressed                // Iterate in the working precision,
+                                      // but store the GMRES Krylov vectors
+                                      // in a lower precision
+            //---KrylovPrecision1---
+        };
+
+        // Converts the Krylov precision to a string
+        std::string to_string(t const & krylov_precision);
+
+        // Converts a string to a Krylov precision
+        t from_string(std::string const & krylov_precision);
+
+        // Checks whether or not a string is valid
+        bool is_valid(std::string const & name);
+    }
+
+    // Spare vectors that we hand out as workspace.  Algorithms that we run
+    // over and over, such as the Krylov methods inside of an optimization
+    // loop, borrow their work vectors from a pool that outlives them.  Once
+    // the pool grows to the largest number of vectors that we need at once,
+    // we stop allocating memory.  All of the vectors in a pool must have the
+    // same shape.
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    struct VectorPool {
+        // Create some type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector X_Vector;
+
+        // Disallow constructors
+        NO_COPY_ASSIGNMENT(VectorPool)
+
+        // Vectors that nobody is using
+        std::list <X_Vector> spare;
+
+        // Start with an empty pool
+        VectorPool() : spare() {}
+
+        // Makes sure that we have at least n spare vectors shaped like x
+        void reserve(X_Vector const & x,Natural const & n) {
+            while(spare.size() < n)
+                spare.emplace_back(std::move(X::init(x)));
+        }
+
+        // Moves a vector shaped like x to the end of vs.  We only allocate
+        // memory when we run out of spare vectors.
+        void take(X_Vector const & x,std::list <X_Vector> & vs) {
+            if(spare.empty())
+                vs.emplace_back(std::move(X::init(x)));
+            else
+                vs.splice(vs.end(),spare,spare.begin());
+        }
+
+        // Returns the first vector in vs to the pool
+        void give_front(std::list <X_Vector> & vs) {
+            spare.splice(spare.end(),vs,vs.begin());
+        }
+
+        // Returns the last vector in vs to the pool
+        void give_back(std::list <X_Vector> & vs) {
+            spare.splice(spare.end(),vs,--vs.end());
+        }
+
+        // Returns all of the vectors in vs to the pool
+        void give(std::list <X_Vector> & vs) {
+            spare.splice(spare.end(),vs);
+        }
+    };
+
+    // Work vectors that we borrow from a pool and return when we go out of
+    // scope
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    struct VectorLease {
+        // Create some type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector X_Vector;
+
+        // Disallow constructors
+        NO_DEFAULT_COPY_ASSIGNMENT(VectorLease)
+
+        // Where we borrow the vectors
+        VectorPool <Real,XX> & pool;
+
+        // Vectors that we borrow one at a time
+        std::list <X_Vector> vs;
+
+        // Lists of vectors that we fill with pool.take
+        std::list <std::list <X_Vector> > lists;
+
+        // Start without any vectors
+        explicit VectorLease(VectorPool <Real,XX> & pool_) :
+            pool(pool_), vs(), lists()
+        {}
+
+        // Return everything to the pool
+        ~VectorLease() {
+            pool.give(vs);
+            for(typename std::list <std::list <X_Vector> >::iterator
+                    l=lists.begin();
+                l!=lists.end();
+                l++
+            )
+                pool.give(*l);
+        }
+
+        // Borrows a vector shaped like x
+        X_Vector & take(X_Vector const & x) {
+            pool.take(x,vs);
+            return vs.back();
+        }
+
+        // Creates an empty list of vectors that we return with the rest
+        std::list <X_Vector> & list() {
+            lists.emplace_back();
+            return lists.back();
+        }
+    };
+
+    // A function that we call at the end of each iteration of a Krylov method
+    // with the number of iterations so far and the norm of the residual
+    // relative to the norm of the initial residual
+    template <typename Real>
+    struct KrylovManipulator {
+        // Disallow constructors
+        NO_COPY_ASSIGNMENT(KrylovManipulator)
+
+        // Give an empty default constructor
+        KrylovManipulator() {}
+
+        // Application
+        virtual void eval(Natural const & iter,Real const & rel_err) const = 0;
+
+        // Allow the derived class to deallocate memory
+        virtual ~KrylovManipulator() {}
+    };
+
+    // An empty manipulator that does nothing
+    template <typename Real>
+    struct EmptyKrylovManipulator : public KrylovManipulator <Real> {
+        // Disallow constructors
+        NO_COPY_ASSIGNMENT(EmptyKrylovManipulator)
+
+        // Give an empty default constructor
+        EmptyKrylovManipulator() {}
+
+        // Application
+        void eval(Natural const & iter,Real const & rel_err) const {}
+    };
+
     // A orthogonalizes a vector Bx to a list of other Bxs.  
     template <
         typename Real,
@@ -1141,28 +1629,9 @@ namespace Optizelle {
         }
     }
 
-    // Computes the truncated projected conjugate direction algorithm in order
-    // to solve Ax=b where we restrict x to be in the range of B and that
-    // || C (x - x_cntr) || <= delta.  The parameters are as follows.
-    // 
-    // (input) A : Operator in the system A B x = b.
-    // (input) b : Right hand side in the system A B x = b.
-    // (input) B : Projection in the system A B x = b.
-    // (input) C : Operator that modifies the shape of the trust-region.
-    // (input) eps : Stopping tolerance.
-    // (input) iter_max :  Maximum number of iterations.
-    // (input) orthog_max : Maximum number of orthgonalizations.  If this
-    //     number is 1, then we do the conjugate gradient algorithm.
-    // (input) delta : Trust region radius.  If this number is infinity, we
-    //     do not scale the final step if we detect negative curvature.
-    // (input) x_cntr : Center of the trust-region. 
-    // (input) do_orthog_check : Orthogonality check for projected algorithms 
-    // (output) x : Final solution x.
-    // (output) x_cp : The Cauchy-Point, which is defined as the solution x
-    //     after a single iteration.
-    // (output) norm_Br : The norm ||B r|| of the final residual.
-    // (output) iter : The number of iterations required to converge. 
-    // (output) krylov_stop : The reason why the Krylov method was terminated.
+    // Computes the truncated projected conjugate direction algorithm, calls
+    // kmanip at the end of each iteration, and borrows the work vectors from
+    // pool.  Otherwise, the arguments and results are the same as below.
     template <
         typename Real,
         template <typename> class XX
@@ -1183,9 +1652,14 @@ namespace Optizelle {
         Real & norm_Br0,
         Real & norm_Br,
         Natural & iter,
-        KrylovStop::t & krylov_stop
+        KrylovStop::t & krylov_stop,
+        KrylovManipulator <Real> const & kmanip,
+        VectorPool <Real,XX> & pool
     ){
 
+        // Record the time that we spend in the solve
+        OPTIZELLE_TRACE(trace,"truncated_cd","krylov")
+
         // Create some type shortcuts
         typedef XX <Real> X;
         typedef typename X::Vector X_Vector;
@@ -1193,18 +1667,21 @@ namespace Optizelle {
         // Set the tolerance for our orthogonality check
         const Real eps_orthog(0.5);
 
+        // Borrow our work vectors from the pool
+        VectorLease <Real,XX> work(pool);
+
         // Allocate memory for the projected search direction and the
         // the operator applied to the projection
-        X_Vector Bp(X::init(x));
-        X_Vector ABp(X::init(x));
+        X_Vector & Bp(work.take(x));
+        X_Vector & ABp(work.take(x));
 
         // Allocate memory for the previous search directions
-        std::list <X_Vector> Bps;
-        std::list <X_Vector> ABps;
+        std::list <X_Vector> & Bps(work.list());
+        std::list <X_Vector> & ABps(work.list());
         
         // Allocate memory for the residuals and projected residuals 
-        std::list <X_Vector> rs;
-        std::list <X_Vector> Brs;
+        std::list <X_Vector> & rs(work.list());
+        std::list <X_Vector> & Brs(work.list());
         std::list <Real> norm_Brs;
 
         // Allocate memory for the orthogonality check matrix.  This is
@@ -1233,8 +1710,8 @@ namespace Optizelle {
 
         // Allocate memory for and find the initial residual, A*x-b = -b.
         // Also, allocate memory for the projected residual.
-        X_Vector r(X::init(x));
-        X_Vector Br(X::init(x));
+        X_Vector & r(work.take(x));
+        X_Vector & Br(work.take(x));
         X::copy(b,r);
         X::scal(Real(-1.),r);
 
@@ -1245,11 +1722,11 @@ namespace Optizelle {
         // norm implicitely, which involves additional inner products and adding
         // the results together.  This can have some numerical difficulties,
         // so we just sacrifice the additional memory.
-        X_Vector x_tmp1(X::init(x));
-        X_Vector x_tmp2(X::init(x));
+        X_Vector & x_tmp1(work.take(x));
+        X_Vector & x_tmp2(work.take(x));
 
         // Allocate memory for the quantity x-x_cntr
-        X_Vector x_m_xcntr(X::init(x));
+        X_Vector & x_m_xcntr(work.take(x));
         X::copy(x_cntr,x_m_xcntr);
         X::scal(Real(-1.),x_m_xcntr);
 
@@ -1313,10 +1790,10 @@ namespace Optizelle {
                 // Check if we need to eliminate any vectors for
                 // orthogonalization.
                 if(Bps.size()==orthog_max) {
-                    Bps.pop_front();
-                    ABps.pop_front();
-                    rs.pop_front();
-                    Brs.pop_front();
+                    pool.give_front(Bps);
+                    pool.give_front(ABps);
+                    pool.give_front(rs);
+                    pool.give_front(Brs);
                     norm_Brs.pop_front();
 
                     // Don't remove elements from the orthogonality check 
@@ -1338,19 +1815,19 @@ namespace Optizelle {
                 }
 
                 // Store the previous directions
-                Bps.emplace_back(std::move(X::init(x)));
+                pool.take(x,Bps);
                 X::copy(Bp,Bps.back());
                 X::scal(Real(1.)/Anorm_Bp,Bps.back());
                 
-                ABps.emplace_back(std::move(X::init(x)));
+                pool.take(x,ABps);
                 X::copy(ABp,ABps.back());
                 X::scal(Real(1.)/Anorm_Bp,ABps.back());
 
                 // Store the previous residuals
-                rs.emplace_back(std::move(X::init(x)));
+                pool.take(x,rs);
                 X::copy(r,rs.back());
 
-                Brs.emplace_back(std::move(X::init(x)));
+                pool.take(x,Brs);
                 X::copy(Br,Brs.back());
 
                 norm_Brs.emplace_back(norm_Br);
@@ -1501,6 +1978,8 @@ namespace Optizelle {
  
                 // If this is the first iteration, save the Cauchy-Point
                 if(iter==1) X::copy(x,x_cp);
+                kmanip.eval(iter,norm_Br
+                    / (std::numeric_limits <Real>::epsilon()+norm_Br0));
                 break;
             }
 
@@ -1522,6 +2001,10 @@ namespace Optizelle {
             // Find the projected steepest descent direction
             X::copy(Br,Bp);
             X::scal(Real(-1.),Bp);	
+
+            // Manipulate the Krylov iteration if required
+            kmanip.eval(iter,norm_Br
+                / (std::numeric_limits <Real>::epsilon()+norm_Br0));
         }
 
         // If we've exceeded the maximum iteration, make sure to denote this
@@ -1532,6 +2015,56 @@ namespace Optizelle {
         iter = iter > iter_max ? iter_max : iter;
     }
 
+    // Computes the truncated projected conjugate direction algorithm in order
+    // to solve Ax=b where we restrict x to be in the range of B and that
+    // || C (x - x_cntr) || <= delta.  The parameters are as follows.
+    // 
+    // (input) A : Operator in the system A B x = b.
+    // (input) b : Right hand side in the system A B x = b.
+    // (input) B : Projection in the system A B x = b.
+    // (input) C : Operator that modifies the shape of the trust-region.
+    // (input) eps : Stopping tolerance.
+    // (input) iter_max :  Maximum number of iterations.
+    // (input) orthog_max : Maximum number of orthgonalizations.  If this
+    //     number is 1, then we do the conjugate gradient algorithm.
+    // (input) delta : Trust region radius.  If this number is infinity, we
+    //     do not scale the final step if we detect negative curvature.
+    // (input) x_cntr : Center of the trust-region. 
+    // (input) do_orthog_check : Orthogonality check for projected algorithms 
+    // (output) x : Final solution x.
+    // (output) x_cp : The Cauchy-Point, which is defined as the solution x
+    //     after a single iteration.
+    // (output) norm_Br : The norm ||B r|| of the final residual.
+    // (output) iter : The number of iterations required to converge. 
+    // (output) krylov_stop : The reason why the Krylov method was terminated.
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    void truncated_cd(
+        Operator <Real,XX,XX> const & A,
+        typename XX <Real>::Vector const & b,
+        Operator <Real,XX,XX> const & B,
+        Operator <Real,XX,XX> const & C,
+        Real const & eps,
+        Natural const & iter_max,
+        Natural const & orthog_max,
+        Real const & delta,
+        typename XX <Real>::Vector const & x_cntr,
+        bool const & do_orthog_check,
+        typename XX <Real>::Vector & x,
+        typename XX <Real>::Vector & x_cp,
+        Real & norm_Br0,
+        Real & norm_Br,
+        Natural & iter,
+        KrylovStop::t & krylov_stop
+    ){
+        VectorPool <Real,XX> pool;
+        truncated_cd <Real,XX> (A,b,B,C,eps,iter_max,orthog_max,delta,x_cntr,
+            do_orthog_check,x,x_cp,norm_Br0,norm_Br,iter,krylov_stop,
+            EmptyKrylovManipulator <Real> (),pool);
+    }
+
     // Solve a 2x2 linear system in packed storage.  This is done through
     // Gaussian elimination with complete pivoting.  In addition, this assumes
     // that the system is nonsingular.
@@ -1695,91 +2228,417 @@ namespace Optizelle {
         }
     }
 
-    // Orthogonalizes a vector x to a list of other xs.  
+    // Lower precision used for the inner iterations of the mixed-precision
+    // Krylov methods.  By default, there is no lower precision.
+    template <typename Real>
+    struct ShadowPrecision {
+        typedef Real t;
+    };
+    template <>
+    struct ShadowPrecision <double> {
+        typedef float t;
+    };
+
+    // Determines whether the vector space XX can convert its vectors to the
+    // lower precision.  This requires the vector space to provide the
+    // functions
+    //
+    // // Memory allocation and size setting in the precision Real2
+    // template <typename Real2>
+    // static typename XX <Real2>::Vector init_prec(Vector const & x);
+    //
+    // // y <- x where y is stored in the precision Real2
+    // template <typename Real2>
+    // static void copy_prec(Vector const & x,typename XX <Real2>::Vector & y);
+    template <typename Real,template <typename> class XX>
+    struct HasPrecisionConversion {
+    private:
+        typedef typename ShadowPrecision <Real>::t Shadow;
+        template <typename X>
+        static std::true_type test(decltype(&X::template copy_prec <Shadow>));
+        template <typename X>
+        static std::false_type test(...);
+    public:
+        static bool const value = !std::is_same <Real,Shadow>::value &&
+            decltype(test <XX <Real> > (nullptr))::value;
+    };
+
+    // Determines whether the vector space XX can store Krylov vectors in the
+    // lower precision and work with them there.  In addition to the
+    // conversions above, this requires the fused functions
+    //
+    // // innr <- <x,y> where x is stored in the precision Real2
+    // template <typename Real2>
+    // static Real innr_prec(typename XX <Real2>::Vector const & x,
+    //     Vector const & y);
+    //
+    // // y <- alpha * x + y where x is stored in the precision Real2
+    // template <typename Real2>
+    // static void axpy_prec(Real const & alpha,
+    //     typename XX <Real2>::Vector const & x, Vector & y);
+    template <typename Real,template <typename> class XX>
+    struct HasCompressedStorage {
+    private:
+        typedef typename ShadowPrecision <Real>::t Shadow;
+        template <typename X>
+        static std::true_type test(
+            decltype(&X::template innr_prec <Shadow>),
+            decltype(&X::template axpy_prec <Shadow>));
+        template <typename X>
+        static std::false_type test(...);
+    public:
+        static bool const value = HasPrecisionConversion <Real,XX>::value &&
+            decltype(test <XX <Real> > (nullptr,nullptr))::value;
+    };
+
+    // List of vectors stored in the lower precision.  This is the fallback
+    // for when the vector space can't convert between precisions.  Here, the
+    // list always stays empty and the caller keeps its vectors in the working
+    // precision.
     template <
         typename Real,
-        template <typename> class XX
+        template <typename> class XX,
+        bool available_ = HasPrecisionConversion <Real,XX>::value
     >
-    void orthogonalize(
-        std::list <typename XX <Real>::Vector> const & vs,
-        typename XX <Real>::Vector & x,
-        Real * R
-    ) {
+    struct CompressedList {
         // Create some type shortcuts
         typedef XX <Real> X;
         typedef typename X::Vector X_Vector;
 
-        // Orthogonalize the vectors
-        Natural i=0;
-        for(typename std::list <X_Vector>::const_iterator v=vs.begin();
-            v!=vs.end();
-            v++
-        ) {
-            Real beta=X::innr(*v,x);
-            X::axpy(Real(-1.)*beta,*v,x);
-            R[i] = beta;
-            i++;
+        // Determines whether we can store vectors in the lower precision
+        static bool const available = false;
+
+        // Number of vectors
+        Natural size() const {
+            return 0;
         }
-    }
 
-    // Solves for the linear solve iterate update dx in the current Krylov space
+        // Removes all of the vectors
+        void clear() {}
+
+        // We never store anything, so there's nothing to add or remove
+        void push_front(X_Vector const & x) {}
+        void push_back(X_Vector const & x) {}
+        void pop_back() {}
+
+        // x <- the ith vector in the working precision
+        void expand(Natural const & i,X_Vector & x) const {}
+    };
+
+    // List of vectors stored in the lower precision.  Each vector takes half
+    // of the memory, but we must expand it into the working precision before
+    // we use it.
     template <
         typename Real,
         template <typename> class XX
     >
-    void solveInKrylov(
-        Natural const & m,
-        Real const * const R,
-        Real const * const Qt_e1,
-        std::list <typename XX <Real>::Vector> const & vs,
-        Operator <Real,XX,XX> const & Mr_inv,
-        typename XX <Real>::Vector const & x,
-        typename XX <Real>::Vector & dx
-    ) {
+    struct CompressedList <Real,XX,true> {
         // Create some type shortcuts
         typedef XX <Real> X;
         typedef typename X::Vector X_Vector;
-        
-        // Allocate memory for the solution of the triangular solve 
-        std::vector <Real> y(m);
+        typedef typename ShadowPrecision <Real>::t Shadow;
+        typedef XX <Shadow> XS;
+        typedef typename XS::Vector XS_Vector;
 
-        // Create one temporary element required to solve for the iterate
-        X_Vector V_y(X::init(x));
+        // Determines whether we can store vectors in the lower precision
+        static bool const available = true;
 
-        // Solve the system for y
-        copy <Real> (m,&(Qt_e1[0]),1,&(y[0]),1);
-        tpsv <Real> ('U','N','N',m,&(R[0]),&(y[0]),1);
+        // Vectors in the lower precision
+        std::deque <XS_Vector> vs;
 
-#if 0
-        // Check the condition number on R.  If it's large, something
-        // wrong has occured and we need to bail.
-        Integer info(0);
-        Real rcond(0.);
-        std::vector <Real> work(3*m);
-        std::vector <Integer> iwork(m);
-        tpcon('I','U','N',m,&(R[0]),rcond,&(work[0]),&(iwork[0]),info);
-        if(rcond < std::numeric_limits <Real>::epsilon()*1e3)
-            return false;
-#endif
+        // Start with an empty list
+        CompressedList() : vs() {}
 
-        // Compute tmp = V y
-        X::zero(V_y);
-        typename std::list <X_Vector>::const_iterator vv=vs.begin();
-        for(Natural j=0;j<m;j++) {
-            X::axpy(Real(y[j]),*vv,V_y);
-            vv++;
+        // Number of vectors
+        Natural size() const {
+            return vs.size();
         }
 
-        // Right recondition the above linear combination
-        Mr_inv.eval(V_y,dx);
-    }
+        // Removes all of the vectors
+        void clear() {
+            vs.clear();
+        }
 
-    // Resets the GMRES method.  This does a number of things
-    // 1.  Calculates the preconditioned residual.
-    // 2.  Finds the norm of the preconditioned residual.
-    // 3.  Finds the initial Krylov vector.
-    // 4.  Initializes the list of Krylov vectors.
-    // 5.  Finds the initial RHS for the least squares system, Q' norm(w1) e1.
+        // Adds x rounded to the lower precision to the front of the list
+        void push_front(X_Vector const & x) {
+            vs.emplace_front(std::move(X::template init_prec <Shadow> (x)));
+            X::template copy_prec <Shadow> (x,vs.front());
+        }
+
+        // Adds x rounded to the lower precision to the end of the list
+        void push_back(X_Vector const & x) {
+            vs.emplace_back(std::move(X::template init_prec <Shadow> (x)));
+            X::template copy_prec <Shadow> (x,vs.back());
+        }
+
+        // Removes the last vector
+        void pop_back() {
+            vs.pop_back();
+        }
+
+        // x <- the ith vector in the working precision
+        void expand(Natural const & i,X_Vector & x) const {
+            XS::template copy_prec <Real> (vs[i],x);
+        }
+    };
+
+    // List of Krylov vectors.  This is the fallback for when the vector
+    // space can't store its vectors in the lower precision, where we always
+    // store them in the working precision.
+    template <
+        typename Real,
+        template <typename> class XX,
+        bool available = HasCompressedStorage <Real,XX>::value
+    >
+    struct KrylovBasis {
+        // Create some type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector X_Vector;
+
+        // Disallow constructors
+        NO_COPY_ASSIGNMENT(KrylovBasis)
+
+        // Krylov vectors
+        std::list <X_Vector> vs;
+
+        // Start with an empty list
+        KrylovBasis() : vs() {}
+
+        // Sets whether we store the vectors in the lower precision
+        void compress(bool const & compressed_) {}
+
+        // Determines whether we store the vectors in the lower precision
+        bool compressed() const {
+            return false;
+        }
+
+        // Number of Krylov vectors
+        Natural size() const {
+            return vs.size();
+        }
+
+        // Removes all of the Krylov vectors
+        void clear() {
+            vs.clear();
+        }
+
+        // Adds a copy of v to the end of the list
+        void push_back(X_Vector const & v) {
+            vs.emplace_back(std::move(X::init(v)));
+            X::copy(v,vs.back());
+        }
+
+        // Orthogonalizes x to the Krylov vectors and stores the
+        // coefficients in R
+        void orthogonalize(X_Vector & x,Real * R) const {
+            Natural i=0;
+            for(typename std::list <X_Vector>::const_iterator v=vs.begin();
+                v!=vs.end();
+                v++
+            ) {
+                Real beta=X::innr(*v,x);
+                X::axpy(Real(-1.)*beta,*v,x);
+                R[i] = beta;
+                i++;
+            }
+        }
+
+        // V_y <- V_y + V y where V holds the first m Krylov vectors
+        void combine(Natural const & m,Real const * const y,X_Vector & V_y)
+            const
+        {
+            typename std::list <X_Vector>::const_iterator vv=vs.begin();
+            for(Natural j=0;j<m;j++) {
+                X::axpy(Real(y[j]),*vv,V_y);
+                vv++;
+            }
+        }
+    };
+
+    // List of Krylov vectors when the vector space can store them in the
+    // lower precision.  Once compressed, we round each new vector to the
+    // lower precision and the vector space combines the stored vectors with
+    // vectors in the working precision without expanding them first.  This
+    // halves the memory for the basis at the cost of orthogonality on the
+    // order of the lower precision's unit roundoff.
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    struct KrylovBasis <Real,XX,true> {
+        // Create some type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector X_Vector;
+        typedef typename ShadowPrecision <Real>::t Shadow;
+        typedef typename XX <Shadow>::Vector XS_Vector;
+
+        // Disallow constructors
+        NO_COPY_ASSIGNMENT(KrylovBasis)
+
+        // Krylov vectors in the working precision
+        std::list <X_Vector> vs;
+
+        // Krylov vectors in the lower precision
+        std::list <XS_Vector> vs_s;
+
+        // Whether we store new vectors in the lower precision
+        bool compressed_;
+
+        // Start with an empty list
+        KrylovBasis() : vs(), vs_s(), compressed_(false) {}
+
+        // Sets whether we store the vectors in the lower precision.  This
+        // only changes where we put vectors after the list is cleared.
+        void compress(bool const & compressed) {
+            if(vs.empty() && vs_s.empty())
+                compressed_ = compressed;
+        }
+
+        // Determines whether we store the vectors in the lower precision
+        bool compressed() const {
+            return compressed_;
+        }
+
+        // Number of Krylov vectors
+        Natural size() const {
+            return compressed_ ? vs_s.size() : vs.size();
+        }
+
+        // Removes all of the Krylov vectors
+        void clear() {
+            vs.clear();
+            vs_s.clear();
+        }
+
+        // Adds a copy of v to the end of the list
+        void push_back(X_Vector const & v) {
+            if(compressed_) {
+                vs_s.emplace_back(std::move(
+                    X::template init_prec <Shadow> (v)));
+                X::template copy_prec <Shadow> (v,vs_s.back());
+            } else {
+                vs.emplace_back(std::move(X::init(v)));
+                X::copy(v,vs.back());
+            }
+        }
+
+        // Orthogonalizes x to the Krylov vectors and stores the
+        // coefficients in R
+        void orthogonalize(X_Vector & x,Real * R) const {
+            if(!compressed_) {
+                Natural i=0;
+                for(typename std::list <X_Vector>::const_iterator
+                        v=vs.begin();
+                    v!=vs.end();
+                    v++
+                ) {
+                    Real beta=X::innr(*v,x);
+                    X::axpy(Real(-1.)*beta,*v,x);
+                    R[i] = beta;
+                    i++;
+                }
+                return;
+            }
+            Natural i=0;
+            for(typename std::list <XS_Vector>::const_iterator
+                    v=vs_s.begin();
+                v!=vs_s.end();
+                v++
+            ) {
+                Real beta=X::template innr_prec <Shadow> (*v,x);
+                X::template axpy_prec <Shadow> (Real(-1.)*beta,*v,x);
+                R[i] = beta;
+                i++;
+            }
+        }
+
+        // V_y <- V_y + V y where V holds the first m Krylov vectors
+        void combine(Natural const & m,Real const * const y,X_Vector & V_y)
+            const
+        {
+            if(!compressed_) {
+                typename std::list <X_Vector>::const_iterator vv=vs.begin();
+                for(Natural j=0;j<m;j++) {
+                    X::axpy(Real(y[j]),*vv,V_y);
+                    vv++;
+                }
+                return;
+            }
+            typename std::list <XS_Vector>::const_iterator vv=vs_s.begin();
+            for(Natural j=0;j<m;j++) {
+                X::template axpy_prec <Shadow> (Real(y[j]),*vv,V_y);
+                vv++;
+            }
+        }
+    };
+
+    // Orthogonalizes a vector x to a list of other xs.  
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    void orthogonalize(
+        KrylovBasis <Real,XX> const & vs,
+        typename XX <Real>::Vector & x,
+        Real * R
+    ) {
+        vs.orthogonalize(x,R);
+    }
+
+    // Solves for the linear solve iterate update dx in the current Krylov space
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    void solveInKrylov(
+        Natural const & m,
+        Real const * const R,
+        Real const * const Qt_e1,
+        KrylovBasis <Real,XX> const & vs,
+        Operator <Real,XX,XX> const & Mr_inv,
+        typename XX <Real>::Vector const & x,
+        typename XX <Real>::Vector & dx
+    ) {
+        // Create some type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector X_Vector;
+        
+        // Allocate memory for the solution of the triangular solve 
+        std::vector <Real> y(m);
+
+        // Create one temporary element required to solve for the iterate
+        X_Vector V_y(X::init(x));
+
+        // Solve the system for y
+        copy <Real> (m,&(Qt_e1[0]),1,&(y[0]),1);
+        tpsv <Real> ('U','N','N',m,&(R[0]),&(y[0]),1);
+
+#if 0
+        // Check the condition number on R.  If it's large, something
+        // wrong has occured and we need to bail.
+        Integer info(0);
+        Real rcond(0.);
+        std::vector <Real> work(3*m);
+        std::vector <Integer> iwork(m);
+        tpcon('I','U','N',m,&(R[0]),rcond,&(work[0]),&(iwork[0]),info);
+        if(rcond < std::numeric_limits <Real>::epsilon()*1e3)
+            return false;
+#endif
+
+        // Compute tmp = V y
+        X::zero(V_y);
+        vs.combine(m,&(y[0]),V_y);
+
+        // Right recondition the above linear combination
+        Mr_inv.eval(V_y,dx);
+    }
+
+    // Resets the GMRES method.  This does a number of things
+    // 1.  Calculates the preconditioned residual.
+    // 2.  Finds the norm of the preconditioned residual.
+    // 3.  Finds the initial Krylov vector.
+    // 4.  Initializes the list of Krylov vectors.
+    // 5.  Finds the initial RHS for the least squares system, Q' norm(w1) e1.
     // 6.  Clears out all of the old Givens rotations
     // These steps are required during initialization as well as during a
     // restart of GMRES
@@ -1792,7 +2651,7 @@ namespace Optizelle {
         Operator <Real,XX,XX> const & Ml_inv,
         Natural const & rst_freq,
         typename XX <Real>::Vector & v,
-        std::list <typename XX <Real>::Vector> & vs,
+        KrylovBasis <Real,XX> & vs,
         typename XX <Real>::Vector & r,
         Real & norm_r,
         std::vector <Real> & Qt_e1,
@@ -1815,8 +2674,7 @@ namespace Optizelle {
         // Clear memory for the list of Krylov vectors and insert the first
         // vector.  This completes #4.
         vs.clear();
-        vs.emplace_back(std::move(X::init(rtrue)));
-        X::copy(v,vs.back());
+        vs.push_back(v);
 
         // Find the initial right hand side for the vector Q' norm(w1) e1.  This
         // completes #5.
@@ -1873,21 +2731,99 @@ namespace Optizelle {
         ) const { } 
     };
 
-    // Computes the GMRES algorithm in order to solve A(x)=b.
-    // (input) A : Operator that computes A(x)
-    // (input) b : Right hand side
-    // (input) eps : Relative stopping tolerance.  We check the relative 
-    //    difference between the current and original preconditioned
-    //    norm of the residual.
-    // (input) iter_max : Maximum number of iterations
-    // (input) rst_freq : Restarts GMRES every rst_freq iterations.  If we don't
-    //    want restarting, set this to zero. 
-    // (input) Ml_inv : Operator that computes the left preconditioner
-    // (input) Mr_inv : Operator that computes the right preconditioner
-    // (input/output) x : Initial guess of the solution.  Returns the final
-    //    solution.
-    // (return) (norm_rtrue,iter) : Final norm of the true residual and
-    //    the number of iterations computed.  They are returned in a STL pair.
+    // Everything GMRES needs in order to continue a solve where it left off.
+    // If we solve the same system again, with the same operators and right
+    // hand side, but with a tighter tolerance, continuing from here gives
+    // exactly the iterates of a solve from scratch.  However, we skip the
+    // iterations that we've already computed.
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    struct GMRESState {
+        // Create some type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector X_Vector;
+
+        // Disallow constructors
+        NO_DEFAULT_COPY_ASSIGNMENT(GMRESState)
+
+        // Whether we've started a solve
+        bool started;
+
+        // Number of iterations computed so far
+        Natural iter;
+
+        // Subiteration number taking into account restarting
+        Natural i;
+
+        // Restart frequency after we adjust it for the maximum number of
+        // iterations
+        Natural rst_freq;
+
+        // Iterate at the last restart.  The current iterate is this plus the
+        // update that we find in the current Krylov space.
+        X_Vector x0;
+
+        // True residual at the current iterate and its norm
+        X_Vector rtrue;
+        Real norm_rtrue;
+
+        // Preconditioned residual and its norm
+        X_Vector r;
+        Real norm_r;
+
+        // Next normalized Krylov vector
+        X_Vector v;
+
+        // List of Krylov vectors
+        KrylovBasis <Real,XX> vs;
+
+        // R matrix in the QR factorization of H where A V = V H + e_m' w_m
+        std::vector <Real> R;
+
+        // Right hand side of the least squares problem, Q' norm(w1) e1
+        std::vector <Real> Qt_e1;
+
+        // Givens rotations
+        std::list <std::pair<Real,Real> > Qts;
+
+        // Allocate memory based on the shape of x
+        explicit GMRESState(X_Vector const & x) :
+            started(false),
+            iter(0),
+            i(0),
+            rst_freq(0),
+            x0(X::init(x)),
+            rtrue(X::init(x)),
+            norm_rtrue(0.),
+            r(X::init(x)),
+            norm_r(0.),
+            v(X::init(x)),
+            vs(),
+            R(),
+            Qt_e1(),
+            Qts()
+        {}
+
+        // Forget the previous solve
+        void reset() {
+            started=false;
+            iter=0;
+            i=0;
+            vs.clear();
+            Qts.clear();
+        }
+    };
+
+    // Computes the GMRES algorithm in order to solve A(x)=b and keeps what
+    // we need to continue the solve later in gstate.  If gstate holds a
+    // previous solve, we continue from there and ignore the initial guess.
+    // In this case, iter_max bounds the total number of iterations across
+    // all the calls and we return the number of iterations computed in this
+    // call.  At the end of each iteration, we call kmanip with the total
+    // number of iterations and the norm of the true residual relative to the
+    // norm of b.  Otherwise, the arguments and results are the same as below.
     template <
         typename Real,
         template <typename> class XX
@@ -1901,84 +2837,124 @@ namespace Optizelle {
         Operator <Real,XX,XX> const & Ml_inv,
         Operator <Real,XX,XX> const & Mr_inv,
         GMRESManipulator <Real,XX> const & gmanip,
-        typename XX <Real>::Vector & x
+        KrylovManipulator <Real> const & kmanip,
+        typename XX <Real>::Vector & x,
+        GMRESState <Real,XX> & gstate
     ){
 
+        // Record the time that we spend in the solve
+        OPTIZELLE_TRACE(trace,"gmres","krylov")
+
         // Create some type shortcuts
         typedef XX <Real> X;
         typedef typename X::Vector X_Vector;
 
-        // Adjust the restart frequency if it is too big
-        rst_freq = rst_freq > iter_max ? iter_max : rst_freq;
-
-        // Adjust the restart frequency if none is desired.
-        rst_freq = rst_freq == 0 ? iter_max : rst_freq;
+        // Create some shortcuts
+        X_Vector & x0 = gstate.x0;
+        X_Vector & r = gstate.r;
+        X_Vector & rtrue = gstate.rtrue;
+        X_Vector & v = gstate.v;
+        Real & norm_rtrue = gstate.norm_rtrue;
+        Real & norm_r = gstate.norm_r;
+        std::vector <Real> & R = gstate.R;
+        std::vector <Real> & Qt_e1 = gstate.Qt_e1;
+        KrylovBasis <Real,XX> & vs = gstate.vs;
+        std::list <std::pair<Real,Real> > & Qts = gstate.Qts;
+        Natural & i = gstate.i;
 
-        // Allocate memory for the residual
-        X_Vector r(X::init(x));
-        
         // Allocate memory for the iterate update 
         X_Vector dx(X::init(x));
         
         // Allocate memory for x + dx 
         X_Vector x_p_dx(X::init(x));
         
-        // Allocate memory for the true residual
-        X_Vector rtrue(X::init(x));
-        
-        // Allocate memory for the norm of the true, preconditioned, and
-        // original true norm of the residual
-        Real norm_rtrue;
-        Real norm_r;
-
-        // Allocate memory for the R matrix in the QR factorization of H where
-        // A V = V H + e_m' w_m
-        // Note, this size is restricted to be no larger than the restart
-        // frequency
-        std::vector <Real> R(rst_freq*(rst_freq+1)/2);
-
-        // Allocate memory for the normalized Krylov vector
-        X_Vector v(X::init(x));
-
         // Allocate memory for w, the orthogonalized, but not normalized vector
         X_Vector w(X::init(x));
 
-        // Allocate memory for the list of Krylov vectors
-        std::list <X_Vector> vs;
-
-        // Allocate memory for right hand side of the linear system, the vector
-        // Q' norm(w1) e1.  Since we have a problem overdetermined by a single
-        // index at each step, the size of this vector is the restart frequency
-        // plus 1.
-        std::vector <Real> Qt_e1(rst_freq+1);
-
-        // Allocoate memory for the Givens rotations
-        std::list <std::pair<Real,Real> > Qts;
-
         // Allocate a temporary work element
         X_Vector A_Mrinv_v(X::init(x));
 
-        // Allocate memory for the subiteration number of GMRES taking into
-        // account restarting
-        Natural i(0);
-
-        // Find the true residual and its norm
-        A.eval(x,rtrue);
-        X::scal(Real(-1.),rtrue);
-        X::axpy(Real(1.),b,rtrue);
-        norm_rtrue = sqrt(X::innr(rtrue,rtrue));
+        // Find the norm of the right hand side, which scales the residuals
+        // that we give to kmanip
+        Real const norm_b = sqrt(X::innr(b,b));
+
+        // Determine whether we're already done
+        bool done(false);
+
+        // Start a brand new solve
+        if(!gstate.started) {
+            // Adjust the restart frequency if it is too big
+            rst_freq = rst_freq > iter_max ? iter_max : rst_freq;
+
+            // Adjust the restart frequency if none is desired.
+            rst_freq = rst_freq == 0 ? iter_max : rst_freq;
+            gstate.rst_freq = rst_freq;
+
+            // Allocate memory for the R matrix in the QR factorization of H
+            // where A V = V H + e_m' w_m.  Note, this size is restricted to
+            // be no larger than the restart frequency
+            R.resize(rst_freq*(rst_freq+1)/2);
+
+            // Allocate memory for right hand side of the linear system, the
+            // vector Q' norm(w1) e1.  Since we have a problem overdetermined
+            // by a single index at each step, the size of this vector is the
+            // restart frequency plus 1.
+            Qt_e1.resize(rst_freq+1);
+
+            // Start from the initial guess
+            X::copy(x,x0);
+            gstate.iter = 0;
+            i = 0;
+            gstate.started = true;
+
+            // Find the true residual and its norm
+            A.eval(x0,rtrue);
+            X::scal(Real(-1.),rtrue);
+            X::axpy(Real(1.),b,rtrue);
+            norm_rtrue = sqrt(X::innr(rtrue,rtrue));
 
-        // Initialize the GMRES algorithm
-        resetGMRES<Real,XX> (rtrue,Ml_inv,rst_freq,v,vs,r,norm_r,
-            Qt_e1,Qts);
+            // Initialize the GMRES algorithm
+            resetGMRES<Real,XX> (rtrue,Ml_inv,rst_freq,v,vs,r,norm_r,
+                Qt_e1,Qts);
             
-        // If for some bizarre reason, we're already optimal, don't do any work 
-        gmanip.eval(0,x,b,eps);
-        if(norm_rtrue <= eps) iter_max=0;	
+            // If for some bizarre reason, we're already optimal, don't do any
+            // work 
+            gmanip.eval(0,x0,b,eps);
+            if(norm_rtrue <= eps) done=true;
+
+        // Continue a previous solve
+        } else {
+            rst_freq = gstate.rst_freq;
+
+            // Find the current iterate
+            X::copy(x0,x_p_dx);
+            if(i > 0) {
+                solveInKrylov <Real,XX> (i,&(R[0]),&(Qt_e1[0]),vs,Mr_inv,x,
+                    dx);
+                X::axpy(Real(1.),dx,x_p_dx);
+            }
+
+            // Check the new tolerance at the current iterate.  If we
+            // restarted on the last iteration, a solve from scratch wouldn't
+            // check anything until the next iteration.
+            if(i > 0 || gstate.iter == 0) {
+                gmanip.eval(i,x_p_dx,b,eps);
+                if(norm_rtrue <= eps) done=true;
+            }
+
+            // If we stopped right before a restart, restart now
+            if(!done && i == rst_freq) {
+                X::copy(x_p_dx,x0);
+                resetGMRES<Real,XX> (rtrue,Ml_inv,rst_freq,v,vs,r,norm_r,
+                    Qt_e1,Qts);
+                i = 0;
+            }
+        }
 
         // Iterate until the maximum iteration
+        Natural const iter0 = gstate.iter;
         Natural iter;
-        for(iter = 1; iter <= iter_max;iter++) {
+        for(iter = iter0+1; !done && iter <= iter_max;iter++) {
 
             // Find the current iterate taking into account restarting
             i = iter % rst_freq;
@@ -2004,8 +2980,7 @@ namespace Optizelle {
             // list of Krylov vectros
             X::copy(w,v);
             X::scal(Real(1.)/norm_w,v);
-            vs.emplace_back(std::move(X::init(x)));
-            X::copy(v,vs.back());
+            vs.push_back(v);
 
             // Apply the existing Givens rotations to the new column of R
             Natural j=1;
@@ -2039,7 +3014,7 @@ namespace Optizelle {
             solveInKrylov <Real,XX> (i,&(R[0]),&(Qt_e1[0]),vs,Mr_inv,x,dx);
 
             // Find the current iterate, its residual, the residual's norm
-            X::copy(x,x_p_dx);
+            X::copy(x0,x_p_dx);
             X::axpy(Real(1.),dx,x_p_dx);
             A.eval(x_p_dx,rtrue);
             X::scal(Real(-1.),rtrue);
@@ -2049,6 +3024,10 @@ namespace Optizelle {
             // Adjust the stopping tolerance
             gmanip.eval(i,x_p_dx,b,eps);
 
+            // Manipulate the Krylov iteration if required
+            kmanip.eval(iter,norm_rtrue
+                / (std::numeric_limits <Real>::epsilon()+norm_b));
+
             // Determine if we should exit since the norm of the true residual
             // is small
             if(norm_rtrue <= eps) break;	
@@ -2058,7 +3037,7 @@ namespace Optizelle {
             if(i%rst_freq==0) {
 
                 // Move to the new iterate
-                X::copy(x_p_dx,x);
+                X::copy(x_p_dx,x0);
 
                 // Reset the GMRES algorithm
                 resetGMRES<Real,XX> (rtrue,Ml_inv,rst_freq,v,vs,r,norm_r,
@@ -2072,18 +3051,80 @@ namespace Optizelle {
             }
         }
 
-        // Adjust the iteration number if we ran out of iterations
+        // Adjust the iteration number if we ran out of iterations or didn't
+        // need any
         iter = iter > iter_max ? iter_max : iter;
+        iter = done ? iter0 : iter;
+        gstate.iter = iter;
 
         // As long as we didn't just solve for our new ierate, go ahead and
         // solve for it now.
+        X::copy(x0,x);
         if(i > 0){ 
             solveInKrylov <Real,XX> (i,&(R[0]),&(Qt_e1[0]),vs,Mr_inv,x,dx);
             X::axpy(Real(1.),dx,x);
         }
 
-        // Return the norm and the residual
-        return std::pair <Real,Natural> (norm_rtrue,iter);
+        // Return the norm and the number of iterations in this call
+        return std::pair <Real,Natural> (norm_rtrue,iter-iter0);
+    }
+
+    // Computes the GMRES algorithm in order to solve A(x)=b and keeps what
+    // we need to continue the solve later in gstate.  Otherwise, the
+    // arguments and results are the same as above.
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    std::pair <Real,Natural> gmres(
+        Operator <Real,XX,XX> const & A,
+        typename XX <Real>::Vector const & b,
+        Real const & eps,
+        Natural const & iter_max,
+        Natural const & rst_freq,
+        Operator <Real,XX,XX> const & Ml_inv,
+        Operator <Real,XX,XX> const & Mr_inv,
+        GMRESManipulator <Real,XX> const & gmanip,
+        typename XX <Real>::Vector & x,
+        GMRESState <Real,XX> & gstate
+    ){
+        return gmres <Real,XX> (A,b,eps,iter_max,rst_freq,Ml_inv,Mr_inv,
+            gmanip,EmptyKrylovManipulator <Real> (),x,gstate);
+    }
+
+    // Computes the GMRES algorithm in order to solve A(x)=b.
+    // (input) A : Operator that computes A(x)
+    // (input) b : Right hand side
+    // (input) eps : Relative stopping tolerance.  We check the relative 
+    //    difference between the current and original preconditioned
+    //    norm of the residual.
+    // (input) iter_max : Maximum number of iterations
+    // (input) rst_freq : Restarts GMRES every rst_freq iterations.  If we don't
+    //    want restarting, set this to zero. 
+    // (input) Ml_inv : Operator that computes the left preconditioner
+    // (input) Mr_inv : Operator that computes the right preconditioner
+    // (input/output) x : Initial guess of the solution.  Returns the final
+    //    solution.
+    // (return) (norm_rtrue,iter) : Final norm of the true residual and
+    //    the number of iterations computed.  They are returned in a STL pair.
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    std::pair <Real,Natural> gmres(
+        Operator <Real,XX,XX> const & A,
+        typename XX <Real>::Vector const & b,
+        Real eps,
+        Natural iter_max,
+        Natural rst_freq,
+        Operator <Real,XX,XX> const & Ml_inv,
+        Operator <Real,XX,XX> const & Mr_inv,
+        GMRESManipulator <Real,XX> const & gmanip,
+        typename XX <Real>::Vector & x
+    ){
+        GMRESState <Real,XX> gstate(x);
+        return gmres <Real,XX> (A,b,eps,iter_max,rst_freq,Ml_inv,Mr_inv,
+            gmanip,x,gstate);
     }
     
     // B orthogonalizes a vector x to a list of other xs.  
@@ -2118,25 +3159,9 @@ namespace Optizelle {
         }
     }
     
-    // Computes the truncated MINRES algorithm in order to solve A(x)=b.
-    // (input) A : Operator that computes A(x)
-    // (input) b : Right hand side
-    // (input) B: Operator that computes the symmetric positive definite
-    //    preconditioner
-    // (input) C : Operator that modifies the shape of the trust-region.
-    // (input) eps : Relative stopping tolerance.  We check the relative 
-    //    difference between the current and original preconditioned
-    //    norm of the residual.
-    // (input) iter_max : Maximum number of iterations
-    // (input) delta : Trust region radius.  
-    // (input) x_cntr : Center of the trust-region. 
-    // (output) x : Final solution.
-    // (output) x_cp : The Cauchy-Point, which is defined as the solution x
-    //     after a single iteration.
-    // (output) Bnorm_r : The B-norm of the residual.  In the case that we
-    //     truncate, this is the B-norm of the residual on the previous
-    //     iteration.
-    // (output) iter : Number of iterations computed
+    // Computes the truncated MINRES algorithm, calls kmanip at the end of
+    // each iteration, and borrows the work vectors from pool.  Otherwise, the
+    // arguments and results are the same as below.
     template <
         typename Real,
         template <typename> class XX
@@ -2156,9 +3181,14 @@ namespace Optizelle {
         Real & Bnorm_r0,
         Real & Bnorm_r,
         Natural & iter,
-        KrylovStop::t & krylov_stop
+        KrylovStop::t & krylov_stop,
+        KrylovManipulator <Real> const & kmanip,
+        VectorPool <Real,XX> & pool
     ){
 
+        // Record the time that we spend in the solve
+        OPTIZELLE_TRACE(trace,"truncated_minres","krylov")
+
         // Create some type shortcuts
         typedef XX <Real> X;
         typedef typename X::Vector X_Vector;
@@ -2169,13 +3199,16 @@ namespace Optizelle {
         // Initialize x to zero. 
         X::zero(x);
 
+        // Borrow our work vectors from the pool
+        VectorLease <Real,XX> work(pool);
+
         // Allocate memory for the iterate update 
-        X_Vector dx(X::init(x));
+        X_Vector & dx(work.take(x));
 
         // Allocate memory for a few more temps 
-        X_Vector ABv_last(X::init(x));
-        X_Vector x_tmp1(X::init(x));
-        X_Vector x_tmp2(X::init(x));
+        X_Vector & ABv_last(work.take(x));
+        X_Vector & x_tmp1(work.take(x));
+        X_Vector & x_tmp2(work.take(x));
 
         // Allocate memory for the final column of the R matrix in the
         // QR factorization of T where
@@ -2183,11 +3216,11 @@ namespace Optizelle {
         std::list <Real> R;
 
         // Allocate memory for the list of Krylov vectors
-        std::list <X_Vector> vs;
-        std::list <X_Vector> Bvs;
+        std::list <X_Vector> & vs(work.list());
+        std::list <X_Vector> & Bvs(work.list());
                     
         // Allocate memory for the vectors that compose B V inv(R)            
-        std::list <X_Vector> B_V_Rinvs;
+        std::list <X_Vector> & B_V_Rinvs(work.list());
 
         // Allocoate memory for the Givens rotations
         std::list <std::pair<Real,Real> > Qts;
@@ -2206,10 +3239,10 @@ namespace Optizelle {
         X::scal(Real(1.)/Bnorm_r,x_tmp1);
 
         // Insert the first Krylov vector
-        vs.emplace_back(std::move(X::init(x_tmp1)));
+        pool.take(x,vs);
         X::copy(x_tmp1,vs.back());
         
-        Bvs.emplace_back(std::move(X::init(x_tmp1)));
+        pool.take(x,Bvs);
         B.eval(x_tmp1,Bvs.back());
 
         // Find the initial right hand side for the vector Q' norm(w1) e1.  
@@ -2217,7 +3250,7 @@ namespace Optizelle {
         Qt_e1[1] = Real(0.);
 
         // Allocate memory for the quantity x-x_cntr
-        X_Vector x_m_xcntr(X::init(x));
+        X_Vector & x_m_xcntr(work.take(x));
         X::copy(x_cntr,x_m_xcntr);
         X::scal(Real(-1.),x_m_xcntr);
 
@@ -2257,16 +3290,16 @@ namespace Optizelle {
                 // Check if we need to eliminate any vectors for
                 // orthogonalization.
                 if(vs.size()==orthog_max+1) {
-                    vs.pop_front();
-                    Bvs.pop_front();
+                    pool.give_front(vs);
+                    pool.give_front(Bvs);
                 }
 
                 // Store the Krylov vector 
-                vs.emplace_back(X::init(x));
+                pool.take(x,vs);
                 X::copy(x_tmp1,vs.back());
                 X::scal(Real(1.)/Bnorm_v,vs.back());
                 
-                Bvs.emplace_back(X::init(x));
+                pool.take(x,Bvs);
                 X::copy(x_tmp2,Bvs.back());
                 X::scal(Real(1.)/Bnorm_v,Bvs.back());
                 
@@ -2326,10 +3359,10 @@ namespace Optizelle {
                
                 // Remove unneeded vectors in B V inv(R).
                 if(B_V_Rinvs.size()==orthog_max+1) 
-                    B_V_Rinvs.pop_front();
+                    pool.give_front(B_V_Rinvs);
 
                 // Add in the new B V inv(R) vector.
-                B_V_Rinvs.emplace_back(std::move(X::init(x_tmp1)));
+                pool.take(x,B_V_Rinvs);
                 X::copy(x_tmp1,B_V_Rinvs.back());
 
                 // Solve for the new iterate update
@@ -2398,6 +3431,8 @@ namespace Optizelle {
 
                     // Set the stopping condition
                     krylov_stop = KrylovStop::RelativeErrorSmall;
+                    kmanip.eval(iter,Bnorm_r
+                        / (std::numeric_limits <Real>::epsilon()+Bnorm_r0));
                     break;	
                 }
             }
@@ -2460,6 +3495,8 @@ namespace Optizelle {
                 // If this is the first iteration, save the Cauchy-Point
                 if(iter==1) 
                     X::copy(x,x_cp);
+                kmanip.eval(iter,Bnorm_r
+                    / (std::numeric_limits <Real>::epsilon()+Bnorm_r0));
                 break;
             }
 
@@ -2477,6 +3514,10 @@ namespace Optizelle {
             // If this is the first iteration, save the Cauchy-Point
             if(iter==1) 
                 X::copy(x,x_cp);
+
+            // Manipulate the Krylov iteration if required
+            kmanip.eval(iter,Bnorm_r
+                / (std::numeric_limits <Real>::epsilon()+Bnorm_r0));
             
             // Determine if we should exit since the norm of the preconditioned
             // residual is small
@@ -2493,6 +3534,898 @@ namespace Optizelle {
         }
     }
 
+    // Computes the truncated MINRES algorithm in order to solve A(x)=b.
+    // (input) A : Operator that computes A(x)
+    // (input) b : Right hand side
+    // (input) B: Operator that computes the symmetric positive definite
+    //    preconditioner
+    // (input) C : Operator that modifies the shape of the trust-region.
+    // (input) eps : Relative stopping tolerance.  We check the relative 
+    //    difference between the current and original preconditioned
+    //    norm of the residual.
+    // (input) iter_max : Maximum number of iterations
+    // (input) delta : Trust region radius.  
+    // (input) x_cntr : Center of the trust-region. 
+    // (output) x : Final solution.
+    // (output) x_cp : The Cauchy-Point, which is defined as the solution x
+    //     after a single iteration.
+    // (output) Bnorm_r : The B-norm of the residual.  In the case that we
+    //     truncate, this is the B-norm of the residual on the previous
+    //     iteration.
+    // (output) iter : Number of iterations computed
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    void truncated_minres(
+        Operator <Real,XX,XX> const & A,
+        typename XX <Real>::Vector const & b,
+        Operator <Real,XX,XX> const & B,
+        Operator <Real,XX,XX> const & C,
+        Real const & eps,
+        Natural const & iter_max,
+        Natural orthog_max,
+        Real const & delta,
+        typename XX <Real>::Vector const & x_cntr,
+        typename XX <Real>::Vector & x,
+        typename XX <Real>::Vector & x_cp,
+        Real & Bnorm_r0,
+        Real & Bnorm_r,
+        Natural & iter,
+        KrylovStop::t & krylov_stop
+    ){
+        VectorPool <Real,XX> pool;
+        truncated_minres <Real,XX> (A,b,B,C,eps,iter_max,orthog_max,delta,
+            x_cntr,x,x_cp,Bnorm_r0,Bnorm_r,iter,krylov_stop,
+            EmptyKrylovManipulator <Real> (),pool);
+    }
+
+    // Applies an operator in the working precision to vectors that are
+    // stored in the lower precision
+    template <typename Real,template <typename> class XX>
+    struct ShadowOperator :
+        public Operator <typename ShadowPrecision <Real>::t,XX,XX>
+    {
+    private:
+        // Create some type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector X_Vector;
+        typedef typename ShadowPrecision <Real>::t Shadow;
+        typedef XX <Shadow> XS;
+        typedef typename XS::Vector XS_Vector;
+
+        // Operator in the working precision
+        Operator <Real,XX,XX> const & A;
+
+        // Workspace in the working precision
+        mutable X_Vector x;
+        mutable X_Vector A_x;
+    public:
+        ShadowOperator(Operator <Real,XX,XX> const & A_,X_Vector const & x_)
+            : A(A_), x(X::init(x_)), A_x(X::init(x_)) {}
+
+        // Operator interface
+        void eval(XS_Vector const & x_s,XS_Vector & A_x_s) const {
+            XS::template copy_prec <Real> (x_s,x);
+            A.eval(x,A_x);
+            X::template copy_prec <Shadow> (A_x,A_x_s);
+        }
+    };
+
+    // Evaluates a GMRES manipulator in the working precision during a
+    // correction solve of mixed-precision GMRES.  Since the correction solve
+    // finds an update dx to the current iterate x, we give x+dx to the
+    // original manipulator.  In addition, we never ask for a residual
+    // smaller than what the lower precision can resolve.
+    template <typename Real,template <typename> class XX>
+    struct ShadowGMRESManipulator :
+        public GMRESManipulator <typename ShadowPrecision <Real>::t,XX>
+    {
+    private:
+        // Create some type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector X_Vector;
+        typedef typename ShadowPrecision <Real>::t Shadow;
+        typedef XX <Shadow> XS;
+        typedef typename XS::Vector XS_Vector;
+
+        // Manipulator in the working precision
+        GMRESManipulator <Real,XX> const & gmanip;
+
+        // Current iterate and right hand side of the original system
+        X_Vector const & x;
+        X_Vector const & b;
+
+        // Smallest tolerance that we allow
+        Real const eps_min;
+
+        // Workspace for x+dx
+        mutable X_Vector x_p_dx;
+    public:
+        ShadowGMRESManipulator(
+            GMRESManipulator <Real,XX> const & gmanip_,
+            X_Vector const & x_,
+            X_Vector const & b_,
+            Real const & eps_min_
+        ) : gmanip(gmanip_), x(x_), b(b_), eps_min(eps_min_),
+            x_p_dx(X::init(x_)) {}
+
+        // Application
+        void eval(
+            Natural const & iter,
+            XS_Vector const & dx_s,
+            XS_Vector const & r_s,
+            Shadow & eps_s
+        ) const {
+            // x_p_dx <- x + dx
+            XS::template copy_prec <Real> (dx_s,x_p_dx);
+            X::axpy(Real(1.),x,x_p_dx);
+
+            // Find the tolerance in the working precision
+            Real eps(eps_s);
+            gmanip.eval(iter,x_p_dx,b,eps);
+            eps_s = Shadow(eps > eps_min ? eps : eps_min);
+        }
+    };
+
+    // Passes the iterations of a Krylov method that solves for a correction
+    // in iterative refinement to the manipulator of the original solve.  We've
+    // already done iter0 iterations, and the residual at the start of the
+    // correction solve is scale times the initial residual of the original
+    // solve.
+    template <typename Real,typename Real_>
+    struct RefinementKrylovManipulator : public KrylovManipulator <Real_> {
+    private:
+        // Manipulator of the original solve
+        KrylovManipulator <Real> const & kmanip;
+
+        // Iterations that we've already done
+        Natural const iter0;
+
+        // Relative size of the residual at the start of the correction solve
+        Real const scale;
+    public:
+        // Disallow constructors
+        NO_DEFAULT_COPY_ASSIGNMENT(RefinementKrylovManipulator)
+
+        // Grab the original manipulator along with the offsets
+        RefinementKrylovManipulator(
+            KrylovManipulator <Real> const & kmanip_,
+            Natural const & iter0_,
+            Real const & scale_
+        ) : kmanip(kmanip_), iter0(iter0_), scale(scale_) {}
+
+        // Application
+        void eval(Natural const & iter,Real_ const & rel_err) const {
+            kmanip.eval(iter0+iter,scale*Real(rel_err));
+        }
+    };
+
+    // Runs the Krylov methods with iterations in a lower precision and
+    // iterative refinement against the residual in the working precision.
+    // This is the fallback for when the vector space can't convert between
+    // precisions, or when there's no lower precision, where we run the
+    // Krylov methods in the working precision.
+    template <
+        typename Real,
+        template <typename> class XX,
+        bool available = HasPrecisionConversion <Real,XX>::value
+    >
+    struct MixedPrecision {
+        // Disallow constructors
+        NO_CONSTRUCTORS(MixedPrecision)
+
+        // Truncated conjugate direction in the precision krylov_precision
+        // that calls kmanip at the end of each iteration and borrows its
+        // work vectors from pool
+        static void truncated_cd(
+            KrylovPrecision::t const & krylov_precision,
+            Operator <Real,XX,XX> const & A,
+            typename XX <Real>::Vector const & b,
+            Operator <Real,XX,XX> const & B,
+            Operator <Real,XX,XX> const & C,
+            Real const & eps,
+            Natural const & iter_max,
+            Natural const & orthog_max,
+            Real const & delta,
+            typename XX <Real>::Vector const & x_cntr,
+            bool const & do_orthog_check,
+            typename XX <Real>::Vector & x,
+            typename XX <Real>::Vector & x_cp,
+            Real & norm_Br0,
+            Real & norm_Br,
+            Natural & iter,
+            KrylovStop::t & krylov_stop,
+            KrylovManipulator <Real> const & kmanip,
+            VectorPool <Real,XX> & pool
+        ) {
+            Optizelle::truncated_cd <Real,XX> (A,b,B,C,eps,iter_max,orthog_max,
+                delta,x_cntr,do_orthog_check,x,x_cp,norm_Br0,norm_Br,iter,
+                krylov_stop,kmanip,pool);
+        }
+
+        // Truncated conjugate direction in the precision krylov_precision
+        static void truncated_cd(
+            KrylovPrecision::t const & krylov_precision,
+            Operator <Real,XX,XX> const & A,
+            typename XX <Real>::Vector const & b,
+            Operator <Real,XX,XX> const & B,
+            Operator <Real,XX,XX> const & C,
+            Real const & eps,
+            Natural const & iter_max,
+            Natural const & orthog_max,
+            Real const & delta,
+            typename XX <Real>::Vector const & x_cntr,
+            bool const & do_orthog_check,
+            typename XX <Real>::Vector & x,
+            typename XX <Real>::Vector & x_cp,
+            Real & norm_Br0,
+            Real & norm_Br,
+            Natural & iter,
+            KrylovStop::t & krylov_stop
+        ) {
+            Optizelle::truncated_cd <Real,XX> (A,b,B,C,eps,iter_max,orthog_max,
+                delta,x_cntr,do_orthog_check,x,x_cp,norm_Br0,norm_Br,iter,
+                krylov_stop);
+        }
+
+        // Truncated MINRES in the precision krylov_precision that calls
+        // kmanip at the end of each iteration and borrows its work vectors
+        // from pool
+        static void truncated_minres(
+            KrylovPrecision::t const & krylov_precision,
+            Operator <Real,XX,XX> const & A,
+            typename XX <Real>::Vector const & b,
+            Operator <Real,XX,XX> const & B,
+            Operator <Real,XX,XX> const & C,
+            Real const & eps,
+            Natural const & iter_max,
+            Natural const & orthog_max,
+            Real const & delta,
+            typename XX <Real>::Vector const & x_cntr,
+            typename XX <Real>::Vector & x,
+            typename XX <Real>::Vector & x_cp,
+            Real & Bnorm_r0,
+            Real & Bnorm_r,
+            Natural & iter,
+            KrylovStop::t & krylov_stop,
+            KrylovManipulator <Real> const & kmanip,
+            VectorPool <Real,XX> & pool
+        ) {
+            Optizelle::truncated_minres <Real,XX> (A,b,B,C,eps,iter_max,
+                orthog_max,delta,x_cntr,x,x_cp,Bnorm_r0,Bnorm_r,iter,
+                krylov_stop,kmanip,pool);
+        }
+
+        // Truncated MINRES in the precision krylov_precision
+        static void truncated_minres(
+            KrylovPrecision::t const & krylov_precision,
+            Operator <Real,XX,XX> const & A,
+            typename XX <Real>::Vector const & b,
+            Operator <Real,XX,XX> const & B,
+            Operator <Real,XX,XX> const & C,
+            Real const & eps,
+            Natural const & iter_max,
+            Natural const & orthog_max,
+            Real const & delta,
+            typename XX <Real>::Vector const & x_cntr,
+            typename XX <Real>::Vector & x,
+            typename XX <Real>::Vector & x_cp,
+            Real & Bnorm_r0,
+            Real & Bnorm_r,
+            Natural & iter,
+            KrylovStop::t & krylov_stop
+        ) {
+            Optizelle::truncated_minres <Real,XX> (A,b,B,C,eps,iter_max,
+                orthog_max,delta,x_cntr,x,x_cp,Bnorm_r0,Bnorm_r,iter,
+                krylov_stop);
+        }
+
+        // GMRES in the precision krylov_precision that calls kmanip at the
+        // end of each iteration
+        static std::pair <Real,Natural> gmres(
+            KrylovPrecision::t const & krylov_precision,
+            Operator <Real,XX,XX> const & A,
+            typename XX <Real>::Vector const & b,
+            Real const & eps,
+            Natural const & iter_max,
+            Natural const & rst_freq,
+            Operator <Real,XX,XX> const & Ml_inv,
+            Operator <Real,XX,XX> const & Mr_inv,
+            GMRESManipulator <Real,XX> const & gmanip,
+            KrylovManipulator <Real> const & kmanip,
+            typename XX <Real>::Vector & x
+        ) {
+            GMRESState <Real,XX> gstate(x);
+            return Optizelle::gmres <Real,XX> (A,b,eps,iter_max,rst_freq,
+                Ml_inv,Mr_inv,gmanip,kmanip,x,gstate);
+        }
+
+        // GMRES in the precision krylov_precision
+        static std::pair <Real,Natural> gmres(
+            KrylovPrecision::t const & krylov_precision,
+            Operator <Real,XX,XX> const & A,
+            typename XX <Real>::Vector const & b,
+            Real const & eps,
+            Natural const & iter_max,
+            Natural const & rst_freq,
+            Operator <Real,XX,XX> const & Ml_inv,
+            Operator <Real,XX,XX> const & Mr_inv,
+            GMRESManipulator <Real,XX> const & gmanip,
+            typename XX <Real>::Vector & x
+        ) {
+            return Optizelle::gmres <Real,XX> (A,b,eps,iter_max,rst_freq,
+                Ml_inv,Mr_inv,gmanip,x);
+        }
+
+        // GMRES in the precision krylov_precision that can continue a
+        // previous solve and calls kmanip at the end of each iteration
+        static std::pair <Real,Natural> gmres(
+            KrylovPrecision::t const & krylov_precision,
+            Operator <Real,XX,XX> const & A,
+            typename XX <Real>::Vector const & b,
+            Real const & eps,
+            Natural const & iter_max,
+            Natural const & rst_freq,
+            Operator <Real,XX,XX> const & Ml_inv,
+            Operator <Real,XX,XX> const & Mr_inv,
+            GMRESManipulator <Real,XX> const & gmanip,
+            KrylovManipulator <Real> const & kmanip,
+            typename XX <Real>::Vector & x,
+            GMRESState <Real,XX> & gstate
+        ) {
+            return Optizelle::gmres <Real,XX> (A,b,eps,iter_max,rst_freq,
+                Ml_inv,Mr_inv,gmanip,kmanip,x,gstate);
+        }
+
+        // GMRES in the precision krylov_precision that can continue a
+        // previous solve
+        static std::pair <Real,Natural> gmres(
+            KrylovPrecision::t const & krylov_precision,
+            Operator <Real,XX,XX> const & A,
+            typename XX <Real>::Vector const & b,
+            Real const & eps,
+            Natural const & iter_max,
+            Natural const & rst_freq,
+            Operator <Real,XX,XX> const & Ml_inv,
+            Operator <Real,XX,XX> const & Mr_inv,
+            GMRESManipulator <Real,XX> const & gmanip,
+            typename XX <Real>::Vector & x,
+            GMRESState <Real,XX> & gstate
+        ) {
+            return Optizelle::gmres <Real,XX> (A,b,eps,iter_max,rst_freq,
+                Ml_inv,Mr_inv,gmanip,x,gstate);
+        }
+    };
+
+    // Mixed-precision Krylov methods when the vector space can convert
+    // between precisions.  Each method first solves the system in the lower
+    // precision.  Then, we compute the residual in the working precision and
+    // solve for a correction in the lower precision until the residual is
+    // small enough, the iteration budget runs out, or the correction no
+    // longer reduces the residual.  In the last case, or if the lower
+    // precision solve breaks down, we finish the solve in the working
+    // precision.  The total number of Krylov iterations never exceeds
+    // iter_max.
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    struct MixedPrecision <Real,XX,true> {
+    private:
+        // Create some type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector X_Vector;
+        typedef typename ShadowPrecision <Real>::t Shadow;
+        typedef XX <Shadow> XS;
+        typedef typename XS::Vector XS_Vector;
+
+        // Smallest relative tolerance that we ask of the lower precision
+        static Real eps_min() {
+            return Real(100.)*Real(std::numeric_limits <Shadow>::epsilon());
+        }
+
+        // Runs one of the truncated Krylov methods in the precision Real_
+        template <typename Real_>
+        static void truncated_solve(
+            bool const & minres,
+            Operator <Real_,XX,XX> const & A,
+            typename XX <Real_>::Vector const & b,
+            Operator <Real_,XX,XX> const & B,
+            Operator <Real_,XX,XX> const & C,
+            Real_ const & eps,
+            Natural const & iter_max,
+            Natural const & orthog_max,
+            Real_ const & delta,
+            typename XX <Real_>::Vector const & x_cntr,
+            bool const & do_orthog_check,
+            typename XX <Real_>::Vector & x,
+            typename XX <Real_>::Vector & x_cp,
+            Real_ & norm_r0,
+            Real_ & norm_r,
+            Natural & iter,
+            KrylovStop::t & krylov_stop,
+            KrylovManipulator <Real_> const & kmanip
+        ) {
+            VectorPool <Real_,XX> pool;
+            if(minres)
+                Optizelle::truncated_minres <Real_,XX> (A,b,B,C,eps,iter_max,
+                    orthog_max,delta,x_cntr,x,x_cp,norm_r0,norm_r,iter,
+                    krylov_stop,kmanip,pool);
+            else
+                Optizelle::truncated_cd <Real_,XX> (A,b,B,C,eps,iter_max,
+                    orthog_max,delta,x_cntr,do_orthog_check,x,x_cp,norm_r0,
+                    norm_r,iter,krylov_stop,kmanip,pool);
+        }
+
+        // Finds the norm of the residual used by the truncated Krylov method.
+        // Truncated CD uses || B r || whereas truncated MINRES uses
+        // sqrt(<B r,r>).
+        static Real norm_residual(
+            bool const & minres,
+            Operator <Real,XX,XX> const & B,
+            X_Vector const & r,
+            X_Vector & x_tmp1
+        ) {
+            B.eval(r,x_tmp1);
+            return minres ? sqrt(X::innr(x_tmp1,r)) :sqrt(X::innr(x_tmp1,x_tmp1));
+        }
+
+        // Finds r <- b - A x and its norm
+        static Real residual(
+            bool const & minres,
+            Operator <Real,XX,XX> const & A,
+            X_Vector const & b,
+            Operator <Real,XX,XX> const & B,
+            X_Vector const & x,
+            X_Vector & r,
+            X_Vector & x_tmp1
+        ) {
+            A.eval(x,x_tmp1);
+            X::copy(b,r);
+            X::axpy(Real(-1.),x_tmp1,r);
+            return norm_residual(minres,B,r,x_tmp1);
+        }
+
+        // Truncated Krylov method in mixed precision
+        static void truncated(
+            bool const & minres,
+            Operator <Real,XX,XX> const & A,
+            X_Vector const & b,
+            Operator <Real,XX,XX> const & B,
+            Operator <Real,XX,XX> const & C,
+            Real const & eps,
+            Natural const & iter_max,
+            Natural const & orthog_max,
+            Real const & delta,
+            X_Vector const & x_cntr,
+            bool const & do_orthog_check,
+            X_Vector & x,
+            X_Vector & x_cp,
+            Real & norm_r0,
+            Real & norm_r,
+            Natural & iter,
+            KrylovStop::t & krylov_stop,
+            KrylovManipulator <Real> const & kmanip
+        ) {
+            // Wrap the operators so that they accept vectors in the lower
+            // precision
+            ShadowOperator <Real,XX> A_s(A,x);
+            ShadowOperator <Real,XX> B_s(B,x);
+            ShadowOperator <Real,XX> C_s(C,x);
+
+            // Allocate memory for the lower precision solves
+            XS_Vector b_s(X::template init_prec <Shadow> (b));
+            XS_Vector x_cntr_s(X::template init_prec <Shadow> (x));
+            XS_Vector x_s(X::template init_prec <Shadow> (x));
+            XS_Vector x_cp_s(X::template init_prec <Shadow> (x));
+            Shadow norm_r0_s(std::numeric_limits <Shadow>::quiet_NaN());
+            Shadow norm_r_s(std::numeric_limits <Shadow>::quiet_NaN());
+
+            // Find an initial solution in the lower precision
+            X::template copy_prec <Shadow> (b,b_s);
+            X::template copy_prec <Shadow> (x_cntr,x_cntr_s);
+            truncated_solve <Shadow> (minres,A_s,b_s,B_s,C_s,
+                Shadow(eps > eps_min() ? eps : eps_min()),iter_max,orthog_max,
+                Shadow(delta),x_cntr_s,do_orthog_check,x_s,x_cp_s,
+                norm_r0_s,norm_r_s,iter,krylov_stop,
+                RefinementKrylovManipulator <Real,Shadow> (kmanip,0,
+                    Real(1.)));
+
+            // If the lower precision broke down, solve the system in the
+            // working precision instead
+            if( krylov_stop==KrylovStop::Instability ||
+                krylov_stop==KrylovStop::InvalidTrustRegionCenter
+            ) {
+                truncated_solve <Real> (minres,A,b,B,C,eps,iter_max,orthog_max,
+                    delta,x_cntr,do_orthog_check,x,x_cp,norm_r0,norm_r,iter,
+                    krylov_stop,kmanip);
+                return;
+            }
+            XS::template copy_prec <Real> (x_s,x);
+            XS::template copy_prec <Real> (x_cp_s,x_cp);
+
+            // Find the residual and its norm in the working precision
+            X_Vector r(X::init(x));
+            X_Vector x_tmp1(X::init(x));
+            norm_r0 = norm_residual(minres,B,b,x_tmp1);
+            norm_r = residual(minres,A,b,B,x,r,x_tmp1);
+
+            // Refine the solution.  When the Krylov method stops due to
+            // negative curvature or the trust-region, the step is not a
+            // solution of the linear system, so we leave it alone.
+            X_Vector dx(X::init(x));
+            X_Vector dx_cp(X::init(x));
+            X_Vector x_p_dx(X::init(x));
+            X_Vector r_p(X::init(x));
+            X_Vector x_cntr_m_x(X::init(x));
+            XS_Vector r_s(X::template init_prec <Shadow> (x));
+            XS_Vector dx_s(X::template init_prec <Shadow> (x));
+            XS_Vector dx_cp_s(X::template init_prec <Shadow> (x));
+            while(krylov_stop==KrylovStop::RelativeErrorSmall &&
+                norm_r > eps*norm_r0 &&
+                iter < iter_max
+            ) {
+                // Solve A dx = r in the lower precision.  We shift the
+                // trust-region center, so that the trust-region applies to
+                // x+dx.
+                X::copy(x_cntr,x_cntr_m_x);
+                X::axpy(Real(-1.),x,x_cntr_m_x);
+                X::template copy_prec <Shadow> (r,r_s);
+                X::template copy_prec <Shadow> (x_cntr_m_x,x_cntr_s);
+                Real eps_corr = eps*norm_r0/norm_r;
+                Natural iter_corr(0);
+                KrylovStop::t krylov_stop_corr(KrylovStop::RelativeErrorSmall);
+                truncated_solve <Shadow> (minres,A_s,r_s,B_s,C_s,
+                    Shadow(eps_corr > eps_min() ? eps_corr : eps_min()),
+                    iter_max-iter,orthog_max,Shadow(delta),x_cntr_s,
+                    do_orthog_check,dx_s,dx_cp_s,norm_r0_s,norm_r_s,
+                    iter_corr,krylov_stop_corr,
+                    RefinementKrylovManipulator <Real,Shadow> (kmanip,iter,
+                        norm_r/norm_r0));
+                iter += iter_corr;
+
+                // Find the residual at x+dx in the working precision
+                XS::template copy_prec <Real> (dx_s,dx);
+                X::copy(x,x_p_dx);
+                X::axpy(Real(1.),dx,x_p_dx);
+                Real norm_r_p = residual(minres,A,b,B,x_p_dx,r_p,x_tmp1);
+
+                // If the correction broke down or did not reduce the residual,
+                // we've hit the limit of what the lower precision can
+                // resolve.  Finish the solve in the working precision.
+                if( krylov_stop_corr==KrylovStop::Instability ||
+                    krylov_stop_corr==KrylovStop::InvalidTrustRegionCenter ||
+                    iter_corr==0 ||
+                    !(norm_r_p < norm_r)
+                ) {
+                    if(iter < iter_max) {
+                        Real norm_corr0(0.);
+                        Real norm_corr(0.);
+                        truncated_solve <Real> (minres,A,r,B,C,eps_corr,
+                            iter_max-iter,orthog_max,delta,x_cntr_m_x,
+                            do_orthog_check,dx,dx_cp,norm_corr0,norm_corr,
+                            iter_corr,krylov_stop,
+                            RefinementKrylovManipulator <Real,Real> (kmanip,
+                                iter,norm_r/norm_r0));
+                        iter += iter_corr;
+                        X::axpy(Real(1.),dx,x);
+                        norm_r = residual(minres,A,b,B,x,r,x_tmp1);
+                    }
+                    break;
+                }
+
+                // Accept the correction
+                X::copy(x_p_dx,x);
+                X::copy(r_p,r);
+                norm_r = norm_r_p;
+                krylov_stop = krylov_stop_corr;
+            }
+
+            // Make sure that the stopping condition reflects the residual in
+            // the working precision
+            if( krylov_stop==KrylovStop::RelativeErrorSmall &&
+                norm_r > eps*norm_r0
+            )
+                krylov_stop = KrylovStop::MaxItersExceeded;
+        }
+    public:
+        // Disallow constructors
+        NO_CONSTRUCTORS(MixedPrecision)
+
+        // Truncated conjugate direction in the precision krylov_precision
+        // that calls kmanip at the end of each iteration and borrows its work
+        // vectors from pool when we run in the working precision
+        static void truncated_cd(
+            KrylovPrecision::t const & krylov_precision,
+            Operator <Real,XX,XX> const & A,
+            X_Vector const & b,
+            Operator <Real,XX,XX> const & B,
+            Operator <Real,XX,XX> const & C,
+            Real const & eps,
+            Natural const & iter_max,
+            Natural const & orthog_max,
+            Real const & delta,
+            X_Vector const & x_cntr,
+            bool const & do_orthog_check,
+            X_Vector & x,
+            X_Vector & x_cp,
+            Real & norm_Br0,
+            Real & norm_Br,
+            Natural & iter,
+            KrylovStop::t & krylov_stop,
+            KrylovManipulator <Real> const & kmanip,
+            VectorPool <Real,XX> & pool
+        ) {
+            if(krylov_precision==KrylovPrecision::Mixed)
+                truncated(false,A,b,B,C,eps,iter_max,orthog_max,delta,x_cntr,
+                    do_orthog_check,x,x_cp,norm_Br0,norm_Br,iter,krylov_stop,
+                    kmanip);
+            else
+                Optizelle::truncated_cd <Real,XX> (A,b,B,C,eps,iter_max,
+                    orthog_max,delta,x_cntr,do_orthog_check,x,x_cp,norm_Br0,
+                    norm_Br,iter,krylov_stop,kmanip,pool);
+        }
+
+        // Truncated conjugate direction in the precision krylov_precision
+        static void truncated_cd(
+            KrylovPrecision::t const & krylov_precision,
+            Operator <Real,XX,XX> const & A,
+            X_Vector const & b,
+            Operator <Real,XX,XX> const & B,
+            Operator <Real,XX,XX> const & C,
+            Real const & eps,
+            Natural const & iter_max,
+            Natural const & orthog_max,
+            Real const & delta,
+            X_Vector const & x_cntr,
+            bool const & do_orthog_check,
+            X_Vector & x,
+            X_Vector & x_cp,
+            Real & norm_Br0,
+            Real & norm_Br,
+            Natural & iter,
+            KrylovStop::t & krylov_stop
+        ) {
+            VectorPool <Real,XX> pool;
+            truncated_cd(krylov_precision,A,b,B,C,eps,iter_max,orthog_max,
+                delta,x_cntr,do_orthog_check,x,x_cp,norm_Br0,norm_Br,iter,
+                krylov_stop,EmptyKrylovManipulator <Real> (),pool);
+        }
+
+        // Truncated MINRES in the precision krylov_precision that calls kmanip
+        // at the end of each iteration and borrows its work vectors from pool
+        // when we run in the working precision
+        static void truncated_minres(
+            KrylovPrecision::t const & krylov_precision,
+            Operator <Real,XX,XX> const & A,
+            X_Vector const & b,
+            Operator <Real,XX,XX> const & B,
+            Operator <Real,XX,XX> const & C,
+            Real const & eps,
+            Natural const & iter_max,
+            Natural const & orthog_max,
+            Real const & delta,
+            X_Vector const & x_cntr,
+            X_Vector & x,
+            X_Vector & x_cp,
+            Real & Bnorm_r0,
+            Real & Bnorm_r,
+            Natural & iter,
+            KrylovStop::t & krylov_stop,
+            KrylovManipulator <Real> const & kmanip,
+            VectorPool <Real,XX> & pool
+        ) {
+            if(krylov_precision==KrylovPrecision::Mixed)
+                truncated(true,A,b,B,C,eps,iter_max,orthog_max,delta,x_cntr,
+                    false,x,x_cp,Bnorm_r0,Bnorm_r,iter,krylov_stop,kmanip);
+            else
+                Optizelle::truncated_minres <Real,XX> (A,b,B,C,eps,iter_max,
+                    orthog_max,delta,x_cntr,x,x_cp,Bnorm_r0,Bnorm_r,iter,
+                    krylov_stop,kmanip,pool);
+        }
+
+        // Truncated MINRES in the precision krylov_precision
+        static void truncated_minres(
+            KrylovPrecision::t const & krylov_precision,
+            Operator <Real,XX,XX> const & A,
+            X_Vector const & b,
+            Operator <Real,XX,XX> const & B,
+            Operator <Real,XX,XX> const & C,
+            Real const & eps,
+            Natural const & iter_max,
+            Natural const & orthog_max,
+            Real const & delta,
+            X_Vector const & x_cntr,
+            X_Vector & x,
+            X_Vector & x_cp,
+            Real & Bnorm_r0,
+            Real & Bnorm_r,
+            Natural & iter,
+            KrylovStop::t & krylov_stop
+        ) {
+            VectorPool <Real,XX> pool;
+            truncated_minres(krylov_precision,A,b,B,C,eps,iter_max,orthog_max,
+                delta,x_cntr,x,x_cp,Bnorm_r0,Bnorm_r,iter,krylov_stop,
+                EmptyKrylovManipulator <Real> (),pool);
+        }
+
+        // GMRES in the precision krylov_precision that calls kmanip at the
+        // end of each iteration
+        static std::pair <Real,Natural> gmres(
+            KrylovPrecision::t const & krylov_precision,
+            Operator <Real,XX,XX> const & A,
+            X_Vector const & b,
+            Real eps,
+            Natural const & iter_max,
+            Natural const & rst_freq,
+            Operator <Real,XX,XX> const & Ml_inv,
+            Operator <Real,XX,XX> const & Mr_inv,
+            GMRESManipulator <Real,XX> const & gmanip,
+            KrylovManipulator <Real> const & kmanip,
+            X_Vector & x
+        ) {
+            // Run in the working precision if requested
+            if(krylov_precision!=KrylovPrecision::Mixed) {
+                GMRESState <Real,XX> gstate(x);
+                gstate.vs.compress(
+                    krylov_precision==KrylovPrecision::Compressed);
+                return Optizelle::gmres <Real,XX> (A,b,eps,iter_max,rst_freq,
+                    Ml_inv,Mr_inv,gmanip,kmanip,x,gstate);
+            }
+
+            // Wrap the operators so that they accept vectors in the lower
+            // precision
+            ShadowOperator <Real,XX> A_s(A,x);
+            ShadowOperator <Real,XX> Ml_inv_s(Ml_inv,x);
+            ShadowOperator <Real,XX> Mr_inv_s(Mr_inv,x);
+
+            // Find the true residual and its norm
+            X_Vector r(X::init(x));
+            X_Vector x_tmp1(X::init(x));
+            A.eval(x,x_tmp1);
+            X::copy(b,r);
+            X::axpy(Real(-1.),x_tmp1,r);
+            Real norm_r = sqrt(X::innr(r,r));
+
+            // Find the norm of the right hand side, which scales the
+            // residuals that we give to kmanip
+            Real const norm_b = sqrt(X::innr(b,b))
+                + std::numeric_limits <Real>::epsilon();
+
+            // Find the stopping tolerance 
+            gmanip.eval(0,x,b,eps);
+
+            // Refine the solution
+            X_Vector dx(X::init(x));
+            X_Vector x_p_dx(X::init(x));
+            X_Vector r_p(X::init(x));
+            XS_Vector r_s(X::template init_prec <Shadow> (x));
+            XS_Vector dx_s(X::template init_prec <Shadow> (x));
+            Natural iter(0);
+            while(norm_r > eps && iter < iter_max) {
+                // Solve A dx = r in the lower precision.  We can't expect the
+                // lower precision to reduce the residual too much, so we
+                // limit the tolerance relative to the current residual.
+                X::template copy_prec <Shadow> (r,r_s);
+                XS::zero(dx_s);
+                Real eps_corr_min = eps_min()*norm_r;
+                ShadowGMRESManipulator <Real,XX> gmanip_s(gmanip,x,b,
+                    eps_corr_min);
+                RefinementKrylovManipulator <Real,Shadow> kmanip_s(kmanip,iter,
+                    norm_r/norm_b);
+                GMRESState <Shadow,XX> gstate_s(dx_s);
+                Natural iter_corr = Optizelle::gmres <Shadow,XX> (A_s,r_s,
+                    Shadow(eps > eps_corr_min ? eps : eps_corr_min),
+                    iter_max-iter,rst_freq,Ml_inv_s,Mr_inv_s,gmanip_s,
+                    kmanip_s,dx_s,gstate_s
+                ).second;
+                iter += iter_corr;
+
+                // Find the residual at x+dx in the working precision
+                XS::template copy_prec <Real> (dx_s,dx);
+                X::copy(x,x_p_dx);
+                X::axpy(Real(1.),dx,x_p_dx);
+                A.eval(x_p_dx,x_tmp1);
+                X::copy(b,r_p);
+                X::axpy(Real(-1.),x_tmp1,r_p);
+                Real norm_r_p = sqrt(X::innr(r_p,r_p));
+
+                // If the correction did not reduce the residual, finish the
+                // solve in the working precision
+                if(iter_corr==0 || !(norm_r_p < norm_r)) {
+                    if(iter < iter_max) {
+                        GMRESState <Real,XX> gstate(x);
+                        std::pair <Real,Natural> result =
+                            Optizelle::gmres <Real,XX> (A,b,eps,iter_max-iter,
+                                rst_freq,Ml_inv,Mr_inv,gmanip,
+                                RefinementKrylovManipulator <Real,Real> (
+                                    kmanip,iter,Real(1.)),
+                                x,gstate);
+                        norm_r = result.first;
+                        iter += result.second;
+                    }
+                    break;
+                }
+
+                // Accept the correction and update the stopping tolerance
+                X::copy(x_p_dx,x);
+                X::copy(r_p,r);
+                norm_r = norm_r_p;
+                gmanip.eval(iter,x,b,eps);
+            }
+
+            // Return the norm and the number of iterations
+            return std::pair <Real,Natural> (norm_r,iter);
+        }
+
+        // GMRES in the precision krylov_precision
+        static std::pair <Real,Natural> gmres(
+            KrylovPrecision::t const & krylov_precision,
+            Operator <Real,XX,XX> const & A,
+            X_Vector const & b,
+            Real const & eps,
+            Natural const & iter_max,
+            Natural const & rst_freq,
+            Operator <Real,XX,XX> const & Ml_inv,
+            Operator <Real,XX,XX> const & Mr_inv,
+            GMRESManipulator <Real,XX> const & gmanip,
+            X_Vector & x
+        ) {
+            return gmres(krylov_precision,A,b,eps,iter_max,rst_freq,Ml_inv,
+                Mr_inv,gmanip,EmptyKrylovManipulator <Real> (),x);
+        }
+
+        // GMRES in the precision krylov_precision that can continue a
+        // previous solve and calls kmanip at the end of each iteration.
+        // Since the refinement in the lower precision doesn't keep a single
+        // Krylov space, we only continue solves in the working precision.
+        static std::pair <Real,Natural> gmres(
+            KrylovPrecision::t const & krylov_precision,
+            Operator <Real,XX,XX> const & A,
+            X_Vector const & b,
+            Real const & eps,
+            Natural const & iter_max,
+            Natural const & rst_freq,
+            Operator <Real,XX,XX> const & Ml_inv,
+            Operator <Real,XX,XX> const & Mr_inv,
+            GMRESManipulator <Real,XX> const & gmanip,
+            KrylovManipulator <Real> const & kmanip,
+            X_Vector & x,
+            GMRESState <Real,XX> & gstate
+        ) {
+            if(krylov_precision!=KrylovPrecision::Mixed) {
+                if(!gstate.started)
+                    gstate.vs.compress(
+                        krylov_precision==KrylovPrecision::Compressed);
+                return Optizelle::gmres <Real,XX> (A,b,eps,iter_max,rst_freq,
+                    Ml_inv,Mr_inv,gmanip,kmanip,x,gstate);
+            }
+            gstate.reset();
+            return gmres(krylov_precision,A,b,eps,iter_max,rst_freq,Ml_inv,
+                Mr_inv,gmanip,kmanip,x);
+        }
+
+        // GMRES in the precision krylov_precision that can continue a
+        // previous solve
+        static std::pair <Real,Natural> gmres(
+            KrylovPrecision::t const & krylov_precision,
+            Operator <Real,XX,XX> const & A,
+            X_Vector const & b,
+            Real const & eps,
+            Natural const & iter_max,
+            Natural const & rst_freq,
+            Operator <Real,XX,XX> const & Ml_inv,
+            Operator <Real,XX,XX> const & Mr_inv,
+            GMRESManipulator <Real,XX> const & gmanip,
+            X_Vector & x,
+            GMRESState <Real,XX> & gstate
+        ) {
+            return gmres(krylov_precision,A,b,eps,iter_max,rst_freq,Ml_inv,
+                Mr_inv,gmanip,EmptyKrylovManipulator <Real> (),x,gstate);
+        }
+    };
+
     // Determines the relative error between two vectors where the second vector
     // may or may not have been initialized.  This is typically used for
     // determining the relative error between a vector and some cached value.
@@ -2525,6 +4458,139 @@ namespace Optizelle {
             return rel_err;
         }
     } 
+
+    // Records the vector used to compute a cached quantity.  Most of these
+    // quantities are computed at a variable held in the optimization state,
+    // such as x, y, or z, and the algorithms assign that variable a new
+    // version token each time they modify it.  In this case, we only record
+    // the token and check whether the cache is current by comparing tokens,
+    // which avoids copying the vectors.  For any other vector, we keep a
+    // copy and fall back to the relative error.  We trust the token alone,
+    // so code that modifies one of these variables without assigning it a
+    // new token, such as a state manipulator that forgets to, leaves the
+    // cache stale.  When built with OPTIZELLE_CHECK_VERSIONS, we also keep a
+    // copy and the norm of the tracked variable and assert that matching
+    // tokens correspond to matching vectors.
+    template <typename Real,template <typename> class XX>
+    struct VersionedCache {
+    private:
+        // Create some type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector X_Vector;
+
+        // Variable whose changes we track along with its version token
+        X_Vector const & x_tracked;
+        Natural const & version;
+
+        // Whether the cached quantity corresponds to the tracked variable
+        // and, if so, at which version
+        bool tracked;
+        Natural version_cached;
+
+        // Copy of the vector used for the cached quantity, which we only
+        // allocate once we cache a quantity at a vector other than the
+        // tracked variable, or when checking the tokens.  The boolean
+        // denotes whether we can use the copy for comparisons.
+        bool copied;
+        std::unique_ptr <X_Vector> x_cached;
+
+        #ifdef OPTIZELLE_CHECK_VERSIONS
+        // Norm of the tracked variable when we recorded its version
+        Real norm_cached;
+        #endif
+
+        // Determines the relative error between x and the copy
+        Real rel_err(X_Vector const & x) const {
+            // If we've not been cached yet, return infinity
+            if(!copied)
+                return std::numeric_limits <Real>::infinity();
+
+            // Otherwise, figure out the residual between x_cached and x
+            X_Vector x_tmp1(X::init(x));
+            X::copy(*x_cached,x_tmp1);
+            X::axpy(Real(-1.),x,x_tmp1);
+
+            // Figure out the relative error between x and x_cached
+            return sqrt(X::innr(x_tmp1,x_tmp1)) /
+                (std::numeric_limits <Real>::epsilon() + sqrt(X::innr(x,x)));
+        }
+
+        // Copies x into the cache and allocates the copy on first use
+        void copy(X_Vector const & x) {
+            if(!x_cached)
+                x_cached.reset(new X_Vector(X::init(x)));
+            X::copy(x,*x_cached);
+            copied=true;
+        }
+
+    public:
+        // Disallow constructors
+        NO_DEFAULT_COPY_ASSIGNMENT(VersionedCache)
+
+        // Start with nothing cached 
+        VersionedCache(X_Vector const & x_tracked_,Natural const & version_)
+            : x_tracked(x_tracked_), version(version_), tracked(false),
+            version_cached(0), copied(false), x_cached()
+            #ifdef OPTIZELLE_CHECK_VERSIONS
+            , norm_cached(0.)
+            #endif
+        {}
+
+        // Determines whether the cached quantity corresponds to x 
+        bool current(X_Vector const & x) {
+            // If x is the tracked variable, compare the tokens
+            if(&x==&x_tracked && tracked) {
+                #ifdef OPTIZELLE_CHECK_VERSIONS
+                if(version_cached==version) {
+                    assert((fabs(sqrt(X::innr(x,x))-norm_cached)
+                        <= std::numeric_limits <Real>::epsilon()*1e1
+                            *norm_cached));
+                    assert((rel_err(x)
+                        < std::numeric_limits <Real>::epsilon()*1e1));
+                }
+                #endif
+                return version_cached==version;
+            }
+
+            // Otherwise, compare against the copy if we have one
+            if(rel_err(x) >= std::numeric_limits <Real>::epsilon()*1e1)
+                return false;
+
+            // If x is the tracked variable, record its version, so that
+            // later checks only compare tokens
+            if(&x==&x_tracked) {
+                tracked=true;
+                version_cached=version;
+                #ifdef OPTIZELLE_CHECK_VERSIONS
+                norm_cached=sqrt(X::innr(x,x));
+                #else
+                copied=false;
+                #endif
+            }
+            return true;
+        }
+
+        // Records that the cached quantity now corresponds to x
+        void update(X_Vector const & x) {
+            tracked = &x==&x_tracked;
+            version_cached=version;
+            #ifdef OPTIZELLE_CHECK_VERSIONS
+            norm_cached=tracked ? sqrt(X::innr(x,x)) : Real(0.);
+            copy(x);
+            #else
+            if(tracked)
+                copied=false;
+            else
+                copy(x);
+            #endif
+        }
+
+        // Forces the cached quantity to be recomputed
+        void reset() {
+            tracked=false;
+            copied=false;
+        }
+    };
 //---Optizelle2---
 }
 //---Optizelle3---
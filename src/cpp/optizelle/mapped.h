@@ -0,0 +1,374 @@
+/*
+Copyright 2013-2014 OptimoJoe.
+
+For the full copyright notice, see LICENSE.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Author: Joseph Young (joe@optimojoe.com)
+*/
+
+#ifndef MAPPED_H
+#define MAPPED_H
+
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "optizelle/optizelle.h"
+#include "optizelle/linalg.h"
+
+//---Optizelle0---
+namespace Optizelle {
+//---Optizelle1---
+
+    // A vector in R^m whose storage is a memory-mapped file.  We create the
+    // file in a scratch directory and unlink it right away, so it disappears
+    // when we release the vector or the program ends.  Since the mapping is
+    // backed by a file rather than swap, the kernel writes pages that we
+    // haven't touched recently back to the file and drops them, which lets
+    // us hold more vectors than fit in memory.  The scratch directory should
+    // be on a local disk rather than a memory-backed file system such as
+    // tmpfs.
+    template <typename Real>
+    struct MappedVector {
+        // Directory that holds the file backing this vector
+        std::string dir;
+
+        // Number of elements
+        Natural n;
+
+        // Mapped elements
+        Real * data;
+
+        // Eliminate constructors
+        NO_DEFAULT_COPY_ASSIGNMENT(MappedVector)
+
+        // Maps n elements, initialized to zero, from a new file in dir
+        MappedVector(
+            Natural const & n_,
+            std::string const & dir_,
+            Messaging const msg = Optizelle::Messaging()
+        ) : dir(dir_), n(n_), data(nullptr) {
+            // There's nothing to map for an empty vector
+            if(n==0) return;
+
+            // Create the file and remove its name
+            std::string name = dir + "/optizelle.XXXXXX";
+            int const fd = mkstemp(&(name[0]));
+            if(fd < 0)
+                msg.error("Unable to create a file for a mapped vector in "
+                    + dir + ": " + std::strerror(errno));
+            unlink(name.c_str());
+
+            // Size the file, which reads as zeros, and map it.  The mapping
+            // keeps the file alive after we close the descriptor.
+            size_t const bytes = n*sizeof(Real);
+            if(ftruncate(fd,off_t(bytes)) != 0) {
+                close(fd);
+                msg.error("Unable to size the file for a mapped vector in "
+                    + dir + ": " + std::strerror(errno));
+            }
+            void * const addr = mmap(nullptr,bytes,PROT_READ | PROT_WRITE,
+                MAP_SHARED,fd,0);
+            close(fd);
+            if(addr == MAP_FAILED)
+                msg.error("Unable to map a vector from " + dir + ": "
+                    + std::strerror(errno));
+            data = static_cast <Real *> (addr);
+
+            // We stream through the vectors from front to back, so ask the
+            // kernel to read ahead aggressively and to release pages soon
+            // after we use them
+            madvise(addr,bytes,MADV_SEQUENTIAL);
+        }
+
+        // Move constructor
+        MappedVector(MappedVector && x) noexcept
+            : dir(std::move(x.dir)), n(x.n), data(x.data)
+        {
+            x.n = 0;
+            x.data = nullptr;
+        }
+
+        // Move assignment operator
+        MappedVector & operator = (MappedVector && x) noexcept {
+            std::swap(dir,x.dir);
+            std::swap(n,x.n);
+            std::swap(data,x.data);
+            return *this;
+        }
+
+        // Unmapping the vector removes its file
+        ~MappedVector() {
+            if(data!=nullptr)
+                munmap(data,n*sizeof(Real));
+        }
+
+        // Number of elements
+        Natural size() const {
+            return n;
+        }
+
+        // Element i
+        Real & operator [] (Natural const & i) {
+            return data[i];
+        }
+        Real const & operator [] (Natural const & i) const {
+            return data[i];
+        }
+    };
+
+    // Vector space for the nonnegative orthant whose vectors live in
+    // memory-mapped files.  This is Rm for problems where the optimization
+    // state, the Krylov bases, and the quasi-Newton history don't fit in
+    // memory.  Every operation streams through its vectors in chunks.  Before
+    // we work on a chunk, we ask the kernel to start reading the next one,
+    // so that the disk and the computation overlap.  Vectors that we rarely
+    // touch, such as old Krylov vectors and quasi-Newton pairs, stay on disk
+    // until we need them.  The vectors that the user creates set the scratch
+    // directory for all of the vectors that the algorithms derive from them.
+    template <typename Real>
+    struct MappedRm {
+        // Disallow constructors
+        NO_CONSTRUCTORS(MappedRm)
+
+        // Store our vectors in mapped files
+        typedef MappedVector <Real> Vector;
+
+        // Number of elements that we process at a time.  This is a multiple
+        // of the page size, so each chunk starts on a page boundary.
+        static Natural const chunk = Natural(1) << 20;
+
+        // Calls f(begin,end) for consecutive chunks [begin,end) of x and
+        // hints that the kernel should read the next chunk of each vector
+        // in ys
+        template <typename F>
+        static void stream(
+            Vector const & x,
+            std::vector <Vector const *> const & ys,
+            F const & f
+        ) {
+            for(Natural begin=0;begin<x.n;begin+=chunk) {
+                Natural const end = std::min(begin+chunk,x.n);
+                if(end < x.n) {
+                    Natural const next = std::min(end+chunk,x.n);
+                    for(auto const & y : ys)
+                        madvise(y->data+end,(next-end)*sizeof(Real),
+                            MADV_WILLNEED);
+                }
+                f(begin,end);
+            }
+        }
+
+        // Memory allocation and size setting.  The new vector uses the
+        // scratch directory of x.
+        static Vector init(Vector const & x) {
+            return std::move(Vector(x.n,x.dir));
+        }
+
+        // y <- x (Shallow.  No memory allocation.)
+        static void copy(Vector const & x, Vector & y) {
+            stream(x,{&x,&y},[&](Natural const & b,Natural const & e) {
+                Optizelle::copy <Real> (e-b,x.data+b,1,y.data+b,1);
+            });
+        }
+
+        // Memory allocation and size setting in the precision Real2
+        template <typename Real2>
+        static typename MappedRm <Real2>::Vector init_prec(
+            Vector const & x
+        ) {
+            return std::move(typename MappedRm <Real2>::Vector(x.n,x.dir));
+        }
+
+        // y <- x where y is stored in the precision Real2
+        template <typename Real2>
+        static void copy_prec(
+            Vector const & x,
+            typename MappedRm <Real2>::Vector & y
+        ) {
+            stream(x,{&x},[&](Natural const & b,Natural const & e) {
+                #ifdef _OPENMP
+                #pragma omp parallel for schedule(static)
+                #endif
+                for(Natural i=b;i<e;i++)
+                    y.data[i]=Real2(x.data[i]);
+            });
+        }
+
+        // innr <- <x,y> where x is stored in the precision Real2
+        template <typename Real2>
+        static Real innr_prec(
+            typename MappedRm <Real2>::Vector const & x,
+            Vector const & y
+        ) {
+            Real z(0.);
+            stream(y,{&y},[&](Natural const & b,Natural const & e) {
+                Real z_chunk(0.);
+                #ifdef _OPENMP
+                #pragma omp parallel for reduction(+:z_chunk) schedule(static)
+                #endif
+                for(Natural i=b;i<e;i++)
+                    z_chunk+=Real(x.data[i])*y.data[i];
+                z+=z_chunk;
+            });
+            return z;
+        }
+
+        // y <- alpha * x + y where x is stored in the precision Real2
+        template <typename Real2>
+        static void axpy_prec(
+            Real const & alpha,
+            typename MappedRm <Real2>::Vector const & x,
+            Vector & y
+        ) {
+            stream(y,{&y},[&](Natural const & b,Natural const & e) {
+                #ifdef _OPENMP
+                #pragma omp parallel for schedule(static)
+                #endif
+                for(Natural i=b;i<e;i++)
+                    y.data[i]+=alpha*Real(x.data[i]);
+            });
+        }
+
+        // x <- alpha * x
+        static void scal(Real const & alpha, Vector & x) {
+            stream(x,{&x},[&](Natural const & b,Natural const & e) {
+                Optizelle::scal <Real> (e-b,alpha,x.data+b,1);
+            });
+        }
+
+        // y <- alpha * x + y
+        static void axpy(Real const & alpha, Vector const & x, Vector & y) {
+            stream(x,{&x,&y},[&](Natural const & b,Natural const & e) {
+                Optizelle::axpy <Real> (e-b,alpha,x.data+b,1,y.data+b,1);
+            });
+        }
+
+        // innr <- <x,y>
+        static Real innr(Vector const & x,Vector const & y) {
+            Real z(0.);
+            stream(x,{&x,&y},[&](Natural const & b,Natural const & e) {
+                z+=Optizelle::dot <Real> (e-b,x.data+b,1,y.data+b,1);
+            });
+            return z;
+        }
+
+        // x <- 0
+        static void zero(Vector & x) {
+            stream(x,{&x},[&](Natural const & b,Natural const & e) {
+                #ifdef _OPENMP
+                #pragma omp parallel for schedule(static)
+                #endif
+                for(Natural i=b;i<e;i++)
+                    x.data[i]=Real(0.);
+            });
+        }
+
+        // x <- random
+        static void rand(Vector & x){
+            std::random_device rd;
+            std::mt19937 gen(rd());
+            std::normal_distribution<Real> dis(Real(0.),Real(1.));
+            for(Natural i=0;i<x.n;i++)
+                x.data[i]=Real(dis(gen));
+        }
+
+        // Jordan product, z <- x o y
+        static void prod(Vector const & x, Vector const & y, Vector & z) {
+            stream(x,{&x,&y,&z},[&](Natural const & b,Natural const & e) {
+                #ifdef _OPENMP
+                #pragma omp parallel for schedule(static)
+                #endif
+                for(Natural i=b;i<e;i++)
+                    z.data[i]=x.data[i]*y.data[i];
+            });
+        }
+
+        // Identity element, x <- e such that x o e = x
+        static void id(Vector & x) {
+            stream(x,{&x},[&](Natural const & b,Natural const & e) {
+                #ifdef _OPENMP
+                #pragma omp parallel for schedule(static)
+                #endif
+                for(Natural i=b;i<e;i++)
+                    x.data[i]=Real(1.);
+            });
+        }
+
+        // Jordan product inverse, z <- inv(L(x)) y where L(x) y = x o y
+        static void linv(Vector const & x,Vector const & y,Vector & z) {
+            stream(x,{&x,&y,&z},[&](Natural const & b,Natural const & e) {
+                #ifdef _OPENMP
+                #pragma omp parallel for schedule(static)
+                #endif
+                for(Natural i=b;i<e;i++)
+                    z.data[i]=y.data[i]/x.data[i];
+            });
+        }
+
+        // Barrier function, barr <- barr(x) where x o grad barr(x) = e
+        static Real barr(Vector const & x) {
+            Real z(0.);
+            stream(x,{&x},[&](Natural const & b,Natural const & e) {
+                Real z_chunk(0.);
+                #ifdef _OPENMP
+                #pragma omp parallel for reduction(+:z_chunk) schedule(static)
+                #endif
+                for(Natural i=b;i<e;i++)
+                    z_chunk+=log(x.data[i]);
+                z+=z_chunk;
+            });
+            return z;
+        }
+
+        // Line search, srch <- argmax {alpha \in Real >= 0 : alpha x + y >= 0}
+        // where y > 0
+        static Real srch(Vector const & x,Vector const & y) {
+            Real alpha=std::numeric_limits <Real>::infinity();
+            stream(x,{&x,&y},[&](Natural const & b,Natural const & e) {
+                for(Natural i=b;i<e;i++)
+                    if(x.data[i] < Real(0.)) {
+                        Real alpha0 = -y.data[i]/x.data[i];
+                        alpha = alpha0 < alpha ? alpha0 : alpha;
+                    }
+            });
+            return alpha;
+        }
+
+        // Symmetrization, x <- symm(x) such that L(symm(x)) is a symmetric
+        // operator
+        static void symm(Vector & x) { }
+    };
+
+//---Optizelle2---
+}
+//---Optizelle3---
+#endif
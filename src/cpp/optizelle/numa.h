@@ -0,0 +1,354 @@
+/*
+Copyright 2013-2014 OptimoJoe.
+
+For the full copyright notice, see LICENSE.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Author: Joseph Young (joe@optimojoe.com)
+*/
+
+#ifndef NUMA_H
+#define NUMA_H
+
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "optizelle/optizelle.h"
+#include "optizelle/linalg.h"
+
+//---Optizelle0---
+namespace Optizelle {
+//---Optizelle1---
+
+    // A vector in R^m whose pages land on the NUMA node of the thread that
+    // first writes them.  Linux doesn't place a page when we allocate it,
+    // but when some thread first touches it, and puts it on the node of
+    // that thread.  A std::vector zeros its elements on the thread that
+    // creates it, so all of its pages end up on one node and every other
+    // node reads them across the interconnect.  Here, we map the elements
+    // without touching them and then zero them with the same static OpenMP
+    // schedule that NumaRm uses for its kernels.  Each thread then works on
+    // the pages that live on its own node.  This only helps when the OpenMP
+    // threads stay on their cores, so run with OMP_PROC_BIND=close or spread
+    // and OMP_PLACES=cores.  Optionally, we ask for transparent huge pages,
+    // which cuts the TLB misses when we stream through long vectors.
+    template <typename Real>
+    struct NumaVector {
+        // Number of elements
+        Natural n;
+
+        // Whether we ask for huge pages
+        bool huge;
+
+        // Mapped elements
+        Real * data;
+
+        // Eliminate constructors
+        NO_DEFAULT_COPY_ASSIGNMENT(NumaVector)
+
+        // Size of a huge page, which is where the mapping starts when we
+        // ask for them
+        static size_t const huge_page = size_t(1) << 21;
+
+        // Number of bytes that we map for n elements
+        static size_t bytes(Natural const & n) {
+            size_t const page = size_t(sysconf(_SC_PAGESIZE));
+            return (n*sizeof(Real)+page-1)/page*page;
+        }
+
+        // Maps n elements and zeros them in parallel
+        NumaVector(
+            Natural const & n_,
+            bool const & huge_ = false,
+            Messaging const msg = Optizelle::Messaging()
+        ) : n(n_), huge(huge_), data(nullptr) {
+            // There's nothing to map for an empty vector
+            if(n==0) return;
+
+            // Map the elements.  When we want huge pages, we map an extra
+            // huge page, so that we can start on a huge page boundary, and
+            // then unmap what lies outside of the elements.
+            size_t const len = bytes(n);
+            size_t const extra = huge ? huge_page : 0;
+            void * const addr = mmap(nullptr,len+extra,PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS,-1,0);
+            if(addr == MAP_FAILED)
+                msg.error("Unable to map a NUMA vector: "
+                    + std::string(std::strerror(errno)));
+            char * begin = static_cast <char *> (addr);
+            if(huge) {
+                uintptr_t const a = reinterpret_cast <uintptr_t> (addr);
+                char * const aligned = begin
+                    + ((a+huge_page-1)/huge_page*huge_page-a);
+                if(aligned > begin)
+                    munmap(begin,aligned-begin);
+                if(begin+extra > aligned)
+                    munmap(aligned+len,begin+extra-aligned);
+                begin = aligned;
+                #ifdef MADV_HUGEPAGE
+                madvise(begin,len,MADV_HUGEPAGE);
+                #endif
+            }
+            data = reinterpret_cast <Real *> (begin);
+
+            // Touch the pages first from the threads that use them
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural i=0;i<n;i++)
+                data[i]=Real(0.);
+        }
+
+        // Move constructor
+        NumaVector(NumaVector && x) noexcept
+            : n(x.n), huge(x.huge), data(x.data)
+        {
+            x.n = 0;
+            x.data = nullptr;
+        }
+
+        // Move assignment operator
+        NumaVector & operator = (NumaVector && x) noexcept {
+            std::swap(n,x.n);
+            std::swap(huge,x.huge);
+            std::swap(data,x.data);
+            return *this;
+        }
+
+        // Release the pages
+        ~NumaVector() {
+            if(data!=nullptr)
+                munmap(data,bytes(n));
+        }
+
+        // Number of elements
+        Natural size() const {
+            return n;
+        }
+
+        // Element i
+        Real & operator [] (Natural const & i) {
+            return data[i];
+        }
+        Real const & operator [] (Natural const & i) const {
+            return data[i];
+        }
+    };
+
+    // Vector space for the nonnegative orthant whose vectors are spread
+    // across the NUMA nodes.  This is Rm for machines with more than one
+    // socket.  Every operation, including the first touch in init, runs
+    // over the elements with the same static OpenMP schedule, so thread t
+    // always works on the block of elements that sits in its own node's
+    // memory.  That's why we don't call BLAS here: its threads split the
+    // vectors in their own way.  The vectors that the user creates set
+    // whether the vectors that the algorithms derive from them use huge
+    // pages.
+    template <typename Real>
+    struct NumaRm {
+        // Disallow constructors
+        NO_CONSTRUCTORS(NumaRm)
+
+        // Store our vectors in NUMA aware pages
+        typedef NumaVector <Real> Vector;
+
+        // Memory allocation and size setting.  The new vector asks for huge
+        // pages when x does.
+        static Vector init(Vector const & x) {
+            return std::move(Vector(x.n,x.huge));
+        }
+
+        // y <- x (Shallow.  No memory allocation.)
+        static void copy(Vector const & x, Vector & y) {
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural i=0;i<x.n;i++)
+                y.data[i]=x.data[i];
+        }
+
+        // Memory allocation and size setting in the precision Real2
+        template <typename Real2>
+        static typename NumaRm <Real2>::Vector init_prec(Vector const & x) {
+            return std::move(typename NumaRm <Real2>::Vector(x.n,x.huge));
+        }
+
+        // y <- x where y is stored in the precision Real2
+        template <typename Real2>
+        static void copy_prec(
+            Vector const & x,
+            typename NumaRm <Real2>::Vector & y
+        ) {
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural i=0;i<x.n;i++)
+                y.data[i]=Real2(x.data[i]);
+        }
+
+        // innr <- <x,y> where x is stored in the precision Real2
+        template <typename Real2>
+        static Real innr_prec(
+            typename NumaRm <Real2>::Vector const & x,
+            Vector const & y
+        ) {
+            Real z(0.);
+            #ifdef _OPENMP
+            #pragma omp parallel for reduction(+:z) schedule(static)
+            #endif
+            for(Natural i=0;i<y.n;i++)
+                z+=Real(x.data[i])*y.data[i];
+            return z;
+        }
+
+        // y <- alpha * x + y where x is stored in the precision Real2
+        template <typename Real2>
+        static void axpy_prec(
+            Real const & alpha,
+            typename NumaRm <Real2>::Vector const & x,
+            Vector & y
+        ) {
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural i=0;i<y.n;i++)
+                y.data[i]+=alpha*Real(x.data[i]);
+        }
+
+        // x <- alpha * x
+        static void scal(Real const & alpha, Vector & x) {
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural i=0;i<x.n;i++)
+                x.data[i]*=alpha;
+        }
+
+        // y <- alpha * x + y
+        static void axpy(Real const & alpha, Vector const & x, Vector & y) {
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural i=0;i<x.n;i++)
+                y.data[i]+=alpha*x.data[i];
+        }
+
+        // innr <- <x,y>
+        static Real innr(Vector const & x,Vector const & y) {
+            Real z(0.);
+            #ifdef _OPENMP
+            #pragma omp parallel for reduction(+:z) schedule(static)
+            #endif
+            for(Natural i=0;i<x.n;i++)
+                z+=x.data[i]*y.data[i];
+            return z;
+        }
+
+        // x <- 0
+        static void zero(Vector & x) {
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural i=0;i<x.n;i++)
+                x.data[i]=Real(0.);
+        }
+
+        // x <- random
+        static void rand(Vector & x){
+            std::random_device rd;
+            std::mt19937 gen(rd());
+            std::normal_distribution<Real> dis(Real(0.),Real(1.));
+            for(Natural i=0;i<x.n;i++)
+                x.data[i]=Real(dis(gen));
+        }
+
+        // Jordan product, z <- x o y
+        static void prod(Vector const & x, Vector const & y, Vector & z) {
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural i=0;i<x.n;i++)
+                z.data[i]=x.data[i]*y.data[i];
+        }
+
+        // Identity element, x <- e such that x o e = x
+        static void id(Vector & x) {
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural i=0;i<x.n;i++)
+                x.data[i]=Real(1.);
+        }
+
+        // Jordan product inverse, z <- inv(L(x)) y where L(x) y = x o y
+        static void linv(Vector const & x,Vector const & y,Vector & z) {
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural i=0;i<x.n;i++)
+                z.data[i]=y.data[i]/x.data[i];
+        }
+
+        // Barrier function, barr <- barr(x) where x o grad barr(x) = e
+        static Real barr(Vector const & x) {
+            Real z(0.);
+            #ifdef _OPENMP
+            #pragma omp parallel for reduction(+:z) schedule(static)
+            #endif
+            for(Natural i=0;i<x.n;i++)
+                z+=log(x.data[i]);
+            return z;
+        }
+
+        // Line search, srch <- argmax {alpha \in Real >= 0 : alpha x + y >= 0}
+        // where y > 0
+        static Real srch(Vector const & x,Vector const & y) {
+            Real alpha=std::numeric_limits <Real>::infinity();
+            #ifdef _OPENMP
+            #pragma omp parallel for reduction(min:alpha) schedule(static)
+            #endif
+            for(Natural i=0;i<x.n;i++)
+                if(x.data[i] < Real(0.)) {
+                    Real alpha0 = -y.data[i]/x.data[i];
+                    alpha = alpha0 < alpha ? alpha0 : alpha;
+                }
+            return alpha;
+        }
+
+        // Symmetrization, x <- symm(x) such that L(symm(x)) is a symmetric
+        // operator
+        static void symm(Vector & x) { }
+    };
+
+//---Optizelle2---
+}
+//---Optizelle3---
+#endif
@@ -29,18 +29,29 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 Author: Joseph Young (joe@optimojoe.com)
 */
 
+#include <mutex>
 #include "optizelle/optizelle.h"
 
 namespace Optizelle{
 
+    namespace {
+        // Keeps the lines from solves on different threads from
+        // interleaving
+        std::mutex output;
+    }
+
     // Prints a message
     void Messaging::print(std::string const & msg) const {
+        std::lock_guard <std::mutex> lock(output);
         std::cout << msg << std::endl;
     }
 
     // Prints an error
     void Messaging::error(std::string const & msg) const {
-        std::cerr << msg << std::endl;
+        {
+            std::lock_guard <std::mutex> lock(output);
+            std::cerr << msg << std::endl;
+        }
         exit(EXIT_FAILURE);
     }
 
@@ -545,6 +556,8 @@ namespace Optizelle{
                 return "PrimalDualLinked";
             case LogBarrier:
                 return "LogBarrier";
+            case Mehrotra:
+                return "Mehrotra";
             default:
                 throw;
             }
@@ -558,6 +571,8 @@ namespace Optizelle{
                 return PrimalDualLinked; 
             else if(ipm=="LogBarrier")
                 return LogBarrier; 
+            else if(ipm=="Mehrotra")
+                return Mehrotra; 
             else
                 throw;
         }
@@ -566,7 +581,8 @@ namespace Optizelle{
         bool is_valid(std::string const & name) {
             if( name=="PrimalDual" ||
                 name=="PrimalDualLinked" ||
-                name=="LogBarrier"
+                name=="LogBarrier" ||
+                name=="Mehrotra"
             )
                 return true;
             else
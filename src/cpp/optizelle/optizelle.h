@@ -43,12 +43,47 @@ Author: Joseph Young (joe@optimojoe.com)
 #include<functional>
 #include<algorithm>
 #include<numeric>
+#include<chrono>
+#include<typeinfo>
+#include<array>
 #include "optizelle/linalg.h"
 
+// Times the rest of the enclosing scope and accumulates the number of calls
+// and the elapsed time into the given state variables.  Unless we compile
+// with OPTIZELLE_INSTRUMENTATION, this does nothing.
+#ifdef OPTIZELLE_INSTRUMENTATION
+#define OPTIZELLE_TIMER(name,calls,time) \
+    Optizelle::Utility::Timer <Real> name(calls,time);
+#define OPTIZELLE_TIMER_STOP(name) \
+    name.stop();
+#else
+#define OPTIZELLE_TIMER(name,calls,time)
+#define OPTIZELLE_TIMER_STOP(name)
+#endif
+
 //---Optizelle0---
 namespace Optizelle{
 //---Optizelle1---
 
+    // Other than the trace buffers below, the solvers keep no global or
+    // static state, so separate calls to getMin may run concurrently on
+    // different threads as long as they share nothing that they modify.
+    // Everything reachable from a State::t and a Functions::t belongs to that
+    // pair alone.  This includes the workspaces of the function wrappers and
+    // the cached decompositions of SQL vectors, which we modify through const
+    // references, so every concurrent solve needs its own state and
+    // functions.  Any data that the user functions share between solves must
+    // be safe to use concurrently.  The messaging object may be shared since
+    // it serializes its output.
+    //
+    // When we compile with OPTIZELLE_TRACING, every solve records into the
+    // global ring buffers of Trace in trace.h.  Each thread owns its own
+    // buffer, so concurrent solves record without a lock and only a thread
+    // that takes over the buffer of an exited thread overwrites another
+    // thread's events.  However, Trace::capacity, Trace::clear, and
+    // Trace::write_chrome touch every buffer, so we only call them while no
+    // solve runs.
+
     //---ScalarValuedFunction0---
     // A scalar valued function interface, f : X -> R
     template <
@@ -70,6 +105,15 @@ namespace Optizelle{
         virtual void hessvec(Vector const & x,Vector const & dx,Vector & H_dx)
             const = 0;
 
+        // H = hess f(x) as a dense, column-major matrix in the coordinates of
+        // the vector space, which H holds room for.  This is optional and
+        // returns false when the function doesn't provide it.  On vector
+        // spaces with dense coordinates, such as Rm, we use it to solve small
+        // trust-region subproblems directly.
+        virtual bool hessian(Vector const & x,std::vector <Real> & H) const {
+            return false;
+        }
+
         // Allow a derived class to deallocate memory
         virtual ~ScalarValuedFunction() {}
     };
@@ -152,6 +196,15 @@ namespace Optizelle{
         ) const {
             X::copy(H_dx,Hdx_step);
         }
+
+        // Whether or not hessvec_step modifies the Hessian-vector product.
+        // Some algorithms work with the Hessian directly when it's not
+        // modified.  We assume a modification unless a class says otherwise,
+        // so a class that overrides hessvec_step without overriding this
+        // stays correct.
+        virtual bool modifies_hessvec() const {
+            return true;
+        }
     };
 
 
@@ -199,8 +252,67 @@ namespace Optizelle{
     };
     //---VectorValuedFunction1---
 
+    //---LinearizationSession0---
+    // An optional interface for functions that cache data at the current
+    // iterate such as the factorization of a PDE operator.  When the
+    // objective or a constraint also derives from this class, the algorithms
+    // announce each new iterate along with its version token.  Any call whose
+    // argument satisfies at_iterate may then reuse the data cached during the
+    // last announcement.  Calls at other points, such as trial steps, may not.
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    struct LinearizationSession {
+    private:
+        // Create some type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector Vector;
+
+        // The iterate and version token from the last announcement
+        Vector const * x;
+        Natural const * x_version;
+
+        // Value of the version token when we last announced
+        Natural version_announced;
+
+    public:
+        // Disallow constructors
+        NO_COPY_ASSIGNMENT(LinearizationSession)
+
+        // Nothing is announced to start
+        LinearizationSession()
+            : x(nullptr), x_version(nullptr), version_announced(0) {}
+
+        // Called once for each new iterate x
+        virtual void linearize(Vector const & x,Natural const & x_version) {}
+
+        // Announces the current iterate and its version token.  This is
+        // called by the algorithms.
+        void announce(Vector const & x_,Natural const & x_version_) {
+            bool const fresh = x_version==nullptr
+                || version_announced!=x_version_;
+            x=&x_;
+            x_version=&x_version_;
+            version_announced=x_version_;
+            if(fresh) linearize(x_,x_version_);
+        }
+
+        // Determines whether x is the announced iterate and hasn't changed
+        // since the announcement
+        bool at_iterate(Vector const & x_) const {
+            return &x_==x && *x_version==version_announced;
+        }
+
+        // Allow a derived class to deallocate memory
+        virtual ~LinearizationSession() {}
+    };
+    //---LinearizationSession1---
+
     //---Messaging0---
-    // Defines how we output messages to the user
+    // Defines how we output messages to the user.  Concurrent solves may
+    // share a messaging object, so derived classes should make print and
+    // error safe to call from multiple threads.
     struct Messaging {
         // Prints a message
         virtual void print(std::string const & msg) const;
@@ -465,7 +577,9 @@ namespace Optizelle{
             PrimalDual,          // Standard primal-dual interior point method 
             PrimalDualLinked,    // A primal dual IPM, but the primal and dual
                                  // variables are kept in lock step.
-            LogBarrier           // Primal log-barrier method 
+            LogBarrier,          // Primal log-barrier method 
+            Mehrotra             // Primal-dual method with a Mehrotra
+                                 // predictor-corrector step
             //---InteriorPointMethod1---
         };
         
@@ -1106,6 +1220,9 @@ namespace Optizelle{
 
     //---StateManipulator0---
     // A function that has free reign to manipulate or analyze the state.
+    // A manipulator that modifies x, y, or z must also assign the
+    // corresponding version token a new value with, for example,
+    // state.x_version=++state.version.
     template <typename ProblemClass>
     struct StateManipulator {
         // Disallow constructors
@@ -1143,26 +1260,147 @@ namespace Optizelle{
         ) const {}
     };
    
-    // A state manipulator that's been customized in order to print diagonistic
+    // Kinds of values that we report as telemetry
+    namespace TelemetryKind {
+        enum t : Natural {
+            Blank,          // Nothing to report, such as before the first step
+            Integer,        // A natural number, such as an iteration count
+            Number,         // A real number
+            Stop            // Reason why the Krylov method stopped
+        };
+    }
+
+    // A single value of telemetry
+    template <typename Real>
+    struct TelemetryValue {
+        // Kind of value that we hold
+        TelemetryKind::t kind;
+
+        // Value when we hold an integer
+        Natural integer;
+
+        // Value when we hold a real number
+        Real number;
+
+        // Value when we hold the reason the Krylov method stopped
+        KrylovStop::t stop;
+
+        // A blank value
+        TelemetryValue() :
+            kind(TelemetryKind::Blank),
+            integer(0),
+            number(Real(0.)),
+            stop(KrylovStop::RelativeErrorSmall)
+        {}
+
+        // An integer
+        TelemetryValue(Natural const & integer_) :
+            kind(TelemetryKind::Integer),
+            integer(integer_),
+            number(Real(0.)),
+            stop(KrylovStop::RelativeErrorSmall)
+        {}
+
+        // A real number
+        TelemetryValue(Real const & number_) :
+            kind(TelemetryKind::Number),
+            integer(0),
+            number(number_),
+            stop(KrylovStop::RelativeErrorSmall)
+        {}
+
+        // A reason why the Krylov method stopped
+        TelemetryValue(KrylovStop::t const & stop_) :
+            kind(TelemetryKind::Stop),
+            integer(0),
+            number(Real(0.)),
+            stop(stop_)
+        {}
+    };
+
+    // A row of telemetry with one value for each column named in the header
+    template <typename Real>
+    struct TelemetryRecord {
+        // Whether the row comes from a rejected step.  In this case, the
+        // iteration, which is always the first column of the state records,
+        // hasn't advanced.
+        bool rejected;
+
+        // Values of each column
+        std::vector <TelemetryValue <Real> > values;
+
+        // Start with an empty row
+        TelemetryRecord() : rejected(false), values() {}
+    };
+
+    //---TelemetrySink0---
+    // Receives the diagnostic information from the optimization as numbers
+    // rather than formatted text.  The headers name the columns once and then
+    // each record holds one value per column.  The columns depend on the
+    // problem class, the algorithm, and msg_level.
+    template <typename Real>
+    struct TelemetrySink {
+        // Disallow constructors
+        NO_COPY_ASSIGNMENT(TelemetrySink)
+
+        // Give an empty default constructor
+        TelemetrySink() {}
+
+        // Names the columns of the state records
+        virtual void stateHeader(std::vector <std::string> const & names) = 0;
+
+        // Receives the state at the end of an optimization iteration or after
+        // a rejected step
+        virtual void state(TelemetryRecord <Real> const & record) = 0;
+
+        // Names the columns of the Krylov records
+        virtual void krylovHeader(std::vector <std::string> const & names) = 0;
+
+        // Receives the state at the end of a Krylov iteration
+        virtual void krylov(TelemetryRecord <Real> const & record) = 0;
+
+        // Allow the derived class to deallocate memory
+        virtual ~TelemetrySink() {}
+    };
+    //---TelemetrySink1---
+
+    // A state manipulator that's been customized in order to report diagonistic
     // information
-    template <typename ProblemClass>
+    template <typename Real,typename ProblemClass>
     struct DiagnosticManipulator : public StateManipulator <ProblemClass> {
     private:
-        // A reference to an existing state manipulator 
+        // Create some type shortcuts
+        typedef typename ProblemClass::X X;
+        typedef typename X::Vector X_Vector;
+
+        // A reference to an existing state manipulator
         StateManipulator <ProblemClass> const & smanip;
 
         // A reference to the messsaging object
         Messaging const & msg;
 
+        // Where we send the diagnostic information
+        TelemetrySink <Real> & sink;
+
+        // Storage for the headers and records, which we reuse between calls
+        mutable std::vector <std::string> names;
+        mutable TelemetryRecord <Real> record;
+
+        // Workspace for the diagnostic gradient
+        mutable std::unique_ptr <X_Vector> grad_diag;
+
     public:
         // Disallow constructors
         NO_COPY_ASSIGNMENT(DiagnosticManipulator)
 
-        // Create a reference to an existing manipulator 
+        // Create a reference to an existing manipulator
         explicit DiagnosticManipulator(
             StateManipulator <ProblemClass> const & smanip_,
-            Messaging const & msg_
-        ) : smanip(smanip_), msg(msg_) {}
+            Messaging const & msg_,
+            TelemetrySink <Real> & sink_
+        ) : smanip(smanip_), msg(msg_), sink(sink_), names(), record(),
+            grad_diag(nullptr)
+        {}
 
         // Application
         void eval(
@@ -1193,15 +1431,16 @@ namespace Optizelle{
             // Output the headers for the diagonstic information
             case OptimizationLocation::BeforeOptimizationLoop:
                 if(msg_level >= 1 &&dscheme!=DiagnosticScheme::DiagnosticsOnly){
-                    // Get the headers 
-                    std::list <std::string> out;
-                    ProblemClass::Diagnostics::getStateHeader(state,out);
-                    if(false && msg_level >= 3)
-                        ProblemClass::Diagnostics::getKrylovHeader(state,out);
-
-                    // Output the result
-                    msg.print(std::accumulate (
-                        out.begin(),out.end(),std::string()));
+                    // Get the headers
+                    names.clear();
+                    ProblemClass::Diagnostics::getStateHeader(state,names);
+                    sink.stateHeader(names);
+                    if(msg_level >= 3) {
+                        names.clear();
+                        ProblemClass::Diagnostics::getKrylovHeader(
+                            state,names);
+                        sink.krylovHeader(names);
+                    }
                 }
             // Output the overall state at the end of the optimization
             // iteration
@@ -1209,48 +1448,37 @@ namespace Optizelle{
             case OptimizationLocation::AfterRejectedTrustRegion:
             case OptimizationLocation::AfterRejectedLineSearch:
                 if(msg_level >= 1 &&dscheme!=DiagnosticScheme::DiagnosticsOnly){
+                    // Allocate the workspace for the diagnostic gradient the
+                    // first time through
+                    if(!grad_diag)
+                        grad_diag.reset(new X_Vector(X::init(state.grad)));
+
                     // Get the diagonstic information
-                    std::list <std::string> out;
-
-                    // Don't print out the iteration information if
-                    // we reject the step
-                    if(    loc==OptimizationLocation
-                            ::AfterRejectedTrustRegion
-                        || loc==OptimizationLocation
-                            ::AfterRejectedLineSearch
-                    )
-                        ProblemClass::Diagnostics
-                            ::getState(fns,state,false,true,out);
-                    else 
-                        ProblemClass::Diagnostics
-                            ::getState(fns,state,false,false,out);
+                    record.values.clear();
+                    ProblemClass::Diagnostics::getState(
+                        fns,state,*grad_diag,record.values);
 
-                    // Print out blank Krylov information 
-                    if(false && msg_level >=3)
-                        ProblemClass::Diagnostics::getKrylov(state,true,out);
+                    // Don't advance the iteration information if we reject
+                    // the step
+                    record.rejected =
+                           loc==OptimizationLocation::AfterRejectedTrustRegion
+                        || loc==OptimizationLocation::AfterRejectedLineSearch;
 
                     // Output the result
-                    msg.print(std::accumulate (
-                        out.begin(),out.end(),std::string()));
+                    sink.state(record);
                 }
                 break;
 
             // Output information at the end of each Krylov iteration
             case OptimizationLocation::EndOfKrylovIteration:
-                if(false && msg_level >= 3) {
+                if(msg_level >= 3) {
                     // Get the diagonstic information
-                    std::list <std::string> out;
-
-                    // Print out blank state information
-                    ProblemClass::Diagnostics::getState(
-                        fns,state,true,false,out);
-
-                    // Print out the Krylov information 
-                    ProblemClass::Diagnostics::getKrylov(state,false,out);
+                    record.values.clear();
+                    ProblemClass::Diagnostics::getKrylov(state,record.values);
+                    record.rejected = false;
 
                     // Output the result
-                    msg.print(std::accumulate (
-                        out.begin(),out.end(),std::string()));
+                    sink.krylov(record);
                 }
                 break;
 
@@ -1260,6 +1488,144 @@ namespace Optizelle{
         }
     };
 
+    // A state manipulator that announces new iterates to the functions that
+    // asked for them.  We announce both before and after the internal
+    // manipulator in case it moves the iterate.
+    template <typename ProblemClass>
+    struct LinearizationManipulator : public StateManipulator <ProblemClass> {
+    private:
+        // A reference to an existing state manipulator 
+        StateManipulator <ProblemClass> const & smanip;
+
+    public:
+        // Disallow constructors
+        NO_COPY_ASSIGNMENT(LinearizationManipulator)
+
+        // Create a reference to an existing manipulator 
+        explicit LinearizationManipulator(
+            StateManipulator <ProblemClass> const & smanip_
+        ) : smanip(smanip_) {}
+
+        // Application
+        void eval(
+            typename ProblemClass::Functions::t const & fns,
+            typename ProblemClass::State::t & state,
+            OptimizationLocation::t const & loc
+        ) const {
+            ProblemClass::Functions::linearize(fns,state);
+            smanip.eval(fns,state,loc);
+            ProblemClass::Functions::linearize(fns,state);
+        }
+    };
+
+    // A state manipulator that records the phases of the optimization in the
+    // trace.  Each phase begins at an optimization location and lasts until
+    // the next one.  The phase that begins at the end of the optimization
+    // is empty, so we only close the last phase there.
+    template <typename ProblemClass>
+    struct TracingManipulator : public StateManipulator <ProblemClass> {
+    private:
+        // A reference to an existing state manipulator
+        StateManipulator <ProblemClass> const & smanip;
+
+        // The phase that we're in and when it started
+        mutable char const * phase;
+        mutable std::uint64_t start;
+
+        // Names of the optimization locations.  These must outlive the
+        // trace, so we keep them around.
+        static char const * name(OptimizationLocation::t const & loc) {
+            static std::vector <std::string> const names = []() {
+                std::vector <std::string> names;
+                for(Natural i=0;i<=OptimizationLocation::EndOfOptimization;i++)
+                    names.emplace_back(OptimizationLocation::to_string(
+                        OptimizationLocation::t(i)));
+                return names;
+            }();
+            return names[loc].c_str();
+        }
+
+    public:
+        // Disallow constructors
+        NO_COPY_ASSIGNMENT(TracingManipulator)
+
+        // Create a reference to an existing manipulator
+        explicit TracingManipulator(
+            StateManipulator <ProblemClass> const & smanip_
+        ) : smanip(smanip_), phase(nullptr), start(0) {}
+
+        // Application
+        void eval(
+            typename ProblemClass::Functions::t const & fns,
+            typename ProblemClass::State::t & state,
+            OptimizationLocation::t const & loc
+        ) const {
+            // Close the current phase and start the next one
+            std::uint64_t const now = Trace::now();
+            if(phase)
+                Trace::record(phase,"location",start,now-start,true);
+            phase = loc==OptimizationLocation::EndOfOptimization
+                ? nullptr : name(loc);
+            start = now;
+
+            // Call the internal manipulator
+            smanip.eval(fns,state,loc);
+        }
+    };
+
+    // Raises EndOfKrylovIteration at the end of each iteration of a Krylov
+    // solve.  At this location, krylov_iter and krylov_rel_err describe the
+    // solve in progress and, when its iterations count toward the total,
+    // krylov_iter_total includes them.  Afterwards, we restore these, so that
+    // the algorithms record the Krylov information once the solve finishes
+    // as before.  The iterations of the augmented system solves in the
+    // composite-step method don't count toward the total.
+    template <typename Real,typename ProblemClass>
+    struct KrylovIterationManipulator : public KrylovManipulator <Real> {
+    private:
+        // A reference to an existing state manipulator
+        StateManipulator <ProblemClass> const & smanip;
+
+        // The functions and state that we hand to the manipulator
+        typename ProblemClass::Functions::t const & fns;
+        typename ProblemClass::State::t & state;
+
+        // Whether the iterations count toward krylov_iter_total
+        bool const counted;
+
+    public:
+        // Disallow constructors
+        NO_DEFAULT_COPY_ASSIGNMENT(KrylovIterationManipulator)
+
+        // Grab the manipulator, functions, and state on construction
+        KrylovIterationManipulator(
+            StateManipulator <ProblemClass> const & smanip_,
+            typename ProblemClass::Functions::t const & fns_,
+            typename ProblemClass::State::t & state_,
+            bool const & counted_
+        ) : smanip(smanip_), fns(fns_), state(state_), counted(counted_) {}
+
+        // Application
+        void eval(Natural const & iter,Real const & rel_err) const {
+            // Save the current Krylov information
+            Natural const krylov_iter = state.krylov_iter;
+            Natural const krylov_iter_total = state.krylov_iter_total;
+            Real const krylov_rel_err = state.krylov_rel_err;
+
+            // Describe the solve in progress and manipulate the state
+            state.krylov_iter = iter;
+            state.krylov_rel_err = rel_err;
+            if(counted)
+                state.krylov_iter_total += iter;
+            smanip.eval(fns,state,OptimizationLocation::EndOfKrylovIteration);
+
+            // Restore the Krylov information
+            state.krylov_iter = krylov_iter;
+            state.krylov_iter_total = krylov_iter_total;
+            state.krylov_rel_err = krylov_rel_err;
+        }
+    };
+
     // This converts one manipulator to another.  In theory, the dynamic
     // casting can fail, so make sure to only use this when compatibility
     // can be guaranteed.
@@ -1278,69 +1644,737 @@ namespace Optizelle{
             const StateManipulator <Internal>& smanip_
         ) : smanip(smanip_) {}
 
-        // Application
-        void eval(
-            const typename External::Functions::t& fns_,
-            typename External::State::t& state_,
-            OptimizationLocation::t const & loc
-        ) const {
-            const typename Internal::Functions::t& fns
-                =dynamic_cast <typename Internal::Functions::t const &> (fns_);
-            typename Internal::State::t& state 
-                =dynamic_cast <typename Internal::State::t &> (state_);
-            smanip.eval(fns,state,loc);
+        // Application
+        void eval(
+            const typename External::Functions::t& fns_,
+            typename External::State::t& state_,
+            OptimizationLocation::t const & loc
+        ) const {
+            const typename Internal::Functions::t& fns
+                =dynamic_cast <typename Internal::Functions::t const &> (fns_);
+            typename Internal::State::t& state 
+                =dynamic_cast <typename Internal::State::t &> (state_);
+            smanip.eval(fns,state,loc);
+        }
+    };
+
+    // Defines the type for the restart packages
+    template <typename T>
+    struct RestartPackage {
+        typedef std::pair <std::string,T> tuple;
+        typedef std::list <tuple> t;
+    };
+
+    // A series of utiilty functions used by the routines below.
+    namespace Utility {
+        // Checks whether all the items are actually valids inputs.  If not, it 
+        // throws an error.
+        template <typename T> 
+        void checkItems(
+            Messaging const & msg,
+            std::function <
+                bool(typename RestartPackage <T>::tuple const &) > is_item,
+            typename RestartPackage<T>::t const & items,
+            std::string const & kind
+        ) {
+            // Create a base message
+            const std::string base
+                ="During serialization, found an invalid ";
+
+            // Check the labels
+            typename RestartPackage<T>::t::const_iterator item
+                = find_if(items.begin(), items.end(),std::not1(is_item));
+
+            if(item!=items.end()) {
+                std::stringstream ss;
+                ss << base << kind << item->first;
+                msg.error(ss.str());
+            }
+        }
+
+        // Converts a variety of basic datatypes to strings
+        std::ostream& formatReal(std::ostream& out);
+        std::ostream& formatInt(std::ostream& out);
+        std::ostream& formatString(std::ostream& out); 
+
+        // Converts anything to a string.
+        std::string atos(const double& x);
+        std::string atos(Natural const & x);
+        std::string atos(std::string const & x);
+        std::string atos(KrylovStop::t const & x);
+
+        // Blank separator for printing
+        std::string const blankSeparator = ".           ";
+
+        // Accumulates the number of calls and the elapsed time, in seconds,
+        // between its creation and either a call to stop or its destruction.
+        // We use a monotonic clock, so changes to the system time don't
+        // affect the timings.
+        template <typename Real>
+        struct Timer {
+        private:
+            // Number of calls and total time
+            Natural & calls;
+            Real & time;
+
+            // Time when we started
+            std::chrono::steady_clock::time_point start;
+
+            // Whether or not we've already recorded the time
+            bool stopped;
+
+        public:
+            // Prevent constructors
+            NO_DEFAULT_COPY_ASSIGNMENT(Timer)
+
+            // Start the timer
+            Timer(Natural & calls_,Real & time_) :
+                calls(calls_),
+                time(time_),
+                start(std::chrono::steady_clock::now()),
+                stopped(false)
+            {}
+
+            // Stop the timer and record the call
+            void stop() {
+                if(stopped) return;
+                calls++;
+                time += std::chrono::duration <Real> (
+                    std::chrono::steady_clock::now()-start).count();
+                stopped=true;
+            }
+
+            // Record the call if we haven't already 
+            ~Timer() {
+                stop();
+            }
+        };
+    }
+
+    // Formats the telemetry as columns of text and prints it with a messaging
+    // object.  This is the output that we give by default.
+    template <typename Real>
+    struct TextTelemetry : public TelemetrySink <Real> {
+    private:
+        // A reference to the messsaging object
+        Messaging const & msg;
+
+        // Storage for the line that we print, which we reuse between calls
+        std::string line;
+
+        // Formats a single value
+        static std::string format(TelemetryValue <Real> const & value) {
+            switch(value.kind) {
+            case TelemetryKind::Integer:
+                return Utility::atos(value.integer);
+            case TelemetryKind::Number:
+                return Utility::atos(value.number);
+            case TelemetryKind::Stop:
+                return Utility::atos(value.stop);
+            default:
+                return Utility::blankSeparator;
+            }
+        }
+
+    public:
+        // Disallow constructors
+        NO_COPY_ASSIGNMENT(TextTelemetry)
+
+        // Print with the given messaging object
+        explicit TextTelemetry(Messaging const & msg_) : msg(msg_), line() {}
+
+        // Prints the names of the columns
+        void stateHeader(std::vector <std::string> const & names) {
+            line.clear();
+            for(auto const & name : names)
+                line+=Utility::atos(name);
+            msg.print(line);
+        }
+
+        // Prints a row of the state.  Rejected steps don't print the
+        // iteration.
+        void state(TelemetryRecord <Real> const & record) {
+            line.clear();
+            for(Natural i=0;i<record.values.size();i++)
+                line+= i==0 && record.rejected
+                    ? Utility::atos("*")
+                    : format(record.values[i]);
+            msg.print(line);
+        }
+
+        // We don't print the Krylov iterations
+        void krylovHeader(std::vector <std::string> const & names) {}
+        void krylov(TelemetryRecord <Real> const & record) {}
+    };
+
+    // A scalar-valued function that times and traces each of its calls.  We
+    // use this to instrument the user-defined objective.
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    struct TimedScalarValuedFunction : public ScalarValuedFunction <Real,XX> {
+    private:
+        // Create some type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector X_Vector;
+
+        // Underlying function
+        std::unique_ptr <ScalarValuedFunction <Real,XX> > f;
+
+        // Counters and timers for each of the calls
+        Natural & eval_calls;
+        Real & eval_time;
+        Natural & grad_calls;
+        Real & grad_time;
+        Natural & hessvec_calls;
+        Real & hessvec_time;
+
+    public:
+        // Prevent constructors 
+        NO_DEFAULT_COPY_ASSIGNMENT(TimedScalarValuedFunction)
+
+        // Take ownership of the function and grab the counters
+        TimedScalarValuedFunction(
+            std::unique_ptr <ScalarValuedFunction <Real,XX> > && f_,
+            Natural & eval_calls_,
+            Real & eval_time_,
+            Natural & grad_calls_,
+            Real & grad_time_,
+            Natural & hessvec_calls_,
+            Real & hessvec_time_
+        ) : f(std::move(f_)),
+            eval_calls(eval_calls_),
+            eval_time(eval_time_),
+            grad_calls(grad_calls_),
+            grad_time(grad_time_),
+            hessvec_calls(hessvec_calls_),
+            hessvec_time(hessvec_time_)
+        {}
+
+        // <- f(x) 
+        Real eval(X_Vector const & x) const {
+            OPTIZELLE_TIMER(timer,eval_calls,eval_time)
+            OPTIZELLE_TRACE(trace,"f.eval","user")
+            return f->eval(x);
+        }
+
+        // grad = grad f(x) 
+        void grad(X_Vector const & x,X_Vector & grad) const {
+            OPTIZELLE_TIMER(timer,grad_calls,grad_time)
+            OPTIZELLE_TRACE(trace,"f.grad","user")
+            f->grad(x,grad);
+        }
+
+        // H_dx = hess f(x) dx 
+        void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+            const
+        {
+            OPTIZELLE_TIMER(timer,hessvec_calls,hessvec_time)
+            OPTIZELLE_TRACE(trace,"f.hessvec","user")
+            f->hessvec(x,dx,H_dx);
+        }
+
+        // H = hess f(x), which we count as a Hessian-vector product
+        bool hessian(X_Vector const & x,std::vector <Real> & H) const {
+            OPTIZELLE_TIMER(timer,hessvec_calls,hessvec_time)
+            OPTIZELLE_TRACE(trace,"f.hessian","user")
+            return f->hessian(x,H);
+        }
+    };
+
+    // A vector-valued function that times and traces each of its calls.  We
+    // use this to instrument the user-defined constraints.
+    template <
+        typename Real,
+        template <typename> class XX,
+        template <typename> class YY 
+    >
+    struct TimedVectorValuedFunction : public VectorValuedFunction <Real,XX,YY>
+    {
+    private:
+        // Create some type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector X_Vector; 
+        typedef YY <Real> Y;
+        typedef typename Y::Vector Y_Vector; 
+
+        // Underlying function
+        std::unique_ptr <VectorValuedFunction <Real,XX,YY> > f;
+
+        // Counters and timers for each of the calls
+        Natural & eval_calls;
+        Real & eval_time;
+        Natural & p_calls;
+        Real & p_time;
+        Natural & ps_calls;
+        Real & ps_time;
+        Natural & pps_calls;
+        Real & pps_time;
+
+        // Names of eval, p, ps, and pps in the trace
+        std::array <char const *,4> names;
+
+    public:
+        // Prevent constructors 
+        NO_DEFAULT_COPY_ASSIGNMENT(TimedVectorValuedFunction)
+
+        // Take ownership of the function and grab the counters
+        TimedVectorValuedFunction(
+            std::unique_ptr <VectorValuedFunction <Real,XX,YY> > && f_,
+            Natural & eval_calls_,
+            Real & eval_time_,
+            Natural & p_calls_,
+            Real & p_time_,
+            Natural & ps_calls_,
+            Real & ps_time_,
+            Natural & pps_calls_,
+            Real & pps_time_,
+            std::array <char const *,4> const & names_
+        ) : f(std::move(f_)),
+            eval_calls(eval_calls_),
+            eval_time(eval_time_),
+            p_calls(p_calls_),
+            p_time(p_time_),
+            ps_calls(ps_calls_),
+            ps_time(ps_time_),
+            pps_calls(pps_calls_),
+            pps_time(pps_time_),
+            names(names_)
+        {}
+
+        // y=f(x)
+        void eval(X_Vector const & x,Y_Vector & y) const {
+            OPTIZELLE_TIMER(timer,eval_calls,eval_time)
+            OPTIZELLE_TRACE(trace,names[0],"user")
+            f->eval(x,y);
+        }
+
+        // y=f'(x)dx 
+        void p(X_Vector const & x,X_Vector const & dx,Y_Vector & y) const {
+            OPTIZELLE_TIMER(timer,p_calls,p_time)
+            OPTIZELLE_TRACE(trace,names[1],"user")
+            f->p(x,dx,y);
+        }
+
+        // z=f'(x)*dy
+        void ps(X_Vector const & x,Y_Vector const & dy,X_Vector & z) const {
+            OPTIZELLE_TIMER(timer,ps_calls,ps_time)
+            OPTIZELLE_TRACE(trace,names[2],"user")
+            f->ps(x,dy,z);
+        }
+
+        // z=(f''(x)dx)*dy
+        void pps(
+            X_Vector const & x,
+            X_Vector const & dx,
+            Y_Vector const & dy,
+            X_Vector & z
+        ) const {
+            OPTIZELLE_TIMER(timer,pps_calls,pps_time)
+            OPTIZELLE_TRACE(trace,names[3],"user")
+            f->pps(x,dx,dy,z);
+        }
+    };
+
+    // An operator that times and traces each of its applications.  We use
+    // this to instrument the preconditioners.
+    template <
+        typename Real,
+        template <typename> class XX,
+        template <typename> class YY
+    >
+    struct TimedOperator : public Operator <Real,XX,YY> {
+    private:
+        // Create some type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector X_Vector;
+        typedef YY <Real> Y;
+        typedef typename Y::Vector Y_Vector;
+
+        // Underlying operator
+        std::unique_ptr <Operator <Real,XX,YY> > A;
+
+        // Counter and timer for the applications
+        Natural & calls;
+        Real & time;
+
+        // Name of the operator in the trace
+        char const * name;
+
+    public:
+        // Prevent constructors 
+        NO_DEFAULT_COPY_ASSIGNMENT(TimedOperator)
+
+        // Take ownership of the operator and grab the counters
+        TimedOperator(
+            std::unique_ptr <Operator <Real,XX,YY> > && A_,
+            Natural & calls_,
+            Real & time_,
+            char const * const name_
+        ) : A(std::move(A_)), calls(calls_), time(time_), name(name_) {}
+
+        // y = A(x)
+        void eval(X_Vector const & x,Y_Vector & y) const {
+            OPTIZELLE_TIMER(timer,calls,time)
+            OPTIZELLE_TRACE(trace,name,"user")
+            A->eval(x,y);
+        }
+    };
+
+    namespace Utility {
+        // Values of a function at the two points where we most recently
+        // computed it.  Normally, these are the current iterate and a trial
+        // point.
+        template <
+            typename Real,
+            template <typename> class XX,
+            typename Value
+        >
+        struct MemoizedValues {
+        private:
+            // Create some type shortcuts
+            typedef XX <Real> X;
+            typedef typename X::Vector X_Vector;
+
+            // Points and values
+            VersionedCache <Real,XX> x0;
+            VersionedCache <Real,XX> x1;
+            Value value0;
+            Value value1;
+
+            // Which of the points we used most recently 
+            Natural last;
+
+        public:
+            // Disallow constructors
+            NO_DEFAULT_COPY_ASSIGNMENT(MemoizedValues)
+
+            // Track the iterate and its version token.  The values only
+            // initialize memory.
+            MemoizedValues(
+                X_Vector const & x,
+                Natural const & x_version,
+                Value && value0_,
+                Value && value1_
+            ) : x0(x,x_version), x1(x,x_version), value0(std::move(value0_)),
+                value1(std::move(value1_)), last(1)
+            {}
+
+            // Returns the value at x when we have it and nullptr otherwise 
+            Value const * find(X_Vector const & x) {
+                if(x0.current(x)) {
+                    last=0;
+                    return &value0;
+                } else if(x1.current(x)) {
+                    last=1;
+                    return &value1;
+                }
+                return nullptr;
+            }
+
+            // Returns memory for a new value, which replaces the least
+            // recently used one
+            Value & next() {
+                last=1-last;
+                (last==0 ? x0 : x1).reset();
+                return last==0 ? value0 : value1;
+            }
+
+            // Records that the new value corresponds to x
+            void record(X_Vector const & x) {
+                (last==0 ? x0 : x1).update(x);
+            }
+        };
+    }
+
+    // A scalar-valued function that remembers its value and gradient at the
+    // current iterate and the most recent trial point.  This removes repeated
+    // evaluations at the same point, which happen, for example, between the
+    // globalization and the gradient at the new iterate.  The iterate and its
+    // version token come from the optimization state.
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    struct MemoizedScalarValuedFunction
+        : public ScalarValuedFunction <Real,XX>,
+          public LinearizationSession <Real,XX>
+    {
+    private:
+        // Create some type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector X_Vector;
+
+        // Underlying function
+        std::unique_ptr <ScalarValuedFunction <Real,XX> > f;
+
+        // Underlying function's interest in new iterates
+        LinearizationSession <Real,XX> * f_session;
+
+        // Cached values and gradients
+        mutable Utility::MemoizedValues <Real,XX,Real> f_x;
+        mutable Utility::MemoizedValues <Real,XX,X_Vector> grad_x;
+
+    public:
+        // Prevent constructors 
+        NO_DEFAULT_COPY_ASSIGNMENT(MemoizedScalarValuedFunction)
+
+        // Take ownership of the function and track the iterate
+        MemoizedScalarValuedFunction(
+            std::unique_ptr <ScalarValuedFunction <Real,XX> > && f_,
+            X_Vector const & x,
+            Natural const & x_version
+        ) : f(std::move(f_)),
+            f_session(dynamic_cast <LinearizationSession <Real,XX> *> (
+                f.get())),
+            f_x(x,x_version,Real(0.),Real(0.)),
+            grad_x(x,x_version,X::init(x),X::init(x))
+        {}
+
+        // Pass the new iterate along
+        void linearize(X_Vector const & x,Natural const & x_version) {
+            if(f_session!=nullptr) f_session->announce(x,x_version);
+        }
+
+        // <- f(x) 
+        Real eval(X_Vector const & x) const {
+            if(Real const * const cached=f_x.find(x))
+                return *cached;
+            Real & f_x_new=f_x.next();
+            f_x_new=f->eval(x);
+            f_x.record(x);
+            return f_x_new;
+        }
+
+        // grad = grad f(x) 
+        void grad(X_Vector const & x,X_Vector & grad) const {
+            if(X_Vector const * const cached=grad_x.find(x)) {
+                X::copy(*cached,grad);
+                return;
+            }
+            X_Vector & grad_new=grad_x.next();
+            f->grad(x,grad_new);
+            grad_x.record(x);
+            X::copy(grad_new,grad);
+        }
+
+        // H_dx = hess f(x) dx 
+        void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+            const
+        {
+            f->hessvec(x,dx,H_dx);
+        }
+
+        // H = hess f(x)
+        bool hessian(X_Vector const & x,std::vector <Real> & H) const {
+            return f->hessian(x,H);
+        }
+    };
+
+    // A vector-valued function that remembers its value at the current
+    // iterate and the most recent trial point
+    template <
+        typename Real,
+        template <typename> class XX,
+        template <typename> class YY 
+    >
+    struct MemoizedVectorValuedFunction
+        : public VectorValuedFunction <Real,XX,YY>,
+          public LinearizationSession <Real,XX>
+    {
+    private:
+        // Create some type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector X_Vector; 
+        typedef YY <Real> Y;
+        typedef typename Y::Vector Y_Vector; 
+
+        // Underlying function
+        std::unique_ptr <VectorValuedFunction <Real,XX,YY> > f;
+
+        // Underlying function's interest in new iterates
+        LinearizationSession <Real,XX> * f_session;
+
+        // Cached values
+        mutable Utility::MemoizedValues <Real,XX,Y_Vector> f_x;
+
+    public:
+        // Prevent constructors 
+        NO_DEFAULT_COPY_ASSIGNMENT(MemoizedVectorValuedFunction)
+
+        // Take ownership of the function and track the iterate.  The vector
+        // y only initializes memory.
+        MemoizedVectorValuedFunction(
+            std::unique_ptr <VectorValuedFunction <Real,XX,YY> > && f_,
+            X_Vector const & x,
+            Natural const & x_version,
+            Y_Vector const & y
+        ) : f(std::move(f_)),
+            f_session(dynamic_cast <LinearizationSession <Real,XX> *> (
+                f.get())),
+            f_x(x,x_version,Y::init(y),Y::init(y))
+        {}
+
+        // Pass the new iterate along
+        void linearize(X_Vector const & x,Natural const & x_version) {
+            if(f_session!=nullptr) f_session->announce(x,x_version);
+        }
+
+        // y=f(x)
+        void eval(X_Vector const & x,Y_Vector & y) const {
+            if(Y_Vector const * const cached=f_x.find(x)) {
+                Y::copy(*cached,y);
+                return;
+            }
+            Y_Vector & y_new=f_x.next();
+            f->eval(x,y_new);
+            f_x.record(x);
+            Y::copy(y_new,y);
+        }
+
+        // y=f'(x)dx 
+        void p(X_Vector const & x,X_Vector const & dx,Y_Vector & y) const {
+            f->p(x,dx,y);
+        }
+
+        // z=f'(x)*dy
+        void ps(X_Vector const & x,Y_Vector const & dy,X_Vector & z) const {
+            f->ps(x,dy,z);
+        }
+
+        // z=(f''(x)dx)*dy
+        void pps(
+            X_Vector const & x,
+            X_Vector const & dx,
+            Y_Vector const & dy,
+            X_Vector & z
+        ) const {
+            f->pps(x,dx,dy,z);
+        }
+    };
+       
+    // Determines whether the vector space XX exposes the coordinates of its
+    // vectors in an orthonormal basis, which lets us work with dense matrices
+    // on the space.  This requires the vector space to provide the functions
+    //
+    // // Number of coordinates of x
+    // static Natural dim(Vector const & x);
+    //
+    // // Pointer to the coordinates of x
+    // static Real * coords(Vector & x);
+    // static Real const * coords(Vector const & x);
+    template <typename Real,template <typename> class XX>
+    struct HasDenseCoordinates {
+    private:
+        template <typename X>
+        static std::true_type test(decltype(&X::dim));
+        template <typename X>
+        static std::false_type test(...);
+    public:
+        static bool const value = decltype(test <XX <Real> > (nullptr))::value;
+    };
+
+    // Solves trust-region subproblems with the dense Hessian of the
+    // objective.  This is the fallback for vector spaces without dense
+    // coordinates, where we never have a dense Hessian and always use the
+    // Krylov methods.
+    template <
+        typename Real,
+        template <typename> class XX,
+        bool available_ = HasDenseCoordinates <Real,XX>::value
+    >
+    struct DenseTrustRegion {
+        // Prevent constructors 
+        NO_DEFAULT_COPY_ASSIGNMENT(DenseTrustRegion)
+
+        // Grab and factor the Hessian of f at x when possible
+        DenseTrustRegion(
+            ScalarValuedFunction <Real,XX> const & f,
+            typename XX <Real>::Vector const & x,
+            typename XX <Real>::Vector const & grad,
+            Natural const & dense_size_max
+        ) {}
+
+        // Whether we solve the subproblem directly
+        bool available() const {
+            return false;
         }
-    };
 
-    // Defines the type for the restart packages
-    template <typename T>
-    struct RestartPackage {
-        typedef std::pair <std::string,T> tuple;
-        typedef std::list <tuple> t;
+        // Solves the subproblem with the trust-region radius delta
+        void solve(
+            Real const & delta,
+            Natural const & iter_max,
+            typename XX <Real>::Vector & dx,
+            Natural & iter,
+            KrylovStop::t & krylov_stop
+        ) {}
     };
 
-    // A series of utiilty functions used by the routines below.
-    namespace Utility {
-        // Checks whether all the items are actually valids inputs.  If not, it 
-        // throws an error.
-        template <typename T> 
-        void checkItems(
-            Messaging const & msg,
-            std::function <
-                bool(typename RestartPackage <T>::tuple const &) > is_item,
-            typename RestartPackage<T>::t const & items,
-            std::string const & kind
-        ) {
-            // Create a base message
-            const std::string base
-                ="During serialization, found an invalid ";
+    // Solves trust-region subproblems with the dense Hessian of the objective
+    // when the vector space has dense coordinates.  We factor the Hessian once
+    // per step, so finding a new step after we reject one is cheap.
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    struct DenseTrustRegion <Real,XX,true> {
+    private:
+        // Create some type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector X_Vector;
 
-            // Check the labels
-            typename RestartPackage<T>::t::const_iterator item
-                = find_if(items.begin(), items.end(),std::not1(is_item));
+        // Factored subproblem, which we only have when the objective
+        // provides its Hessian and the problem is small enough
+        std::unique_ptr <MoreSorensen <Real> > subproblem;
 
-            if(item!=items.end()) {
-                std::stringstream ss;
-                ss << base << kind << item->first;
-                msg.error(ss.str());
-            }
+    public:
+        // Prevent constructors 
+        NO_DEFAULT_COPY_ASSIGNMENT(DenseTrustRegion)
+
+        // Grab and factor the Hessian of f at x when possible
+        DenseTrustRegion(
+            ScalarValuedFunction <Real,XX> const & f,
+            X_Vector const & x,
+            X_Vector const & grad,
+            Natural const & dense_size_max
+        ) : subproblem(nullptr) {
+            Natural const m = X::dim(x);
+            if(m==0 || m > dense_size_max)
+                return;
+            OPTIZELLE_TRACE(trace,"dense","solver")
+            std::vector <Real> H(m*m);
+            if(f.hessian(x,H))
+                subproblem.reset(new MoreSorensen <Real> (m,&(H[0]),
+                    X::coords(grad)));
         }
 
-        // Converts a variety of basic datatypes to strings
-        std::ostream& formatReal(std::ostream& out);
-        std::ostream& formatInt(std::ostream& out);
-        std::ostream& formatString(std::ostream& out); 
+        // Whether we solve the subproblem directly
+        bool available() const {
+            return subproblem.get()!=nullptr;
+        }
 
-        // Converts anything to a string.
-        std::string atos(const double& x);
-        std::string atos(Natural const & x);
-        std::string atos(std::string const & x);
-        std::string atos(KrylovStop::t const & x);
+        // Solves the subproblem with the trust-region radius delta.  As
+        // Moré and Sorensen recommend, a step within 10% of the radius is
+        // close enough to the boundary.  We report a solution on the boundary
+        // in the same way as the Krylov methods, so that the trust-region
+        // grows afterwards.
+        void solve(
+            Real const & delta,
+            Natural const & iter_max,
+            X_Vector & dx,
+            Natural & iter,
+            KrylovStop::t & krylov_stop
+        ) {
+            Real lambda(0.);
+            bool boundary(false);
+            iter = subproblem->solve(delta,Real(0.1),iter_max,
+                X::coords(dx),lambda,boundary);
+            krylov_stop = boundary ? KrylovStop::TrustRegionViolated :
+                KrylovStop::RelativeErrorSmall;
+        }
+    };
 
-        // Blank separator for printing
-        std::string const blankSeparator = ".           ";
-    }
-       
     // Routines that manipulate and support problems of the form
     // 
     // min_{x \in X} f(x)
@@ -1410,6 +2444,11 @@ namespace Optizelle{
                 // quasi-Newton methods
                 Natural history_reset;
 
+                // Precision used to store the history for quasi-Newton methods.
+                // Compressed stores it in the lower precision when the vector
+                // space can convert between precisions.  Mixed isn't valid.
+                KrylovPrecision::t history_precision;
+
                 // Current iteration
                 Natural iter;
 
@@ -1444,6 +2483,14 @@ namespace Optizelle{
                 // Truncated Krylov solver
                 KrylovSolverTruncated::t krylov_solver;
 
+                // Precision used for the iterations of the Krylov methods
+                KrylovPrecision::t krylov_precision;
+
+                // Largest number of variables where we solve the
+                // trust-region subproblem with a dense factorization of the
+                // Hessian when the objective provides one
+                Natural dense_size_max;
+
                 // Algorithm class
                 AlgorithmClass::t algorithm_class;
 
@@ -1461,6 +2508,15 @@ namespace Optizelle{
 
                 // Optimization variable 
                 X_Vector x; 
+
+                // Version tokens.  Each time the algorithms modify x, y, or z,
+                // they assign the corresponding token a fresh value drawn
+                // from version.  Cached computations at these variables
+                // compare tokens rather than vectors.  Since we never reuse a
+                // value, we may safely restore an old token along with an
+                // old value of the variable.
+                Natural version;
+                Natural x_version;
                 
                 // Gradient of the objective
                 X_Vector grad;
@@ -1483,6 +2539,12 @@ namespace Optizelle{
                 // Difference in prior steps
                 std::list <X_Vector> oldS;
 
+                // Difference in prior gradients and steps when we store them
+                // in the lower precision.  In this case, oldY and oldS stay
+                // empty while we optimize.
+                CompressedList <Real,XX> oldY_compressed;
+                CompressedList <Real,XX> oldS_compressed;
+
                 // Current value of the objective function 
                 Real f_x;
 
@@ -1549,6 +2611,37 @@ namespace Optizelle{
                 // Diagnostic scheme 
                 DiagnosticScheme::t dscheme;
 
+                // Number of evaluations of the objective
+                Natural f_eval_calls;
+
+                // Time spent evaluating the objective
+                Real f_eval_time;
+
+                // Number of evaluations of the gradient of the objective
+                Natural f_grad_calls;
+
+                // Time spent evaluating the gradient of the objective
+                Real f_grad_time;
+
+                // Number of Hessian-vector products of the objective
+                Natural f_hessvec_calls;
+
+                // Time spent computing Hessian-vector products of the objective
+                Real f_hessvec_time;
+
+                // Number of applications of the preconditioner for the Hessian
+                Natural PH_calls;
+
+                // Time spent applying the preconditioner for the Hessian
+                Real PH_time;
+
+                // Number of Krylov solves
+                Natural krylov_calls;
+
+                // Time spent in the Krylov solves.  This includes the operator
+                // and preconditioner applications made during the solves.
+                Real krylov_time;
+
                 // Initialization constructors
                 explicit t(X_Vector const & x_user) :
                     eps_grad(
@@ -1571,6 +2664,11 @@ namespace Optizelle{
                         5
                         //---history_reset1---
                     ),
+                    history_precision(
+                        //---history_precision0---
+                        KrylovPrecision::Full
+                        //---history_precision1---
+                    ),
                     iter(
                         //---iter0---
                         1
@@ -1626,6 +2724,16 @@ namespace Optizelle{
                         KrylovSolverTruncated::ConjugateDirection
                         //---krylov_solver1---
                     ),
+                    krylov_precision(
+                        //---krylov_precision0---
+                        KrylovPrecision::Full
+                        //---krylov_precision1---
+                    ),
+                    dense_size_max(
+                        //---dense_size_max0---
+                        50
+                        //---dense_size_max1---
+                    ),
                     algorithm_class(
                         //---algorithm_class0---
                         AlgorithmClass::TrustRegion
@@ -1652,6 +2760,8 @@ namespace Optizelle{
                         //---norm_dxtyp1---
                     ),
                     x(X::init(x_user)),
+                    version(0),
+                    x_version(0),
                     grad(
                         //---grad0---
                         X::init(x_user)
@@ -1687,6 +2797,8 @@ namespace Optizelle{
                         // Empty
                         //---oldS1--- 
                     ), 
+                    oldY_compressed(),
+                    oldS_compressed(),
                     f_x(
                         //---f_x0---
                         std::numeric_limits<Real>::quiet_NaN()
@@ -1786,6 +2898,56 @@ namespace Optizelle{
                         //---dscheme0---
                         DiagnosticScheme::Never
                         //---dscheme1---
+                    ),
+                    f_eval_calls(
+                        //---f_eval_calls0---
+                        0
+                        //---f_eval_calls1---
+                    ),
+                    f_eval_time(
+                        //---f_eval_time0---
+                        0.
+                        //---f_eval_time1---
+                    ),
+                    f_grad_calls(
+                        //---f_grad_calls0---
+                        0
+                        //---f_grad_calls1---
+                    ),
+                    f_grad_time(
+                        //---f_grad_time0---
+                        0.
+                        //---f_grad_time1---
+                    ),
+                    f_hessvec_calls(
+                        //---f_hessvec_calls0---
+                        0
+                        //---f_hessvec_calls1---
+                    ),
+                    f_hessvec_time(
+                        //---f_hessvec_time0---
+                        0.
+                        //---f_hessvec_time1---
+                    ),
+                    PH_calls(
+                        //---PH_calls0---
+                        0
+                        //---PH_calls1---
+                    ),
+                    PH_time(
+                        //---PH_time0---
+                        0.
+                        //---PH_time1---
+                    ),
+                    krylov_calls(
+                        //---krylov_calls0---
+                        0
+                        //---krylov_calls1---
+                    ),
+                    krylov_time(
+                        //---krylov_time0---
+                        0.
+                        //---krylov_time1---
                     )
                 {
                         //---x0---
@@ -1830,6 +2992,17 @@ namespace Optizelle{
                     //---history_reset_valid0---
                     // Any 
                     //---history_reset_valid1---
+
+                // Check that we store the quasi-Newton history in a single
+                // precision
+                else if(!(
+                    //---history_precision_valid0---
+                    state.history_precision!=KrylovPrecision::Mixed
+                    //---history_precision_valid1---
+                ))
+                    ss << "The precision of the quasi-Newton history must be "
+                        "Full or Compressed: history_precision = "
+                        << KrylovPrecision::to_string(state.history_precision);
         
                 // Check that the current iteration is positive
                 else if(!(
@@ -1904,6 +3077,14 @@ namespace Optizelle{
                     // Any 
                     //---krylov_solver_valid1---
                     
+                    //---krylov_precision_valid0---
+                    // Any 
+                    //---krylov_precision_valid1---
+                    
+                    //---dense_size_max_valid0---
+                    // Any 
+                    //---dense_size_max_valid1---
+                    
                     //---algorithm_class_valid0---
                     // Any 
                     //---algorithm_class_valid1---
@@ -2124,12 +3305,98 @@ namespace Optizelle{
                     // Any 
                     //---dscheme_valid1---
 
+                    //---f_eval_calls_valid0---
+                    // Any
+                    //---f_eval_calls_valid1---
+
+                    //---f_eval_time_valid0---
+                    // Any
+                    //---f_eval_time_valid1---
+
+                    //---f_grad_calls_valid0---
+                    // Any
+                    //---f_grad_calls_valid1---
+
+                    //---f_grad_time_valid0---
+                    // Any
+                    //---f_grad_time_valid1---
+
+                    //---f_hessvec_calls_valid0---
+                    // Any
+                    //---f_hessvec_calls_valid1---
+
+                    //---f_hessvec_time_valid0---
+                    // Any
+                    //---f_hessvec_time_valid1---
+
+                    //---PH_calls_valid0---
+                    // Any
+                    //---PH_calls_valid1---
+
+                    //---PH_time_valid0---
+                    // Any
+                    //---PH_time_valid1---
+
+                    //---krylov_calls_valid0---
+                    // Any
+                    //---krylov_calls_valid1---
+
+                    //---krylov_time_valid0---
+                    // Any
+                    //---krylov_time_valid1---
+
                 // If there's an error, print it
                 if(ss.str()!="") msg.error(ss.str());
             }
             static void check(Messaging const & msg,t const & state) {
                 Unconstrained <Real,XX>::State::check_(msg,state);
             }
+
+            // Determines whether we store the quasi-Newton history in the
+            // lower precision
+            static bool compressHistory(t const & state) {
+                return state.history_precision==KrylovPrecision::Compressed
+                    && CompressedList <Real,XX>::available;
+            }
+
+            // Moves the quasi-Newton history into the storage that
+            // history_precision asks for.  Compressing a vector rounds it, so
+            // switching back to the working precision doesn't recover the
+            // lost digits.
+            static void storeHistory(t & state) {
+                if(compressHistory(state)) {
+                    for(typename std::list <X_Vector>::const_iterator
+                            y=state.oldY.begin();
+                        y!=state.oldY.end();
+                        y++
+                    )
+                        state.oldY_compressed.push_back(*y);
+                    for(typename std::list <X_Vector>::const_iterator
+                            s=state.oldS.begin();
+                        s!=state.oldS.end();
+                        s++
+                    )
+                        state.oldS_compressed.push_back(*s);
+                    state.oldY.clear();
+                    state.oldS.clear();
+                } else
+                    expandHistory(state);
+            }
+
+            // Moves any quasi-Newton history stored in the lower precision
+            // into oldY and oldS
+            static void expandHistory(t & state) {
+                for(Natural i=0;i<state.oldY_compressed.size();i++) {
+                    state.oldY.emplace_back(std::move(X::init(state.x)));
+                    state.oldY_compressed.expand(i,state.oldY.back());
+                }
+                for(Natural i=0;i<state.oldS_compressed.size();i++) {
+                    state.oldS.emplace_back(std::move(X::init(state.x)));
+                    state.oldS_compressed.expand(i,state.oldS.back());
+                }
+                state.oldY_compressed.clear();
+                state.oldS_compressed.clear();
+            }
         };
 
         // Utilities for restarting the optimization
@@ -2163,7 +3430,12 @@ namespace Optizelle{
                     item.first == "alpha0" || 
                     item.first == "alpha" || 
                     item.first == "c1" || 
-                    item.first == "eps_ls"
+                    item.first == "eps_ls" ||
+                    item.first == "f_eval_time" ||
+                    item.first == "f_grad_time" ||
+                    item.first == "f_hessvec_time" ||
+                    item.first == "PH_time" ||
+                    item.first == "krylov_time"
                 ) 
                     return true;
                 else
@@ -2182,11 +3454,17 @@ namespace Optizelle{
                     item.first == "krylov_iter_max" ||
                     item.first == "krylov_iter_total" || 
                     item.first == "krylov_orthog_max" ||
+                    item.first == "dense_size_max" ||
                     item.first == "msg_level" ||
                     item.first == "rejected_trustregion" || 
                     item.first == "linesearch_iter" || 
                     item.first == "linesearch_iter_max" ||
-                    item.first == "linesearch_iter_total" 
+                    item.first == "linesearch_iter_total" ||
+                    item.first == "f_eval_calls" ||
+                    item.first == "f_grad_calls" ||
+                    item.first == "f_hessvec_calls" ||
+                    item.first == "PH_calls" ||
+                    item.first == "krylov_calls"
                 ) 
                     return true;
                 else
@@ -2199,6 +3477,10 @@ namespace Optizelle{
             ){
                 if( (item.first=="krylov_solver" &&
                         KrylovSolverTruncated::is_valid(item.second)) ||
+                    (item.first=="krylov_precision" &&
+                        KrylovPrecision::is_valid(item.second)) ||
+                    (item.first=="history_precision" &&
+                        KrylovPrecision::is_valid(item.second)) ||
                     (item.first=="algorithm_class" &&
                         AlgorithmClass::is_valid(item.second)) ||
                     (item.first=="opt_stop" &&
@@ -2265,6 +3547,10 @@ namespace Optizelle{
                 typename State::t & state, 
                 X_Vectors & xs
             ) {
+                // We always write the quasi-Newton information in the working
+                // precision
+                State::expandHistory(state);
+
                 xs.emplace_back("x",std::move(state.x));
                 xs.emplace_back("grad",std::move(state.grad));
                 xs.emplace_back("dx",std::move(state.dx));
@@ -2326,6 +3612,12 @@ namespace Optizelle{
                 reals.emplace_back("alpha",std::move(state.alpha));
                 reals.emplace_back("c1",std::move(state.c1));
                 reals.emplace_back("eps_ls",std::move(state.eps_ls));
+                reals.emplace_back("f_eval_time",std::move(state.f_eval_time));
+                reals.emplace_back("f_grad_time",std::move(state.f_grad_time));
+                reals.emplace_back("f_hessvec_time",
+                    std::move(state.f_hessvec_time));
+                reals.emplace_back("PH_time",std::move(state.PH_time));
+                reals.emplace_back("krylov_time",std::move(state.krylov_time));
 
                 // Copy in all the natural numbers
                 nats.emplace_back("stored_history",
@@ -2341,6 +3633,8 @@ namespace Optizelle{
                     std::move(state.krylov_iter_total));
                 nats.emplace_back("krylov_orthog_max",
                     std::move(state.krylov_orthog_max));
+                nats.emplace_back("dense_size_max",
+                    std::move(state.dense_size_max));
                 nats.emplace_back("msg_level",std::move(state.msg_level));
                 nats.emplace_back("rejected_trustregion",
                     std::move(state.rejected_trustregion));
@@ -2350,10 +3644,20 @@ namespace Optizelle{
                     std::move(state.linesearch_iter_max));
                 nats.emplace_back("linesearch_iter_total",
                     std::move(state.linesearch_iter_total));
+                nats.emplace_back("f_eval_calls",std::move(state.f_eval_calls));
+                nats.emplace_back("f_grad_calls",std::move(state.f_grad_calls));
+                nats.emplace_back("f_hessvec_calls",
+                    std::move(state.f_hessvec_calls));
+                nats.emplace_back("PH_calls",std::move(state.PH_calls));
+                nats.emplace_back("krylov_calls",std::move(state.krylov_calls));
 
                 // Copy in all the parameters
                 params.emplace_back("krylov_solver",
                     KrylovSolverTruncated::to_string(state.krylov_solver));
+                params.emplace_back("krylov_precision",
+                    KrylovPrecision::to_string(state.krylov_precision));
+                params.emplace_back("history_precision",
+                    KrylovPrecision::to_string(state.history_precision));
                 params.emplace_back("algorithm_class",
                     AlgorithmClass::to_string(state.algorithm_class));
                 params.emplace_back("opt_stop",
@@ -2388,9 +3692,10 @@ namespace Optizelle{
                     item!=xs.end();
                     item++
                 ){
-                    if(item->first=="x") 
+                    if(item->first=="x") {
                         state.x = std::move(item->second);
-                    else if(item->first=="grad")
+                        state.x_version=++state.version;
+                    } else if(item->first=="grad")
                         state.grad = std::move(item->second);
                     else if(item->first=="dx")
                         state.dx = std::move(item->second);
@@ -2454,6 +3759,16 @@ namespace Optizelle{
                         state.c1=std::move(item->second);
                     else if(item->first=="eps_ls")
                         state.eps_ls=std::move(item->second);
+                    else if(item->first=="f_eval_time")
+                        state.f_eval_time=std::move(item->second);
+                    else if(item->first=="f_grad_time")
+                        state.f_grad_time=std::move(item->second);
+                    else if(item->first=="f_hessvec_time")
+                        state.f_hessvec_time=std::move(item->second);
+                    else if(item->first=="PH_time")
+                        state.PH_time=std::move(item->second);
+                    else if(item->first=="krylov_time")
+                        state.krylov_time=std::move(item->second);
                 }
             
                 // Next, copy in any naturals
@@ -2477,6 +3792,8 @@ namespace Optizelle{
                         state.krylov_iter_total=std::move(item->second);
                     else if(item->first=="krylov_orthog_max")
                         state.krylov_orthog_max=std::move(item->second);
+                    else if(item->first=="dense_size_max")
+                        state.dense_size_max=std::move(item->second);
                     else if(item->first=="msg_level")
                         state.msg_level=std::move(item->second);
                     else if(item->first=="rejected_trustregion")
@@ -2487,6 +3804,16 @@ namespace Optizelle{
                         state.linesearch_iter_max=std::move(item->second);
                     else if(item->first=="linesearch_iter_total")
                         state.linesearch_iter_total=std::move(item->second);
+                    else if(item->first=="f_eval_calls")
+                        state.f_eval_calls=std::move(item->second);
+                    else if(item->first=="f_grad_calls")
+                        state.f_grad_calls=std::move(item->second);
+                    else if(item->first=="f_hessvec_calls")
+                        state.f_hessvec_calls=std::move(item->second);
+                    else if(item->first=="PH_calls")
+                        state.PH_calls=std::move(item->second);
+                    else if(item->first=="krylov_calls")
+                        state.krylov_calls=std::move(item->second);
                 }
                     
                 // Next, copy in any parameters 
@@ -2497,6 +3824,12 @@ namespace Optizelle{
                     if(item->first=="krylov_solver")
                         state.krylov_solver
                             = KrylovSolverTruncated::from_string(item->second);
+                    else if(item->first=="krylov_precision")
+                        state.krylov_precision
+                            = KrylovPrecision::from_string(item->second);
+                    else if(item->first=="history_precision")
+                        state.history_precision
+                            = KrylovPrecision::from_string(item->second);
                     else if(item->first=="algorithm_class")
                         state.algorithm_class
                             = AlgorithmClass::from_string(item->second);
@@ -2521,6 +3854,10 @@ namespace Optizelle{
                         state.dscheme
                             = DiagnosticScheme::from_string(item->second);
                 }
+
+                // Now that we know history_precision, store the quasi-Newton
+                // information in the right precision
+                State::storeHistory(state);
             }
             
             // Release the data into structures controlled by the user 
@@ -2593,8 +3930,12 @@ namespace Optizelle{
                 // Preconditioner for the Hessian of the objective
                 std::unique_ptr <Operator <Real,XX,XX> > PH;
 
+                // Objective function's interest in new iterates.  This points
+                // inside of f and is found during initialization.
+                LinearizationSession <Real,XX> * f_session;
+
                 // Initialize all of the pointers to null
-                t() : f(nullptr), PH(nullptr) {}
+                t() : f(nullptr), PH(nullptr), f_session(nullptr) {}
                 
                 // A trick to allow dynamic casting later
                 virtual ~t() {}
@@ -2607,6 +3948,16 @@ namespace Optizelle{
                 }
             };
 
+            // The objective modifications that leave the objective alone
+            struct IdentityModifications
+                : public ScalarValuedFunctionModifications <Real,XX>
+            {
+                // We don't modify the Hessian-vector product
+                virtual bool modifies_hessvec() const {
+                    return false;
+                }
+            };
+
             // The scaled identity Hessian approximation.  Specifically, use use
             // || grad || / (2 delta) I where delta is the current size of the
             // trust-region.  This forces us into the trust-region at each
@@ -2624,6 +3975,9 @@ namespace Optizelle{
 
                 // Maximum size of the trust-region radius
                 Real const & delta;
+
+                // Workspace for the gradient
+                mutable X_Vector grad_step;
             public:
                 ScaledIdentity(
                     typename Functions::t const & fns,
@@ -2631,13 +3985,13 @@ namespace Optizelle{
                 ) : f_mod(*(fns.f_mod)),
                     x(state.x),
                     grad(state.grad),
-                    delta(state.delta)
+                    delta(state.delta),
+                    grad_step(X::init(state.grad))
                 {};
 
                 void eval(X_Vector const & dx,X_Vector & result) const{
                     // Determine the norm of the gradient
-                    X_Vector grad_step(X::init(grad));
-                        f_mod.grad_step(x,grad,grad_step);
+                    f_mod.grad_step(x,grad,grad_step);
                     Real norm_grad=sqrt(X::innr(grad_step,grad_step));
 
                     // Copy in the direction and scale it
@@ -2646,6 +4000,93 @@ namespace Optizelle{
                 }
             };
 
+            // Access to the quasi-Newton information no matter how we store
+            // it.  When we store it in the lower precision, we expand each
+            // vector into one of a few work slots right before we use it.  A
+            // vector that we get from a slot stays valid until we expand
+            // another vector into the same slot.
+            class History {
+            private:
+                // Stored quasi-Newton information in the working precision
+                std::vector <X_Vector const *> ys;
+                std::vector <X_Vector const *> ss;
+
+                // Stored quasi-Newton information in the lower precision
+                CompressedList <Real,XX> const & ys_compressed;
+                CompressedList <Real,XX> const & ss_compressed;
+
+                // Whether we use the lower precision
+                bool const compressed;
+
+                // Work slots for the expanded vectors
+                VectorLease <Real,XX> lease;
+                std::vector <X_Vector *> slots;
+
+            public:
+                // Disallow constructors
+                NO_DEFAULT_COPY_ASSIGNMENT(History)
+
+                // Find the stored vectors and borrow the work slots from the
+                // pool
+                History(
+                    typename State::t const & state,
+                    VectorPool <Real,XX> & pool,
+                    Natural const & nslots
+                ) :
+                    ys(),
+                    ss(),
+                    ys_compressed(state.oldY_compressed),
+                    ss_compressed(state.oldS_compressed),
+                    compressed(State::compressHistory(state)),
+                    lease(pool),
+                    slots()
+                {
+                    for(typename std::list <X_Vector>::const_iterator
+                            y=state.oldY.begin();
+                        y!=state.oldY.end();
+                        y++
+                    )
+                        ys.push_back(&*y);
+                    for(typename std::list <X_Vector>::const_iterator
+                            s=state.oldS.begin();
+                        s!=state.oldS.end();
+                        s++
+                    )
+                        ss.push_back(&*s);
+                    if(compressed)
+                        for(Natural i=0;i<nslots;i++)
+                            slots.push_back(&lease.take(state.x));
+                }
+
+                // Number of stored gradient differences
+                Natural size_y() const {
+                    return compressed ? ys_compressed.size() : ys.size();
+                }
+
+                // Number of stored trial step differences
+                Natural size_s() const {
+                    return compressed ? ss_compressed.size() : ss.size();
+                }
+
+                // Gets the ith gradient difference, newest first
+                X_Vector const & y(Natural const & i,Natural const & slot)
+                    const
+                {
+                    if(!compressed) return *(ys[i]);
+                    ys_compressed.expand(i,*(slots[slot]));
+                    return *(slots[slot]);
+                }
+
+                // Gets the ith trial step difference, newest first
+                X_Vector const & s(Natural const & i,Natural const & slot)
+                    const
+                {
+                    if(!compressed) return *(ss[i]);
+                    ss_compressed.expand(i,*(slots[slot]));
+                    return *(slots[slot]);
+                }
+            };
+
             // The BFGS Hessian approximation.  Note, the formula we normally
             // see for BFGS denotes the inverse Hessian approximation.  This is
             // not the inverse, but the true Hessian approximation. 
@@ -2655,13 +4096,20 @@ namespace Optizelle{
                 Messaging const & msg;
 
                 // Stored quasi-Newton information
-                std::list<X_Vector> const & oldY;
-                std::list<X_Vector> const & oldS;
+                typename State::t const & state;
+
+                // Work vectors that we keep between applications.  We need
+                // one for each pair in the history and, when we store the
+                // history in the lower precision, three to expand it into.
+                mutable VectorPool <Real,XX> pool;
             public:
                 BFGS(
                     Messaging const & msg_,
-                    typename State::t const & state
-                ) : msg(msg_), oldY(state.oldY), oldS(state.oldS) {};
+                    typename State::t const & state_
+                ) : msg(msg_), state(state_), pool() {
+                    pool.reserve(state.x,state.stored_history
+                        + (State::compressHistory(state) ? 3 : 0));
+                };
 
                 // Operator interface
                 /* It's not entirely clear to me what the best implementation
@@ -2678,32 +4126,33 @@ namespace Optizelle{
                 multivectors of data and we don't require the user to provide
                 these abstractions. */
                 void eval(X_Vector const & dx, X_Vector & result) const{
+                    // Get the stored information.  We use slot 0 for si, 1
+                    // for yi, and 2 for sj.
+                    History const history(state,pool,3);
+                    Natural const k = history.size_y();
 
                     // Check that the number of stored gradient and trial step
                     // differences is the same.
-                    if(oldY.size() != oldS.size())
+                    if(k != history.size_s())
                         msg.error("In the BFGS Hessian approximation, the "
                             "number of stored gradient differences must equal "
                             "the number of stored trial step differences.");
 
-                    // Allocate memory for work
-                    std::list <X_Vector> work;
-                    for(Natural i=0;i<oldY.size();i++)
-                        work.emplace_back(std::move(X::init(dx)));
+                    // Borrow memory for work
+                    VectorLease <Real,XX> lease(pool);
+                    std::vector <X_Vector *> Bs;
+                    for(Natural i=0;i<k;i++)
+                        Bs.push_back(&lease.take(dx));
 
                     // If we have no vectors in our history, we return the
                     // direction
                     X::copy(dx,result);
-                    if(oldY.size() == 0) return;
+                    if(k == 0) return;
 
                     // As a safety check, insure that the inner product
                     // between all the (s,y) pairs is positive
-                    typename std::list <X_Vector>::const_iterator y0
-                        = oldY.begin();
-                    typename std::list <X_Vector>::const_iterator s0
-                        = oldS.begin();
-                    while(y0!=oldY.end()){
-                        Real inner_y_s=X::innr(*y0++,*s0++);
+                    for(Natural i=0;i<k;i++) {
+                        Real inner_y_s=X::innr(history.y(i,1),history.s(i,0));
                         if(inner_y_s <= Real(0.))
                             msg.error("Detected a (s,y) pair in BFGS that "
                                 "possesed a nonpositive inner product");
@@ -2711,34 +4160,20 @@ namespace Optizelle{
 
                     // Othwerwise, we copy all of the trial step differences
                     // into the work space
-                    typename std::list <X_Vector>::iterator Bisj_iter
-                        =work.begin();
-                    typename std::list <X_Vector>::const_iterator sk_iter
-                        =oldS.begin();
-                    while(Bisj_iter!=work.end())
-                        X::copy((*sk_iter++),(*Bisj_iter++));
-
-                    // Keep track of the element Bisi
-                    typename std::list <X_Vector>::const_iterator Bisi_iter
-                        =work.end(); Bisi_iter--;
+                    for(Natural j=0;j<k;j++)
+                        X::copy(history.s(j,2),*(Bs[j]));
 
                     // Keep iterating until Bisi equals the first element in the
-                    // work list. This means we have computed B1s1, B2s2, ...,
-                    // Bksk.
-                    Bisj_iter=work.begin();
-                    typename std::list <X_Vector>::const_iterator si_iter
-                        =oldS.end(); si_iter--;
-                    typename std::list <X_Vector>::const_iterator yi_iter
-                        =oldY.end(); yi_iter--;
-                    typename std::list <X_Vector>::const_iterator sj_iter
-                        =oldS.begin();
-                    while(true){
-
-                        // Create some reference to our iterators that are
+                    // work list.  This means we have computed B1s1, B2s2, ...,
+                    // Bksk.  Note, the newest information comes first in the
+                    // list, so we start with the oldest at the end.
+                    for(Natural i=k-1;;i--) {
+
+                        // Create some reference to our vectors that are
                         // easier to work with
-                        X_Vector const & si=*si_iter;
-                        X_Vector const & yi=*yi_iter;
-                        X_Vector const & Bisi=*Bisi_iter;
+                        X_Vector const & si=history.s(i,0);
+                        X_Vector const & yi=history.y(i,1);
+                        X_Vector const & Bisi=*(Bs[i]);
 
                         // Determine <Bi si,si>
                         Real inner_Bisi_si=X::innr(Bisi,si);
@@ -2763,13 +4198,13 @@ namespace Optizelle{
 
                         // Check whether or not we've calculated B_{i+1} dx for
                         // the last time
-                        if(Bisi_iter==work.begin()) break;
+                        if(i==0) break;
 
                         // Begin the calculation of B_{i+1}sj
-                        while(si_iter!=sj_iter){
-                            // Add some additional references to the iterators 
-                            X_Vector const & sj=*sj_iter;
-                            X_Vector & Bisj=*Bisj_iter;
+                        for(Natural j=0;j<i;j++) {
+                            // Add some additional references to the vectors
+                            X_Vector const & sj=history.s(j,2);
+                            X_Vector & Bisj=*(Bs[j]);
 
                             // Determine <si,Bisj>
                             Real inner_si_Bisj=X::innr(si,Bisj);
@@ -2785,32 +4220,7 @@ namespace Optizelle{
                             // calculated w in the line above.  This completes 
                             // the computation of B_{i+1}sj.
                             X::axpy(inner_yi_sj/inner_yi_si,yi,Bisj);
-
-                            // Change j to be j-1 and adjust Bisj and sj 
-                            // accordingly
-                            sj_iter++;
-                            Bisj_iter++;
                         }
-
-                        // At this point, we've computed all Bisj entries on the
-                        // current row.  As a result, we increment i and set j 
-                        // to be k.  This requires us to modify si, yi, sj, 
-                        // Bisj, and Bisi accordingly.
-                        
-                        // Increment i and adjust si
-                        si_iter--;
-
-                        // Increment i and adjust yi
-                        yi_iter--;
-
-                        // Set j=k and adjust sj
-                        sj_iter=oldS.begin();
-
-                        // Set j=k, increment i, and adjust Bisj
-                        Bisj_iter=work.begin();
-
-                        // Increment i and adjust Bisi
-                        Bisi_iter--;
                     }
                 }
             };
@@ -2822,64 +4232,62 @@ namespace Optizelle{
                 Messaging const & msg;
 
                 // Stored quasi-Newton information
-                std::list<X_Vector> const & oldY;
-                std::list<X_Vector> const & oldS;
+                typename State::t const & state;
+
+                // Work vectors that we keep between applications.  We need
+                // one for each pair in the history and, when we store the
+                // history in the lower precision, three to expand it into.
+                mutable VectorPool <Real,XX> pool;
             public:
                 SR1(
                     Messaging const & msg_,
-                    typename State::t const & state
-                ) : msg(msg_), oldY(state.oldY), oldS(state.oldS) {};
+                    typename State::t const & state_
+                ) : msg(msg_), state(state_), pool() {
+                    pool.reserve(state.x,state.stored_history
+                        + (State::compressHistory(state) ? 3 : 0));
+                };
                 
                 // Operator interface
                 void eval(X_Vector const & dx,X_Vector & result) const {
+                    // Get the stored information.  We use slot 0 for si, 1
+                    // for yi, and 2 for sj.
+                    History const history(state,pool,3);
+                    Natural const k = history.size_y();
 
                     // Check that the number of stored gradient and trial step
                     // differences is the same.
-                    if(oldY.size() != oldS.size())
+                    if(k != history.size_s())
                         msg.error("In the SR1 Hessian approximation, the "
                             "number of stored gradient differences must equal "
                             "the number of stored trial step differences.");
 
-                    // Allocate memory for work
-                    std::list <X_Vector> work;
-                    for(Natural i=0;i<oldY.size();i++)
-                        work.emplace_back(std::move(X::init(dx)));
+                    // Borrow memory for work
+                    VectorLease <Real,XX> lease(pool);
+                    std::vector <X_Vector *> Bs;
+                    for(Natural i=0;i<k;i++)
+                        Bs.push_back(&lease.take(dx));
 
                     // If we have no vectors in our history, we return the 
                     // direction
                     X::copy(dx,result);
-                    if(oldY.size() == 0) return;
+                    if(k == 0) return;
 
                     // Othwerwise, we copy all of the trial step differences 
                     // into the work space
-                    typename std::list <X_Vector>::iterator Bisj_iter
-                        =work.begin();
-                    typename std::list <X_Vector>::const_iterator sk_iter
-                        =oldS.begin();
-                    while(Bisj_iter!=work.end())
-                        X::copy((*sk_iter++),(*Bisj_iter++));
-
-                    // Keep track of the element Bisi
-                    typename std::list <X_Vector>::const_iterator Bisi_iter
-                        =work.end(); Bisi_iter--;
+                    for(Natural j=0;j<k;j++)
+                        X::copy(history.s(j,2),*(Bs[j]));
 
                     // Keep iterating until Bisi equals the first element in the
-                    // work list. This means we have computed B1s1, B2s2, ...,
-                    // Bksk.
-                    Bisj_iter=work.begin();
-                    typename std::list <X_Vector>::const_iterator si_iter
-                        =oldS.end(); si_iter--;
-                    typename std::list <X_Vector>::const_iterator yi_iter
-                        =oldY.end(); yi_iter--;
-                    typename std::list <X_Vector>::const_iterator sj_iter
-                        =oldS.begin();
-                    while(true){
-
-                        // Create some reference to our iterators that are 
+                    // work list.  This means we have computed B1s1, B2s2, ...,
+                    // Bksk.  Note, the newest information comes first in the
+                    // list, so we start with the oldest at the end.
+                    for(Natural i=k-1;;i--) {
+
+                        // Create some reference to our vectors that are 
                         // easier to work with
-                        X_Vector const & si=*si_iter;
-                        X_Vector const & yi=*yi_iter;
-                        X_Vector const & Bisi=*Bisi_iter;
+                        X_Vector const & si=history.s(i,0);
+                        X_Vector const & yi=history.y(i,1);
+                        X_Vector const & Bisi=*(Bs[i]);
 
                         // Determine <yi,dx>
                         Real inner_yi_dx=X::innr(yi,dx);
@@ -2907,13 +4315,13 @@ namespace Optizelle{
 
                         // Check whether or not we've calculated B_{i+1}p for 
                         // the last time
-                        if(Bisi_iter==work.begin()) break;
+                        if(i==0) break;
 
                         // Begin the calculation of B_{i+1}sj
-                        while(si_iter!=sj_iter){
-                            // Add some additional references to the iterators 
-                            X_Vector const & sj=*sj_iter;
-                            X_Vector & Bisj=*Bisj_iter;
+                        for(Natural j=0;j<i;j++) {
+                            // Add some additional references to the vectors
+                            X_Vector const & sj=history.s(j,2);
+                            X_Vector & Bisj=*(Bs[j]);
 
                             // Determine <yi,sj>
                             Real inner_yi_sj=X::innr(yi,sj);
@@ -2934,32 +4342,7 @@ namespace Optizelle{
 
                             // Add -beta*Bisi to this result
                             X::axpy(-beta,Bisi,Bisj);
-
-                            // Change j to be j-1 and adjust Bisj and sj 
-                            // accordingly
-                            sj_iter++;
-                            Bisj_iter++;
                         }
-
-                        // At this point, we've computed all Bisj entries on the
-                        // current row.  As a result, we increment i and set j 
-                        // to be k.  This requires us to modify si, yi, sj, 
-                        // Bisj, and Bisi accordingly.
-                        
-                        // Increment i and adjust si
-                        si_iter--;
-
-                        // Increment i and adjust yi
-                        yi_iter--;
-
-                        // Set j=k and adjust sj
-                        sj_iter=oldS.begin();
-
-                        // Set j=k, increment i, and adjust Bisj
-                        Bisj_iter=work.begin();
-
-                        // Increment i and adjust Bisi
-                        Bisi_iter--;
                     }
                 }
             };
@@ -2971,32 +4354,37 @@ namespace Optizelle{
                 Messaging const & msg;
 
                 // Stored quasi-Newton information
-                std::list <X_Vector> const & oldY;
-                std::list <X_Vector> const & oldS;
+                typename State::t const & state;
+
+                // Work vectors to expand the history into when we store it in
+                // the lower precision
+                mutable VectorPool <Real,XX> pool;
             public:
                 InvBFGS(
                     Messaging const & msg_,
-                    typename State::t const & state
-                ) : msg(msg_), oldY(state.oldY), oldS(state.oldS) {};
+                    typename State::t const & state_
+                ) : msg(msg_), state(state_), pool() {
+                    pool.reserve(state.x,State::compressHistory(state) ? 2:0);
+                };
                 
                 // Operator interface
                 void eval(X_Vector const & dx,X_Vector & result) const{
+                    // Get the stored information.  We use slot 0 for y_k and
+                    // 1 for s_k.
+                    History const history(state,pool,2);
+                    Natural const k = history.size_y();
 
                     // Check that the number of stored gradient and trial step
                     // differences is the same.
-                    if(oldY.size() != oldS.size())
+                    if(k != history.size_s())
                         msg.error("In the inverse BFGS operator, the number "
                             "of stored gradient differences must equal the "
                             "number of stored trial step differences.");
                     
                     // As a safety check, insure that the inner product between
                     // all the (s,y) pairs is positive
-                    typename std::list <X_Vector>::const_iterator y0
-                        = oldY.begin();
-                    typename std::list <X_Vector>::const_iterator s0
-                        = oldS.begin();
-                    while(y0!=oldY.end()){
-                        Real inner_y_s=X::innr(*y0++,*s0++);
+                    for(Natural i=0;i<k;i++) {
+                        Real inner_y_s=X::innr(history.y(i,0),history.s(i,1));
                         if(inner_y_s <= Real(0.))
                             msg.error("Detected a (s,y) pair in the inverse "
                                 "BFGS operator that possesed a nonpositive "
@@ -3004,8 +4392,8 @@ namespace Optizelle{
                     }
 
                     // Create two vectors to hold some intermediate calculations
-                    std::vector <Real> alpha(oldY.size());
-                    std::vector <Real> rho(oldY.size());
+                    std::vector <Real> alpha(k);
+                    std::vector <Real> rho(k);
 
                     // Before we begin computing, copy dx to our result 
                     X::copy(dx,result);
@@ -3013,15 +4401,10 @@ namespace Optizelle{
                     // In order to compute, we first iterate over all the stored
                     // element in the forward direction.  Then, we iterate over
                     // them backward.
-                    typename std::list <X_Vector>::const_iterator y_iter
-                        =oldY.begin();
-                    typename std::list <X_Vector>::const_iterator s_iter
-                        =oldS.begin();
-                    Natural i(0);
-                    while(y_iter != oldY.end()){
+                    for(Natural i=0;i<k;i++) {
                         // Find y_k, s_k, and their inner product
-                        X_Vector const & y_k=*(y_iter++);
-                        X_Vector const & s_k=*(s_iter++);
+                        X_Vector const & y_k=history.y(i,0);
+                        X_Vector const & s_k=history.s(i,1);
                         rho[i]=Real(1.)/X::innr(y_k,s_k);
 
                         // Find rho_i <s_i,result>.  Store in alpha_i
@@ -3029,9 +4412,6 @@ namespace Optizelle{
 
                         // result = - alpha_i y_i + result 
                         X::axpy(-alpha[i],y_k,result);
-
-                        // Make sure we don't overwrite alpha and rho
-                        i++;
                     }
 
                     // Assume that H_0 is the identity operator (which may or 
@@ -3039,16 +4419,16 @@ namespace Optizelle{
 
                     // Now, let us iterate backward over our elements to 
                     // complete the computation
-                    while(y_iter != oldY.begin()){
+                    for(Natural i=k;i>0;i--) {
                         // Find y_k and s_k
-                        X_Vector const & s_k=*(--s_iter);
-                        X_Vector const & y_k=*(--y_iter);
+                        X_Vector const & s_k=history.s(i-1,1);
+                        X_Vector const & y_k=history.y(i-1,0);
 
                         // beta=rho_i <y_i,result>
-                        Real beta= rho[--i] * X::innr(y_k,result);
+                        Real beta= rho[i-1] * X::innr(y_k,result);
 
                         // result=  (alpha_i-beta) s_i + result
-                        X::axpy(alpha[i]-beta,s_k,result);
+                        X::axpy(alpha[i-1]-beta,s_k,result);
                     }
                 }
             };
@@ -3141,6 +4521,13 @@ namespace Optizelle{
                      else
                         f->hessvec(x,dx,H_dx);
                  }
+
+                 // H = hess f(x) when we use the Hessian from the user
+                 bool hessian(X_Vector const & x,std::vector <Real> & H_x)
+                     const
+                 {
+                     return H.get()==nullptr && f->hessian(x,H_x);
+                 }
             };
 
             // Check that all the functions are defined
@@ -3163,12 +4550,11 @@ namespace Optizelle{
             // optimization.
             static void init_(
                 Messaging const & msg,
-                typename State::t const & state,
+                typename State::t & state,
                 t & fns
             ) {
                 // Create the objective modifications
-                fns.f_mod.reset(
-                    new ScalarValuedFunctionModifications <Real,XX>());
+                fns.f_mod.reset(new IdentityModifications());
 
                 // Determine the preconditioner
                 switch(state.PH_type){
@@ -3195,6 +4581,35 @@ namespace Optizelle{
                 // objective).
                 check(msg,fns);
 
+                // Find whether the objective wants to hear about new iterates.
+                // If we've been here before, the objective is already wrapped
+                // and we keep what we found the first time.
+                if(dynamic_cast <HessianAdjustedFunction *> (fns.f.get())
+                    ==nullptr
+                )
+                    fns.f_session=dynamic_cast <LinearizationSession<Real,XX>*>(
+                        fns.f.get());
+
+                #if defined(OPTIZELLE_INSTRUMENTATION) \
+                    || defined(OPTIZELLE_TRACING)
+                // Time and trace the objective and the preconditioner.  If
+                // we've been here before, the objective is already wrapped
+                // inside of a HessianAdjustedFunction and timed.
+                if(dynamic_cast <HessianAdjustedFunction *> (fns.f.get())
+                    ==nullptr
+                )
+                    fns.f.reset(new TimedScalarValuedFunction <Real,XX> (
+                        std::move(fns.f),
+                        state.f_eval_calls,state.f_eval_time,
+                        state.f_grad_calls,state.f_grad_time,
+                        state.f_hessvec_calls,state.f_hessvec_time));
+                if(dynamic_cast <TimedOperator <Real,XX,XX> *> (fns.PH.get())
+                    ==nullptr
+                )
+                    fns.PH.reset(new TimedOperator <Real,XX,XX> (
+                        std::move(fns.PH),state.PH_calls,state.PH_time,"PH"));
+                #endif
+
                 // Modify the objective function if necessary
                 fns.f.reset(new HessianAdjustedFunction(msg,state,fns));
             }
@@ -3202,11 +4617,26 @@ namespace Optizelle{
             // Initialize any missing functions 
             static void init(
                 Messaging const & msg,
-                typename State::t const & state,
+                typename State::t & state,
                 t & fns
             ) {
                 Unconstrained <Real,XX>::Functions::init_(msg,state,fns);
             }
+
+            // Announces the current iterate to the functions that want it
+            static void linearize_(
+                t const & fns,
+                typename State::t const & state
+            ) {
+                if(fns.f_session!=nullptr)
+                    fns.f_session->announce(state.x,state.x_version);
+            }
+            static void linearize(
+                t const & fns,
+                typename State::t const & state
+            ) {
+                Unconstrained <Real,XX>::Functions::linearize_(fns,state);
+            }
         };
 
         // Contains functions that assist in creating an output for diagonstics
@@ -3217,7 +4647,7 @@ namespace Optizelle{
             // Gets the header for the state information
             static void getStateHeader_(
                 typename State::t const & state,
-                std::list <std::string> & out
+                std::vector <std::string> & out
             ) {
 
                 // Create some shortcuts
@@ -3226,57 +4656,68 @@ namespace Optizelle{
                 Natural const & msg_level = state.msg_level;
 
                 // Basic information
-                out.emplace_back(Utility::atos("Iter"));
-                out.emplace_back(Utility::atos("f(x)"));
-                out.emplace_back(Utility::atos("||grad||"));
-                out.emplace_back(Utility::atos("||dx||"));
+                out.emplace_back("Iter");
+                out.emplace_back("f(x)");
+                out.emplace_back("||grad||");
+                out.emplace_back("||dx||");
                 
                 // More detailed information
                 if(msg_level >= 2) {
-                    out.emplace_back(Utility::atos("merit(x)"));
+                    out.emplace_back("merit(x)");
 
                     // In case we're using a Krylov method
                     if(    algorithm_class==AlgorithmClass::TrustRegion
                         || dir==LineSearchDirection::NewtonCG
                     ){
-                        out.emplace_back(Utility::atos("KryIter"));
-                        out.emplace_back(Utility::atos("KryErr"));
-                        out.emplace_back(Utility::atos("KryStop"));
+                        out.emplace_back("KryIter");
+                        out.emplace_back("KryErr");
+                        out.emplace_back("KryStop");
                     }
 
                     // In case we're using a line-search method
                     if(algorithm_class==AlgorithmClass::LineSearch) {
-                        out.emplace_back(Utility::atos("LSIter"));
-                        out.emplace_back(Utility::atos("alpha0"));
-                        out.emplace_back(Utility::atos("alpha"));
+                        out.emplace_back("LSIter");
+                        out.emplace_back("alpha0");
+                        out.emplace_back("alpha");
                     }
 
                     // In case we're using a trust-region method 
                     if(algorithm_class==AlgorithmClass::TrustRegion) {
-                        out.emplace_back(Utility::atos("ared"));
-                        out.emplace_back(Utility::atos("pred"));
-                        out.emplace_back(Utility::atos("ared/pred"));
-                        out.emplace_back(Utility::atos("delta"));
+                        out.emplace_back("ared");
+                        out.emplace_back("pred");
+                        out.emplace_back("ared/pred");
+                        out.emplace_back("delta");
                     }
                 }
+
+                #ifdef OPTIZELLE_INSTRUMENTATION
+                // Cumulative timings
+                if(msg_level >= 3) {
+                    out.emplace_back("time(f)");
+                    out.emplace_back("time(grad)");
+                    out.emplace_back("time(hess)");
+                    out.emplace_back("time(PH)");
+                    out.emplace_back("time(Kry)");
+                }
+                #endif
             }
 
             // Combines all of the state headers
             static void getStateHeader(
                 typename State::t const & state,
-                std::list <std::string> & out
+                std::vector <std::string> & out
             ) {
                 Unconstrained <Real,XX>::Diagnostics::getStateHeader_(
                     state,out);
             }
 
-            // Gets the state information for output
+            // Gets the state information for output.  We compute the
+            // diagnostic gradient in the workspace grad_diag.
             static void getState_(
                 typename Functions::t const & fns,
                 typename State::t const & state,
-                bool const & blank,
-                bool const & noiter,
-                std::list <std::string> & out
+                X_Vector & grad_diag,
+                std::vector <TelemetryValue <Real> > & out
             ) {
 
                 // Create some shortcuts
@@ -3313,100 +4754,91 @@ namespace Optizelle{
                       algorithm_class == AlgorithmClass::UserDefined) && 
                         rejected_trustregion == 0));
 
-                // Determine some extra diagnostic information
-                Real merit_x=f_mod.merit(x,f_x);
-                Real norm_dx=sqrt(X::innr(dx,dx));
-                X_Vector grad_diag(X::init(grad));
-                    f_mod.grad_diag(x,grad,grad_diag);
+                // Determine some extra diagnostic information.  The
+                // modifications to the objective cache the expensive pieces
+                // of the merit function and the diagnostic gradient, so these
+                // generally reuse work that the algorithm already did.
+                f_mod.grad_diag(x,grad,grad_diag);
                 Real norm_grad=sqrt(X::innr(grad_diag,grad_diag));
 
-                // Get a iterator to the last element prior to inserting
-                // elements
-                std::list <std::string>::iterator prior=out.end(); prior--;
-
                 // Basic information
-                if(!noiter)
-                    out.emplace_back(Utility::atos(iter));
-                else
-                    out.emplace_back(Utility::atos("*"));
-                out.emplace_back(Utility::atos(f_x));
-                out.emplace_back(Utility::atos(norm_grad));
+                out.emplace_back(iter);
+                out.emplace_back(f_x);
+                out.emplace_back(norm_grad);
                 if(!opt_begin) {
+                    Real norm_dx=sqrt(X::innr(dx,dx));
                     if(algorithm_class==AlgorithmClass::LineSearch)
-                        out.emplace_back(
-                            Utility::atos(Real(1.)/alpha*norm_dx));
+                        out.emplace_back(Real(1.)/alpha*norm_dx);
                     else
-                        out.emplace_back(Utility::atos(norm_dx));
+                        out.emplace_back(norm_dx);
                 } else
-                    out.emplace_back(Utility::blankSeparator);
+                    out.emplace_back();
                 
                 // More detailed information 
                 if(msg_level >=2) {
-                    out.emplace_back(Utility::atos(merit_x));
+                    out.emplace_back(f_mod.merit(x,f_x));
 
                     // In case we're using a Krylov method
                     if(    algorithm_class==AlgorithmClass::TrustRegion
                         || dir==LineSearchDirection::NewtonCG
                     ){
                         if(!opt_begin) {
-                            out.emplace_back(Utility::atos(krylov_iter));
-                            out.emplace_back(Utility::atos(krylov_rel_err));
-                            out.emplace_back(Utility::atos(krylov_stop));
+                            out.emplace_back(krylov_iter);
+                            out.emplace_back(krylov_rel_err);
+                            out.emplace_back(krylov_stop);
                         } else 
-                            for(Natural i=0;i<3;i++)
-                                out.emplace_back(Utility::blankSeparator);
+                            out.resize(out.size()+3);
                     }
 
                     // In case we're using a line-search method
                     if(algorithm_class==AlgorithmClass::LineSearch) {
                         if(!opt_begin) {
-                            out.emplace_back(Utility::atos(linesearch_iter));
-                            out.emplace_back(Utility::atos(alpha0));
-                            out.emplace_back(Utility::atos(alpha));
+                            out.emplace_back(linesearch_iter);
+                            out.emplace_back(alpha0);
+                            out.emplace_back(alpha);
                         } else 
-                            for(Natural i=0;i<3;i++)
-                                out.emplace_back(Utility::blankSeparator);
+                            out.resize(out.size()+3);
                     }
                     
                     // In case we're using a trust-region method
                     if(algorithm_class==AlgorithmClass::TrustRegion) {
                         if(!opt_begin) {
-                            out.emplace_back(Utility::atos(ared));
-                            out.emplace_back(Utility::atos(pred));
-                            out.emplace_back(Utility::atos(ared/pred));
-                            out.emplace_back(Utility::atos(delta));
+                            out.emplace_back(ared);
+                            out.emplace_back(pred);
+                            out.emplace_back(ared/pred);
+                            out.emplace_back(delta);
                         } else  
-                            for(Natural i=0;i<4;i++)
-                                out.emplace_back(Utility::blankSeparator);
+                            out.resize(out.size()+4);
                     }
                 }
 
-                // If we needed to do blank insertions, overwrite the elements
-                // with spaces 
-                if(blank)
-                    for(std::list <std::string>::iterator x=++prior;
-                        x!=out.end();
-                        x++
-                    )
-                        (*x)=Utility::blankSeparator;
+                #ifdef OPTIZELLE_INSTRUMENTATION
+                // Cumulative timings
+                if(msg_level >= 3) {
+                    out.emplace_back(state.f_eval_time);
+                    out.emplace_back(state.f_grad_time);
+                    out.emplace_back(state.f_hessvec_time);
+                    out.emplace_back(state.PH_time);
+                    out.emplace_back(state.krylov_time);
+                }
+                #endif
             }
 
             // Combines all of the state information
             static void getState(
                 typename Functions::t const & fns,
                 typename State::t const & state,
-                bool const & blank,
-                bool const & noiter,
-                std::list <std::string> & out
+                X_Vector & grad_diag,
+                std::vector <TelemetryValue <Real> > & out
             ) {
                 Unconstrained <Real,XX>::Diagnostics
-                    ::getState_(fns,state,blank,noiter,out);
+                    ::getState_(fns,state,grad_diag,out);
             }
 
             // Get the header for the Krylov iteration
             static void getKrylovHeader_(
                 typename State::t const & state,
-                std::list <std::string> & out
+                std::vector <std::string> & out
             ) {
                 // Create some shortcuts
                 AlgorithmClass::t const & algorithm_class=state.algorithm_class;
@@ -3416,16 +4848,16 @@ namespace Optizelle{
                 if(    algorithm_class==AlgorithmClass::TrustRegion
                     || dir==LineSearchDirection::NewtonCG
                 ){
-                    out.emplace_back(Utility::atos("KrySubItr"));
-                    out.emplace_back(Utility::atos("KryTotItr"));
-                    out.emplace_back(Utility::atos("KrySubErr"));
+                    out.emplace_back("KrySubItr");
+                    out.emplace_back("KryTotItr");
+                    out.emplace_back("KrySubErr");
                 }
             }
 
             // Combines all of the Krylov headers
             static void getKrylovHeader(
                 typename State::t const & state,
-                std::list <std::string> & out
+                std::vector <std::string> & out
             ) {
                 Unconstrained <Real,XX>::Diagnostics::getKrylovHeader_(
                     state,out);
@@ -3434,42 +4866,28 @@ namespace Optizelle{
             // Get the information for the Krylov iteration
             static void getKrylov_(
                 typename State::t const & state,
-                bool const & blank,
-                std::list <std::string> & out
+                std::vector <TelemetryValue <Real> > & out
             ) {
                 // Create some shortcuts
-                Natural const & krylov_iter=state.krylov_iter;
-                Natural const & krylov_iter_total=state.krylov_iter_total;
-                Real const & krylov_rel_err=state.krylov_rel_err;
-
-                // Get a iterator to the last element prior to inserting
-                // elements
-                std::list <std::string>::iterator prior=out.end(); prior--;
+                AlgorithmClass::t const & algorithm_class=state.algorithm_class;
+                LineSearchDirection::t const & dir=state.dir;
 
-                // Basic information
-                out.emplace_back(Utility::atos(krylov_iter));
-                out.emplace_back(Utility::atos(krylov_iter_total));
-                out.emplace_back(Utility::atos(krylov_rel_err));
-                
-                // If we needed to do blank insertions, overwrite the elements
-                // with nothing
-                if(blank) {
-                    for(std::list <std::string>::iterator x=++prior;
-                        x!=out.end();
-                        x++
-                    )
-                        x->clear();
+                // In case we're using a Krylov method
+                if(    algorithm_class==AlgorithmClass::TrustRegion
+                    || dir==LineSearchDirection::NewtonCG
+                ){
+                    out.emplace_back(state.krylov_iter);
+                    out.emplace_back(state.krylov_iter_total);
+                    out.emplace_back(state.krylov_rel_err);
                 }
             }
 
             // Combines all of the Krylov information
             static void getKrylov(
                 typename State::t const & state,
-                bool const & blank,
-                std::list <std::string> & out
+                std::vector <TelemetryValue <Real> > & out
             ) {
-                Unconstrained <Real,XX>::Diagnostics::getKrylov_(
-                    state,blank,out);
+                Unconstrained <Real,XX>::Diagnostics::getKrylov_(state,out);
             }
             
             // Runs the specified function diagnostics 
@@ -3521,10 +4939,41 @@ namespace Optizelle{
             // Disallow constructors
             NO_CONSTRUCTORS(Algorithms)
 
+            // Memory that the algorithms reuse from one iteration to the
+            // next.  We create this once in getMin_, so that the optimization
+            // loop stops allocating vectors once it reaches a steady state.
+            struct Workspace {
+                // Disallow constructors
+                NO_DEFAULT_COPY_ASSIGNMENT(Workspace)
+
+                // Temporaries for the steps, line-searches, and Krylov methods
+                VectorPool <Real,XX> pool;
+
+                // Vectors for the quasi-Newton information
+                VectorPool <Real,XX> history;
+
+                // Allocate the vectors for the quasi-Newton information up
+                // front, since the history grows during the first few
+                // iterations.  We need one more pair than we store for the
+                // pair that we find before we drop the oldest.  When we store
+                // the history in the lower precision, we only need the pair
+                // that we find.
+                explicit Workspace(typename State::t const & state) :
+                    pool(), history()
+                {
+                    Natural const needed = State::compressHistory(state)
+                        ? Natural(2) : Natural(2)*(state.stored_history+1);
+                    Natural const stored = state.oldS.size()+state.oldY.size();
+                    history.reserve(state.x,
+                        needed > stored ? needed-stored : 0);
+                }
+            };
+
             // Checks a set of stopping conditions
             static StoppingCondition::t checkStop(
                 typename Functions::t const & fns, 
-                typename State::t const & state
+                typename State::t const & state,
+                Workspace & work
             ){
                 // Create some shortcuts
                 ScalarValuedFunctionModifications <Real,XX> const & f_mod
@@ -3540,7 +4989,8 @@ namespace Optizelle{
                 Real const & eps_dx=state.eps_dx;
 
                 // Find both the norm of the gradient and the step
-                X_Vector grad_stop(X::init(grad));
+                VectorLease <Real,XX> lease(work.pool);
+                X_Vector & grad_stop(lease.take(grad));
                 f_mod.grad_stop(x,grad,grad_stop);
                 const Real norm_grad=sqrt(X::innr(grad_stop,grad_stop));
                 const Real norm_dx=sqrt(X::innr(dx,dx));
@@ -3576,8 +5026,11 @@ namespace Optizelle{
                 // Store a reference to the base of the Hessian-vector product
                 X_Vector const & x;
 
-                // Allocate memory for the Hessian modification
-                mutable X_Vector H_dx;
+                // Allocate memory for the Hessian modification.  Unless we
+                // borrow it from a pool, we allocate it ourselves.
+                VectorPool <Real,XX> own;
+                VectorLease <Real,XX> lease;
+                X_Vector & H_dx;
 
             public:
                 // Take in the objective and the base point during construction 
@@ -3585,7 +5038,18 @@ namespace Optizelle{
                     ScalarValuedFunction <Real,XX> const & f_,
                     ScalarValuedFunctionModifications <Real,XX> const & f_mod_,
                     X_Vector const & x_)
-                : f(f_), f_mod(f_mod_), x(x_), H_dx(X::init(x_))
+                : f(f_), f_mod(f_mod_), x(x_), own(), lease(own),
+                    H_dx(lease.take(x_))
+                {}
+
+                // Borrow the memory for the Hessian modification from pool
+                HessianOperator(
+                    ScalarValuedFunction <Real,XX> const & f_,
+                    ScalarValuedFunctionModifications <Real,XX> const & f_mod_,
+                    X_Vector const & x_,
+                    VectorPool <Real,XX> & pool)
+                : f(f_), f_mod(f_mod_), x(x_), own(), lease(pool),
+                    H_dx(lease.take(x_))
                 {}
 
                 // Basic application
@@ -3600,7 +5064,8 @@ namespace Optizelle{
             // Checks whether we accept or reject a step
             static bool checkStep(
                 typename Functions::t const & fns,
-                typename State::t & state
+                typename State::t & state,
+                Workspace & work
             ){
                 // Create some shortcuts
                 ScalarValuedFunction <Real,XX> const & f=*(fns.f);
@@ -3618,8 +5083,9 @@ namespace Optizelle{
                 Real & pred=state.pred;
                 Real & f_xpdx=state.f_xpdx;
                 
-                // Allocate memory for temporaries that we need
-                X_Vector x_p_dx(X::init(x));
+                // Borrow memory for temporaries that we need
+                VectorLease <Real,XX> lease(work.pool);
+                X_Vector & x_p_dx(lease.take(x));
 
                 // Determine x+dx 
                 X::copy(dx,x_p_dx);
@@ -3629,13 +5095,13 @@ namespace Optizelle{
                 Real merit_x = f_mod.merit(x,f_x);
                 
                 // Determine H(x)dx
-                X_Vector H_dx(X::init(x));
+                X_Vector & H_dx(lease.take(x));
                     f.hessvec(x,dx,H_dx);
-                X_Vector Hdx_step(X::init(x));
+                X_Vector & Hdx_step(lease.take(x));
                     f_mod.hessvec_step(x,dx,H_dx,Hdx_step);
 
                 // Determine the gradient
-                X_Vector grad_step(X::init(x));
+                X_Vector & grad_step(lease.take(x));
                     f_mod.grad_step(x,grad,grad_step);
 
                 // Calculate the model,
@@ -3690,7 +5156,8 @@ namespace Optizelle{
                 Messaging const & msg,
                 StateManipulator <Unconstrained <Real,XX> > const & smanip,
                 typename Functions::t const & fns,
-                typename State::t & state
+                typename State::t & state,
+                Workspace & work
             ){
                 // Create some shortcuts
                 ScalarValuedFunction <Real,XX> const & f=*(fns.f);
@@ -3707,6 +5174,10 @@ namespace Optizelle{
                 Real const & norm_dxtyp=state.norm_dxtyp;
                 KrylovSolverTruncated::t const & krylov_solver
                     = state.krylov_solver;
+                KrylovPrecision::t const & krylov_precision
+                    = state.krylov_precision;
+                Operators::t const & PH_type=state.PH_type;
+                Natural const & dense_size_max=state.dense_size_max;
                 Natural & rejected_trustregion=state.rejected_trustregion;
                 X_Vector & dx=state.dx;
                 Natural & krylov_iter=state.krylov_iter;
@@ -3719,18 +5190,27 @@ namespace Optizelle{
                 Real & alpha = state.alpha;
                 Real & alpha0 = state.alpha0;
                 
-                // Allocate some memory for the scaled trial step and the
+                // Borrow some memory for the scaled trial step and the
                 // trust-region center
-                X_Vector x_tmp1(X::init(x));
-                X_Vector dx_cp(X::init(x));
-                X_Vector grad_step(X::init(x));
-                X_Vector minus_grad(X::init(x));
+                VectorLease <Real,XX> lease(work.pool);
+                X_Vector & x_tmp1(lease.take(x));
+                X_Vector & dx_cp(lease.take(x));
+                X_Vector & grad_step(lease.take(x));
+                X_Vector & minus_grad(lease.take(x));
 
                 // Find -grad f(x) 
                 f_mod.grad_step(x,grad,grad_step);
                 X::copy(grad_step,minus_grad);
                 X::scal(Real(-1.),minus_grad);
 
+                // When the objective provides a dense Hessian and the problem
+                // is small, we solve the subproblem directly rather than with
+                // a Krylov method.  This requires that nothing modifies the
+                // Hessian and that we don't precondition.
+                DenseTrustRegion <Real,XX> dense(f,x,grad_step,
+                    !f_mod.modifies_hessvec() && PH_type==Operators::Identity
+                        ? dense_size_max : 0);
+
                 // Continue to look for a step until one comes back as valid
                 for(rejected_trustregion=0;
                     true; 
@@ -3740,7 +5220,7 @@ namespace Optizelle{
 
                     // Use truncated the truncated Krylov solver to find a 
                     // new trial step
-                    HessianOperator H(f,f_mod,x);
+                    HessianOperator H(f,f_mod,x,work.pool);
 
                     // Set the trust-region center
                     X::zero(x_tmp1);
@@ -3749,10 +5229,22 @@ namespace Optizelle{
                     Real residual_err0(std::numeric_limits <Real>::quiet_NaN());
                     Real residual_err(std::numeric_limits <Real>::quiet_NaN());
 
-                    switch(krylov_solver) {
+                    // Manipulate the state at the end of each Krylov iteration
+                    KrylovIterationManipulator <Real,Unconstrained <Real,XX> >
+                        kmanip(smanip,fns,state,true);
+
+                    OPTIZELLE_TIMER(krylov_timer,
+                        state.krylov_calls,state.krylov_time)
+                    if(dense.available()) {
+                        dense.solve(delta,krylov_iter_max,dx,krylov_iter,
+                            krylov_stop);
+                        residual_err0 = Real(1.);
+                        residual_err = Real(0.);
+                    } else switch(krylov_solver) {
                     // Truncated conjugate direction
                     case KrylovSolverTruncated::ConjugateDirection:
-                        truncated_cd(
+                        MixedPrecision <Real,XX>::truncated_cd(
+                            krylov_precision,
                             H,
                             minus_grad,
                             PH,
@@ -3769,12 +5261,15 @@ namespace Optizelle{
                             residual_err0,
                             residual_err,
                             krylov_iter,
-                            krylov_stop);
+                            krylov_stop,
+                            kmanip,
+                            work.pool);
                         break;
 
                     // Truncated MINRES 
                     case KrylovSolverTruncated::MINRES:
-                        truncated_minres(
+                        MixedPrecision <Real,XX>::truncated_minres(
+                            krylov_precision,
                             H,
                             minus_grad,
                             PH,
@@ -3790,13 +5285,16 @@ namespace Optizelle{
                             residual_err0,
                             residual_err,
                             krylov_iter,
-                            krylov_stop);
+                            krylov_stop,
+                            kmanip,
+                            work.pool);
 
                         // Force a descent direction
                         if(X::innr(dx,grad) > 0) X::scal(Real(-1.),dx);
                         if(X::innr(dx_cp,grad) > 0) X::scal(Real(-1.),dx_cp);
                         break;
                     }
+                    OPTIZELLE_TIMER_STOP(krylov_timer)
                     krylov_rel_err = residual_err 
                         / (std::numeric_limits <Real>::epsilon()+residual_err0);
                     krylov_iter_total += krylov_iter;
@@ -3806,7 +5304,7 @@ namespace Optizelle{
                         OptimizationLocation::BeforeActualVersusPredicted);
 
                     // Check whether the step is good
-                    if(checkStep(fns,state))
+                    if(checkStep(fns,state,work))
                         break;
                     else
                         rejected_trustregion++;
@@ -3815,8 +5313,10 @@ namespace Optizelle{
                     // history_reset threshold, destroy the quasi-Newton
                     // information
                     if(rejected_trustregion > history_reset){
-                        oldY.clear();
-                        oldS.clear();
+                        work.history.give(oldY);
+                        work.history.give(oldS);
+                        state.oldY_compressed.clear();
+                        state.oldS_compressed.clear();
                     }
 
                     // Manipulate the state if required
@@ -3849,7 +5349,8 @@ namespace Optizelle{
             // Steepest descent search direction
             static void SteepestDescent(
                 typename Functions::t const & fns,
-                typename State::t & state
+                typename State::t & state,
+                Workspace & work
             ) {
                 // Create some shortcuts 
                 ScalarValuedFunctionModifications <Real,XX> const &
@@ -3860,7 +5361,8 @@ namespace Optizelle{
                 X_Vector & dx=state.dx;
 
                 // Determine the gradient for the step computation
-                X_Vector grad_step(X::init(grad));
+                VectorLease <Real,XX> lease(work.pool);
+                X_Vector & grad_step(lease.take(grad));
                     f_mod.grad_step(x,grad,grad_step);
 
                 // We take the steepest descent direction and apply the
@@ -3873,7 +5375,8 @@ namespace Optizelle{
             static void NonlinearCG(
                 typename NonlinearCGDirections::t const & dir,
                 typename Functions::t const & fns,
-                typename State::t & state
+                typename State::t & state,
+                Workspace & work
             ) {
             
                 // Create some shortcuts 
@@ -3895,12 +5398,13 @@ namespace Optizelle{
                 X::scal(1./alpha,dx_old);
 
                 // Determine the gradient for the step computation
-                X_Vector grad_step(X::init(grad));
+                VectorLease <Real,XX> lease(work.pool);
+                X_Vector & grad_step(lease.take(grad));
                     f_mod.grad_step(x,grad,grad_step);
 
                 // If we're on the first iterations, we take the steepest
                 // descent direction
-                if(iter==1) SteepestDescent(fns,state);
+                if(iter==1) SteepestDescent(fns,state,work);
 
                 // On subsequent iterations, we take the specified direction
                 else {
@@ -3908,13 +5412,13 @@ namespace Optizelle{
                     Real beta(std::numeric_limits<Real>::quiet_NaN());
                     switch(dir) {
                     case NonlinearCGDirections::FletcherReeves:
-                        beta=FletcherReeves(fns,state);
+                        beta=FletcherReeves(fns,state,work);
                         break;
                     case NonlinearCGDirections::PolakRibiere:
-                        beta=PolakRibiere(fns,state);
+                        beta=PolakRibiere(fns,state,work);
                         break;
                     case NonlinearCGDirections::HestenesStiefel:
-                        beta=HestenesStiefel(fns,state);
+                        beta=HestenesStiefel(fns,state,work);
                         break;
                     }
 
@@ -3935,7 +5439,8 @@ namespace Optizelle{
             // Fletcher-Reeves CG search direction
             static Real FletcherReeves(
                 typename Functions::t const & fns,
-                typename State::t & state
+                typename State::t & state,
+                Workspace & work
             ) {
                 // Create some shortcuts 
                 ScalarValuedFunctionModifications <Real,XX> const &
@@ -3946,15 +5451,16 @@ namespace Optizelle{
                 X_Vector const & grad_old=state.grad_old;
 
                 // Determine the gradient for the step computation
-                X_Vector grad_step(X::init(grad));
+                VectorLease <Real,XX> lease(work.pool);
+                X_Vector & grad_step(lease.take(grad));
                     f_mod.grad_step(x,grad,grad_step);
-                X_Vector grad_old_step(X::init(grad));
+                X_Vector & grad_old_step(lease.take(grad));
                     f_mod.grad_step(x,grad_old,grad_old_step);
 
                 // Apply the preconditioner to the gradients 
-                X_Vector PH_grad_step(X::init(grad_step));
+                X_Vector & PH_grad_step(lease.take(grad_step));
                     PH.eval(grad_step,PH_grad_step);
-                X_Vector PH_grad_old_step(X::init(grad_old_step));
+                X_Vector & PH_grad_old_step(lease.take(grad_old_step));
                     PH.eval(grad_old_step,PH_grad_old_step);
 
                 // Return the momentum parameter
@@ -3965,7 +5471,8 @@ namespace Optizelle{
             // Polak-Ribiere CG search direction
             static Real PolakRibiere(
                 typename Functions::t const & fns,
-                typename State::t & state
+                typename State::t & state,
+                Workspace & work
             ) {
                 // Create some shortcuts 
                 ScalarValuedFunctionModifications <Real,XX> const &
@@ -3976,20 +5483,21 @@ namespace Optizelle{
                 X_Vector const & grad_old=state.grad_old;
 
                 // Determine the gradient for the step computation
-                X_Vector grad_step(X::init(grad));
+                VectorLease <Real,XX> lease(work.pool);
+                X_Vector & grad_step(lease.take(grad));
                     f_mod.grad_step(x,grad,grad_step);
-                X_Vector grad_old_step(X::init(grad));
+                X_Vector & grad_old_step(lease.take(grad));
                     f_mod.grad_step(x,grad_old,grad_old_step);
 
                 // Find grad-grad_old 
-                X_Vector grad_m_gradold(X::init(grad));
+                X_Vector & grad_m_gradold(lease.take(grad));
                 X::copy(grad_step,grad_m_gradold);
                 X::axpy(Real(-1.),grad_old_step,grad_m_gradold);
                 
                 // Apply the preconditioner to the gradients 
-                X_Vector PH_grad_step(X::init(grad_step));
+                X_Vector & PH_grad_step(lease.take(grad_step));
                     PH.eval(grad_step,PH_grad_step);
-                X_Vector PH_grad_old_step(X::init(grad_old_step));
+                X_Vector & PH_grad_old_step(lease.take(grad_old_step));
                     PH.eval(grad_old_step,PH_grad_old_step);
                     
                 // Return the momentum parameter
@@ -4000,7 +5508,8 @@ namespace Optizelle{
             // Hestenes-Stiefel search direction
             static Real HestenesStiefel(
                 typename Functions::t const & fns,
-                typename State::t & state
+                typename State::t & state,
+                Workspace & work
             ) {
 
                 // Create some shortcuts 
@@ -4013,18 +5522,19 @@ namespace Optizelle{
                 X_Vector const & dx_old=state.dx_old;
 
                 // Determine the gradient for the step computation
-                X_Vector grad_step(X::init(grad));
+                VectorLease <Real,XX> lease(work.pool);
+                X_Vector & grad_step(lease.take(grad));
                     f_mod.grad_step(x,grad,grad_step);
-                X_Vector grad_old_step(X::init(grad));
+                X_Vector & grad_old_step(lease.take(grad));
                     f_mod.grad_step(x,grad_old,grad_old_step);
 
                 // Find grad-grad_old 
-                X_Vector grad_m_gradold(X::init(grad));
+                X_Vector & grad_m_gradold(lease.take(grad));
                 X::copy(grad_step,grad_m_gradold);
                 X::axpy(Real(-1.),grad_old_step,grad_m_gradold);
                 
                 // Apply the preconditioner to the gradient
-                X_Vector PH_grad_step(X::init(grad_step));
+                X_Vector & PH_grad_step(lease.take(grad_step));
                     PH.eval(grad_step,PH_grad_step);
                     
                 // Return the momentum parameter.
@@ -4037,7 +5547,8 @@ namespace Optizelle{
             static void BFGS(
                 Messaging const & msg,
                 typename Functions::t const & fns,
-                typename State::t & state
+                typename State::t & state,
+                Workspace & work
             ) {
                 
                 // Create some shortcuts 
@@ -4048,7 +5559,8 @@ namespace Optizelle{
                 X_Vector & dx=state.dx;
 
                 // Determine the gradient for the step computation
-                X_Vector grad_step(X::init(grad));
+                VectorLease <Real,XX> lease(work.pool);
+                X_Vector & grad_step(lease.take(grad));
                     f_mod.grad_step(x,grad,grad_step);
 
                 // Create the inverse BFGS operator
@@ -4064,7 +5576,8 @@ namespace Optizelle{
             // Compute a Golden-Section search between 0 and alpha0. 
             static typename LineSearchTermination::t goldenSection(
                 typename Functions::t const & fns,
-                typename State::t & state
+                typename State::t & state,
+                Workspace & work
             ) {
                 // Create some shortcuts
                 ScalarValuedFunction <Real,XX> const & f=*(fns.f);
@@ -4079,8 +5592,9 @@ namespace Optizelle{
                 Real & f_xpdx=state.f_xpdx;
                 Real & alpha=state.alpha;
                 
-                // Create one work element that holds x+mu dx or x+lambda dx 
-                X_Vector x_p_dx(X::init(x));
+                // Borrow one work element that holds x+mu dx or x+lambda dx 
+                VectorLease <Real,XX> lease(work.pool);
+                X_Vector & x_p_dx(lease.take(x));
 
                 // Find 1 over the golden ratio
                 Real beta=Real(2./(1.+sqrt(5.)));
@@ -4173,7 +5687,8 @@ namespace Optizelle{
             // in order to do the line-search.
             static void backTracking(
                 typename Functions::t const & fns,
-                typename State::t & state
+                typename State::t & state,
+                Workspace & work
             ) {
                 // Create some shortcuts
                 ScalarValuedFunction <Real,XX> const & f=*(fns.f);
@@ -4189,7 +5704,8 @@ namespace Optizelle{
                 alpha=alpha0;
                
                 // Determine x+alpha dx 
-                X_Vector x_p_adx(X::init(x));
+                VectorLease <Real,XX> lease(work.pool);
+                X_Vector & x_p_adx(lease.take(x));
                     X::copy(x,x_p_adx);
                     X::axpy(alpha,dx,x_p_adx);
     
@@ -4205,7 +5721,8 @@ namespace Optizelle{
             // from Barzilai and Borwein
             static void twoPoint(
                 typename Functions::t const & fns,
-                typename State::t & state
+                typename State::t & state,
+                Workspace & work
             ) {
                 // Create some shortcuts
                 ScalarValuedFunction <Real,XX> const & f=*(fns.f);
@@ -4223,19 +5740,20 @@ namespace Optizelle{
                 Real & f_xpdx=state.f_xpdx;
 
                 // Find delta_x
-                X_Vector delta_x(X::init(x));
+                VectorLease <Real,XX> lease(work.pool);
+                X_Vector & delta_x(lease.take(x));
                     X::copy(x,delta_x);
                     X::axpy(Real(-1.),x_old,delta_x);
 
                 // Determine the gradient for the step computation
-                X_Vector grad_step(X::init(grad));
+                X_Vector & grad_step(lease.take(grad));
                     f_mod.grad_step(x,grad,grad_step);
                 
-                X_Vector grad_old_step(X::init(grad));
+                X_Vector & grad_old_step(lease.take(grad));
                     f_mod.grad_step(x,grad_old,grad_old_step);
 
                 // Find delta_grad
-                X_Vector delta_grad(X::init(x));
+                X_Vector & delta_grad(lease.take(x));
                     X::copy(grad_step,delta_grad);
                     X::axpy(Real(-1.),grad_old_step,delta_grad);
 
@@ -4247,7 +5765,7 @@ namespace Optizelle{
                     alpha=X::innr(delta_x,delta_x)/X::innr(delta_x,delta_grad);
 
                 // Save the objective value at this step
-                X_Vector x_p_adx(X::init(x));
+                X_Vector & x_p_adx(lease.take(x));
                     X::copy(x,x_p_adx);
                     X::axpy(alpha,dx,x_p_adx);
                 f_xpdx=f.eval(x_p_adx);
@@ -4262,7 +5780,8 @@ namespace Optizelle{
                 Messaging const & msg,
                 StateManipulator <Unconstrained <Real,XX> > const & smanip,
                 typename Functions::t const & fns,
-                typename State::t & state
+                typename State::t & state,
+                Workspace & work
             ){
                 // Create some shortcuts
                 ScalarValuedFunction <Real,XX> const & f=*(fns.f);
@@ -4297,34 +5816,36 @@ namespace Optizelle{
                 smanip.eval(fns,state,OptimizationLocation::BeforeGetStep);
 
                 // Create the trust-region center 
-                X_Vector x_cntr(X::init(x));
+                VectorLease <Real,XX> lease(work.pool);
+                X_Vector & x_cntr(lease.take(x));
                 X::zero(x_cntr);
 
                 // Find the line-search direction
                 switch(dir){
                 case LineSearchDirection::SteepestDescent:
-                    SteepestDescent(fns,state);
+                    SteepestDescent(fns,state,work);
                     break;
                 case LineSearchDirection::FletcherReeves:
                     NonlinearCG(NonlinearCGDirections::FletcherReeves,
-                        fns,state);
+                        fns,state,work);
                     break;
                 case LineSearchDirection::PolakRibiere:
-                    NonlinearCG(NonlinearCGDirections::PolakRibiere,fns,state);
+                    NonlinearCG(NonlinearCGDirections::PolakRibiere,fns,state,
+                        work);
                     break;
                 case LineSearchDirection::HestenesStiefel:
                     NonlinearCG(NonlinearCGDirections::HestenesStiefel,
-                        fns,state);
+                        fns,state,work);
                     break;
                 case LineSearchDirection::BFGS:
-                    BFGS(msg,fns,state);
+                    BFGS(msg,fns,state,work);
                     break;
                 case LineSearchDirection::NewtonCG: {
-                    HessianOperator H(f,f_mod,x);
-                    X_Vector dx_cp(X::init(x));
-                    X_Vector grad_step(X::init(grad));
+                    HessianOperator H(f,f_mod,x,work.pool);
+                    X_Vector & dx_cp(lease.take(x));
+                    X_Vector & grad_step(lease.take(grad));
                         f_mod.grad_step(x,grad,grad_step);
-                    X_Vector minus_grad(X::init(x));
+                    X_Vector & minus_grad(lease.take(x));
                         X::copy(grad_step,minus_grad);
                         X::scal(Real(-1.),minus_grad);
 
@@ -4332,6 +5853,12 @@ namespace Optizelle{
                     Real residual_err0(std::numeric_limits <Real>::quiet_NaN());
                     Real residual_err(std::numeric_limits <Real>::quiet_NaN());
 
+                    // Manipulate the state at the end of each Krylov iteration
+                    KrylovIterationManipulator <Real,Unconstrained <Real,XX> >
+                        kmanip(smanip,fns,state,true);
+
+                    OPTIZELLE_TIMER(krylov_timer,
+                        state.krylov_calls,state.krylov_time)
                     switch(krylov_solver) {
                     // Truncated conjugate direction
                     case KrylovSolverTruncated::ConjugateDirection:
@@ -4352,7 +5879,9 @@ namespace Optizelle{
                             residual_err0,
                             residual_err,
                             krylov_iter,
-                            krylov_stop);
+                            krylov_stop,
+                            kmanip,
+                            work.pool);
                         break;
 
                     // Truncated MINRES 
@@ -4373,13 +5902,16 @@ namespace Optizelle{
                             residual_err0,
                             residual_err,
                             krylov_iter,
-                            krylov_stop);
+                            krylov_stop,
+                            kmanip,
+                            work.pool);
 
                         // Force a descent direction
                         if(X::innr(dx,grad_step) > 0) X::scal(Real(-1.),dx);
                         if(X::innr(dx_cp,grad_step)>0) X::scal(Real(-1.),dx_cp);
                         break;
                     }
+                    OPTIZELLE_TIMER_STOP(krylov_timer)
                     krylov_rel_err = residual_err 
                         / (std::numeric_limits <Real>::epsilon()+residual_err0);
                     krylov_iter_total += krylov_iter;
@@ -4395,11 +5927,11 @@ namespace Optizelle{
                     Real merit_x = f_mod.merit(x,f_x);
                     
                     // Determine the gradient at x
-                    X_Vector grad_step(X::init(x));
+                    X_Vector & grad_step(lease.take(x));
                         f_mod.grad_step(x,grad,grad_step);
                 
                     // Allocate memory for x+alpha dx 
-                    X_Vector x_p_adx(X::init(x));
+                    X_Vector & x_p_adx(lease.take(x));
 
                     // Keep track of whether or not we hit a bound with the
                     // line-search
@@ -4418,9 +5950,9 @@ namespace Optizelle{
                             (!LineSearchKind::is_sufficient_decrease(kind) &&
                             iter==1)
                         )
-                            ls_why=goldenSection(fns,state);
+                            ls_why=goldenSection(fns,state,work);
                         else if(kind==LineSearchKind::BackTracking)
-                            backTracking(fns,state);
+                            backTracking(fns,state,work);
                         else if(kind==LineSearchKind::Brents) 
                             msg.error("Brent's linesearch is not currently "
                                 "implemented.");
@@ -4496,7 +6028,7 @@ namespace Optizelle{
                 // Do the line-searches that are not based on sufficient
                 // decrease
                 } else 
-                    twoPoint(fns,state);
+                    twoPoint(fns,state,work);
 
                 // Adjust the size of the step (apply the line-search 
                 // parameter.)
@@ -4514,7 +6046,8 @@ namespace Optizelle{
                 Messaging const & msg,
                 StateManipulator <Unconstrained <Real,XX> > const & smanip,
                 typename Functions::t const & fns,
-                typename State::t & state
+                typename State::t & state,
+                Workspace & work
             ){
                 // Create some shortcuts
                 AlgorithmClass::t const & algorithm_class=state.algorithm_class;
@@ -4522,10 +6055,10 @@ namespace Optizelle{
                 // Choose whether we use a line-search or trust-region method
                 switch(algorithm_class){
                 case AlgorithmClass::TrustRegion:
-                    getStepTR(msg,smanip,fns,state);
+                    getStepTR(msg,smanip,fns,state,work);
                     break;
                 case AlgorithmClass::LineSearch:
-                    getStepLS(msg,smanip,fns,state);
+                    getStepLS(msg,smanip,fns,state,work);
                     break;
                 case AlgorithmClass::UserDefined:
                     smanip.eval(fns,state,OptimizationLocation::GetStep);
@@ -4536,7 +6069,8 @@ namespace Optizelle{
             // Updates the quasi-Newton information
             static void updateQuasi(
                 typename Functions::t const & fns,
-                typename State::t & state
+                typename State::t & state,
+                Workspace & work
             ){
                 // Exit immediately if we're not using a quasi-Newton method
                 if(state.stored_history==0) return;
@@ -4554,18 +6088,26 @@ namespace Optizelle{
                 std::list <X_Vector>& oldY=state.oldY;
                 std::list <X_Vector>& oldS=state.oldS;
                
-                // Allocate some temp storage for y and s
-                X_Vector s(X::init(x));
-                X_Vector y(X::init(x));
+                // Borrow storage for y and s.  If we keep them, we move them
+                // into the quasi-Newton storage.  Otherwise, they go back to
+                // the pool.
+                VectorLease <Real,XX> quasi(work.history);
+                std::list <X_Vector> & s_new(quasi.list());
+                std::list <X_Vector> & y_new(quasi.list());
+                work.history.take(x,s_new);
+                work.history.take(x,y_new);
+                X_Vector & s(s_new.back());
+                X_Vector & y(y_new.back());
 
                 // Find s = x-x_old
                 X::copy(x,s);
                 X::axpy(Real(-1.),x_old,s);
                 
                 // Determine the gradient for the quasi-Newton computation 
-                X_Vector grad_quasi(X::init(grad));
+                VectorLease <Real,XX> lease(work.pool);
+                X_Vector & grad_quasi(lease.take(grad));
                     f_mod.grad_quasi(x,grad,grad_quasi);
-                X_Vector grad_old_quasi(X::init(grad_old));
+                X_Vector & grad_old_quasi(lease.take(grad_old));
                     f_mod.grad_quasi(x,grad_old,grad_old_quasi);
 
                 // Find y = grad - grad_old
@@ -4579,14 +6121,26 @@ namespace Optizelle{
                     && X::innr(y,s) <= Real(0.))
                     return;
 
-                // Insert these into the quasi-Newton storage
-                oldS.emplace_front(std::move(s));
-                oldY.emplace_front(std::move(y));
+                // Insert these into the quasi-Newton storage.  When we store
+                // the history in the lower precision, we round the new pair
+                // and return the originals to the pool.
+                State::storeHistory(state);
+                if(State::compressHistory(state)) {
+                    state.oldS_compressed.push_front(s);
+                    state.oldY_compressed.push_front(y);
+                    if(state.oldS_compressed.size()>state.stored_history){
+                        state.oldS_compressed.pop_back();
+                        state.oldY_compressed.pop_back();
+                    }
+                    return;
+                }
+                oldS.splice(oldS.begin(),s_new);
+                oldY.splice(oldY.begin(),y_new);
 
                 // Determine if we need to free some memory
                 if(oldS.size()>state.stored_history){
-                    oldS.pop_back();
-                    oldY.pop_back();
+                    work.history.give_back(oldS);
+                    work.history.give_back(oldY);
                 }
             }
 
@@ -4614,6 +6168,9 @@ namespace Optizelle{
                 Real & norm_dxtyp=state.norm_dxtyp;
                 Natural & iter=state.iter;
                 StoppingCondition::t & opt_stop=state.opt_stop;
+
+                // Create the memory that we reuse between iterations
+                Workspace work(state);
                 
                 // Manipulate the state if required
                 smanip.eval(fns,state,
@@ -4632,7 +6189,8 @@ namespace Optizelle{
                     // gradient first and then possibly cache the objective
                     f.grad(x,grad);
                     f_x=f.eval(x);
-                    X_Vector grad_stop(X::init(grad));
+                    VectorLease <Real,XX> lease(work.pool);
+                    X_Vector & grad_stop(lease.take(grad));
                         f_mod.grad_stop(x,grad,grad_stop);
                     norm_gradtyp=sqrt(X::innr(grad_stop,grad_stop));
 
@@ -4665,7 +6223,7 @@ namespace Optizelle{
                         OptimizationLocation::BeginningOfOptimizationLoop);
 
                     // Get a new optimization iterate.  
-                    getStep(msg,smanip,fns,state);
+                    getStep(msg,smanip,fns,state,work);
 
                     // Manipulate the state if required
                     smanip.eval(fns,state,OptimizationLocation::BeforeSaveOld);
@@ -4681,6 +6239,7 @@ namespace Optizelle{
 
                     // Move to the new iterate
                     X::axpy(Real(1.),dx,x);
+                    state.x_version=++state.version;
 
                     // Manipulate the state if required
                     smanip.eval(fns,state,
@@ -4697,7 +6256,7 @@ namespace Optizelle{
                     smanip.eval(fns,state,OptimizationLocation::BeforeQuasi);
 
                     // Update the quasi-Newton information
-                    updateQuasi(fns,state);
+                    updateQuasi(fns,state,work);
                     
                     // Manipulate the state if required
                     smanip.eval(fns,state,OptimizationLocation::AfterQuasi);
@@ -4706,7 +6265,7 @@ namespace Optizelle{
                     iter++;
                     
                     // Check the stopping condition
-                    opt_stop=checkStop(fns,state);
+                    opt_stop=checkStop(fns,state,work);
 
                     // Manipulate the state if required
                     smanip.eval(fns,state,
@@ -4738,6 +6297,22 @@ namespace Optizelle{
                 typename Functions::t & fns,
                 typename State::t & state,
                 StateManipulator <Unconstrained <Real,XX> > const & smanip
+            ){
+                // Print the diagnostic information as text
+                TextTelemetry <Real> sink(msg);
+
+                // Minimize the problem
+                getMin(msg,fns,state,smanip,sink);
+            }
+
+            // Initializes remaining functions then solves an optimization
+            // problem while sending the diagnostic information to sink
+            static void getMin(
+                Messaging const & msg,
+                typename Functions::t & fns,
+                typename State::t & state,
+                StateManipulator <Unconstrained <Real,XX> > const & smanip,
+                TelemetrySink <Real> & sink
             ){
                 // Initialize any remaining functions required for optimization 
                 Functions::init(msg,state,fns);
@@ -4746,11 +6321,23 @@ namespace Optizelle{
                 State::check(msg,state);
 
                 // Add the output to the state manipulator
-                DiagnosticManipulator <Unconstrained<Real,XX> >
-                    dmanip(smanip,msg);
+                DiagnosticManipulator <Real,Unconstrained <Real,XX> >
+                    dmanip(smanip,msg,sink);
+
+                // Announce new iterates to the functions
+                LinearizationManipulator <Unconstrained<Real,XX> >
+                    lmanip(dmanip);
+
+                // Record the phases between the optimization locations
+                #ifdef OPTIZELLE_TRACING
+                TracingManipulator <Unconstrained <Real,XX> > tmanip(lmanip);
+                #else
+                auto const & tmanip = lmanip;
+                #endif
 
                 // Minimize the problem
-                getMin_(msg,dmanip,fns,state);
+                OPTIZELLE_TRACE(trace,"getMin","solver")
+                getMin_(msg,tmanip,fns,state);
             }
         };
     };
@@ -4778,42 +6365,63 @@ namespace Optizelle{
         // This defines a product space between X and Y
         template <typename Real_>
         struct XXxYY {
-            typedef std::pair <X_Vector,Y_Vector> Vector;
+            typedef std::pair <
+                typename XX <Real_>::Vector,
+                typename YY <Real_>::Vector> Vector;
 
             // Memory allocation and size setting
             static Vector init(Vector const & x) {
-                return std::move(std::pair <X_Vector,Y_Vector> (
-                        X::init(x.first),
-                        Y::init(x.second)));
+                return std::move(Vector(
+                        XX <Real_>::init(x.first),
+                        YY <Real_>::init(x.second)));
             }
 
             // y <- x (Shallow.  No memory allocation.)
             static void copy(Vector const & x, Vector & y) {
-                X::copy(x.first,y.first);
-                Y::copy(x.second,y.second);
+                XX <Real_>::copy(x.first,y.first);
+                YY <Real_>::copy(x.second,y.second);
             }
 
             // x <- alpha * x
             static void scal(Real_ const & alpha, Vector & x) {
-                X::scal(alpha,x.first);
-                Y::scal(alpha,x.second);
+                XX <Real_>::scal(alpha,x.first);
+                YY <Real_>::scal(alpha,x.second);
             }
 
             // x <- 0 
             static void zero(Vector & x) {
-                X::zero(x.first);
-                Y::zero(x.second);
+                XX <Real_>::zero(x.first);
+                YY <Real_>::zero(x.second);
             }
 
             // y <- alpha * x + y
             static void axpy(Real_ const & alpha, Vector const & x, Vector & y){
-                X::axpy(alpha,x.first,y.first);
-                Y::axpy(alpha,x.second,y.second);
+                XX <Real_>::axpy(alpha,x.first,y.first);
+                YY <Real_>::axpy(alpha,x.second,y.second);
             }
 
             // innr <- <x,y>
             static Real_ innr(Vector const & x,Vector const & y) {
-                return X::innr(x.first,y.first) + Y::innr(x.second,y.second);
+                return XX <Real_>::innr(x.first,y.first)
+                    + YY <Real_>::innr(x.second,y.second);
+            }
+
+            // Memory allocation and size setting in the precision Real2
+            template <typename Real2>
+            static typename XXxYY <Real2>::Vector init_prec(Vector const & x){
+                return std::move(typename XXxYY <Real2>::Vector(
+                    XX <Real_>::template init_prec <Real2> (x.first),
+                    YY <Real_>::template init_prec <Real2> (x.second)));
+            }
+
+            // y <- x where y is stored in the precision Real2
+            template <typename Real2>
+            static void copy_prec(
+                Vector const & x,
+                typename XXxYY <Real2>::Vector & y
+            ) {
+                XX <Real_>::template copy_prec <Real2> (x.first,y.first);
+                YY <Real_>::template copy_prec <Real2> (x.second,y.second);
             }
         };
         typedef XXxYY <Real> XxY;
@@ -4837,6 +6445,9 @@ namespace Optizelle{
                 // Equality multiplier (dual variable or Lagrange multiplier)
                 Y_Vector y;
 
+                // Version token for y 
+                Natural y_version;
+
                 // Step in the equality multiplier 
                 Y_Vector dy;
 
@@ -4900,6 +6511,12 @@ namespace Optizelle{
 
                 // How often we restart the augmented system solve
                 Natural augsys_rst_freq;
+
+                // Number of augmented system iterations that we didn't have
+                // to repeat since, after tightening the tolerances in the
+                // step computation, we continued the solves from where they
+                // left off rather than from scratch
+                Natural augsys_iter_saved;
                 
                 // Equality constraint evaluated at x.  We use this in the
                 // quasinormal step as well as in the computation of the
@@ -4953,11 +6570,54 @@ namespace Optizelle{
 
                 // Function diagnostics on g
                 FunctionDiagnostics::t g_diag;
+
+                // Number of evaluations of the equality constraint
+                Natural g_eval_calls;
+
+                // Time spent evaluating the equality constraint
+                Real g_eval_time;
+
+                // Number of derivatives of the equality constraint
+                Natural g_p_calls;
+
+                // Time spent computing derivatives of the equality constraint
+                Real g_p_time;
+
+                // Number of adjoint derivatives of the equality constraint
+                Natural g_ps_calls;
+
+                // Time spent computing adjoint derivatives of the equality
+                // constraint
+                Real g_ps_time;
+
+                // Number of second derivatives of the equality constraint
+                Natural g_pps_calls;
+
+                // Time spent computing second derivatives of the equality
+                // constraint
+                Real g_pps_time;
+
+                // Number of applications of the left preconditioner for the
+                // augmented system
+                Natural PSchur_left_calls;
+
+                // Time spent applying the left preconditioner for the augmented
+                // system
+                Real PSchur_left_time;
+
+                // Number of applications of the right preconditioner for the
+                // augmented system
+                Natural PSchur_right_calls;
+
+                // Time spent applying the right preconditioner for the
+                // augmented system
+                Real PSchur_right_time;
                 
                 // Initialization constructors
                 explicit t(X_Vector const & x_user,Y_Vector const & y_user) : 
                     Unconstrained <Real,XX>::State::t(x_user),
                     y(Y::init(y_user)),
+                    y_version(0),
                     dy(
                         //---dy0---
                         Y::init(y_user)
@@ -5058,6 +6718,11 @@ namespace Optizelle{
                         0
                         //---augsys_rst_freq1---
                     ),
+                    augsys_iter_saved(
+                        //---augsys_iter_saved0---
+                        0
+                        //---augsys_iter_saved1---
+                    ),
                     g_x(
                         //---g_x0---
                         Y::init(y_user)
@@ -5127,6 +6792,66 @@ namespace Optizelle{
                         //---g_diag0---
                         FunctionDiagnostics::NoDiagnostics
                         //---g_diag1---
+                    ),
+                    g_eval_calls(
+                        //---g_eval_calls0---
+                        0
+                        //---g_eval_calls1---
+                    ),
+                    g_eval_time(
+                        //---g_eval_time0---
+                        0.
+                        //---g_eval_time1---
+                    ),
+                    g_p_calls(
+                        //---g_p_calls0---
+                        0
+                        //---g_p_calls1---
+                    ),
+                    g_p_time(
+                        //---g_p_time0---
+                        0.
+                        //---g_p_time1---
+                    ),
+                    g_ps_calls(
+                        //---g_ps_calls0---
+                        0
+                        //---g_ps_calls1---
+                    ),
+                    g_ps_time(
+                        //---g_ps_time0---
+                        0.
+                        //---g_ps_time1---
+                    ),
+                    g_pps_calls(
+                        //---g_pps_calls0---
+                        0
+                        //---g_pps_calls1---
+                    ),
+                    g_pps_time(
+                        //---g_pps_time0---
+                        0.
+                        //---g_pps_time1---
+                    ),
+                    PSchur_left_calls(
+                        //---PSchur_left_calls0---
+                        0
+                        //---PSchur_left_calls1---
+                    ),
+                    PSchur_left_time(
+                        //---PSchur_left_time0---
+                        0.
+                        //---PSchur_left_time1---
+                    ),
+                    PSchur_right_calls(
+                        //---PSchur_right_calls0---
+                        0
+                        //---PSchur_right_calls1---
+                    ),
+                    PSchur_right_time(
+                        //---PSchur_right_time0---
+                        0.
+                        //---PSchur_right_time1---
                     )
                 {
                         //---y0---
@@ -5335,6 +7060,10 @@ namespace Optizelle{
                     // Any
                     //---augsys_rst_freq_valid1---
                     
+                    //---augsys_iter_saved_valid0---
+                    // Any
+                    //---augsys_iter_saved_valid1---
+                    
                     //---g_x_valid0---
                     // Any
                     //---g_x_valid1---
@@ -5398,6 +7127,54 @@ namespace Optizelle{
                     // Any
                     //---g_diag_valid1---
 
+                    //---g_eval_calls_valid0---
+                    // Any
+                    //---g_eval_calls_valid1---
+
+                    //---g_eval_time_valid0---
+                    // Any
+                    //---g_eval_time_valid1---
+
+                    //---g_p_calls_valid0---
+                    // Any
+                    //---g_p_calls_valid1---
+
+                    //---g_p_time_valid0---
+                    // Any
+                    //---g_p_time_valid1---
+
+                    //---g_ps_calls_valid0---
+                    // Any
+                    //---g_ps_calls_valid1---
+
+                    //---g_ps_time_valid0---
+                    // Any
+                    //---g_ps_time_valid1---
+
+                    //---g_pps_calls_valid0---
+                    // Any
+                    //---g_pps_calls_valid1---
+
+                    //---g_pps_time_valid0---
+                    // Any
+                    //---g_pps_time_valid1---
+
+                    //---PSchur_left_calls_valid0---
+                    // Any
+                    //---PSchur_left_calls_valid1---
+
+                    //---PSchur_left_time_valid0---
+                    // Any
+                    //---PSchur_left_time_valid1---
+
+                    //---PSchur_right_calls_valid0---
+                    // Any
+                    //---PSchur_right_calls_valid1---
+
+                    //---PSchur_right_time_valid0---
+                    // Any
+                    //---PSchur_right_time_valid1---
+
                 // If there's an error, print it
                 if(ss.str()!="") msg.error(ss.str());
             }
@@ -5439,7 +7216,13 @@ namespace Optizelle{
                     item.first == "xi_4" ||
                     item.first == "rpred" ||
                     item.first == "norm_gxtyp" ||
-                    item.first == "norm_gpxdxnpgx" 
+                    item.first == "norm_gpxdxnpgx" ||
+                    item.first == "g_eval_time" ||
+                    item.first == "g_p_time" ||
+                    item.first == "g_ps_time" ||
+                    item.first == "g_pps_time" ||
+                    item.first == "PSchur_left_time" ||
+                    item.first == "PSchur_right_time"
                 )
                     return true;
                 else
@@ -5452,7 +7235,14 @@ namespace Optizelle{
             ) {
                 if( Unconstrained <Real,XX>::Restart::is_nat(item) ||
                     item.first == "augsys_iter_max" ||
-                    item.first == "augsys_rst_freq"
+                    item.first == "augsys_rst_freq" ||
+                    item.first == "augsys_iter_saved" ||
+                    item.first == "g_eval_calls" ||
+                    item.first == "g_p_calls" ||
+                    item.first == "g_ps_calls" ||
+                    item.first == "g_pps_calls" ||
+                    item.first == "PSchur_left_calls" ||
+                    item.first == "PSchur_right_calls"
                 )
                     return true;
                 else
@@ -5581,12 +7371,30 @@ namespace Optizelle{
                 reals.emplace_back("norm_gxtyp",std::move(state.norm_gxtyp));
                 reals.emplace_back("norm_gpxdxnpgx",
                     std::move(state.norm_gpxdxnpgx));
+                reals.emplace_back("g_eval_time",std::move(state.g_eval_time));
+                reals.emplace_back("g_p_time",std::move(state.g_p_time));
+                reals.emplace_back("g_ps_time",std::move(state.g_ps_time));
+                reals.emplace_back("g_pps_time",std::move(state.g_pps_time));
+                reals.emplace_back("PSchur_left_time",
+                    std::move(state.PSchur_left_time));
+                reals.emplace_back("PSchur_right_time",
+                    std::move(state.PSchur_right_time));
 
                 // Copy in all the natural numbers
                 nats.emplace_back("augsys_iter_max",
                     std::move(state.augsys_iter_max));
                 nats.emplace_back("augsys_rst_freq",
                     std::move(state.augsys_rst_freq));
+                nats.emplace_back("augsys_iter_saved",
+                    std::move(state.augsys_iter_saved));
+                nats.emplace_back("g_eval_calls",std::move(state.g_eval_calls));
+                nats.emplace_back("g_p_calls",std::move(state.g_p_calls));
+                nats.emplace_back("g_ps_calls",std::move(state.g_ps_calls));
+                nats.emplace_back("g_pps_calls",std::move(state.g_pps_calls));
+                nats.emplace_back("PSchur_left_calls",
+                    std::move(state.PSchur_left_calls));
+                nats.emplace_back("PSchur_right_calls",
+                    std::move(state.PSchur_right_calls));
 
                 // Copy in all the parameters
                 params.emplace_back("PSchur_left_type",
@@ -5607,9 +7415,10 @@ namespace Optizelle{
                     item!=ys.end();
                     item++
                 ){
-                    if(item->first=="y")
+                    if(item->first=="y") {
                         state.y = std::move(item->second);
-                    else if(item->first=="dy")
+                        state.y_version=++state.version;
+                    } else if(item->first=="dy")
                         state.dy = std::move(item->second);
                     else if(item->first=="g_x")
                         state.g_x = std::move(item->second);
@@ -5686,6 +7495,18 @@ namespace Optizelle{
                         state.norm_gxtyp=std::move(item->second);
                     else if(item->first=="norm_gpxdxnpgx")
                         state.norm_gpxdxnpgx=std::move(item->second);
+                    else if(item->first=="g_eval_time")
+                        state.g_eval_time=std::move(item->second);
+                    else if(item->first=="g_p_time")
+                        state.g_p_time=std::move(item->second);
+                    else if(item->first=="g_ps_time")
+                        state.g_ps_time=std::move(item->second);
+                    else if(item->first=="g_pps_time")
+                        state.g_pps_time=std::move(item->second);
+                    else if(item->first=="PSchur_left_time")
+                        state.PSchur_left_time=std::move(item->second);
+                    else if(item->first=="PSchur_right_time")
+                        state.PSchur_right_time=std::move(item->second);
                 }
                 
                 // Next, copy in any naturals
@@ -5697,6 +7518,20 @@ namespace Optizelle{
                         state.augsys_iter_max=std::move(item->second);
                     else if(item->first=="augsys_rst_freq")
                         state.augsys_rst_freq=std::move(item->second);
+                    else if(item->first=="augsys_iter_saved")
+                        state.augsys_iter_saved=std::move(item->second);
+                    else if(item->first=="g_eval_calls")
+                        state.g_eval_calls=std::move(item->second);
+                    else if(item->first=="g_p_calls")
+                        state.g_p_calls=std::move(item->second);
+                    else if(item->first=="g_ps_calls")
+                        state.g_ps_calls=std::move(item->second);
+                    else if(item->first=="g_pps_calls")
+                        state.g_pps_calls=std::move(item->second);
+                    else if(item->first=="PSchur_left_calls")
+                        state.PSchur_left_calls=std::move(item->second);
+                    else if(item->first=="PSchur_right_calls")
+                        state.PSchur_right_calls=std::move(item->second);
                 }
                 
                 // Next, copy in any parameters 
@@ -5791,9 +7626,13 @@ namespace Optizelle{
                 // Right preconditioner for the augmented system
                 std::unique_ptr <Operator <Real,YY,YY> > PSchur_right;
                 
+                // Equality constraint's interest in new iterates
+                LinearizationSession <Real,XX> * g_session;
+                
                 // Initialize all of the pointers to null
                 t() : Unconstrained <Real,XX>::Functions::t(), g(nullptr),
-                    PSchur_left(nullptr), PSchur_right(nullptr) {}
+                    PSchur_left(nullptr), PSchur_right(nullptr),
+                    g_session(nullptr) {}
             };
 
             struct EqualityModifications
@@ -5823,12 +7662,12 @@ namespace Optizelle{
                 mutable X_Vector x_tmp1;
                 mutable Y_Vector y_tmp1;
 
-                // Variables used for caching.  The boolean values denote
-                // whether or not we've started caching yet.
-                mutable std::pair <bool,X_Vector> x_merit;
+                // Variables used for caching.  These track the x and y
+                // used for each cached quantity.
+                mutable VersionedCache <Real,XX> x_merit;
                 mutable Y_Vector g_x;
-                mutable std::pair <bool,X_Vector> x_grad;
-                mutable std::pair <bool,Y_Vector> y_grad;
+                mutable VersionedCache <Real,XX> x_grad;
+                mutable VersionedCache <Real,YY> y_grad;
                 mutable X_Vector gpxsy; 
 
                 // Adds the Lagrangian pieces to the gradient
@@ -5840,21 +7679,14 @@ namespace Optizelle{
                     // grad_lag <- grad f(x)
                     X::copy(grad,grad_lag);
                     
-                    // If relative error between the current and cached values
-                    // is large, compute anew.
-                    if( rel_err_cached <Real,XX> (x,x_grad)
-                            >= std::numeric_limits <Real>::epsilon()*1e1 ||
-                        rel_err_cached <Real,YY> (y,y_grad)
-                            >= std::numeric_limits <Real>::epsilon()*1e1 
-                    ) {
+                    // If x or y differ from the cached values, compute anew.
+                    if(!x_grad.current(x) || !y_grad.current(y)) {
                         // gpxsy <- g'(x)* y 
                         g.ps(x,y,gpxsy);
 
                         // Cache the values
-                        x_grad.first=true;
-                        X::copy(x,x_grad.second);
-                        y_grad.first=true;
-                        Y::copy(y,y_grad.second);
+                        x_grad.update(x);
+                        y_grad.update(y);
                     }
 
                     // grad <- grad f(x) + g'(x)*y 
@@ -5872,10 +7704,10 @@ namespace Optizelle{
                     grad_tmp(X::init(state.x)),
                     x_tmp1(X::init(state.x)),
                     y_tmp1(Y::init(state.y)),
-                    x_merit(false,X::init(state.x)),
+                    x_merit(state.x,state.x_version),
                     g_x(Y::init(state.y)),
-                    x_grad(false,X::init(state.x)),
-                    y_grad(false,Y::init(state.y)),
+                    x_grad(state.x,state.x_version),
+                    y_grad(state.y,state.y_version),
                     gpxsy(X::init(state.x))
                 { }
 
@@ -5884,17 +7716,14 @@ namespace Optizelle{
                     // Do the underlying modification of the objective
                     Real merit_x = f_mod->merit(x,f_x);
                     
-                    // If we've not started caching or the relative error
-                    // is large, compute anew.
-                    if( rel_err_cached <Real,XX> (x,x_merit)
-                            >= std::numeric_limits <Real>::epsilon()*1e1
-                    ) {
+                    // If we've not started caching or x differs from the
+                    // cached value, compute anew.
+                    if(!x_merit.current(x)) {
                         // g_x <- g(x)
                         g.eval(x,g_x);
                     
                         // Cache the values
-                        x_merit.first=true;
-                        X::copy(x,x_merit.second);
+                        x_merit.update(x);
                     }
 
                     // Return f(x) + < y,g(x) > + rho || g(x) ||^2   
@@ -5969,6 +7798,11 @@ namespace Optizelle{
                     // Hdx_step <- hess f(x)dx + (g''(x)dx)*y  
                     X::axpy(Real(1.),x_tmp1,Hdx_step);
                 }
+
+                // We add (g''(x)dx)*y to the Hessian-vector product
+                virtual bool modifies_hessvec() const {
+                    return true;
+                }
             };
 
             // The identity operator 
@@ -6001,7 +7835,7 @@ namespace Optizelle{
             // optimization.
             static void init_(
                 Messaging const & msg,
-                typename State::t const & state,
+                typename State::t & state,
                 t & fns
             ) {
                 // Determine the left preconditioner for the augmented system
@@ -6040,6 +7874,44 @@ namespace Optizelle{
 
                 // Check that all functions are defined 
                 check(msg,fns);
+
+                // Find whether the constraint wants to hear about new iterates
+                // unless we've already wrapped it
+                if(dynamic_cast <TimedVectorValuedFunction <Real,XX,YY> *> (
+                    fns.g.get())==nullptr
+                )
+                    fns.g_session=dynamic_cast <LinearizationSession<Real,XX>*>(
+                        fns.g.get());
+
+                #if defined(OPTIZELLE_INSTRUMENTATION) \
+                    || defined(OPTIZELLE_TRACING)
+                // Time and trace the constraint and the preconditioners
+                // unless we've already done so
+                if(dynamic_cast <TimedVectorValuedFunction <Real,XX,YY> *> (
+                    fns.g.get())==nullptr
+                )
+                    fns.g.reset(new TimedVectorValuedFunction <Real,XX,YY> (
+                        std::move(fns.g),
+                        state.g_eval_calls,state.g_eval_time,
+                        state.g_p_calls,state.g_p_time,
+                        state.g_ps_calls,state.g_ps_time,
+                        state.g_pps_calls,state.g_pps_time,
+                        {{"g.eval","g.p","g.ps","g.pps"}}));
+                if(dynamic_cast <TimedOperator <Real,YY,YY> *> (
+                    fns.PSchur_left.get())==nullptr
+                )
+                    fns.PSchur_left.reset(new TimedOperator <Real,YY,YY> (
+                        std::move(fns.PSchur_left),
+                        state.PSchur_left_calls,state.PSchur_left_time,
+                        "PSchur_left"));
+                if(dynamic_cast <TimedOperator <Real,YY,YY> *> (
+                    fns.PSchur_right.get())==nullptr
+                )
+                    fns.PSchur_right.reset(new TimedOperator <Real,YY,YY> (
+                        std::move(fns.PSchur_right),
+                        state.PSchur_right_calls,state.PSchur_right_time,
+                        "PSchur_right"));
+                #endif
                 
                 // Modify the objective 
                 fns.f_mod.reset(new EqualityModifications(state,fns));
@@ -6048,7 +7920,7 @@ namespace Optizelle{
             // Initialize any missing functions 
             static void init(
                 Messaging const & msg,
-                typename State::t const & state,
+                typename State::t & state,
                 t & fns
             ) {
                 Unconstrained <Real,XX>
@@ -6056,6 +7928,23 @@ namespace Optizelle{
                 EqualityConstrained <Real,XX,YY>
                     ::Functions::init_(msg,state,fns);
             }
+
+            // Announces the current iterate to the functions that want it
+            static void linearize_(
+                t const & fns,
+                typename State::t const & state
+            ) {
+                if(fns.g_session!=nullptr)
+                    fns.g_session->announce(state.x,state.x_version);
+            }
+            static void linearize(
+                t const & fns,
+                typename State::t const & state
+            ) {
+                Unconstrained <Real,XX>::Functions::linearize_(fns,state);
+                EqualityConstrained <Real,XX,YY>::Functions::linearize_(
+                    fns,state);
+            }
         };
         
         // Contains functions that assist in creating an output for diagonstics
@@ -6066,32 +7955,40 @@ namespace Optizelle{
             // Gets the header for the state information
             static void getStateHeader_(
                 typename State::t const & state,
-                std::list <std::string> & out
+                std::vector <std::string> & out
             ) { 
                 // Create some shortcuts
                 Natural const & msg_level = state.msg_level; 
 
                 // Norm of the constrained 
-                out.emplace_back(Utility::atos("||g(x)||"));
+                out.emplace_back("||g(x)||");
                 
                 // More detailed information
                 if(msg_level>=2) {
                     // Trust-region information
-                    out.emplace_back(Utility::atos("ared"));
-                    out.emplace_back(Utility::atos("pred"));
-                    out.emplace_back(Utility::atos("ared/pred"));
-                    out.emplace_back(Utility::atos("delta"));
+                    out.emplace_back("ared");
+                    out.emplace_back("pred");
+                    out.emplace_back("ared/pred");
+                    out.emplace_back("delta");
                        
                     // Krylov method information
-                    out.emplace_back(Utility::atos("KryIter"));
-                    out.emplace_back(Utility::atos("KryErr"));
-                    out.emplace_back(Utility::atos("KryWhy"));
+                    out.emplace_back("KryIter");
+                    out.emplace_back("KryErr");
+                    out.emplace_back("KryWhy");
+                }
+
+                #ifdef OPTIZELLE_INSTRUMENTATION
+                // Cumulative timings
+                if(msg_level >= 3) {
+                    out.emplace_back("time(g)");
+                    out.emplace_back("time(Schur)");
                 }
+                #endif
             }
             // Combines all of the state headers
             static void getStateHeader(
                 typename State::t const & state,
-                std::list <std::string> & out
+                std::vector <std::string> & out
             ) {
                 Unconstrained <Real,XX>::Diagnostics::getStateHeader_(
                     state,out);
@@ -6103,8 +8000,7 @@ namespace Optizelle{
             static void getState_(
                 typename Functions::t const & fns,
                 typename State::t const & state,
-                bool const & blank,
-                std::list <std::string> & out
+                std::vector <TelemetryValue <Real> > & out
             ) {
                 // Create some shortcuts
                 Y_Vector const & g_x = state.g_x;
@@ -6126,70 +8022,79 @@ namespace Optizelle{
                 bool opt_begin = (iter==1) &&
                         (rejected_trustregion == 0);
 
-                // Get a iterator to the last element prior to inserting
-                // elements
-                std::list <std::string>::iterator prior=out.end(); prior--;
-
                 // Norm of the gradient 
                 Real norm_gx = sqrt(Y::innr(g_x,g_x));
-                out.emplace_back(Utility::atos(norm_gx));
+                out.emplace_back(norm_gx);
                     
                 // More detailed information
                 if(msg_level >=2) {
                     // Actual vs. predicted reduction 
                     if(!opt_begin) {
-                        out.emplace_back(Utility::atos(ared));
-                        out.emplace_back(Utility::atos(pred));
-                        out.emplace_back(Utility::atos(ared/pred));
-                        out.emplace_back(Utility::atos(delta));
+                        out.emplace_back(ared);
+                        out.emplace_back(pred);
+                        out.emplace_back(ared/pred);
+                        out.emplace_back(delta);
                     } else 
-                        for(Natural i=0;i<4;i++)
-                            out.emplace_back(Utility::blankSeparator);
+                        out.resize(out.size()+4);
                     
                     // Krylov method information
                     if(!opt_begin) {
-                        out.emplace_back(Utility::atos(krylov_iter));
-                        out.emplace_back(Utility::atos(krylov_rel_err));
-                        out.emplace_back(Utility::atos(krylov_stop));
+                        out.emplace_back(krylov_iter);
+                        out.emplace_back(krylov_rel_err);
+                        out.emplace_back(krylov_stop);
                     } else 
-                        for(Natural i=0;i<3;i++)
-                            out.emplace_back(Utility::blankSeparator);
+                        out.resize(out.size()+3);
                 }
 
-                // If we needed to do blank insertions, overwrite the elements
-                // with spaces 
-                if(blank)
-                    for(std::list <std::string>::iterator x=++prior;
-                        x!=out.end();
-                        x++
-                    )
-                        (*x)=Utility::blankSeparator;
+                #ifdef OPTIZELLE_INSTRUMENTATION
+                // Cumulative timings
+                if(msg_level >= 3) {
+                    out.emplace_back(state.g_eval_time
+                        + state.g_p_time + state.g_ps_time + state.g_pps_time);
+                    out.emplace_back(state.PSchur_left_time
+                        + state.PSchur_right_time);
+                }
+                #endif
             }
 
             // Combines all of the state information
             static void getState(
                 typename Functions::t const & fns,
                 typename State::t const & state,
-                bool const & blank,
-                bool const & noiter,
-                std::list <std::string> & out
+                X_Vector & grad_diag,
+                std::vector <TelemetryValue <Real> > & out
             ) {
                 Unconstrained <Real,XX>::Diagnostics
-                    ::getState_(fns,state,blank,noiter,out);
+                    ::getState_(fns,state,grad_diag,out);
                 EqualityConstrained <Real,XX,YY>::Diagnostics
-                    ::getState_(fns,state,blank,out);
+                    ::getState_(fns,state,out);
             }
             
             // Get the header for the Krylov iteration
             static void getKrylovHeader_(
                 typename State::t const & state,
-                std::list <std::string> & out
-            ) { }
+                std::vector <std::string> & out
+            ) {
+                // Create some shortcuts
+                AlgorithmClass::t const & algorithm_class=state.algorithm_class;
+                LineSearchDirection::t const & dir=state.dir;
+
+                // The composite-step method always solves the tangential
+                // subproblem and the augmented systems with Krylov methods.
+                // Add the columns unless the unconstrained header already has.
+                if(!(   algorithm_class==AlgorithmClass::TrustRegion
+                     || dir==LineSearchDirection::NewtonCG)
+                ){
+                    out.emplace_back("KrySubItr");
+                    out.emplace_back("KryTotItr");
+                    out.emplace_back("KrySubErr");
+                }
+            }
 
             // Combines all of the Krylov headers
             static void getKrylovHeader(
                 typename State::t const & state,
-                std::list <std::string> & out
+                std::vector <std::string> & out
             ) {
                 Unconstrained <Real,XX>::Diagnostics::getKrylovHeader_(
                     state,out);
@@ -6200,20 +8105,30 @@ namespace Optizelle{
             // Get the information for the Krylov iteration
             static void getKrylov_(
                 typename State::t const & state,
-                bool const & blank,
-                std::list <std::string> & out
-            ) { }
+                std::vector <TelemetryValue <Real> > & out
+            ) {
+                // Create some shortcuts
+                AlgorithmClass::t const & algorithm_class=state.algorithm_class;
+                LineSearchDirection::t const & dir=state.dir;
+
+                // Match the header above
+                if(!(   algorithm_class==AlgorithmClass::TrustRegion
+                     || dir==LineSearchDirection::NewtonCG)
+                ){
+                    out.emplace_back(state.krylov_iter);
+                    out.emplace_back(state.krylov_iter_total);
+                    out.emplace_back(state.krylov_rel_err);
+                }
+            }
 
             // Combines all of the Krylov information
             static void getKrylov(
                 typename State::t const & state,
-                bool const & blank,
-                std::list <std::string> & out
+                std::vector <TelemetryValue <Real> > & out
             ) {
-                Unconstrained <Real,XX>::Diagnostics::getKrylov_(
-                    state,blank,out);
+                Unconstrained <Real,XX>::Diagnostics::getKrylov_(state,out);
                 EqualityConstrained <Real,XX,YY>::Diagnostics::getKrylov_(
-                    state,blank,out);
+                    state,out);
             }
            
             // Runs the specified function diagnostics 
@@ -6274,6 +8189,13 @@ namespace Optizelle{
             // Disallow constructors
             NO_CONSTRUCTORS(Algorithms)
 
+            // Krylov methods for the augmented system.  We only run these in
+            // mixed precision when both X and Y can convert between
+            // precisions.
+            typedef MixedPrecision <Real,XXxYY,
+                HasPrecisionConversion <Real,XX>::value &&
+                HasPrecisionConversion <Real,YY>::value> AugSysKrylov;
+
             // The operator for the augmented system,
             //
             // [ I      g'(x)* ]
@@ -6388,10 +8310,14 @@ namespace Optizelle{
                 }
             };
 
-            // Finds the quasi-normal step
+            // Finds the quasi-normal step.  If gstate holds a previous solve
+            // for the Newton step, we continue it.
             static void quasinormalStep(
+                StateManipulator <EqualityConstrained <Real,XX,YY> > const &
+                    smanip,
                 typename Functions::t const & fns,
-                typename State::t & state
+                typename State::t & state,
+                GMRESState <Real,XXxYY> & gstate
             ) {
                 // Create some shortcuts
                 VectorValuedFunction <Real,XX,YY> const & g=*(fns.g);
@@ -6466,8 +8392,13 @@ namespace Optizelle{
                 BlockDiagonalPreconditioner PAugSys_l (I,*(fns.PSchur_left));
                 BlockDiagonalPreconditioner PAugSys_r (I,*(fns.PSchur_right));
 
-                // Solve the augmented system for the Newton step
-                Optizelle::gmres <Real,XXxYY> (
+                // Solve the augmented system for the Newton step.  The
+                // iterations we've already done are ones we don't repeat.
+                state.augsys_iter_saved += gstate.iter;
+                OPTIZELLE_TIMER(krylov_timer,
+                    state.krylov_calls,state.krylov_time)
+                AugSysKrylov::gmres(
+                    state.krylov_precision,
                     AugmentedSystem(state,fns,x),
                     b0,
                     Real(1.), // This will be overwritten by the manipulator
@@ -6476,8 +8407,13 @@ namespace Optizelle{
                     PAugSys_l,
                     PAugSys_r,
                     QNManipulator(state,fns),
-                    x0 
+                    KrylovIterationManipulator
+                        <Real,EqualityConstrained <Real,XX,YY> >(
+                            smanip,fns,state,false),
+                    x0,
+                    gstate
                 );
+                OPTIZELLE_TIMER_STOP(krylov_timer)
 
                 // Find the Newton shift, dx_dnewton = dx_newton-dx_ncp
                 X_Vector & dx_dnewton = x0.first;
@@ -6576,6 +8512,8 @@ namespace Optizelle{
             // tangential subproblem as well as the predicted reduction.
             // Note, this also computes and caches H dx_n.
             static void projectedGradLagrangianPlusHdxn(
+                StateManipulator <EqualityConstrained <Real,XX,YY> > const &
+                    smanip,
                 typename Functions::t const & fns,
                 typename State::t & state
             ) {
@@ -6621,7 +8559,10 @@ namespace Optizelle{
                 BlockDiagonalPreconditioner PAugSys_r (I,*(fns.PSchur_right));
 
                 // Solve the augmented system for the nullspace projection 
-                Optizelle::gmres <Real,XXxYY> (
+                OPTIZELLE_TIMER(krylov_timer,
+                    state.krylov_calls,state.krylov_time)
+                AugSysKrylov::gmres(
+                    state.krylov_precision,
                     AugmentedSystem(state,fns,x),
                     b0,
                     Real(1.), // This will be overwritten by the manipulator
@@ -6630,8 +8571,12 @@ namespace Optizelle{
                     PAugSys_l,
                     PAugSys_r,
                     NullspaceProjForGradLagPlusHdxnManipulator(state,fns),
+                    KrylovIterationManipulator
+                        <Real,EqualityConstrained <Real,XX,YY> >(
+                            smanip,fns,state,false),
                     x0 
                 );
+                OPTIZELLE_TIMER_STOP(krylov_timer)
 
                 // Copy out the solution
                 X::copy(x0.first,W_gradpHdxn);
@@ -6736,7 +8681,8 @@ namespace Optizelle{
                         PAugSys_r(I,*(fns.PSchur_right));
 
                     // Solve the augmented system for the nullspace projection 
-                    Optizelle::gmres <Real,XXxYY> (
+                    AugSysKrylov::gmres(
+                        state.krylov_precision,
                         AugmentedSystem(state,fns,x),
                         b0,
                         Real(1.), // This will be overwritten by the manipulator
@@ -6755,6 +8701,8 @@ namespace Optizelle{
             
             // Solves the tangential subproblem 
             static void tangentialSubProblem(
+                StateManipulator <EqualityConstrained <Real,XX,YY> > const &
+                    smanip,
                 typename Functions::t const & fns,
                 typename State::t & state
             ) {
@@ -6770,6 +8718,8 @@ namespace Optizelle{
                 Natural const & krylov_orthog_max=state.krylov_orthog_max;
                 KrylovSolverTruncated::t const & krylov_solver
                     = state.krylov_solver;
+                KrylovPrecision::t const & krylov_precision
+                    = state.krylov_precision;
                 X_Vector & dx_t_uncorrected=state.dx_t_uncorrected;
                 X_Vector & dx_tcp_uncorrected=state.dx_tcp_uncorrected;
                 Real & krylov_rel_err=state.krylov_rel_err;
@@ -6794,11 +8744,20 @@ namespace Optizelle{
                 // Keep track of the residual errors
                 Real residual_err0(std::numeric_limits <Real>::quiet_NaN());
                 Real residual_err(std::numeric_limits <Real>::quiet_NaN());
+
+                // Manipulate the state at the end of each Krylov iteration
+                KrylovIterationManipulator
+                    <Real,EqualityConstrained <Real,XX,YY> >
+                    kmanip(smanip,fns,state,true);
+                VectorPool <Real,XX> pool;
             
+                OPTIZELLE_TIMER(krylov_timer,
+                    state.krylov_calls,state.krylov_time)
                 switch(krylov_solver) {
                 // Truncated conjugate direction
                 case KrylovSolverTruncated::ConjugateDirection:
-                    truncated_cd(
+                    MixedPrecision <Real,XX>::truncated_cd(
+                        krylov_precision,
                         H,
                         minus_W_gradpHdxn,
                         NullspaceProjForKrylovMethod(state,fns), // Add in PH?
@@ -6815,12 +8774,15 @@ namespace Optizelle{
                         residual_err0,
                         residual_err,
                         krylov_iter,
-                        krylov_stop);
+                        krylov_stop,
+                        kmanip,
+                        pool);
                     break;
 
                 // Truncated MINRES 
                 case KrylovSolverTruncated::MINRES:
-                    truncated_minres(
+                    MixedPrecision <Real,XX>::truncated_minres(
+                        krylov_precision,
                         H,
                         minus_W_gradpHdxn,
                         NullspaceProjForKrylovMethod(state,fns), // Add in PH?
@@ -6836,7 +8798,9 @@ namespace Optizelle{
                         residual_err0,
                         residual_err,
                         krylov_iter,
-                        krylov_stop);
+                        krylov_stop,
+                        kmanip,
+                        pool);
 
                     // Force a descent direction
                     if(X::innr(dx_t_uncorrected,W_gradpHdxn) > 0)
@@ -6845,6 +8809,7 @@ namespace Optizelle{
                         X::scal(Real(-1.),dx_tcp_uncorrected);
                     break;
                 }
+                OPTIZELLE_TIMER_STOP(krylov_timer)
                 krylov_rel_err = residual_err 
                     / (std::numeric_limits <Real>::epsilon()+residual_err0);
                 krylov_iter_total += krylov_iter;
@@ -6900,10 +8865,14 @@ namespace Optizelle{
                 }
             };
             
-            // Finds the tangential step 
+            // Finds the tangential step.  If gstate holds a previous solve,
+            // we continue it.
             static void tangentialStep(
+                StateManipulator <EqualityConstrained <Real,XX,YY> > const &
+                    smanip,
                 typename Functions::t const & fns,
-                typename State::t & state
+                typename State::t & state,
+                GMRESState <Real,XXxYY> & gstate
             ) {
                 // Create some shortcuts
                 X_Vector const & x=state.x;
@@ -6927,8 +8896,13 @@ namespace Optizelle{
                 BlockDiagonalPreconditioner PAugSys_l(I,*(fns.PSchur_left));
                 BlockDiagonalPreconditioner PAugSys_r(I,*(fns.PSchur_right));
 
-                // Solve the augmented system for the tangential step 
-                Optizelle::gmres <Real,XXxYY> (
+                // Solve the augmented system for the tangential step.  The
+                // iterations we've already done are ones we don't repeat.
+                state.augsys_iter_saved += gstate.iter;
+                OPTIZELLE_TIMER(krylov_timer,
+                    state.krylov_calls,state.krylov_time)
+                AugSysKrylov::gmres(
+                    state.krylov_precision,
                     AugmentedSystem(state,fns,x),
                     b0,
                     Real(1.), // This will be overwritten by the manipulator
@@ -6937,8 +8911,13 @@ namespace Optizelle{
                     PAugSys_l,
                     PAugSys_r,
                     TangentialStepManipulator(state,fns),
-                    x0 
+                    KrylovIterationManipulator
+                        <Real,EqualityConstrained <Real,XX,YY> >(
+                            smanip,fns,state,false),
+                    x0,
+                    gstate
                 );
+                OPTIZELLE_TIMER_STOP(krylov_timer)
 
                 // Copy out the tangential step
                 X::copy(x0.first,dx_t);
@@ -7020,7 +8999,10 @@ namespace Optizelle{
 
                 // Solve the augmented system for the initial Lagrange
                 // multiplier 
-                Optizelle::gmres <Real,XXxYY> (
+                OPTIZELLE_TIMER(krylov_timer,
+                    state.krylov_calls,state.krylov_time)
+                AugSysKrylov::gmres(
+                    state.krylov_precision,
                     AugmentedSystem(state,fns,x),
                     b0,
                     Real(1.), // This will be overwritten by the manipulator
@@ -7031,13 +9013,17 @@ namespace Optizelle{
                     LagrangeMultiplierStepManipulator(state,fns),
                     x0 
                 );
+                OPTIZELLE_TIMER_STOP(krylov_timer)
 
                 // Find the Lagrange multiplier based on this step
                 Y::axpy(Real(1.),x0.second,y);
+                state.y_version=++state.version;
             }
             
             // Finds the Lagrange multiplier step 
             static void lagrangeMultiplierStep(
+                StateManipulator <EqualityConstrained <Real,XX,YY> > const &
+                    smanip,
                 typename Functions::t const & fns,
                 typename State::t & state
             ) {
@@ -7093,10 +9079,15 @@ namespace Optizelle{
                 // current iterate is for this solve and then move back.
                 X_Vector x_save(X::init(x));
                     X::copy(x,x_save);
+                Natural const x_version_save=state.x_version;
                 X::copy(x_p_dx,x);
+                state.x_version=++state.version;
 
                 // Solve the augmented system for the Lagrange multiplier step 
-                Optizelle::gmres <Real,XXxYY> (
+                OPTIZELLE_TIMER(krylov_timer,
+                    state.krylov_calls,state.krylov_time)
+                AugSysKrylov::gmres(
+                    state.krylov_precision,
                     AugmentedSystem(state,fns,x),
                     b0,
                     Real(1.), // This will be overwritten by the manipulator
@@ -7105,11 +9096,16 @@ namespace Optizelle{
                     PAugSys_l,
                     PAugSys_r,
                     LagrangeMultiplierStepManipulator(state,fns),
+                    KrylovIterationManipulator
+                        <Real,EqualityConstrained <Real,XX,YY> >(
+                            smanip,fns,state,false),
                     x0 
                 );
+                OPTIZELLE_TIMER_STOP(krylov_timer)
 
                 // Restore our current iterate
                 X::copy(x_save,x);
+                state.x_version=x_version_save;
 
                 // Copy out the Lagrange multiplier step
                 Y::copy(x0.second,dy);
@@ -7155,7 +9151,10 @@ namespace Optizelle{
                 BlockDiagonalPreconditioner PAugSys_r(I,*(fns.PSchur_right));
 
                 // Solve the augmented system for the Lagrange multiplier step 
-                Optizelle::gmres <Real,XXxYY> (
+                OPTIZELLE_TIMER(krylov_timer,
+                    state.krylov_calls,state.krylov_time)
+                AugSysKrylov::gmres(
+                    state.krylov_precision,
                     AugmentedSystem(state,fns,x),
                     b0,
                     Real(1.), // This will be overwritten by the manipulator
@@ -7166,6 +9165,7 @@ namespace Optizelle{
                     LagrangeMultiplierStepManipulator(state,fns),
                     x0 
                 );
+                OPTIZELLE_TIMER_STOP(krylov_timer)
 
                 // Copy out the Lagrange multiplier step
                 return sqrt(Y::innr(x0.second,x0.second));
@@ -7324,9 +9324,11 @@ namespace Optizelle{
                 // Save the old Lagrange multiplier
                 Y_Vector y_old(Y::init(y));
                     Y::copy(y,y_old);
+                Natural const y_version_old=state.y_version;
 
                 // Determine y + dy
                 Y::axpy(Real(1.),dy,y);
+                state.y_version=++state.version;
 
                 // Determine the merit function at x and x+dx
                 Real merit_x = f_mod.merit(x,f_x);
@@ -7335,6 +9337,7 @@ namespace Optizelle{
 
                 // Restore the old Lagrange multiplier
                 Y::copy(y_old,y);
+                state.y_version=y_version_old;
 
                 // norm_dx = || dx ||
                 Real norm_dx = sqrt(X::innr(dx,dx));
@@ -7419,6 +9422,14 @@ namespace Optizelle{
                 // Create a single temporary vector
                 X_Vector x_tmp1(X::init(x));
 
+                // When we tighten the tolerances below, the augmented systems
+                // for the Newton step in the quasi-normal step and for the
+                // tangential step stay the same.  Hence, rather than solve
+                // them from scratch, we continue the previous solves.
+                XxY_Vector xx(X::init(x),Y::init(g_x));
+                GMRESState <Real,XXxYY> qn_gstate(xx);
+                GMRESState <Real,XXxYY> tang_gstate(xx);
+
                 // Continue to look for a step until our actual vs. predicted
                 // reduction is good.
                 rejected_trustregion=0;
@@ -7426,6 +9437,10 @@ namespace Optizelle{
                     // Manipulate the state if required
                     smanip.eval(fns,state,OptimizationLocation::BeforeGetStep);
 
+                    // The trust-region radius may have changed, which changes
+                    // the quasi-normal step
+                    qn_gstate.reset();
+
                     // Continue to look for a step until the inaccuracy
                     // in the normal and tangential steps are acceptable.
                     // The iterate i alternates between trying the Cauchy
@@ -7439,7 +9454,7 @@ namespace Optizelle{
                         // Compute a brand new step
                         if(i%2 == 0) {
                             // Find the quasi-Normal step
-                            quasinormalStep(fns,state);
+                            quasinormalStep(smanip,fns,state,qn_gstate);
 
                             // Find g'(x) dx_n + g(x)
                             g.p(x,dx_n,gpxdxn_p_gx);
@@ -7453,10 +9468,11 @@ namespace Optizelle{
                             f.hessvec(x,dx_n,H_dxn);
                             
                             // Find W (g + H dxn) 
-                            projectedGradLagrangianPlusHdxn(fns,state);
+                            projectedGradLagrangianPlusHdxn(smanip,fns,state);
 
                             // Find the uncorrected tangential step
-                            tangentialSubProblem(fns,state);
+                            tangentialSubProblem(smanip,fns,state);
+                            tang_gstate.reset();
                         }
                     
                         // Find H dx_t_uncorrected
@@ -7478,7 +9494,7 @@ namespace Optizelle{
                         ) {
 
                             // Correct the tangential step
-                            tangentialStep(fns,state);
+                            tangentialStep(smanip,fns,state,tang_gstate);
 
                             // Find the primal step
                             X::copy(dx_n,dx);
@@ -7488,7 +9504,7 @@ namespace Optizelle{
                             g.p(x,dx_t,gpxdxt);
 
                             // Find the Lagrange multiplier step
-                            lagrangeMultiplierStep(fns,state);
+                            lagrangeMultiplierStep(smanip,fns,state);
 
                             // Find the predicted reduction
                             rho = rho_old;
@@ -7515,8 +9531,10 @@ namespace Optizelle{
 
                         // If the inexactness isn't acceptable, try the Cauchy
                         // point before recomputing everything 
-                        if(i % 2==0)
+                        if(i % 2==0) {
                             X::copy(dx_tcp_uncorrected,dx_t_uncorrected);
+                            tang_gstate.reset();
+                        }
 
                         // If the Cauchy point didn't work, then tighten the
                         // tolerances and try again
@@ -7557,7 +9575,7 @@ namespace Optizelle{
                     // If we shorten our step, update our Lagrange multiplier
                     // step
                     if(alpha0 < Real(1.))
-                        lagrangeMultiplierStep(fns,state);
+                        lagrangeMultiplierStep(smanip,fns,state);
                     
                     // Check whether the step is good
                     if(checkStep(fns,state))
@@ -7722,6 +9740,7 @@ namespace Optizelle{
 
                         // Make sure to take the step in the dual variable
                         Y::axpy(Real(1.),dy,y);
+                        state.y_version=++state.version;
                         break;
 
                     case OptimizationLocation::AfterGradient: {
@@ -7772,19 +9791,41 @@ namespace Optizelle{
                 StateManipulator <EqualityConstrained <Real,XX,YY> > const &
                     smanip
             ){
+                // Print the diagnostic information as text
+                TextTelemetry <Real> sink(msg);
+
+                // Minimize the problem
+                getMin(msg,fns,state,smanip,sink);
+            }
+
+            // Initializes remaining functions then solves an optimization
+            // problem while sending the diagnostic information to sink
+            static void getMin(
+                Messaging const & msg,
+                typename Functions::t & fns,
+                typename State::t & state,
+                StateManipulator <EqualityConstrained <Real,XX,YY> > const &
+                    smanip,
+                TelemetrySink <Real> & sink
+            ){
                 
                 // Adds the output pieces to the state manipulator 
-                DiagnosticManipulator <EqualityConstrained <Real,XX,YY> >
-                    dmanip(smanip,msg);
+                DiagnosticManipulator
+                    <Real,EqualityConstrained <Real,XX,YY> >
+                    dmanip(smanip,msg,sink);
 
                 // Add the composite step pieces to the state manipulator
                 CompositeStepManipulator <EqualityConstrained <Real,XX,YY> >
                     csmanip(dmanip,msg);
 
+                // Announce new iterates to the functions
+                LinearizationManipulator <EqualityConstrained <Real,XX,YY> >
+                    lmanip(csmanip);
+
                 // Insures that we can interact with unconstrained code
                 ConversionManipulator
                     <EqualityConstrained<Real,XX,YY>,Unconstrained <Real,XX> >
-                    cmanip(csmanip);
+                    cmanip(lmanip);
                 
                 // Initialize any remaining functions required for optimization 
                 Functions::init(msg,state,fns);
@@ -7792,9 +9833,17 @@ namespace Optizelle{
                 // Check the inputs to the optimization
                 State::check(msg,state);
 
+                // Record the phases between the optimization locations
+                #ifdef OPTIZELLE_TRACING
+                TracingManipulator <Unconstrained <Real,XX> > tmanip(cmanip);
+                #else
+                auto const & tmanip = cmanip;
+                #endif
+
                 // Minimize the problem
+                OPTIZELLE_TRACE(trace,"getMin","solver")
                 Unconstrained <Real,XX>::Algorithms
-                    ::getMin_(msg,cmanip,fns,state);
+                    ::getMin_(msg,tmanip,fns,state);
             }
         };
     };
@@ -7836,6 +9885,9 @@ namespace Optizelle{
 
                 // Inequality multiplier (dual variable or Lagrange multiplier)
                 Z_Vector z;
+
+                // Version token for z 
+                Natural z_version;
                 
                 // Step in the inequality multiplier 
                 Z_Vector dz;
@@ -7849,6 +9901,12 @@ namespace Optizelle{
                 // factorization.
                 Z_Vector h_x;
 
+                // Second-order correction to the complementarity condition.
+                // In a Mehrotra predictor-corrector method, this holds
+                // h'(x)dx_aff o dz_aff where (dx_aff,dz_aff) is the affine
+                // scaling, or predictor, step.  Otherwise, it is zero.
+                Z_Vector z_corr;
+
                 // Interior point parameter
                 Real mu;
 
@@ -7877,10 +9935,47 @@ namespace Optizelle{
                 // Function diagnostics on h
                 FunctionDiagnostics::t h_diag;
 
+                // Number of evaluations of the inequality constraint
+                Natural h_eval_calls;
+
+                // Time spent evaluating the inequality constraint
+                Real h_eval_time;
+
+                // Number of derivatives of the inequality constraint
+                Natural h_p_calls;
+
+                // Time spent computing derivatives of the inequality constraint
+                Real h_p_time;
+
+                // Number of adjoint derivatives of the inequality constraint
+                Natural h_ps_calls;
+
+                // Time spent computing adjoint derivatives of the inequality
+                // constraint
+                Real h_ps_time;
+
+                // Number of second derivatives of the inequality constraint
+                Natural h_pps_calls;
+
+                // Time spent computing second derivatives of the inequality
+                // constraint
+                Real h_pps_time;
+
+                // Number of updates of the inequality multiplier and line
+                // searches to the boundary of the cone
+                Natural cone_calls;
+
+                // Time spent updating the inequality multiplier and searching
+                // for the boundary of the cone.  This includes any
+                // factorizations done by the Jordan product inverse and the line
+                // search in the inequality vector space.
+                Real cone_time;
+
                 // Initialization constructors
                 t(X_Vector const & x_user,Z_Vector const & z_user) :
                     Unconstrained <Real,XX>::State::t(x_user),
                     z(Z::init(z_user)),
+                    z_version(0),
                     dz(
                         //---dz0---
                         Z::init(z_user)
@@ -7891,6 +9986,11 @@ namespace Optizelle{
                         Z::init(z_user)
                         //---h_x1---
                     ),
+                    z_corr(
+                        //---z_corr0---
+                        Z::init(z_user)
+                        //---z_corr1---
+                    ),
                     mu(
                         //---mu0---
                         std::numeric_limits<Real>::quiet_NaN()
@@ -7926,20 +10026,71 @@ namespace Optizelle{
                         InteriorPointMethod::PrimalDual
                         //---ipm1---
                     ),
-                    cstrat(
-                        //---cstrat0---
-                        CentralityStrategy::Constant
-                        //---cstrat1---
+                    cstrat(
+                        //---cstrat0---
+                        CentralityStrategy::Constant
+                        //---cstrat1---
+                    ),
+                    h_diag(
+                        //---h_diag0---
+                        FunctionDiagnostics::NoDiagnostics
+                        //---h_diag1---
+                    ),
+                    h_eval_calls(
+                        //---h_eval_calls0---
+                        0
+                        //---h_eval_calls1---
+                    ),
+                    h_eval_time(
+                        //---h_eval_time0---
+                        0.
+                        //---h_eval_time1---
+                    ),
+                    h_p_calls(
+                        //---h_p_calls0---
+                        0
+                        //---h_p_calls1---
+                    ),
+                    h_p_time(
+                        //---h_p_time0---
+                        0.
+                        //---h_p_time1---
+                    ),
+                    h_ps_calls(
+                        //---h_ps_calls0---
+                        0
+                        //---h_ps_calls1---
+                    ),
+                    h_ps_time(
+                        //---h_ps_time0---
+                        0.
+                        //---h_ps_time1---
+                    ),
+                    h_pps_calls(
+                        //---h_pps_calls0---
+                        0
+                        //---h_pps_calls1---
+                    ),
+                    h_pps_time(
+                        //---h_pps_time0---
+                        0.
+                        //---h_pps_time1---
                     ),
-                    h_diag(
-                        //---h_diag0---
-                        FunctionDiagnostics::NoDiagnostics
-                        //---h_diag1---
+                    cone_calls(
+                        //---cone_calls0---
+                        0
+                        //---cone_calls1---
+                    ),
+                    cone_time(
+                        //---cone_time0---
+                        0.
+                        //---cone_time1---
                     )
                 {
                         //---z0---
                         Z::copy(z_user,z);
                         //---z1---
+                        Z::zero(z_corr);
                 }
                 
                 // A trick to allow dynamic casting later
@@ -7962,6 +10113,10 @@ namespace Optizelle{
                     //---h_x_valid0---
                     // Any
                     //---h_x_valid1---
+                    
+                    //---z_corr_valid0---
+                    // Any
+                    //---z_corr_valid1---
                 
                 // Check that the interior point parameter is positive after
                 // iteration 1.
@@ -8036,6 +10191,46 @@ namespace Optizelle{
                     // Any
                     //---h_diag_valid1---
 
+                    //---h_eval_calls_valid0---
+                    // Any
+                    //---h_eval_calls_valid1---
+
+                    //---h_eval_time_valid0---
+                    // Any
+                    //---h_eval_time_valid1---
+
+                    //---h_p_calls_valid0---
+                    // Any
+                    //---h_p_calls_valid1---
+
+                    //---h_p_time_valid0---
+                    // Any
+                    //---h_p_time_valid1---
+
+                    //---h_ps_calls_valid0---
+                    // Any
+                    //---h_ps_calls_valid1---
+
+                    //---h_ps_time_valid0---
+                    // Any
+                    //---h_ps_time_valid1---
+
+                    //---h_pps_calls_valid0---
+                    // Any
+                    //---h_pps_calls_valid1---
+
+                    //---h_pps_time_valid0---
+                    // Any
+                    //---h_pps_time_valid1---
+
+                    //---cone_calls_valid0---
+                    // Any
+                    //---cone_calls_valid1---
+
+                    //---cone_time_valid0---
+                    // Any
+                    //---cone_time_valid1---
+
                 // If there's an error, print it
                 if(ss.str()!="") msg.error(ss.str());
             }
@@ -8066,7 +10261,12 @@ namespace Optizelle{
                     item.first == "mu_typ" ||
                     item.first == "eps_mu" ||
                     item.first == "sigma" ||
-                    item.first == "gamma" 
+                    item.first == "gamma" ||
+                    item.first == "h_eval_time" ||
+                    item.first == "h_p_time" ||
+                    item.first == "h_ps_time" ||
+                    item.first == "h_pps_time" ||
+                    item.first == "cone_time"
                 )
                     return true;
                 else
@@ -8077,7 +10277,13 @@ namespace Optizelle{
             static bool is_nat(
                 typename RestartPackage <Natural>::tuple const & item
             ) {
-                if( Unconstrained <Real,XX>::Restart::is_nat(item))
+                if( Unconstrained <Real,XX>::Restart::is_nat(item) ||
+                    item.first == "h_eval_calls" ||
+                    item.first == "h_p_calls" ||
+                    item.first == "h_ps_calls" ||
+                    item.first == "h_pps_calls" ||
+                    item.first == "cone_calls"
+                )
                     return true;
                 else
                     return false;
@@ -8116,7 +10322,8 @@ namespace Optizelle{
             ) {
                 if( item.first == "z" ||
                     item.first == "dz" ||
-                    item.first == "h_x"
+                    item.first == "h_x" ||
+                    item.first == "z_corr"
                 )
                     return true;
                 else
@@ -8153,6 +10360,7 @@ namespace Optizelle{
                 zs.emplace_back("z",std::move(state.z));
                 zs.emplace_back("dz",std::move(state.dz));
                 zs.emplace_back("h_x",std::move(state.h_x));
+                zs.emplace_back("z_corr",std::move(state.z_corr));
             }
             
             // Copy out the scalar information
@@ -8168,6 +10376,18 @@ namespace Optizelle{
                 reals.emplace_back("eps_mu",std::move(state.eps_mu));
                 reals.emplace_back("sigma",std::move(state.sigma));
                 reals.emplace_back("gamma",std::move(state.gamma));
+                reals.emplace_back("h_eval_time",std::move(state.h_eval_time));
+                reals.emplace_back("h_p_time",std::move(state.h_p_time));
+                reals.emplace_back("h_ps_time",std::move(state.h_ps_time));
+                reals.emplace_back("h_pps_time",std::move(state.h_pps_time));
+                reals.emplace_back("cone_time",std::move(state.cone_time));
+
+                // Copy in all the natural numbers
+                nats.emplace_back("h_eval_calls",std::move(state.h_eval_calls));
+                nats.emplace_back("h_p_calls",std::move(state.h_p_calls));
+                nats.emplace_back("h_ps_calls",std::move(state.h_ps_calls));
+                nats.emplace_back("h_pps_calls",std::move(state.h_pps_calls));
+                nats.emplace_back("cone_calls",std::move(state.cone_calls));
 
                 // Copy in all of the parameters
                 params.emplace_back("ipm",
@@ -8188,12 +10408,15 @@ namespace Optizelle{
                     item!=zs.end();
                     item++
                 ){
-                    if(item->first=="z")
+                    if(item->first=="z") {
                         state.z = std::move(item->second);
-                    else if(item->first=="dz")
+                        state.z_version=++state.version;
+                    } else if(item->first=="dz")
                         state.dz = std::move(item->second);
                     else if(item->first=="h_x")
                         state.h_x = std::move(item->second);
+                    else if(item->first=="z_corr")
+                        state.z_corr = std::move(item->second);
                 }
             }
             
@@ -8221,7 +10444,34 @@ namespace Optizelle{
                         state.sigma=std::move(item->second);
                     else if(item->first=="gamma")
                         state.gamma=std::move(item->second);
+                    else if(item->first=="h_eval_time")
+                        state.h_eval_time=std::move(item->second);
+                    else if(item->first=="h_p_time")
+                        state.h_p_time=std::move(item->second);
+                    else if(item->first=="h_ps_time")
+                        state.h_ps_time=std::move(item->second);
+                    else if(item->first=="h_pps_time")
+                        state.h_pps_time=std::move(item->second);
+                    else if(item->first=="cone_time")
+                        state.cone_time=std::move(item->second);
                 } 
+                
+                // Next, copy in any naturals
+                for(typename Naturals::iterator item = nats.begin();
+                    item!=nats.end();
+                    item++
+                ){
+                    if(item->first=="h_eval_calls")
+                        state.h_eval_calls=std::move(item->second);
+                    else if(item->first=="h_p_calls")
+                        state.h_p_calls=std::move(item->second);
+                    else if(item->first=="h_ps_calls")
+                        state.h_ps_calls=std::move(item->second);
+                    else if(item->first=="h_pps_calls")
+                        state.h_pps_calls=std::move(item->second);
+                    else if(item->first=="cone_calls")
+                        state.cone_calls=std::move(item->second);
+                }
                     
                 // Next, copy in any parameters 
                 for(typename Params::iterator item = params.begin();
@@ -8309,8 +10559,12 @@ namespace Optizelle{
                 // Inequality constraints 
                 std::unique_ptr <VectorValuedFunction <Real,XX,ZZ> > h;
                 
+                // Inequality constraint's interest in new iterates
+                LinearizationSession <Real,XX> * h_session;
+                
                 // Initialize all of the pointers to null
-                t() : Unconstrained <Real,XX>::Functions::t(), h(nullptr) {}
+                t() : Unconstrained <Real,XX>::Functions::t(), h(nullptr),
+                    h_session(nullptr) {}
             };
 
             struct InequalityModifications
@@ -8329,6 +10583,11 @@ namespace Optizelle{
                 // Inequality constraint.
                 Optizelle::VectorValuedFunction <Real,XX,ZZ> const & h;
                 
+                // Current iterate.  We always take the second-order
+                // correction at this point, even when we evaluate the merit
+                // function at a trial point.
+                X_Vector const & x_iter;
+
                 // Inequality Lagrange multiplier
                 Z_Vector const & z;
 
@@ -8337,6 +10596,13 @@ namespace Optizelle{
 
                 // Inequality constraint evaluated at x
                 Z_Vector const & h_x;
+
+                // Second-order correction to the complementarity condition
+                Z_Vector const & z_corr;
+
+                // Type of interior point method
+                InteriorPointMethod::t const & ipm;
+
                 
                 // Some workspace for the below functions
                 mutable X_Vector grad_tmp;
@@ -8345,63 +10611,52 @@ namespace Optizelle{
                 mutable Z_Vector z_tmp1;
                 mutable Z_Vector z_tmp2;
                 
-                // Variables used for caching.  The boolean values denote
-                // whether or not we've started caching yet.
-                mutable std::pair <bool,X_Vector> x_merit;
+                // Variables used for caching.  These track the x and z
+                // used for each cached quantity.  The correction changes
+                // within an iteration and has no version, so we compare
+                // against a copy of it in corr_schur, whose boolean value
+                // denotes whether or not we've started caching yet.
+                mutable VersionedCache <Real,XX> x_merit;
                 mutable Z_Vector hx_merit;
-                mutable std::pair <bool,X_Vector> x_lag;
-                mutable std::pair <bool,Z_Vector> z_lag;
-                mutable std::pair <bool,X_Vector> x_schur;
-                mutable std::pair <bool,Z_Vector> z_schur;
+                mutable VersionedCache <Real,XX> x_lag;
+                mutable VersionedCache <Real,ZZ> z_lag;
+                mutable VersionedCache <Real,XX> x_schur;
+                mutable VersionedCache <Real,ZZ> z_schur;
+                mutable VersionedCache <Real,XX> x_corr;
+                mutable std::pair <bool,Z_Vector> corr_schur;
                 mutable X_Vector hpxsz;
                 mutable X_Vector hpxs_invLhx_e;
+                mutable X_Vector hpxs_invLhx_corr;
+
+                // Computes the Lagrangian pieces of the gradient
+                void cache_lag(X_Vector const & x) const {
+                    // If x or z differ from the cached values, compute anew.
+                    if(!x_lag.current(x) || !z_lag.current(z)) {
+                        // hpxsz <- h'(x)* z 
+                        h.ps(x,z,hpxsz);
+
+                        // Cache the values
+                        x_lag.update(x);
+                        z_lag.update(z);
+                    }
+                }
 
                 // Adds the Lagrangian pieces to the gradient
                 void grad_lag(
-                    X_Vector const & x,
                     X_Vector const & grad,
                     X_Vector & grad_lag
                 ) const {
                     // grad_lag <- grad f(x)
                     X::copy(grad,grad_lag);
-                    
-                    // If relative error between the current and cached values
-                    // is large, compute anew.
-                    if( rel_err_cached <Real,XX> (x,x_lag)
-                            >= std::numeric_limits <Real>::epsilon()*1e1 ||
-                        rel_err_cached <Real,ZZ> (z,z_lag)
-                            >= std::numeric_limits <Real>::epsilon()*1e1 
-                    ) {
-                        // hpxsz <- h'(x)* z 
-                        h.ps(x,z,hpxsz);
-
-                        // Cache the values
-                        x_lag.first=true;
-                        X::copy(x,x_lag.second);
-                        z_lag.first=true;
-                        Z::copy(z,z_lag.second);
-                    }
 
                     // grad_lag <- grad f(x) - h'(x)*z
                     X::axpy(-Real(1.0),hpxsz,grad_lag);
                 }
                 
-                // Adds the Schur complement pieces to the gradient
-                void grad_schur(
-                    X_Vector const & x,
-                    X_Vector const & grad,
-                    X_Vector & grad_schur
-                ) const {
-                    // grad_schur <- grad f(x)
-                    X::copy(grad,grad_schur);
-                    
-                    // If relative error between the current and cached values
-                    // is large, compute anew.
-                    if( rel_err_cached <Real,XX> (x,x_schur)
-                            >= std::numeric_limits <Real>::epsilon()*1e1 ||
-                        rel_err_cached <Real,ZZ> (z,z_schur)
-                            >= std::numeric_limits <Real>::epsilon()*1e1
-                    ) {
+                // Computes the Schur complement pieces of the gradient
+                void cache_schur(X_Vector const & x) const {
+                    // If x or z differ from the cached values, compute anew.
+                    if(!x_schur.current(x) || !z_schur.current(z)) {
                         // z_tmp1 <- e
                         Z::id(z_tmp1);
 
@@ -8412,14 +10667,54 @@ namespace Optizelle{
                         h.ps(x,z_tmp2,hpxs_invLhx_e);
                         
                         // Cache the values
-                        x_schur.first=true;
-                        X::copy(x,x_schur.second);
-                        z_schur.first=true;
-                        Z::copy(z,z_schur.second);
+                        x_schur.update(x);
+                        z_schur.update(z);
+                    }
+
+                    // In a Mehrotra predictor-corrector method, we also
+                    // target the complementarity condition h(x) o z = mu e -
+                    // z_corr, which adds h'(x)* (inv(L(h(x))) z_corr).
+                    if(ipm==InteriorPointMethod::Mehrotra)
+                        cache_corr(x);
+                }
+
+                // Computes the second-order correction to the gradient,
+                // h'(x)* (inv(L(h(x))) z_corr).  This depends on x through
+                // both h'(x) and h(x), so we recompute it when either x or
+                // the correction changes.
+                void cache_corr(X_Vector const & x) const {
+                    if( !x_corr.current(x) ||
+                        rel_err_cached <Real,ZZ> (z_corr,corr_schur)
+                            >= std::numeric_limits <Real>::epsilon()*1e1
+                    ) {
+                        // z_tmp1 <- inv(L(h(x))) z_corr 
+                        Z::linv(h_x,z_corr,z_tmp1);
+
+                        // hpxs_invLhx_corr <- h'(x)* (inv(L(h(x))) z_corr)
+                        h.ps(x,z_tmp1,hpxs_invLhx_corr);
+
+                        // Cache the values
+                        x_corr.update(x);
+                        corr_schur.first=true;
+                        Z::copy(z_corr,corr_schur.second);
                     }
+                }
+
+                // Adds the Schur complement pieces to the gradient
+                void grad_schur(
+                    X_Vector const & grad,
+                    X_Vector & grad_schur
+                ) const {
+                    // grad_schur <- grad f(x)
+                    X::copy(grad,grad_schur);
 
                     // grad_schur<- grad f(x) - mu h'(x)* (inv(L(h(x))) e)
                     X::axpy(-mu,hpxs_invLhx_e,grad_schur);
+
+                    // grad_schur <- grad f(x) - h'(x)* (inv(L(h(x)))
+                    //     (mu e - z_corr))
+                    if(ipm==InteriorPointMethod::Mehrotra)
+                        X::axpy(Real(1.),hpxs_invLhx_corr,grad_schur);
                 }
             public:
                 InequalityModifications(
@@ -8427,40 +10722,58 @@ namespace Optizelle{
                     typename Functions::t & fns
                 ) : f_mod(std::move(fns.f_mod)),
                     h(*(fns.h)),
+                    x_iter(state.x),
                     z(state.z),
                     mu(state.mu),
                     h_x(state.h_x),
+                    z_corr(state.z_corr),
+                    ipm(state.ipm),
                     grad_tmp(X::init(state.x)),
                     hess_mod(X::init(state.x)),
                     x_tmp1(X::init(state.x)),
                     z_tmp1(Z::init(state.z)),
                     z_tmp2(Z::init(state.z)),
-                    x_merit(false,X::init(state.x)),
+                    x_merit(state.x,state.x_version),
                     hx_merit(Z::init(state.z)),
-                    x_lag(false,X::init(state.x)),
-                    z_lag(false,Z::init(state.z)),
-                    x_schur(false,X::init(state.x)),
-                    z_schur(false,Z::init(state.z)),
+                    x_lag(state.x,state.x_version),
+                    z_lag(state.z,state.z_version),
+                    x_schur(state.x,state.x_version),
+                    z_schur(state.z,state.z_version),
+                    x_corr(state.x,state.x_version),
+                    corr_schur(false,Z::init(state.z)),
                     hpxsz(X::init(state.x)),
-                    hpxs_invLhx_e(X::init(state.x))
+                    hpxs_invLhx_e(X::init(state.x)),
+                    hpxs_invLhx_corr(X::init(state.x))
                 {}
 
                 // Merit function additions to the objective
                 virtual Real merit(X_Vector const & x,Real const & f_x) const {
                     // Do the underlying modification of the objective
                     Real merit_x = f_mod->merit(x,f_x);
-                    
-                    // If we've not started caching or the relative error
-                    // is large, compute anew.
-                    if( rel_err_cached <Real,XX> (x,x_merit)
-                            >= std::numeric_limits <Real>::epsilon()*1e1
-                    ) {
+
+                    // If we've not started caching or x differs from the
+                    // cached value, compute anew.
+                    if(!x_merit.current(x)) {
                         // hx_merit <- h(x)
                         h.eval(x,hx_merit);
-                        
+
                         // Cache the values
-                        x_merit.first=true;
-                        X::copy(x,x_merit.second);
+                        x_merit.update(x);
+                    }
+
+                    // In a Mehrotra predictor-corrector method, the gradient
+                    // used to find the step contains the additional term
+                    // h'(x)* (inv(L(h(x))) z_corr).  In order to keep the
+                    // merit function consistent with our model, we add the
+                    // linear functional corresponding to this term.  Since
+                    // this term is fixed during an iteration, it does not
+                    // change the actual reduction beyond this correction.
+                    // We take it at the current iterate, so that a rejected
+                    // step or a change to the state can't leave us with a
+                    // correction from an old iterate.
+                    if(ipm==InteriorPointMethod::Mehrotra) {
+                        cache_corr(x_iter);
+                        merit_x += X::innr(hpxs_invLhx_corr,x);
                     }
 
                     // Return merit(x) - mu barr(h(x))
@@ -8474,7 +10787,8 @@ namespace Optizelle{
                     X_Vector & grad_stop
                 ) const {
                     f_mod->grad_stop(x,grad,grad_tmp);
-                    grad_lag(x,grad_tmp,grad_stop);
+                    cache_lag(x);
+                    grad_lag(grad_tmp,grad_stop);
                 }
 
                 // Diagnostic modification of the gradient
@@ -8484,7 +10798,8 @@ namespace Optizelle{
                     X_Vector & grad_diag
                 ) const {
                     f_mod->grad_diag(x,grad,grad_tmp);
-                    grad_lag(x,grad_tmp,grad_diag);
+                    cache_lag(x);
+                    grad_lag(grad_tmp,grad_diag);
                 }
 
                 // Modification of the gradient when finding a trial step
@@ -8494,7 +10809,8 @@ namespace Optizelle{
                     X_Vector & grad_step
                 ) const {
                     f_mod->grad_step(x,grad,grad_tmp);
-                    grad_schur(x,grad_tmp,grad_step);
+                    cache_schur(x);
+                    grad_schur(grad_tmp,grad_step);
                 }
 
                 // Modification of the gradient for a quasi-Newton method 
@@ -8514,7 +10830,8 @@ namespace Optizelle{
                     X_Vector & grad_mult
                 ) const {
                     f_mod->grad_mult(x,grad,grad_tmp);
-                    grad_lag(x,grad_tmp,grad_mult);
+                    cache_lag(x);
+                    grad_lag(grad_tmp,grad_mult);
                 }
 
                 // Modification of the Hessian-vector product when finding a
@@ -8525,7 +10842,6 @@ namespace Optizelle{
                     X_Vector const & H_dx,
                     X_Vector & Hdx_step 
                 ) const {
-
                     // Modify the Hessian-vector product
                     f_mod->hessvec_step(x,dx,H_dx,Hdx_step);
 
@@ -8535,7 +10851,7 @@ namespace Optizelle{
                     // z_tmp2 <- h'(x) dx o z
                     Z::prod(z_tmp1,z,z_tmp2);
 
-                    // linv_hx_hpx_prod_z <- inv(L(h(x))) (h'(x) dx o z) 
+                    // linv_hx_hpx_prod_z <- inv(L(h(x))) (h'(x) dx o z)
                     Z::linv(h_x,z_tmp2,z_tmp1);
 
                     // hess_mod <- h'(x)* (inv(L(h(x))) (h'(x) dx o z))
@@ -8545,6 +10861,12 @@ namespace Optizelle{
                     //  = hess f(x) dx + h'(x)* (inv(L(h(x))) (h'(x) dx o z))
                     X::axpy(Real(1.),hess_mod,Hdx_step);
                 }
+
+                // We add h'(x)* (inv(L(h(x))) (h'(x) dx o z)) to the
+                // Hessian-vector product
+                virtual bool modifies_hessvec() const {
+                    return true;
+                }
             };
 
             // Check that all the functions are defined
@@ -8568,6 +10890,29 @@ namespace Optizelle{
                 // Check that all functions are defined 
                 check(msg,fns);
 
+                // Find whether the constraint wants to hear about new iterates
+                // unless we've already wrapped it
+                if(dynamic_cast <TimedVectorValuedFunction <Real,XX,ZZ> *> (
+                    fns.h.get())==nullptr
+                )
+                    fns.h_session=dynamic_cast <LinearizationSession<Real,XX>*>(
+                        fns.h.get());
+
+                #if defined(OPTIZELLE_INSTRUMENTATION) \
+                    || defined(OPTIZELLE_TRACING)
+                // Time and trace the constraint unless we've already done so
+                if(dynamic_cast <TimedVectorValuedFunction <Real,XX,ZZ> *> (
+                    fns.h.get())==nullptr
+                )
+                    fns.h.reset(new TimedVectorValuedFunction <Real,XX,ZZ> (
+                        std::move(fns.h),
+                        state.h_eval_calls,state.h_eval_time,
+                        state.h_p_calls,state.h_p_time,
+                        state.h_ps_calls,state.h_ps_time,
+                        state.h_pps_calls,state.h_pps_time,
+                        {{"h.eval","h.p","h.ps","h.pps"}}));
+                #endif
+
                 // Modify the objective 
                 fns.f_mod.reset(new InequalityModifications(state,fns));
             }
@@ -8583,6 +10928,23 @@ namespace Optizelle{
                 InequalityConstrained <Real,XX,ZZ>
                     ::Functions::init_(msg,state,fns);
             }
+
+            // Announces the current iterate to the functions that want it
+            static void linearize_(
+                t const & fns,
+                typename State::t const & state
+            ) {
+                if(fns.h_session!=nullptr)
+                    fns.h_session->announce(state.x,state.x_version);
+            }
+            static void linearize(
+                t const & fns,
+                typename State::t const & state
+            ) {
+                Unconstrained <Real,XX>::Functions::linearize_(fns,state);
+                InequalityConstrained <Real,XX,ZZ>::Functions::linearize_(
+                    fns,state);
+            }
         };
         
         // Contains functions that assist in creating an output for diagonstics
@@ -8593,23 +10955,31 @@ namespace Optizelle{
             // Gets the header for the state information
             static void getStateHeader_(
                 typename State::t const & state,
-                std::list <std::string> & out
+                std::vector <std::string> & out
             ) {
                 // Create some shortcuts
                 Natural const & msg_level = state.msg_level;
 
                 // Basic information
-                out.emplace_back(Utility::atos("mu_est"));
+                out.emplace_back("mu_est");
 
                 // More detailed information
                 if(msg_level >= 2)
-                    out.emplace_back(Utility::atos("mu"));
+                    out.emplace_back("mu");
+
+                #ifdef OPTIZELLE_INSTRUMENTATION
+                // Cumulative timings
+                if(msg_level >= 3) {
+                    out.emplace_back("time(h)");
+                    out.emplace_back("time(cone)");
+                }
+                #endif
             }
 
             // Combines all of the state headers
             static void getStateHeader(
                 typename State::t const & state,
-                std::list <std::string> & out
+                std::vector <std::string> & out
             ) {
                 Unconstrained <Real,XX>::Diagnostics::getStateHeader_(
                     state,out);
@@ -8621,60 +10991,51 @@ namespace Optizelle{
             static void getState_(
                 typename Functions::t const & fns,
                 typename State::t const & state,
-                bool const & blank,
-                std::list <std::string> & out
+                std::vector <TelemetryValue <Real> > & out
             ) {
-
                 // Create some shortcuts
-                Real const & mu=state.mu; 
-                Real const & mu_est=state.mu_est; 
                 Natural const & msg_level = state.msg_level;
 
-                // Get a iterator to the last element prior to inserting
-                // elements
-                std::list <std::string>::iterator prior=out.end(); prior--;
-
                 // Basic information
-                out.emplace_back(Utility::atos(mu_est));
+                out.emplace_back(state.mu_est);
                 
                 // More detailed information
                 if(msg_level >= 2) 
-                    out.emplace_back(Utility::atos(mu));
-
-                // If we needed to do blank insertions, overwrite the elements
-                // with spaces 
-                if(blank)
-                    for(std::list <std::string>::iterator x=++prior;
-                        x!=out.end();
-                        x++
-                    )
-                        (*x)=Utility::blankSeparator;
+                    out.emplace_back(state.mu);
+
+                #ifdef OPTIZELLE_INSTRUMENTATION
+                // Cumulative timings
+                if(msg_level >= 3) {
+                    out.emplace_back(state.h_eval_time
+                        + state.h_p_time + state.h_ps_time + state.h_pps_time);
+                    out.emplace_back(state.cone_time);
+                }
+                #endif
             }
 
             // Combines all of the state information
             static void getState(
                 typename Functions::t const & fns,
                 typename State::t const & state,
-                bool const & blank,
-                bool const & noiter,
-                std::list <std::string> & out
+                X_Vector & grad_diag,
+                std::vector <TelemetryValue <Real> > & out
             ) {
                 Unconstrained <Real,XX>::Diagnostics
-                    ::getState_(fns,state,blank,noiter,out);
+                    ::getState_(fns,state,grad_diag,out);
                 InequalityConstrained <Real,XX,ZZ>::Diagnostics
-                    ::getState_(fns,state,blank,out);
+                    ::getState_(fns,state,out);
             }
             
             // Get the header for the Krylov iteration
             static void getKrylovHeader_(
                 typename State::t const & state,
-                std::list <std::string> & out
+                std::vector <std::string> & out
             ) { }
 
             // Combines all of the Krylov headers
             static void getKrylovHeader(
                 typename State::t const & state,
-                std::list <std::string> & out
+                std::vector <std::string> & out
             ) {
                 Unconstrained <Real,XX>::Diagnostics::getKrylovHeader_(
                     state,out);
@@ -8685,20 +11046,17 @@ namespace Optizelle{
             // Get the information for the Krylov iteration
             static void getKrylov_(
                 typename State::t const & state,
-                bool const & blank,
-                std::list <std::string> & out
+                std::vector <TelemetryValue <Real> > & out
             ) { }
 
             // Combines all of the Krylov information
             static void getKrylov(
                 typename State::t const & state,
-                bool const & blank,
-                std::list <std::string> & out
+                std::vector <TelemetryValue <Real> > & out
             ) {
-                Unconstrained <Real,XX>::Diagnostics
-                    ::getKrylov_(state,blank,out);
-                InequalityConstrained <Real,XX,ZZ>::Diagnostics
-                    ::getKrylov_(state,blank,out);
+                Unconstrained <Real,XX>::Diagnostics::getKrylov_(state,out);
+                InequalityConstrained <Real,XX,ZZ>::Diagnostics::getKrylov_(
+                    state,out);
             }
            
             // Runs the specified function diagnostics 
@@ -8804,6 +11162,9 @@ namespace Optizelle{
                 typename Functions::t const & fns,
                 typename State::t & state
             ) {
+                // Time the work on the cone
+                OPTIZELLE_TIMER(cone_timer,state.cone_calls,state.cone_time)
+
                 // Create some shortcuts
                 Z_Vector const & h_x=state.h_x;
                 X_Vector const & x=state.x;
@@ -8834,6 +11195,7 @@ namespace Optizelle{
 
                 // Symmetrize the iterate
                 Z::symm(z);
+                state.z_version=++state.version;
             }
 
             // Finds the new inequality Lagrange multiplier
@@ -8842,6 +11204,9 @@ namespace Optizelle{
                 typename Functions::t const & fns,
                 typename State::t & state
             ) {
+                // Time the work on the cone
+                OPTIZELLE_TIMER(cone_timer,state.cone_calls,state.cone_time)
+
                 // Create some shortcuts
                 Z_Vector const & h_x=state.h_x;
                 Real const & mu=state.mu;
@@ -8859,20 +11224,26 @@ namespace Optizelle{
                 
                 // Symmetrize the iterate 
                 Z::symm(z);
+                state.z_version=++state.version;
             }
 
             // Finds the new inequality Lagrange multiplier step
-            // dz = -z + inv L(h(x)) (-h'(x)dx o z + mu e)
+            // dz = -z + inv L(h(x)) (-h'(x)dx o z + mu e - z_corr)
             static void findInequalityMultiplierStep(
                 typename Functions::t const & fns,
                 typename State::t & state
             ) {
+                // Time the work on the cone
+                OPTIZELLE_TIMER(cone_timer,state.cone_calls,state.cone_time)
+
                 // Create some shortcuts
                 Z_Vector const & z=state.z;
                 Z_Vector const & h_x=state.h_x;
+                Z_Vector const & z_corr=state.z_corr;
                 X_Vector const & x=state.x;
                 X_Vector const & dx=state.dx;
                 Real const & mu=state.mu;
+                InteriorPointMethod::t const & ipm=state.ipm;
                 VectorValuedFunction <Real,XX,ZZ> const & h=*(fns.h);
                 Z_Vector & dz=state.dz;
 
@@ -8893,7 +11264,11 @@ namespace Optizelle{
                 // z_tmp2 <- -h'(x)dx o z + mu e
                 Z::axpy(mu,z_tmp1,z_tmp2);
 
-                // dz <- inv L(h(x)) (-h'(x)dx o z + mu e)
+                // z_tmp2 <- -h'(x)dx o z + mu e - z_corr
+                if(ipm==InteriorPointMethod::Mehrotra)
+                    Z::axpy(Real(-1.),z_corr,z_tmp2);
+
+                // dz <- inv L(h(x)) (-h'(x)dx o z + mu e - z_corr)
                 Z::linv(h_x,z_tmp2,dz);
 
                 // dz <- -z + inv L(h(x)) (-h'(x)dx o z + mu e)
@@ -9005,6 +11380,172 @@ namespace Optizelle{
                 }
             }
 
+
+            // Finds the affine scaling, or predictor, step of a Mehrotra
+            // predictor-corrector method.  This solves the Newton system with
+            // mu=0 using the same Hessian operator and preconditioner as the
+            // corrector step, so any factorization held by the preconditioner
+            // is reused.  Then, it sets the interior point parameter to
+            // sigma mu_est where sigma = (mu_aff / mu_est)^3 and stores the
+            // second-order correction z_corr = h'(x)dx_aff o dz_aff.  We
+            // don't apply the Nesterov-Todd scaling, so on quadratic and
+            // semidefinite cones this is the unscaled predictor-corrector
+            // method.
+            static void findPredictorStep(
+                typename Functions::t const & fns,
+                typename State::t & state
+            ) {
+                // Create some shortcuts
+                ScalarValuedFunction <Real,XX> const & f=*(fns.f);
+                ScalarValuedFunctionModifications <Real,XX> const & f_mod
+                    = *(fns.f_mod);
+                Operator <Real,XX,XX> const & PH=*(fns.PH);
+                VectorValuedFunction <Real,XX,ZZ> const & h=*(fns.h);
+                X_Vector const & x=state.x;
+                X_Vector const & grad=state.grad;
+                Z_Vector const & z=state.z;
+                Z_Vector const & h_x=state.h_x;
+                Real const & mu_est=state.mu_est;
+                Real const & mu_typ=state.mu_typ;
+                Real const & eps_mu=state.eps_mu;
+                Real const & eps_krylov=state.eps_krylov;
+                Natural const & krylov_iter_max=state.krylov_iter_max;
+                Natural const & krylov_orthog_max=state.krylov_orthog_max;
+                KrylovSolverTruncated::t const & krylov_solver
+                    = state.krylov_solver;
+                AlgorithmClass::t const & algorithm_class
+                    = state.algorithm_class;
+                Natural & krylov_iter_total=state.krylov_iter_total;
+                Z_Vector & z_corr=state.z_corr;
+                Real & mu=state.mu;
+
+                // Clear out the old correction, so that the gradient below
+                // only contains the affine scaling pieces
+                Z::zero(z_corr);
+
+                // If we satisfy the stopping criteria, stop trying to
+                // reduce the interior point parameter
+                if(mu_est <= mu_typ*eps_mu) {
+                    mu=mu_est;
+                    return;
+                }
+
+                // Find -grad f(x) with mu=0
+                mu=Real(0.);
+                X_Vector minus_grad(X::init(x));
+                    f_mod.grad_step(x,grad,minus_grad);
+                    X::scal(Real(-1.),minus_grad);
+
+                // Find the affine scaling step in the primal variable.  In a
+                // trust-region method, we keep the step inside the current
+                // trust-region.
+                typename Unconstrained <Real,XX>::Algorithms::HessianOperator
+                    H(f,f_mod,x);
+                Real delta = algorithm_class==AlgorithmClass::TrustRegion ?
+                    state.delta : std::numeric_limits <Real>::infinity();
+                X_Vector x_cntr(X::init(x));
+                    X::zero(x_cntr);
+                X_Vector dx_aff(X::init(x));
+                X_Vector dx_cp(X::init(x));
+                Real residual_err0(std::numeric_limits <Real>::quiet_NaN());
+                Real residual_err(std::numeric_limits <Real>::quiet_NaN());
+                Natural krylov_iter(0);
+                KrylovStop::t krylov_stop(KrylovStop::RelativeErrorSmall);
+                OPTIZELLE_TIMER(krylov_timer,
+                    state.krylov_calls,state.krylov_time)
+                switch(krylov_solver) {
+                // Truncated conjugate direction
+                case KrylovSolverTruncated::ConjugateDirection:
+                    truncated_cd(
+                        H,
+                        minus_grad,
+                        PH,
+                        typename Unconstrained <Real,XX>::Functions
+                            ::Identity(),
+                        eps_krylov,
+                        krylov_iter_max,
+                        krylov_orthog_max,
+                        delta,
+                        x_cntr,
+                        false,
+                        dx_aff,
+                        dx_cp,
+                        residual_err0,
+                        residual_err,
+                        krylov_iter,
+                        krylov_stop);
+                    break;
+
+                // Truncated MINRES 
+                case KrylovSolverTruncated::MINRES:
+                    truncated_minres(
+                        H,
+                        minus_grad,
+                        PH,
+                        typename Unconstrained <Real,XX>::Functions
+                            ::Identity(),
+                        eps_krylov,
+                        krylov_iter_max,
+                        krylov_orthog_max,
+                        delta,
+                        x_cntr,
+                        dx_aff,
+                        dx_cp,
+                        residual_err0,
+                        residual_err,
+                        krylov_iter,
+                        krylov_stop);
+
+                    // Force a descent direction
+                    if(X::innr(dx_aff,minus_grad) < 0)
+                        X::scal(Real(-1.),dx_aff);
+                    break;
+                }
+                OPTIZELLE_TIMER_STOP(krylov_timer)
+                krylov_iter_total += krylov_iter;
+
+                // hpx_dx_aff <- h'(x)dx_aff
+                Z_Vector hpx_dx_aff(Z::init(z));
+                    h.p(x,dx_aff,hpx_dx_aff);
+
+                // dz_aff <- -z + inv L(h(x)) (-h'(x)dx_aff o z)
+                Z_Vector z_tmp1(Z::init(z));
+                    Z::prod(hpx_dx_aff,z,z_tmp1);
+                    Z::scal(Real(-1.),z_tmp1);
+                Z_Vector dz_aff(Z::init(z));
+                    Z::linv(h_x,z_tmp1,dz_aff);
+                    Z::axpy(Real(-1.),z,dz_aff);
+                    Z::symm(dz_aff);
+
+                // Find the largest steps that keep h(x) + alpha h'(x)dx_aff
+                // and z + alpha dz_aff feasible
+                Real alpha_x = Z::srch(hpx_dx_aff,h_x);
+                    alpha_x = alpha_x > Real(1.) ? Real(1.) : alpha_x;
+                Real alpha_z = Z::srch(dz_aff,z);
+                    alpha_z = alpha_z > Real(1.) ? Real(1.) : alpha_z;
+
+                // Estimate the interior point parameter after the affine
+                // scaling step, mu_aff = <h(x)+alpha_x h'(x)dx_aff,
+                // z+alpha_z dz_aff>/m
+                Z_Vector h_aff(Z::init(z));
+                    Z::copy(h_x,h_aff);
+                    Z::axpy(alpha_x,hpx_dx_aff,h_aff);
+                Z_Vector z_aff(Z::init(z));
+                    Z::copy(z,z_aff);
+                    Z::axpy(alpha_z,dz_aff,z_aff);
+                Z::id(z_tmp1);
+                Real mu_aff = Z::innr(h_aff,z_aff) / Z::innr(z_tmp1,z_tmp1);
+                    mu_aff = mu_aff < Real(0.) ? Real(0.) : mu_aff;
+
+                // Use Mehrotra's heuristic for the centering parameter
+                Real sigma_aff = mu_aff / mu_est;
+                    sigma_aff = sigma_aff > Real(1.) ? Real(1.) : sigma_aff;
+                mu = sigma_aff*sigma_aff*sigma_aff*mu_est;
+
+                // z_corr <- h'(x)dx_aff o dz_aff
+                Z::prod(hpx_dx_aff,dz_aff,z_corr);
+                Z::symm(z_corr);
+            }
            
             // Adjust the stopping conditions unless the criteria below are
             // satisfied.
@@ -9056,6 +11597,9 @@ namespace Optizelle{
                 typename Functions::t const & fns,
                 typename State::t & state
             ) {
+                // Time the work on the cone
+                OPTIZELLE_TIMER(cone_timer,state.cone_calls,state.cone_time)
+
                 // Create some shortcuts 
                 Real const & gamma=state.gamma;
                 AlgorithmClass::t const & algorithm_class
@@ -9132,6 +11676,9 @@ namespace Optizelle{
                 typename Functions::t const & fns,
                 typename State::t & state
             ) {
+                // Time the work on the cone
+                OPTIZELLE_TIMER(cone_timer,state.cone_calls,state.cone_time)
+
                 // Create some shortcuts 
                 Real const & gamma=state.gamma;
                 Real const & mu=state.mu;
@@ -9239,6 +11786,9 @@ namespace Optizelle{
                 typename Functions::t const & fns,
                 typename State::t & state
             ) {
+                // Time the work on the cone
+                OPTIZELLE_TIMER(cone_timer,state.cone_calls,state.cone_time)
+
                 // Create some shortcuts 
                 Real const & gamma=state.gamma;
                 AlgorithmClass::t const & algorithm_class
@@ -9351,6 +11901,7 @@ namespace Optizelle{
                         // mu_est = <h(x),z> / m = 1.
                         Z::id(z);
                         Z::scal(Z::innr(z,z)/Z::innr(h_x,z),z);
+                        state.z_version=++state.version;
 
                         // Estimate the interior point parameter
                         estimateInteriorPointParameter(fns,state);
@@ -9373,6 +11924,7 @@ namespace Optizelle{
                         // Do the linesearch
                         switch(ipm){
                         case InteriorPointMethod::PrimalDual:
+                        case InteriorPointMethod::Mehrotra:
                             findInequalityMultiplierStep(fns,state);
                             positivityLineSearchPrimalDual(fns,state);
                             break;
@@ -9387,6 +11939,14 @@ namespace Optizelle{
                         }
                         break;
 
+                    // In a Mehrotra predictor-corrector method, find the
+                    // predictor step and the centering parameter prior to
+                    // computing the corrector step.
+                    case OptimizationLocation::BeginningOfOptimizationLoop:
+                        if(ipm==InteriorPointMethod::Mehrotra)
+                            findPredictorStep(fns,state);
+                        break;
+
                     // After we reject a step, make sure that we take a zero
                     // step in the inequality multiplier.  This is important
                     // in case we exit early due to small steps.
@@ -9399,6 +11959,7 @@ namespace Optizelle{
                         // Find the new inequality multiplier or step
                         switch(ipm){
                         case InteriorPointMethod::PrimalDual:
+                        case InteriorPointMethod::Mehrotra:
                             Z::axpy(Real(1.),dz,z);
 
                             // In theory, we start symmetric and make sure our
@@ -9406,6 +11967,7 @@ namespace Optizelle{
                             // in never having a nonsymmetric dual variable,
                             // we force symmetrization here.
                             Z::symm(z);
+                            state.z_version=++state.version;
                             break;
                         case InteriorPointMethod::PrimalDualLinked:
                             findInequalityMultiplierLinked(fns,state);
@@ -9470,19 +12032,41 @@ namespace Optizelle{
                 typename State::t & state,
                 StateManipulator <InequalityConstrained <Real,XX,ZZ> > const &
                     smanip
+            ){
+                // Print the diagnostic information as text
+                TextTelemetry <Real> sink(msg);
+
+                // Minimize the problem
+                getMin(msg,fns,state,smanip,sink);
+            }
+
+            // Initializes remaining functions then solves an optimization
+            // problem while sending the diagnostic information to sink
+            static void getMin(
+                Messaging const & msg,
+                typename Functions::t & fns,
+                typename State::t & state,
+                StateManipulator <InequalityConstrained <Real,XX,ZZ> > const &
+                    smanip,
+                TelemetrySink <Real> & sink
             ){
                 // Adds the output pieces to the state manipulator 
-                DiagnosticManipulator <InequalityConstrained <Real,XX,ZZ> >
-                    dmanip(smanip,msg);
+                DiagnosticManipulator
+                    <Real,InequalityConstrained <Real,XX,ZZ> >
+                    dmanip(smanip,msg,sink);
 
                 // Add the interior point pieces to the state manipulator
                 InteriorPointManipulator <InequalityConstrained <Real,XX,ZZ> >
                     ipmanip(dmanip);
 
+                // Announce new iterates to the functions
+                LinearizationManipulator <InequalityConstrained <Real,XX,ZZ> >
+                    lmanip(ipmanip);
+
                 // Insures that we can interact with unconstrained code
                 ConversionManipulator
                     <InequalityConstrained<Real,XX,ZZ>,Unconstrained <Real,XX> >
-                    cmanip(ipmanip);
+                    cmanip(lmanip);
                 
                 // Initialize any remaining functions required for optimization 
                 Functions::init(msg,state,fns);
@@ -9490,9 +12074,17 @@ namespace Optizelle{
                 // Check the inputs to the optimization
                 State::check(msg,state);
                 
+                // Record the phases between the optimization locations
+                #ifdef OPTIZELLE_TRACING
+                TracingManipulator <Unconstrained <Real,XX> > tmanip(cmanip);
+                #else
+                auto const & tmanip = cmanip;
+                #endif
+
                 // Minimize the problem
+                OPTIZELLE_TRACE(trace,"getMin","solver")
                 Unconstrained <Real,XX>::Algorithms
-                    ::getMin_(msg,cmanip,fns,state);
+                    ::getMin_(msg,tmanip,fns,state);
             }
         };
     };
@@ -9553,6 +12145,12 @@ namespace Optizelle{
                 Unconstrained <Real,XX>::State::check_(msg,state);
                 EqualityConstrained <Real,XX,YY>::State::check_(msg,state);
                 InequalityConstrained <Real,XX,ZZ>::State::check_(msg,state);
+
+                // The predictor step in a Mehrotra predictor-corrector method
+                // does not account for the equality constraints
+                if(state.ipm==InteriorPointMethod::Mehrotra)
+                    msg.error("The Mehrotra predictor-corrector method is not "
+                        "available for problems with equality constraints.");
             }
         };
         
@@ -9764,6 +12362,18 @@ namespace Optizelle{
                 InequalityConstrained <Real,XX,ZZ>
                     ::Functions::init_(msg,state,fns);
             }
+
+            // Announces the current iterate to the functions that want it
+            static void linearize(
+                t const & fns,
+                typename State::t const & state
+            ) {
+                Unconstrained <Real,XX>::Functions::linearize_(fns,state);
+                EqualityConstrained <Real,XX,YY>::Functions::linearize_(
+                    fns,state);
+                InequalityConstrained <Real,XX,ZZ>::Functions::linearize_(
+                    fns,state);
+            }
         };
         
         // Contains functions that assist in creating an output for diagonstics
@@ -9774,13 +12384,13 @@ namespace Optizelle{
             // Gets the header for the state information
             static void getStateHeader_(
                 typename State::t const & state,
-                std::list <std::string> & out
+                std::vector <std::string> & out
             ) { 
             }
             // Combines all of the state headers
             static void getStateHeader(
                 typename State::t const & state,
-                std::list <std::string> & out
+                std::vector <std::string> & out
             ) {
                 Unconstrained <Real,XX>::Diagnostics::getStateHeader_(
                     state,out);
@@ -9794,22 +12404,21 @@ namespace Optizelle{
             static void getState(
                 typename Functions::t const & fns,
                 typename State::t const & state,
-                bool const & blank,
-                bool const & noiter,
-                std::list <std::string> & out
+                X_Vector & grad_diag,
+                std::vector <TelemetryValue <Real> > & out
             ) {
                 Unconstrained <Real,XX>::Diagnostics
-                    ::getState_(fns,state,blank,noiter,out);
+                    ::getState_(fns,state,grad_diag,out);
                 EqualityConstrained <Real,XX,YY>::Diagnostics
-                    ::getState_(fns,state,blank,out);
+                    ::getState_(fns,state,out);
                 InequalityConstrained <Real,XX,ZZ>::Diagnostics
-                    ::getState_(fns,state,blank,out);
+                    ::getState_(fns,state,out);
             }
 
             // Combines all of the Krylov headers
             static void getKrylovHeader(
                 typename State::t const & state,
-                std::list <std::string> & out
+                std::vector <std::string> & out
             ) {
                 Unconstrained <Real,XX>::Diagnostics::getKrylovHeader_(
                     state,out);
@@ -9822,15 +12431,13 @@ namespace Optizelle{
             // Combines all of the Krylov information
             static void getKrylov(
                 typename State::t const & state,
-                bool const & blank,
-                std::list <std::string> & out
+                std::vector <TelemetryValue <Real> > & out
             ) {
-                Unconstrained <Real,XX>::Diagnostics::getKrylov_(
-                    state,blank,out);
+                Unconstrained <Real,XX>::Diagnostics::getKrylov_(state,out);
                 EqualityConstrained <Real,XX,YY>::Diagnostics::getKrylov_(
-                    state,blank,out);
+                    state,out);
                 InequalityConstrained <Real,XX,ZZ>::Diagnostics::getKrylov_(
-                    state,blank,out);
+                    state,out);
             }
             
             // Runs the specified function diagnostics 
@@ -9874,10 +12481,26 @@ namespace Optizelle{
                 typename Functions::t & fns,
                 typename State::t & state,
                 StateManipulator <Constrained <Real,XX,YY,ZZ> > const & smanip
+            ){
+                // Print the diagnostic information as text
+                TextTelemetry <Real> sink(msg);
+
+                // Minimize the problem
+                getMin(msg,fns,state,smanip,sink);
+            }
+
+            // Initializes remaining functions then solves an optimization
+            // problem while sending the diagnostic information to sink
+            static void getMin(
+                Messaging const & msg,
+                typename Functions::t & fns,
+                typename State::t & state,
+                StateManipulator <Constrained <Real,XX,YY,ZZ> > const & smanip,
+                TelemetrySink <Real> & sink
             ){
                 // Adds the output pieces to the state manipulator 
-                DiagnosticManipulator <Constrained <Real,XX,YY,ZZ> >
-                    dmanip(smanip,msg);
+                DiagnosticManipulator <Real,Constrained <Real,XX,YY,ZZ> >
+                    dmanip(smanip,msg,sink);
 
                 // Add the interior point pieces to the state manipulator
                 typename InequalityConstrained <Real,XX,ZZ>::Algorithms
@@ -9891,10 +12514,14 @@ namespace Optizelle{
                     <Constrained <Real,XX,YY,ZZ> >
                     csmanip(ipmanip,msg);
 
+                // Announce new iterates to the functions
+                LinearizationManipulator <Constrained <Real,XX,YY,ZZ> >
+                    lmanip(csmanip);
+
                 // Insures that we can interact with unconstrained code
                 ConversionManipulator
                     <Constrained<Real,XX,YY,ZZ>,Unconstrained <Real,XX> >
-                    cmanip(csmanip);
+                    cmanip(lmanip);
                 
                 // Initialize any remaining functions required for optimization 
                 Functions::init(msg,state,fns);
@@ -9902,9 +12529,17 @@ namespace Optizelle{
                 // Check the inputs to the optimization
                 State::check(msg,state);
                 
+                // Record the phases between the optimization locations
+                #ifdef OPTIZELLE_TRACING
+                TracingManipulator <Unconstrained <Real,XX> > tmanip(cmanip);
+                #else
+                auto const & tmanip = cmanip;
+                #endif
+
                 // Minimize the problem
+                OPTIZELLE_TRACE(trace,"getMin","solver")
                 Unconstrained <Real,XX>::Algorithms
-                    ::getMin_(msg,cmanip,fns,state);
+                    ::getMin_(msg,tmanip,fns,state);
             }
         };
     };
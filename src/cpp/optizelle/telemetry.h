@@ -0,0 +1,377 @@
+/*
+Copyright 2013-2014 OptimoJoe.
+
+For the full copyright notice, see LICENSE.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Author: Joseph Young (joe@optimojoe.com)
+*/
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <cstdint>
+#include <iomanip>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "optizelle/optizelle.h"
+
+//---Optizelle0---
+namespace Optizelle {
+//---Optizelle1---
+
+    // Telemetry stored column by column, so that each metric sits
+    // contiguously in memory and on disk.  Every column holds either integers
+    // or real numbers along with a flag for each row that marks whether the
+    // row has a value at all.
+    //
+    // The binary format, in native byte order, is
+    //
+    // "OPTZTEL1"
+    // uint64 number of columns, uint64 number of rows
+    // for each column: uint64 kind, uint64 length of the name, the name
+    // one byte per row that marks rejected steps
+    // for each column: one byte per row that marks whether the row has a
+    //     value followed by the values, which are uint64 for integers and
+    //     Krylov stopping conditions, double for real numbers, and absent
+    //     for columns that never had a value
+    template <typename Real>
+    struct TelemetryTable {
+        // A single column
+        struct Column {
+            // Name of the column
+            std::string name;
+
+            // Kind of values in the column.  This remains Blank until the
+            // column receives its first value.
+            TelemetryKind::t kind;
+
+            // Values of integer and Krylov stopping condition columns
+            std::vector <Natural> integers;
+
+            // Values of real number columns
+            std::vector <Real> numbers;
+
+            // Whether each row has a value
+            std::vector <unsigned char> present;
+
+            // Start an empty column
+            explicit Column(std::string const & name_) :
+                name(name_),
+                kind(TelemetryKind::Blank),
+                integers(),
+                numbers(),
+                present()
+            {}
+
+            // Adds a value to the end of the column.  Returns false if the
+            // kind of the value doesn't match the rest of the column.
+            bool push(TelemetryValue <Real> const & value) {
+                // Figure out the kind of the column from the first value and
+                // fill in the rows that came before
+                if(kind==TelemetryKind::Blank &&
+                    value.kind!=TelemetryKind::Blank
+                ) {
+                    kind=value.kind;
+                    if(kind==TelemetryKind::Number)
+                        numbers.resize(present.size(),Real(0.));
+                    else
+                        integers.resize(present.size(),0);
+                }
+
+                // Make sure that the kinds match
+                bool const blank = value.kind==TelemetryKind::Blank;
+                if(!blank && value.kind!=kind)
+                    return false;
+
+                // Store the value
+                present.push_back(!blank);
+                switch(kind) {
+                case TelemetryKind::Integer:
+                    integers.push_back(blank ? 0 : value.integer);
+                    break;
+                case TelemetryKind::Stop:
+                    integers.push_back(blank ? 0 : Natural(value.stop));
+                    break;
+                case TelemetryKind::Number:
+                    numbers.push_back(blank ? Real(0.) : value.number);
+                    break;
+                default:
+                    break;
+                }
+                return true;
+            }
+
+            // Grabs the value in a particular row
+            TelemetryValue <Real> operator [] (Natural const & i) const {
+                if(!present[i])
+                    return TelemetryValue <Real> ();
+                switch(kind) {
+                case TelemetryKind::Integer:
+                    return TelemetryValue <Real> (integers[i]);
+                case TelemetryKind::Stop:
+                    return TelemetryValue <Real> (
+                        KrylovStop::t(integers[i]));
+                case TelemetryKind::Number:
+                    return TelemetryValue <Real> (numbers[i]);
+                default:
+                    return TelemetryValue <Real> ();
+                }
+            }
+        };
+
+        // Columns of the table
+        std::vector <Column> columns;
+
+        // Whether each row comes from a rejected step
+        std::vector <unsigned char> rejected;
+
+        // Start with an empty table
+        TelemetryTable() : columns(), rejected() {}
+
+        // Starts over with the given columns
+        void reset(std::vector <std::string> const & names) {
+            columns.clear();
+            for(auto const & name : names)
+                columns.emplace_back(name);
+            rejected.clear();
+        }
+
+        // Number of rows in the table
+        Natural rows() const {
+            return rejected.size();
+        }
+
+        // Finds the index of the column with the given name.  If there isn't
+        // one, returns the number of columns.
+        Natural find(std::string const & name) const {
+            Natural i=0;
+            for(;i<columns.size() && columns[i].name!=name;i++);
+            return i;
+        }
+
+        // Adds a row to the end of the table
+        void append(
+            Messaging const & msg,
+            TelemetryRecord <Real> const & record
+        ) {
+            if(record.values.size()!=columns.size())
+                msg.error("Telemetry record has " +
+                    std::to_string(record.values.size()) +
+                    " values, but the table has " +
+                    std::to_string(columns.size()) + " columns.");
+            for(Natural i=0;i<columns.size();i++)
+                if(!columns[i].push(record.values[i]))
+                    msg.error("Telemetry value in column " +
+                        columns[i].name + " changed its kind.");
+            rejected.push_back(record.rejected);
+        }
+
+        // Writes the table in the binary format
+        void write(std::ostream & out) const {
+            out.write("OPTZTEL1",8);
+            write_uint64(out,columns.size());
+            write_uint64(out,rows());
+            for(auto const & column : columns) {
+                write_uint64(out,column.kind);
+                write_uint64(out,column.name.size());
+                out.write(column.name.data(),column.name.size());
+            }
+            write_bytes(out,rejected);
+            for(auto const & column : columns) {
+                write_bytes(out,column.present);
+                switch(column.kind) {
+                case TelemetryKind::Integer:
+                case TelemetryKind::Stop:
+                    for(auto const & x : column.integers)
+                        write_uint64(out,x);
+                    break;
+                case TelemetryKind::Number:
+                    for(auto const & x : column.numbers) {
+                        double const y(x);
+                        out.write(reinterpret_cast <char const *> (&y),
+                            sizeof(double));
+                    }
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+
+        // Reads a table in the binary format
+        void read(Messaging const & msg,std::istream & in) {
+            // Check that we have the right kind of file
+            std::string const err_msg = "Invalid telemetry file.";
+            char magic[8];
+            in.read(magic,8);
+            if(!in || std::string(magic,8)!="OPTZTEL1")
+                msg.error(err_msg);
+
+            // Read the names and kinds of the columns
+            Natural const ncols = read_uint64(in);
+            Natural const nrows = read_uint64(in);
+            columns.clear();
+            for(Natural i=0;i<ncols;i++) {
+                Natural const kind = read_uint64(in);
+                std::string name(read_uint64(in),' ');
+                in.read(&name[0],name.size());
+                if(!in || kind > TelemetryKind::Stop)
+                    msg.error(err_msg);
+                columns.emplace_back(name);
+                columns.back().kind=TelemetryKind::t(kind);
+            }
+
+            // Read the data
+            read_bytes(in,nrows,rejected);
+            for(auto & column : columns) {
+                read_bytes(in,nrows,column.present);
+                switch(column.kind) {
+                case TelemetryKind::Integer:
+                case TelemetryKind::Stop:
+                    column.integers.resize(nrows);
+                    for(auto & x : column.integers)
+                        x=read_uint64(in);
+                    break;
+                case TelemetryKind::Number:
+                    column.numbers.resize(nrows);
+                    for(auto & x : column.numbers) {
+                        double y;
+                        in.read(reinterpret_cast <char *> (&y),sizeof(double));
+                        x=Real(y);
+                    }
+                    break;
+                default:
+                    break;
+                }
+            }
+            if(!in)
+                msg.error(err_msg);
+        }
+
+        // Writes the table as CSV with a final column that marks rejected
+        // steps.  Rows without a value are left empty.
+        void write_csv(std::ostream & out) const {
+            for(auto const & column : columns)
+                out << column.name << ',';
+            out << "rejected" << std::endl;
+            out << std::setprecision(std::numeric_limits <Real>::max_digits10)
+                << std::scientific;
+            for(Natural i=0;i<rows();i++) {
+                for(auto const & column : columns) {
+                    auto const value = column[i];
+                    switch(value.kind) {
+                    case TelemetryKind::Integer:
+                        out << value.integer;
+                        break;
+                    case TelemetryKind::Stop:
+                        out << KrylovStop::to_string(value.stop);
+                        break;
+                    case TelemetryKind::Number:
+                        out << value.number;
+                        break;
+                    default:
+                        break;
+                    }
+                    out << ',';
+                }
+                out << Natural(rejected[i]) << std::endl;
+            }
+        }
+
+    private:
+        // Reads and writes the pieces of the binary format
+        static void write_uint64(std::ostream & out,Natural const & x) {
+            std::uint64_t const y(x);
+            out.write(reinterpret_cast <char const *> (&y),sizeof(y));
+        }
+        static Natural read_uint64(std::istream & in) {
+            std::uint64_t y(0);
+            in.read(reinterpret_cast <char *> (&y),sizeof(y));
+            return Natural(y);
+        }
+        static void write_bytes(
+            std::ostream & out,
+            std::vector <unsigned char> const & x
+        ) {
+            out.write(reinterpret_cast <char const *> (x.data()),x.size());
+        }
+        static void read_bytes(
+            std::istream & in,
+            Natural const & n,
+            std::vector <unsigned char> & x
+        ) {
+            x.resize(n);
+            in.read(reinterpret_cast <char *> (x.data()),n);
+        }
+    };
+
+    // A telemetry sink that stores everything in columnar tables.  After the
+    // optimization, write the tables to file or look at the columns directly.
+    template <typename Real>
+    struct ColumnarTelemetry : public TelemetrySink <Real> {
+    private:
+        // A reference to the messsaging object
+        Messaging const & msg;
+
+    public:
+        // State at the end of each optimization iteration or rejected step
+        TelemetryTable <Real> iterations;
+
+        // State at the end of each Krylov iteration
+        TelemetryTable <Real> krylov_iterations;
+
+        // Disallow constructors
+        NO_COPY_ASSIGNMENT(ColumnarTelemetry)
+
+        // Report errors with the given messaging object
+        explicit ColumnarTelemetry(Messaging const & msg_) :
+            msg(msg_), iterations(), krylov_iterations()
+        {}
+
+        // Each header starts a new table
+        void stateHeader(std::vector <std::string> const & names) {
+            iterations.reset(names);
+        }
+        void krylovHeader(std::vector <std::string> const & names) {
+            krylov_iterations.reset(names);
+        }
+
+        // Each record adds a row
+        void state(TelemetryRecord <Real> const & record) {
+            iterations.append(msg,record);
+        }
+        void krylov(TelemetryRecord <Real> const & record) {
+            krylov_iterations.append(msg,record);
+        }
+    };
+
+//---Optizelle2---
+}
+//---Optizelle3---
+#endif
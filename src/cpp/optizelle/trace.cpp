@@ -0,0 +1,200 @@
+/*
+Copyright 2013-2014 OptimoJoe.
+
+For the full copyright notice, see LICENSE.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Author: Joseph Young (joe@optimojoe.com)
+*/
+
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <iomanip>
+#include "optizelle/trace.h"
+
+namespace Optizelle{
+    namespace Trace {
+        namespace {
+            // Guards the list of buffers
+            std::mutex lock;
+
+            // The buffers for every thread that's recorded an event.  We
+            // own these here, so they outlive their threads.
+            std::vector <std::unique_ptr <Buffer> > buffers;
+
+            // Buffers whose threads have exited, which we hand to the next
+            // threads that record an event
+            std::vector <Buffer *> free_buffers;
+
+            // Returns the buffer of a thread to the free list when the
+            // thread exits
+            struct Owner {
+                Buffer * buf;
+                Owner() : buf(nullptr) {}
+                Owner(Owner const &) = delete;
+                Owner & operator = (Owner const &) = delete;
+                ~Owner() {
+                    std::lock_guard <std::mutex> guard(lock);
+                    free_buffers.push_back(buf);
+                }
+            };
+
+            // Number of events that each new buffer keeps
+            std::size_t events_per_thread = std::size_t(1) << 16;
+
+            // Time at which we start counting
+            std::chrono::steady_clock::time_point const epoch
+                = std::chrono::steady_clock::now();
+
+            // Rounds up to the next power of two
+            std::size_t round_up(std::size_t const & n) {
+                std::size_t m = 1;
+                while(m < n)
+                    m <<= 1;
+                return m;
+            }
+
+            // Writes a string as a JSON string
+            void write_string(std::ostream & out,char const * const s) {
+                out << '"';
+                for(char const * c=s;*c;c++) {
+                    if(*c=='"' || *c=='\\')
+                        out << '\\' << *c;
+                    else if(static_cast <unsigned char> (*c) < 0x20)
+                        out << ' ';
+                    else
+                        out << *c;
+                }
+                out << '"';
+            }
+        }
+
+        // Creates an empty buffer
+        Buffer::Buffer(std::size_t const & capacity,std::size_t const & tid_) :
+            events(round_up(capacity)), head(0), tid(tid_)
+        {}
+
+        // Nanoseconds since the first time we asked
+        std::uint64_t now() {
+            return std::chrono::duration_cast <std::chrono::nanoseconds> (
+                std::chrono::steady_clock::now()-epoch).count();
+        }
+
+        // Hands the calling thread a buffer from the free list or a new one
+        Buffer & acquire_buffer() {
+            Buffer * buf = nullptr;
+            {
+                std::lock_guard <std::mutex> guard(lock);
+                if(free_buffers.empty()) {
+                    buffers.emplace_back(
+                        new Buffer(events_per_thread,buffers.size()+1));
+                    buf = buffers.back().get();
+                } else {
+                    buf = free_buffers.back();
+                    free_buffers.pop_back();
+                }
+            }
+
+            // Return the buffer when this thread exits
+            thread_local Owner owner;
+            owner.buf = buf;
+            return *buf;
+        }
+
+        // Sets the number of events that each thread keeps
+        void capacity(std::size_t const & n) {
+            std::lock_guard <std::mutex> guard(lock);
+            events_per_thread = round_up(n > 0 ? n : 1);
+            for(auto & buf : buffers) {
+                buf->events.assign(events_per_thread,Event());
+                buf->head.store(0,std::memory_order_release);
+            }
+        }
+
+        // Forgets all of the recorded events
+        void clear() {
+            std::lock_guard <std::mutex> guard(lock);
+            for(auto & buf : buffers)
+                buf->head.store(0,std::memory_order_release);
+        }
+
+        // Writes the trace in the Chrome trace event format
+        void write_chrome(std::ostream & out) {
+            std::lock_guard <std::mutex> guard(lock);
+
+            // Timestamps are in microseconds
+            auto const flags = out.flags();
+            auto const precision = out.precision();
+            out << std::fixed << std::setprecision(3);
+
+            out << "{\"traceEvents\":[";
+            bool first = true;
+            for(auto const & buf : buffers) {
+                // Find the oldest event that we still have
+                std::uint64_t const head
+                    = buf->head.load(std::memory_order_acquire);
+                std::uint64_t const size = buf->events.size();
+                std::uint64_t const begin = head > size ? head-size : 0;
+
+                for(std::uint64_t i=begin;i<head;i++) {
+                    Event const & event = buf->events[i & (size-1)];
+
+                    // Phases become a pair of asynchronous events that share
+                    // an id with the other phases on this thread
+                    if(event.phase) {
+                        for(auto const & mark : {'b','e'}) {
+                            out << (first ? "\n" : ",\n") << "{\"name\":";
+                            first = false;
+                            write_string(out,event.name);
+                            out << ",\"cat\":";
+                            write_string(out,event.category);
+                            out << ",\"ph\":\"" << mark << "\",\"ts\":"
+                                << (event.start
+                                    + (mark=='e' ? event.duration : 0))/1e3
+                                << ",\"id\":" << buf->tid
+                                << ",\"pid\":1,\"tid\":" << buf->tid << "}";
+                        }
+
+                    // Everything else becomes a complete event
+                    } else {
+                        out << (first ? "\n" : ",\n") << "{\"name\":";
+                        first = false;
+                        write_string(out,event.name);
+                        out << ",\"cat\":";
+                        write_string(out,event.category);
+                        out << ",\"ph\":\"X\",\"ts\":" << event.start/1e3
+                            << ",\"dur\":" << event.duration/1e3
+                            << ",\"pid\":1,\"tid\":" << buf->tid << "}";
+                    }
+                }
+            }
+            out << "\n]}" << std::endl;
+
+            out.flags(flags);
+            out.precision(precision);
+        }
+    }
+}
@@ -0,0 +1,169 @@
+/*
+Copyright 2013-2014 OptimoJoe.
+
+For the full copyright notice, see LICENSE.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Author: Joseph Young (joe@optimojoe.com)
+*/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+
+// Records the rest of the enclosing scope as an event with the given name and
+// category.  Both must be string literals or otherwise outlive the trace.
+// Unless we compile with OPTIZELLE_TRACING, this does nothing.
+#ifdef OPTIZELLE_TRACING
+#define OPTIZELLE_TRACE(var,name,category) \
+    Optizelle::Trace::Scope var(name,category);
+#else
+#define OPTIZELLE_TRACE(var,name,category)
+#endif
+
+//---Optizelle0---
+namespace Optizelle {
+//---Optizelle1---
+
+    // Timestamped events that record where the solvers spend their time.
+    // Each thread writes into its own ring buffer, so recording an event
+    // never takes a lock.  When a buffer fills, we overwrite its oldest
+    // events.  Unlike the rest of Optizelle, the buffers are global state.
+    // Recording from any number of threads is safe, but we must only change
+    // the capacity, clear, or export the trace while no thread records.
+    //
+    // The buffers live until the program exits, so we can still export the
+    // events of a thread that has finished.  When a thread exits, it returns
+    // its buffer to a free list and the next thread that records an event
+    // takes it over along with its identifier.  Hence, we only allocate as
+    // many buffers as there were threads recording at once, and the new
+    // thread's events overwrite the oldest ones of the thread before it.
+    // Threads must not record events from the destructors of their
+    // thread_local objects, since they may have already returned their
+    // buffer.
+    namespace Trace {
+        // A span of time that begins at start and lasts for duration.  Both
+        // are in nanoseconds.  We store complete spans rather than separate
+        // begin and end events, so overwriting old events never leaves one
+        // without the other.
+        struct Event {
+            char const * name;
+            char const * category;
+            std::uint64_t start;
+            std::uint64_t duration;
+
+            // Whether the span may overlap other spans on the same thread
+            // without nesting inside of them
+            bool phase;
+        };
+
+        // The ring buffer for a single thread
+        struct Buffer {
+            // Storage for the events.  The size is a power of two.
+            std::vector <Event> events;
+
+            // Total number of events that we've recorded.  Only the owning
+            // thread writes this.
+            std::atomic <std::uint64_t> head;
+
+            // Identifier for the thread
+            std::size_t tid;
+
+            Buffer(std::size_t const & capacity,std::size_t const & tid_);
+        };
+
+        // Nanoseconds since the first time we asked
+        std::uint64_t now();
+
+        // Hands the calling thread a buffer from the free list or, when the
+        // list is empty, a new one.  The thread returns the buffer to the
+        // list when it exits.
+        Buffer & acquire_buffer();
+
+        // Grabs the buffer for this thread, which we acquire the first time
+        // the thread records an event
+        inline Buffer & buffer() {
+            thread_local Buffer * buf = nullptr;
+            if(!buf)
+                buf = &acquire_buffer();
+            return *buf;
+        }
+
+        // Records a span into this thread's buffer
+        inline void record(
+            char const * const name,
+            char const * const category,
+            std::uint64_t const & start,
+            std::uint64_t const & duration,
+            bool const & phase = false
+        ) {
+            Buffer & buf = buffer();
+            std::uint64_t const head = buf.head.load(std::memory_order_relaxed);
+            buf.events[head & (buf.events.size()-1)]
+                = Event{name,category,start,duration,phase};
+            buf.head.store(head+1,std::memory_order_release);
+        }
+
+        // Records the lifetime of this object
+        struct Scope {
+        private:
+            char const * const name;
+            char const * const category;
+            std::uint64_t const start;
+
+        public:
+            Scope(char const * const name_,char const * const category_) :
+                name(name_), category(category_), start(now())
+            {}
+            Scope(Scope const &) = delete;
+            Scope & operator = (Scope const &) = delete;
+            ~Scope() {
+                record(name,category,start,now()-start);
+            }
+        };
+
+        // Sets the number of events that each thread keeps, which we round
+        // up to a power of two.  This also clears the trace.
+        void capacity(std::size_t const & n);
+
+        // Forgets all of the recorded events
+        void clear();
+
+        // Writes the trace in the Chrome trace event format, which both
+        // chrome://tracing and Perfetto read.  Spans become complete events
+        // and phases become asynchronous events, which the viewers place on
+        // their own tracks.
+        void write_chrome(std::ostream & out);
+    }
+
+//---Optizelle2---
+}
+//---Optizelle3---
+#endif
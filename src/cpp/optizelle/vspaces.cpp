@@ -73,6 +73,42 @@ namespace Optizelle {
         }
     }
 
+    // How we store the semidefinite blocks in SQL vectors
+    namespace SDPStorage {
+
+        // Converts the storage to a string
+        std::string to_string(t const & storage){
+            switch(storage){
+            case Full:
+                return "Full";
+            case Packed:
+                return "Packed";
+            default:
+                throw;
+            }
+        }
+        
+        // Converts a string to a storage 
+        t from_string(std::string const & storage){
+            if(storage=="Full")
+                return Full;
+            else if(storage=="Packed")
+                return Packed;
+            else
+                throw;
+        }
+
+        // Checks whether or not a string is valid
+        bool is_valid(std::string const & name) {
+            if( name=="Full" ||
+                name=="Packed"
+            )
+                return true;
+            else
+                return false;
+        }
+    }
+
     // Optimization problems instantiated on these vector spaces.  In theory,
     // this should help our compilation times.
     template struct Unconstrained<double,Rm>;
@@ -33,6 +33,7 @@ Author: Joseph Young (joe@optimojoe.com)
 #define VSPACES_H
 #include <cmath>
 #include <random>
+#include <algorithm>
 #include "optizelle/linalg.h"
 #include "optizelle/optizelle.h"
 #include "optizelle/json.h"
@@ -63,6 +64,67 @@ namespace Optizelle {
             Optizelle::copy <Real> (x.size(),&(x.front()),1,&(y.front()),1);
         }
 
+        // Memory allocation and size setting in the precision Real2
+        template <typename Real2>
+        static typename Rm <Real2>::Vector init_prec(Vector const & x) {
+            return std::move(typename Rm <Real2>::Vector(x.size()));
+        }
+
+        // y <- x where y is stored in the precision Real2
+        template <typename Real2>
+        static void copy_prec(
+            Vector const & x,
+            typename Rm <Real2>::Vector & y
+        ) {
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural i=0;i<x.size();i++) 
+                y[i]=Real2(x[i]);
+        }
+
+        // innr <- <x,y> where x is stored in the precision Real2
+        template <typename Real2>
+        static Real innr_prec(
+            typename Rm <Real2>::Vector const & x,
+            Vector const & y
+        ) {
+            Real z(0.);
+            #ifdef _OPENMP
+            #pragma omp parallel for reduction(+:z) schedule(static)
+            #endif
+            for(Natural i=0;i<y.size();i++) 
+                z+=Real(x[i])*y[i];
+            return z;
+        }
+
+        // y <- alpha * x + y where x is stored in the precision Real2
+        template <typename Real2>
+        static void axpy_prec(
+            Real const & alpha,
+            typename Rm <Real2>::Vector const & x,
+            Vector & y
+        ) {
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural i=0;i<y.size();i++) 
+                y[i]+=alpha*Real(x[i]);
+        }
+
+        // Number of coordinates of x
+        static Natural dim(Vector const & x) {
+            return x.size();
+        }
+
+        // Pointer to the coordinates of x
+        static Real * coords(Vector & x) {
+            return x.data();
+        }
+        static Real const * coords(Vector const & x) {
+            return x.data();
+        }
+
         // x <- alpha * x.
         static void scal(Real const & alpha, Vector & x) {
             Optizelle::scal <Real> (x.size(),alpha,&(x.front()),1);
@@ -234,10 +296,36 @@ namespace Optizelle {
         bool is_valid(std::string const & name); 
     }
 
+    // How we store the semidefinite blocks in SQL vectors
+    namespace SDPStorage {
+        enum t {
+            //---SDPStorage0---
+            Full,               // Full m x m column-major matrix
+            Packed              // Upper triangle in rectangular full packed
+                                // (RFP) format
+            //---SDPStorage1---
+        };
+
+        // Converts the storage to a string
+        std::string to_string(t const & storage);
+        
+        // Converts a string to a storage 
+        t from_string(std::string const & storage);
+
+        // Checks whether or not a string is valid
+        bool is_valid(std::string const & name); 
+    }
+
     // A vector spaces consisting of a finite product of semidefinite,
     // quadratic, and linear cones.  This uses the nonsymmetric product
     // for the SDP blocks where x o y = xy.  This is not a true Euclidean-Jordan
-    // algebra, but is sufficient for our purposes.
+    // algebra, but is sufficient for our purposes.  Alternatively, the SDP
+    // blocks may be stored in rectangular full packed format.  In this case,
+    // we store the upper triangle of each block, which remains symmetric.
+    // Since xy isn't symmetric, prod writes the semidefinite blocks of its
+    // result to a separate full-storage temporary.  The block lives there
+    // until symm, linv, or an assignment folds it back into packed storage.
+    // Hence, packed blocks follow the same path as full blocks.
     //---SQL0---
     template <typename Real>
     struct SQL {
@@ -261,19 +349,40 @@ namespace Optizelle {
             // Size of the cones stored in the data.
             std::vector <Natural> sizes;
 
-            // Cached matrix inverses.  Once we have the offset, we store the
-            // matrix.
+            // How we store the semidefinite blocks
+            SDPStorage::t storage;
+
+            // Cached matrix inverses.  For packed storage, we cache the
+            // Choleski factor in RFP format instead.
             mutable std::vector <Real> inverse;
 
             // Offsets of the cached matrix inverses 
             std::vector <Natural> inverse_offsets;
 
-            // Point where we last took the matrix inverse 
+            // Point where we last took the matrix inverse
             mutable std::vector <Real> inverse_base;
 
-            // Offsets for the bases stored for the matrix inverses 
+            // Offsets for the bases stored for the cached decompositions
             std::vector <Natural> inverse_base_offsets;
 
+            // Indices of the second-order cone blocks sorted by their size.
+            // We use these to apply the cone operations to all of the
+            // second-order cones in a single pass, which matters when we
+            // have a large number of small cones.
+            std::vector <Natural> quadratic_blocks;
+
+            // Full-storage temporaries for the packed SDP blocks that hold
+            // a nonsymmetric Jordan product.  We only allocate these the
+            // first time that a product needs them.
+            std::vector <Real> wide;
+
+            // Offsets of the full-storage temporaries
+            std::vector <Natural> wide_offsets;
+
+            // Whether or not each block currently lives in its full-storage
+            // temporary rather than in the packed data
+            std::vector <bool> widened;
+
             // Eliminate constructors 
             NO_DEFAULT_COPY_ASSIGNMENT(Vector)
 
@@ -285,9 +394,21 @@ namespace Optizelle {
                 Messaging const msg = Optizelle::Messaging()
             )
             //---SQLVector3---
+            : Vector(types_,sizes_,SDPStorage::Full,msg) {}
+
+            //---SQLVector6---
+            // Optionally, we specify how to store the semidefinite blocks.
+            Vector (
+                std::vector <Cone::t> const & types_,
+                std::vector <Natural> const & sizes_,
+                SDPStorage::t const & storage_,
+                Messaging const msg = Optizelle::Messaging()
+            )
+            //---SQLVector7---
             : data(), offsets(), types(types_), sizes(sizes_),
-                inverse(), inverse_offsets(), inverse_base(),
-                inverse_base_offsets()
+                storage(storage_), inverse(), inverse_offsets(),
+                inverse_base(), inverse_base_offsets(), quadratic_blocks(),
+                wide(), wide_offsets(), widened(types_.size(),false)
             {
 
                 // Insure that the type of cones and their sizes lines up.
@@ -307,41 +428,61 @@ namespace Optizelle {
                     offsets[itok(i)] = types[itok(i-1)]==Cone::Linear ||
                                        types[itok(i-1)]==Cone::Quadratic
                                      ? offsets[itok(i-1)]+sizes[itok(i-1)]
-                                     : offsets[itok(i-1)]+sizes[itok(i-1)]
-                                         *sizes[itok(i-1)];
+                                     : offsets[itok(i-1)]
+                                         +sdpLength(sizes[itok(i-1)]);
 
                 // Create the data.
                 data.resize(offsets.back());
 
-                // Calculate offsets for the matrix inverses.  Basically,
-                // the way it works is that we calculate offsets for every cone
-                // even though we're not ever going to use them.  In the case
-                // we don't have an SDP block, we simply use the last offset.
-                // This makes it easy to index to the correct place where the
-                // cached information is stored.
+                // Calculate offsets for the matrix inverses and the
+                // full-storage temporaries.  Basically, the way it works is
+                // that we calculate offsets for every cone even though we're
+                // not ever going to use them.  In the case we don't have an
+                // SDP block, or we don't need a temporary for this storage, we
+                // simply use the last offset.  This makes it easy to index to
+                // the correct place where the cached information is stored.
                 inverse_offsets.resize(sizes.size()+1);
                 inverse_offsets.front()=0;
                 inverse_base_offsets.resize(sizes.size()+1);
                 inverse_base_offsets.front()=0;
+                wide_offsets.resize(sizes.size()+1);
+                wide_offsets.front()=0;
+                bool const packed = storage==SDPStorage::Packed;
                 for(Natural i=1;i<types.size()+1;i++) {
                     inverse_offsets[i] =
                         types[itok(i)]==Cone::Linear ||
                         types[itok(i)]==Cone::Quadratic
                             ? inverse_offsets[itok(i)]
                             : inverse_offsets[itok(i)]
-                                +sizes[itok(i)]*sizes[itok(i)];
+                                +sdpLength(sizes[itok(i)]);
                     inverse_base_offsets[i] =
                         types[itok(i)]==Cone::Linear ||
                         types[itok(i)]==Cone::Quadratic
                             ? inverse_base_offsets[itok(i)]
                             : inverse_base_offsets[itok(i)]
+                                +sdpLength(sizes[itok(i)]);
+                    wide_offsets[i] =
+                        types[itok(i)]==Cone::Linear ||
+                        types[itok(i)]==Cone::Quadratic || !packed
+                            ? wide_offsets[itok(i)]
+                            : wide_offsets[itok(i)]
                                 +sizes[itok(i)]*sizes[itok(i)];
                 }
 
-                // Create the memory required for the cached Schur
-                // decompositions.
+                // Create the memory required for the cached decompositions.
                 inverse.resize(inverse_offsets.back());
                 inverse_base.resize(inverse_base_offsets.back());
+
+                // Group the second-order cones by size.  This keeps the work
+                // in each chunk of the parallel loops below about the same.
+                for(Natural i=1;i<=types.size();i++)
+                    if(types[itok(i)]==Cone::Quadratic)
+                        quadratic_blocks.push_back(i);
+                std::stable_sort(quadratic_blocks.begin(),
+                    quadratic_blocks.end(),
+                    [this](Natural const & i,Natural const & j) {
+                        return sizes[itok(i)] < sizes[itok(j)];
+                    });
             }
             
             // Move constructor 
@@ -350,10 +491,15 @@ namespace Optizelle {
                 offsets(std::move(x.offsets)),
                 types(std::move(x.types)),
                 sizes(std::move(x.sizes)),
+                storage(x.storage),
                 inverse(std::move(x.inverse)),
                 inverse_offsets(std::move(x.inverse_offsets)),
                 inverse_base(std::move(x.inverse_base)),
-                inverse_base_offsets(std::move(x.inverse_base_offsets))
+                inverse_base_offsets(std::move(x.inverse_base_offsets)),
+                quadratic_blocks(std::move(x.quadratic_blocks)),
+                wide(std::move(x.wide)),
+                wide_offsets(std::move(x.wide_offsets)),
+                widened(std::move(x.widened))
             {}
 
             // Move assignment operator
@@ -362,10 +508,15 @@ namespace Optizelle {
                 offsets=std::move(x.offsets);
                 types=std::move(x.types);
                 sizes=std::move(x.sizes);
+                storage=x.storage;
                 inverse=std::move(x.inverse);
-                inverse_offsets=std::move(inverse_offsets);
-                inverse_base=std::move(inverse_base);
-                inverse_base_offsets=std::move(inverse_base_offsets);
+                inverse_offsets=std::move(x.inverse_offsets);
+                inverse_base=std::move(x.inverse_base);
+                inverse_base_offsets=std::move(x.inverse_base_offsets);
+                quadratic_blocks=std::move(x.quadratic_blocks);
+                wide=std::move(x.wide);
+                wide_offsets=std::move(x.wide_offsets);
+                widened=std::move(x.widened);
                 return *this;
             }
 
@@ -385,24 +536,33 @@ namespace Optizelle {
                 return data[offsets[itok(k)]+itok(i)];
             }
 
-            // Indexing a matrix with multiple cones.
+            // Indexing a matrix with multiple cones.  When the semidefinite
+            // blocks are packed, (i,j) and (j,i) refer to the same element
+            // unless the block lives in its full-storage temporary.
             Real & operator () (
                 Natural const & k,Natural const & i,Natural const & j
             ) {
-                return data[offsets[itok(k)]+ijtok(i,j,sizes[itok(k)])];
+                if(widened[itok(k)])
+                    return wide[wide_offsets[itok(k)]
+                        +ijtok(i,j,sizes[itok(k)])];
+                return data[offsets[itok(k)]+sdpIndex(i,j,sizes[itok(k)])];
             }
             Real const & operator ()(
                 Natural const & k,Natural const & i,Natural const & j
             ) const {
-                return data[offsets[itok(k)]+ijtok(i,j,sizes[itok(k)])];
+                if(widened[itok(k)])
+                    return wide[wide_offsets[itok(k)]
+                        +ijtok(i,j,sizes[itok(k)])];
+                return data[offsets[itok(k)]+sdpIndex(i,j,sizes[itok(k)])];
             }
 
-            // First element of the block
+            // First element of the block.  For packed semidefinite blocks,
+            // this is the start of the RFP array and not the (1,1) element.
             Real const & front(Natural const & blk) const {
-                return (*this)(blk,1,1);
+                return data[offsets[itok(blk)]];
             }
             Real & front(Natural const & blk) {
-                return (*this)(blk,1,1);
+                return data[offsets[itok(blk)]];
             }
 
             // These are really shortcuts for second-order cone blocks, which
@@ -436,38 +596,65 @@ namespace Optizelle {
             Natural numBlocks() const {
                 return types.size();
             }
+
+            // Number of elements used to store a semidefinite block of size m
+            Natural sdpLength(Natural const & m) const {
+                return storage==SDPStorage::Packed ? m*(m+1)/2 : m*m;
+            }
+
+            // Location of the (i,j) element within a semidefinite block of
+            // size m
+            Natural sdpIndex(
+                Natural const & i,
+                Natural const & j,
+                Natural const & m
+            ) const {
+                return storage==SDPStorage::Full ? ijtok(i,j,m) :
+                    i<=j ? ijtokrf(i,j,m) : ijtokrf(j,i,m);
+            }
+
+            // First element of the full-storage temporary of a packed block
+            Real const & wideFront(Natural const & blk) const {
+                return wide[wide_offsets[itok(blk)]];
+            }
+            Real & wideFront(Natural const & blk) {
+                return wide[wide_offsets[itok(blk)]];
+            }
+
+            // Whether or not any block lives in its full-storage temporary
+            bool isWide() const {
+                return std::find(widened.begin(),widened.end(),true)
+                    !=widened.end();
+            }
+
+            // Allocates the full-storage temporaries unless we have them
+            void allocWide() {
+                wide.resize(wide_offsets.back());
+            }
         //---SQLVector4---
         };
         //---SQLVector5---
 
-        // Gets the matrix inverse of a block of the SQL vector.
-        static void get_inverse(
-            Vector const & X,
-            Natural const & blk,
-            std::vector <Real> & Xinv 
-        ) {
-            // Get the size of the block
+        // Checks whether the cached decomposition of a block of the SQL
+        // vector is out of date.  If so, we store the current block as the new
+        // base and return true.
+        static bool refresh_base(Vector const & X,Natural const & blk) {
+            // Get the size of the block and the amount of storage it uses
             const Natural m=X.sizes[itok(blk)];
-
-            // Next, check if we've already calculated the matrix inverse.
-
-            // Copy out the the base of the last inverse 
-            std::vector <Real> tmp(m*m);
-            Optizelle::copy <Real>
-                (m*m,&(X.inverse_base[X.inverse_base_offsets[itok(blk)]]),
-                1,&(tmp.front()),1);
+            const Natural n=X.sdpLength(m);
+            Real const * const X_k=&(X.data[X.offsets[itok(blk)]]);
+            Real * const base=
+                &(X.inverse_base[X.inverse_base_offsets[itok(blk)]]);
 
             // tmp <- Base_k - X_k
-            Optizelle::axpy <Real>
-                (m*m,Real(-1.),&(X.data[X.offsets[itok(blk)]]),
-                1,&(tmp.front()),1);
+            std::vector <Real> tmp(n);
+            Optizelle::copy <Real> (n,base,1,&(tmp.front()),1);
+            Optizelle::axpy <Real> (n,Real(-1.),X_k,1,&(tmp.front()),1);
 
             // Find the relative error between the current iterate
             // and the base
-            Real norm_xk = sqrt(dot <Real>
-                (m*m,&(X.data[X.offsets[itok(blk)]]),1,
-                &(X.data[X.offsets[itok(blk)]]),1));
-            Real rel_err = sqrt(dot<Real> (m,&(tmp.front()),1,&(tmp.front()),1))
+            Real norm_xk = sqrt(dot <Real> (n,X_k,1,X_k,1));
+            Real rel_err = sqrt(dot<Real> (n,&(tmp.front()),1,&(tmp.front()),1))
                 / (std::numeric_limits <Real>::epsilon()+norm_xk);
 
             // If the relative error is large, refresh the cached decomposition.
@@ -476,66 +663,282 @@ namespace Optizelle {
             // the iterates will probably change rapidly, so I don't think
             // we have to worry too much, but be careful.
             if(rel_err > std::numeric_limits <Real>::epsilon()*1e2) {
+                Optizelle::copy<Real> (n,X_k,1,base,1);
+                return true;
+            }
+            return false;
+        }
 
-                // Store X_k as the new base
-                Optizelle::copy<Real> (m*m,&(X.data[X.offsets[itok(blk)]]),1,
-                    &(X.inverse_base[X.inverse_base_offsets[itok(blk)]]),1);
+        // Inverts a symmetric positive definite m x m matrix in place using
+        // the Choleski factorization of its upper triangle
+        static void invert(Natural const & m,Real * X) {
+            OPTIZELLE_TRACE(trace,"inverse","sql")
+            Integer info(0);
+            Optizelle::potrf <Real> ('U',m,X,m,info);
+            Optizelle::potri <Real> ('U',m,X,m,info);
 
-                // Find the matrix inverse of X_k 
+            // Copy the upper triangular portion to the lower.
+            for(Natural i=1;i<=m;i++)
+                Optizelle::copy <Real> (m-i,&(X[ijtok(i,i+1,m)]),m,
+                    &(X[ijtok(i+1,i,m)]),1);
+        }
 
-                // Find the matrix inverse.  This assumes the input is
-                // symmetric positive definite.
-                Integer info(0);
-                Optizelle::copy<Real> (m*m,&(X.data[X.offsets[itok(blk)]]),1,
-                    &(X.inverse[X.inverse_offsets[itok(blk)]]),1);
-                Optizelle::potrf <Real> ('U',m,
-                    &(X.inverse[X.inverse_offsets[itok(blk)]]),m,info);
-                Optizelle::potri <Real> ('U',m,
-                    &(X.inverse[X.inverse_offsets[itok(blk)]]),m,info);
-               
-                // Copy the upper triangular portion to the lower.
-                for(Natural i=1;i<=m;i++)
-                    Optizelle::copy <Real> (m-i,
-                        &(X.inverse[X.inverse_offsets[itok(blk)]
-                            +ijtok(i,i+1,m)]),m,
-                        &(X.inverse[X.inverse_offsets[itok(blk)]
-                            +ijtok(i+1,i,m)]),1);
+        // Gets the matrix inverse of a block of the SQL vector with full
+        // storage.  Only the upper triangle of the block matters.
+        static void get_inverse(
+            Vector const & X,
+            Natural const & blk,
+            std::vector <Real> & Xinv 
+        ) {
+            // Get the size of the block
+            const Natural m=X.sizes[itok(blk)];
+            Xinv.resize(m*m);
 
+            // Find the matrix inverse of X_k if we haven't already.  This
+            // assumes the input is symmetric positive definite.
+            Real * const inv=&(X.inverse[X.inverse_offsets[itok(blk)]]);
+            if(refresh_base(X,blk)) {
+                Optizelle::copy <Real> (m*m,&(X.front(blk)),1,inv,1);
+                invert(m,inv);
             }
 
             // Copy out the inverse from the cached copy
-            Xinv.resize(m*m);
-            Optizelle::copy <Real>
-                (m*m,&(X.inverse[X.inverse_offsets[itok(blk)]]),1,
-                &(Xinv.front()),1);
+            Optizelle::copy <Real> (m*m,inv,1,&(Xinv.front()),1);
+        }
+
+        // Gets the Choleski factor of a packed semidefinite block of the SQL
+        // vector in RFP format.  With any luck, this is cached.  Since the
+        // base only tracks the packed data, we factor a block that lives in
+        // its full-storage temporary into U without caching it.
+        static Real const * get_factor(
+            Vector const & X,
+            Natural const & blk,
+            std::vector <Real> & U
+        ) {
+            const Natural m=X.sizes[itok(blk)];
+            Integer info(0);
+            if(X.widened[itok(blk)]) {
+                U.resize(m*(m+1)/2);
+                Optizelle::trttf <Real> ('N','U',m,&(X.wideFront(blk)),m,
+                    &(U.front()),info);
+                Optizelle::pftrf <Real> ('N','U',m,&(U.front()),info);
+                return &(U.front());
+            }
+            Real * const U_k=&(X.inverse[X.inverse_offsets[itok(blk)]]);
+            if(refresh_base(X,blk)) {
+                OPTIZELLE_TRACE(trace,"inverse","sql")
+                Optizelle::copy <Real> (m*(m+1)/2,&(X.front(blk)),1,U_k,1);
+                Optizelle::pftrf <Real> ('N','U',m,U_k,info);
+            }
+            return U_k;
+        }
+
+        // Expands a symmetric matrix in RFP format into a full matrix 
+        static void unpack(Natural const & m,Real const * const Xrf,Real * X) {
+            Integer info(0);
+            Optizelle::tfttr <Real> ('N','U',m,Xrf,X,m,info);
+            for(Natural i=1;i<=m;i++)
+                Optizelle::copy <Real> (m-i,&(X[ijtok(i,i+1,m)]),m,
+                    &(X[ijtok(i+1,i,m)]),1);
+        }
+
+        // Expands a semidefinite block of the SQL vector into a full matrix
+        static void expand(Vector const & x,Natural const & blk,Real * X) {
+            Natural const m=x.blkSize(blk);
+            if(x.storage==SDPStorage::Full)
+                Optizelle::copy <Real> (m*m,&(x.front(blk)),1,X,1);
+            else if(x.widened[itok(blk)])
+                Optizelle::copy <Real> (m*m,&(x.wideFront(blk)),1,X,1);
+            else
+                unpack(m,&(x.front(blk)),X);
+        }
+
+        // Moves a packed semidefinite block of the SQL vector into its
+        // full-storage temporary unless it lives there already
+        static void widen(Vector & x,Natural const & blk) {
+            if(x.widened[itok(blk)]) return;
+            x.allocWide();
+            unpack(x.blkSize(blk),&(x.front(blk)),&(x.wideFront(blk)));
+            x.widened[itok(blk)]=true;
+        }
+
+        // Stores the symmetric part of a full matrix in a packed semidefinite
+        // block of the SQL vector.  This overwrites X.
+        static void fold(Real * X,Natural const & blk,Vector & x) {
+            Natural const m=x.blkSize(blk);
+            for(Natural j=2;j<=m;j++)
+                for(Natural i=1;i<j;i++)
+                    X[ijtok(i,j,m)]=
+                        Real(0.5)*(X[ijtok(i,j,m)]+X[ijtok(j,i,m)]);
+            Integer info(0);
+            Optizelle::trttf <Real> ('N','U',m,X,m,&(x.front(blk)),info);
+            x.widened[itok(blk)]=false;
+        }
+
+        // Gets the upper triangle of a semidefinite block of the SQL vector
+        // in RFP format.  We only copy the block when it's not packed
+        // already.
+        static Real const * rfp(
+            Vector const & x,
+            Natural const & blk,
+            std::vector <Real> & Xrf
+        ) {
+            Natural const m=x.blkSize(blk);
+            Real const * X_k=&(x.front(blk));
+            if(x.storage==SDPStorage::Packed) {
+                if(!x.widened[itok(blk)])
+                    return X_k;
+                X_k=&(x.wideFront(blk));
+            }
+            Xrf.resize(m*(m+1)/2);
+            Integer info(0);
+            Optizelle::trttf <Real> ('N','U',m,X_k,m,&(Xrf.front()),info);
+            return &(Xrf.front());
+        }
+
+        // y <- x where x and y may store their semidefinite blocks
+        // differently.  When y is packed, we keep the symmetric part of each
+        // semidefinite block.
+        static void convert(Vector const & x,Vector & y) {
+            if(x.storage==y.storage) {
+                copy(x,y);
+                return;
+            }
+            std::vector <Real> X;
+            for(Natural blk=1;blk<=x.numBlocks();blk++) {
+                Natural m=x.blkSize(blk);
+                if(x.blkType(blk)!=Cone::Semidefinite)
+                    Optizelle::copy <Real> (m,&(x.front(blk)),1,
+                        &(y.front(blk)),1);
+                else if(y.storage==SDPStorage::Packed) {
+                    X.resize(m*m);
+                    expand(x,blk,&(X.front()));
+                    fold(&(X.front()),blk,y);
+                } else
+                    expand(x,blk,&(y.front(blk)));
+            }
         }
         
         // Memory allocation and size setting
         static Vector init(Vector const & x) {
-            return std::move(Vector(x.types,x.sizes));
+            return std::move(Vector(x.types,x.sizes,x.storage));
         }
         
         // y <- x (Shallow.  No memory allocation.)
         static void copy(Vector const & x, Vector & y) {
             Optizelle::copy <Real> (x.data.size(),&(x.data.front()),1,
                 &(y.data.front()),1);
+            for(Natural blk=1;blk<=x.numBlocks();blk++) {
+                if(!x.widened[itok(blk)]) continue;
+                Natural const m=x.blkSize(blk);
+                y.allocWide();
+                Optizelle::copy <Real> (m*m,&(x.wideFront(blk)),1,
+                    &(y.wideFront(blk)),1);
+            }
+            y.widened=x.widened;
+        }
+
+        // Memory allocation and size setting in the precision Real2
+        template <typename Real2>
+        static typename SQL <Real2>::Vector init_prec(Vector const & x) {
+            return std::move(typename SQL <Real2>::Vector(
+                x.types,x.sizes,x.storage));
+        }
+
+        // y <- x where y is stored in the precision Real2
+        template <typename Real2>
+        static void copy_prec(
+            Vector const & x,
+            typename SQL <Real2>::Vector & y
+        ) {
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural i=0;i<x.data.size();i++) 
+                y.data[i]=Real2(x.data[i]);
+            for(Natural blk=1;blk<=x.numBlocks();blk++) {
+                if(!x.widened[itok(blk)]) continue;
+                Natural const m=x.blkSize(blk);
+                y.allocWide();
+                for(Natural i=0;i<m*m;i++)
+                    (&(y.wideFront(blk)))[i]=Real2((&(x.wideFront(blk)))[i]);
+            }
+            y.widened=x.widened;
         }
 
         // x <- alpha * x
         static void scal(Real const & alpha, Vector & x) {
             Optizelle::scal <Real> (x.data.size(),alpha,&(x.data.front()),1);
+            for(Natural blk=1;blk<=x.numBlocks();blk++)
+                if(x.widened[itok(blk)])
+                    Optizelle::scal <Real> (x.blkSize(blk)*x.blkSize(blk),
+                        alpha,&(x.wideFront(blk)),1);
         }
 
         // y <- alpha * x + y
         static void axpy(Real const & alpha, Vector const & x, Vector & y) {
-            Optizelle::axpy <Real> (x.data.size(),alpha,&(x.data.front()),1,
-                &(y.data.front()),1);
+            if(!x.isWide() && !y.isWide()) {
+                Optizelle::axpy <Real> (x.data.size(),alpha,
+                    &(x.data.front()),1,&(y.data.front()),1);
+                return;
+            }
+
+            // When either block lives in its full-storage temporary, we
+            // accumulate the result in the temporary of y
+            std::vector <Real> X;
+            for(Natural blk=1;blk<=x.numBlocks();blk++) {
+                Natural const n=x.offsets[blk]-x.offsets[itok(blk)];
+                if(!x.widened[itok(blk)] && !y.widened[itok(blk)]) {
+                    Optizelle::axpy <Real> (n,alpha,&(x.front(blk)),1,
+                        &(y.front(blk)),1);
+                    continue;
+                }
+                Natural const m=x.blkSize(blk);
+                widen(y,blk);
+                Real const * X_k=&(x.wideFront(blk));
+                if(!x.widened[itok(blk)]) {
+                    X.resize(m*m);
+                    unpack(m,&(x.front(blk)),&(X.front()));
+                    X_k=&(X.front());
+                }
+                Optizelle::axpy <Real> (m*m,alpha,X_k,1,&(y.wideFront(blk)),1);
+            }
         }
 
         // innr <- <x,y>
         static Real innr(Vector const & x,Vector const & y) {
-            return Optizelle::dot<Real> (x.data.size(),&(x.data.front()),1,
-                &(y.data.front()),1);
+            bool const wide = x.isWide() || y.isWide();
+            Real z = wide ? Real(0.) : Optizelle::dot<Real> (x.data.size(),
+                &(x.data.front()),1,&(y.data.front()),1);
+
+            // Packed semidefinite blocks only hold the upper triangle, so we
+            // count the off-diagonal elements a second time.  When either
+            // block lives in its full-storage temporary, we expand both.
+            if(x.storage==SDPStorage::Full) return z;
+            std::vector <Real> X;
+            std::vector <Real> Y;
+            for(Natural blk=1;blk<=x.numBlocks();blk++) {
+                Natural m=x.blkSize(blk);
+                if(x.widened[itok(blk)] || y.widened[itok(blk)]) {
+                    X.resize(m*m);
+                    Y.resize(m*m);
+                    expand(x,blk,&(X.front()));
+                    expand(y,blk,&(Y.front()));
+                    z+=Optizelle::dot<Real> (m*m,&(X.front()),1,
+                        &(Y.front()),1);
+                    continue;
+                }
+                if(wide)
+                    z+=Optizelle::dot<Real> (
+                        x.offsets[blk]-x.offsets[itok(blk)],
+                        &(x.front(blk)),1,&(y.front(blk)),1);
+                if(x.blkType(blk)!=Cone::Semidefinite) continue;
+                z+=Optizelle::dot<Real> (x.sdpLength(m),&(x.front(blk)),1,
+                    &(y.front(blk)),1);
+                for(Natural i=1;i<=m;i++)
+                    z-=x(blk,i,i)*y(blk,i,i);
+            }
+            return z;
         }
 
         // x <- 0 
@@ -545,6 +948,7 @@ namespace Optizelle {
             #endif
             for(Natural i=0;i<x.data.size();i++) 
                 x.data[i]=Real(0.);
+            std::fill(x.widened.begin(),x.widened.end(),false);
         }
 
         // x <- random
@@ -557,10 +961,16 @@ namespace Optizelle {
             // works properly when parallel.
             for(Natural i=0;i<x.data.size();i++) 
                 x.data[i]=Real(dis(gen));
+            std::fill(x.widened.begin(),x.widened.end(),false);
         }
 
         // Jordan product, z <- x o y
         static void prod(Vector const & x, Vector const & y, Vector & z) {
+            // Full copies of packed semidefinite blocks
+            std::vector <Real> X;
+            std::vector <Real> Y;
+            bool const packed = x.storage==SDPStorage::Packed;
+
             /* It's hard to tell apriori how to parallelize this
                computuation.  Sometimes, it helps to parallelize across
                the cones, but if the cones are large and few, it helps
@@ -591,41 +1001,39 @@ namespace Optizelle {
                         z(blk,i)=x(blk,i)*y(blk,i);
                     break;
 
-                // z = [x'y ; x0 ybar + y0 xbar].
-                case Cone::Quadratic: {
-                    // Get the size of the bar section.
-                    Natural mbar=m-1;
-
-                    // Find the first element
-                    z.naught(blk)=
-                        Optizelle::dot<Real>(
-                            m,&(x.front(blk)),1,&(y.front(blk)),1);
-
-                    // zbar = ybar
-                    Optizelle::copy <Real> (
-                        mbar,&(y.bar(blk)),1,&(z.bar(blk)),1);
-                        
-                    // zbar = x0 ybar
-                    Optizelle::scal <Real> (mbar,x.naught(blk),&(z.bar(blk)),1);
-
-                    // zbar = x0 ybar + y0 xbar
-                    Optizelle::axpy <Real> (mbar,y.naught(blk),&(x.bar(blk)),1,
-                        &(z.bar(blk)),1);
+                // We handle all of the second-order cones together below
+                case Cone::Quadratic:
                     break;
-                }
 
-                // z = xy 
+                // z = xy where we only look at the upper triangle of x.  When
+                // packed, xy goes to the full-storage temporary of z.  Since
+                // z may alias x or y, we expand both first.
                 case Cone::Semidefinite:
-                    Optizelle::symm <Real> ('L','U',m,m,Real(1.),
-                        &(x.front(blk)),m,&(y.front(blk)),m,Real(0.),
-                        &(z.front(blk)),m);
+                    if(packed) {
+                        X.resize(m*m);
+                        Y.resize(m*m);
+                        expand(x,blk,&(X.front()));
+                        expand(y,blk,&(Y.front()));
+                        z.allocWide();
+                        Optizelle::symm <Real> ('L','U',m,m,Real(1.),
+                            &(X.front()),m,&(Y.front()),m,Real(0.),
+                            &(z.wideFront(blk)),m);
+                        z.widened[itok(blk)]=true;
+                    } else
+                        Optizelle::symm <Real> ('L','U',m,m,Real(1.),
+                            &(x.front(blk)),m,&(y.front(blk)),m,Real(0.),
+                            &(z.front(blk)),m);
                     break;
                 }
             }
+
+            // z = [x'y ; x0 ybar + y0 xbar] on all of the second-order cones
+            prod_quadratic(x,y,z);
         }
 
         // Identity element, x <- e such that x o e = x
         static void id(Vector & x) {
+            std::fill(x.widened.begin(),x.widened.end(),false);
 
             // Loop over all the blocks
             for(Natural blk=1;blk<=x.numBlocks();blk++) {
@@ -660,9 +1068,8 @@ namespace Optizelle {
                     #ifdef _OPENMP
                     #pragma omp parallel for schedule(static)
                     #endif
-                    for(Natural j=1;j<=m;j++) 
-                        for(Natural i=1;i<=m;i++) 
-                            x(blk,i,j)=Real(0.);
+                    for(Natural i=0;i<x.sdpLength(m);i++) 
+                        x.data[x.offsets[itok(blk)]+i]=Real(0.);
 
                     #ifdef _OPENMP
                     #pragma omp parallel for schedule(static)
@@ -691,11 +1098,203 @@ namespace Optizelle {
             // y <- 1/x0 y + <xbar,y> / (x0 ( x0^2 - <xbar,xbar> )) xbar
             Optizelle::axpy <Real> (m,innr_xbar_y/denom,&(x[1]),1,&(y[0]),1);
         }
-        
+
+        // The routines below apply the Jordan algebra operations to all of
+        // the second-order cone blocks at once.  Typically, these cones are
+        // small, so we parallelize across the cones rather than within them
+        // and work directly on the data in order to avoid the overhead of
+        // allocating memory and calling BLAS on every block.  Since we
+        // only touch a single element of each vector at a time, it is safe
+        // for z to alias x or y.
+
+        // Jordan product, z <- [x'y ; x0 ybar + y0 xbar], on every
+        // second-order cone
+        static void prod_quadratic(
+            Vector const & x,
+            Vector const & y,
+            Vector & z
+        ) {
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural k=0;k<x.quadratic_blocks.size();k++) {
+                // Get the block, its size, and its data
+                Natural const blk=x.quadratic_blocks[k];
+                Natural const m=x.sizes[itok(blk)];
+                Real const * const xx=&(x.data[x.offsets[itok(blk)]]);
+                Real const * const yy=&(y.data[y.offsets[itok(blk)]]);
+                Real * const zz=&(z.data[z.offsets[itok(blk)]]);
+
+                // x0, y0, and <x,y>
+                Real const x0=xx[0];
+                Real const y0=yy[0];
+                Real innr_x_y(0.);
+                for(Natural i=0;i<m;i++)
+                    innr_x_y+=xx[i]*yy[i];
+
+                // zbar <- x0 ybar + y0 xbar
+                for(Natural i=1;i<m;i++)
+                    zz[i]=x0*yy[i]+y0*xx[i];
+
+                // z0 <- <x,y>
+                zz[0]=innr_x_y;
+            }
+        }
+
+        // Jordan product inverse, z <- inv(Arw(x)) y, on every second-order
+        // cone.  In closed form, we have that
+        //
+        // z0 = (x0 y0 - <xbar,ybar>) / det(x)
+        // zbar = (1/x0) ybar + ((<xbar,ybar>/x0 - y0) / det(x)) xbar
+        //
+        // where det(x) = x0^2 - <xbar,xbar>.
+        static void linv_quadratic(
+            Vector const & x,
+            Vector const & y,
+            Vector & z
+        ) {
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural k=0;k<x.quadratic_blocks.size();k++) {
+                // Get the block, its size, and its data
+                Natural const blk=x.quadratic_blocks[k];
+                Natural const m=x.sizes[itok(blk)];
+                Real const * const xx=&(x.data[x.offsets[itok(blk)]]);
+                Real const * const yy=&(y.data[y.offsets[itok(blk)]]);
+                Real * const zz=&(z.data[z.offsets[itok(blk)]]);
+
+                // x0, y0, <xbar,xbar>, and <xbar,ybar>
+                Real const x0=xx[0];
+                Real const y0=yy[0];
+                Real innr_xbar_xbar(0.);
+                Real innr_xbar_ybar(0.);
+                for(Natural i=1;i<m;i++) {
+                    innr_xbar_xbar+=xx[i]*xx[i];
+                    innr_xbar_ybar+=xx[i]*yy[i];
+                }
+                Real const det=x0*x0-innr_xbar_xbar;
+
+                // zbar <- (1/x0) ybar + ((<xbar,ybar>/x0 - y0) / det) xbar
+                Real const alpha=(innr_xbar_ybar/x0-y0)/det;
+                for(Natural i=1;i<m;i++)
+                    zz[i]=yy[i]/x0+alpha*xx[i];
+
+                // z0 <- (x0 y0 - <xbar,ybar>) / det
+                zz[0]=(x0*y0-innr_xbar_ybar)/det;
+            }
+        }
+
+        // Barrier function, sum_i 0.5 * log(x0^2-<xbar,xbar>), on every
+        // second-order cone
+        static Real barr_quadratic(Vector const & x) {
+            Real z(0.);
+            #ifdef _OPENMP
+            #pragma omp parallel for reduction(+:z) schedule(static)
+            #endif
+            for(Natural k=0;k<x.quadratic_blocks.size();k++) {
+                // Get the block, its size, and its data
+                Natural const blk=x.quadratic_blocks[k];
+                Natural const m=x.sizes[itok(blk)];
+                Real const * const xx=&(x.data[x.offsets[itok(blk)]]);
+
+                // z += 0.5 * log(x0^2-<xbar,xbar>)
+                Real innr_xbar_xbar(0.);
+                for(Natural i=1;i<m;i++)
+                    innr_xbar_xbar+=xx[i]*xx[i];
+                z+=Real(0.5) * log(xx[0]*xx[0]-innr_xbar_xbar);
+            }
+            return z;
+        }
+
+        // Line search, argmax {alpha >= 0 : alpha x + y >= 0}, on every
+        // second-order cone.  On each cone, we choose the smallest positive
+        // number between -y0/x0 and the roots of alpha^2 a + alpha b + c
+        //
+        // where
+        //
+        // a = x0^2 - ||xbar||^2
+        // b = 2x0y0 - 2 <xbar,ybar>
+        // c = y0^2 - ||ybar||^2
+        //
+        // Technically, if a is zero, the quadratic formula doesn't
+        // apply and we use -c/b instead of the roots.  If b is zero
+        // and a is zero, then there's no limit to the line search.
+        static Real srch_quadratic(Vector const & x,Vector const & y) {
+            // Line search parameter
+            Real alpha=std::numeric_limits <Real>::infinity();
+
+            #ifdef _OPENMP
+            #pragma omp parallel
+            #endif
+            {
+                // Create a local version of alpha
+                Real alpha_loc=std::numeric_limits <Real>::infinity();
+
+                #ifdef _OPENMP
+                #pragma omp for schedule(static)
+                #endif
+                for(Natural k=0;k<x.quadratic_blocks.size();k++) {
+                    // Get the block, its size, and its data
+                    Natural const blk=x.quadratic_blocks[k];
+                    Natural const m=x.sizes[itok(blk)];
+                    Real const * const xx=&(x.data[x.offsets[itok(blk)]]);
+                    Real const * const yy=&(y.data[y.offsets[itok(blk)]]);
+
+                    // Insure that the leading coefficient of the cone remains
+                    // nonnegative.
+                    if(xx[0] < Real(0.)) {
+                        Real const alpha0 = -yy[0]/xx[0];
+                        alpha_loc = alpha0<alpha_loc ? alpha0 : alpha_loc;
+                    }
+
+                    // Next, figure out how far we can step before we violate
+                    // the rest of the cone.
+                    Real innr_xbar_xbar(0.);
+                    Real innr_xbar_ybar(0.);
+                    Real innr_ybar_ybar(0.);
+                    for(Natural i=1;i<m;i++) {
+                        innr_xbar_xbar+=xx[i]*xx[i];
+                        innr_xbar_ybar+=xx[i]*yy[i];
+                        innr_ybar_ybar+=yy[i]*yy[i];
+                    }
+                    Real const a = xx[0]*xx[0] - innr_xbar_xbar;
+                    Real const b = Real(2.)*(xx[0]*yy[0] - innr_xbar_ybar);
+                    Real const c = yy[0]*yy[0] - innr_ybar_ybar;
+                    Natural nroots(0);
+                    Real alpha1(-1.);
+                    Real alpha2(-1.);
+                    quad_equation(a,b,c,nroots,alpha1,alpha2);
+
+                    // If we have roots, determine the restriction.  If we have
+                    // no roots, there's no additional restriction.  This can't
+                    // happen since we assume that y is strictly feasible.
+                    if(nroots>=1)
+                        alpha_loc = alpha1>=Real(0.) && alpha1<alpha_loc ?
+                            alpha1 : alpha_loc;
+                    if(nroots==2)
+                        alpha_loc = alpha2>=Real(0.) && alpha2<alpha_loc ?
+                            alpha2 : alpha_loc;
+                }
+
+                // After we're through with the local search, accumulate the
+                // result
+                #ifdef _OPENMP
+                #pragma omp critical
+                #endif
+                {
+                    alpha = alpha_loc < alpha ? alpha_loc : alpha;
+                }
+            }
+            return alpha;
+        }
+
         // Jordan product inverse, z <- inv(L(x)) y where L(x) y = x o y
         static void linv(Vector const & x,Vector const & y,Vector & z) {
-            // We have this vector in case we have a SDP block
+            // We have these vectors in case we have a SDP block
             std::vector <Real> Xinv;
+            std::vector <Real> Y;
+            bool const packed = x.storage==SDPStorage::Packed;
 
             // Loop over all the blocks
             for(Natural blk=1;blk<=x.numBlocks();blk++) {
@@ -715,50 +1314,29 @@ namespace Optizelle {
                         z(blk,i)=y(blk,i)/x(blk,i);
                     break;
 
-                // z = inv(Arw(x)) y
-                case Cone::Quadratic: {
-                    // Get the size of the bar piece
-                    Natural mbar=m-1;
-
-                    // invSchur_ybar <- invSchur(x)(y_bar) 
-                    std::vector <Real> invSchur_ybar(mbar);
-                    Optizelle::copy <Real>(mbar,&(y.bar(blk)),1,
-                        &(invSchur_ybar.front()),1);
-                    invSchur(mbar,&(x.front(blk)),&(invSchur_ybar[0]));
-
-                    // a <- 1 / (x0 - (1/x0) <x_bar,x_bar>) * y0
-                    Real a = y.naught(blk) / (
-                        x.naught(blk) - (Real(1.)/x.naught(blk)) *
-                        Optizelle::dot<Real>(
-                            mbar,&(x.bar(blk)),1,&(x.bar(blk)),1));
-
-                    // b <- - (1/x0) <xbar,invSchur(x)(y_bar)>
-                    Real b = -Optizelle::dot <Real> (mbar,
-                            &(x.bar(blk)),1,&(invSchur_ybar.front()),1)
-                        / x.naught(blk);
-                    
-                    // z0 <- 1 / (x0 - (1/x0) <x_bar,x_bar>) y0
-                    //       - (1/x0) <x_bar,invSchur(x)(y_bar)> 
-                    z(blk,1) = a + b;
-                    
-                    // z_bar <- invSchur(x)(x_bar)
-                    Optizelle::copy <Real> (
-                        mbar,&(x.bar(blk)),1,&(z.bar(blk)),1);
-                    invSchur(mbar,&(x.front(blk)),&(z.bar(blk)));
-
-                    // zbar <- (-y0/x0) invSchur(x)(x_bar)
-                    Optizelle::scal <Real> (mbar,
-                        -y.naught(blk)/x.naught(blk),&(z.bar(blk)),1);
-
-                    // z_bar <- (-y0/x0) invSchur(x)(x_bar) + invSchur(x)(y_bar)
-                    Optizelle::axpy <Real> (mbar,Real(1.),
-                        &(invSchur_ybar.front()),1,&(z.bar(blk)),1);
+                // We handle all of the second-order cones together below
+                case Cone::Quadratic:
                     break;
 
-                // Z=inv(X) Y
-                } case Cone::Semidefinite: {
-                    // Get the Schur complement of the block.  With any luck
-                    // these are cached.
+                // Z=inv(X) Y.  When packed, we solve with the Choleski factor
+                // of X in RFP format and keep the symmetric part of the
+                // result.  The algorithms only use the symmetric part of
+                // inv(X) Y, either through symm or through h'(x)*, so this
+                // follows the same path as full storage.
+                case Cone::Semidefinite:
+                    if(packed) {
+                        Real const * const U = get_factor(x,blk,Xinv);
+                        Y.resize(m*m);
+                        expand(y,blk,&(Y.front()));
+                        Integer info(0);
+                        Optizelle::pftrs <Real> ('N','U',m,m,U,&(Y.front()),m,
+                            info);
+                        fold(&(Y.front()),blk,z);
+                        break;
+                    }
+
+                    // Get the inverse of the block.  With any luck, this is
+                    // cached.
                     Optizelle::SQL <Real>::get_inverse(x,blk,Xinv);
 
                     // Multiply out the result
@@ -766,8 +1344,11 @@ namespace Optizelle {
                         &(Xinv.front()),m,&(y.front(blk)),m,Real(0.),
                         &(z.front(blk)),m);
                     break;
-                }}
+                }
             }
+
+            // z = inv(Arw(x)) y on all of the second-order cones
+            linv_quadratic(x,y,z);
         }
 
         // Barrier function, barr <- barr(x) where x o grad barr(x) = e
@@ -784,6 +1365,7 @@ namespace Optizelle {
                 // In case we need to take a Choleski factorization for the
                 // SDP blocks
                 std::vector <Real> U;
+                std::vector <Real> Xrf;
 
                 // Depending on the block, compute a different barrier
                 switch(x.blkType(blk)) {
@@ -797,15 +1379,9 @@ namespace Optizelle {
                         z+=log(x(blk,i));
                     break;
 
-                // z += 0.5 * log(x0^2-<xbar,xbar>)
-                case Cone::Quadratic: {
-                    // Get the size of the bar part.
-                    Natural mbar=m-1;
-
-                    z+=Real(0.5) * log(x.naught(blk)*x.naught(blk)
-                        -dot <Real> (mbar,&(x.bar(blk)),1,&(x.bar(blk)),1));
+                // We handle all of the second-order cones together below
+                case Cone::Quadratic:
                     break;
-                }
 
                 // z += log(det(x)).  We compute this by noting that
                 // log(det(x)) = log(det(u'u)) = log(det(u')det(u))
@@ -813,19 +1389,26 @@ namespace Optizelle {
                 case Cone::Semidefinite: {
 
                     // Find the Choleski factorization of X
-                    U.resize(m*m);
+                    OPTIZELLE_TRACE(trace,"barrier","sql")
+                    U.resize(x.sdpLength(m));
                     Integer info;
-                    Optizelle::copy <Real> (
-                        m*m,&(x.front(blk)),1,&(U.front()),1);
-                    Optizelle::potrf <Real> (
-                        'U',m,&(U.front()),m,info);
+                    if(x.storage==SDPStorage::Packed) {
+                        Optizelle::copy <Real> (x.sdpLength(m),
+                            rfp(x,blk,Xrf),1,&(U.front()),1);
+                        Optizelle::pftrf <Real> ('N','U',m,&(U.front()),info);
+                    } else {
+                        Optizelle::copy <Real> (
+                            x.sdpLength(m),&(x.front(blk)),1,&(U.front()),1);
+                        Optizelle::potrf <Real> (
+                            'U',m,&(U.front()),m,info);
+                    }
 
                     Real log_det(0.);
                     #ifdef _OPENMP
                     #pragma omp parallel for reduction(+:log_det) schedule(static)
                     #endif
                     for(Natural i=1;i<=m;i++)
-                        log_det += log(U[Optizelle::ijtok(i,i,m)]);
+                        log_det += log(U[x.sdpIndex(i,i,m)]);
                     
                     // Complete the barrier computation by taking the log
                     z+= Real(2.) * log_det;
@@ -833,6 +1416,10 @@ namespace Optizelle {
                 } }
             }
 
+            // z += 0.5 * log(x0^2-<xbar,xbar>) on all of the second-order
+            // cones
+            z+=barr_quadratic(x);
+
             // Return the accumulated barrier value
             return z;
         }
@@ -845,6 +1432,7 @@ namespace Optizelle {
                    
             // Variables required for the linesearch on SDP blocks 
             Integer info(0);
+            std::vector <Real> X;
             std::vector <Real> Xrf;
             std::vector <Real> Yrf;
             std::vector <Real> Zrf;
@@ -893,65 +1481,9 @@ namespace Optizelle {
 
                     break;
 
-                // We choose the smallest positive number between:
-                // -y0/x0, and the roots of alpha^2 a + alpha b + c
-                //
-                // where
-                //
-                // a = x0^2 - ||xbar||^2
-                // b = 2x0y0 - 2 <xbar,ybar>
-                // c = y0^2 - ||ybar||^2 
-                // 
-                // Technically, if a is zero, the quadratic formula doesn't
-                // apply and we use -c/b instead of the roots.  If b is zero
-                // and a is zero, then there's no limit to the line search
-                case Cone::Quadratic: {
-
-                    // Get the size of the bar block.
-                    Natural mbar=m-1;
-
-                    // Now, first we have to insure that the leading coefficient
-                    // of the second order cone problem remains nonnegative.
-                    // This number tells us how far we can step before this
-                    // is not true.
-                    Real alpha0 = -y.naught(blk)/x.naught(blk);
-
-                    // Next, assuming that the leading coefficient is fine,
-                    // figure out how far we can step before we violate the
-                    // rest of the SOCP constraint.  This involves solving
-                    // the quadratic equation from above.
-                    Real a = x.naught(blk)*x.naught(blk)
-                        - dot <Real> (mbar,&(x.bar(blk)),1,&(x.bar(blk)),1);
-                    Real b = Real(2.)*(x.naught(blk)*y.naught(blk)
-                        - dot <Real> (mbar,&(x.bar(blk)),1,&(y.bar(blk)),1));
-                    Real c = y.naught(blk)*y.naught(blk)
-                        - dot <Real> (mbar,&(y.bar(blk)),1,&(y.bar(blk)),1);
-                    Natural nroots(0);
-                    Real alpha1(-1.);
-                    Real alpha2(-1.);
-                    quad_equation(a,b,c,nroots,alpha1,alpha2);
-
-                    // Now, determine the step length.
-
-                    // If we have a restriction on alpha based on the leading
-                    // coefficient.
-                    alpha = x.naught(blk) < Real(0.) && alpha0<alpha ?
-                        alpha0 : alpha;
-
-                    // Next, if we have two roots, determine the restriction 
-                    if(nroots==2) { 
-                        alpha = alpha1>=Real(0.)&&alpha1<alpha ? alpha1 : alpha;
-                        alpha = alpha2>=Real(0.)&&alpha2<alpha ? alpha2 : alpha;
-
-                    // If we have a single root 
-                    } else if(nroots==1)
-                        alpha = alpha1>=Real(0.)&&alpha1<alpha ? alpha1 : alpha;
-
-                    // If we no roots, there's no additional restriction.
-                    // This can't happen since we assume that y is strictly
-                    // feasible.
-                }
-                break;
+                // We handle all of the second-order cones together below
+                case Cone::Quadratic:
+                    break;
 
                 // We need to find the solution of the generalized eigenvalue
                 // problem alpha X v + Y v = 0.  Since Y is positive definite,
@@ -966,19 +1498,15 @@ namespace Optizelle {
                 // in lambda, we can just back off of it by a small amount.
                 case Cone::Semidefinite: {
 
-                    // Convert X and Y to rectangular packed storage
-                    Xrf.resize(m*(m+1)/2);
-                    Optizelle::trttf <Real>('N','U',m,&(x(blk,1,1)),m,&(Xrf[0]),
-                        info);
-
-                    Yrf.resize(m*(m+1)/2);
-                    Optizelle::trttf <Real>('N','U',m,&(y(blk,1,1)),m,&(Yrf[0]),
-                        info);
+                    // Convert the upper triangles of X and Y to rectangular
+                    // packed storage unless they're there already
+                    Real const * xrf = rfp(x,blk,Xrf);
+                    Real const * yrf = rfp(y,blk,Yrf);
 
                     // Solve the generalized eigenvalue problem X v = lambda Y v
                     Real abs_tol=1e-2;
                     std::pair <Real,Real> lambda_err=Optizelle::gsyiram <Real> (
-                        m,&(Xrf[0]),&(Yrf[0]),20,20,abs_tol);
+                        m,xrf,yrf,20,20,abs_tol);
 
                     // IRAM converges from the right, but we really need a lower
                     // bound on the eigenvalue.  Hence, modify the result
@@ -1015,9 +1543,9 @@ namespace Optizelle {
                         // Basically, we find X+alpha0 Y and try to take
                         // the Choleski factorization.  If that fails, we're
                         // infeasible and we do a backtracking line search.
-                        Optizelle::copy <Real> (
-                            m*(m+1)/2,&(Yrf[0]),1,&(Zrf[0]),1);
-                        Optizelle::axpy <Real> (m*(m+1)/2,alpha0,&(Xrf[0]),1,
+                        OPTIZELLE_TRACE(trace,"srch","sql")
+                        Optizelle::copy <Real> (m*(m+1)/2,yrf,1,&(Zrf[0]),1);
+                        Optizelle::axpy <Real> (m*(m+1)/2,alpha0,xrf,1,
                             &(Zrf[0]),1);
                         pftrf('N','U',m,&(Zrf[0]),info);
 
@@ -1040,14 +1568,23 @@ namespace Optizelle {
                     alpha = alpha0<alpha ? alpha0 : alpha;
                 } }
             }
+
+            // Find the line search parameter on all of the second-order cones
+            Real alpha_quad = srch_quadratic(x,y);
+            alpha = alpha_quad<alpha ? alpha_quad : alpha;
             return alpha;
         }
         // Symmetrization, x <- symm(x) such that L(symm(x)) is a symmetric
         // operator.
         static void symm(Vector & x) { 
-            // Allocate vectors to help with the SDP blocks
-            std::vector <Real> I;
-            std::vector <Real> Xk;
+            // Packed semidefinite blocks are symmetric already.  We only
+            // fold the blocks that live in their full-storage temporaries.
+            if(x.storage==SDPStorage::Packed) {
+                for(Natural blk=1;blk<=x.numBlocks();blk++)
+                    if(x.widened[itok(blk)])
+                        fold(&(x.wideFront(blk)),blk,x);
+                return;
+            }
 
             // Loop over all the blocks
             for(Natural blk=1;blk<=x.numBlocks();blk++) {
@@ -1065,34 +1602,15 @@ namespace Optizelle {
 
                 // Find the symmetric part of X, (X+X')/2
                 case Cone::Semidefinite: {
-                    // Create the identity matrix
-                    I.resize(m*m);
-                    #ifdef _OPENMP
-                    #pragma omp parallel for schedule(static)
-                    #endif
-                    for(Natural i=1;i<=m;i++) 
-                        for(Natural j=1;j<=m;j++) 
-                            I[ijtok(i,j,m)]=Real(0.);
-
                     #ifdef _OPENMP
-                    #pragma omp parallel for schedule(static)
+                    #pragma omp parallel for schedule(dynamic)
                     #endif
-                    for(Natural i=1;i<=m;i++) 
-                        I[ijtok(i,i,m)]=Real(1.);
-
-                    // Create a copy of X
-                    std::vector <Real> Xk(m*m);
-                    Optizelle::copy<Real> (
-                        m*m,&(x.front(blk)),1,&(Xk.front()),1);
-
-                    // X <- (X+X')/2
-                    syr2k <Real> ('U','N',m,m,Real(0.5),&(Xk.front()),m,
-                        &(I.front()),m,Real(0.),&(x.front(blk)),m);
-
-                    // Copy the upper part of X to the lower
-                    for(Natural i=1;i<=m;i++)
-                        Optizelle::copy <Real> (
-                            m-i,&(x(blk,i,i+1)),m,&(x(blk,i+1,i)),1);
+                    for(Natural j=1;j<=m;j++) 
+                        for(Natural i=1;i<j;i++) {
+                            Real x_ij = Real(0.5)*(x(blk,i,j)+x(blk,j,i));
+                            x(blk,i,j)=x_ij;
+                            x(blk,j,i)=x_ij;
+                        }
                     break;
                 } }
             }
@@ -1101,6 +1619,449 @@ namespace Optizelle {
     };
     //---SQL3---
 
+    // A sparse element of SQL stored in triplet format.  Each nonzero lives
+    // in the cone blks[k] at the position is[k] or, for semidefinite cones, at
+    // the position (is[k],js[k]).  Since the semidefinite blocks are
+    // symmetric, an off-diagonal entry denotes both (i,j) and (j,i).  For
+    // linear and quadratic cones, the column indices are ignored.  All
+    // indices start from 1.
+    template <typename Real>
+    struct SparseSQL {
+        std::vector <Natural> blks;
+        std::vector <Natural> is;
+        std::vector <Natural> js;
+        std::vector <Real> data;
+
+        // y <- alpha * A + y
+        static void axpy(
+            Real const & alpha,
+            SparseSQL const & A,
+            typename SQL <Real>::Vector & y
+        ) {
+            for(Natural k=0;k<A.data.size();k++) {
+                Natural const & blk=A.blks[k];
+                // Packed blocks only hold one of each pair of off-diagonal
+                // elements unless they live in their full-storage temporary
+                if(y.blkType(blk)==Cone::Semidefinite) {
+                    y(blk,A.is[k],A.js[k]) += alpha*A.data[k];
+                    if(A.is[k]!=A.js[k] && (y.storage==SDPStorage::Full
+                        || y.widened[itok(blk)])
+                    )
+                        y(blk,A.js[k],A.is[k]) += alpha*A.data[k];
+                } else
+                    y(blk,A.is[k]) += alpha*A.data[k];
+            }
+        }
+
+        // innr <- <A,y>
+        static Real innr(
+            SparseSQL const & A,
+            typename SQL <Real>::Vector const & y
+        ) {
+            Real z(0.);
+            for(Natural k=0;k<A.data.size();k++) {
+                Natural const & blk=A.blks[k];
+                if(y.blkType(blk)==Cone::Semidefinite) {
+                    z += A.data[k]*y(blk,A.is[k],A.js[k]);
+                    if(A.is[k]!=A.js[k])
+                        z += A.data[k]*y(blk,A.js[k],A.is[k]);
+                } else
+                    z += A.data[k]*y(blk,A.is[k]);
+            }
+            return z;
+        }
+    };
+
+    // A linear inequality constraint h : Rm -> SQL of the form
+    //
+    // h(x) = A1 x1 + ... + Am xm - A0
+    //
+    // where each Ai is sparse.  This is the structure of linear SDP, SOCP,
+    // and LP problems.  Declaring the constraint in this form allows the use
+    // of the SchurComplement operator below.
+    template <typename Real>
+    struct LinearSQLFunction : public VectorValuedFunction <Real,Rm,SQL> {
+        // Create some type shortcuts
+        typedef Rm <Real> X;
+        typedef typename X::Vector X_Vector;
+        typedef SQL <Real> Z;
+        typedef typename Z::Vector Z_Vector;
+
+        // The constant A0 followed by the coefficients A1, ..., Am
+        std::vector <SparseSQL <Real> > const A;
+
+        // Grab the sparse matrices
+        LinearSQLFunction(std::vector <SparseSQL <Real> > const & A_) : A(A_) {}
+
+        // z=h(x)
+        void eval(X_Vector const & x,Z_Vector & z) const {
+            Z::zero(z);
+            SparseSQL <Real>::axpy(Real(-1.),A[0],z);
+            for(Natural i=1;i<A.size();i++)
+                SparseSQL <Real>::axpy(x[itok(i)],A[i],z);
+        }
+
+        // z=h'(x)dx
+        void p(X_Vector const & x,X_Vector const & dx,Z_Vector & z) const {
+            Z::zero(z);
+            for(Natural i=1;i<A.size();i++)
+                SparseSQL <Real>::axpy(dx[itok(i)],A[i],z);
+        }
+
+        // xhat=h'(x)*dz
+        void ps(X_Vector const & x,Z_Vector const & dz,X_Vector & xhat) const {
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural i=1;i<A.size();i++)
+                xhat[itok(i)]=SparseSQL <Real>::innr(A[i],dz);
+        }
+
+        // xhat=(h''(x)dx)*dz
+        void pps(
+            X_Vector const & x,
+            X_Vector const & dx,
+            Z_Vector const & dz,
+            X_Vector & xhat
+        ) const {
+            X::zero(xhat);
+        }
+    };
+
+    // The inverse of the Schur complement (normal equations) of the
+    // interior point Newton system for a linear constraint h.  Specifically,
+    // we form the m x m matrix
+    //
+    // M_ij = <A_i, inv(L(h(x))) (A_j o z)>,
+    //
+    // which is the matrix of h'(x)* inv(L(h(x))) L(z) h'(x), symmetrize it,
+    // and take its Choleski factorization.  This is exactly the piece that
+    // InequalityConstrained adds to the Hessian.  When the objective is also
+    // linear, this is the inverse of the whole Hessian and a Krylov method
+    // preconditioned with this operator converges in a single iteration.
+    // Hence, setting PH_type to UserDefined and PH to this operator turns the
+    // Newton solve into a direct solve.  Otherwise, it still serves as a
+    // preconditioner.  The matrix is rebuilt whenever z or h(x) change.
+    //
+    // We exploit the sparsity of the Ai when forming M.  For each column j,
+    // we only compute inv(L(h(x))) (A_j o z) on the cones that A_j touches
+    // and, for semidefinite cones with few nonzeros relative to their size,
+    // we form inv(H) A_j Z as a sum of rank-1 updates rather than with dense
+    // matrix products.  The columns are computed in parallel.
+    template <typename Real>
+    struct SchurComplement : public Operator <Real,Rm,Rm> {
+    private:
+        // Create some type shortcuts
+        typedef Rm <Real> X;
+        typedef typename X::Vector X_Vector;
+        typedef SQL <Real> Z;
+        typedef typename Z::Vector Z_Vector;
+
+        // Linear inequality constraint
+        LinearSQLFunction <Real> const & h;
+
+        // Inequality multiplier
+        Z_Vector const & z;
+
+        // Inequality constraint evaluated at x
+        Z_Vector const & h_x;
+
+        // Variables used for caching.  The boolean values denote whether or
+        // not we've started caching yet.
+        mutable std::pair <bool,Z_Vector> z_last;
+        mutable std::pair <bool,Z_Vector> h_x_last;
+
+        // Copies of z and h(x) with full semidefinite blocks.  We only need
+        // these when z and h(x) are packed and we only expand them again when
+        // they change.
+        mutable std::unique_ptr <Z_Vector> z_full;
+        mutable std::unique_ptr <Z_Vector> h_x_full;
+
+        // Schur complement and then its Choleski factorization
+        mutable std::vector <Real> M;
+
+        // Whether or not we formed the Schur complement and its Choleski
+        // factorization.  This fails when h(x) or M isn't positive definite.
+        mutable bool factored;
+
+        // Gets a version of x with full semidefinite blocks.  When x is
+        // packed, we keep its expansion in x_full and only redo it when x
+        // changed.
+        static Z_Vector const & full(
+            Z_Vector const & x,
+            std::unique_ptr <Z_Vector> & x_full,
+            bool const & changed
+        ) {
+            if(x.storage==SDPStorage::Full)
+                return x;
+            if(!x_full) {
+                x_full.reset(new Z_Vector(x.types,x.sizes));
+                Z::convert(x,*x_full);
+            } else if(changed)
+                Z::convert(x,*x_full);
+            return *x_full;
+        }
+
+        // Forms the Schur complement and its Choleski factorization
+        void factor(bool const & z_changed,bool const & h_x_changed) const {
+            // Record the time that we spend in the factorization
+            OPTIZELLE_TRACE(trace,"schur","sql")
+
+            // We work with full semidefinite blocks below
+            Z_Vector const & z_f = full(z,z_full,z_changed);
+            Z_Vector const & h_x_f = full(h_x,h_x_full,h_x_changed);
+
+            // Determine the number of variables and cones
+            Natural const m = h.A.size()-1;
+            Natural const nblks = z_f.numBlocks();
+
+            // Find the inverse of each semidefinite block of h(x)
+            std::vector <std::vector <Real> > Hinv(nblks);
+            for(Natural blk=1;blk<=nblks;blk++) {
+                if(h_x_f.blkType(blk)!=Cone::Semidefinite) continue;
+                Natural const mm=h_x_f.blkSize(blk);
+
+                std::vector <Real> & Hinv_k=Hinv[itok(blk)];
+                Hinv_k.resize(mm*mm);
+                Optizelle::copy <Real> (mm*mm,&(h_x_f.front(blk)),1,
+                    &(Hinv_k.front()),1);
+                Integer info(0);
+                Optizelle::potrf <Real> ('U',mm,&(Hinv_k.front()),mm,info);
+                if(info==0)
+                    Optizelle::potri <Real> ('U',mm,&(Hinv_k.front()),mm,
+                        info);
+
+                // If the block isn't positive definite, we can't form the
+                // Schur complement, so revert to the identity
+                if(info!=0) {
+                    factored = false;
+                    return;
+                }
+                for(Natural i=1;i<=mm;i++)
+                    Optizelle::copy <Real> (mm-i,&(Hinv_k[ijtok(i,i+1,mm)]),mm,
+                        &(Hinv_k[ijtok(i+1,i,mm)]),1);
+            }
+
+            // Form each column of the Schur complement
+            M.resize(m*m);
+            #ifdef _OPENMP
+            #pragma omp parallel
+            #endif
+            {
+                // Workspace for each thread.  Only the cones marked in
+                // touched contain valid data in W.
+                Z_Vector W(Z::init(z_f));
+                std::vector <Real> a;
+                std::vector <Real> s;
+                std::vector <char> touched(nblks);
+
+                #ifdef _OPENMP
+                #pragma omp for schedule(dynamic)
+                #endif
+                for(Natural j=1;j<=m;j++) {
+                    SparseSQL <Real> const & Aj=h.A[j];
+
+                    // Find the cones touched by A_j
+                    std::fill(touched.begin(),touched.end(),0);
+                    for(Natural k=0;k<Aj.blks.size();k++)
+                        touched[itok(Aj.blks[k])]=1;
+
+                    // W <- inv(L(h(x))) (A_j o z) on the touched cones
+                    for(Natural blk=1;blk<=nblks;blk++) {
+                        if(!touched[itok(blk)]) continue;
+                        Natural const mm=z_f.blkSize(blk);
+
+                        switch(z_f.blkType(blk)) {
+
+                        // W = inv(Diag(h(x))) Diag(z) a
+                        case Cone::Linear:
+                            for(Natural i=1;i<=mm;i++)
+                                W(blk,i)=Real(0.);
+                            for(Natural k=0;k<Aj.blks.size();k++)
+                                if(Aj.blks[k]==blk) {
+                                    Natural const & i=Aj.is[k];
+                                    W(blk,i) += Aj.data[k]*z_f(blk,i)
+                                        /h_x_f(blk,i);
+                                }
+                            break;
+
+                        // W = inv(Arw(h(x))) (a o z)
+                        case Cone::Quadratic: {
+                            // a <- A_j restricted to this cone
+                            a.assign(mm,Real(0.));
+                            for(Natural k=0;k<Aj.blks.size();k++)
+                                if(Aj.blks[k]==blk)
+                                    a[itok(Aj.is[k])] += Aj.data[k];
+
+                            // s <- a o z = [a'z ; a0 zbar + z0 abar]
+                            Natural const mbar=mm-1;
+                            s.resize(mm);
+                            s[0]=Optizelle::dot <Real> (mm,&(a[0]),1,
+                                &(z_f.front(blk)),1);
+                            Optizelle::copy <Real> (mbar,&(z_f.bar(blk)),1,
+                                &(s[1]),1);
+                            Optizelle::scal <Real> (mbar,a[0],&(s[1]),1);
+                            Optizelle::axpy <Real> (mbar,z_f.naught(blk),
+                                &(a[1]),1,&(s[1]),1);
+
+                            // Apply the closed form inverse of Arw(h(x))
+                            //
+                            // w0 = (h0 s0 - <hbar,sbar>) / det
+                            // wbar = sbar / h0 - (s0/det) hbar
+                            //      + <hbar,sbar> / (h0 det) hbar
+                            //
+                            // where det = h0^2 - <hbar,hbar>.
+                            Real const h0=h_x_f.naught(blk);
+                            Real const det = h0*h0 - Optizelle::dot <Real> (
+                                mbar,&(h_x_f.bar(blk)),1,&(h_x_f.bar(blk)),1);
+                            Real const hbar_sbar = Optizelle::dot <Real> (
+                                mbar,&(h_x_f.bar(blk)),1,&(s[1]),1);
+                            W.naught(blk)=(h0*s[0]-hbar_sbar)/det;
+                            Optizelle::copy <Real> (mbar,&(s[1]),1,
+                                &(W.bar(blk)),1);
+                            Optizelle::scal <Real> (mbar,Real(1.)/h0,
+                                &(W.bar(blk)),1);
+                            Optizelle::axpy <Real> (mbar,
+                                (hbar_sbar/h0-s[0])/det,&(h_x_f.bar(blk)),1,
+                                &(W.bar(blk)),1);
+                            break;
+
+                        // W = inv(H) A_j Z
+                        } case Cone::Semidefinite: {
+                            // Count the number of nonzeros in this cone
+                            Natural nnz(0);
+                            for(Natural k=0;k<Aj.blks.size();k++)
+                                if(Aj.blks[k]==blk)
+                                    nnz += Aj.is[k]==Aj.js[k] ? 1 : 2;
+
+                            std::vector <Real> const & Hinv_k=Hinv[itok(blk)];
+
+                            // When A_j is very sparse, accumulate the rank-1
+                            // updates inv(H) e_p (Z e_q)' for each nonzero
+                            // (p,q).  This uses the symmetry of Z.
+                            if(nnz < mm) {
+                                for(Natural i=1;i<=mm;i++)
+                                    for(Natural ii=1;ii<=mm;ii++)
+                                        W(blk,ii,i)=Real(0.);
+                                for(Natural k=0;k<Aj.blks.size();k++) {
+                                    if(Aj.blks[k]!=blk) continue;
+                                    Natural const & p=Aj.is[k];
+                                    Natural const & q=Aj.js[k];
+                                    Optizelle::gemm <Real> ('N','T',mm,mm,1,
+                                        Aj.data[k],&(Hinv_k[ijtok(1,p,mm)]),mm,
+                                        &(z_f(blk,1,q)),mm,Real(1.),
+                                        &(W.front(blk)),mm);
+                                    if(p!=q)
+                                        Optizelle::gemm <Real> ('N','T',mm,mm,1,
+                                            Aj.data[k],&(Hinv_k[ijtok(1,q,mm)]),
+                                            mm,&(z_f(blk,1,p)),mm,Real(1.),
+                                            &(W.front(blk)),mm);
+                                }
+
+                            // Otherwise, form A_j densely and multiply
+                            } else {
+                                a.assign(mm*mm,Real(0.));
+                                s.resize(mm*mm);
+                                for(Natural k=0;k<Aj.blks.size();k++) {
+                                    if(Aj.blks[k]!=blk) continue;
+                                    Natural const & p=Aj.is[k];
+                                    Natural const & q=Aj.js[k];
+                                    a[ijtok(p,q,mm)] += Aj.data[k];
+                                    if(p!=q)
+                                        a[ijtok(q,p,mm)] += Aj.data[k];
+                                }
+
+                                // s <- A_j Z
+                                Optizelle::symm <Real> ('L','U',mm,mm,Real(1.),
+                                    &(a[0]),mm,&(z_f.front(blk)),mm,Real(0.),
+                                    &(s[0]),mm);
+
+                                // W <- inv(H) A_j Z
+                                Optizelle::symm <Real> ('L','U',mm,mm,Real(1.),
+                                    &(Hinv_k[0]),mm,&(s[0]),mm,Real(0.),
+                                    &(W.front(blk)),mm);
+                            }
+                            break;
+                        }}
+                    }
+
+                    // M_ij <- <A_i,W> where we only look at the touched cones
+                    for(Natural i=1;i<=m;i++) {
+                        SparseSQL <Real> const & Ai=h.A[i];
+                        Real Mij(0.);
+                        for(Natural k=0;k<Ai.blks.size();k++) {
+                            Natural const & blk=Ai.blks[k];
+                            if(!touched[itok(blk)]) continue;
+                            if(W.blkType(blk)==Cone::Semidefinite) {
+                                Mij += Ai.data[k]*W(blk,Ai.is[k],Ai.js[k]);
+                                if(Ai.is[k]!=Ai.js[k])
+                                    Mij += Ai.data[k]*W(blk,Ai.js[k],Ai.is[k]);
+                            } else
+                                Mij += Ai.data[k]*W(blk,Ai.is[k]);
+                        }
+                        M[ijtok(i,j,m)]=Mij;
+                    }
+                }
+            }
+
+            // M <- (M + M')/2.  We only need the upper triangle for the
+            // Choleski factorization.
+            for(Natural j=1;j<=m;j++)
+                for(Natural i=1;i<j;i++)
+                    M[ijtok(i,j,m)]=Real(0.5)*(M[ijtok(i,j,m)]+M[ijtok(j,i,m)]);
+
+            // Find the Choleski factorization of M
+            Integer info(0);
+            if(m>0) Optizelle::potrf <Real> ('U',m,&(M[0]),m,info);
+            factored = info==0;
+        }
+
+    public:
+        SchurComplement(
+            LinearSQLFunction <Real> const & h_,
+            Z_Vector const & z_,
+            Z_Vector const & h_x_
+        ) : h(h_),
+            z(z_),
+            h_x(h_x_),
+            z_last(false,Z::init(z_)),
+            h_x_last(false,Z::init(h_x_)),
+            z_full(),
+            h_x_full(),
+            M(),
+            factored(false)
+        {}
+
+        // PH_dx <- inv(M) dx
+        void eval(X_Vector const & dx,X_Vector & PH_dx) const {
+            // See if we need to refactor the Schur complement
+            bool const z_changed = rel_err_cached <Real,SQL> (z,z_last)
+                >= std::numeric_limits <Real>::epsilon()*1e1;
+            bool const h_x_changed = rel_err_cached <Real,SQL> (h_x,h_x_last)
+                >= std::numeric_limits <Real>::epsilon()*1e1;
+            if(z_changed || h_x_changed) {
+                factor(z_changed,h_x_changed);
+
+                // Cache the values
+                z_last.first=true;
+                Z::copy(z,z_last.second);
+                h_x_last.first=true;
+                Z::copy(h_x,h_x_last.second);
+            }
+
+            // Start by copying over the direction
+            X::copy(dx,PH_dx);
+
+            // If we have a factorization, solve with M.  Otherwise, we
+            // revert to the identity.
+            if(factored && PH_dx.size()>0) {
+                Natural const m = PH_dx.size();
+                Optizelle::trsv <Real> ('U','T','N',m,&(M[0]),m,&(PH_dx[0]),1);
+                Optizelle::trsv <Real> ('U','N','N',m,&(M[0]),m,&(PH_dx[0]),1);
+            }
+        }
+    };
+
     namespace json {
         // Serialization utility for the SQL vector space
         template <typename Real>
@@ -1127,6 +2088,8 @@ namespace Optizelle {
                     x_json["sizes"][Json::ArrayIndex(i)]
                         =Json::Value::UInt64(x.sizes[i]);
 
+                x_json["storage"]=SDPStorage::to_string(x.storage);
+
                 for(Natural i=0;i<x.inverse.size();i++)
                     x_json["inverse"][Json::ArrayIndex(i)]=x.inverse[i];
 
@@ -1141,6 +2104,15 @@ namespace Optizelle {
                 for(Natural i=0;i<x.inverse_base_offsets.size();i++)
                     x_json["inverse_base_offsets"][Json::ArrayIndex(i)]
                         =Json::Value::UInt64(x.inverse_base_offsets[i]);
+
+                if(x.isWide()) {
+                    for(Natural i=0;i<x.widened.size();i++)
+                        x_json["widened"][Json::ArrayIndex(i)]
+                            =bool(x.widened[i]);
+
+                    for(Natural i=0;i<x.wide.size();i++)
+                        x_json["wide"][Json::ArrayIndex(i)]=x.wide[i];
+                }
                 
                 // Return a string of the result
                 Json::StyledWriter writer;
@@ -1169,8 +2141,14 @@ namespace Optizelle {
                     sizes[i]=x_json["sizes"][Json::ArrayIndex(i)]
                         .asUInt64();
 
+                // Grab how we store the semidefinite blocks.  Older files
+                // don't have this and always use full storage.
+                SDPStorage::t storage = x_json.isMember("storage")
+                    ? SDPStorage::from_string(x_json["storage"].asString())
+                    : SDPStorage::Full;
+
                 // Allocate a new SQL vector
-                typename SQL <Real>::Vector x(types,sizes);
+                typename SQL <Real>::Vector x(types,sizes,storage);
 
                 // Read in the data
                 for(Natural i=0;i<x.data.size();i++)
@@ -1181,21 +2159,31 @@ namespace Optizelle {
                     x.offsets[i]=x_json["offsets"][Json::ArrayIndex(i)]
                         .asUInt64();
 
-                for(Natural i=0;i<x.inverse.size();i++)
+                // Grab the cached inverses or, for packed storage, Choleski
+                // factors.  The offsets into the caches are determined by the
+                // types, sizes, and storage, so the constructor has already
+                // set them.  Older files with packed blocks cached something
+                // else.  In this case, we leave the base at zero, which forces
+                // us to recompute the decomposition.
+                bool const cached = x_json["inverse"].size()==x.inverse.size();
+                for(Natural i=0;i<x.inverse.size() && cached;i++)
                     x.inverse[i]=Real(x_json["inverse"]
                         [Json::ArrayIndex(i)].asDouble());
-                
-                for(Natural i=0;i<x.inverse_offsets.size();i++)
-                    x.inverse_offsets[i]=x_json["inverse_offsets"]
-                        [Json::ArrayIndex(i)].asUInt64();
-                
-                for(Natural i=0;i<x.inverse_base.size();i++)
+
+                for(Natural i=0;i<x.inverse_base.size() && cached;i++)
                     x.inverse_base[i]=Real(x_json["inverse_base"]
                         [Json::ArrayIndex(i)].asDouble());
-                
-                for(Natural i=0;i<x.inverse_base_offsets.size();i++)
-                    x.inverse_base_offsets[i]=x_json["inverse_base_offsets"]
-                        [Json::ArrayIndex(i)].asUInt64();
+
+                // Grab the full-storage temporaries if we have them
+                if(x_json.isMember("widened")) {
+                    for(Natural i=0;i<x.widened.size();i++)
+                        x.widened[i]=x_json["widened"]
+                            [Json::ArrayIndex(i)].asBool();
+                    x.allocWide();
+                    for(Natural i=0;i<x.wide.size();i++)
+                        x.wide[i]=Real(x_json["wide"]
+                            [Json::ArrayIndex(i)].asDouble());
+                }
 
                 // Return the newly constructed vector
                 return std::move(x);
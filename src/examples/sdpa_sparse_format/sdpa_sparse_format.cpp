@@ -498,6 +498,27 @@ public:
     }
 };
 
+// Converts the constraint matrices into the sparse format used by
+// Optizelle::LinearSQLFunction
+template <typename Real>
+std::vector <Optizelle::SparseSQL <Real> > toSparseSQL(
+    SparseSDP <Real> const & prob
+) {
+    std::vector <Optizelle::SparseSQL <Real> > A(prob.A.size());
+    for(Natural i=0;i<prob.A.size();i++) {
+        for(Natural j=0;j<prob.blk_sizes.size();j++) {
+            for(Natural k=0;k<prob.A[i][j].is.size();k++) {
+                A[i].blks.emplace_back(j+1);
+                A[i].is.emplace_back(prob.A[i][j].is[k]);
+                A[i].js.emplace_back(
+                    prob.blk_sizes[j]<0 ? 0 : prob.A[i][j].js[k]);
+                A[i].data.emplace_back(prob.A[i][j].data[k]);
+            }
+        }
+    }
+    return A;
+}
+
 // Initializes an SQL vector 
 template <typename Real>
 typename Optizelle::SQL <Real>::Vector initSQL(
@@ -1046,9 +1067,13 @@ int main(int argc,char* argv[]) {
     Optizelle::InequalityConstrained <Real,Optizelle::Rm,Optizelle::SQL>
         ::Functions::t fns;
     fns.f.reset(new SDPObj <Real> (prob));
-    fns.h.reset(new SDPIneq <Real> (prob));
-    fns.PH.reset(new SDPPreconditioner <Real,Optizelle::Rm> (
-        new ProjectRm <Real> (),fns.f_mod,state.x));
+
+    // Since the phase-2 problem is linear, we give the constraint in sparse
+    // form and solve the Newton systems directly with the Schur complement.
+    Optizelle::LinearSQLFunction <Real> * h
+        = new Optizelle::LinearSQLFunction <Real> (toSparseSQL <Real> (prob));
+    fns.h.reset(h);
+    fns.PH.reset(new Optizelle::SchurComplement <Real> (*h,state.z,state.h_x));
     
     // Keep our user informed
     std::cout << std::endl << "Solving the SDP probem: " << fname << std::endl;
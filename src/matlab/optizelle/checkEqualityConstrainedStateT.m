@@ -34,11 +34,24 @@ function checkEqualityConstrainedStateT(name,value)
         'PSchur_right_type', ...
         'augsys_iter_max', ...
         'augsys_rst_freq', ...
+        'augsys_iter_saved', ...
         'g_x', ...
         'norm_gxtyp', ...
         'gpxdxn_p_gx', ...
         'gpxdxt', ...
         'norm_gpxdxnpgx', ...
+        'g_eval_calls', ...
+        'g_eval_time', ...
+        'g_p_calls', ...
+        'g_p_time', ...
+        'g_ps_calls', ...
+        'g_ps_time', ...
+        'g_pps_calls', ...
+        'g_pps_time', ...
+        'PSchur_left_calls', ...
+        'PSchur_left_time', ...
+        'PSchur_right_calls', ...
+        'PSchur_right_time', ...
         'dx_n', ...
         'dx_ncp', ...
         'dx_t', ...
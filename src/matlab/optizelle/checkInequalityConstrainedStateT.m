@@ -17,12 +17,23 @@ function checkInequalityConstrainedStateT(name,value)
         'z', ...
         'dz', ...
         'h_x', ...
+        'z_corr', ...
         'mu', ...
         'mu_est', ...
         'mu_typ', ...
         'eps_mu', ...
         'sigma', ...
         'gamma', ...
+        'h_eval_calls', ...
+        'h_eval_time', ...
+        'h_p_calls', ...
+        'h_p_time', ...
+        'h_ps_calls', ...
+        'h_ps_time', ...
+        'h_pps_calls', ...
+        'h_pps_time', ...
+        'cone_calls', ...
+        'cone_time', ...
         'ipm', ...
         'cstrat', ...
         'h_diag'}, ...
@@ -7,6 +7,7 @@ function checkUnconstrainedStateT(name,value)
         'eps_dx', ...
         'stored_history', ...
         'history_reset', ...
+        'history_precision', ...
         'iter', ...
         'iter_max', ...
         'opt_stop', ...
@@ -14,10 +15,12 @@ function checkUnconstrainedStateT(name,value)
         'krylov_iter_max', ...
         'krylov_iter_total', ...
         'krylov_orthog_max', ...
+        'dense_size_max', ...
         'krylov_stop', ...
         'krylov_rel_err', ...
         'eps_krylov', ...
         'krylov_solver', ...
+        'krylov_precision', ...
         'algorithm_class', ...
         'PH_type', ...
         'H_type', ...
@@ -47,6 +50,16 @@ function checkUnconstrainedStateT(name,value)
         'linesearch_iter_max', ...
         'linesearch_iter_total', ...
         'eps_ls', ...
+        'f_eval_calls', ...
+        'f_eval_time', ...
+        'f_grad_calls', ...
+        'f_grad_time', ...
+        'f_hessvec_calls', ...
+        'f_hessvec_time', ...
+        'PH_calls', ...
+        'PH_time', ...
+        'krylov_calls', ...
+        'krylov_time', ...
         'dir', ...
         'kind', ...
         'f_diag', ...
@@ -179,6 +179,38 @@ namespace Optizelle {
         }
     }
 
+    namespace KrylovPrecision { 
+        // Converts t to a Matlab enumerated type
+        mxArray * toMatlab(t const & krylov_precision) {
+            // Do the conversion
+            switch(krylov_precision){
+            case Full:
+                return Matlab::enumToMxArray("KrylovPrecision","Full");
+            case Mixed:
+                return Matlab::enumToMxArray("KrylovPrecision","Mixed");
+            case Compressed:
+                return Matlab::enumToMxArray("KrylovPrecision","Compressed");
+            default:
+                throw;
+            }
+        }
+
+        // Converts a Matlab enumerated type to t 
+        t fromMatlab(mxArray * const member) {
+            // Convert the member to a Natural 
+            Natural m(*mxGetPr(member));
+
+            if(m==Matlab::enumToNatural("KrylovPrecision","Full"))
+                return Full;
+            else if(m==Matlab::enumToNatural("KrylovPrecision","Mixed"))
+                return Mixed;
+            else if(m==Matlab::enumToNatural("KrylovPrecision","Compressed"))
+                return Compressed;
+            else
+                throw;
+        }
+    }
+
     namespace AlgorithmClass { 
         // Converts t to a Matlab enumerated type
         mxArray * toMatlab(t const & algorithm_class) {
@@ -508,6 +540,9 @@ namespace Optizelle {
             case LogBarrier:
                 return Matlab::enumToMxArray("InteriorPointMethod",
                     "LogBarrier");
+            case Mehrotra:
+                return Matlab::enumToMxArray("InteriorPointMethod",
+                    "Mehrotra");
             default:
                 throw;
             }
@@ -528,6 +563,10 @@ namespace Optizelle {
                 "LogBarrier")
             )
                 return LogBarrier;
+            else if(m==Matlab::enumToNatural("InteriorPointMethod",
+                "Mehrotra")
+            )
+                return Mehrotra;
             else
                 throw;
         }
@@ -1732,6 +1771,25 @@ namespace Optizelle {
                 mxArray * item(mxGetField(obj,0,name.c_str()));
                 value.fromMatlab(item);
             }
+
+            // Sets a vector in a C++ state that has a version token.  The
+            // state manipulators convert the state at every location, so
+            // we compare against the old vector rather than invalidate the
+            // cached quantities on each round trip.
+            void VersionedVector(
+                std::string const & name,
+                mxArray * const obj,
+                Matlab::Vector & value,
+                Optizelle::Natural & value_version,
+                Optizelle::Natural & version
+            ) {
+                Matlab::Vector value_old(value.init());
+                value_old.copy(value);
+                Vector(name,obj,value);
+                value_old.axpy(-1.,value);
+                if(value_old.innr(value_old)!=0.)
+                    value_version=++version;
+            }
         
             // Sets restart vectors in C++ 
             void Vectors(
@@ -1831,6 +1889,7 @@ namespace Optizelle {
                         "eps_dx",
                         "stored_history",
                         "history_reset",
+                        "history_precision",
                         "iter",
                         "iter_max",
                         "opt_stop",
@@ -1838,10 +1897,12 @@ namespace Optizelle {
                         "krylov_iter_max",
                         "krylov_iter_total",
                         "krylov_orthog_max",
+                        "dense_size_max",
                         "krylov_stop",
                         "krylov_rel_err",
                         "eps_krylov",
                         "krylov_solver",
+                        "krylov_precision",
                         "algorithm_class",
                         "PH_type",
                         "H_type",
@@ -1871,6 +1932,16 @@ namespace Optizelle {
                         "linesearch_iter_max",
                         "linesearch_iter_total",
                         "eps_ls",
+                        "f_eval_calls",
+                        "f_eval_time",
+                        "f_grad_calls",
+                        "f_grad_time",
+                        "f_hessvec_calls",
+                        "f_hessvec_time",
+                        "PH_calls",
+                        "PH_time",
+                        "krylov_calls",
+                        "krylov_time",
                         "dir",
                         "kind",
                         "f_diag",
@@ -1901,6 +1972,11 @@ namespace Optizelle {
                         state.stored_history,mxstate);
                     toMatlab::Natural("history_reset",
                         state.history_reset,mxstate);
+                    toMatlab::Param <KrylovPrecision::t> (
+                        "history_precision",
+                        KrylovPrecision::toMatlab,
+                        state.history_precision,
+                        mxstate);
                     toMatlab::Natural("iter",state.iter,mxstate);
                     toMatlab::Natural("iter_max",state.iter_max,mxstate);
                     toMatlab::Param <StoppingCondition::t> (
@@ -1915,6 +1991,8 @@ namespace Optizelle {
                         state.krylov_iter_total,mxstate);
                     toMatlab::Natural("krylov_orthog_max",
                         state.krylov_orthog_max,mxstate);
+                    toMatlab::Natural("dense_size_max",
+                        state.dense_size_max,mxstate);
                     toMatlab::Param <KrylovStop::t> (
                         "krylov_stop",
                         KrylovStop::toMatlab,
@@ -1928,6 +2006,11 @@ namespace Optizelle {
                         KrylovSolverTruncated::toMatlab,
                         state.krylov_solver,
                         mxstate);
+                    toMatlab::Param <KrylovPrecision::t> (
+                        "krylov_precision",
+                        KrylovPrecision::toMatlab,
+                        state.krylov_precision,
+                        mxstate);
                     toMatlab::Param <AlgorithmClass::t> (
                         "algorithm_class",
                         AlgorithmClass::toMatlab,
@@ -1973,6 +2056,21 @@ namespace Optizelle {
                     toMatlab::Natural("linesearch_iter_total",
                         state.linesearch_iter_total,mxstate);
                     toMatlab::Real("eps_ls",state.eps_ls,mxstate);
+                    toMatlab::Natural("f_eval_calls",
+                        state.f_eval_calls,mxstate);
+                    toMatlab::Real("f_eval_time",state.f_eval_time,mxstate);
+                    toMatlab::Natural("f_grad_calls",
+                        state.f_grad_calls,mxstate);
+                    toMatlab::Real("f_grad_time",state.f_grad_time,mxstate);
+                    toMatlab::Natural("f_hessvec_calls",
+                        state.f_hessvec_calls,mxstate);
+                    toMatlab::Real("f_hessvec_time",
+                        state.f_hessvec_time,mxstate);
+                    toMatlab::Natural("PH_calls",state.PH_calls,mxstate);
+                    toMatlab::Real("PH_time",state.PH_time,mxstate);
+                    toMatlab::Natural("krylov_calls",
+                        state.krylov_calls,mxstate);
+                    toMatlab::Real("krylov_time",state.krylov_time,mxstate);
                     toMatlab::Param <LineSearchDirection::t> (
                         "dir",
                         LineSearchDirection::toMatlab,
@@ -2013,6 +2111,11 @@ namespace Optizelle {
                         mxstate,state.stored_history);
                     fromMatlab::Natural("history_reset",
                         mxstate,state.history_reset);
+                    fromMatlab::Param <KrylovPrecision::t> (
+                        "history_precision",
+                        KrylovPrecision::fromMatlab,
+                        mxstate,
+                        state.history_precision);
                     fromMatlab::Natural("iter",mxstate,state.iter);
                     fromMatlab::Natural("iter_max",mxstate,state.iter_max);
                     fromMatlab::Param <StoppingCondition::t> (
@@ -2028,6 +2131,8 @@ namespace Optizelle {
                         mxstate,state.krylov_iter_total);
                     fromMatlab::Natural("krylov_orthog_max",
                         mxstate,state.krylov_orthog_max);
+                    fromMatlab::Natural("dense_size_max",
+                        mxstate,state.dense_size_max);
                     fromMatlab::Param <KrylovStop::t> (
                         "krylov_stop",
                         KrylovStop::fromMatlab,
@@ -2041,6 +2146,11 @@ namespace Optizelle {
                         KrylovSolverTruncated::fromMatlab,
                         mxstate,
                         state.krylov_solver);
+                    fromMatlab::Param <KrylovPrecision::t> (
+                        "krylov_precision",
+                        KrylovPrecision::fromMatlab,
+                        mxstate,
+                        state.krylov_precision);
                     fromMatlab::Param <AlgorithmClass::t> (
                         "algorithm_class",
                         AlgorithmClass::fromMatlab,
@@ -2059,7 +2169,8 @@ namespace Optizelle {
                     fromMatlab::Real("norm_gradtyp",
                         mxstate,state.norm_gradtyp);
                     fromMatlab::Real("norm_dxtyp",mxstate,state.norm_dxtyp);
-                    fromMatlab::Vector("x",mxstate,state.x);
+                    fromMatlab::VersionedVector("x",mxstate,state.x,
+                        state.x_version,state.version);
                     fromMatlab::Vector("grad",mxstate,state.grad);
                     fromMatlab::Vector("dx",mxstate,state.dx);
                     fromMatlab::Vector("x_old",mxstate,state.x_old);
@@ -2087,6 +2198,21 @@ namespace Optizelle {
                     fromMatlab::Natural("linesearch_iter_total",mxstate,
                         state.linesearch_iter_total);
                     fromMatlab::Real("eps_ls",mxstate,state.eps_ls);
+                    fromMatlab::Natural("f_eval_calls",
+                        mxstate,state.f_eval_calls);
+                    fromMatlab::Real("f_eval_time",mxstate,state.f_eval_time);
+                    fromMatlab::Natural("f_grad_calls",
+                        mxstate,state.f_grad_calls);
+                    fromMatlab::Real("f_grad_time",mxstate,state.f_grad_time);
+                    fromMatlab::Natural("f_hessvec_calls",
+                        mxstate,state.f_hessvec_calls);
+                    fromMatlab::Real("f_hessvec_time",
+                        mxstate,state.f_hessvec_time);
+                    fromMatlab::Natural("PH_calls",mxstate,state.PH_calls);
+                    fromMatlab::Real("PH_time",mxstate,state.PH_time);
+                    fromMatlab::Natural("krylov_calls",
+                        mxstate,state.krylov_calls);
+                    fromMatlab::Real("krylov_time",mxstate,state.krylov_time);
                     fromMatlab::Param <LineSearchDirection::t> (
                         "dir",
                         LineSearchDirection::fromMatlab,
@@ -2588,11 +2714,24 @@ namespace Optizelle {
                         "PSchur_right_type",
                         "augsys_iter_max",
                         "augsys_rst_freq",
+                        "augsys_iter_saved",
                         "g_x",
                         "norm_gxtyp",
                         "gpxdxn_p_gx",
                         "gpxdxt",
                         "norm_gpxdxnpgx",
+                        "g_eval_calls",
+                        "g_eval_time",
+                        "g_p_calls",
+                        "g_p_time",
+                        "g_ps_calls",
+                        "g_ps_time",
+                        "g_pps_calls",
+                        "g_pps_time",
+                        "PSchur_left_calls",
+                        "PSchur_left_time",
+                        "PSchur_right_calls",
+                        "PSchur_right_time",
                         "dx_n",
                         "dx_ncp",
                         "dx_t",
@@ -2657,12 +2796,31 @@ namespace Optizelle {
                         state.augsys_iter_max,mxstate);
                     toMatlab::Natural("augsys_rst_freq",
                         state.augsys_rst_freq,mxstate);
+                    toMatlab::Natural("augsys_iter_saved",
+                        state.augsys_iter_saved,mxstate);
                     toMatlab::Vector("g_x",state.g_x,mxstate);
                     toMatlab::Real("norm_gxtyp",state.norm_gxtyp,mxstate);
                     toMatlab::Vector("gpxdxn_p_gx",state.gpxdxn_p_gx,mxstate);
                     toMatlab::Vector("gpxdxt",state.gpxdxt,mxstate);
                     toMatlab::Real("norm_gpxdxnpgx",
                         state.norm_gpxdxnpgx,mxstate);
+                    toMatlab::Natural("g_eval_calls",
+                        state.g_eval_calls,mxstate);
+                    toMatlab::Real("g_eval_time",state.g_eval_time,mxstate);
+                    toMatlab::Natural("g_p_calls",state.g_p_calls,mxstate);
+                    toMatlab::Real("g_p_time",state.g_p_time,mxstate);
+                    toMatlab::Natural("g_ps_calls",state.g_ps_calls,mxstate);
+                    toMatlab::Real("g_ps_time",state.g_ps_time,mxstate);
+                    toMatlab::Natural("g_pps_calls",state.g_pps_calls,mxstate);
+                    toMatlab::Real("g_pps_time",state.g_pps_time,mxstate);
+                    toMatlab::Natural("PSchur_left_calls",
+                        state.PSchur_left_calls,mxstate);
+                    toMatlab::Real("PSchur_left_time",
+                        state.PSchur_left_time,mxstate);
+                    toMatlab::Natural("PSchur_right_calls",
+                        state.PSchur_right_calls,mxstate);
+                    toMatlab::Real("PSchur_right_time",
+                        state.PSchur_right_time,mxstate);
                     toMatlab::Vector("dx_n",state.dx_n,mxstate);
                     toMatlab::Vector("dx_ncp",state.dx_ncp,mxstate);
                     toMatlab::Vector("dx_t",state.dx_t,mxstate);
@@ -2693,7 +2851,8 @@ namespace Optizelle {
                     mxArray * const mxstate,
                     typename MxEqualityConstrained::State::t & state
                 ){
-                    fromMatlab::Vector("y",mxstate,state.y);
+                    fromMatlab::VersionedVector("y",mxstate,state.y,
+                        state.y_version,state.version);
                     fromMatlab::Vector("dy",mxstate,state.dy);
                     fromMatlab::Real("zeta",mxstate,state.zeta);
                     fromMatlab::Real("eta0",mxstate,state.eta0);
@@ -2723,12 +2882,32 @@ namespace Optizelle {
                         mxstate,state.augsys_iter_max);
                     fromMatlab::Natural("augsys_rst_freq",
                         mxstate,state.augsys_rst_freq);
+                    fromMatlab::Natural("augsys_iter_saved",
+                        mxstate,state.augsys_iter_saved);
                     fromMatlab::Vector("g_x",mxstate,state.g_x);
                     fromMatlab::Real("norm_gxtyp",mxstate,state.norm_gxtyp);
                     fromMatlab::Vector("gpxdxn_p_gx",mxstate,state.gpxdxn_p_gx);
                     fromMatlab::Vector("gpxdxt",mxstate,state.gpxdxt);
                     fromMatlab::Real("norm_gpxdxnpgx",
                         mxstate,state.norm_gpxdxnpgx);
+                    fromMatlab::Natural("g_eval_calls",
+                        mxstate,state.g_eval_calls);
+                    fromMatlab::Real("g_eval_time",mxstate,state.g_eval_time);
+                    fromMatlab::Natural("g_p_calls",mxstate,state.g_p_calls);
+                    fromMatlab::Real("g_p_time",mxstate,state.g_p_time);
+                    fromMatlab::Natural("g_ps_calls",mxstate,state.g_ps_calls);
+                    fromMatlab::Real("g_ps_time",mxstate,state.g_ps_time);
+                    fromMatlab::Natural("g_pps_calls",
+                        mxstate,state.g_pps_calls);
+                    fromMatlab::Real("g_pps_time",mxstate,state.g_pps_time);
+                    fromMatlab::Natural("PSchur_left_calls",
+                        mxstate,state.PSchur_left_calls);
+                    fromMatlab::Real("PSchur_left_time",
+                        mxstate,state.PSchur_left_time);
+                    fromMatlab::Natural("PSchur_right_calls",
+                        mxstate,state.PSchur_right_calls);
+                    fromMatlab::Real("PSchur_right_time",
+                        mxstate,state.PSchur_right_time);
                     fromMatlab::Vector("dx_n",mxstate,state.dx_n);
                     fromMatlab::Vector("dx_ncp",mxstate,state.dx_ncp);
                     fromMatlab::Vector("dx_t",mxstate,state.dx_t);
@@ -3244,12 +3423,23 @@ namespace Optizelle {
                         "z",
                         "dz",
                         "h_x",
+                        "z_corr",
                         "mu",
                         "mu_est",
                         "mu_typ",
                         "eps_mu",
                         "sigma",
                         "gamma",
+                        "h_eval_calls",
+                        "h_eval_time",
+                        "h_p_calls",
+                        "h_p_time",
+                        "h_ps_calls",
+                        "h_ps_time",
+                        "h_pps_calls",
+                        "h_pps_time",
+                        "cone_calls",
+                        "cone_time",
                         "ipm",
                         "cstrat",
                         "h_diag"};
@@ -3281,12 +3471,24 @@ namespace Optizelle {
                     toMatlab::Vector("z",state.z,mxstate);
                     toMatlab::Vector("dz",state.dz,mxstate);
                     toMatlab::Vector("h_x",state.h_x,mxstate);
+                    toMatlab::Vector("z_corr",state.z_corr,mxstate);
                     toMatlab::Real("mu",state.mu,mxstate);
                     toMatlab::Real("mu_est",state.mu_est,mxstate);
                     toMatlab::Real("mu_typ",state.mu_typ,mxstate);
                     toMatlab::Real("eps_mu",state.eps_mu,mxstate);
                     toMatlab::Real("sigma",state.sigma,mxstate);
                     toMatlab::Real("gamma",state.gamma,mxstate);
+                    toMatlab::Natural("h_eval_calls",
+                        state.h_eval_calls,mxstate);
+                    toMatlab::Real("h_eval_time",state.h_eval_time,mxstate);
+                    toMatlab::Natural("h_p_calls",state.h_p_calls,mxstate);
+                    toMatlab::Real("h_p_time",state.h_p_time,mxstate);
+                    toMatlab::Natural("h_ps_calls",state.h_ps_calls,mxstate);
+                    toMatlab::Real("h_ps_time",state.h_ps_time,mxstate);
+                    toMatlab::Natural("h_pps_calls",state.h_pps_calls,mxstate);
+                    toMatlab::Real("h_pps_time",state.h_pps_time,mxstate);
+                    toMatlab::Natural("cone_calls",state.cone_calls,mxstate);
+                    toMatlab::Real("cone_time",state.cone_time,mxstate);
                     toMatlab::Param <InteriorPointMethod::t> (
                         "ipm",
                         InteriorPointMethod::toMatlab,
@@ -3316,15 +3518,29 @@ namespace Optizelle {
                     mxArray * const mxstate,
                     typename MxInequalityConstrained::State::t & state
                 ){
-                    fromMatlab::Vector("z",mxstate,state.z);
+                    fromMatlab::VersionedVector("z",mxstate,state.z,
+                        state.z_version,state.version);
                     fromMatlab::Vector("dz",mxstate,state.dz);
                     fromMatlab::Vector("h_x",mxstate,state.h_x);
+                    fromMatlab::Vector("z_corr",mxstate,state.z_corr);
                     fromMatlab::Real("mu",mxstate,state.mu);
                     fromMatlab::Real("mu_est",mxstate,state.mu_est);
                     fromMatlab::Real("mu_typ",mxstate,state.mu_typ);
                     fromMatlab::Real("eps_mu",mxstate,state.eps_mu);
                     fromMatlab::Real("sigma",mxstate,state.sigma);
                     fromMatlab::Real("gamma",mxstate,state.gamma);
+                    fromMatlab::Natural("h_eval_calls",
+                        mxstate,state.h_eval_calls);
+                    fromMatlab::Real("h_eval_time",mxstate,state.h_eval_time);
+                    fromMatlab::Natural("h_p_calls",mxstate,state.h_p_calls);
+                    fromMatlab::Real("h_p_time",mxstate,state.h_p_time);
+                    fromMatlab::Natural("h_ps_calls",mxstate,state.h_ps_calls);
+                    fromMatlab::Real("h_ps_time",mxstate,state.h_ps_time);
+                    fromMatlab::Natural("h_pps_calls",
+                        mxstate,state.h_pps_calls);
+                    fromMatlab::Real("h_pps_time",mxstate,state.h_pps_time);
+                    fromMatlab::Natural("cone_calls",mxstate,state.cone_calls);
+                    fromMatlab::Real("cone_time",mxstate,state.cone_time);
                     fromMatlab::Param <InteriorPointMethod::t> (
                         "ipm",
                         InteriorPointMethod::fromMatlab,
@@ -61,6 +61,14 @@ namespace Optizelle {
         t fromMatlab(mxArray * const member);
     }
 
+    namespace KrylovPrecision {
+        // Converts t to a Matlab enumerated type
+        mxArray * toMatlab(t const & krylov_precision);
+
+        // Converts a Matlab enumerated type to t 
+        t fromMatlab(mxArray * const member);
+    }
+
     namespace AlgorithmClass { 
         // Converts t to a Matlab enumerated type
         mxArray * toMatlab(t const & algorithm_class);
@@ -830,6 +838,16 @@ namespace Optizelle {
                 mxArray * const obj,
                 Matlab::Vector & value
             );
+
+            // Sets a vector in a C++ state that has a version token.  We only
+            // assign a new token when the vector changes.
+            void VersionedVector(
+                std::string const & name,
+                mxArray * const obj,
+                Matlab::Vector & value,
+                Optizelle::Natural & value_version,
+                Optizelle::Natural & version
+            );
             
             // Sets a list of vectors in a C++ state 
             void VectorList(
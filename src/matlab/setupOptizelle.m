@@ -110,11 +110,18 @@ Optizelle.KrylovSolverTruncated = createEnum( { ...
     'ConjugateDirection', ...
     'MINRES' } );
 
+% Different precisions for the iterations of the Krylov methods
+Optizelle.KrylovPrecision = createEnum( { ...
+    'Full', ...
+    'Mixed', ...
+    'Compressed' } );
+
 % Different kinds of interior point methods
 Optizelle.InteriorPointMethod = createEnum( { ...
     'PrimalDual', ...
     'PrimalDualLinked', ...
-    'LogBarrier' } );
+    'LogBarrier', ...
+    'Mehrotra' } );
     
 % Different schemes for adjusting the interior point centrality
 Optizelle.CentralityStrategy = createEnum( { ...
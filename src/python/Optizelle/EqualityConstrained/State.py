@@ -113,6 +113,12 @@ class t(Optizelle.Unconstrained.State.t):
         ("Equality constraint evaluated at x.  This is used in the quasinormal "
         "step as well as in the computation of the linear Taylor series at x "
         "in the direciton dx_n."))
+    augsys_iter_saved = Optizelle.createNatProperty(
+        "augsys_iter_saved",
+        ("Number of augmented system iterations that we didn't have to repeat "
+        "since, after tightening the tolerances in the step computation, we "
+        "continued the solves from where they left off rather than from "
+        "scratch"))
     norm_gxtyp = Optizelle.createFloatProperty(
         "norm_gxtyp",
         ("A typical norm for norm_gx.  Generally, we just take the value at "
@@ -130,6 +136,44 @@ class t(Optizelle.Unconstrained.State.t):
         "norm_gpxdxnpgx",
         ("Norm of gpxdxn_p_gx.  This is used in the penalty parameter "
         "computation and predicted reduction."))
+    g_eval_calls = Optizelle.createNatProperty(
+        "g_eval_calls",
+        "Number of calls to the equality constraint")
+    g_eval_time = Optizelle.createFloatProperty(
+        "g_eval_time",
+        "Seconds spent in the equality constraint")
+    g_p_calls = Optizelle.createNatProperty(
+        "g_p_calls",
+        "Number of calls to the equality constraint derivative")
+    g_p_time = Optizelle.createFloatProperty(
+        "g_p_time",
+        "Seconds spent in the equality constraint derivative")
+    g_ps_calls = Optizelle.createNatProperty(
+        "g_ps_calls",
+        "Number of calls to the equality constraint derivative adjoint")
+    g_ps_time = Optizelle.createFloatProperty(
+        "g_ps_time",
+        "Seconds spent in the equality constraint derivative adjoint")
+    g_pps_calls = Optizelle.createNatProperty(
+        "g_pps_calls",
+        ("Number of calls to the equality constraint second "
+        "derivative adjoint"))
+    g_pps_time = Optizelle.createFloatProperty(
+        "g_pps_time",
+        ("Seconds spent in the equality constraint second "
+        "derivative adjoint"))
+    PSchur_left_calls = Optizelle.createNatProperty(
+        "PSchur_left_calls",
+        "Number of calls to the left augmented system preconditioner")
+    PSchur_left_time = Optizelle.createFloatProperty(
+        "PSchur_left_time",
+        "Seconds spent in the left augmented system preconditioner")
+    PSchur_right_calls = Optizelle.createNatProperty(
+        "PSchur_right_calls",
+        "Number of calls to the right augmented system preconditioner")
+    PSchur_right_time = Optizelle.createFloatProperty(
+        "PSchur_right_time",
+        "Seconds spent in the right augmented system preconditioner")
     dx_n = Optizelle.createVectorProperty(
         "dx_n",
         "Normal step")
@@ -10,6 +10,7 @@ def allocateVectors(self,X,Z,x,z):
     self.z=Z.init(z)
     self.dz=Z.init(z)
     self.h_x=Z.init(z)
+    self.z_corr=Z.init(z)
 
 class t(Optizelle.Unconstrained.State.t):
     """Internal state of the optimization"""
@@ -39,6 +40,9 @@ class t(Optizelle.Unconstrained.State.t):
     h_x = Optizelle.createVectorProperty(
         "h_x",
         "The inequality constraint evaluated at x.")
+    z_corr = Optizelle.createVectorProperty(
+        "z_corr",
+        "Second-order correction to the complementarity condition")
     mu = Optizelle.createFloatProperty(
         "mu",
         "Interior point parameter")
@@ -58,6 +62,38 @@ class t(Optizelle.Unconstrained.State.t):
     gamma = Optizelle.createFloatProperty(
         "gamma",
         "How close we move to the boundary during a single step")
+    h_eval_calls = Optizelle.createNatProperty(
+        "h_eval_calls",
+        "Number of calls to the inequality constraint")
+    h_eval_time = Optizelle.createFloatProperty(
+        "h_eval_time",
+        "Seconds spent in the inequality constraint")
+    h_p_calls = Optizelle.createNatProperty(
+        "h_p_calls",
+        "Number of calls to the inequality constraint derivative")
+    h_p_time = Optizelle.createFloatProperty(
+        "h_p_time",
+        "Seconds spent in the inequality constraint derivative")
+    h_ps_calls = Optizelle.createNatProperty(
+        "h_ps_calls",
+        "Number of calls to the inequality constraint derivative adjoint")
+    h_ps_time = Optizelle.createFloatProperty(
+        "h_ps_time",
+        "Seconds spent in the inequality constraint derivative adjoint")
+    h_pps_calls = Optizelle.createNatProperty(
+        "h_pps_calls",
+        ("Number of calls to the inequality constraint second "
+        "derivative adjoint"))
+    h_pps_time = Optizelle.createFloatProperty(
+        "h_pps_time",
+        ("Seconds spent in the inequality constraint second "
+        "derivative adjoint"))
+    cone_calls = Optizelle.createNatProperty(
+        "cone_calls",
+        "Number of calls to the work on the cone")
+    cone_time = Optizelle.createFloatProperty(
+        "cone_time",
+        "Seconds spent in the work on the cone")
     ipm = Optizelle.createEnumProperty(
         "ipm",
         Optizelle.InteriorPointMethod,
@@ -50,6 +50,10 @@ class t(object):
         "history_reset", 
             "Number of failed iterations before we reset the "
             "history for quasi-Newton methods")
+    history_precision = Optizelle.createEnumProperty(
+        "history_precision",
+        Optizelle.KrylovPrecision,
+        "Precision used to store the history for quasi-Newton methods")
     iter = Optizelle.createNatProperty(
         "iter",
         "Current iteration")
@@ -74,6 +78,11 @@ class t(object):
         ("The maximum number of vectors we orthogonalize "
         "against in the Krylov method.  For something like "
         "CG, this is 1."))
+    dense_size_max = Optizelle.createNatProperty(
+        "dense_size_max",
+        ("Largest number of variables where we solve the trust-region "
+        "subproblem with a dense factorization of the Hessian when the "
+        "objective provides one"))
     krylov_stop = Optizelle.createEnumProperty(
         "krylov_stop",
         Optizelle.KrylovStop,
@@ -88,6 +97,10 @@ class t(object):
         "krylov_solver",
         Optizelle.KrylovSolverTruncated, 
         "Truncated Krylov solver")
+    krylov_precision = Optizelle.createEnumProperty(
+        "krylov_precision",
+        Optizelle.KrylovPrecision,
+        "Precision used for the iterations of the Krylov methods")
     algorithm_class = Optizelle.createEnumProperty(
         "algorithm_class",
         Optizelle.AlgorithmClass,
@@ -180,6 +193,36 @@ class t(object):
     eps_ls = Optizelle.createFloatProperty(
         "eps_ls",
         "Stopping tolerance for the line-search")
+    f_eval_calls = Optizelle.createNatProperty(
+        "f_eval_calls",
+        "Number of calls to the objective")
+    f_eval_time = Optizelle.createFloatProperty(
+        "f_eval_time",
+        "Seconds spent in the objective")
+    f_grad_calls = Optizelle.createNatProperty(
+        "f_grad_calls",
+        "Number of calls to the gradient")
+    f_grad_time = Optizelle.createFloatProperty(
+        "f_grad_time",
+        "Seconds spent in the gradient")
+    f_hessvec_calls = Optizelle.createNatProperty(
+        "f_hessvec_calls",
+        "Number of calls to the Hessian-vector product")
+    f_hessvec_time = Optizelle.createFloatProperty(
+        "f_hessvec_time",
+        "Seconds spent in the Hessian-vector product")
+    PH_calls = Optizelle.createNatProperty(
+        "PH_calls",
+        "Number of calls to the Hessian preconditioner")
+    PH_time = Optizelle.createFloatProperty(
+        "PH_time",
+        "Seconds spent in the Hessian preconditioner")
+    krylov_calls = Optizelle.createNatProperty(
+        "krylov_calls",
+        "Number of calls to the Krylov solves")
+    krylov_time = Optizelle.createFloatProperty(
+        "krylov_time",
+        "Seconds spent in the Krylov solves")
     dir = Optizelle.createEnumProperty(
         "dir",
         Optizelle.LineSearchDirection,
@@ -172,6 +172,38 @@ namespace Optizelle {
                 throw;
         }
     }
+    
+    namespace KrylovPrecision { 
+        // Converts t to a Python enumerated type
+        PyObject * toPython(t const & krylov_precision) {
+            // Do the conversion
+            switch(krylov_precision){
+            case Full:
+                return Python::enumToPyObject("KrylovPrecision","Full");
+            case Mixed:
+                return Python::enumToPyObject("KrylovPrecision","Mixed");
+            case Compressed:
+                return Python::enumToPyObject("KrylovPrecision","Compressed");
+            default:
+                throw;
+            }
+        }
+
+        // Converts a Python enumerated type to t 
+        t fromPython(PyObject * const member) {
+            // Convert the member to a Natural 
+            Natural m=PyInt_AsSsize_t(member);
+
+            if(m==Python::enumToNatural("KrylovPrecision","Full"))
+                return Full;
+            else if(m==Python::enumToNatural("KrylovPrecision","Mixed"))
+                return Mixed;
+            else if(m==Python::enumToNatural("KrylovPrecision","Compressed"))
+                return Compressed;
+            else
+                throw;
+        }
+    }
 
     namespace AlgorithmClass { 
         // Converts t to a Python enumerated type
@@ -502,6 +534,9 @@ namespace Optizelle {
             case LogBarrier:
                 return Python::enumToPyObject("InteriorPointMethod",
                     "LogBarrier");
+            case Mehrotra:
+                return Python::enumToPyObject("InteriorPointMethod",
+                    "Mehrotra");
             default:
                 throw;
             }
@@ -522,6 +557,10 @@ namespace Optizelle {
                 "LogBarrier")
             )
                 return LogBarrier;
+            else if(m==Python::enumToNatural("InteriorPointMethod",
+                "Mehrotra")
+            )
+                return Mehrotra;
             else
                 throw;
         }
@@ -1701,6 +1740,25 @@ namespace Optizelle {
                 PyObjectPtr item(PyObject_GetAttrString(obj,name.c_str()));
                 value.fromPython(item.get());
             }
+
+            // Sets a vector in a C++ state that has a version token.  The
+            // state manipulators convert the state at every location, so
+            // we compare against the old vector rather than invalidate the
+            // cached quantities on each round trip.
+            void VersionedVector(
+                std::string const & name,
+                PyObject * const obj,
+                Python::Vector & value,
+                Optizelle::Natural & value_version,
+                Optizelle::Natural & version
+            ) {
+                Python::Vector value_old(value.init());
+                value_old.copy(value);
+                Vector(name,obj,value);
+                value_old.axpy(-1.,value);
+                if(value_old.innr(value_old)!=0.)
+                    value_version=++version;
+            }
         
             // Sets restart vectors in C++ 
             void Vectors(
@@ -1817,6 +1875,11 @@ namespace Optizelle {
                         state.stored_history,pystate);
                     toPython::Natural("history_reset",
                         state.history_reset,pystate);
+                    toPython::Param <KrylovPrecision::t> (
+                        "history_precision",
+                        KrylovPrecision::toPython,
+                        state.history_precision,
+                        pystate);
                     toPython::Natural("iter",state.iter,pystate);
                     toPython::Natural("iter_max",state.iter_max,pystate);
                     toPython::Param <StoppingCondition::t> (
@@ -1831,6 +1894,8 @@ namespace Optizelle {
                         state.krylov_iter_total,pystate);
                     toPython::Natural("krylov_orthog_max",
                         state.krylov_orthog_max,pystate);
+                    toPython::Natural("dense_size_max",
+                        state.dense_size_max,pystate);
                     toPython::Param <KrylovStop::t> (
                         "krylov_stop",
                         KrylovStop::toPython,
@@ -1844,6 +1909,11 @@ namespace Optizelle {
                         KrylovSolverTruncated::toPython,
                         state.krylov_solver,
                         pystate);
+                    toPython::Param <KrylovPrecision::t> (
+                        "krylov_precision",
+                        KrylovPrecision::toPython,
+                        state.krylov_precision,
+                        pystate);
                     toPython::Param <AlgorithmClass::t> (
                         "algorithm_class",
                         AlgorithmClass::toPython,
@@ -1889,6 +1959,21 @@ namespace Optizelle {
                     toPython::Natural("linesearch_iter_total",
                         state.linesearch_iter_total,pystate);
                     toPython::Real("eps_ls",state.eps_ls,pystate);
+                    toPython::Natural("f_eval_calls",
+                        state.f_eval_calls,pystate);
+                    toPython::Real("f_eval_time",state.f_eval_time,pystate);
+                    toPython::Natural("f_grad_calls",
+                        state.f_grad_calls,pystate);
+                    toPython::Real("f_grad_time",state.f_grad_time,pystate);
+                    toPython::Natural("f_hessvec_calls",
+                        state.f_hessvec_calls,pystate);
+                    toPython::Real("f_hessvec_time",
+                        state.f_hessvec_time,pystate);
+                    toPython::Natural("PH_calls",state.PH_calls,pystate);
+                    toPython::Real("PH_time",state.PH_time,pystate);
+                    toPython::Natural("krylov_calls",
+                        state.krylov_calls,pystate);
+                    toPython::Real("krylov_time",state.krylov_time,pystate);
                     toPython::Param <LineSearchDirection::t> (
                         "dir",
                         LineSearchDirection::toPython,
@@ -1929,6 +2014,11 @@ namespace Optizelle {
                         pystate,state.stored_history);
                     fromPython::Natural("history_reset",
                         pystate,state.history_reset);
+                    fromPython::Param <KrylovPrecision::t> (
+                        "history_precision",
+                        KrylovPrecision::fromPython,
+                        pystate,
+                        state.history_precision);
                     fromPython::Natural("iter",pystate,state.iter);
                     fromPython::Natural("iter_max",pystate,state.iter_max);
                     fromPython::Param <StoppingCondition::t> (
@@ -1944,6 +2034,8 @@ namespace Optizelle {
                         pystate,state.krylov_iter_total);
                     fromPython::Natural("krylov_orthog_max",
                         pystate,state.krylov_orthog_max);
+                    fromPython::Natural("dense_size_max",
+                        pystate,state.dense_size_max);
                     fromPython::Param <KrylovStop::t> (
                         "krylov_stop",
                         KrylovStop::fromPython,
@@ -1957,6 +2049,11 @@ namespace Optizelle {
                         KrylovSolverTruncated::fromPython,
                         pystate,
                         state.krylov_solver);
+                    fromPython::Param <KrylovPrecision::t> (
+                        "krylov_precision",
+                        KrylovPrecision::fromPython,
+                        pystate,
+                        state.krylov_precision);
                     fromPython::Param <AlgorithmClass::t> (
                         "algorithm_class",
                         AlgorithmClass::fromPython,
@@ -1975,7 +2072,8 @@ namespace Optizelle {
                     fromPython::Real("norm_gradtyp",
                         pystate,state.norm_gradtyp);
                     fromPython::Real("norm_dxtyp",pystate,state.norm_dxtyp);
-                    fromPython::Vector("x",pystate,state.x);
+                    fromPython::VersionedVector("x",pystate,state.x,
+                        state.x_version,state.version);
                     fromPython::Vector("grad",pystate,state.grad);
                     fromPython::Vector("dx",pystate,state.dx);
                     fromPython::Vector("x_old",pystate,state.x_old);
@@ -2003,6 +2101,21 @@ namespace Optizelle {
                     fromPython::Natural("linesearch_iter_total",pystate,
                         state.linesearch_iter_total);
                     fromPython::Real("eps_ls",pystate,state.eps_ls);
+                    fromPython::Natural("f_eval_calls",
+                        pystate,state.f_eval_calls);
+                    fromPython::Real("f_eval_time",pystate,state.f_eval_time);
+                    fromPython::Natural("f_grad_calls",
+                        pystate,state.f_grad_calls);
+                    fromPython::Real("f_grad_time",pystate,state.f_grad_time);
+                    fromPython::Natural("f_hessvec_calls",
+                        pystate,state.f_hessvec_calls);
+                    fromPython::Real("f_hessvec_time",
+                        pystate,state.f_hessvec_time);
+                    fromPython::Natural("PH_calls",pystate,state.PH_calls);
+                    fromPython::Real("PH_time",pystate,state.PH_time);
+                    fromPython::Natural("krylov_calls",
+                        pystate,state.krylov_calls);
+                    fromPython::Real("krylov_time",pystate,state.krylov_time);
                     fromPython::Param <LineSearchDirection::t> (
                         "dir",
                         LineSearchDirection::fromPython,
@@ -2457,12 +2570,31 @@ namespace Optizelle {
                         state.augsys_iter_max,pystate);
                     toPython::Natural("augsys_rst_freq",
                         state.augsys_rst_freq,pystate);
+                    toPython::Natural("augsys_iter_saved",
+                        state.augsys_iter_saved,pystate);
                     toPython::Vector("g_x",state.g_x,pystate);
                     toPython::Real("norm_gxtyp",state.norm_gxtyp,pystate);
                     toPython::Vector("gpxdxn_p_gx",state.gpxdxn_p_gx,pystate);
                     toPython::Vector("gpxdxt",state.gpxdxt,pystate);
                     toPython::Real("norm_gpxdxnpgx",
                         state.norm_gpxdxnpgx,pystate);
+                    toPython::Natural("g_eval_calls",
+                        state.g_eval_calls,pystate);
+                    toPython::Real("g_eval_time",state.g_eval_time,pystate);
+                    toPython::Natural("g_p_calls",state.g_p_calls,pystate);
+                    toPython::Real("g_p_time",state.g_p_time,pystate);
+                    toPython::Natural("g_ps_calls",state.g_ps_calls,pystate);
+                    toPython::Real("g_ps_time",state.g_ps_time,pystate);
+                    toPython::Natural("g_pps_calls",state.g_pps_calls,pystate);
+                    toPython::Real("g_pps_time",state.g_pps_time,pystate);
+                    toPython::Natural("PSchur_left_calls",
+                        state.PSchur_left_calls,pystate);
+                    toPython::Real("PSchur_left_time",
+                        state.PSchur_left_time,pystate);
+                    toPython::Natural("PSchur_right_calls",
+                        state.PSchur_right_calls,pystate);
+                    toPython::Real("PSchur_right_time",
+                        state.PSchur_right_time,pystate);
                     toPython::Vector("dx_n",state.dx_n,pystate);
                     toPython::Vector("dx_ncp",state.dx_ncp,pystate);
                     toPython::Vector("dx_t",state.dx_t,pystate);
@@ -2493,7 +2625,8 @@ namespace Optizelle {
                     PyObject * const pystate,
                     typename PyEqualityConstrained::State::t & state
                 ){
-                    fromPython::Vector("y",pystate,state.y);
+                    fromPython::VersionedVector("y",pystate,state.y,
+                        state.y_version,state.version);
                     fromPython::Vector("dy",pystate,state.dy);
                     fromPython::Real("zeta",pystate,state.zeta);
                     fromPython::Real("eta0",pystate,state.eta0);
@@ -2523,12 +2656,32 @@ namespace Optizelle {
                         pystate,state.augsys_iter_max);
                     fromPython::Natural("augsys_rst_freq",
                         pystate,state.augsys_rst_freq);
+                    fromPython::Natural("augsys_iter_saved",
+                        pystate,state.augsys_iter_saved);
                     fromPython::Vector("g_x",pystate,state.g_x);
                     fromPython::Real("norm_gxtyp",pystate,state.norm_gxtyp);
                     fromPython::Vector("gpxdxn_p_gx",pystate,state.gpxdxn_p_gx);
                     fromPython::Vector("gpxdxt",pystate,state.gpxdxt);
                     fromPython::Real("norm_gpxdxnpgx",
                         pystate,state.norm_gpxdxnpgx);
+                    fromPython::Natural("g_eval_calls",
+                        pystate,state.g_eval_calls);
+                    fromPython::Real("g_eval_time",pystate,state.g_eval_time);
+                    fromPython::Natural("g_p_calls",pystate,state.g_p_calls);
+                    fromPython::Real("g_p_time",pystate,state.g_p_time);
+                    fromPython::Natural("g_ps_calls",pystate,state.g_ps_calls);
+                    fromPython::Real("g_ps_time",pystate,state.g_ps_time);
+                    fromPython::Natural("g_pps_calls",
+                        pystate,state.g_pps_calls);
+                    fromPython::Real("g_pps_time",pystate,state.g_pps_time);
+                    fromPython::Natural("PSchur_left_calls",
+                        pystate,state.PSchur_left_calls);
+                    fromPython::Real("PSchur_left_time",
+                        pystate,state.PSchur_left_time);
+                    fromPython::Natural("PSchur_right_calls",
+                        pystate,state.PSchur_right_calls);
+                    fromPython::Real("PSchur_right_time",
+                        pystate,state.PSchur_right_time);
                     fromPython::Vector("dx_n",pystate,state.dx_n);
                     fromPython::Vector("dx_ncp",pystate,state.dx_ncp);
                     fromPython::Vector("dx_t",pystate,state.dx_t);
@@ -2979,12 +3132,24 @@ namespace Optizelle {
                     toPython::Vector("z",state.z,pystate);
                     toPython::Vector("dz",state.dz,pystate);
                     toPython::Vector("h_x",state.h_x,pystate);
+                    toPython::Vector("z_corr",state.z_corr,pystate);
                     toPython::Real("mu",state.mu,pystate);
                     toPython::Real("mu_est",state.mu_est,pystate);
                     toPython::Real("mu_typ",state.mu_typ,pystate);
                     toPython::Real("eps_mu",state.eps_mu,pystate);
                     toPython::Real("sigma",state.sigma,pystate);
                     toPython::Real("gamma",state.gamma,pystate);
+                    toPython::Natural("h_eval_calls",
+                        state.h_eval_calls,pystate);
+                    toPython::Real("h_eval_time",state.h_eval_time,pystate);
+                    toPython::Natural("h_p_calls",state.h_p_calls,pystate);
+                    toPython::Real("h_p_time",state.h_p_time,pystate);
+                    toPython::Natural("h_ps_calls",state.h_ps_calls,pystate);
+                    toPython::Real("h_ps_time",state.h_ps_time,pystate);
+                    toPython::Natural("h_pps_calls",state.h_pps_calls,pystate);
+                    toPython::Real("h_pps_time",state.h_pps_time,pystate);
+                    toPython::Natural("cone_calls",state.cone_calls,pystate);
+                    toPython::Real("cone_time",state.cone_time,pystate);
                     toPython::Param <InteriorPointMethod::t> (
                         "ipm",
                         InteriorPointMethod::toPython,
@@ -3014,15 +3179,29 @@ namespace Optizelle {
                     PyObject * const pystate,
                     typename PyInequalityConstrained::State::t & state
                 ){
-                    fromPython::Vector("z",pystate,state.z);
+                    fromPython::VersionedVector("z",pystate,state.z,
+                        state.z_version,state.version);
                     fromPython::Vector("dz",pystate,state.dz);
                     fromPython::Vector("h_x",pystate,state.h_x);
+                    fromPython::Vector("z_corr",pystate,state.z_corr);
                     fromPython::Real("mu",pystate,state.mu);
                     fromPython::Real("mu_est",pystate,state.mu_est);
                     fromPython::Real("mu_typ",pystate,state.mu_typ);
                     fromPython::Real("eps_mu",pystate,state.eps_mu);
                     fromPython::Real("sigma",pystate,state.sigma);
                     fromPython::Real("gamma",pystate,state.gamma);
+                    fromPython::Natural("h_eval_calls",
+                        pystate,state.h_eval_calls);
+                    fromPython::Real("h_eval_time",pystate,state.h_eval_time);
+                    fromPython::Natural("h_p_calls",pystate,state.h_p_calls);
+                    fromPython::Real("h_p_time",pystate,state.h_p_time);
+                    fromPython::Natural("h_ps_calls",pystate,state.h_ps_calls);
+                    fromPython::Real("h_ps_time",pystate,state.h_ps_time);
+                    fromPython::Natural("h_pps_calls",
+                        pystate,state.h_pps_calls);
+                    fromPython::Real("h_pps_time",pystate,state.h_pps_time);
+                    fromPython::Natural("cone_calls",pystate,state.cone_calls);
+                    fromPython::Real("cone_time",pystate,state.cone_time);
                     fromPython::Param <InteriorPointMethod::t> (
                         "ipm",
                         InteriorPointMethod::fromPython,
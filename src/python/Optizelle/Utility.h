@@ -69,6 +69,14 @@ namespace Optizelle {
         t fromPython(PyObject * const member);
     }
 
+    namespace KrylovPrecision {
+        // Converts t to a Python enumerated type
+        PyObject * toPython(t const & krylov_precision);
+
+        // Converts a Python enumerated type to t 
+        t fromPython(PyObject * const member);
+    }
+
     namespace AlgorithmClass { 
         // Converts t to a Python enumerated type
         PyObject * toPython(t const & algorithm_class);
@@ -841,6 +849,16 @@ namespace Optizelle {
                 PyObject * const obj,
                 Python::Vector & value
             );
+
+            // Sets a vector in a C++ state that has a version token.  We only
+            // assign a new token when the vector changes.
+            void VersionedVector(
+                std::string const & name,
+                PyObject * const obj,
+                Python::Vector & value,
+                Optizelle::Natural & value_version,
+                Optizelle::Natural & version
+            );
             
             // Sets a list of vectors in a C++ state 
             void VectorList(
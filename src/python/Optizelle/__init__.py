@@ -23,6 +23,7 @@ __all__ = [
     "OptimizationLocation",
     "ProblemClass",
     "KrylovSolverTruncated",
+    "KrylovPrecision",
     "InteriorPointMethod",
     "CentralityStrategy",
     "FunctionDiagnostics",
@@ -148,12 +149,20 @@ class KrylovSolverTruncated(EnumeratedType):
     MINRES \
     = range(2)
 
+class KrylovPrecision(EnumeratedType):
+    """Precision used for the iterations of the Krylov methods"""
+    Full, \
+    Mixed, \
+    Compressed \
+    = range(3)
+
 class InteriorPointMethod(EnumeratedType):
     """Different kinds of interior point methods"""
     PrimalDual, \
     PrimalDualLinked, \
-    LogBarrier \
-    = range(3)
+    LogBarrier, \
+    Mehrotra \
+    = range(4)
     
 class CentralityStrategy(EnumeratedType):
     """Different schemes for adjusting the interior point centrality"""
@@ -0,0 +1,146 @@
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/ad.h"
+#include "unit.h"
+
+// Create some type shortcuts
+typedef Optizelle::Rm <double> X;
+typedef X::Vector X_Vector;
+using Optizelle::Natural;
+
+// f(x) = log(x0) + sqrt(x1) + x2^2.5 + tanh(x0 x1) + atan(x2)
+//        + cos(x1) tan(x0) + |x0-x2| + 1/(x0+x1)
+// Also counts how many times we record the function on a tape.
+struct Elementary {
+    Natural & recorded;
+    Elementary(Natural & recorded_) : recorded(recorded_) {}
+
+    template <typename T>
+    T operator () (std::vector <T> const & x) const {
+        if(!std::is_same <T,double>::value) recorded++;
+        using std::log; using std::sqrt; using std::pow; using std::tanh;
+        using std::atan; using std::cos; using std::tan; using std::fabs;
+        return log(x[0])+sqrt(x[1])+pow(x[2],2.5)+tanh(x[0]*x[1])
+            +atan(x[2])+cos(x[1])*tan(x[0])+fabs(x[0]-x[2])+1./(x[0]+x[1]);
+    }
+};
+
+// g(x) = [ x0 x1 x2 ; sin(x0) + exp(x1)/x2 ]
+struct Constraint {
+    template <typename T>
+    void operator () (std::vector <T> const & x,std::vector <T> & y) const {
+        using std::sin; using std::exp;
+        y[0]=x[0]*x[1]*x[2];
+        y[1]=sin(x[0])+exp(x[1])/x[2];
+    }
+};
+
+// Relative difference between two vectors
+double rel_err(X_Vector const & x,X_Vector const & y) {
+    X_Vector r(X::init(x));
+    X::copy(x,r);
+    X::axpy(-1.,y,r);
+    return std::sqrt(X::innr(r,r))/(1.+std::sqrt(X::innr(y,y)));
+}
+
+// Checks that the derivatives from automatic differentiation match the
+// hand-coded or finite difference derivatives and that the tape is only
+// recorded once per point
+int main() {
+    X_Vector x = {0.7,1.3,0.9};
+    X_Vector dx = {-0.4,0.25,1.1};
+    double const eps = 1e-6;
+
+    // Check the gradient and the Hessian-vector product of the scalar
+    // function against central differences
+    {
+        Natural recorded(0);
+        Elementary e(recorded);
+        Optizelle::AD::ScalarValuedFunction <double,Elementary> f(e);
+
+        X_Vector g(X::init(x));
+        f.grad(x,g);
+        X_Vector g_fd(X::init(x));
+        for(Natural i=0;i<x.size();i++) {
+            X_Vector xp(x); xp[i]+=eps;
+            X_Vector xm(x); xm[i]-=eps;
+            g_fd[i]=(f.eval(xp)-f.eval(xm))/(2.*eps);
+        }
+        CHECK(rel_err(g,g_fd) < 1e-8);
+
+        X_Vector H_dx(X::init(x));
+        f.hessvec(x,dx,H_dx);
+        X_Vector H_dx_fd(X::init(x));
+        {
+            X_Vector xp(x); X::axpy(eps,dx,xp);
+            X_Vector xm(x); X::axpy(-eps,dx,xm);
+            X_Vector gp(X::init(x)); f.grad(xp,gp);
+            X_Vector gm(X::init(x)); f.grad(xm,gm);
+            X::copy(gp,H_dx_fd);
+            X::axpy(-1.,gm,H_dx_fd);
+            X::scal(1./(2.*eps),H_dx_fd);
+        }
+        CHECK(rel_err(H_dx,H_dx_fd) < 1e-7);
+
+        // Evaluation doesn't record, the gradient at x recorded once, and the
+        // two finite difference gradients recorded twice more.  Going back
+        // to x records again, but repeated products at x don't.
+        CHECK(recorded == 3);
+        f.hessvec(x,dx,H_dx);
+        f.hessvec(x,g,H_dx);
+        f.grad(x,g);
+        CHECK(recorded == 4);
+
+        // The dense Hessian agrees with the Hessian-vector product and reuses
+        // the tape
+        std::vector <double> H(x.size()*x.size());
+        CHECK(f.hessian(x,H));
+        CHECK(recorded == 4);
+        f.hessvec(x,dx,H_dx);
+        X_Vector H_dx_dense(X::init(x));
+        Optizelle::gemv <double> ('N',x.size(),x.size(),1.,&(H[0]),x.size(),
+            &(dx[0]),1,0.,&(H_dx_dense[0]),1);
+        CHECK(rel_err(H_dx_dense,H_dx) < 1e-14);
+    }
+
+    // Check the constraint derivatives against the hand-coded ones
+    {
+        Optizelle::AD::VectorValuedFunction <double,Constraint>
+            g((Constraint()));
+        X_Vector dy = {0.6,-1.7};
+        double const e1 = std::exp(x[1]);
+
+        X_Vector y(2);
+        g.eval(x,y);
+        CHECK(std::fabs(y[0]-x[0]*x[1]*x[2]) < 1e-15);
+
+        X_Vector gp_dx(2);
+        g.p(x,dx,gp_dx);
+        X_Vector gp_dx_true = {
+            x[1]*x[2]*dx[0]+x[0]*x[2]*dx[1]+x[0]*x[1]*dx[2],
+            std::cos(x[0])*dx[0]+e1/x[2]*dx[1]-e1/(x[2]*x[2])*dx[2]};
+        CHECK(rel_err(gp_dx,gp_dx_true) < 1e-14);
+
+        X_Vector gps_dy(X::init(x));
+        g.ps(x,dy,gps_dy);
+        X_Vector gps_dy_true = {
+            x[1]*x[2]*dy[0]+std::cos(x[0])*dy[1],
+            x[0]*x[2]*dy[0]+e1/x[2]*dy[1],
+            x[0]*x[1]*dy[0]-e1/(x[2]*x[2])*dy[1]};
+        CHECK(rel_err(gps_dy,gps_dy_true) < 1e-14);
+
+        X_Vector gpps(X::init(x));
+        g.pps(x,dx,dy,gpps);
+        X_Vector gpps_true = {
+            dy[0]*(x[2]*dx[1]+x[1]*dx[2])-dy[1]*std::sin(x[0])*dx[0],
+            dy[0]*(x[2]*dx[0]+x[0]*dx[2])
+                +dy[1]*(e1/x[2]*dx[1]-e1/(x[2]*x[2])*dx[2]),
+            dy[0]*(x[1]*dx[0]+x[0]*dx[1])
+                +dy[1]*(-e1/(x[2]*x[2])*dx[1]
+                    +2.*e1/(x[2]*x[2]*x[2])*dx[2])};
+        CHECK(rel_err(gpps,gpps_true) < 1e-14);
+    }
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
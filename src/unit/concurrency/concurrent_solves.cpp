@@ -0,0 +1,234 @@
+#include <atomic>
+#include <thread>
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "unit.h"
+
+// Create some type shortcuts
+typedef Optizelle::Rm <double> X;
+typedef X::Vector X_Vector;
+typedef Optizelle::SQL <double> Z;
+typedef Z::Vector Z_Vector;
+using Optizelle::Natural;
+using Optizelle::Rm;
+using Optizelle::SQL;
+
+// Data for problem k
+double data(Natural const & k) {
+    return 1.+0.5*std::sin(double(k));
+}
+
+// f(x,y) = (a - x)^2 + 10 (y - x^2)^2
+struct MyRosenbrock : public Optizelle::ScalarValuedFunction <double,Rm> {
+    double a;
+    MyRosenbrock(double const & a_) : a(a_) {}
+    double eval(X_Vector const & x) const {
+        return Optizelle::sq(a-x[0])+10.*Optizelle::sq(x[1]-x[0]*x[0]);
+    }
+    void grad(X_Vector const & x,X_Vector & g) const {
+        g[0]=-2.*(a-x[0])-40.*x[0]*(x[1]-x[0]*x[0]);
+        g[1]=20.*(x[1]-x[0]*x[0]);
+    }
+    void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+        const
+    {
+        H_dx[0]=(2.-40.*x[1]+120.*x[0]*x[0])*dx[0]-40.*x[0]*dx[1];
+        H_dx[1]=-40.*x[0]*dx[0]+20.*dx[1];
+    }
+};
+
+// f(x,y) = -a x + y
+struct MyLinear : public Optizelle::ScalarValuedFunction <double,Rm> {
+    double a;
+    MyLinear(double const & a_) : a(a_) {}
+    double eval(X_Vector const & x) const {
+        return -a*x[0]+x[1];
+    }
+    void grad(X_Vector const & x,X_Vector & g) const {
+        g[0]=-a;
+        g[1]=1.;
+    }
+    void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+        const
+    {
+        X::zero(H_dx);
+    }
+};
+
+// f(x,y) = (x - a)^2 + (y + 1)^2
+struct MyQuadratic : public Optizelle::ScalarValuedFunction <double,Rm> {
+    double a;
+    MyQuadratic(double const & a_) : a(a_) {}
+    double eval(X_Vector const & x) const {
+        return Optizelle::sq(x[0]-a)+Optizelle::sq(x[1]+1.);
+    }
+    void grad(X_Vector const & x,X_Vector & g) const {
+        g[0]=2.*(x[0]-a);
+        g[1]=2.*(x[1]+1.);
+    }
+    void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+        const
+    {
+        H_dx[0]=2.*dx[0];
+        H_dx[1]=2.*dx[1];
+    }
+};
+
+// g(x,y) = [ x^2 + 2y = 1 ]
+struct MyEq : public Optizelle::VectorValuedFunction <double,Rm,Rm> {
+    void eval(X_Vector const & x,X_Vector & y) const {
+        y[0]=x[0]*x[0]+2.*x[1]-1.;
+    }
+    void p(X_Vector const & x,X_Vector const & dx,X_Vector & y) const {
+        y[0]=2.*x[0]*dx[0]+2.*dx[1];
+    }
+    void ps(X_Vector const & x,X_Vector const & dy,X_Vector & z) const {
+        z[0]=2.*x[0]*dy[0];
+        z[1]=2.*dy[0];
+    }
+    void pps(
+        X_Vector const & x,
+        X_Vector const & dx,
+        X_Vector const & dy,
+        X_Vector & z
+    ) const {
+        z[0]=2.*dx[0]*dy[0];
+        z[1]=0.;
+    }
+};
+
+// h(x,y) = [ y x ] >= 0
+//          [ x 1 ]
+//
+// We use a semidefinite cone since its vectors cache decompositions
+struct MyIneq : public Optizelle::VectorValuedFunction <double,Rm,SQL> {
+    void eval(X_Vector const & x,Z_Vector & y) const {
+        y(1,1,1)=x[1];
+        y(1,1,2)=x[0];
+        y(1,2,1)=x[0];
+        y(1,2,2)=1.;
+    }
+    void p(X_Vector const & x,X_Vector const & dx,Z_Vector & y) const {
+        y(1,1,1)=dx[1];
+        y(1,1,2)=dx[0];
+        y(1,2,1)=dx[0];
+        y(1,2,2)=0.;
+    }
+    void ps(X_Vector const & x,Z_Vector const & dy,X_Vector & z) const {
+        z[0]=dy(1,1,2)+dy(1,2,1);
+        z[1]=dy(1,1,1);
+    }
+    void pps(
+        X_Vector const & x,
+        X_Vector const & dx,
+        Z_Vector const & dy,
+        X_Vector & z
+    ) const {
+        X::zero(z);
+    }
+};
+
+// The outcome of a single solve
+struct Result {
+    X_Vector x;
+    Optizelle::StoppingCondition::t opt_stop;
+    Natural iter;
+};
+
+// Grabs the outcome of a solve from its state
+template <typename State>
+Result result(State const & state) {
+    return Result{state.x,state.opt_stop,state.iter};
+}
+
+// A 2x2 semidefinite multiplier
+Z_Vector sdp() {
+    return Z_Vector(
+        std::vector <Optizelle::Cone::t> {Optizelle::Cone::Semidefinite},
+        std::vector <Natural> {2});
+}
+
+// Solves problem k, which cycles through the four problem classes.  All
+// solves share the same messaging object.
+Result solve(Optizelle::Messaging const & msg,Natural const & k) {
+    double const a = data(k);
+    switch(k%4) {
+    case 0: {
+        typedef Optizelle::Unconstrained <double,Rm> Problem;
+        Problem::State::t state(X_Vector{-1.2,1.});
+        state.msg_level = 0;
+        state.H_type = Optizelle::Operators::UserDefined;
+        Problem::Functions::t fns;
+        fns.f.reset(new MyRosenbrock(a));
+        Problem::Algorithms::getMin(msg,fns,state);
+        return result(state);
+    } case 1: {
+        typedef Optizelle::EqualityConstrained <double,Rm,Rm> Problem;
+        Problem::State::t state(X_Vector{2.1,1.1},X_Vector(1));
+        state.msg_level = 0;
+        state.H_type = Optizelle::Operators::UserDefined;
+        Problem::Functions::t fns;
+        fns.f.reset(new MyQuadratic(a));
+        fns.g.reset(new MyEq);
+        Problem::Algorithms::getMin(msg,fns,state);
+        return result(state);
+    } case 2: {
+        typedef Optizelle::InequalityConstrained <double,Rm,SQL> Problem;
+        Problem::State::t state(X_Vector{1.2,3.1},sdp());
+        state.msg_level = 0;
+        state.iter_max = 100;
+        Problem::Functions::t fns;
+        fns.f.reset(new MyLinear(a));
+        fns.h.reset(new MyIneq);
+        Problem::Algorithms::getMin(msg,fns,state);
+        return result(state);
+    } default: {
+        typedef Optizelle::Constrained <double,Rm,Rm,SQL> Problem;
+        Problem::State::t state(X_Vector{0.1,0.5},X_Vector(1),sdp());
+        state.msg_level = 0;
+        state.H_type = Optizelle::Operators::UserDefined;
+        state.iter_max = 100;
+        Problem::Functions::t fns;
+        fns.f.reset(new MyQuadratic(0.5*a));
+        fns.g.reset(new MyEq);
+        fns.h.reset(new MyIneq);
+        Problem::Algorithms::getMin(msg,fns,state);
+        return result(state);
+    }}
+}
+
+// Runs hundreds of solves across all four problem classes concurrently from
+// a pool of threads and checks that each matches the same solve run alone.
+// Build with ENABLE_THREAD_SANITIZER to check for data races.
+int main() {
+    Natural const nprob = 256;
+    Natural const nthreads = 8;
+    Optizelle::Messaging const msg;
+
+    // Solve every problem serially
+    std::vector <Result> serial;
+    for(Natural k=0;k<nprob;k++)
+        serial.emplace_back(solve(msg,k));
+
+    // Solve them again with the threads taking problems as they finish
+    std::vector <Result> concurrent(nprob);
+    std::atomic <Natural> next(0);
+    std::vector <std::thread> pool;
+    for(Natural t=0;t<nthreads;t++)
+        pool.emplace_back([&]() {
+            for(Natural k=next++;k<nprob;k=next++)
+                concurrent[k]=solve(msg,k);
+        });
+    for(auto & thread : pool)
+        thread.join();
+
+    // The concurrent solves match exactly
+    for(Natural k=0;k<nprob;k++) {
+        CHECK(concurrent[k].x == serial[k].x);
+        CHECK(concurrent[k].opt_stop == serial[k].opt_stop);
+        CHECK(concurrent[k].iter == serial[k].iter);
+    }
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
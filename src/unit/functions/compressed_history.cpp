@@ -0,0 +1,127 @@
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "unit.h"
+
+// Create some type shortcuts
+typedef Optizelle::Rm <double> X;
+typedef X::Vector X_Vector;
+using Optizelle::Natural;
+using Optizelle::Rm;
+typedef Optizelle::Unconstrained <double,Rm> Unconstrained;
+
+// f(x,y,z) = (x+1)^2 + 2 (y-1)^2 + 3 (z-2)^2 + 0.1 (xyz)^2
+struct MyObj : public Optizelle::ScalarValuedFunction <double,Rm> {
+    double eval(X_Vector const & x) const {
+        return Optizelle::sq(x[0]+1.)+2.*Optizelle::sq(x[1]-1.)
+            +3.*Optizelle::sq(x[2]-2.)+0.1*Optizelle::sq(x[0]*x[1]*x[2]);
+    }
+    void grad(X_Vector const & x,X_Vector & g) const {
+        double const p = x[0]*x[1]*x[2];
+        g[0]=2.*(x[0]+1.)+0.2*p*x[1]*x[2];
+        g[1]=4.*(x[1]-1.)+0.2*p*x[0]*x[2];
+        g[2]=6.*(x[2]-2.)+0.2*p*x[0]*x[1];
+    }
+    void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+        const
+    {
+        X::zero(H_dx);
+    }
+};
+
+// Solves the problem with a BFGS line search and the given history precision
+// and iteration limit
+void solve(
+    Optizelle::KrylovPrecision::t const & history_precision,
+    Natural const & iter_max,
+    Unconstrained::State::t & state
+) {
+    Optizelle::Messaging msg;
+    state.algorithm_class = Optizelle::AlgorithmClass::LineSearch;
+    state.dir = Optizelle::LineSearchDirection::BFGS;
+    state.stored_history = 5;
+    state.iter_max = iter_max;
+    state.history_precision = history_precision;
+    Unconstrained::Functions::t fns;
+    fns.f.reset(new MyObj);
+    Unconstrained::Algorithms::getMin(msg,fns,state);
+}
+
+// Checks that op gives the same result on the full and compressed histories
+template <typename Operator>
+void check_operator(
+    Unconstrained::State::t const & full,
+    Unconstrained::State::t const & compressed
+) {
+    Optizelle::Messaging msg;
+    X_Vector const dx{0.3,-1.2,0.7};
+    X_Vector result_full(X::init(dx));
+    X_Vector result_compressed(X::init(dx));
+    Operator(msg,full).eval(dx,result_full);
+    Operator(msg,compressed).eval(dx,result_compressed);
+    X_Vector diff(X::init(dx));
+    X::copy(result_full,diff);
+    X::axpy(-1.,result_compressed,diff);
+    CHECK(std::sqrt(X::innr(diff,diff))
+        <= 1e-4 * std::sqrt(X::innr(result_full,result_full)));
+}
+
+// Checks that storing the quasi-Newton history in single precision leaves
+// oldY and oldS empty, gives the same operators up to rounding, and survives
+// a restart
+int main() {
+    // Both precisions converge
+    Unconstrained::State::t full(X_Vector{2.1,-1.1,0.5});
+    Unconstrained::State::t compressed(X_Vector{2.1,-1.1,0.5});
+    solve(Optizelle::KrylovPrecision::Full,100,full);
+    solve(Optizelle::KrylovPrecision::Compressed,100,compressed);
+    using Optizelle::StoppingCondition::RelativeGradientSmall;
+    CHECK(full.opt_stop==RelativeGradientSmall);
+    CHECK(compressed.opt_stop==RelativeGradientSmall);
+
+    // The compressed history lives outside of oldY and oldS
+    CHECK(compressed.oldY.empty());
+    CHECK(compressed.oldS.empty());
+    CHECK(compressed.oldY_compressed.size() > 0);
+    CHECK(compressed.oldY_compressed.size()
+        == compressed.oldS_compressed.size());
+    CHECK(compressed.oldY_compressed.size() <= 5);
+
+    // Compress a copy of a history and compare the operators.  We stop early
+    // since, near the solution, the steps are small enough that rounding them
+    // perturbs the SR1 update by far more than the working precision.
+    Unconstrained::State::t early(X_Vector{2.1,-1.1,0.5});
+    solve(Optizelle::KrylovPrecision::Full,6,early);
+    Unconstrained::State::t copy(early.x);
+    copy.stored_history = early.stored_history;
+    copy.oldY = early.oldY;
+    copy.oldS = early.oldS;
+    copy.history_precision = Optizelle::KrylovPrecision::Compressed;
+    Unconstrained::State::storeHistory(copy);
+    CHECK(copy.oldY.empty());
+    CHECK(copy.oldY_compressed.size() == early.oldY.size());
+    check_operator <Unconstrained::Functions::BFGS> (early,copy);
+    check_operator <Unconstrained::Functions::SR1> (early,copy);
+    check_operator <Unconstrained::Functions::InvBFGS> (early,copy);
+
+    // A restart expands the history and a capture compresses it again
+    Natural const m = compressed.oldY_compressed.size();
+    Unconstrained::Restart::X_Vectors xs;
+    Unconstrained::Restart::Reals reals;
+    Unconstrained::Restart::Naturals nats;
+    Unconstrained::Restart::Params params;
+    Unconstrained::Restart::release(compressed,xs,reals,nats,params);
+    Natural old_y = 0;
+    for(auto const & x : xs)
+        if(x.first.find("oldY_")==0) old_y++;
+    CHECK(old_y == m);
+    Optizelle::Messaging msg;
+    Unconstrained::State::t restored(X_Vector{0.,0.,0.});
+    Unconstrained::Restart::capture(msg,restored,xs,reals,nats,params);
+    CHECK(restored.history_precision==Optizelle::KrylovPrecision::Compressed);
+    CHECK(restored.oldY.empty());
+    CHECK(restored.oldY_compressed.size() == m);
+    CHECK(restored.oldS_compressed.size() == m);
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,219 @@
+#include <map>
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "unit.h"
+
+// Create some type shortcuts
+typedef Optizelle::Rm <double> X;
+typedef X::Vector X_Vector;
+using Optizelle::Natural;
+using Optizelle::Rm;
+
+// Counts how many times we call a function at each point
+struct Counter {
+    std::map <X_Vector,Natural> calls;
+    Natural total;
+    Counter() : calls(), total(0) {}
+    void operator () (X_Vector const & x) {
+        calls[x]++;
+        total++;
+    }
+    Natural repeats() const {
+        return total-calls.size();
+    }
+};
+
+// f(x,y) = (x+1)^2 + (y+1)^2 + 0.1 (xy)^2.  The objective caches its Hessian
+// at each announced iterate and checks that every derivative at the iterate
+// can use it.
+struct MyObj
+    : public Optizelle::ScalarValuedFunction <double,Rm>,
+      public Optizelle::LinearizationSession <double,Rm>
+{
+    mutable Counter evals;
+    mutable Counter grads;
+    Natural linearizations;
+    mutable Natural cached_hessvecs;
+    mutable Natural uncached_hessvecs;
+    X_Vector H;
+    MyObj() : evals(), grads(), linearizations(0), cached_hessvecs(0),
+        uncached_hessvecs(0), H(4) {}
+
+    // Hessian at x
+    static void hessian_at(X_Vector const & x,X_Vector & H) {
+        H[0]=2.+0.2*x[1]*x[1];
+        H[1]=H[2]=0.4*x[0]*x[1];
+        H[3]=2.+0.2*x[0]*x[0];
+    }
+
+    void linearize(X_Vector const & x,Natural const & x_version) {
+        linearizations++;
+        hessian_at(x,H);
+    }
+
+    double eval(X_Vector const & x) const {
+        evals(x);
+        return Optizelle::sq(x[0]+1.)+Optizelle::sq(x[1]+1.)
+            +0.1*Optizelle::sq(x[0]*x[1]);
+    }
+    void grad(X_Vector const & x,X_Vector & g) const {
+        grads(x);
+        g[0]=2.*x[0]+2.+0.2*x[0]*x[1]*x[1];
+        g[1]=2.*x[1]+2.+0.2*x[0]*x[0]*x[1];
+    }
+    void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+        const
+    {
+        X_Vector H_x(4);
+        if(at_iterate(x)) {
+            H_x=H;
+            cached_hessvecs++;
+        } else {
+            hessian_at(x,H_x);
+            uncached_hessvecs++;
+        }
+        H_dx[0]=H_x[0]*dx[0]+H_x[2]*dx[1];
+        H_dx[1]=H_x[1]*dx[0]+H_x[3]*dx[1];
+    }
+};
+
+// g(x,y) = [ x^2 + 2y = 1 ]
+struct MyEq
+    : public Optizelle::VectorValuedFunction <double,Rm,Rm>,
+      public Optizelle::LinearizationSession <double,Rm>
+{
+    mutable Counter evals;
+    Natural linearizations;
+    MyEq() : evals(), linearizations(0) {}
+    void linearize(X_Vector const & x,Natural const & x_version) {
+        linearizations++;
+    }
+    void eval(X_Vector const & x,X_Vector & y) const {
+        evals(x);
+        y[0]=x[0]*x[0]+2.*x[1]-1.;
+    }
+    void p(X_Vector const & x,X_Vector const & dx,X_Vector & y) const {
+        y[0]=2.*x[0]*dx[0]+2.*dx[1];
+    }
+    void ps(X_Vector const & x,X_Vector const & dy,X_Vector & z) const {
+        z[0]=2.*x[0]*dy[0];
+        z[1]=2.*dy[0];
+    }
+    void pps(
+        X_Vector const & x,
+        X_Vector const & dx,
+        X_Vector const & dy,
+        X_Vector & z
+    ) const {
+        z[0]=2.*dx[0]*dy[0];
+        z[1]=0.;
+    }
+};
+
+// h(x,y) = [ 2x + y >= 1 ]
+struct MyIneq : public Optizelle::VectorValuedFunction <double,Rm,Rm> {
+    mutable Counter evals;
+    MyIneq() : evals() {}
+    void eval(X_Vector const & x,X_Vector & y) const {
+        evals(x);
+        y[0]=2.*x[0]+x[1]-1.;
+    }
+    void p(X_Vector const & x,X_Vector const & dx,X_Vector & y) const {
+        y[0]=2.*dx[0]+dx[1];
+    }
+    void ps(X_Vector const & x,X_Vector const & dy,X_Vector & z) const {
+        z[0]=2.*dy[0];
+        z[1]=dy[0];
+    }
+    void pps(
+        X_Vector const & x,
+        X_Vector const & dx,
+        X_Vector const & dy,
+        X_Vector & z
+    ) const {
+        X::zero(z);
+    }
+};
+
+// Solves a constrained problem and returns the final state along with the
+// raw functions.  Optionally, we memoize the functions.
+typedef Optizelle::Constrained <double,Rm,Rm,Rm> Problem;
+void solve(
+    bool const memoize,
+    Problem::State::t & state,
+    MyObj *& f,
+    MyEq *& g,
+    MyIneq *& h,
+    Problem::Functions::t & fns
+) {
+    state.H_type = Optizelle::Operators::UserDefined;
+    state.msg_level = 0;
+    f = new MyObj;
+    g = new MyEq;
+    h = new MyIneq;
+    fns.f.reset(f);
+    fns.g.reset(g);
+    fns.h.reset(h);
+    if(memoize) {
+        fns.f.reset(new Optizelle::MemoizedScalarValuedFunction <double,Rm> (
+            std::move(fns.f),state.x,state.x_version));
+        fns.g.reset(new Optizelle::MemoizedVectorValuedFunction
+            <double,Rm,Rm> (std::move(fns.g),state.x,state.x_version,
+            state.y));
+        fns.h.reset(new Optizelle::MemoizedVectorValuedFunction
+            <double,Rm,Rm> (std::move(fns.h),state.x,state.x_version,
+            state.z));
+    }
+    Problem::Algorithms::getMin(Optizelle::Messaging(),fns,state);
+}
+
+// Checks that the algorithms announce each new iterate exactly once, that the
+// announced iterate is the one passed to the derivatives, and that memoizing
+// the functions removes repeated evaluations without changing the iterates
+int main() {
+    // Solve the problem without memoization
+    Problem::State::t state(X_Vector{2.1,1.1},X_Vector(1),X_Vector(1));
+    Problem::Functions::t fns;
+    MyObj * f; MyEq * g; MyIneq * h;
+    solve(false,state,f,g,h,fns);
+    CHECK(state.opt_stop != Optizelle::StoppingCondition::MaxItersExceeded);
+
+    // We announce the initial iterate and one iterate per iteration.  Since
+    // the iteration count starts at 1, this matches the final count.
+    CHECK(f->linearizations == state.iter);
+    CHECK(g->linearizations == state.iter);
+
+    // Every Hessian-vector product occurs at the announced iterate
+    CHECK(f->cached_hessvecs > 0);
+    CHECK(f->uncached_hessvecs == 0);
+
+    // Make sure that there's something to memoize
+    CHECK(f->grads.repeats() > 0);
+    CHECK(g->evals.repeats() > 0);
+    CHECK(h->evals.repeats() > 0);
+
+    // Solve the problem again with memoization
+    Problem::State::t state_m(X_Vector{2.1,1.1},X_Vector(1),X_Vector(1));
+    Problem::Functions::t fns_m;
+    MyObj * f_m; MyEq * g_m; MyIneq * h_m;
+    solve(true,state_m,f_m,g_m,h_m,fns_m);
+
+    // The wrappers pass the announcements along
+    CHECK(f_m->linearizations == state_m.iter);
+    CHECK(g_m->linearizations == state_m.iter);
+    CHECK(f_m->uncached_hessvecs == 0);
+
+    // We don't repeat anything
+    CHECK(f_m->evals.repeats() == 0);
+    CHECK(f_m->grads.repeats() == 0);
+    CHECK(g_m->evals.repeats() == 0);
+    CHECK(h_m->evals.repeats() == 0);
+
+    // Memoization doesn't change the iterates
+    CHECK(state_m.iter == state.iter);
+    CHECK(state_m.x == state.x);
+    CHECK(f_m->grads.calls.size() == f->grads.calls.size());
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
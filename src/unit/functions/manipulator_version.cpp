@@ -0,0 +1,81 @@
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "unit.h"
+
+// Create some type shortcuts
+typedef Optizelle::Rm <double> X;
+typedef X::Vector X_Vector;
+using Optizelle::Rm;
+typedef Optizelle::InequalityConstrained <double,Rm,Rm> Problem;
+
+// h(x,y) = [ 2x + y >= 1 ]
+struct MyIneq : public Optizelle::VectorValuedFunction <double,Rm,Rm> {
+    void eval(X_Vector const & x,X_Vector & y) const {
+        y[0]=2.*x[0]+x[1]-1.;
+    }
+    void p(X_Vector const & x,X_Vector const & dx,X_Vector & y) const {
+        y[0]=2.*dx[0]+dx[1];
+    }
+    void ps(X_Vector const & x,X_Vector const & dy,X_Vector & z) const {
+        z[0]=2.*dy[0];
+        z[1]=dy[0];
+    }
+    void pps(
+        X_Vector const & x,
+        X_Vector const & dx,
+        X_Vector const & dy,
+        X_Vector & z
+    ) const {
+        X::zero(z);
+    }
+};
+
+// Nudges x toward (1,2) at the end of each iteration and gives x a new
+// version token
+struct Nudge : public Optizelle::StateManipulator <Problem> {
+    void eval(
+        Problem::Functions::t const & fns,
+        Problem::State::t & state,
+        Optizelle::OptimizationLocation::t const & loc
+    ) const {
+        if(loc!=Optizelle::OptimizationLocation::EndOfOptimizationIteration)
+            return;
+        state.x[0]+=0.5*(1.-state.x[0]);
+        state.x[1]+=0.5*(2.-state.x[1]);
+        fns.h->eval(state.x,state.h_x);
+        state.x_version=++state.version;
+    }
+};
+
+// Merit function that we expect at x, which is f(x) - mu log(h(x))
+double expected(X_Vector const & x,double const & f_x,double const & mu) {
+    return f_x - mu*std::log(2.*x[0]+x[1]-1.);
+}
+
+// Checks that the quantities that the inequality constrained problem caches
+// at x follow a manipulator that modifies x
+int main() {
+    // Set up the state at a feasible point
+    Problem::State::t state(X_Vector{3.,3.},X_Vector(1));
+    state.mu = 0.2;
+    Problem::Functions::t fns;
+    fns.h.reset(new MyIneq);
+    fns.f_mod.reset(
+        new Optizelle::ScalarValuedFunctionModifications <double,Rm>);
+    fns.h->eval(state.x,state.h_x);
+    Problem::Functions::InequalityModifications f_mod(state,fns);
+
+    // Cache the merit function at x
+    double const tol = 1e-14;
+    CHECK(std::fabs(f_mod.merit(state.x,1.)
+        - expected(state.x,1.,state.mu)) < tol);
+
+    // Move x with the manipulator and check the merit function again
+    Nudge().eval(fns,state,
+        Optizelle::OptimizationLocation::EndOfOptimizationIteration);
+    CHECK(std::fabs(f_mod.merit(state.x,1.)
+        - expected(state.x,1.,state.mu)) < tol);
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
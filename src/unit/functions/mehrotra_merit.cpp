@@ -0,0 +1,188 @@
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "unit.h"
+
+// Create some type shortcuts
+typedef Optizelle::Rm <double> X;
+typedef X::Vector X_Vector;
+using Optizelle::Natural;
+using Optizelle::Rm;
+typedef Optizelle::InequalityConstrained <double,Rm,Rm> Problem;
+
+// h(x,y) = [ 2x + y >= 1 ]
+struct MyIneq : public Optizelle::VectorValuedFunction <double,Rm,Rm> {
+    void eval(X_Vector const & x,X_Vector & y) const {
+        y[0]=2.*x[0]+x[1]-1.;
+    }
+    void p(X_Vector const & x,X_Vector const & dx,X_Vector & y) const {
+        y[0]=2.*dx[0]+dx[1];
+    }
+    void ps(X_Vector const & x,X_Vector const & dy,X_Vector & z) const {
+        z[0]=2.*dy[0];
+        z[1]=dy[0];
+    }
+    void pps(
+        X_Vector const & x,
+        X_Vector const & dx,
+        X_Vector const & dy,
+        X_Vector & z
+    ) const {
+        X::zero(z);
+    }
+};
+
+// h(x,y) = [ xy >= 1 ]
+struct MyNonlinearIneq : public Optizelle::VectorValuedFunction <double,Rm,Rm>
+{
+    void eval(X_Vector const & x,X_Vector & y) const {
+        y[0]=x[0]*x[1]-1.;
+    }
+    void p(X_Vector const & x,X_Vector const & dx,X_Vector & y) const {
+        y[0]=x[1]*dx[0]+x[0]*dx[1];
+    }
+    void ps(X_Vector const & x,X_Vector const & dy,X_Vector & z) const {
+        z[0]=x[1]*dy[0];
+        z[1]=x[0]*dy[0];
+    }
+    void pps(
+        X_Vector const & x,
+        X_Vector const & dx,
+        X_Vector const & dy,
+        X_Vector & z
+    ) const {
+        z[0]=dx[1]*dy[0];
+        z[1]=dx[0]*dy[0];
+    }
+};
+
+// Sets up a state at a feasible point of xy >= 1
+void setup(
+    Optizelle::InteriorPointMethod::t const & ipm,
+    Problem::State::t & state
+) {
+    state.ipm = ipm;
+    MyNonlinearIneq().eval(state.x,state.h_x);
+    state.z[0] = 0.7;
+    state.mu = 0.2;
+}
+
+// Merit function that we expect at x with a Mehrotra correction z_corr,
+// which is <h'(x)* (inv(L(h(x))) z_corr), x> - mu log(h(x))
+double expected(X_Vector const & x,double const & z_corr,double const & mu) {
+    double const h_x = 2.*x[0]+x[1]-1.;
+    return z_corr/h_x*(2.*x[0]+x[1]) - mu*std::log(h_x);
+}
+
+// Checks that the merit function in a Mehrotra method uses the correction
+// at the current iterate rather than the one that we cached when we last
+// found a step
+void check_current_iterate() {
+    // Set up the state at a feasible point
+    Problem::State::t state(X_Vector{2.1,1.1},X_Vector(1));
+    state.ipm = Optizelle::InteriorPointMethod::Mehrotra;
+    MyIneq h;
+    h.eval(state.x,state.h_x);
+    X::id(state.z);
+    state.z_corr[0] = 0.3;
+    state.mu = 0.2;
+
+    // Set up the modifications
+    Problem::Functions::t fns;
+    fns.h.reset(new MyIneq);
+    fns.f_mod.reset(
+        new Optizelle::ScalarValuedFunctionModifications <double,Rm>);
+    Problem::Functions::InequalityModifications f_mod(state,fns);
+
+    // Find the gradient for the step, which caches the correction
+    X_Vector grad{1.,1.};
+    X_Vector grad_step(X::init(grad));
+    f_mod.grad_step(state.x,grad,grad_step);
+    double const tol = 1e-14;
+    CHECK(std::fabs(f_mod.merit(state.x,0.)
+        - expected(state.x,state.z_corr[0],state.mu)) < tol);
+
+    // Move the iterate, as a manipulator might, without finding a new step
+    state.x = X_Vector{1.5,3.};
+    state.x_version=++state.version;
+    h.eval(state.x,state.h_x);
+    CHECK(std::fabs(f_mod.merit(state.x,0.)
+        - expected(state.x,state.z_corr[0],state.mu)) < tol);
+
+    // Trial points use the correction at the current iterate
+    X_Vector x_trial{1.4,3.2};
+    double const h_x = 2.*state.x[0]+state.x[1]-1.;
+    double const h_trial = 2.*x_trial[0]+x_trial[1]-1.;
+    CHECK(std::fabs(f_mod.merit(x_trial,0.)
+        - (state.z_corr[0]/h_x*(2.*x_trial[0]+x_trial[1])
+            - state.mu*std::log(h_trial))) < tol);
+
+    // Changing the correction changes the merit function
+    state.z_corr[0] = -0.1;
+    CHECK(std::fabs(f_mod.merit(state.x,0.)
+        - expected(state.x,state.z_corr[0],state.mu)) < tol);
+}
+
+// Checks that the Mehrotra merit function differs from the original one by
+// exactly <h'(x)* (inv(L(h(x))) z_corr), x> and that this term matches the
+// change to the gradient that we use to find the step
+void check_original_merit() {
+    // Set up a Mehrotra and a primal-dual state at the same point
+    Problem::State::t mehrotra(X_Vector{2.,1.5},X_Vector(1));
+    Problem::State::t original(X_Vector{2.,1.5},X_Vector(1));
+    setup(Optizelle::InteriorPointMethod::Mehrotra,mehrotra);
+    setup(Optizelle::InteriorPointMethod::PrimalDual,original);
+    mehrotra.z_corr[0] = 0.3;
+
+    // Set up the modifications for each
+    Problem::Functions::t fns_mehrotra;
+    fns_mehrotra.h.reset(new MyNonlinearIneq);
+    fns_mehrotra.f_mod.reset(
+        new Optizelle::ScalarValuedFunctionModifications <double,Rm>);
+    Problem::Functions::InequalityModifications
+        f_mehrotra(mehrotra,fns_mehrotra);
+    Problem::Functions::t fns_original;
+    fns_original.h.reset(new MyNonlinearIneq);
+    fns_original.f_mod.reset(
+        new Optizelle::ScalarValuedFunctionModifications <double,Rm>);
+    Problem::Functions::InequalityModifications
+        f_original(original,fns_original);
+
+    // Find h'(x)* (inv(L(h(x))) z_corr) at the current iterate by hand
+    X_Vector const & x = mehrotra.x;
+    double const h_x = x[0]*x[1]-1.;
+    X_Vector corr{mehrotra.z_corr[0]/h_x*x[1],mehrotra.z_corr[0]/h_x*x[0]};
+
+    // The merit functions differ by the linear term at the iterate and at
+    // trial points, where h differs from h at the iterate
+    double const tol = 1e-13;
+    std::vector <X_Vector> const pts = {
+        x, X_Vector{2.4,1.1}, X_Vector{1.3,2.2}};
+    for(auto const & pt : pts)
+        CHECK(std::fabs(f_mehrotra.merit(pt,1.7) - f_original.merit(pt,1.7)
+            - X::innr(corr,pt)) < tol);
+
+    // The gradient of the linear term is the change to the gradient for the
+    // step
+    X_Vector grad{1.,-2.};
+    X_Vector grad_mehrotra(X::init(grad));
+    X_Vector grad_original(X::init(grad));
+    f_mehrotra.grad_step(x,grad,grad_mehrotra);
+    f_original.grad_step(x,grad,grad_original);
+    X::axpy(-1.,grad_original,grad_mehrotra);
+    X::axpy(-1.,corr,grad_mehrotra);
+    CHECK(std::sqrt(X::innr(grad_mehrotra,grad_mehrotra)) < tol);
+
+    // Without a correction, the merit functions agree
+    mehrotra.z_corr[0] = 0.;
+    for(auto const & pt : pts)
+        CHECK(std::fabs(f_mehrotra.merit(pt,1.7) - f_original.merit(pt,1.7))
+            < tol);
+}
+
+int main() {
+    check_current_iterate();
+    check_original_merit();
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
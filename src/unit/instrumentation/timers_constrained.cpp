@@ -0,0 +1,217 @@
+// This tests that the timers and call counters record the work done during
+// an optimization
+
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "unit.h"
+
+// Squares its input
+template <typename Real>
+Real sq(Real const & x){
+    return x*x; 
+}
+
+// Define a simple objective where 
+// 
+// f(x,y)=(x+1)^2+(y+1)^2
+//
+struct MyObj
+    : public Optizelle::ScalarValuedFunction <double,Optizelle::Rm>
+{
+    typedef Optizelle::Rm <double> X;
+
+    // Evaluation 
+    double eval(const X::Vector& x) const {
+        return sq(x[0]+1.)+sq(x[1]+1.);
+    }
+
+    // Gradient
+    void grad(
+        const X::Vector& x,
+        X::Vector& g
+    ) const {
+        g[0]=2*x[0]+2;
+        g[1]=2*x[1]+2;
+    }
+
+    // Hessian-vector product
+    void hessvec(
+        const X::Vector& x,
+        const X::Vector& dx,
+        X::Vector& H_dx
+    ) const {
+        H_dx[0]=2.*dx[0]; 
+        H_dx[1]=2.*dx[1]; 
+    }
+};
+
+// Define a simple equality
+//
+// g(x,y)= [ x + 2y = 1 ] 
+//
+struct MyEq
+    :public Optizelle::VectorValuedFunction<double,Optizelle::Rm,Optizelle::Rm>
+{
+    typedef Optizelle::Rm <double> X;
+    typedef Optizelle::Rm <double> Y;
+
+    // y=g(x) 
+    void eval(
+        const X::Vector& x,
+        Y::Vector& y
+    ) const {
+        y[0]=x[0]+2.*x[1]-1.;
+    }
+
+    // y=g'(x)dx
+    void p(
+        const X::Vector& x,
+        const X::Vector& dx,
+        Y::Vector& y
+    ) const {
+        y[0]= dx[0]+2.*dx[1];
+    }
+
+    // z=g'(x)*dy
+    void ps(
+        const X::Vector& x,
+        const Y::Vector& dy,
+        X::Vector& z
+    ) const {
+        z[0]= dy[0];
+        z[1]= 2.*dy[0];
+    }
+
+    // z=(g''(x)dx)*dy
+    void pps(
+        const X::Vector& x,
+        const X::Vector& dx,
+        const Y::Vector& dy,
+        X::Vector& z
+    ) const {
+        X::zero(z);
+    }
+};
+
+// Define a simple inequality
+//
+// h(x,y)= [ 2x + y >= 1 ] 
+//
+struct MyIneq
+    :public Optizelle::VectorValuedFunction<double,Optizelle::Rm,Optizelle::Rm>
+{
+    typedef Optizelle::Rm <double> X;
+    typedef Optizelle::Rm <double> Y;
+
+    // y=h(x) 
+    void eval(
+        const X::Vector& x,
+        Y::Vector& y
+    ) const {
+        y[0]=2.*x[0]+x[1]-1.;
+    }
+
+    // y=h'(x)dx
+    void p(
+        const X::Vector& x,
+        const X::Vector& dx,
+        Y::Vector& y
+    ) const {
+        y[0]= 2.*dx[0]+dx[1];
+    }
+
+    // z=h'(x)*dy
+    void ps(
+        const X::Vector& x,
+        const Y::Vector& dy,
+        X::Vector& z
+    ) const {
+        z[0]= 2.*dy[0];
+        z[1]= dy[0];
+    }
+
+    // z=(h''(x)dx)*dy
+    void pps(
+        const X::Vector& x,
+        const X::Vector& dx,
+        const Y::Vector& dy,
+        X::Vector& z
+    ) const {
+        X::zero(z);
+    }
+};
+
+int main() {
+    // Create a type shortcut
+    using Optizelle::Rm;
+
+    // Generate an initial guess for the primal and the multipliers
+    std::vector <double> x = {2.1,1.1};
+    std::vector <double> y(1);
+    std::vector <double> z(1);
+
+    // Create an optimization state
+    Optizelle::Constrained <double,Rm,Rm,Rm>::State::t state(x,y,z);
+    state.H_type = Optizelle::Operators::UserDefined;
+    state.msg_level = 0;
+
+    // Create a bundle of functions
+    Optizelle::Constrained <double,Rm,Rm,Rm>::Functions::t fns;
+    fns.f.reset(new MyObj);
+    fns.g.reset(new MyEq);
+    fns.h.reset(new MyIneq);
+
+    // Solve the optimization problem
+    Optizelle::Constrained <double,Rm,Rm,Rm>::Algorithms
+        ::getMin(Optizelle::Messaging(),fns,state);
+    CHECK(state.opt_stop != Optizelle::StoppingCondition::NotConverged);
+
+    // Check that we counted the calls to the user functions and kernels
+    CHECK(state.f_eval_calls > 0);
+    CHECK(state.f_grad_calls > 0);
+    CHECK(state.f_hessvec_calls > 0);
+    CHECK(state.krylov_calls > 0);
+    CHECK(state.g_eval_calls > 0);
+    CHECK(state.g_p_calls > 0);
+    CHECK(state.g_ps_calls > 0);
+    CHECK(state.h_eval_calls > 0);
+    CHECK(state.h_p_calls > 0);
+    CHECK(state.h_ps_calls > 0);
+    CHECK(state.cone_calls > 0);
+
+    // Check that the timers are sensible
+    CHECK(state.f_eval_time >= 0.);
+    CHECK(state.f_grad_time >= 0.);
+    CHECK(state.f_hessvec_time >= 0.);
+    CHECK(state.krylov_time >= 0.);
+    CHECK(state.g_eval_time >= 0.);
+    CHECK(state.h_eval_time >= 0.);
+    CHECK(state.cone_time >= 0.);
+
+    // Solving a second time continues to accumulate the counters rather than
+    // restarting them
+    Optizelle::Natural f_eval_calls = state.f_eval_calls;
+    state.opt_stop = Optizelle::StoppingCondition::NotConverged;
+    Optizelle::Constrained <double,Rm,Rm,Rm>::Algorithms
+        ::getMin(Optizelle::Messaging(),fns,state);
+    CHECK(state.f_eval_calls > f_eval_calls);
+
+    // Make sure the counters survive a release and capture
+    Optizelle::Constrained <double,Rm,Rm,Rm>::Restart::X_Vectors xs;
+    Optizelle::Constrained <double,Rm,Rm,Rm>::Restart::Y_Vectors ys;
+    Optizelle::Constrained <double,Rm,Rm,Rm>::Restart::Z_Vectors zs;
+    Optizelle::Constrained <double,Rm,Rm,Rm>::Restart::Reals reals;
+    Optizelle::Constrained <double,Rm,Rm,Rm>::Restart::Naturals nats;
+    Optizelle::Constrained <double,Rm,Rm,Rm>::Restart::Params params;
+    Optizelle::Natural cone_calls = state.cone_calls;
+    double f_grad_time = state.f_grad_time;
+    Optizelle::Constrained <double,Rm,Rm,Rm>::Restart
+        ::release(state,xs,ys,zs,reals,nats,params);
+    Optizelle::Constrained <double,Rm,Rm,Rm>::Restart
+        ::capture(Optizelle::Messaging(),state,xs,ys,zs,reals,nats,params);
+    CHECK(state.cone_calls == cone_calls);
+    CHECK(state.f_grad_time == f_grad_time);
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,171 @@
+// This tests that, after the first couple of iterations, the unconstrained
+// optimization loop reuses its workspace rather than allocate new vectors,
+// whether or not we print diagnostics
+
+#include <functional>
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "unit.h"
+
+// Create some type shortcuts
+using Optizelle::Natural;
+
+// Rm, but we count the number of times that we allocate a vector
+template <typename Real>
+struct CountedRm : public Optizelle::Rm <Real> {
+    typedef typename Optizelle::Rm <Real>::Vector Vector;
+
+    // Number of vectors that we've allocated
+    static Natural inits;
+
+    // Memory allocation and size setting
+    static Vector init(Vector const & x) {
+        inits++;
+        return Optizelle::Rm <Real>::init(x);
+    }
+};
+template <typename Real>
+Natural CountedRm <Real>::inits = 0;
+
+// More type shortcuts
+typedef CountedRm <double> X;
+typedef X::Vector X_Vector;
+typedef Optizelle::Unconstrained <double,CountedRm> Problem;
+
+// Extended Rosenbrock function
+//
+// f(x) = sum_i 100 (x_{i+1}-x_i^2)^2 + (1-x_i)^2
+//
+struct Rosenbrock : public Optizelle::ScalarValuedFunction <double,CountedRm> {
+    double eval(X_Vector const & x) const {
+        double f(0.);
+        for(Natural i=0;i+1<x.size();i++)
+            f+=100.*Optizelle::sq(x[i+1]-x[i]*x[i])+Optizelle::sq(1.-x[i]);
+        return f;
+    }
+    void grad(X_Vector const & x,X_Vector & g) const {
+        X::zero(g);
+        for(Natural i=0;i+1<x.size();i++) {
+            g[i]+=-400.*x[i]*(x[i+1]-x[i]*x[i])-2.*(1.-x[i]);
+            g[i+1]+=200.*(x[i+1]-x[i]*x[i]);
+        }
+    }
+    void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+        const
+    {
+        X::zero(H_dx);
+        for(Natural i=0;i+1<x.size();i++) {
+            H_dx[i]+=(1200.*x[i]*x[i]-400.*x[i+1]+2.)*dx[i]
+                -400.*x[i]*dx[i+1];
+            H_dx[i+1]+=-400.*x[i]*dx[i]+200.*dx[i+1];
+        }
+    }
+};
+
+// Records the number of allocations at the end of each iteration.  When the
+// user defines the step, we take a short steepest descent step.
+struct CountAllocations : public Optizelle::StateManipulator <Problem> {
+    mutable std::vector <Natural> inits;
+    CountAllocations() : inits() {}
+    void eval(
+        Problem::Functions::t const & fns,
+        Problem::State::t & state,
+        Optizelle::OptimizationLocation::t const & loc
+    ) const {
+        switch(loc) {
+        case Optizelle::OptimizationLocation::GetStep: {
+            X::copy(state.grad,state.dx);
+            X::scal(-1e-4,state.dx);
+            std::vector <double> x_p_dx(state.x);
+            X::axpy(1.,state.dx,x_p_dx);
+            state.f_xpdx=fns.f->eval(x_p_dx);
+            break;
+        } case Optizelle::OptimizationLocation::EndOfOptimizationIteration:
+            inits.push_back(X::inits);
+            break;
+        default:
+            break;
+        }
+    }
+};
+
+// Discards the diagnostics
+struct Quiet : public Optizelle::Messaging {
+    void print(std::string const & msg) const {}
+};
+
+// Solves the problem with the settings in setup and checks that we don't
+// allocate anything after the second iteration.  We check both without any
+// output and with the most detailed output, which also reports on the
+// Krylov and line-search iterations.
+void check(std::function <void(Problem::State::t &)> const & setup) {
+    for(Natural msg_level : {0,3}) {
+        Problem::State::t state(X_Vector(10,-1.2));
+        state.msg_level = msg_level;
+        state.iter_max = 8;
+        setup(state);
+        Problem::Functions::t fns;
+        fns.f.reset(new Rosenbrock);
+        CountAllocations counter;
+        Problem::Algorithms::getMin(Quiet(),fns,state,counter);
+        CHECK(counter.inits.size() == state.iter_max-1);
+        CHECK(counter.inits.back() == counter.inits[1]);
+    }
+}
+
+int main() {
+    // Trust-region methods with each of the Krylov methods and with the
+    // quasi-Newton Hessian approximations
+    check([](Problem::State::t & state) {
+        state.algorithm_class = Optizelle::AlgorithmClass::TrustRegion;
+        state.H_type = Optizelle::Operators::UserDefined;
+    });
+    check([](Problem::State::t & state) {
+        state.algorithm_class = Optizelle::AlgorithmClass::TrustRegion;
+        state.H_type = Optizelle::Operators::UserDefined;
+        state.krylov_solver = Optizelle::KrylovSolverTruncated::MINRES;
+    });
+    check([](Problem::State::t & state) {
+        state.algorithm_class = Optizelle::AlgorithmClass::TrustRegion;
+        state.H_type = Optizelle::Operators::BFGS;
+        state.stored_history = 4;
+    });
+    check([](Problem::State::t & state) {
+        state.algorithm_class = Optizelle::AlgorithmClass::TrustRegion;
+        state.H_type = Optizelle::Operators::SR1;
+        state.PH_type = Optizelle::Operators::InvSR1;
+        state.stored_history = 4;
+    });
+
+    // Line-search methods with each direction and kind of line-search.  We
+    // skip Brent's line-search since it isn't implemented.
+    for(auto dir : {
+        Optizelle::LineSearchDirection::SteepestDescent,
+        Optizelle::LineSearchDirection::FletcherReeves,
+        Optizelle::LineSearchDirection::PolakRibiere,
+        Optizelle::LineSearchDirection::HestenesStiefel,
+        Optizelle::LineSearchDirection::BFGS,
+        Optizelle::LineSearchDirection::NewtonCG
+    })
+        for(auto kind : {
+            Optizelle::LineSearchKind::GoldenSection,
+            Optizelle::LineSearchKind::BackTracking,
+            Optizelle::LineSearchKind::TwoPointA,
+            Optizelle::LineSearchKind::TwoPointB
+        })
+            check([&](Problem::State::t & state) {
+                state.algorithm_class = Optizelle::AlgorithmClass::LineSearch;
+                state.H_type = Optizelle::Operators::UserDefined;
+                state.dir = dir;
+                state.kind = kind;
+                state.stored_history = 4;
+            });
+
+    // Steps that the user defines
+    check([](Problem::State::t & state) {
+        state.algorithm_class = Optizelle::AlgorithmClass::UserDefined;
+    });
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
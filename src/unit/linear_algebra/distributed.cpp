@@ -0,0 +1,262 @@
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/distributed.h"
+#include "unit.h"
+
+// Create some type shortcuts
+using Optizelle::Natural;
+using Optizelle::Rm;
+using Optizelle::SQL;
+using Optizelle::DistributedRm;
+using Optizelle::DistributedSQL;
+typedef Optizelle::Communicator <double> Communicator;
+typedef Optizelle::DistributedRm <double> XD;
+typedef XD::Vector XD_Vector;
+
+// Grabs the piece of the global vector x that belongs to this rank
+XD_Vector scatter(Communicator const & comm,std::vector <double> const & x) {
+    auto range = XD::partition(x.size(),comm);
+    return XD_Vector(comm,std::vector <double> (
+        x.begin()+range.first,x.begin()+range.second));
+}
+
+// f(x) = sum_i (1+i)/2 (x_i-1)^2 + 1/4 x_i^4
+struct MyObj : public Optizelle::ScalarValuedFunction <double,DistributedRm> {
+    // Global index of the first element on this rank
+    Natural const begin;
+    explicit MyObj(Natural const & begin_) : begin(begin_) {}
+
+    double eval(XD_Vector const & x) const {
+        double z(0.);
+        for(Natural i=0;i<x.local.size();i++)
+            z+=0.5*double(1+begin+i)*Optizelle::sq(x.local[i]-1.)
+                +0.25*Optizelle::sq(Optizelle::sq(x.local[i]));
+        x.comm->allreduce_sum(&z,1);
+        return z;
+    }
+    void grad(XD_Vector const & x,XD_Vector & g) const {
+        for(Natural i=0;i<x.local.size();i++)
+            g.local[i]=double(1+begin+i)*(x.local[i]-1.)
+                +x.local[i]*x.local[i]*x.local[i];
+    }
+    void hessvec(XD_Vector const & x,XD_Vector const & dx,XD_Vector & H_dx)
+        const
+    {
+        for(Natural i=0;i<x.local.size();i++)
+            H_dx.local[i]=(double(1+begin+i)+3.*x.local[i]*x.local[i])
+                *dx.local[i];
+    }
+};
+
+// h(x) = x - l >= 0 where l_i = 1.2 for even i and 0 otherwise
+struct MyIneq :
+    public Optizelle::VectorValuedFunction <double,DistributedRm,DistributedRm>
+{
+    // Global index of the first element on this rank
+    Natural const begin;
+    explicit MyIneq(Natural const & begin_) : begin(begin_) {}
+
+    void eval(XD_Vector const & x,XD_Vector & y) const {
+        for(Natural i=0;i<x.local.size();i++)
+            y.local[i]=x.local[i]-((begin+i)%2==0 ? 1.2 : 0.);
+    }
+    void p(XD_Vector const & x,XD_Vector const & dx,XD_Vector & y) const {
+        XD::copy(dx,y);
+    }
+    void ps(XD_Vector const & x,XD_Vector const & dy,XD_Vector & z) const {
+        XD::copy(dy,z);
+    }
+    void pps(
+        XD_Vector const & x,
+        XD_Vector const & dx,
+        XD_Vector const & dy,
+        XD_Vector & z
+    ) const {
+        XD::zero(z);
+    }
+};
+
+// Solution of each problem class on one rank
+struct Result {
+    std::vector <double> x;
+    Natural iter;
+};
+
+// Solves the unconstrained and inequality constrained problems on p ranks
+// and gathers the solution from each rank in rank order
+std::vector <std::vector <Result> > solve(Natural const & n,Natural const & p) {
+    std::vector <std::vector <Result> > results(p,std::vector <Result> (2));
+    Optizelle::runLocalRanks <double> (p,[&](Communicator const & comm) {
+        Optizelle::Messaging msg;
+        Natural const begin = XD::partition(n,comm).first;
+        std::vector <double> x0(n,2.);
+
+        {
+            typedef Optizelle::Unconstrained <double,DistributedRm> Problem;
+            Problem::State::t state(scatter(comm,x0));
+            state.msg_level = 0;
+            state.H_type = Optizelle::Operators::UserDefined;
+            Problem::Functions::t fns;
+            fns.f.reset(new MyObj(begin));
+            Problem::Algorithms::getMin(msg,fns,state);
+            results[comm.rank()][0] = Result{state.x.local,state.iter};
+        }
+
+        {
+            typedef Optizelle::InequalityConstrained
+                <double,DistributedRm,DistributedRm> Problem;
+            Problem::State::t state(scatter(comm,x0),
+                scatter(comm,std::vector <double> (n,0.)));
+            state.msg_level = 0;
+            state.H_type = Optizelle::Operators::UserDefined;
+            Problem::Functions::t fns;
+            fns.f.reset(new MyObj(begin));
+            fns.h.reset(new MyIneq(begin));
+            Problem::Algorithms::getMin(msg,fns,state);
+            results[comm.rank()][1] = Result{state.x.local,state.iter};
+        }
+    });
+    return results;
+}
+
+// Checks that the distributed vector spaces reduce over all of the ranks
+// and give every rank the same result, and that the solves don't depend on
+// the number of ranks
+int main() {
+    // Create some type shortcuts
+    typedef Optizelle::Rm <double> X;
+    typedef Optizelle::SQL <double> Z;
+    typedef Optizelle::DistributedSQL <double> ZD;
+
+    // Create global vectors that don't divide evenly over the ranks
+    Natural const n = 11;
+    Natural const p = 3;
+    std::vector <double> x(n), y(n), dy(n);
+    for(Natural i=0;i<n;i++) {
+        x[i] = 2.+sin(double(i));
+        y[i] = 2.+cos(double(i));
+        dy[i] = cos(double(3*i));
+    }
+
+    // Reduce over the pieces and gather the elementwise operations
+    std::vector <std::vector <double> > reductions(p);
+    std::vector <double> z(n);
+    Optizelle::runLocalRanks <double> (p,[&](Communicator const & comm) {
+        XD_Vector xd(scatter(comm,x));
+        XD_Vector yd(scatter(comm,y));
+        XD_Vector dyd(scatter(comm,dy));
+        XD_Vector zd(XD::init(xd));
+        XD::copy(yd,zd);
+        XD::axpy(2.,xd,zd);
+        XD::prod(xd,zd,zd);
+        XD::linv(yd,zd,zd);
+        auto range = XD::partition(n,comm);
+        std::copy(zd.local.begin(),zd.local.end(),z.begin()+range.first);
+        reductions[comm.rank()] = {
+            XD::innr(xd,yd),XD::barr(xd),XD::srch(dyd,yd)};
+    });
+
+    // Find the same quantities without distributing the vectors
+    std::vector <double> z_rm(X::init(y));
+    X::copy(y,z_rm);
+    X::axpy(2.,x,z_rm);
+    X::prod(x,z_rm,z_rm);
+    X::linv(y,z_rm,z_rm);
+    CHECK(z == z_rm);
+    for(Natural r=0;r<p;r++)
+        CHECK(reductions[r] == reductions[0]);
+    double const tol = 1e-14;
+    CHECK(std::fabs(reductions[0][0]-X::innr(x,y)) < tol*X::innr(x,y));
+    CHECK(std::fabs(reductions[0][1]-X::barr(x)) < tol*std::fabs(X::barr(x)));
+    CHECK(reductions[0][2] == X::srch(dy,y));
+
+    // Create a mix of cones and split them by blocks over two ranks
+    std::vector <Optizelle::Cone::t> types = {
+        Optizelle::Cone::Linear,
+        Optizelle::Cone::Quadratic,
+        Optizelle::Cone::Semidefinite,
+        Optizelle::Cone::Linear};
+    std::vector <Natural> sizes = {3,4,3,2};
+    Natural const split = 2;
+    auto fill = [](Z::Vector & x,Z::Vector & y,Z::Vector & dy,
+        Natural const & blk0)
+    {
+        for(Natural blk=1;blk<=x.types.size();blk++) {
+            Natural m=x.sizes[blk-1];
+            Natural gblk=blk0+blk;
+            if(x.types[blk-1]==Optizelle::Cone::Semidefinite) {
+                for(Natural j=1;j<=m;j++)
+                    for(Natural i=1;i<=m;i++) {
+                        x(blk,i,j)= i==j ? 2. : 0.;
+                        y(blk,i,j)= i==j ? 3. : 0.;
+                        dy(blk,i,j)= i==j ? -1. : 0.;
+                    }
+            } else if(x.types[blk-1]==Optizelle::Cone::Linear) {
+                for(Natural i=1;i<=m;i++) {
+                    x(blk,i)=2.+sin(double(gblk+i));
+                    y(blk,i)=2.+cos(double(gblk*i));
+                    dy(blk,i)=cos(double(gblk+3*i));
+                }
+            } else
+                for(Natural i=1;i<=m;i++) {
+                    x(blk,i)= i==1 ? double(m)+1. : sin(double(gblk+i));
+                    y(blk,i)= i==1 ? double(m)+2. : cos(double(gblk*i));
+                    dy(blk,i)= i==1 ? -2. : cos(double(gblk+3*i));
+                }
+        }
+    };
+    std::vector <std::vector <double> > sql_reductions(2);
+    Optizelle::runLocalRanks <double> (2,[&](Communicator const & comm) {
+        Natural const blk0 = comm.rank()==0 ? 0 : split;
+        std::vector <Optizelle::Cone::t> my_types(
+            types.begin()+blk0,
+            comm.rank()==0 ? types.begin()+split : types.end());
+        std::vector <Natural> my_sizes(
+            sizes.begin()+blk0,
+            comm.rank()==0 ? sizes.begin()+split : sizes.end());
+        ZD::Vector xd(comm,Z::Vector(my_types,my_sizes));
+        ZD::Vector yd(ZD::init(xd));
+        ZD::Vector dyd(ZD::init(xd));
+        fill(xd.local,yd.local,dyd.local,blk0);
+        sql_reductions[comm.rank()] = {
+            ZD::innr(xd,yd),ZD::barr(xd),ZD::srch(dyd,yd)};
+    });
+    Z::Vector xs(types,sizes);
+    Z::Vector ys(Z::init(xs));
+    Z::Vector dys(Z::init(xs));
+    fill(xs,ys,dys,0);
+    CHECK(sql_reductions[0] == sql_reductions[1]);
+    CHECK(std::fabs(sql_reductions[0][0]-Z::innr(xs,ys))
+        < tol*Z::innr(xs,ys));
+    CHECK(std::fabs(sql_reductions[0][1]-Z::barr(xs))
+        < tol*std::fabs(Z::barr(xs)));
+    CHECK(std::fabs(sql_reductions[0][2]-Z::srch(dys,ys))
+        < tol*Z::srch(dys,ys));
+
+    // Solve the problems on one rank and then on several.  The sums in the
+    // reductions round differently with more ranks.  The interior point
+    // method stops while the barrier parameter is still around 1e-6, so
+    // there, the solutions only agree to about that level.
+    Natural const nsolve = 20;
+    std::vector <double> const sol_tol = {1e-10,1e-4};
+    auto serial = solve(nsolve,1);
+    for(Natural np : {2,4}) {
+        auto dist = solve(nsolve,np);
+        for(Natural k=0;k<2;k++) {
+            std::vector <double> x_dist;
+            for(Natural r=0;r<np;r++) {
+                CHECK(dist[r][k].iter == dist[0][k].iter);
+                x_dist.insert(x_dist.end(),
+                    dist[r][k].x.begin(),dist[r][k].x.end());
+            }
+            std::vector <double> const & x_serial = serial[0][k].x;
+            CHECK(x_dist.size() == nsolve);
+            X::axpy(-1.,x_serial,x_dist);
+            CHECK(std::sqrt(X::innr(x_dist,x_dist))
+                < sol_tol[k]*std::sqrt(X::innr(x_serial,x_serial)));
+        }
+    }
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,74 @@
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/linalg.h"
+#include "linear_algebra.h"
+#include "unit.h"
+
+// Checks that continuing a GMRES solve with a tighter tolerance gives the
+// same solution as a solve from scratch and that, together, the two solves
+// take the same number of iterations
+int main() {
+    // Create a type shortcut
+    typedef Optizelle::Rm <double> X;
+
+    // Set the size of the problem
+    Natural m = 20;
+
+    // Set the maximum number of iterations
+    Natural iter_max = 200;
+
+    // Create some nonsymmetric operator
+    BasicOperator <double> A(m);
+    for(Natural i=1;i<=m*m;i++)
+        A.A[i-1]=cos(pow(i,2));
+    for(Natural i=1;i<=m;i++)
+        A.A[(i-1)+m*(i-1)]+=double(m)/4.;
+
+    // Create some right hand side
+    std::vector <double> b(m);
+    for(Natural i=1;i<=m;i++) b[i-1] = cos(i+25);
+
+    // Create empty preconditioners
+    IdentityOperator <double> Ml_inv;
+    IdentityOperator <double> Mr_inv;
+
+    // Create an empty GMRES manipulator
+    Optizelle::EmptyGMRESManipulator <double,Optizelle::Rm> gmanip;
+
+    // Try without restarts and with restarts that land in the middle of the
+    // solve
+    for(Natural rst_freq : {0,7}) {
+        // Solve loosely and then continue with a tighter tolerance
+        std::vector <double> x(m);
+        X::zero(x);
+        Optizelle::GMRESState <double,Optizelle::Rm> gstate(x);
+        Natural iter_loose = Optizelle::gmres <double,Optizelle::Rm> (
+            A,b,1e-3,iter_max,rst_freq,Ml_inv,Mr_inv,gmanip,x,gstate).second;
+        X::zero(x);
+        Natural iter_tight = Optizelle::gmres <double,Optizelle::Rm> (
+            A,b,1e-10,iter_max,rst_freq,Ml_inv,Mr_inv,gmanip,x,gstate).second;
+
+        // Solve with the tighter tolerance from scratch
+        std::vector <double> x_scratch(m);
+        X::zero(x_scratch);
+        Natural iter_scratch = Optizelle::gmres <double,Optizelle::Rm> (
+            A,b,1e-10,iter_max,rst_freq,Ml_inv,Mr_inv,gmanip,x_scratch
+        ).second;
+
+        // Both solves did some work, the solutions match exactly, and we
+        // didn't repeat any iterations
+        CHECK(iter_loose > 0);
+        CHECK(iter_tight > 0);
+        CHECK(x == x_scratch);
+        CHECK(iter_loose + iter_tight == iter_scratch);
+
+        // Continuing with a looser tolerance doesn't do any more work
+        Natural iter_again = Optizelle::gmres <double,Optizelle::Rm> (
+            A,b,1e-3,iter_max,rst_freq,Ml_inv,Mr_inv,gmanip,x,gstate).second;
+        CHECK(iter_again == 0);
+        CHECK(x == x_scratch);
+    }
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
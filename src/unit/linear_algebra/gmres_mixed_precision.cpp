@@ -0,0 +1,77 @@
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/linalg.h"
+#include "linear_algebra.h"
+#include "unit.h"
+
+// Checks that GMRES run with single-precision iterations and iterative
+// refinement reaches the same accuracy as the double-precision solve
+int main() {
+    // Create a type shortcut
+    typedef Optizelle::Rm <double> X;
+
+    // Set the size of the problem
+    Natural m = 20;
+
+    // Set the stopping tolerance
+    double eps_krylov = 1e-12;
+
+    // Set the maximum number of iterations
+    Natural iter_max = 200;
+
+    // Set how often we restart GMRES
+    Natural rst_freq = 0;
+
+    // Create some nonsymmetric operator 
+    BasicOperator <double> A(m);
+    for(Natural i=1;i<=m*m;i++)
+        A.A[i-1]=cos(pow(i,2));
+    for(Natural i=1;i<=m;i++)
+        A.A[(i-1)+m*(i-1)]+=double(m);
+    
+    // Create some right hand side
+    std::vector <double> b(m);
+    for(Natural i=1;i<=m;i++) b[i-1] = cos(i+25); 
+    
+    // Create empty preconditioners
+    IdentityOperator <double> Ml_inv;
+    IdentityOperator <double> Mr_inv;
+
+    // Create an initial guess at the solution
+    std::vector <double> x(m);
+    X::zero (x);
+    std::vector <double> x_full(m);
+    X::zero (x_full);
+
+    // Create an empty GMRES manipulator
+    Optizelle::EmptyGMRESManipulator <double,Optizelle::Rm> gmanip;
+
+    // Solve this linear system in mixed and full precision
+    std::pair <double,Natural> err_iter =
+        Optizelle::MixedPrecision <double,Optizelle::Rm>::gmres(
+            Optizelle::KrylovPrecision::Mixed,
+            A,b,eps_krylov,iter_max,rst_freq,Ml_inv,Mr_inv,gmanip,x);
+    Optizelle::MixedPrecision <double,Optizelle::Rm>::gmres(
+        Optizelle::KrylovPrecision::Full,
+        A,b,eps_krylov,iter_max,rst_freq,Ml_inv,Mr_inv,gmanip,x_full);
+
+    // Check the error is less than our tolerance 
+    CHECK(err_iter.first < eps_krylov);
+
+    // Check the true residual as well
+    std::vector <double> residual(m);
+    A.eval(x,residual);
+    X::axpy(-1.,b,residual);
+    CHECK(std::sqrt(X::innr(residual,residual))
+        < 10.*eps_krylov*std::sqrt(X::innr(b,b)));
+
+    // Check the relative error between the two solutions
+    X::copy(x_full,residual);
+    X::axpy(-1.,x,residual);
+    double err=std::sqrt(X::innr(residual,residual))
+        /(1+sqrt(X::innr(x_full,x_full)));
+    CHECK(err < 1e-12);
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
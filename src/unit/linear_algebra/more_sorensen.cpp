@@ -0,0 +1,185 @@
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/linalg.h"
+#include "unit.h"
+
+// Create some type shortcuts
+typedef Optizelle::Rm <double> X;
+typedef X::Vector X_Vector;
+using Optizelle::Natural;
+using Optizelle::Rm;
+using Optizelle::ijtok;
+
+// Checks the optimality conditions of the trust-region subproblem,
+//
+// (H + lambda I) d = -g, lambda >= 0, || d || <= delta,
+// lambda (delta - || d ||) = 0, and H + lambda I positive semidefinite.
+void check_optimality(
+    Natural const & m,
+    std::vector <double> const & H,
+    std::vector <double> const & g,
+    double const & delta,
+    std::vector <double> const & d,
+    double const & lambda,
+    bool const & boundary,
+    double const & lambda_min
+) {
+    // r <- (H + lambda I) d + g
+    std::vector <double> r(g);
+    Optizelle::gemv <double> ('N',m,m,1.,&(H[0]),m,&(d[0]),1,1.,&(r[0]),1);
+    Optizelle::axpy <double> (m,lambda,&(d[0]),1,&(r[0]),1);
+    double const norm_g = std::sqrt(Optizelle::dot <double> (m,&(g[0]),1,
+        &(g[0]),1));
+    double const norm_d = std::sqrt(Optizelle::dot <double> (m,&(d[0]),1,
+        &(d[0]),1));
+    CHECK(std::sqrt(Optizelle::dot <double> (m,&(r[0]),1,&(r[0]),1))
+        <= 1e-8*(1.+norm_g));
+    CHECK(lambda >= 0.);
+    CHECK(norm_d <= delta*(1.+1e-12));
+    CHECK(!boundary || std::fabs(norm_d-delta) <= 1e-7*delta);
+    CHECK(boundary || lambda == 0.);
+    CHECK(lambda_min+lambda >= -1e-10);
+}
+
+// f(x) = 1/2 <Ax,x> + <b,x> with a dense Hessian
+struct Quadratic : public Optizelle::ScalarValuedFunction <double,Rm> {
+    Natural m;
+    std::vector <double> A;
+    std::vector <double> b;
+    mutable Natural hessians;
+    Quadratic(Natural const & m_) : m(m_), A(m_*m_), b(m_), hessians(0) {
+        for(Natural j=1;j<=m;j++) {
+            for(Natural i=1;i<=m;i++)
+                A[ijtok(i,j,m)]= i==j ? 2.+double(i) : 1./double(i+j);
+            b[j-1]=std::cos(double(j));
+        }
+    }
+    double eval(X_Vector const & x) const {
+        X_Vector Ax(m);
+        Optizelle::symv <double> ('U',m,1.,&(A[0]),m,&(x[0]),1,0.,&(Ax[0]),1);
+        return .5*X::innr(Ax,x)+X::innr(b,x);
+    }
+    void grad(X_Vector const & x,X_Vector & g) const {
+        X::copy(b,g);
+        Optizelle::symv <double> ('U',m,1.,&(A[0]),m,&(x[0]),1,1.,&(g[0]),1);
+    }
+    void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+        const
+    {
+        Optizelle::symv <double> ('U',m,1.,&(A[0]),m,&(dx[0]),1,0.,
+            &(H_dx[0]),1);
+    }
+    bool hessian(X_Vector const & x,std::vector <double> & H) const {
+        hessians++;
+        H = A;
+        return true;
+    }
+};
+
+// Checks the Moré-Sorensen trust-region subproblem solver on the interior,
+// boundary, indefinite, and hard cases, and then checks that the
+// trust-region method uses it when the objective provides a dense Hessian
+int main() {
+    Natural const iter_max = 50;
+    double const tol = 1e-10;
+    std::vector <double> d;
+    double lambda(0.);
+    bool boundary(false);
+
+    // H positive definite with the Newton step inside the trust-region and
+    // then, with smaller radii, on the boundary
+    {
+        Natural const m = 3;
+        std::vector <double> H = {4.,1.,0., 1.,3.,1., 0.,1.,2.};
+        std::vector <double> g = {1.,-2.,0.5};
+        d.resize(m);
+        Optizelle::MoreSorensen <double> ms(m,&(H[0]),&(g[0]));
+        for(double delta : {10.,0.5,0.1}) {
+            ms.solve(delta,tol,iter_max,&(d[0]),lambda,boundary);
+            check_optimality(m,H,g,delta,d,lambda,boundary,
+                2.-std::sqrt(3.));
+            CHECK(boundary == (delta < 1.));
+        }
+    }
+
+    // H indefinite
+    {
+        Natural const m = 4;
+        std::vector <double> H(m*m,0.);
+        double const D[] = {-3.,-1.,2.,5.};
+        for(Natural i=1;i<=m;i++) H[ijtok(i,i,m)]=D[i-1];
+        H[ijtok(1,2,m)]=H[ijtok(2,1,m)]=0.5;
+        std::vector <double> g = {1.,1.,1.,1.};
+        d.resize(m);
+        Optizelle::MoreSorensen <double> ms(m,&(H[0]),&(g[0]));
+        for(double delta : {100.,1.,0.01}) {
+            ms.solve(delta,tol,iter_max,&(d[0]),lambda,boundary);
+            check_optimality(m,H,g,delta,d,lambda,boundary,
+                -2.-std::sqrt(1.25));
+            CHECK(boundary);
+        }
+    }
+
+    // The hard case where g is orthogonal to the leftmost eigenvector, so we
+    // need a component along it to reach the boundary
+    {
+        Natural const m = 3;
+        std::vector <double> H = {-1.,0.,0., 0.,1.,0., 0.,0.,2.};
+        std::vector <double> g = {0.,1.,1.};
+        d.resize(m);
+        Optizelle::MoreSorensen <double> ms(m,&(H[0]),&(g[0]));
+        double const delta = 5.;
+        ms.solve(delta,tol,iter_max,&(d[0]),lambda,boundary);
+        check_optimality(m,H,g,delta,d,lambda,boundary,-1.);
+        CHECK(boundary);
+        CHECK(std::fabs(lambda-1.) < 1e-12);
+        CHECK(std::fabs(std::fabs(d[0])-std::sqrt(25.-.25-1./9.)) < 1e-12);
+    }
+
+    // A zero gradient at a saddle point gives a step along the negative
+    // curvature
+    {
+        Natural const m = 2;
+        std::vector <double> H = {1.,0., 0.,-2.};
+        std::vector <double> g = {0.,0.};
+        d.resize(m);
+        Optizelle::MoreSorensen <double> ms(m,&(H[0]),&(g[0]));
+        ms.solve(2.,tol,iter_max,&(d[0]),lambda,boundary);
+        check_optimality(m,H,g,2.,d,lambda,boundary,-2.);
+        CHECK(std::fabs(std::fabs(d[1])-2.) < 1e-12);
+    }
+
+    // Minimize a quadratic with the trust-region method.  With a dense
+    // Hessian, the first subproblem gives the Newton step, so we converge
+    // right away.  Without it, we need several truncated CG iterations.
+    {
+        Natural const m = 20;
+        std::vector <X_Vector> sols;
+        for(Natural dense_size_max : {Natural(0),Natural(1000)}) {
+            Optizelle::Unconstrained <double,Rm>::State::t state(
+                X_Vector(m,0.));
+            state.msg_level = 0;
+            state.H_type = Optizelle::Operators::UserDefined;
+            state.dense_size_max = dense_size_max;
+            state.delta = 100.;
+            Quadratic * f = new Quadratic(m);
+            Optizelle::Unconstrained <double,Rm>::Functions::t fns;
+            fns.f.reset(f);
+            Optizelle::Unconstrained <double,Rm>::Algorithms::getMin(
+                Optizelle::Messaging(),fns,state);
+            CHECK(state.opt_stop
+                == Optizelle::StoppingCondition::RelativeGradientSmall);
+            if(dense_size_max > 0) {
+                CHECK(f->hessians > 0);
+                CHECK(state.iter <= 3);
+            } else
+                CHECK(f->hessians == 0);
+            sols.emplace_back(std::move(state.x));
+        }
+        X::axpy(-1.,sols[0],sols[1]);
+        CHECK(std::sqrt(X::innr(sols[1],sols[1])) < 1e-6);
+    }
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
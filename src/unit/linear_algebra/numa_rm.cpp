@@ -0,0 +1,263 @@
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/numa.h"
+#include "unit.h"
+
+// Create some type shortcuts
+using Optizelle::Natural;
+using Optizelle::Rm;
+using Optizelle::NumaRm;
+typedef Optizelle::NumaVector <double> NumaVector;
+
+// Creates a vector in either space from its elements.  We ask for huge
+// pages, so that we exercise the aligned mapping.
+template <template <typename> class XX>
+struct Make;
+template <>
+struct Make <Rm> {
+    static std::vector <double> vector(std::vector <double> const & x) {
+        return x;
+    }
+};
+template <>
+struct Make <NumaRm> {
+    static NumaVector vector(std::vector <double> const & x) {
+        NumaVector y(x.size(),true);
+        for(Natural i=0;i<x.size();i++)
+            y[i]=x[i];
+        return y;
+    }
+};
+
+// f(x,y) = (x+1)^2 + (y+1)^2 + 0.1 (xy)^2
+template <template <typename> class XX>
+struct MyObj : public Optizelle::ScalarValuedFunction <double,XX> {
+    typedef typename XX <double>::Vector X_Vector;
+    double eval(X_Vector const & x) const {
+        return Optizelle::sq(x[0]+1.)+Optizelle::sq(x[1]+1.)
+            +0.1*Optizelle::sq(x[0]*x[1]);
+    }
+    void grad(X_Vector const & x,X_Vector & g) const {
+        g[0]=2.*x[0]+2.+0.2*x[0]*x[1]*x[1];
+        g[1]=2.*x[1]+2.+0.2*x[0]*x[0]*x[1];
+    }
+    void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+        const
+    {
+        H_dx[0]=(2.+0.2*x[1]*x[1])*dx[0]+0.4*x[0]*x[1]*dx[1];
+        H_dx[1]=0.4*x[0]*x[1]*dx[0]+(2.+0.2*x[0]*x[0])*dx[1];
+    }
+};
+
+// g(x,y) = [ x^2 + 2y = 1 ]
+template <template <typename> class XX>
+struct MyEq : public Optizelle::VectorValuedFunction <double,XX,XX> {
+    typedef typename XX <double>::Vector X_Vector;
+    void eval(X_Vector const & x,X_Vector & y) const {
+        y[0]=x[0]*x[0]+2.*x[1]-1.;
+    }
+    void p(X_Vector const & x,X_Vector const & dx,X_Vector & y) const {
+        y[0]=2.*x[0]*dx[0]+2.*dx[1];
+    }
+    void ps(X_Vector const & x,X_Vector const & dy,X_Vector & z) const {
+        z[0]=2.*x[0]*dy[0];
+        z[1]=2.*dy[0];
+    }
+    void pps(
+        X_Vector const & x,
+        X_Vector const & dx,
+        X_Vector const & dy,
+        X_Vector & z
+    ) const {
+        z[0]=2.*dx[0]*dy[0];
+        z[1]=0.;
+    }
+};
+
+// h(x,y) = [ 2x + y >= 1 ]
+template <template <typename> class XX>
+struct MyIneq : public Optizelle::VectorValuedFunction <double,XX,XX> {
+    typedef typename XX <double>::Vector X_Vector;
+    void eval(X_Vector const & x,X_Vector & y) const {
+        y[0]=2.*x[0]+x[1]-1.;
+    }
+    void p(X_Vector const & x,X_Vector const & dx,X_Vector & y) const {
+        y[0]=2.*dx[0]+dx[1];
+    }
+    void ps(X_Vector const & x,X_Vector const & dy,X_Vector & z) const {
+        z[0]=2.*dy[0];
+        z[1]=dy[0];
+    }
+    void pps(
+        X_Vector const & x,
+        X_Vector const & dx,
+        X_Vector const & dy,
+        X_Vector & z
+    ) const {
+        z[0]=0.;
+        z[1]=0.;
+    }
+};
+
+// Solves each of the problem classes and returns the solutions along with
+// the number of iterations
+template <template <typename> class XX>
+std::vector <double> solve() {
+    std::vector <double> x0 = {2.1,1.1};
+    std::vector <double> results;
+    auto record = [&](typename XX <double>::Vector const & x,Natural iter) {
+        results.push_back(x[0]);
+        results.push_back(x[1]);
+        results.push_back(double(iter));
+    };
+    Optizelle::Messaging msg;
+
+    {
+        typedef Optizelle::Unconstrained <double,XX> Problem;
+        typename Problem::State::t state(Make <XX>::vector(x0));
+        state.msg_level = 0;
+        state.H_type = Optizelle::Operators::UserDefined;
+        typename Problem::Functions::t fns;
+        fns.f.reset(new MyObj <XX>);
+        Problem::Algorithms::getMin(msg,fns,state);
+        record(state.x,state.iter);
+    }
+
+    {
+        typedef Optizelle::EqualityConstrained <double,XX,XX> Problem;
+        typename Problem::State::t state(Make <XX>::vector(x0),
+            Make <XX>::vector({0.}));
+        state.msg_level = 0;
+        state.H_type = Optizelle::Operators::UserDefined;
+        typename Problem::Functions::t fns;
+        fns.f.reset(new MyObj <XX>);
+        fns.g.reset(new MyEq <XX>);
+        Problem::Algorithms::getMin(msg,fns,state);
+        record(state.x,state.iter);
+    }
+
+    {
+        typedef Optizelle::InequalityConstrained <double,XX,XX> Problem;
+        typename Problem::State::t state(Make <XX>::vector(x0),
+            Make <XX>::vector({0.}));
+        state.msg_level = 0;
+        state.H_type = Optizelle::Operators::UserDefined;
+        typename Problem::Functions::t fns;
+        fns.f.reset(new MyObj <XX>);
+        fns.h.reset(new MyIneq <XX>);
+        Problem::Algorithms::getMin(msg,fns,state);
+        record(state.x,state.iter);
+    }
+
+    {
+        typedef Optizelle::Constrained <double,XX,XX,XX> Problem;
+        typename Problem::State::t state(Make <XX>::vector(x0),
+            Make <XX>::vector({0.}),Make <XX>::vector({0.}));
+        state.msg_level = 0;
+        state.H_type = Optizelle::Operators::UserDefined;
+        typename Problem::Functions::t fns;
+        fns.f.reset(new MyObj <XX>);
+        fns.g.reset(new MyEq <XX>);
+        fns.h.reset(new MyIneq <XX>);
+        Problem::Algorithms::getMin(msg,fns,state);
+        record(state.x,state.iter);
+    }
+
+    return results;
+}
+
+// Checks that the NUMA vector space matches Rm on vectors that span
+// several huge pages and that each of the problem classes gives the same
+// solution with either space
+int main() {
+    // Create some type shortcuts
+    typedef Optizelle::Rm <double> X;
+    typedef Optizelle::NumaRm <double> XN;
+
+    // Create vectors that end in the middle of a page
+    Natural const n = 5*NumaVector::huge_page/sizeof(double)/2+3;
+    std::vector <double> x(n), y(n), z(n);
+    for(Natural i=0;i<n;i++) {
+        x[i] = 1.+0.5*sin(double(i));
+        y[i] = cos(double(i));
+    }
+    NumaVector xn(Make <NumaRm>::vector(x));
+    NumaVector yn(Make <NumaRm>::vector(y));
+    NumaVector zn(XN::init(xn));
+    CHECK(zn.size() == n);
+    CHECK(zn.huge);
+
+    // Checks that zn matches z
+    auto same = [&]() {
+        for(Natural i=0;i<n;i++)
+            if(z[i]!=zn[i]) return false;
+        return true;
+    };
+
+    // New vectors start at zero
+    X::zero(z);
+    CHECK(same());
+
+    // Apply each operation in both spaces
+    X::copy(y,z);
+    XN::copy(yn,zn);
+    CHECK(same());
+
+    X::scal(-0.5,z);
+    XN::scal(-0.5,zn);
+    CHECK(same());
+
+    X::axpy(2.,x,z);
+    XN::axpy(2.,xn,zn);
+    CHECK(same());
+
+    X::prod(x,y,z);
+    XN::prod(xn,yn,zn);
+    CHECK(same());
+
+    X::linv(x,y,z);
+    XN::linv(xn,yn,zn);
+    CHECK(same());
+
+    X::id(z);
+    XN::id(zn);
+    CHECK(same());
+
+    X::zero(z);
+    XN::zero(zn);
+    CHECK(same());
+
+    // The reductions sum in a different order
+    double const tol = 1e-12;
+    CHECK(std::fabs(X::innr(x,y)-XN::innr(xn,yn))
+        < tol*std::fabs(X::innr(x,y)));
+    CHECK(std::fabs(X::barr(x)-XN::barr(xn)) < tol*std::fabs(X::barr(x)));
+    CHECK(X::srch(y,x) == XN::srch(yn,xn));
+
+    // Convert to single precision
+    Optizelle::NumaVector <float> xs(XN::init_prec <float> (xn));
+    XN::copy_prec <float> (xn,xs);
+    CHECK(xs[n-1] == float(x[n-1]));
+
+    // Work with the single-precision vector directly
+    std::vector <float> xf(n);
+    X::copy_prec <float> (x,xf);
+    CHECK(std::fabs(X::innr_prec <float> (xf,y)-XN::innr_prec <float> (xs,yn))
+        < tol*std::fabs(X::innr_prec <float> (xf,y)));
+    X::copy(y,z);
+    XN::copy(yn,zn);
+    X::axpy_prec <float> (2.,xf,z);
+    XN::axpy_prec <float> (2.,xs,zn);
+    CHECK(same());
+
+    // Moving a vector transfers its pages
+    NumaVector wn(std::move(zn));
+    CHECK(wn.size() == n);
+    CHECK(zn.size() == 0);
+
+    // Solve the problems in both spaces
+    CHECK(solve <Rm> () == solve <NumaRm> ());
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
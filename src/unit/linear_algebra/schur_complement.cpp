@@ -0,0 +1,177 @@
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/linalg.h"
+#include "unit.h"
+
+// Checks that the Schur complement operator inverts the interior point
+// Hessian h'(x)* inv(L(h(x))) (h'(x) dx o z) for a linear constraint that
+// touches linear, quadratic, and semidefinite cones.  We check this with both
+// full and packed storage for the semidefinite block.  With a general
+// multiplier, the Hessian isn't symmetric, so we also check the Schur
+// complement against the symmetric part of the Hessian formed with full
+// storage.  We also check that we revert to the identity when h(x) isn't
+// positive definite.
+int main() {
+    // Create some type shortcuts
+    typedef Optizelle::Rm <double> X;
+    typedef Optizelle::SQL <double> Z;
+    typedef Optizelle::SparseSQL <double> SparseSQL;
+    using Optizelle::Natural;
+
+    // Create the cones
+    std::vector <Optizelle::Cone::t> types(3);
+    types[0]=Optizelle::Cone::Linear;
+    types[1]=Optizelle::Cone::Quadratic;
+    types[2]=Optizelle::Cone::Semidefinite;
+    std::vector <Natural> sizes(3);
+    sizes[0]=3;
+    sizes[1]=3;
+    sizes[2]=4;
+
+    // Set the number of variables
+    Natural m = 4;
+
+    // Create the sparse constraint matrices.  A0 is the constant term.
+    std::vector <SparseSQL> A(m+1);
+    for(Natural i=1;i<=m;i++) {
+        // Linear cone
+        A[i].blks.push_back(1); A[i].is.push_back((i-1)%3+1);
+        A[i].js.push_back(0); A[i].data.push_back(1.+i);
+
+        // Quadratic cone
+        A[i].blks.push_back(2); A[i].is.push_back((i-1)%3+1);
+        A[i].js.push_back(0); A[i].data.push_back(cos(double(i)));
+    }
+
+    // A1 has a single off-diagonal entry in the SDP block, which uses the
+    // sparse kernel.
+    A[1].blks.push_back(3); A[1].is.push_back(1);
+    A[1].js.push_back(3); A[1].data.push_back(2.);
+
+    // A2 is dense in the SDP block, which uses the dense kernel.
+    for(Natural j=1;j<=4;j++)
+        for(Natural i=1;i<=j;i++) {
+            A[2].blks.push_back(3); A[2].is.push_back(i);
+            A[2].js.push_back(j); A[2].data.push_back(sin(double(i+4*j)));
+        }
+
+    // A3 has a diagonal entry
+    A[3].blks.push_back(3); A[3].is.push_back(2);
+    A[3].js.push_back(2); A[3].data.push_back(1.5);
+    Optizelle::LinearSQLFunction <double> h(A);
+
+    for(auto storage : {Optizelle::SDPStorage::Full,
+        Optizelle::SDPStorage::Packed}
+    ) {
+        Z::Vector zz(types,sizes,storage);
+
+        // Create a strictly feasible h(x)
+        Z::Vector h_x(Z::init(zz));
+        h_x(1,1)=1.; h_x(1,2)=2.; h_x(1,3)=0.5;
+        h_x(2,1)=3.; h_x(2,2)=1.; h_x(2,3)=-1.;
+        for(Natural j=1;j<=4;j++)
+            for(Natural i=1;i<=4;i++)
+                h_x(3,i,j)= i==j ? 4. : 1./double(i+j);
+
+        // Create a multiplier that is a multiple of the identity.  This makes
+        // the interior point Hessian symmetric.
+        Z::Vector z(Z::init(zz));
+        Z::id(z);
+        Z::scal(0.7,z);
+
+        // Create the Schur complement operator
+        Optizelle::SchurComplement <double> PH(h,z,h_x);
+
+        // Create a direction
+        std::vector <double> x(m);
+        std::vector <double> dx(m);
+        for(Natural i=0;i<m;i++) dx[i]=cos(double(i+25));
+
+        // H_dx <- h'(x)* inv(L(h(x))) (h'(x) dx o z)
+        Z::Vector z_tmp1(Z::init(zz));
+        Z::Vector z_tmp2(Z::init(zz));
+        h.p(x,dx,z_tmp1);
+        Z::prod(z_tmp1,z,z_tmp2);
+        Z::linv(h_x,z_tmp2,z_tmp1);
+        std::vector <double> H_dx(m);
+        h.ps(x,z_tmp1,H_dx);
+
+        // dx_sol <- inv(M) H_dx
+        std::vector <double> dx_sol(m);
+        PH.eval(H_dx,dx_sol);
+
+        // Check that we recovered the direction
+        std::vector <double> residual(dx);
+        X::axpy(-1.,dx_sol,residual);
+        double err=std::sqrt(X::innr(residual,residual))
+            /(1+std::sqrt(X::innr(dx,dx)));
+        CHECK(err < 1e-12);
+
+        // Create a general multiplier.  The semidefinite block isn't diagonal.
+        Z::Vector zg(Z::init(zz));
+        for(Natural i=1;i<=3;i++)
+            zg(1,i)=0.5+0.2*double(i);
+        zg(2,1)=2.; zg(2,2)=0.3; zg(2,3)=-0.4;
+        for(Natural j=1;j<=4;j++)
+            for(Natural i=1;i<=4;i++)
+                zg(3,i,j)= i==j ? 2.+0.1*double(i) : 0.3*cos(double(i*j));
+        Optizelle::SchurComplement <double> PH_g(h,zg,h_x);
+
+        // Forms the symmetric part of h'(x)* inv(L(h(x))) (h'(x) . o z)
+        // column by column with full storage
+        auto hessian = [&](Z::Vector const & z_) {
+            Z::Vector z_f(types,sizes);
+            Z::Vector h_x_f(types,sizes);
+            Z::convert(z_,z_f);
+            Z::convert(h_x,h_x_f);
+            Z::Vector z_tmp1(Z::init(z_f));
+            Z::Vector z_tmp2(Z::init(z_f));
+            std::vector <double> H(m*m);
+            for(Natural j=1;j<=m;j++) {
+                std::vector <double> e_j(m);
+                e_j[j-1]=1.;
+                std::vector <double> H_ej(m);
+                h.p(x,e_j,z_tmp1);
+                Z::prod(z_tmp1,z_f,z_tmp2);
+                Z::linv(h_x_f,z_tmp2,z_tmp1);
+                h.ps(x,z_tmp1,H_ej);
+                for(Natural i=1;i<=m;i++)
+                    H[Optizelle::ijtok(i,j,m)]=H_ej[i-1];
+            }
+            for(Natural j=1;j<=m;j++)
+                for(Natural i=1;i<j;i++) {
+                    double const H_ij=0.5*(H[Optizelle::ijtok(i,j,m)]
+                        +H[Optizelle::ijtok(j,i,m)]);
+                    H[Optizelle::ijtok(i,j,m)]=H_ij;
+                    H[Optizelle::ijtok(j,i,m)]=H_ij;
+                }
+            return H;
+        };
+
+        // Checks that H inv(M) H_dx recovers H_dx
+        auto check_inverse = [&](std::vector <double> const & H) {
+            PH_g.eval(H_dx,dx_sol);
+            std::vector <double> r(H_dx);
+            Optizelle::gemv <double> ('N',m,m,1.,&(H[0]),m,&(dx_sol[0]),1,
+                -1.,&(r[0]),1);
+            return std::sqrt(X::innr(r,r))/(1+std::sqrt(X::innr(H_dx,H_dx)));
+        };
+        CHECK(check_inverse(hessian(zg)) < 1e-12);
+
+        // Changing only z refactors the Schur complement
+        Z::scal(1.5,zg);
+        CHECK(check_inverse(hessian(zg)) < 1e-12);
+
+        // When the semidefinite block of h(x) isn't positive definite, we
+        // can't form the Schur complement and revert to the identity
+        Z::Vector h_x_bad(Z::init(zz));
+        Z::copy(h_x,h_x_bad);
+        h_x_bad(3,1,1)=-4.;
+        Optizelle::SchurComplement <double> PH_bad(h,z,h_x_bad);
+        PH_bad.eval(H_dx,dx_sol);
+        CHECK(dx_sol == H_dx);
+    }
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,61 @@
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/linalg.h"
+#include "unit.h"
+
+// Checks the dense kernels behind the semidefinite blocks.  Namely, we check
+// that the Krylov eigenvalue solvers find the leftmost eigenvalue of matrices
+// large enough to need more than a single restart.
+int main() {
+    // Create some type shortcuts
+    using Optizelle::Natural;
+    using Optizelle::Integer;
+    using Optizelle::ijtok;
+
+    // Returns a symmetric test matrix with the given shift on the diagonal
+    auto symmetric = [](Natural const & m,double const & shift) {
+        std::vector <double> A(m*m);
+        for(Natural j=1;j<=m;j++)
+            for(Natural i=1;i<=m;i++)
+                A[ijtok(i,j,m)]= i==j ? shift+double(i)/double(m)
+                    : 0.5*sin(double(i+j))/double(m);
+        return A;
+    };
+
+    // Returns the smallest eigenvalue of a symmetric matrix
+    auto lambda_min = [](Natural const & m,std::vector <double> A) {
+        Integer neig(0);
+        Integer info(0);
+        std::vector <double> W(m);
+        std::vector <double> Z(m);
+        std::vector <Integer> isuppz(2*m);
+        std::vector <double> work(26*m);
+        std::vector <Integer> iwork(10*m);
+        Optizelle::syevr <double> ('N','I','U',m,&(A[0]),m,0.,0.,1,1,
+            Optizelle::lamch <double> ('S'),neig,&(W[0]),&(Z[0]),m,
+            &(isuppz[0]),&(work[0]),work.size(),&(iwork[0]),iwork.size(),
+            info);
+        return W[0];
+    };
+
+    for(Natural m : {1,2,7,60}) {
+        // Find the smallest eigenvalue of an indefinite matrix with Lanczos
+        std::vector <double> C(symmetric(m,-0.5));
+        double lambda = lambda_min(m,C);
+        double lambda_lanczos=Optizelle::lanczos <double> (m,&(C[0]),m,1e-8);
+        CHECK(std::fabs(lambda-lambda_lanczos) < 1e-6);
+
+        // Find the smallest eigenvalue with the implicitly restarted Arnoldi
+        // method.  When the matrix is small enough, this is a dense solve.
+        std::vector <double> Cp(m*(m+1)/2);
+        Integer info(0);
+        Optizelle::trttp <double> ('U',m,&(C[0]),m,&(Cp[0]),info);
+        std::pair <double,double> lambda_err = Optizelle::syiram <double> (
+            m,&(Cp[0]),20,50,1e-8);
+        CHECK(std::fabs(lambda-lambda_err.first) < 1e-6);
+        CHECK(lambda_err.second < 1e-8);
+    }
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
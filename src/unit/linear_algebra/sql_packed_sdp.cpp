@@ -0,0 +1,232 @@
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/linalg.h"
+#include "unit.h"
+
+// Checks that the SQL operations on semidefinite blocks stored in rectangular
+// full packed format agree with the same operations on full storage.  This
+// includes the nonsymmetric result of the Jordan product, which the packed
+// blocks keep in a separate full-storage temporary.
+int main() {
+    // Create some type shortcuts
+    typedef Optizelle::SQL <double> Z;
+    typedef Optizelle::SparseSQL <double> SparseSQL;
+    using Optizelle::Natural;
+    using Optizelle::SDPStorage::Full;
+    using Optizelle::SDPStorage::Packed;
+
+    // Check the RFP indexing against the LAPACK conversion routine
+    double err(0.);
+    for(Natural m=1;m<=7;m++) {
+        std::vector <double> A(m*m);
+        for(Natural j=1;j<=m;j++)
+            for(Natural i=1;i<=m;i++)
+                A[Optizelle::ijtok(i,j,m)]=double(i+10*j);
+        std::vector <double> Arf(m*(m+1)/2);
+        Optizelle::Integer info(0);
+        Optizelle::trttf <double> ('N','U',m,&(A[0]),m,&(Arf[0]),info);
+        for(Natural j=1;j<=m;j++)
+            for(Natural i=1;i<=j;i++)
+                err=std::max(err,std::fabs(Arf[Optizelle::ijtokrf(i,j,m)]
+                    -A[Optizelle::ijtok(i,j,m)]));
+    }
+    CHECK(err == 0.);
+
+    // Create a mix of cones with semidefinite blocks of even and odd size
+    std::vector <Optizelle::Cone::t> types;
+    std::vector <Natural> sizes;
+    types.push_back(Optizelle::Cone::Semidefinite); sizes.push_back(4);
+    types.push_back(Optizelle::Cone::Linear); sizes.push_back(3);
+    types.push_back(Optizelle::Cone::Quadratic); sizes.push_back(4);
+    types.push_back(Optizelle::Cone::Semidefinite); sizes.push_back(5);
+    types.push_back(Optizelle::Cone::Semidefinite); sizes.push_back(1);
+    Z::Vector zz(types,sizes);
+    Z::Vector pp(types,sizes,Packed);
+    CHECK(pp.data.size() < zz.data.size());
+
+    // Create two strictly feasible vectors and a direction in full storage
+    Z::Vector x(Z::init(zz));
+    Z::Vector y(Z::init(zz));
+    Z::Vector dy(Z::init(zz));
+    for(Natural blk=1;blk<=types.size();blk++) {
+        Natural m=sizes[blk-1];
+        if(types[blk-1]==Optizelle::Cone::Semidefinite) {
+            for(Natural j=1;j<=m;j++)
+                for(Natural i=1;i<=m;i++) {
+                    x(blk,i,j)= i==j ? 3.+double(i) : 1./double(i+j);
+                    y(blk,i,j)= i==j ? 2. : 0.3*sin(double(i*j+blk));
+                    dy(blk,i,j)= i==j ? -1.-double(i) : 0.1*cos(double(i+j));
+                }
+        } else if(types[blk-1]==Optizelle::Cone::Linear) {
+            for(Natural i=1;i<=m;i++) {
+                x(blk,i)=2.+sin(double(blk+i));
+                y(blk,i)=2.+cos(double(blk*i));
+                dy(blk,i)=cos(double(blk+3*i));
+            }
+        } else
+            for(Natural i=1;i<=m;i++) {
+                x(blk,i)= i==1 ? double(m)+1. : sin(double(blk+i));
+                y(blk,i)= i==1 ? double(m)+2. : cos(double(blk*i));
+                dy(blk,i)= i==1 ? -2. : cos(double(blk+3*i));
+            }
+    }
+
+    // Pack the vectors and make sure that we can recover the full vectors
+    Z::Vector xp(Z::init(pp));
+    Z::Vector yp(Z::init(pp));
+    Z::Vector dyp(Z::init(pp));
+    Z::convert(x,xp);
+    Z::convert(y,yp);
+    Z::convert(dy,dyp);
+    Z::Vector z(Z::init(zz));
+    Z::Vector zp(Z::init(pp));
+    Z::convert(xp,z);
+    Z::axpy(-1.,x,z);
+    err=std::sqrt(Z::innr(z,z));
+    CHECK(err == 0.);
+
+    // Computes the relative error between a full and packed vector
+    auto rel_err = [&](Z::Vector const & full,Z::Vector const & packed) {
+        Z::Vector r(Z::init(zz));
+        Z::convert(packed,r);
+        Z::axpy(-1.,full,r);
+        return std::sqrt(Z::innr(r,r))/(1.+std::sqrt(Z::innr(full,full)));
+    };
+
+    // Inner product
+    err=std::fabs(Z::innr(x,y)-Z::innr(xp,yp))/(1.+std::fabs(Z::innr(x,y)));
+    CHECK(err < 1e-14);
+
+    // Jordan product
+    Z::prod(x,y,z);
+    Z::prod(xp,yp,zp);
+    CHECK(zp.widened[0] && !zp.widened[1] && zp.widened[3]);
+    CHECK(rel_err(z,zp) < 1e-14);
+
+    // Inner products and linear combinations with the full-storage
+    // temporaries
+    Z::Vector w(Z::init(zz));
+    Z::Vector wp(Z::init(pp));
+    Z::prod(dy,x,w);
+    Z::prod(dyp,xp,wp);
+    err=std::fabs(Z::innr(z,w)-Z::innr(zp,wp))/(1.+std::fabs(Z::innr(z,w)));
+    CHECK(err < 1e-14);
+    Z::axpy(-2.,z,y);
+    Z::axpy(-2.,zp,yp);
+    CHECK(rel_err(y,yp) < 1e-14);
+    Z::axpy(2.,z,y);
+    Z::axpy(2.,zp,yp);
+    CHECK(rel_err(y,yp) < 1e-14);
+
+    // Jordan product inverse, which recovers y from x o y.  Packed storage
+    // keeps the symmetric part of the result.
+    Z::linv(xp,zp,zp);
+    CHECK(!zp.isWide());
+    CHECK(rel_err(y,zp) < 1e-12);
+
+    // Since x o y = xy, the Jordan product inverse is inv(x) y, which
+    // exactly inverts the Jordan product on full storage even when the
+    // right hand side isn't symmetric
+    Z::linv(x,w,z);
+    Z::Vector r(Z::init(zz));
+    Z::prod(x,z,r);
+    Z::axpy(-1.,w,r);
+    CHECK(std::sqrt(Z::innr(r,r))/(1.+std::sqrt(Z::innr(w,w))) < 1e-12);
+
+    // Jordan product inverse of a nonsymmetric right hand side
+    Z::linv(xp,wp,zp);
+    Z::symm(z);
+    CHECK(rel_err(z,zp) < 1e-12);
+
+    // Identity
+    Z::id(z);
+    Z::id(zp);
+    CHECK(rel_err(z,zp) == 0.);
+
+    // Barrier function
+    err=std::fabs(Z::barr(x)-Z::barr(xp))/(1.+std::fabs(Z::barr(x)));
+    CHECK(err < 1e-14);
+
+    // Line search
+    double alpha=Z::srch(dy,y);
+    CHECK(alpha > 0. && alpha < std::numeric_limits <double>::infinity());
+    err=std::fabs(alpha-Z::srch(dyp,yp))/(1.+alpha);
+    CHECK(err < 1e-12);
+
+    // Line search in the direction of a Jordan product, which only looks at
+    // the upper triangle
+    alpha=Z::srch(w,y);
+    err=std::fabs(alpha-Z::srch(wp,yp))/(1.+alpha);
+    CHECK(err < 1e-12);
+
+    // Symmetrization folds the full-storage temporaries back into packed
+    // storage and does nothing otherwise
+    Z::prod(x,y,z);
+    Z::prod(xp,yp,zp);
+    Z::symm(z);
+    Z::symm(zp);
+    CHECK(!zp.isWide());
+    CHECK(rel_err(z,zp) < 1e-12);
+    Z::Vector zp_symm(Z::init(pp));
+    Z::copy(zp,zp_symm);
+    Z::symm(zp_symm);
+    Z::axpy(-1.,zp,zp_symm);
+    CHECK(Z::innr(zp_symm,zp_symm) == 0.);
+
+    // Indexing a block that lives in its full-storage temporary reads and
+    // writes that temporary, so it behaves like full storage and doesn't
+    // touch the other blocks
+    Z::prod(x,y,z);
+    Z::prod(xp,yp,zp);
+    CHECK(zp(1,1,2)==z(1,1,2) && zp(1,2,1)==z(1,2,1));
+    CHECK(zp(1,1,2)!=zp(1,2,1));
+    CHECK(zp.widened[0]);
+    Z::copy(xp,zp);
+    Z::widen(zp,4);
+    zp(4,1,2)+=1.;
+    CHECK(!zp.widened[0] && zp.widened[3]);
+    CHECK(zp(4,2,1)==xp(4,2,1) && zp(4,1,2)==xp(4,1,2)+1.);
+    Z::copy(x,z);
+    z(4,1,2)+=1.;
+    CHECK(rel_err(z,zp) < 1e-14);
+
+    // Sparse matrices only store one of each pair of off-diagonal elements
+    SparseSQL A;
+    A.blks.push_back(1); A.is.push_back(1); A.js.push_back(3);
+    A.data.push_back(2.);
+    A.blks.push_back(1); A.is.push_back(2); A.js.push_back(2);
+    A.data.push_back(-1.);
+    A.blks.push_back(4); A.is.push_back(2); A.js.push_back(5);
+    A.data.push_back(0.5);
+    A.blks.push_back(2); A.is.push_back(3); A.js.push_back(0);
+    A.data.push_back(4.);
+    Z::copy(x,z);
+    Z::copy(xp,zp);
+    SparseSQL::axpy(0.7,A,z);
+    SparseSQL::axpy(0.7,A,zp);
+    CHECK(rel_err(z,zp) < 1e-14);
+    err=std::fabs(SparseSQL::innr(A,z)-SparseSQL::innr(A,zp))
+        /(1.+std::fabs(SparseSQL::innr(A,z)));
+    CHECK(err < 1e-14);
+    Z::prod(x,y,z);
+    Z::prod(xp,yp,zp);
+    SparseSQL::axpy(0.7,A,z);
+    SparseSQL::axpy(0.7,A,zp);
+    CHECK(rel_err(z,zp) < 1e-14);
+
+    // Serialization retains the storage and the full-storage temporaries
+    Z::Vector xp_json(Optizelle::json::Serialization <double,Optizelle::SQL>
+        ::deserialize(pp,Optizelle::json::Serialization<double,Optizelle::SQL>
+            ::serialize(xp)));
+    CHECK(xp_json.storage==Packed);
+    CHECK(rel_err(x,xp_json) < 1e-14);
+    CHECK(zz.storage==Full);
+    Z::Vector wp_json(Optizelle::json::Serialization <double,Optizelle::SQL>
+        ::deserialize(pp,Optizelle::json::Serialization<double,Optizelle::SQL>
+            ::serialize(wp)));
+    CHECK(wp_json.widened==wp.widened);
+    CHECK(rel_err(w,wp_json) < 1e-14);
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,164 @@
+#include <functional>
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "unit.h"
+
+// Create some type shortcuts
+typedef Optizelle::Rm <double> X;
+typedef X::Vector X_Vector;
+typedef Optizelle::SQL <double> Z;
+typedef Z::Vector Z_Vector;
+using Optizelle::Natural;
+using Optizelle::Rm;
+using Optizelle::SQL;
+typedef Optizelle::InequalityConstrained <double,Rm,SQL> Problem;
+
+// f(x,y)=-x+y
+struct MyObj : public Optizelle::ScalarValuedFunction <double,Rm> {
+    double eval(X_Vector const & x) const {
+        return -x[0]+x[1];
+    }
+    void grad(X_Vector const & x,X_Vector & g) const {
+        g[0]=-1.;
+        g[1]=1.;
+    }
+    void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+        const
+    {
+        X::zero(H_dx);
+    }
+};
+
+// h(x,y) = [ y x ] >= 0
+//          [ x 1 ]
+struct MyIneq : public Optizelle::VectorValuedFunction <double,Rm,SQL> {
+    void eval(X_Vector const & x,Z_Vector & y) const {
+        y(1,1,1)=x[1];
+        y(1,1,2)=x[0];
+        y(1,2,1)=x[0];
+        y(1,2,2)=1.;
+    }
+    void p(X_Vector const & x,X_Vector const & dx,Z_Vector & y) const {
+        y(1,1,1)=dx[1];
+        y(1,1,2)=dx[0];
+        y(1,2,1)=dx[0];
+        y(1,2,2)=0.;
+    }
+    void ps(X_Vector const & x,Z_Vector const & dy,X_Vector & z) const {
+        z[0]=dy(1,1,2)+dy(1,2,1);
+        z[1]=dy(1,1,1);
+    }
+    void pps(
+        X_Vector const & x,
+        X_Vector const & dx,
+        Z_Vector const & dy,
+        X_Vector & z
+    ) const {
+        X::zero(z);
+    }
+};
+
+// Pieces of the final state that we compare
+struct Result {
+    Natural iter;
+    Optizelle::StoppingCondition::t opt_stop;
+    X_Vector x;
+};
+
+// Solves the problem from the simple_sdp_cone example with the settings in
+// setup and the given storage for the semidefinite block
+Result solve(
+    std::function <void(Problem::State::t &)> const & setup,
+    Optizelle::SDPStorage::t const & storage
+) {
+    Problem::State::t state(X_Vector{1.2,3.1},
+        Z_Vector({Optizelle::Cone::Semidefinite},{2},storage));
+    state.msg_level = 0;
+    state.H_type = Optizelle::Operators::UserDefined;
+    state.iter_max = 50;
+    state.eps_krylov = 1e-10;
+    state.eps_dx = 1e-16;
+    setup(state);
+    Problem::Functions::t fns;
+    fns.f.reset(new MyObj);
+    fns.h.reset(new MyIneq);
+    Problem::Algorithms::getMin(Optizelle::Messaging(),fns,state);
+    return Result{state.iter,state.opt_stop,std::move(state.x)};
+}
+
+// Checks that packed storage for the semidefinite block follows the same
+// path as full storage with each of the settings from the simple_sdp_cone
+// example.  Both should find the solution (0.5,0.25) in the same number of
+// iterations.  Packed storage solves with the Choleski factor rather than
+// multiplying by the inverse, so rounding differences may still trigger a
+// different stopping condition once the steps become tiny.
+void check(std::function <void(Problem::State::t &)> const & setup) {
+    auto full = solve(setup,Optizelle::SDPStorage::Full);
+    auto packed = solve(setup,Optizelle::SDPStorage::Packed);
+    CHECK(packed.iter == full.iter ||
+        packed.opt_stop == Optizelle::StoppingCondition::RelativeStepSmall ||
+        full.opt_stop == Optizelle::StoppingCondition::RelativeStepSmall);
+    CHECK(packed.opt_stop != Optizelle::StoppingCondition::MaxItersExceeded);
+    CHECK(std::fabs(packed.x[0]-0.5) < 1e-4);
+    CHECK(std::fabs(packed.x[1]-0.25) < 1e-4);
+    CHECK(std::fabs(packed.x[0]-full.x[0]) < 1e-6);
+    CHECK(std::fabs(packed.x[1]-full.x[1]) < 1e-6);
+}
+
+int main() {
+    // newton_cg.json
+    check([](Problem::State::t & state) {
+        state.algorithm_class = Optizelle::AlgorithmClass::LineSearch;
+        state.dir = Optizelle::LineSearchDirection::NewtonCG;
+        state.sigma = 0.01;
+        state.gamma = 0.995;
+    });
+
+    // newton_cg_backtracking.json
+    check([](Problem::State::t & state) {
+        state.algorithm_class = Optizelle::AlgorithmClass::LineSearch;
+        state.dir = Optizelle::LineSearchDirection::NewtonCG;
+        state.kind = Optizelle::LineSearchKind::BackTracking;
+        state.sigma = 0.01;
+        state.gamma = 0.99;
+    });
+
+    // sr1.json
+    check([](Problem::State::t & state) {
+        state.H_type = Optizelle::Operators::SR1;
+        state.stored_history = 2;
+        state.history_reset = 10;
+        state.iter_max = 100;
+        state.eps_dx = 1e-10;
+        state.eps_grad = 1e-9;
+        state.eps_mu = 1e-10;
+        state.delta = 100.;
+        state.sigma = 0.5;
+        state.gamma = 0.9;
+    });
+
+    // tr_newton.json
+    check([](Problem::State::t & state) {
+        state.eps_mu = 1e-11;
+        state.sigma = 0.1;
+        state.gamma = 0.99;
+        state.delta = 100.;
+    });
+
+    // tr_newton_mehrotra.json
+    check([](Problem::State::t & state) {
+        state.gamma = 0.99;
+        state.delta = 100.;
+        state.ipm = Optizelle::InteriorPointMethod::Mehrotra;
+    });
+
+    // tr_newton_predictor_corrector.json
+    check([](Problem::State::t & state) {
+        state.gamma = 0.9;
+        state.delta = 100.;
+        state.cstrat = Optizelle::CentralityStrategy::PredictorCorrector;
+    });
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
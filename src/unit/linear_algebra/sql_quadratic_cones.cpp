@@ -0,0 +1,151 @@
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "unit.h"
+
+// Checks the Jordan product, its inverse, the barrier, and the line search on
+// a collection of second-order cones of different sizes, which are processed
+// together, against a straightforward computation on each block.
+int main() {
+    // Create some type shortcuts
+    typedef Optizelle::SQL <double> Z;
+    using Optizelle::Natural;
+
+    // Create a mix of cones where the second-order cones are not in order
+    // of size
+    std::vector <Optizelle::Cone::t> types;
+    std::vector <Natural> sizes;
+    for(Natural i=0;i<50;i++) {
+        types.push_back(Optizelle::Cone::Quadratic);
+        sizes.push_back(2+(7*i)%9);
+        if(i%10==0) {
+            types.push_back(Optizelle::Cone::Linear);
+            sizes.push_back(3);
+        }
+    }
+    types.push_back(Optizelle::Cone::Semidefinite);
+    sizes.push_back(3);
+    Z::Vector zz(types,sizes);
+
+    // Create two strictly feasible vectors and a direction
+    Z::Vector x(Z::init(zz));
+    Z::Vector y(Z::init(zz));
+    Z::Vector dy(Z::init(zz));
+    for(Natural blk=1;blk<=types.size();blk++) {
+        Natural m=sizes[blk-1];
+        if(types[blk-1]==Optizelle::Cone::Semidefinite) {
+            for(Natural j=1;j<=m;j++)
+                for(Natural i=1;i<=m;i++) {
+                    x(blk,i,j)= i==j ? 2. : 0.;
+                    y(blk,i,j)= i==j ? 3. : 0.;
+                    dy(blk,i,j)= i==j ? -1. : 0.;
+                }
+        } else if(types[blk-1]==Optizelle::Cone::Linear) {
+            for(Natural i=1;i<=m;i++) {
+                x(blk,i)=2.+sin(double(blk+i));
+                y(blk,i)=2.+cos(double(blk*i));
+                dy(blk,i)=cos(double(blk+3*i));
+            }
+        } else
+            for(Natural i=1;i<=m;i++) {
+                x(blk,i)= i==1 ? double(m)+1. : sin(double(blk+i));
+                y(blk,i)= i==1 ? double(m)+2. : cos(double(blk*i));
+                dy(blk,i)= i==1 ? -1.-double(blk%3) : cos(double(blk+3*i));
+            }
+    }
+
+    // Jordan product
+    Z::Vector x_o_y(Z::init(zz));
+    Z::prod(x,y,x_o_y);
+    double err(0.);
+    for(Natural blk=1;blk<=types.size();blk++) {
+        if(types[blk-1]!=Optizelle::Cone::Quadratic) continue;
+        Natural m=sizes[blk-1];
+        double innr_x_y(0.);
+        for(Natural i=1;i<=m;i++)
+            innr_x_y+=x(blk,i)*y(blk,i);
+        err=std::max(err,std::fabs(x_o_y(blk,1)-innr_x_y));
+        for(Natural i=2;i<=m;i++)
+            err=std::max(err,std::fabs(x_o_y(blk,i)
+                -(x(blk,1)*y(blk,i)+y(blk,1)*x(blk,i))));
+    }
+    CHECK(err < 1e-14);
+
+    // Jordan product inverse.  We check this by undoing the product.
+    Z::Vector y_recovered(Z::init(zz));
+    Z::linv(x,x_o_y,y_recovered);
+    Z::Vector residual(Z::init(zz));
+    Z::copy(y,residual);
+    Z::axpy(-1.,y_recovered,residual);
+    err = std::sqrt(Z::innr(residual,residual))/(1.+std::sqrt(Z::innr(y,y)));
+    CHECK(err < 1e-14);
+
+    // Make sure that we can use the same vector for the input and output on
+    // the second-order cones
+    Z::copy(x_o_y,y_recovered);
+    Z::linv(x,y_recovered,y_recovered);
+    err = 0.;
+    for(Natural blk=1;blk<=types.size();blk++) {
+        if(types[blk-1]!=Optizelle::Cone::Quadratic) continue;
+        for(Natural i=1;i<=sizes[blk-1];i++)
+            err=std::max(err,std::fabs(y_recovered(blk,i)-y(blk,i))
+                /(1.+std::fabs(y(blk,i))));
+    }
+    CHECK(err < 1e-14);
+
+    // Barrier function
+    double barr(0.);
+    for(Natural blk=1;blk<=types.size();blk++) {
+        Natural m=sizes[blk-1];
+        switch(types[blk-1]) {
+        case Optizelle::Cone::Linear:
+            for(Natural i=1;i<=m;i++)
+                barr+=log(x(blk,i));
+            break;
+        case Optizelle::Cone::Quadratic: {
+            double innr_xbar_xbar(0.);
+            for(Natural i=2;i<=m;i++)
+                innr_xbar_xbar+=x(blk,i)*x(blk,i);
+            barr+=0.5*log(x(blk,1)*x(blk,1)-innr_xbar_xbar);
+            break;
+        } case Optizelle::Cone::Semidefinite:
+            barr+=double(m)*log(2.);
+            break;
+        }
+    }
+    err = std::fabs(Z::barr(x)-barr)/(1.+std::fabs(barr));
+    CHECK(err < 1e-14);
+
+    // Line search.  The step should take us to the boundary of the cone, so
+    // that one block has a zero determinant while every other block remains
+    // feasible.
+    double alpha = Z::srch(dy,y);
+    CHECK(alpha > 0. && alpha < std::numeric_limits <double>::infinity());
+    Z::Vector y_alpha(Z::init(zz));
+    Z::copy(y,y_alpha);
+    Z::axpy(alpha,dy,y_alpha);
+    double min_det=std::numeric_limits <double>::infinity();
+    for(Natural blk=1;blk<=types.size();blk++) {
+        Natural m=sizes[blk-1];
+        switch(types[blk-1]) {
+        case Optizelle::Cone::Linear:
+            for(Natural i=1;i<=m;i++)
+                min_det=std::min(min_det,y_alpha(blk,i));
+            break;
+        case Optizelle::Cone::Quadratic: {
+            double innr_ybar_ybar(0.);
+            for(Natural i=2;i<=m;i++)
+                innr_ybar_ybar+=y_alpha(blk,i)*y_alpha(blk,i);
+            CHECK(y_alpha(blk,1) >= 0.);
+            min_det=std::min(min_det,
+                y_alpha(blk,1)*y_alpha(blk,1)-innr_ybar_ybar);
+            break;
+        } case Optizelle::Cone::Semidefinite:
+            min_det=std::min(min_det,y_alpha(blk,1,1));
+            break;
+        }
+    }
+    CHECK(std::fabs(min_det) < 1e-10);
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
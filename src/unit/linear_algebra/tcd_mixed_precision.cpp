@@ -0,0 +1,92 @@
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/linalg.h"
+#include "linear_algebra.h"
+#include "unit.h"
+
+// Checks that truncated CD run with single-precision iterations and iterative
+// refinement reaches the same accuracy as the double-precision solve
+int main() {
+    // Create a type shortcut
+    typedef Optizelle::Rm <double> X;
+
+    // Set the size of the problem
+    Natural m = 20;
+
+    // Set the stopping tolerance
+    double eps_krylov = 1e-12;
+
+    // Set the maximum number of iterations
+    Natural iter_max = 200;
+
+    // Set the trust-reregion radius 
+    double delta = 100.;
+
+    // Create some symmetric positive definite operator 
+    BasicOperator <double> A(m);
+    for(Natural j=1;j<=m;j++)
+        for(Natural i=1;i<=m;i++) {
+            Natural I = j+(i-1)*m;
+            Natural J = i+(j-1)*m;
+            if(i>j) {
+                A.A[I-1]=cos(pow(I,2));
+                A.A[J-1]=A.A[I-1];
+            } else if(i==j)
+                A.A[I-1]=cos(pow(I,2))+double(m)+1.;
+        }
+    
+    // Create some right hand side
+    std::vector <double> b(m);
+    for(Natural i=1;i<=m;i++) b[i-1] = cos(i+25); 
+
+    // Get the norm of the RHS
+    double norm_b = std::sqrt(X::innr(b,b));
+    
+    // Create some empty null-space projection 
+    IdentityOperator <double> W;
+
+    // Create some empty trust-region shape operator
+    IdentityOperator <double> TR_op;
+    
+    // Create an initial guess at the solution
+    std::vector <double> x(m);
+    X::zero (x);
+    std::vector <double> x_full(m);
+    X::zero (x_full);
+
+    // Create a vector for the Cauchy point
+    std::vector <double> x_cp(m);
+
+    // Create a vector for the center of the trust-region
+    std::vector <double> x_cntr(m);
+    X::zero(x_cntr);
+
+    // Solve this linear system in mixed and full precision
+    double residual_err0, residual_err; 
+    Natural iter;
+    Optizelle::KrylovStop::t krylov_stop;
+    Optizelle::MixedPrecision <double,Optizelle::Rm>::truncated_cd(
+        Optizelle::KrylovPrecision::Mixed,
+        A,b,W,TR_op,eps_krylov,iter_max,1,delta,x_cntr,false,x,x_cp,
+        residual_err0,residual_err,iter,krylov_stop);
+    Optizelle::MixedPrecision <double,Optizelle::Rm>::truncated_cd(
+        Optizelle::KrylovPrecision::Full,
+        A,b,W,TR_op,eps_krylov,iter_max,1,delta,x_cntr,false,x_full,x_cp,
+        residual_err0,residual_err,iter,krylov_stop);
+
+    // Check that the mixed-precision solve converged
+    std::vector <double> residual(m);
+    A.eval(x,residual);
+    X::axpy(-1.,b,residual);
+    CHECK(std::sqrt(X::innr(residual,residual)) < 10.*eps_krylov*norm_b);
+
+    // Check the relative error between the two solutions
+    X::copy(x_full,residual);
+    X::axpy(-1.,x,residual);
+    double err=std::sqrt(X::innr(residual,residual))
+        /(1+sqrt(X::innr(x_full,x_full)));
+    CHECK(err < 1e-12);
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
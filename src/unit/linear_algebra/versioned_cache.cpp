@@ -0,0 +1,61 @@
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "unit.h"
+
+// Checks that a versioned cache recognizes when the tracked variable has
+// changed by its token, falls back to comparing vectors for any other
+// vector, picks up the token when the tracked variable moves to a vector
+// that we've already cached.
+int main() {
+    // Create some type shortcuts
+    typedef Optizelle::Rm <double> X;
+    using Optizelle::Natural;
+
+    // Create a tracked variable along with its version token
+    std::vector <double> x = {1.2,2.3,3.4};
+    Natural version(0);
+    Natural x_version(0);
+    Optizelle::VersionedCache <double,Optizelle::Rm> cache(x,x_version);
+
+    // Nothing is cached to start
+    CHECK(!cache.current(x));
+
+    // Cache a quantity at x
+    cache.update(x);
+    CHECK(cache.current(x));
+
+    // Modify x and its token
+    X::scal(2.,x);
+    x_version=++version;
+    CHECK(!cache.current(x));
+
+    // Cache a quantity at a trial point, which is not tracked
+    std::vector <double> x_trial = {0.5,-1.,4.};
+    cache.update(x_trial);
+    CHECK(cache.current(x_trial));
+    CHECK(!cache.current(x));
+
+    // Move x to the trial point.  We should recognize the cached value and
+    // then use the token.
+    X::copy(x_trial,x);
+    x_version=++version;
+    CHECK(cache.current(x));
+    CHECK(cache.current(x));
+
+    // Temporarily move x and then restore it along with its old token
+    Natural const x_version_save = x_version;
+    X::scal(3.,x);
+    x_version=++version;
+    CHECK(!cache.current(x));
+    X::copy(x_trial,x);
+    x_version=x_version_save;
+    CHECK(cache.current(x));
+
+    // Force a recomputation
+    cache.reset();
+    CHECK(!cache.current(x));
+    CHECK(!cache.current(x_trial));
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
@@ -82,10 +82,11 @@ int main() {
     CHECK(state.z.size()==0);
     CHECK(state.dz.size()==0);
     CHECK(state.h_x.size()==0);
+    CHECK(state.z_corr.size()==0);
     
     // Check that we have the correct number of vectors
     CHECK(xs.size() == 6);
-    CHECK(zs.size() == 3);
+    CHECK(zs.size() == 4);
     
     // Modify some vectors 
     xs.front().second = x0;
@@ -107,6 +108,7 @@ int main() {
     CHECK(state.z.size()>0);
     CHECK(state.dz.size()>0);
     CHECK(state.h_x.size()>0);
+    CHECK(state.z_corr.size()>0);
 
     // Check the relative error between the vector created above and the one
     // left in the state.  
@@ -10,65 +10,8 @@ template <typename Real> using XX = Optizelle::Rm <Real>;
 template <typename Real> using YY = Optizelle::Rm <Real>;
 template <typename Real> using ZZ = Optizelle::Rm <Real>;
 
-// There's some irritating "feature" in GCC that forces us to do this.
-// Basically, an alias-template is not really the template's alias.  Hence,
-// when we alias Optielle::Rm above, it turns out that the serialization
-// functions are not defined.  However, the typeid error message refers
-// to Rm and not XX, YY, or ZZ, which is super confusing.
-namespace Optizelle {
-    namespace json {
-        template <typename Real>
-        struct Serialization <Real,XX> {
-            static std::string serialize(
-                typename XX <Real>::Vector const & x
-            ) {
-                return Optizelle::json::Serialization
-                    <Real,Optizelle::Rm>::serialize(x);
-            }
-            static typename XX <Real>::Vector deserialize(
-                typename XX <Real>::Vector const & x,
-                std::string const & x_json
-            ) {
-                return std::move(Optizelle::json::Serialization
-                    <Real,Optizelle::Rm>::deserialize(x,x_json));
-            }
-        };
-        
-        template <typename Real>
-        struct Serialization <Real,YY> {
-            static std::string serialize(
-                typename YY <Real>::Vector const & x
-            ) {
-                return Optizelle::json::Serialization
-                    <Real,Optizelle::Rm>::serialize(x);
-            }
-            static typename YY <Real>::Vector deserialize(
-                typename YY <Real>::Vector const & x,
-                std::string const & x_json
-            ) {
-                return std::move(Optizelle::json::Serialization
-                    <Real,Optizelle::Rm>::deserialize(x,x_json));
-            }
-        };
-        
-        template <typename Real>
-        struct Serialization <Real,ZZ> {
-            static std::string serialize(
-                typename ZZ <Real>::Vector const & x
-            ) {
-                return Optizelle::json::Serialization
-                    <Real,Optizelle::Rm>::serialize(x);
-            }
-            static typename ZZ <Real>::Vector deserialize(
-                typename ZZ <Real>::Vector const & x,
-                std::string const & x_json
-            ) {
-                return std::move(Optizelle::json::Serialization
-                    <Real,Optizelle::Rm>::deserialize(x,x_json));
-            }
-        };
-    }
-}
+// Since XX, YY, and ZZ are alias templates, they name Optizelle::Rm itself,
+// so the serialization of Rm in optizelle/json.h covers them.
 
 // Create a blank state mainpulator
 template <typename ProblemClass>
@@ -0,0 +1,176 @@
+#include <sstream>
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/telemetry.h"
+#include "unit.h"
+
+// Create some type shortcuts
+typedef Optizelle::Rm <double> X;
+typedef X::Vector X_Vector;
+using Optizelle::Natural;
+using Optizelle::Rm;
+typedef Optizelle::Constrained <double,Rm,Rm,Rm> Problem;
+
+// f(x,y) = (x+1)^2 + (y+1)^2 + 0.1 (xy)^2
+struct MyObj : public Optizelle::ScalarValuedFunction <double,Rm> {
+    double eval(X_Vector const & x) const {
+        return Optizelle::sq(x[0]+1.)+Optizelle::sq(x[1]+1.)
+            +0.1*Optizelle::sq(x[0]*x[1]);
+    }
+    void grad(X_Vector const & x,X_Vector & g) const {
+        g[0]=2.*x[0]+2.+0.2*x[0]*x[1]*x[1];
+        g[1]=2.*x[1]+2.+0.2*x[0]*x[0]*x[1];
+    }
+    void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+        const
+    {
+        H_dx[0]=(2.+0.2*x[1]*x[1])*dx[0]+0.4*x[0]*x[1]*dx[1];
+        H_dx[1]=0.4*x[0]*x[1]*dx[0]+(2.+0.2*x[0]*x[0])*dx[1];
+    }
+};
+
+// g(x,y) = [ x^2 + 2y = 1 ]
+struct MyEq : public Optizelle::VectorValuedFunction <double,Rm,Rm> {
+    void eval(X_Vector const & x,X_Vector & y) const {
+        y[0]=x[0]*x[0]+2.*x[1]-1.;
+    }
+    void p(X_Vector const & x,X_Vector const & dx,X_Vector & y) const {
+        y[0]=2.*x[0]*dx[0]+2.*dx[1];
+    }
+    void ps(X_Vector const & x,X_Vector const & dy,X_Vector & z) const {
+        z[0]=2.*x[0]*dy[0];
+        z[1]=2.*dy[0];
+    }
+    void pps(
+        X_Vector const & x,
+        X_Vector const & dx,
+        X_Vector const & dy,
+        X_Vector & z
+    ) const {
+        z[0]=2.*dx[0]*dy[0];
+        z[1]=0.;
+    }
+};
+
+// h(x,y) = [ 2x + y >= 1 ]
+struct MyIneq : public Optizelle::VectorValuedFunction <double,Rm,Rm> {
+    void eval(X_Vector const & x,X_Vector & y) const {
+        y[0]=2.*x[0]+x[1]-1.;
+    }
+    void p(X_Vector const & x,X_Vector const & dx,X_Vector & y) const {
+        y[0]=2.*dx[0]+dx[1];
+    }
+    void ps(X_Vector const & x,X_Vector const & dy,X_Vector & z) const {
+        z[0]=2.*dy[0];
+        z[1]=dy[0];
+    }
+    void pps(
+        X_Vector const & x,
+        X_Vector const & dx,
+        X_Vector const & dy,
+        X_Vector & z
+    ) const {
+        X::zero(z);
+    }
+};
+
+// Keeps everything that we print
+struct Capture : public Optizelle::Messaging {
+    mutable std::vector <std::string> lines;
+    void print(std::string const & msg) const {
+        lines.push_back(msg);
+    }
+};
+
+// Solves the problem while sending the diagnostics to the given sink
+void solve(
+    Optizelle::Messaging const & msg,
+    Optizelle::TelemetrySink <double> & sink,
+    X_Vector & x
+) {
+    Problem::State::t state(X_Vector{2.1,1.1},X_Vector(1),X_Vector(1));
+    state.msg_level = 2;
+    state.H_type = Optizelle::Operators::UserDefined;
+    Problem::Functions::t fns;
+    fns.f.reset(new MyObj);
+    fns.g.reset(new MyEq);
+    fns.h.reset(new MyIneq);
+    Problem::Algorithms::getMin(msg,fns,state,
+        Optizelle::EmptyManipulator <Problem> (),sink);
+    x = std::move(state.x);
+}
+
+// Checks that the columnar telemetry holds exactly what we print as text and
+// that it survives a trip through the binary format
+int main() {
+    Optizelle::Messaging msg;
+
+    // Solve once while printing text and once while storing columns
+    Capture text;
+    Optizelle::TextTelemetry <double> text_sink(text);
+    X_Vector x_text;
+    solve(msg,text_sink,x_text);
+
+    Optizelle::ColumnarTelemetry <double> sink(msg);
+    X_Vector x_columnar;
+    solve(msg,sink,x_columnar);
+    auto const & table = sink.iterations;
+
+    // The choice of sink doesn't affect the optimization
+    CHECK(x_text == x_columnar);
+    CHECK(table.rows() > 1);
+    CHECK(text.lines.size() == table.rows()+1);
+
+    // There's no step before the first iteration
+    Natural const dx = table.find("||dx||");
+    CHECK(dx < table.columns.size());
+    CHECK(!table.columns[dx].present[0]);
+    CHECK(table.columns[dx].present[1]);
+    CHECK(table.columns[0].kind == Optizelle::TelemetryKind::Integer);
+    CHECK(table.columns[dx].kind == Optizelle::TelemetryKind::Number);
+
+    // Replaying the columns as text gives exactly what we printed
+    Capture replay;
+    Optizelle::TextTelemetry <double> replay_sink(replay);
+    std::vector <std::string> names;
+    for(auto const & column : table.columns)
+        names.push_back(column.name);
+    replay_sink.stateHeader(names);
+    for(Natural i=0;i<table.rows();i++) {
+        Optizelle::TelemetryRecord <double> record;
+        record.rejected = table.rejected[i];
+        for(auto const & column : table.columns)
+            record.values.push_back(column[i]);
+        replay_sink.state(record);
+    }
+    CHECK(replay.lines == text.lines);
+
+    // Write and read the binary format
+    std::stringstream binary;
+    table.write(binary);
+    Optizelle::TelemetryTable <double> table_read;
+    table_read.read(msg,binary);
+    CHECK(table_read.rows() == table.rows());
+    CHECK(table_read.rejected == table.rejected);
+    CHECK(table_read.columns.size() == table.columns.size());
+    for(Natural j=0;j<table.columns.size();j++) {
+        auto const & a = table.columns[j];
+        auto const & b = table_read.columns[j];
+        CHECK(a.name == b.name);
+        CHECK(a.kind == b.kind);
+        CHECK(a.present == b.present);
+        CHECK(a.integers == b.integers);
+        CHECK(a.numbers == b.numbers);
+    }
+
+    // The CSV has a header and one line per row
+    std::stringstream csv;
+    table.write_csv(csv);
+    Natural lines = 0;
+    for(std::string line; std::getline(csv,line);)
+        lines++;
+    CHECK(lines == table.rows()+1);
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
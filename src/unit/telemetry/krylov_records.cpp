@@ -0,0 +1,160 @@
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/telemetry.h"
+#include "unit.h"
+
+// Create some type shortcuts
+typedef Optizelle::Rm <double> X;
+typedef X::Vector X_Vector;
+using Optizelle::Natural;
+using Optizelle::Rm;
+typedef Optizelle::Unconstrained <double,Rm> Unconstrained;
+typedef Optizelle::EqualityConstrained <double,Rm,Rm> EqualityConstrained;
+
+// f(x,y,z) = (x+1)^2 + 2 (y-1)^2 + 3 (z-2)^2 + 0.1 (xyz)^2
+struct MyObj : public Optizelle::ScalarValuedFunction <double,Rm> {
+    double eval(X_Vector const & x) const {
+        return Optizelle::sq(x[0]+1.)+2.*Optizelle::sq(x[1]-1.)
+            +3.*Optizelle::sq(x[2]-2.)+0.1*Optizelle::sq(x[0]*x[1]*x[2]);
+    }
+    void grad(X_Vector const & x,X_Vector & g) const {
+        double const p = x[0]*x[1]*x[2];
+        g[0]=2.*(x[0]+1.)+0.2*p*x[1]*x[2];
+        g[1]=4.*(x[1]-1.)+0.2*p*x[0]*x[2];
+        g[2]=6.*(x[2]-2.)+0.2*p*x[0]*x[1];
+    }
+    void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+        const
+    {
+        double const p = x[0]*x[1]*x[2];
+        double const a = x[1]*x[2];
+        double const b = x[0]*x[2];
+        double const c = x[0]*x[1];
+        H_dx[0]=(2.+0.2*a*a)*dx[0]+(0.2*b*a+0.2*p*x[2])*dx[1]
+            +(0.2*c*a+0.2*p*x[1])*dx[2];
+        H_dx[1]=(0.2*a*b+0.2*p*x[2])*dx[0]+(4.+0.2*b*b)*dx[1]
+            +(0.2*c*b+0.2*p*x[0])*dx[2];
+        H_dx[2]=(0.2*a*c+0.2*p*x[1])*dx[0]+(0.2*b*c+0.2*p*x[0])*dx[1]
+            +(6.+0.2*c*c)*dx[2];
+    }
+};
+
+// g(x,y,z) = [ x^2 + 2y + z = 1 ]
+struct MyEq : public Optizelle::VectorValuedFunction <double,Rm,Rm> {
+    void eval(X_Vector const & x,X_Vector & y) const {
+        y[0]=x[0]*x[0]+2.*x[1]+x[2]-1.;
+    }
+    void p(X_Vector const & x,X_Vector const & dx,X_Vector & y) const {
+        y[0]=2.*x[0]*dx[0]+2.*dx[1]+dx[2];
+    }
+    void ps(X_Vector const & x,X_Vector const & dy,X_Vector & z) const {
+        z[0]=2.*x[0]*dy[0];
+        z[1]=2.*dy[0];
+        z[2]=dy[0];
+    }
+    void pps(
+        X_Vector const & x,
+        X_Vector const & dx,
+        X_Vector const & dy,
+        X_Vector & z
+    ) const {
+        X::zero(z);
+        z[0]=2.*dx[0]*dy[0];
+    }
+};
+
+// Counts the end of each Krylov iteration
+template <typename ProblemClass>
+struct CountKrylov : public Optizelle::StateManipulator <ProblemClass> {
+    mutable Natural count;
+    CountKrylov() : count(0) {}
+    void eval(
+        typename ProblemClass::Functions::t const & fns,
+        typename ProblemClass::State::t & state,
+        Optizelle::OptimizationLocation::t const & loc
+    ) const {
+        if(loc==Optizelle::OptimizationLocation::EndOfKrylovIteration)
+            count++;
+    }
+};
+
+// Checks that the Krylov records count the iterations of each solve and add
+// up to the total
+void check_unconstrained(
+    Optizelle::KrylovSolverTruncated::t const & krylov_solver,
+    Optizelle::KrylovPrecision::t const & krylov_precision
+) {
+    Optizelle::Messaging msg;
+    Unconstrained::State::t state(X_Vector{2.1,-1.1,0.5});
+    state.msg_level = 3;
+    state.H_type = Optizelle::Operators::UserDefined;
+    state.krylov_solver = krylov_solver;
+    state.krylov_precision = krylov_precision;
+    Unconstrained::Functions::t fns;
+    fns.f.reset(new MyObj);
+    Optizelle::ColumnarTelemetry <double> sink(msg);
+    CountKrylov <Unconstrained> count;
+    Unconstrained::Algorithms::getMin(msg,fns,state,count,sink);
+    auto const & table = sink.krylov_iterations;
+
+    // There's one record per Krylov iteration
+    CHECK(state.krylov_iter_total > 0);
+    CHECK(table.rows() == state.krylov_iter_total);
+    CHECK(count.count == table.rows());
+
+    // Each solve counts up from one and the running total ends at the total
+    Natural const sub = table.find("KrySubItr");
+    Natural const tot = table.find("KryTotItr");
+    Natural const err = table.find("KrySubErr");
+    CHECK(sub < table.columns.size());
+    CHECK(tot < table.columns.size());
+    CHECK(err < table.columns.size());
+    auto const & subs = table.columns[sub].integers;
+    auto const & tots = table.columns[tot].integers;
+    CHECK(subs.front() == 1);
+    for(Natural i=1;i<table.rows();i++)
+        CHECK(subs[i] == 1 || subs[i] == subs[i-1]+1);
+    CHECK(tots.back() == state.krylov_iter_total);
+    for(auto const & rel_err : table.columns[err].numbers)
+        CHECK(rel_err >= 0.);
+}
+
+// Checks that the composite-step method reports the tangential subproblem and
+// the augmented system solves
+void check_equality() {
+    Optizelle::Messaging msg;
+    EqualityConstrained::State::t state(X_Vector{2.1,-1.1,0.5},X_Vector(1));
+    state.msg_level = 3;
+    state.H_type = Optizelle::Operators::UserDefined;
+    EqualityConstrained::Functions::t fns;
+    fns.f.reset(new MyObj);
+    fns.g.reset(new MyEq);
+    Optizelle::ColumnarTelemetry <double> sink(msg);
+    CountKrylov <EqualityConstrained> count;
+    EqualityConstrained::Algorithms::getMin(msg,fns,state,count,sink);
+    auto const & table = sink.krylov_iterations;
+
+    // The augmented systems add records beyond the tangential subproblem
+    CHECK(state.krylov_iter_total > 0);
+    CHECK(count.count == table.rows());
+    CHECK(table.rows() > state.krylov_iter_total);
+    CHECK(table.find("KrySubItr") < table.columns.size());
+}
+
+// Checks that the Krylov solvers raise EndOfKrylovIteration once per
+// iteration
+int main() {
+    check_unconstrained(
+        Optizelle::KrylovSolverTruncated::ConjugateDirection,
+        Optizelle::KrylovPrecision::Full);
+    check_unconstrained(
+        Optizelle::KrylovSolverTruncated::MINRES,
+        Optizelle::KrylovPrecision::Full);
+    check_unconstrained(
+        Optizelle::KrylovSolverTruncated::ConjugateDirection,
+        Optizelle::KrylovPrecision::Mixed);
+    check_equality();
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,181 @@
+// This tests that the trace records the phases of an optimization, the user
+// functions, and the Krylov solves from every thread and that it exports
+// them in the Chrome trace event format
+
+#include <sstream>
+#include <thread>
+#include <set>
+#include <json/json.h>
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/trace.h"
+#include "unit.h"
+
+// Create some type shortcuts
+typedef Optizelle::Rm <double> X;
+typedef X::Vector X_Vector;
+using Optizelle::Natural;
+using Optizelle::Rm;
+typedef Optizelle::Constrained <double,Rm,Rm,Rm> Problem;
+
+// f(x,y) = (x+1)^2 + (y+1)^2 + 0.1 (xy)^2
+struct MyObj : public Optizelle::ScalarValuedFunction <double,Rm> {
+    double eval(X_Vector const & x) const {
+        return Optizelle::sq(x[0]+1.)+Optizelle::sq(x[1]+1.)
+            +0.1*Optizelle::sq(x[0]*x[1]);
+    }
+    void grad(X_Vector const & x,X_Vector & g) const {
+        g[0]=2.*x[0]+2.+0.2*x[0]*x[1]*x[1];
+        g[1]=2.*x[1]+2.+0.2*x[0]*x[0]*x[1];
+    }
+    void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+        const
+    {
+        H_dx[0]=(2.+0.2*x[1]*x[1])*dx[0]+0.4*x[0]*x[1]*dx[1];
+        H_dx[1]=0.4*x[0]*x[1]*dx[0]+(2.+0.2*x[0]*x[0])*dx[1];
+    }
+};
+
+// g(x,y) = [ x^2 + 2y = 1 ]
+struct MyEq : public Optizelle::VectorValuedFunction <double,Rm,Rm> {
+    void eval(X_Vector const & x,X_Vector & y) const {
+        y[0]=x[0]*x[0]+2.*x[1]-1.;
+    }
+    void p(X_Vector const & x,X_Vector const & dx,X_Vector & y) const {
+        y[0]=2.*x[0]*dx[0]+2.*dx[1];
+    }
+    void ps(X_Vector const & x,X_Vector const & dy,X_Vector & z) const {
+        z[0]=2.*x[0]*dy[0];
+        z[1]=2.*dy[0];
+    }
+    void pps(
+        X_Vector const & x,
+        X_Vector const & dx,
+        X_Vector const & dy,
+        X_Vector & z
+    ) const {
+        z[0]=2.*dx[0]*dy[0];
+        z[1]=0.;
+    }
+};
+
+// h(x,y) = [ 2x + y >= 1 ]
+struct MyIneq : public Optizelle::VectorValuedFunction <double,Rm,Rm> {
+    void eval(X_Vector const & x,X_Vector & y) const {
+        y[0]=2.*x[0]+x[1]-1.;
+    }
+    void p(X_Vector const & x,X_Vector const & dx,X_Vector & y) const {
+        y[0]=2.*dx[0]+dx[1];
+    }
+    void ps(X_Vector const & x,X_Vector const & dy,X_Vector & z) const {
+        z[0]=2.*dy[0];
+        z[1]=dy[0];
+    }
+    void pps(
+        X_Vector const & x,
+        X_Vector const & dx,
+        X_Vector const & dy,
+        X_Vector & z
+    ) const {
+        X::zero(z);
+    }
+};
+
+// Solves the problem
+void solve() {
+    Problem::State::t state(X_Vector{2.1,1.1},X_Vector(1),X_Vector(1));
+    state.msg_level = 0;
+    state.H_type = Optizelle::Operators::UserDefined;
+    Problem::Functions::t fns;
+    fns.f.reset(new MyObj);
+    fns.g.reset(new MyEq);
+    fns.h.reset(new MyIneq);
+    Problem::Algorithms::getMin(Optizelle::Messaging(),fns,state);
+    CHECK(state.opt_stop != Optizelle::StoppingCondition::NotConverged);
+}
+
+// Exports the trace and reads it back
+Json::Value export_trace() {
+    std::stringstream out;
+    Optizelle::Trace::write_chrome(out);
+    Json::Value trace;
+    Json::Reader reader;
+    CHECK(reader.parse(out.str(),trace));
+    return trace["traceEvents"];
+}
+
+int main() {
+    // Solve the problem on two threads at once
+    Optizelle::Trace::clear();
+    std::thread first(solve);
+    std::thread second(solve);
+    first.join();
+    second.join();
+    Json::Value events = export_trace();
+
+    // Sort what we found by name and by thread.  Every phase that begins must
+    // also end.
+    std::set <std::string> names;
+    std::set <std::string> categories;
+    std::set <Natural> tids;
+    Natural begins = 0;
+    Natural ends = 0;
+    for(auto const & event : events) {
+        names.insert(event["name"].asString());
+        categories.insert(event["cat"].asString());
+        tids.insert(event["tid"].asUInt());
+        std::string const ph = event["ph"].asString();
+        CHECK(ph=="X" || ph=="b" || ph=="e");
+        if(ph=="X") {
+            CHECK(event["dur"].asDouble() >= 0.);
+        } else if(ph=="b")
+            begins++;
+        else if(ph=="e")
+            ends++;
+    }
+    CHECK(begins > 0);
+    CHECK(begins == ends);
+    CHECK(tids.size() == 2);
+
+    // We saw the solves, the phases, the user functions, and the Krylov
+    // solves
+    for(auto const & name : {"getMin","BeginningOfOptimization",
+        "BeforeStep","EndOfOptimizationIteration","f.eval","f.grad",
+        "f.hessvec","g.eval","g.p","g.ps","h.eval","h.p","h.ps"}
+    )
+        CHECK(names.count(name) == 1);
+    for(auto const & category : {"solver","location","user","krylov"})
+        CHECK(categories.count(category) == 1);
+
+    // When the buffer fills, we keep only the most recent events
+    Optizelle::Trace::capacity(6);
+    solve();
+    events = export_trace();
+    Natural recorded = 0;
+    for(auto const & event : events)
+        recorded += event["ph"].asString()=="e" ? 0 : 1;
+    CHECK(recorded == 8);
+
+    // The solve finishes last, so it's the last event we recorded
+    CHECK(events[events.size()-1]["name"].asString() == "getMin");
+
+    // Clearing the trace forgets everything
+    Optizelle::Trace::clear();
+    CHECK(export_trace().size() == 0);
+
+    // Threads that start after others have exited take over their buffers,
+    // and we keep the events of every thread
+    for(Natural i=0;i<3;i++) {
+        std::thread worker([]() {
+            Optizelle::Trace::Scope scope("worker","test");
+        });
+        worker.join();
+    }
+    events = export_trace();
+    CHECK(events.size() == 3);
+    for(auto const & event : events)
+        CHECK(tids.count(event["tid"].asUInt()) == 1);
+
+    // Declare success
+    return EXIT_SUCCESS;
+}